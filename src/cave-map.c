@@ -18,11 +18,13 @@
 
 #include "angband.h"
 #include "cave.h"
+#include "game-world.h"
 #include "init.h"
 #include "monster.h"
 #include "mon-predicate.h"
 #include "mon-util.h"
 #include "obj-ignore.h"
+#include "obj-knowledge.h"
 #include "obj-pile.h"
 #include "obj-tval.h"
 #include "obj-util.h"
@@ -30,6 +32,73 @@
 #include "player-timed.h"
 #include "trap.h"
 
+/**
+ * Work out what map_info() shows of the player's known pile at a grid
+ */
+static void pile_summarise(struct loc grid, struct pile_summary *summary)
+{
+	struct object *obj;
+
+	summary->first_kind = NULL;
+	summary->multiple_objects = false;
+	summary->unseen_object = false;
+	summary->unseen_money = false;
+
+	for (obj = square_object(player->cave, grid); obj; obj = obj->next) {
+		if (obj->kind == unknown_gold_kind) {
+			summary->unseen_money = true;
+		} else if (obj->kind == unknown_item_kind) {
+			summary->unseen_object = true;
+		} else if (ignore_known_item_ok(obj)) {
+			/* Item stays hidden */
+		} else if (!summary->first_kind) {
+			summary->first_kind = obj->kind;
+		} else {
+			summary->multiple_objects = true;
+			break;
+		}
+	}
+}
+
+/**
+ * Get what map_info() shows of the player's known pile at a grid.
+ *
+ * Summaries are kept on the known cave, forgotten by any change to the pile
+ * (see square_note_pile()), and worked out again when the ignore settings,
+ * object knowledge or unignoring change.  While a change that may affect
+ * ignoring is waiting for notice_stuff() nothing is trusted or kept.
+ */
+static const struct pile_summary *pile_summary(struct loc grid)
+{
+	static struct pile_summary scratch;
+	struct chunk *c = player->cave;
+	struct pile_summary *summary;
+	u32b generation = ignore_settings_generation();
+	u32b version = object_knowledge_version();
+
+	if (player->upkeep->notice & PN_IGNORE) {
+		pile_summarise(grid, &scratch);
+		return &scratch;
+	}
+
+	if (!c->pile_summary)
+		c->pile_summary = mem_zalloc(c->height * c->width *
+									 sizeof(*c->pile_summary));
+	summary = &c->pile_summary[grid_to_i(grid, c->width)];
+
+	if (!summary->valid || summary->ignore_generation != generation ||
+		summary->knowledge_version != version ||
+		summary->unignoring != player->unignoring) {
+		pile_summarise(grid, summary);
+		summary->valid = true;
+		summary->ignore_generation = generation;
+		summary->knowledge_version = version;
+		summary->unignoring = player->unignoring;
+	}
+
+	return summary;
+}
+
 /**
  * This function takes a grid location and extracts information the
  * player is allowed to know about it, filling in the grid_data structure
@@ -79,7 +148,7 @@
  */
 void map_info(struct loc grid, struct grid_data *g)
 {
-	struct object *obj;
+	const struct pile_summary *pile;
 
 	assert(grid.x < cave->width);
 	assert(grid.y < cave->height);
@@ -164,19 +233,12 @@ void map_info(struct loc grid, struct grid_data *g)
     }
 
 	/* Objects */
-	for (obj = square_object(player->cave, grid); obj; obj = obj->next) {
-		if (obj->kind == unknown_gold_kind) {
-			g->unseen_money = true;
-		} else if (obj->kind == unknown_item_kind) {
-			g->unseen_object = true;
-		} else if (ignore_known_item_ok(obj)) {
-			/* Item stays hidden */
-		} else if (!g->first_kind) {
-			g->first_kind = obj->kind;
-		} else {
-			g->multiple_objects = true;
-			break;
-		}
+	if (square_object(player->cave, grid)) {
+		pile = pile_summary(grid);
+		g->first_kind = pile->first_kind;
+		g->multiple_objects = pile->multiple_objects;
+		g->unseen_object = pile->unseen_object;
+		g->unseen_money = pile->unseen_money;
 	}
 
 	/* Monsters */
@@ -264,7 +326,7 @@ void square_note_spot(struct chunk *c, struct loc grid)
  */
 void square_light_spot(struct chunk *c, struct loc grid)
 {
-	if ((c == cave) && player->cave) {
+	if ((c == cave) && player->cave && !display_null) {
 		player->upkeep->redraw |= PR_ITEMLIST;
 		event_signal_point(EVENT_MAP, grid.x, grid.y);
 	}
@@ -384,7 +446,7 @@ void light_room(struct loc grid, bool light)
 	int i, d;
 	struct point_set *ps;
 
-	ps = point_set_new(200);
+	ps = point_set_new_grid(200, cave->width, cave->height);
 
 	/* Add the initial grid */
 	cave_room_aux(ps, grid);
@@ -418,60 +480,82 @@ void light_room(struct loc grid, bool light)
 
 
 /**
- * Light up the dungeon using "claravoyance"
- *
- * This function "illuminates" every grid in the dungeon, memorizes all
- * "objects" (or notes the existence of an object "if" full is true),
- * and memorizes all grids as with magic mapping.
+ * Set in the scratch bitplane `near` every grid which is one of, or next to
+ * one of, the grids fully in bounds which are set in `from`
  */
-void wiz_light(struct chunk *c, struct player *p, bool full)
+static void grid_plane_spread(struct chunk *c, const bitflag *from,
+		bitflag *near)
 {
-	int i, y, x;
+	int y, i, d;
 
-	/* Scan all grids */
 	for (y = 1; y < c->height - 1; y++) {
-		for (x = 1; x < c->width - 1; x++) {
-			struct loc grid = loc(x, y);
-
-			/* Process all non-walls */
-			if (!square_seemslikewall(c, grid)) {
-				if (!square_in_bounds_fully(c, grid)) continue;
-
-				/* Scan all neighbors */
-				for (i = 0; i < 9; i++) {
-					struct loc a_grid = loc_sum(grid, ddgrid_ddd[i]);
-
-					/* Perma-light the grid */
-					sqinfo_on(square(c, a_grid).info, SQUARE_GLOW);
+		int row = y * c->width;
+		int end = row + c->width - 1;
+
+		for (i = grid_plane_next(from, row + 1, end); i < end;
+			 i = grid_plane_next(from, i + 1, end)) {
+			for (d = 0; d < 9; d++)
+				grid_plane_on(near, i + ddgrid_ddd[d].y * c->width +
+							  ddgrid_ddd[d].x);
+		}
+	}
+}
 
-					/* Memorize normal features */
-					if (!square_isfloor(c, a_grid) || 
-						square_isvisibletrap(c, a_grid)) {
-						square_memorize(c, a_grid);
-						square_mark(c, a_grid);
-					}
-				}
-			}
+/**
+ * Light or darken every grid in or next to a grid which doesn't look like a
+ * wall, memorizing the interesting ones and the objects on the level, and
+ * forgetting whatever else the player has wrong.  The scratch plane means
+ * each grid is visited once, however many open grids it touches.
+ */
+static void wiz_map(struct chunk *c, struct player *p, bool full, bool light)
+{
+	int size = c->height * c->width;
+	bitflag *near = mem_zalloc(GRID_PLANE_SIZE(size) * sizeof(bitflag));
+	struct loc grid;
+	int i, y, x;
 
-			/* Memorize objects */
-			if (full) {
-				square_know_pile(c, grid);
-			} else {
-				square_sense_pile(c, grid);
-			}
+	/* Light or darken, and memorize normal features */
+	grid_plane_spread(c, c->classes[GRID_CLASS_OPEN], near);
+	for (i = grid_plane_next(near, 0, size); i < size;
+		 i = grid_plane_next(near, i + 1, size)) {
+		i_to_grid(i, c->width, &grid);
+		if (light)
+			sqinfo_on(square(c, grid).info, SQUARE_GLOW);
+		else
+			sqinfo_off(square(c, grid).info, SQUARE_GLOW);
 
-			/* Forget unprocessed, unknown grids in the mapping area */
-			if (!square_ismark(c, grid) && square_isnotknown(c, grid))
-				square_forget(c, grid);
+		if ((!square_isfloor(c, grid) || square_isvisibletrap(c, grid)) &&
+			square_isnotknown(c, grid))
+			square_memorize(c, grid);
+	}
+	mem_free(near);
+
+	/* Memorize objects, and forget those no longer where they were seen */
+	grid = loc(0, 1);
+	while (cave_next_object_grid(c, loc(1, 1), loc(c->width - 2, c->height - 2),
+								 &grid)) {
+		if (full) {
+			square_know_pile(c, grid);
+		} else {
+			square_sense_pile(c, grid);
 		}
 	}
+	if (full && c == cave && p->cave) {
+		grid = loc(0, 1);
+		while (cave_next_object_grid(p->cave, loc(1, 1),
+									 loc(c->width - 2, c->height - 2), &grid))
+			square_know_pile(c, grid);
+	}
 
-	/* Unmark grids */
-	for (y = 1; y < c->height - 1; y++) {
+	/* Forget unprocessed, unknown grids, skipping rows already right */
+	for (y = 1; c == cave && p->cave && y < c->height - 1; y++) {
+		int row = y * c->width;
+
+		if (!memcmp(p->cave->feat + row + 1, c->feat + row + 1, c->width - 2))
+			continue;
 		for (x = 1; x < c->width - 1; x++) {
-			struct loc grid = loc(x, y);
-			if (!square_in_bounds(c, grid)) continue;
-			square_unmark(c, grid);
+			if (square_isnotknown(c, loc(x, y)))
+				square_forget(c, loc(x, y));
 		}
 	}
 
@@ -482,6 +566,18 @@ void wiz_light(struct chunk *c, struct player *p, bool full)
 	p->upkeep->redraw |= (PR_MAP | PR_MONLIST | PR_ITEMLIST);
 }
 
+/**
+ * Light up the dungeon using "claravoyance"
+ *
+ * This function "illuminates" every grid in the dungeon, memorizes all
+ * "objects" (or notes the existence of an object "if" full is true),
+ * and memorizes all grids as with magic mapping.
+ */
+void wiz_light(struct chunk *c, struct player *p, bool full)
+{
+	wiz_map(c, p, full, true);
+}
+
 
 /**
  * Compeletly darken the level, and know all objects
@@ -492,60 +588,7 @@ void wiz_light(struct chunk *c, struct player *p, bool full)
  */
 void wiz_dark(struct chunk *c, struct player *p, bool full)
 {
-	int i, y, x;
-
-	/* Scan all grids */
-	for (y = 1; y < c->height - 1; y++) {
-		for (x = 1; x < c->width - 1; x++) {
-			struct loc grid = loc(x, y);
-
-			/* Process all non-walls */
-			if (!square_seemslikewall(c, grid)) {
-				if (!square_in_bounds_fully(c, grid)) continue;
-
-				/* Scan all neighbors */
-				for (i = 0; i < 9; i++) {
-					struct loc a_grid = loc_sum(grid, ddgrid_ddd[i]);
-
-					/* Perma-darken the grid */
-					sqinfo_off(square(cave, a_grid).info, SQUARE_GLOW);
-
-					/* Memorize normal features */
-					if (!square_isfloor(c, a_grid) || 
-						square_isvisibletrap(c, a_grid)) {
-						square_memorize(c, a_grid);
-						square_mark(c, a_grid);
-					}
-				}
-			}
-
-			/* Memorize objects */
-			if (full) {
-				square_know_pile(c, grid);
-			} else {
-				square_sense_pile(c, grid);
-			}
-
-			/* Forget unprocessed, unknown grids in the mapping area */
-			if (!square_ismark(c, grid) && square_isnotknown(c, grid))
-				square_forget(c, grid);
-		}
-	}
-
-	/* Unmark grids */
-	for (y = 1; y < c->height - 1; y++) {
-		for (x = 1; x < c->width - 1; x++) {
-			struct loc grid = loc(x, y);
-			if (!square_in_bounds(c, grid)) continue;
-			square_unmark(c, grid);
-		}
-	}
-
-	/* Fully update the visuals */
-	p->upkeep->update |= (PU_UPDATE_VIEW | PU_MONSTERS);
-
-	/* Redraw whole map, monster list */
-	p->upkeep->redraw |= (PR_MAP | PR_MONLIST | PR_ITEMLIST);
+	wiz_map(c, p, full, false);
 }
 
 
@@ -554,57 +597,46 @@ void wiz_dark(struct chunk *c, struct player *p, bool full)
  */
 void cave_illuminate(struct chunk *c, bool daytime)
 {
-	int y, x, i;
-
-	/* Apply light or darkness */
-	for (y = 0; y < c->height; y++) {
-		for (x = 0; x < c->width; x++) {
-			int d;
-			bool light = false;
-			struct loc grid = loc(x, y);
-			
-			/* Skip grids with no surrounding floors or stairs */
-			for (d = 0; d < 9; d++) {
-				/* Extract adjacent (legal) location */
-				struct loc a_grid = loc_sum(grid, ddgrid_ddd[d]);
-
-				/* Paranoia */
-				if (!square_in_bounds_fully(c, a_grid)) continue;
-
-				/* Test */
-				if (square_isfloor(c, a_grid) || square_isstairs(c, a_grid))
-					light = true;
-			}
-
-			if (!light) continue;
+	int size = c->height * c->width;
+	bitflag *open = mem_zalloc(GRID_PLANE_SIZE(size) * sizeof(bitflag));
+	bitflag *near = mem_zalloc(GRID_PLANE_SIZE(size) * sizeof(bitflag));
+	struct loc grid;
+	int i, d;
 
-			/* Only interesting grids at night */
-			if (daytime || !square_isfloor(c, grid)) {
-				sqinfo_on(square(c, grid).info, SQUARE_GLOW);
-				square_memorize(c, grid);
-			} else if (!square_isbright(c, grid)) {
-				sqinfo_off(square(c, grid).info, SQUARE_GLOW);
-				square_forget(c, grid);
-			}
+	/* Find the floors and stairs */
+	for (i = 0; i < size; i++)
+		if (feat_props[c->feat[i]] & (FEAT_PROP_FLOOR | FEAT_PROP_STAIR))
+			grid_plane_on(open, i);
+
+	/* Apply light or darkness to grids with surrounding floors or stairs */
+	grid_plane_spread(c, open, near);
+	for (i = grid_plane_next(near, 0, size); i < size;
+		 i = grid_plane_next(near, i + 1, size)) {
+		i_to_grid(i, c->width, &grid);
+
+		/* Only interesting grids at night */
+		if (daytime || !square_isfloor(c, grid)) {
+			sqinfo_on(square(c, grid).info, SQUARE_GLOW);
+			square_memorize(c, grid);
+		} else if (!square_isbright(c, grid)) {
+			sqinfo_off(square(c, grid).info, SQUARE_GLOW);
+			square_forget(c, grid);
 		}
 	}
-			
-			
+	mem_free(open);
+	mem_free(near);
+
 	/* Light shop doorways */
-	for (y = 0; y < c->height; y++) {
-		for (x = 0; x < c->width; x++) {
-			struct loc grid = loc(x, y);
-			if (!square_isshop(c, grid))
-				continue;
-			for (i = 0; i < 8; i++) {
-				struct loc a_grid = loc_sum(grid, ddgrid_ddd[i]);
-				sqinfo_on(square(c, a_grid).info, SQUARE_GLOW);
-				square_memorize(c, a_grid);
-			}
+	for (i = 0; i < size; i++) {
+		if (!tf_has(f_info[c->feat[i]].flags, TF_SHOP)) continue;
+		i_to_grid(i, c->width, &grid);
+		for (d = 0; d < 8; d++) {
+			struct loc a_grid = loc_sum(grid, ddgrid_ddd[d]);
+			sqinfo_on(square(c, a_grid).info, SQUARE_GLOW);
+			square_memorize(c, a_grid);
 		}
 	}
 
-
 	/* Fully update the visuals */
 	player->upkeep->update |= (PU_UPDATE_VIEW | PU_MONSTERS);
 
@@ -637,7 +669,8 @@ void cave_known(struct player *p)
 
 			/* Internal walls not known */
 			if (count < 8) {
-				p->cave->squares[y][x].feat = square(cave, grid).feat;
+				p->cave->feat[grid_to_i(grid, cave->width)] = square(cave, grid).feat;
+				square_update_planes(p->cave, grid);
 			}
 		}
 	}
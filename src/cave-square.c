@@ -20,6 +20,7 @@
 #include "cave.h"
 #include "game-world.h"
 #include "init.h"
+#include "mon-move.h"
 #include "monster.h"
 #include "obj-knowledge.h"
 #include "obj-pile.h"
@@ -74,7 +75,7 @@ bool feat_is_treasure(int feat)
  */
 bool feat_is_wall(int feat)
 {
-	return tf_has(f_info[feat].flags, TF_WALL);
+	return (feat_props[feat] & FEAT_PROP_WALL) ? true : false;
 }
 
 /**
@@ -82,7 +83,7 @@ bool feat_is_wall(int feat)
  */
 bool feat_is_floor(int feat)
 {
-	return tf_has(f_info[feat].flags, TF_FLOOR);
+	return (feat_props[feat] & FEAT_PROP_FLOOR) ? true : false;
 }
 
 /**
@@ -90,7 +91,7 @@ bool feat_is_floor(int feat)
  */
 bool feat_is_trap_holding(int feat)
 {
-	return tf_has(f_info[feat].flags, TF_TRAP);
+	return (feat_props[feat] & FEAT_PROP_TRAP) ? true : false;
 }
 
 /**
@@ -98,7 +99,7 @@ bool feat_is_trap_holding(int feat)
  */
 bool feat_is_object_holding(int feat)
 {
-	return tf_has(f_info[feat].flags, TF_OBJECT);
+	return (feat_props[feat] & FEAT_PROP_OBJECT) ? true : false;
 }
 
 /**
@@ -106,7 +107,7 @@ bool feat_is_object_holding(int feat)
  */
 bool feat_is_monster_walkable(int feat)
 {
-	return tf_has(f_info[feat].flags, TF_PASSABLE);
+	return (feat_props[feat] & FEAT_PROP_PASSABLE) ? true : false;
 }
 
 /**
@@ -122,7 +123,7 @@ bool feat_is_shop(int feat)
  */
 bool feat_is_passable(int feat)
 {
-	return tf_has(f_info[feat].flags, TF_PASSABLE);
+	return (feat_props[feat] & FEAT_PROP_PASSABLE) ? true : false;
 }
 
 /**
@@ -130,7 +131,7 @@ bool feat_is_passable(int feat)
  */
 bool feat_is_projectable(int feat)
 {
-	return tf_has(f_info[feat].flags, TF_PROJECT);
+	return (feat_props[feat] & FEAT_PROP_PROJECT) ? true : false;
 }
 
 /**
@@ -138,7 +139,7 @@ bool feat_is_projectable(int feat)
  */
 bool feat_is_torch(int feat)
 {
-	return tf_has(f_info[feat].flags, TF_TORCH);
+	return (feat_props[feat] & FEAT_PROP_TORCH) ? true : false;
 }
 
 /**
@@ -146,7 +147,7 @@ bool feat_is_torch(int feat)
  */
 bool feat_is_bright(int feat)
 {
-	return tf_has(f_info[feat].flags, TF_BRIGHT);
+	return (feat_props[feat] & FEAT_PROP_BRIGHT) ? true : false;
 }
 
 /**
@@ -162,7 +163,7 @@ bool feat_is_fiery(int feat)
  */
 bool feat_is_no_flow(int feat)
 {
-	return tf_has(f_info[feat].flags, TF_NO_FLOW);
+	return (feat_props[feat] & FEAT_PROP_NO_FLOW) ? true : false;
 }
 
 /**
@@ -170,7 +171,7 @@ bool feat_is_no_flow(int feat)
  */
 bool feat_is_no_scent(int feat)
 {
-	return tf_has(f_info[feat].flags, TF_NO_SCENT);
+	return (feat_props[feat] & FEAT_PROP_NO_SCENT) ? true : false;
 }
 
 /**
@@ -185,7 +186,7 @@ bool feat_is_smooth(int feat)
  * SQUARE FEATURE PREDICATES
  *
  * These functions are used to figure out what kind of square something is,
- * via c->squares[y][x].feat (preferably accessed via square(c, grid)).
+ * via c->feat[] (preferably accessed via square(c, grid)).
  * All direct testing of square(c, grid).feat should be rewritten
  * in terms of these functions.
  *
@@ -197,12 +198,20 @@ bool feat_is_smooth(int feat)
  * Use functions like square_isdiggable, square_iswall, etc. in these cases.
  */
 
+/**
+ * Test a terrain property (see set_terrain()) of the feature in a grid
+ */
+#define square_feat_has(c, grid, prop) \
+	((feat_props[(c)->feat[grid_to_i((grid), (c)->width)]] & (prop)) ? \
+	 true : false)
+
 /**
  * True if the square is normal open floor.
  */
 bool square_isfloor(struct chunk *c, struct loc grid)
 {
-	return feat_is_floor(square(c, grid).feat);
+	assert(square_in_bounds(c, grid));
+	return square_feat_has(c, grid, FEAT_PROP_FLOOR);
 }
 
 /**
@@ -210,7 +219,8 @@ bool square_isfloor(struct chunk *c, struct loc grid)
  */
 bool square_istrappable(struct chunk *c, struct loc grid)
 {
-	return feat_is_trap_holding(square(c, grid).feat);
+	assert(square_in_bounds(c, grid));
+	return square_feat_has(c, grid, FEAT_PROP_TRAP);
 }
 
 /**
@@ -218,7 +228,8 @@ bool square_istrappable(struct chunk *c, struct loc grid)
  */
 bool square_isobjectholding(struct chunk *c, struct loc grid)
 {
-	return feat_is_object_holding(square(c, grid).feat);
+	assert(square_in_bounds(c, grid));
+	return square_feat_has(c, grid, FEAT_PROP_OBJECT);
 }
 
 /**
@@ -226,8 +237,8 @@ bool square_isobjectholding(struct chunk *c, struct loc grid)
  */
 bool square_isrock(struct chunk *c, struct loc grid)
 {
-	return (tf_has(f_info[square(c, grid).feat].flags, TF_GRANITE) &&
-			!tf_has(f_info[square(c, grid).feat].flags, TF_DOOR_ANY));
+	assert(square_in_bounds(c, grid));
+	return square_feat_has(c, grid, FEAT_PROP_ROCK);
 }
 
 /**
@@ -243,8 +254,8 @@ bool square_isgranite(struct chunk *c, struct loc grid)
  */
 bool square_isperm(struct chunk *c, struct loc grid)
 {
-	return (tf_has(f_info[square(c, grid).feat].flags, TF_PERMANENT) &&
-			tf_has(f_info[square(c, grid).feat].flags, TF_ROCK));
+	assert(square_in_bounds(c, grid));
+	return square_feat_has(c, grid, FEAT_PROP_PERM);
 }
 
 /**
@@ -274,7 +285,7 @@ bool square_ismineral(struct chunk *c, struct loc grid)
 
 bool square_hasgoldvein(struct chunk *c, struct loc grid)
 {
-	return tf_has(f_info[square(c, grid).feat].flags, TF_GOLD);
+	return square_feat_has(c, grid, FEAT_PROP_GOLD);
 }
 
 /**
@@ -282,8 +293,8 @@ bool square_hasgoldvein(struct chunk *c, struct loc grid)
  */
 bool square_isrubble(struct chunk *c, struct loc grid)
 {
-    return (!tf_has(f_info[square(c, grid).feat].flags, TF_WALL) &&
-			tf_has(f_info[square(c, grid).feat].flags, TF_ROCK));
+	assert(square_in_bounds(c, grid));
+	return square_feat_has(c, grid, FEAT_PROP_RUBBLE);
 }
 
 /**
@@ -294,8 +305,8 @@ bool square_isrubble(struct chunk *c, struct loc grid)
  */
 bool square_issecretdoor(struct chunk *c, struct loc grid)
 {
-    return (tf_has(f_info[square(c, grid).feat].flags, TF_DOOR_ANY) &&
-			tf_has(f_info[square(c, grid).feat].flags, TF_ROCK));
+	assert(square_in_bounds(c, grid));
+	return square_feat_has(c, grid, FEAT_PROP_SECRET_DOOR);
 }
 
 /**
@@ -303,7 +314,8 @@ bool square_issecretdoor(struct chunk *c, struct loc grid)
  */
 bool square_isopendoor(struct chunk *c, struct loc grid)
 {
-    return (tf_has(f_info[square(c, grid).feat].flags, TF_CLOSABLE));
+	assert(square_in_bounds(c, grid));
+	return square_feat_has(c, grid, FEAT_PROP_OPEN_DOOR);
 }
 
 /**
@@ -311,8 +323,8 @@ bool square_isopendoor(struct chunk *c, struct loc grid)
  */
 bool square_iscloseddoor(struct chunk *c, struct loc grid)
 {
-	int feat = square(c, grid).feat;
-	return tf_has(f_info[feat].flags, TF_DOOR_CLOSED);
+	assert(square_in_bounds(c, grid));
+	return square_feat_has(c, grid, FEAT_PROP_CLOSED_DOOR);
 }
 
 bool square_isbrokendoor(struct chunk *c, struct loc grid)
@@ -330,8 +342,8 @@ bool square_isbrokendoor(struct chunk *c, struct loc grid)
  */
 bool square_isdoor(struct chunk *c, struct loc grid)
 {
-	int feat = square(c, grid).feat;
-	return tf_has(f_info[feat].flags, TF_DOOR_ANY);
+	assert(square_in_bounds(c, grid));
+	return square_feat_has(c, grid, FEAT_PROP_DOOR);
 }
 
 /**
@@ -339,8 +351,8 @@ bool square_isdoor(struct chunk *c, struct loc grid)
  */
 bool square_isstairs(struct chunk *c, struct loc grid)
 {
-	int feat = square(c, grid).feat;
-	return tf_has(f_info[feat].flags, TF_STAIR);
+	assert(square_in_bounds(c, grid));
+	return square_feat_has(c, grid, FEAT_PROP_STAIR);
 }
 
 /**
@@ -655,7 +667,8 @@ bool square_is_monster_walkable(struct chunk *c, struct loc grid)
  */
 bool square_ispassable(struct chunk *c, struct loc grid) {
 	assert(square_in_bounds(c, grid));
-	return feat_is_passable(square(c, grid).feat);
+	return grid_plane_has(c->passable, grid_to_i(grid, c->width)) ?
+		true : false;
 }
 
 /**
@@ -665,7 +678,8 @@ bool square_ispassable(struct chunk *c, struct loc grid) {
  */
 bool square_isprojectable(struct chunk *c, struct loc grid) {
 	if (!square_in_bounds(c, grid)) return false;
-	return feat_is_projectable(square(c, grid).feat);
+	return grid_plane_has(c->projectable, grid_to_i(grid, c->width)) ?
+		true : false;
 }
 
 /**
@@ -781,8 +795,7 @@ bool square_seemslikewall(struct chunk *c, struct loc grid)
 
 bool square_isinteresting(struct chunk *c, struct loc grid)
 {
-	int f = square(c, grid).feat;
-	return tf_has(f_info[f].flags, TF_INTERESTING);
+	return square_feat_has(c, grid, FEAT_PROP_INTERESTING);
 }
 
 /**
@@ -807,7 +820,8 @@ bool square_isplayertrap(struct chunk *c, struct loc grid)
 bool square_isvisibletrap(struct chunk *c, struct loc grid)
 {
     /* Look for a visible trap */
-    return square_trap_flag(c, grid, TRF_VISIBLE);
+    return square_istrap(c, grid) &&
+		grid_plane_has(c->trap_seen, grid_to_i(grid, c->width));
 }
 /**
  * True if the square is an unknown player trap (it will appear as a floor tile)
@@ -941,8 +955,17 @@ bool square_suits_stairs_ok(struct chunk *c, struct loc grid)
 
 struct square square(struct chunk *c, struct loc grid)
 {
+	struct square sq;
+	int i = grid_to_i(grid, c->width);
+
 	assert(square_in_bounds(c, grid));
-	return c->squares[grid.y][grid.x];
+	sq.feat = c->feat[i];
+	sq.info = &c->info[i * SQUARE_SIZE];
+	sq.light = c->light[i];
+	sq.mon = c->mon[i];
+	sq.obj = c->obj[i];
+	sq.trap = c->trap[i];
+	return sq;
 }
 
 struct feature *square_feat(struct chunk *c, struct loc grid)
@@ -957,6 +980,42 @@ int square_light(struct chunk *c, struct loc grid)
 	return square(c, grid).light;
 }
 
+/**
+ * Get the distance to a grid in a flow, as last computed by update_flow();
+ * 0 means the flow doesn't reach the grid (or that it is the source).
+ */
+int square_flow(struct chunk *c, enum flow_class fc, struct loc grid)
+{
+	struct flow_map *flow = &c->flows[fc];
+	int i = grid_to_i(grid, c->width);
+
+	assert(square_in_bounds(c, grid));
+	if (!flow->generation || flow->stamp[i] != flow->generation)
+		return 0;
+	return flow->grids[i];
+}
+
+/**
+ * Get the noise distance to a grid, as last computed by make_noise();
+ * 0 means no noise reaches the grid.
+ */
+int square_noise(struct chunk *c, struct loc grid)
+{
+	return square_flow(c, FLOW_NOISE, grid);
+}
+
+/**
+ * Get the age of the player's scent on a grid; 0 means no scent.
+ */
+int square_scent(struct chunk *c, struct loc grid)
+{
+	int i = grid_to_i(grid, c->width);
+
+	assert(square_in_bounds(c, grid));
+	if (!c->scent.laid || !c->scent.laid[i]) return 0;
+	return c->scent.strength[i] + (c->scent.turn - c->scent.laid[i]);
+}
+
 /**
  * Get a monster on the current level by its position.
  */
@@ -996,12 +1055,33 @@ bool square_holds_object(struct chunk *c, struct loc grid, struct object *obj) {
 	return pile_contains(square_object(c, grid), obj);
 }
 
+/**
+ * Keep the cell count of object grids, after a change to the pile in a
+ * grid which was (if had_obj) or was not holding objects before.
+ */
+static void square_note_pile(struct chunk *c, struct loc grid, bool had_obj)
+{
+	bool has_obj = c->obj[grid_to_i(grid, c->width)] ? true : false;
+
+	if (c->pile_summary)
+		c->pile_summary[grid_to_i(grid, c->width)].valid = false;
+
+	if (has_obj && !had_obj)
+		c->obj_cells[grid_cell(c, grid)]++;
+	else if (had_obj && !has_obj)
+		c->obj_cells[grid_cell(c, grid)]--;
+}
+
 /**
  * Excise an object from a floor pile, leaving it orphaned.
  */
 void square_excise_object(struct chunk *c, struct loc grid, struct object *obj){
+	bool had_obj;
+
 	assert(square_in_bounds(c, grid));
-	pile_excise(&c->squares[grid.y][grid.x].obj, obj);
+	had_obj = square_object(c, grid) ? true : false;
+	pile_excise(&c->obj[grid_to_i(grid, c->width)], obj);
+	square_note_pile(c, grid, had_obj);
 }
 
 /**
@@ -1037,7 +1117,7 @@ void square_know_pile(struct chunk *c, struct loc grid)
 
 	if (c != cave) return;
 
-	object_lists_check_integrity(c, player->cave);
+	object_pile_check_integrity(c, player->cave, grid);
 
 	/* Know every item on this grid, greater knowledge for the player grid */
 	for (obj = square_object(c, grid); obj; obj = obj->next) {
@@ -1130,7 +1210,12 @@ void square_set_feat(struct chunk *c, struct loc grid, int feat)
 	if (feat) c->feat_count[feat]++;
 
 	/* Make the change */
-	c->squares[grid.y][grid.x].feat = feat;
+	cave_feat_digest_change(c, grid_to_i(grid, c->width), current_feat, feat);
+	c->feat[grid_to_i(grid, c->width)] = feat;
+	square_update_planes(c, grid);
+	c->flows[FLOW_NOISE].stale = true;
+	if ((feat_props[current_feat] ^ feat_props[feat]) & FEAT_PROP_PERM)
+		c->flows[FLOW_ROCK].stale = true;
 
 	/* Light bright terrain */
 	if (feat_is_bright(feat)) {
@@ -1145,6 +1230,10 @@ void square_set_feat(struct chunk *c, struct loc grid, int feat)
 
 		square_note_spot(c, grid);
 		square_light_spot(c, grid);
+
+		/* Dormant monsters notice the ground changing under them */
+		if (square(c, grid).mon > 0)
+			monster_rejoin(c, square_monster(c, grid));
 	} else {
 		/* Make sure no incorrect wall flags set for dungeon generation */
 		sqinfo_off(square(c, grid).info, SQUARE_WALL_INNER);
@@ -1153,13 +1242,95 @@ void square_set_feat(struct chunk *c, struct loc grid, int feat)
 	}
 }
 
+/**
+ * Bring the passable, projectable and grid_class bitplanes of a chunk up to
+ * date with the feature in a grid, noting the change in the chunk's
+ * feat_stamp (and project_stamp, if projectability changed).  Anything which
+ * changes c->feat[] directly, rather than through square_set_feat(), must
+ * call this.
+ */
+void square_update_planes(struct chunk *c, struct loc grid)
+{
+	int i = grid_to_i(grid, c->width);
+	u32b props = feat_props[c->feat[i]];
+	int k;
+
+	c->feat_stamp++;
+	if (props & FEAT_PROP_PASSABLE)
+		grid_plane_on(c->passable, i);
+	else
+		grid_plane_off(c->passable, i);
+
+	if (!(props & FEAT_PROP_PROJECT) != !grid_plane_has(c->projectable, i))
+		c->project_stamp++;
+	if (props & FEAT_PROP_PROJECT)
+		grid_plane_on(c->projectable, i);
+	else
+		grid_plane_off(c->projectable, i);
+
+	for (k = 0; k < GRID_CLASS_MAX; k++) {
+		if (props & grid_class_prop[k])
+			grid_plane_on(c->classes[k], i);
+		else
+			grid_plane_off(c->classes[k], i);
+	}
+}
+
+/**
+ * Return the first index from i up to (but not including) n which is set in
+ * a bitplane, or n if there is none; clear bytes are skipped whole.
+ */
+int grid_plane_next(const bitflag *p, int i, int n)
+{
+	while (i < n) {
+		if (!(i & 7) && !p[i >> 3]) {
+			i += 8;
+			continue;
+		}
+		if (grid_plane_has(p, i)) return i;
+		i++;
+	}
+
+	return n;
+}
+
+/**
+ * True if all of the n bits of a bitplane from index i on are set; whole
+ * bytes are tested at once.
+ */
+bool grid_plane_run(const bitflag *p, int i, int n)
+{
+	int end = i + n;
+
+	/* Leading bits, up to a byte boundary */
+	while (i < end && (i & 7)) {
+		if (!grid_plane_has(p, i)) return false;
+		i++;
+	}
+
+	/* Whole bytes */
+	while (end - i >= 8) {
+		if (p[i >> 3] != 0xFF) return false;
+		i += 8;
+	}
+
+	/* Trailing bits */
+	while (i < end) {
+		if (!grid_plane_has(p, i)) return false;
+		i++;
+	}
+
+	return true;
+}
+
 /**
  * Set the player-"known" terrain type for a square.
  */
 static void square_set_known_feat(struct chunk *c, struct loc grid, int feat)
 {
 	if (c != cave) return;
-	player->cave->squares[grid.y][grid.x].feat = feat;
+	player->cave->feat[grid_to_i(grid, player->cave->width)] = feat;
+	square_update_planes(player->cave, grid);
 }
 
 /**
@@ -1167,7 +1338,16 @@ static void square_set_known_feat(struct chunk *c, struct loc grid, int feat)
  */
 void square_set_mon(struct chunk *c, struct loc grid, int midx)
 {
-	c->squares[grid.y][grid.x].mon = midx;
+	int i = grid_to_i(grid, c->width);
+
+	/* Keep the cell count of monster grids (not the player) */
+	if ((c->mon[i] > 0) != (midx > 0)) {
+		if (midx > 0)
+			c->mon_cells[grid_cell(c, grid)]++;
+		else
+			c->mon_cells[grid_cell(c, grid)]--;
+	}
+	c->mon[i] = midx;
 }
 
 /**
@@ -1175,7 +1355,32 @@ void square_set_mon(struct chunk *c, struct loc grid, int midx)
  */
 void square_set_obj(struct chunk *c, struct loc grid, struct object *obj)
 {
-	c->squares[grid.y][grid.x].obj = obj;
+	bool had_obj = square_object(c, grid) ? true : false;
+
+	c->obj[grid_to_i(grid, c->width)] = obj;
+	square_note_pile(c, grid, had_obj);
+}
+
+/**
+ * Put an object on top of a floor pile.
+ */
+void square_insert_object(struct chunk *c, struct loc grid, struct object *obj)
+{
+	bool had_obj = square_object(c, grid) ? true : false;
+
+	pile_insert(&c->obj[grid_to_i(grid, c->width)], obj);
+	square_note_pile(c, grid, had_obj);
+}
+
+/**
+ * Put an object at the bottom of a floor pile.
+ */
+void square_append_object(struct chunk *c, struct loc grid, struct object *obj)
+{
+	bool had_obj = square_object(c, grid) ? true : false;
+
+	pile_insert_end(&c->obj[grid_to_i(grid, c->width)], obj);
+	square_note_pile(c, grid, had_obj);
 }
 
 /**
@@ -1183,7 +1388,30 @@ void square_set_obj(struct chunk *c, struct loc grid, struct object *obj)
  */
 void square_set_trap(struct chunk *c, struct loc grid, struct trap *trap)
 {
-	c->squares[grid.y][grid.x].trap = trap;
+	c->trap[grid_to_i(grid, c->width)] = trap;
+	square_note_traps(c, grid);
+}
+
+/**
+ * Bring the trapped and trap_seen bitplanes of a chunk up to date with the
+ * traps in a grid.  Anything which makes a trap visible, or changes a trap
+ * list other than through square_set_trap(), must call this.
+ */
+void square_note_traps(struct chunk *c, struct loc grid)
+{
+	int i = grid_to_i(grid, c->width);
+	struct trap *trap = c->trap[i];
+
+	grid_plane_off(c->trapped, i);
+	grid_plane_off(c->trap_seen, i);
+	if (trap)
+		grid_plane_on(c->trapped, i);
+	for (; trap; trap = trap->next) {
+		if (trf_has(trap->flags, TRF_VISIBLE)) {
+			grid_plane_on(c->trap_seen, i);
+			break;
+		}
+	}
 }
 
 void square_add_trap(struct chunk *c, struct loc grid)
@@ -81,7 +81,7 @@ int distance(struct loc grid1, struct loc grid2)
  * determining which grids are illuminated by the player's torch, and which
  * grids and monsters can be "seen" by the player, etc).
  */
-bool los(struct chunk *c, struct loc grid1, struct loc grid2)
+static bool los_trace(struct chunk *c, struct loc grid1, struct loc grid2)
 {
 	/* Delta */
 	int dx, dy;
@@ -130,19 +130,11 @@ bool los(struct chunk *c, struct loc grid1, struct loc grid2)
 		return (true);
 	}
 
-	/* Directly East/West */
+	/* Directly East/West -- the grids between are a run of the bitplane */
 	if (!dy) {
-		/* East -- check for walls */
-		if (dx > 0) {
-			for (tx = grid1.x + 1; tx < grid2.x; tx++)
-				if (!square_isprojectable(c, loc(tx, grid1.y))) return (false);
-		} else { /* West -- check for walls */
-			for (tx = grid1.x - 1; tx > grid2.x; tx--)
-				if (!square_isprojectable(c, loc(tx, grid1.y))) return (false);
-		}
-
-		/* Assume los */
-		return (true);
+		tx = MIN(grid1.x, grid2.x) + 1;
+		return grid_plane_run(c->projectable, grid_to_i(loc(tx, grid1.y),
+			c->width), ax - 1);
 	}
 
 
@@ -246,6 +238,72 @@ bool los(struct chunk *c, struct loc grid1, struct loc grid2)
 	return (true);
 }
 
+/**
+ * Rays at least this long (in grids along the major axis) are remembered
+ * in the chunk's los memo; shorter ones are quicker to trace again.
+ */
+#define LOS_MEMO_MIN	6
+
+/**
+ * Determine if there is line of sight from grid1 to grid2 (see los_trace()).
+ *
+ * Longer rays are answered from a small direct-mapped memo in the chunk when
+ * possible.  Each entry records the project_stamp it was traced under, so any
+ * change to which grids are projectable makes every entry stale at once.
+ */
+bool los(struct chunk *c, struct loc grid1, struct loc grid2)
+{
+	int from, to;
+	u32b hash;
+	struct los_memo *memo;
+
+	if (MAX(ABS(grid2.x - grid1.x), ABS(grid2.y - grid1.y)) < LOS_MEMO_MIN)
+		return los_trace(c, grid1, grid2);
+
+	if (!c->los_memo)
+		c->los_memo = mem_zalloc(LOS_MEMO_SIZE * sizeof(struct los_memo));
+
+	from = grid_to_i(grid1, c->width);
+	to = grid_to_i(grid2, c->width);
+	hash = ((u32b) from * 2654435761U) ^ (u32b) to;
+	memo = &c->los_memo[(hash ^ (hash >> 16)) & (LOS_MEMO_SIZE - 1)];
+
+	if (memo->stamp != c->project_stamp || memo->from != from ||
+		memo->to != to) {
+		memo->from = from;
+		memo->to = to;
+		memo->stamp = c->project_stamp;
+		memo->result = los_trace(c, grid1, grid2);
+	}
+	return memo->result;
+}
+
+/**
+ * Determine if there is line of sight from a grid to the player.
+ *
+ * Between two projectable grids los() gives the same answer both ways,
+ * except for the knight's moves, which look at the grid beside the first.
+ * So while the player stands where update_view() last worked out the view,
+ * and nothing projectable has changed since, SQUARE_VIEW already holds the
+ * answer for every monster.  Walls (which borrow sight from a neighbour in
+ * the view), grids beyond max_sight and knight's moves get the full test.
+ */
+bool los_to_player(struct chunk *c, struct loc grid)
+{
+	int ax = ABS(grid.x - player->grid.x);
+	int ay = ABS(grid.y - player->grid.y);
+
+	if (c == cave && c->view_stamp == c->project_stamp &&
+		loc_eq(c->view_grid, player->grid) &&
+		distance(grid, player->grid) <= z_info->max_sight &&
+		!(ax == 1 && ay == 2) && !(ax == 2 && ay == 1) &&
+		square_isprojectable(c, grid) &&
+		square_isprojectable(c, player->grid))
+		return square_isview(c, grid);
+
+	return los(c, grid, player->grid);
+}
+
 /**
  * The comments below are still predominantly true, and have been left
  * (slightly modified for accuracy) for historical and nostalgic reasons.
@@ -287,8 +345,7 @@ bool los(struct chunk *c, struct loc grid1, struct loc grid2)
  * twice is inconsequential compared to the speed increase.
  *
  * Several pieces of information about each cave grid are stored in the
- * info field of the "cave->squares" array, which is a special array of
- * bitflags.
+ * "cave->info" array, which holds a set of bitflags for each grid.
  *
  * The "SQUARE_ROOM" flag is used to determine which grids are part of "rooms", 
  * and thus which grids are affected by "illumination" spells.
@@ -428,45 +485,78 @@ bool los(struct chunk *c, struct loc grid1, struct loc grid2)
 
 /**
  * Mark the currently seen grids, then wipe in preparation for recalculating
+ *
+ * Only grids inside the bounding box of the last calculated view can have
+ * view flags set, so only those need to be visited.
  */
 static void mark_wasseen(struct chunk *c)
 {
 	int x, y;
 	/* Save the old "view" grids for later */
-	for (y = 0; y < c->height; y++) {
-		for (x = 0; x < c->width; x++) {
-			struct loc grid = loc(x, y);
-			if (square_isseen(c, grid))
-				sqinfo_on(square(c, grid).info, SQUARE_WASSEEN);
-			sqinfo_off(square(c, grid).info, SQUARE_VIEW);
-			sqinfo_off(square(c, grid).info, SQUARE_SEEN);
+	for (y = c->view_tl.y; y <= c->view_br.y; y++) {
+		bitflag *info = &c->info[(y * c->width + c->view_tl.x) * SQUARE_SIZE];
+		for (x = c->view_tl.x; x <= c->view_br.x; x++, info += SQUARE_SIZE) {
+			if (sqinfo_has(info, SQUARE_SEEN))
+				sqinfo_on(info, SQUARE_WASSEEN);
+			sqinfo_off(info, SQUARE_VIEW);
+			sqinfo_off(info, SQUARE_SEEN);
 		}
 	}
 }
 
+/**
+ * Is a grid inside the box from tl to br?
+ */
+static bool loc_in_box(struct loc grid, struct loc tl, struct loc br)
+{
+	return grid.x >= tl.x && grid.x <= br.x && grid.y >= tl.y &&
+		grid.y <= br.y;
+}
+
 /**
  * Calculate light level for every grid in view - stolen from Sil
+ *
+ * Light is only read for grids the player might see, so only the grids
+ * inside the box from tl to br (the one update_view() is about to look at)
+ * are worked out.  The last view box is cleared first, which leaves every
+ * grid outside the current one dark rather than stale.
  */
-static void calc_lighting(struct chunk *c, struct player *p)
+static void calc_lighting(struct chunk *c, struct player *p, struct loc tl,
+						  struct loc br)
 {
 	int dir, k, x, y;
 	int light = p->state.cur_light, radius = ABS(light) - 1;
 	int old_light = square_light(c, p->grid);
 
+	/* Clear the last box */
+	for (y = c->view_tl.y; y <= c->view_br.y; y++) {
+		for (x = c->view_tl.x; x <= c->view_br.x; x++) {
+			c->light[y * c->width + x] = 0;
+		}
+	}
+
 	/* Starting values based on permanent light */
-	for (y = 0; y < c->height; y++) {
-		for (x = 0; x < c->width; x++) {
+	for (y = tl.y; y <= br.y; y++) {
+		for (x = tl.x; x <= br.x; x++) {
+			int i = y * c->width + x;
+			c->light[i] = sqinfo_has(&c->info[i * SQUARE_SIZE], SQUARE_GLOW) ?
+				1 : 0;
+		}
+	}
+
+	/* Squares with bright terrain have intensity 2, and light their
+	 * neighbours, so look one grid beyond the box for them */
+	for (y = MAX(tl.y - 1, 0); y <= MIN(br.y + 1, c->height - 1); y++) {
+		for (x = MAX(tl.x - 1, 0); x <= MIN(br.x + 1, c->width - 1); x++) {
 			struct loc grid = loc(x, y);
-			c->squares[y][x].light = square_isglow(c, grid) ? 1 : 0;
-
-			/* Squares with bright terrain have intensity 2 */
-			if (square_isbright(c, grid)) {
-				c->squares[y][x].light += 2;
-				for (dir = 0; dir < 8; dir++) {
-					struct loc adj_grid = loc_sum(grid, ddgrid_ddd[dir]);
-					if (!square_in_bounds(c, adj_grid)) continue;
-					c->squares[adj_grid.y][adj_grid.x].light += 1;
-				}
+
+			if (!feat_is_bright(c->feat[y * c->width + x])) continue;
+			if (loc_in_box(grid, tl, br))
+				c->light[y * c->width + x] += 2;
+			for (dir = 0; dir < 8; dir++) {
+				struct loc adj_grid = loc_sum(grid, ddgrid_ddd[dir]);
+				if (!loc_in_box(adj_grid, tl, br)) continue;
+				c->light[grid_to_i(adj_grid, c->width)] += 1;
 			}
 		}
 	}
@@ -483,10 +573,10 @@ static void calc_lighting(struct chunk *c, struct player *p)
 			/* Adjust the light level */
 			if (light > 0) {
 				/* Light getting less further away */
-				c->squares[grid.y][grid.x].light += light - dist;
+				c->light[grid_to_i(grid, c->width)] += light - dist;
 			} else {
 				/* Light getting greater further away */
-				c->squares[grid.y][grid.x].light += light + dist;
+				c->light[grid_to_i(grid, c->width)] += light + dist;
 			}
 		}
 	}
@@ -521,10 +611,10 @@ static void calc_lighting(struct chunk *c, struct player *p)
 				/* Adjust the light level */
 				if (light > 0) {
 					/* Light getting less further away */
-					c->squares[grid.y][grid.x].light += light - dist;
+					c->light[grid_to_i(grid, c->width)] += light - dist;
 				} else {
 					/* Light getting greater further away */
-					c->squares[grid.y][grid.x].light += light + dist;
+					c->light[grid_to_i(grid, c->width)] += light + dist;
 				}
 			}
 		}
@@ -643,10 +733,19 @@ static void update_view_one(struct chunk *c, struct loc grid, struct player *p)
  */
 static void update_one(struct chunk *c, struct loc grid, int blind)
 {
-	/* Remove view if blind, check visible squares for traps */
-	if (blind) {
-		sqinfo_off(square(c, grid).info, SQUARE_SEEN);
-	} else if (square_isseen(c, grid)) {
+	bitflag *info = &c->info[grid_to_i(grid, c->width) * SQUARE_SIZE];
+
+	/* Remove view if blind */
+	if (blind)
+		sqinfo_off(info, SQUARE_SEEN);
+
+	/* Nothing to do for the many grids which neither are nor were seen */
+	if (!sqinfo_has(info, SQUARE_SEEN) && !sqinfo_has(info, SQUARE_WASSEEN))
+		return;
+
+	/* Check visible squares for traps */
+	if (square_isseen(c, grid) &&
+		grid_plane_has(c->trapped, grid_to_i(grid, c->width))) {
 		square_reveal_trap(c, grid, false, true);
 	}
 
@@ -680,6 +779,11 @@ static void update_one(struct chunk *c, struct loc grid, int blind)
 void update_view(struct chunk *c, struct player *p)
 {
 	int x, y;
+	int d = z_info->max_sight;
+	struct loc tl = loc(MAX(p->grid.x - d, 0), MAX(p->grid.y - d, 0));
+	struct loc br = loc(MIN(p->grid.x + d, c->width - 1),
+						MIN(p->grid.y + d, c->height - 1));
+	struct loc old_tl = c->view_tl, old_br = c->view_br;
 
 	/* Record the current view */
 	mark_wasseen(c);
@@ -692,16 +796,23 @@ void update_view(struct chunk *c, struct player *p)
 	}
 
 	/* Calculate light levels */
-	calc_lighting(c, p);
+	calc_lighting(c, p, tl, br);
 
-	/* Squares we have LOS to get marked as in the view, and perhaps seen */
-	for (y = 0; y < c->height; y++)
-		for (x = 0; x < c->width; x++)
+	/* Squares we have LOS to get marked as in the view, and perhaps seen;
+	 * nothing outside the sight radius can be */
+	for (y = tl.y; y <= br.y; y++)
+		for (x = tl.x; x <= br.x; x++)
 			update_view_one(c, loc(x, y), p);
-
-	/* Update each grid */
-	for (y = 0; y < c->height; y++)
-		for (x = 0; x < c->width; x++)
+	c->view_tl = tl;
+	c->view_br = br;
+	c->view_grid = p->grid;
+	c->view_stamp = c->project_stamp;
+
+	/* Update each grid which was or is now in view */
+	tl = loc(MIN(tl.x, old_tl.x), MIN(tl.y, old_tl.y));
+	br = loc(MAX(br.x, old_br.x), MAX(br.y, old_br.y));
+	for (y = tl.y; y <= br.y; y++)
+		for (x = tl.x; x <= br.x; x++)
 			update_one(c, loc(x, y), p->timed[TMD_BLIND]);
 }
 
@@ -32,6 +32,8 @@
 #include "object.h"
 #include "player-timed.h"
 #include "trap.h"
+#include "z-names.h"
+#include "z-queue.h"
 
 struct feature *f_info;
 struct chunk *cave = NULL;
@@ -54,6 +56,16 @@ int FEAT_GRANITE;
 int FEAT_PERM;
 int FEAT_LAVA;
 
+u32b *feat_props;
+
+const u32b grid_class_prop[GRID_CLASS_MAX] = {
+	FEAT_PROP_DOOR,
+	FEAT_PROP_STAIR,
+	FEAT_PROP_GOLD,
+	FEAT_PROP_OPEN,
+	FEAT_PROP_INTERESTING
+};
+
 /**
  * Global array for looping through the "keypad directions".
  */
@@ -253,6 +265,29 @@ const byte side_dirs[20][8] = {
 	{9, 8, 6, 7, 3, 4, 2, 1}
 };
 
+/**
+ * Used to convert grid into an array index (i) in a chunk of width w.
+ * \param grid location
+ * \param w area width
+ * \return index
+ */
+int grid_to_i(struct loc grid, int w)
+{
+    return grid.y * w + grid.x;
+}
+
+/**
+ * Used to convert an array index (i) into grid in a chunk of width w.
+ * \param i grid index
+ * \param w area width
+ * \param grid location
+ */
+void i_to_grid(int i, int w, struct loc *grid)
+{
+    grid->y = i / w;
+    grid->x = i % w;
+}
+
 /**
  * Given a "start" and "finish" location, extract a "direction",
  * which will move one step from the "start" towards the "finish".
@@ -290,6 +325,11 @@ struct loc next_grid(struct loc grid, int dir)
 	return loc(grid.x + ddgrid[dir].x, grid.y + ddgrid[dir].y);
 }
 
+/**
+ * Terrain feature indices by name, made when the first is looked for
+ */
+static struct name_table *feat_names;
+
 /**
  * Find a terrain feature index by name
  */
@@ -297,27 +337,39 @@ int lookup_feat(const char *name)
 {
 	int i;
 
-	/* Look for it */
-	for (i = 0; i < z_info->f_max; i++) {
-		struct feature *feat = &f_info[i];
-		if (!feat->name)
-			continue;
-
-		/* Test for equality */
-		if (streq(name, feat->name))
-			return i;
+	if (!feat_names) {
+		feat_names = name_table_new(z_info->f_max, false);
+		for (i = 0; i < z_info->f_max; i++)
+			if (f_info[i].name)
+				name_table_add(feat_names, f_info[i].name, 0, i);
 	}
 
+	/* Look for it */
+	i = name_table_find(feat_names, name, 0);
+	if (i >= 0)
+		return i;
+
 	/* Fail horribly */
 	quit_fmt("Failed to find terrain feature %s", name);
 	return -1;
 }
 
+/**
+ * Forget the feature names, when f_info is freed
+ */
+void feat_names_free(void)
+{
+	name_table_free(feat_names);
+	feat_names = NULL;
+}
+
 /**
  * Set terrain constants to the indices from terrain.txt
  */
 void set_terrain(void)
 {
+	int i;
+
 	FEAT_NONE = lookup_feat("unknown grid");
 	FEAT_FLOOR = lookup_feat("open floor");
 	FEAT_CLOSED = lookup_feat("closed door");
@@ -335,50 +387,165 @@ void set_terrain(void)
 	FEAT_GRANITE = lookup_feat("granite wall");
 	FEAT_PERM = lookup_feat("permanent wall");
 	FEAT_LAVA = lookup_feat("lava");
+
+	/* Work out the terrain properties */
+	mem_free(feat_props);
+	feat_props = mem_zalloc(z_info->f_max * sizeof(*feat_props));
+	for (i = 0; i < z_info->f_max; i++) {
+		bitflag *flags = f_info[i].flags;
+		u32b props = 0;
+
+		if (tf_has(flags, TF_PASSABLE)) props |= FEAT_PROP_PASSABLE;
+		if (tf_has(flags, TF_PROJECT)) props |= FEAT_PROP_PROJECT;
+		if (tf_has(flags, TF_FLOOR)) props |= FEAT_PROP_FLOOR;
+		if (tf_has(flags, TF_WALL)) props |= FEAT_PROP_WALL;
+		if (tf_has(flags, TF_GRANITE) && !tf_has(flags, TF_DOOR_ANY))
+			props |= FEAT_PROP_ROCK;
+		if (tf_has(flags, TF_PERMANENT) && tf_has(flags, TF_ROCK))
+			props |= FEAT_PROP_PERM;
+		if (!tf_has(flags, TF_WALL) && tf_has(flags, TF_ROCK))
+			props |= FEAT_PROP_RUBBLE;
+		if (tf_has(flags, TF_DOOR_ANY)) props |= FEAT_PROP_DOOR;
+		if (tf_has(flags, TF_DOOR_ANY) && tf_has(flags, TF_ROCK))
+			props |= FEAT_PROP_SECRET_DOOR;
+		if (tf_has(flags, TF_DOOR_CLOSED)) props |= FEAT_PROP_CLOSED_DOOR;
+		if (tf_has(flags, TF_CLOSABLE)) props |= FEAT_PROP_OPEN_DOOR;
+		if (tf_has(flags, TF_STAIR)) props |= FEAT_PROP_STAIR;
+		if (tf_has(flags, TF_TRAP)) props |= FEAT_PROP_TRAP;
+		if (tf_has(flags, TF_OBJECT)) props |= FEAT_PROP_OBJECT;
+		if (tf_has(flags, TF_TORCH)) props |= FEAT_PROP_TORCH;
+		if (tf_has(flags, TF_BRIGHT)) props |= FEAT_PROP_BRIGHT;
+		if (tf_has(flags, TF_NO_FLOW)) props |= FEAT_PROP_NO_FLOW;
+		if (tf_has(flags, TF_NO_SCENT)) props |= FEAT_PROP_NO_SCENT;
+		if (tf_has(flags, TF_GOLD)) props |= FEAT_PROP_GOLD;
+		if (!tf_has(flags, TF_ROCK)) props |= FEAT_PROP_OPEN;
+		if (tf_has(flags, TF_INTERESTING)) props |= FEAT_PROP_INTERESTING;
+
+		feat_props[i] = props;
+	}
 }
 
 /**
  * Allocate a new chunk of the world
  */
 struct chunk *cave_new(int height, int width) {
-	int y, x;
+	int size = height * width;
+	int i;
+	enum mem_tag tag = mem_tag_set(MEM_TAG_CAVE);
 
 	struct chunk *c = mem_zalloc(sizeof *c);
 	c->height = height;
 	c->width = width;
 	c->feat_count = mem_zalloc((z_info->f_max + 1) * sizeof(int));
 
-	c->squares = mem_zalloc(c->height * sizeof(struct square*));
-	c->noise.grids = mem_zalloc(c->height * sizeof(u16b*));
-	c->scent.grids = mem_zalloc(c->height * sizeof(u16b*));
-	for (y = 0; y < c->height; y++) {
-		c->squares[y] = mem_zalloc(c->width * sizeof(struct square));
-		for (x = 0; x < c->width; x++) {
-			c->squares[y][x].info = mem_zalloc(SQUARE_SIZE * sizeof(bitflag));
-		}
-		c->noise.grids[y] = mem_zalloc(c->width * sizeof(u16b));
-		c->scent.grids[y] = mem_zalloc(c->width * sizeof(u16b));
+	c->feat = mem_zalloc(size * sizeof(byte));
+	c->info = mem_zalloc(size * SQUARE_SIZE * sizeof(bitflag));
+	c->light = mem_zalloc(size * sizeof(int));
+	c->mon = mem_zalloc(size * sizeof(s16b));
+	c->obj = mem_zalloc(size * sizeof(struct object*));
+	c->trap = mem_zalloc(size * sizeof(struct trap*));
+
+	/* Nothing has been placed yet */
+	c->cell_wid = (width + GRID_CELL - 1) >> GRID_CELL_SHIFT;
+	c->mon_cells = mem_zalloc(c->cell_wid *
+		((height + GRID_CELL - 1) >> GRID_CELL_SHIFT) * sizeof(byte));
+	c->obj_cells = mem_zalloc(c->cell_wid *
+		((height + GRID_CELL - 1) >> GRID_CELL_SHIFT) * sizeof(byte));
+
+	/* Every grid starts as feature zero */
+	c->passable = mem_zalloc(GRID_PLANE_SIZE(size) * sizeof(bitflag));
+	c->projectable = mem_zalloc(GRID_PLANE_SIZE(size) * sizeof(bitflag));
+	c->trapped = mem_zalloc(GRID_PLANE_SIZE(size) * sizeof(bitflag));
+	c->trap_seen = mem_zalloc(GRID_PLANE_SIZE(size) * sizeof(bitflag));
+	if (feat_props[0] & FEAT_PROP_PASSABLE)
+		memset(c->passable, 0xFF, GRID_PLANE_SIZE(size) * sizeof(bitflag));
+	if (feat_props[0] & FEAT_PROP_PROJECT)
+		memset(c->projectable, 0xFF, GRID_PLANE_SIZE(size) * sizeof(bitflag));
+	for (i = 0; i < GRID_CLASS_MAX; i++) {
+		c->classes[i] = mem_zalloc(GRID_PLANE_SIZE(size) * sizeof(bitflag));
+		if (feat_props[0] & grid_class_prop[i])
+			memset(c->classes[i], 0xFF,
+				GRID_PLANE_SIZE(size) * sizeof(bitflag));
 	}
+	c->project_stamp = 1;
+	c->feat_stamp = 1;
+
+	/* Traps may come with timeouts (from a savefile, say), so check once */
+	c->traps_timed = true;
+
+	/* Nothing is known about the view yet, so cover the whole chunk */
+	c->view_tl = loc(0, 0);
+	c->view_br = loc(width - 1, height - 1);
+
+	/* The noise and scent maps are made when the level is first played on;
+	 * see make_noise() and update_scent() */
 
 	c->objects = mem_zalloc(OBJECT_LIST_SIZE * sizeof(struct object*));
 	c->obj_max = OBJECT_LIST_SIZE - 1;
 
-	c->monsters = mem_zalloc(z_info->level_monster_max *sizeof(struct monster));
+	c->monsters = mem_zalloc(MONSTER_BLOCKS(z_info->level_monster_max) *
+							 sizeof(struct monster *));
 	c->mon_max = 1;
 	c->mon_current = -1;
+	free_slots_reset(&c->mon_free, z_info->level_monster_max);
+
+	c->mon_changed = mem_zalloc(z_info->level_monster_max * sizeof(s16b));
+	c->mon_handled = mem_zalloc(z_info->level_monster_max * sizeof(s16b));
 
+	/* Monsters loaded from a savefile may already be marked as handled */
+	c->mon_handled_all = true;
 	c->monster_groups = mem_zalloc(z_info->level_monster_max *
 								   sizeof(struct monster_group*));
+	free_slots_reset(&c->group_free, z_info->level_monster_max);
 
 	c->turn = turn;
+	mem_tag_set(tag);
 	return c;
 }
 
+/**
+ * Free the packed grids of a stored chunk, with the objects and traps on them
+ */
+static void cave_free_packed(struct packed_grids *packed)
+{
+	int i;
+
+	for (i = 0; i < packed->num_contents; i++) {
+		struct grid_contents *here = &packed->contents[i];
+		struct trap *trap = here->trap;
+
+		while (trap) {
+			struct trap *next = trap->next;
+			mem_free(trap);
+			trap = next;
+		}
+		if (here->obj)
+			object_pile_free(here->obj);
+	}
+	mem_free(packed->runs);
+	mem_free(packed->contents);
+	mem_free(packed);
+}
+
+/**
+ * Free the candidate pools built for cave_find() and friends
+ */
+static void cave_free_grid_pools(struct chunk *c)
+{
+	while (c->grid_pools) {
+		struct grid_pool *pool = c->grid_pools;
+
+		c->grid_pools = pool->next;
+		mem_free(pool->grids);
+		mem_free(pool);
+	}
+}
+
 /**
  * Free a chunk
  */
 void cave_free(struct chunk *c) {
-	int y, x;
+	int i;
 
 	while (c->join) {
 		struct connector *current = c->join;
@@ -387,55 +554,367 @@ void cave_free(struct chunk *c) {
 		mem_free(current);
 	}
 
-	for (y = 0; y < c->height; y++) {
-		for (x = 0; x < c->width; x++) {
-			mem_free(c->squares[y][x].info);
-			if (c->squares[y][x].trap)
-				square_free_trap(c, loc(x, y));
-			if (c->squares[y][x].obj)
-				object_pile_free(c->squares[y][x].obj);
+	/* Stored chunks keep their objects and traps with the packed grids */
+	if (c->packed) {
+		cave_free_packed(c->packed);
+	} else {
+		for (i = 0; i < c->height * c->width; i++) {
+			struct loc grid;
+
+			i_to_grid(i, c->width, &grid);
+			if (c->trap[i])
+				square_free_trap(c, grid);
+			if (c->obj[i])
+				object_pile_free(c->obj[i]);
 		}
-		mem_free(c->squares[y]);
-		mem_free(c->noise.grids[y]);
-		mem_free(c->scent.grids[y]);
 	}
-	mem_free(c->squares);
-	mem_free(c->noise.grids);
-	mem_free(c->scent.grids);
+	mem_free(c->feat);
+	mem_free(c->info);
+	mem_free(c->light);
+	mem_free(c->mon);
+	mem_free(c->obj);
+	mem_free(c->trap);
+	mem_free(c->mon_cells);
+	mem_free(c->obj_cells);
+	mem_free(c->passable);
+	mem_free(c->projectable);
+	mem_free(c->trapped);
+	mem_free(c->trap_seen);
+	for (i = 0; i < GRID_CLASS_MAX; i++)
+		mem_free(c->classes[i]);
+	mem_free(c->los_memo);
+	mem_free(c->path_memo);
+	mem_free(c->to_player);
+	mem_free(c->to_player_known);
+	mem_free(c->pile_summary);
+	mem_free(c->floors.cell_start);
+	mem_free(c->floors.grids);
+	mem_free(c->floors.cell_score);
+	mem_free(c->floors.found);
+	cave_free_grid_pools(c);
+	for (i = 0; i < FLOW_MAX; i++) {
+		mem_free(c->flows[i].grids);
+		mem_free(c->flows[i].stamp);
+		if (c->flows[i].queue)
+			q_free(c->flows[i].queue);
+	}
+	mem_free(c->scent.strength);
+	mem_free(c->scent.laid);
 
+	mem_free(c->saved);
 	mem_free(c->feat_count);
 	mem_free(c->objects);
+	mem_free(c->obj_free.slots);
+	for (i = 0; c->monsters && i < MONSTER_BLOCKS(z_info->level_monster_max);
+		 i++)
+		mem_free(c->monsters[i]);
 	mem_free(c->monsters);
+	mem_free(c->mon_free.slots);
 	mem_free(c->monster_groups);
+	mem_free(c->group_free.slots);
+	mem_free(c->mon_changed);
+	mem_free(c->mon_handled);
+	mem_free(c->schedule.queue.entries);
+	mem_free(c->schedule.dormant.entries);
+	mem_free(c->schedule.due);
 	if (c->name)
 		string_free(c->name);
 	mem_free(c);
 }
 
+/**
+ * Free the working data a chunk has for the grids the player is on: light,
+ * noise and scent, the bitplanes and the memos, all of which are either
+ * worked out again from the terrain or start afresh when the level is in
+ * use again
+ */
+static void cave_free_working_data(struct chunk *c)
+{
+	int i;
+
+	mem_free(c->light);
+	mem_free(c->passable);
+	mem_free(c->projectable);
+	mem_free(c->trapped);
+	mem_free(c->trap_seen);
+	for (i = 0; i < GRID_CLASS_MAX; i++)
+		mem_free(c->classes[i]);
+	mem_free(c->los_memo);
+	mem_free(c->path_memo);
+	mem_free(c->to_player);
+	mem_free(c->to_player_known);
+	mem_free(c->pile_summary);
+	mem_free(c->floors.cell_start);
+	mem_free(c->floors.grids);
+	mem_free(c->floors.cell_score);
+	mem_free(c->floors.found);
+	cave_free_grid_pools(c);
+	for (i = 0; i < FLOW_MAX; i++) {
+		mem_free(c->flows[i].grids);
+		mem_free(c->flows[i].stamp);
+		if (c->flows[i].queue)
+			q_free(c->flows[i].queue);
+	}
+	mem_free(c->scent.strength);
+	mem_free(c->scent.laid);
+
+	c->light = NULL;
+	c->passable = NULL;
+	c->projectable = NULL;
+	c->trapped = NULL;
+	c->trap_seen = NULL;
+	for (i = 0; i < GRID_CLASS_MAX; i++)
+		c->classes[i] = NULL;
+	c->los_memo = NULL;
+	c->path_memo = NULL;
+	c->to_player = NULL;
+	c->to_player_known = NULL;
+	c->pile_summary = NULL;
+	memset(&c->floors, 0, sizeof(c->floors));
+	for (i = 0; i < FLOW_MAX; i++) {
+		c->flows[i].grids = NULL;
+		c->flows[i].stamp = NULL;
+		c->flows[i].queue = NULL;
+		c->flows[i].generation = 0;
+	}
+	c->scent.strength = NULL;
+	c->scent.laid = NULL;
+}
+
+/**
+ * Whether two grids have the same terrain and square flags
+ */
+static bool same_terrain(struct chunk *c, int i, int j)
+{
+	return c->feat[i] == c->feat[j] &&
+		sqinfo_is_equal(&c->info[i * SQUARE_SIZE], &c->info[j * SQUARE_SIZE]);
+}
+
+/**
+ * Pack the per-grid data of a chunk which is being stored, to be unpacked
+ * by cave_unpack() when it is next used.
+ *
+ * Terrain and square flags are kept as runs of identical grids, which are
+ * long on most levels, and monsters, objects and traps only for the grids
+ * which have them; everything else is dropped and rebuilt.  The monster
+ * and object lists, connectors and counts are left as they are.
+ */
+void cave_pack(struct chunk *c)
+{
+	int size = c->height * c->width;
+	struct packed_grids *packed;
+	struct grid_run *run;
+	int i, num, length;
+	enum mem_tag tag;
+
+	if (c->packed || !size) return;
+	tag = mem_tag_set(MEM_TAG_CAVE);
+	packed = mem_zalloc(sizeof(*packed));
+
+	/* Count the runs, which can be no longer than a u16b allows, and the
+	 * grids with something in them */
+	for (i = 0, num = 0, length = 0; i < size; i++, length++) {
+		if (!i || length == 0xFFFF || !same_terrain(c, i, i - 1)) {
+			packed->num_runs++;
+			length = 0;
+		}
+		if (c->mon[i] || c->obj[i] || c->trap[i])
+			num++;
+	}
+
+	packed->runs = mem_zalloc(packed->num_runs * sizeof(struct grid_run));
+	packed->contents = mem_zalloc(MAX(num, 1) * sizeof(struct grid_contents));
+
+	/* Fill them in the same way */
+	run = packed->runs;
+	for (i = 0; i < size; i++) {
+		if (i && (run->length == 0xFFFF || !same_terrain(c, i, i - 1)))
+			run++;
+		if (!run->length) {
+			run->feat = c->feat[i];
+			sqinfo_copy(run->info, &c->info[i * SQUARE_SIZE]);
+		}
+		run->length++;
+
+		if (c->mon[i] || c->obj[i] || c->trap[i]) {
+			struct grid_contents *here =
+				&packed->contents[packed->num_contents++];
+
+			here->grid = i;
+			here->mon = c->mon[i];
+			here->obj = c->obj[i];
+			here->trap = c->trap[i];
+		}
+	}
+	assert(run == &packed->runs[packed->num_runs - 1]);
+
+	mem_free(c->feat);
+	mem_free(c->info);
+	mem_free(c->mon);
+	mem_free(c->obj);
+	mem_free(c->trap);
+	c->feat = NULL;
+	c->info = NULL;
+	c->mon = NULL;
+	c->obj = NULL;
+	c->trap = NULL;
+	cave_free_working_data(c);
+
+	c->packed = packed;
+	mem_tag_set(tag);
+}
+
+/**
+ * Restore the per-grid data of a chunk packed by cave_pack()
+ */
+void cave_unpack(struct chunk *c)
+{
+	struct packed_grids *packed = c->packed;
+	int size = c->height * c->width;
+	int i, j, k, n;
+	enum mem_tag tag;
+
+	if (!packed) return;
+
+	tag = mem_tag_set(MEM_TAG_CAVE);
+	c->feat = mem_zalloc(size * sizeof(byte));
+	c->info = mem_zalloc(size * SQUARE_SIZE * sizeof(bitflag));
+	c->light = mem_zalloc(size * sizeof(int));
+	c->mon = mem_zalloc(size * sizeof(s16b));
+	c->obj = mem_zalloc(size * sizeof(struct object*));
+	c->trap = mem_zalloc(size * sizeof(struct trap*));
+	c->passable = mem_zalloc(GRID_PLANE_SIZE(size) * sizeof(bitflag));
+	c->projectable = mem_zalloc(GRID_PLANE_SIZE(size) * sizeof(bitflag));
+	c->trapped = mem_zalloc(GRID_PLANE_SIZE(size) * sizeof(bitflag));
+	c->trap_seen = mem_zalloc(GRID_PLANE_SIZE(size) * sizeof(bitflag));
+	for (k = 0; k < GRID_CLASS_MAX; k++)
+		c->classes[k] = mem_zalloc(GRID_PLANE_SIZE(size) * sizeof(bitflag));
+	mem_tag_set(tag);
+
+	for (i = 0, n = 0; i < packed->num_runs; i++) {
+		struct grid_run *run = &packed->runs[i];
+		u32b props = feat_props[run->feat];
+
+		for (j = 0; j < run->length; j++, n++) {
+			c->feat[n] = run->feat;
+			sqinfo_copy(&c->info[n * SQUARE_SIZE], run->info);
+			if (props & FEAT_PROP_PASSABLE)
+				grid_plane_on(c->passable, n);
+			if (props & FEAT_PROP_PROJECT)
+				grid_plane_on(c->projectable, n);
+			for (k = 0; k < GRID_CLASS_MAX; k++)
+				if (props & grid_class_prop[k])
+					grid_plane_on(c->classes[k], n);
+		}
+	}
+	assert(n == size);
+
+	for (i = 0; i < packed->num_contents; i++) {
+		struct grid_contents *here = &packed->contents[i];
+
+		c->mon[here->grid] = here->mon;
+		c->obj[here->grid] = here->obj;
+		if (here->trap) {
+			struct loc grid;
+
+			i_to_grid(here->grid, c->width, &grid);
+			square_set_trap(c, grid, here->trap);
+		}
+	}
+
+	/* Anything worked out from the old terrain is out of date */
+	c->feat_stamp++;
+	c->project_stamp++;
+
+	mem_free(packed->runs);
+	mem_free(packed->contents);
+	mem_free(packed);
+	c->packed = NULL;
+}
+
+
+/**
+ * Note that slot idx of a table may have become free
+ */
+void free_slots_push(struct free_slots *f, int idx)
+{
+	/* Rather than grow, forget the list is complete and search later */
+	if (f->num >= f->size) {
+		f->complete = false;
+		return;
+	}
+	f->slots[f->num++] = idx;
+}
+
+/**
+ * Take the most recently freed slot, or 0 if there are none
+ */
+int free_slots_pop(struct free_slots *f)
+{
+	return f->num ? f->slots[--f->num] : 0;
+}
+
+/**
+ * Empty a list of free slots, making room for size of them
+ */
+void free_slots_reset(struct free_slots *f, int size)
+{
+	if (size > f->size) {
+		f->slots = mem_realloc(f->slots, size * sizeof(u16b));
+		f->size = size;
+	}
+	f->num = 0;
+	f->complete = false;
+}
+
+/**
+ * Whether slot i of a chunk's object list can be given to a new object
+ */
+static bool object_slot_usable(struct chunk *c, int i)
+{
+	if (i < 1 || i >= c->obj_max || c->objects[i])
+		return false;
+
+	/* If there is a known object, skip this slot */
+	if ((c == cave) && player->cave && player->cave->objects[i])
+		return false;
+
+	return true;
+}
 
 /**
  * Enter an object in the list of objects for the current level/chunk.  This
- * function is robust against listing of duplicates or non-objects
+ * function is robust against listing of duplicates or non-objects.
+ *
+ * Freed slots are kept in c->obj_free, so that neither the check for
+ * duplicates nor finding a hole needs to look through the list.
  */
 void list_object(struct chunk *c, struct object *obj)
 {
-	int i, newsize;
+	int i, newsize, old_max = c->obj_max;
 
 	/* Check for duplicates and objects already deleted or combined */
 	if (!obj) return;
-	for (i = 1; i < c->obj_max; i++)
-		if (c->objects[i] == obj)
-			return;
+	if (obj->oidx > 0 && obj->oidx < c->obj_max && c->objects[obj->oidx] == obj)
+		return;
 
 	/* Put objects in holes in the object list */
-	for (i = 1; i < c->obj_max; i++) {
-		/* If there is a known object, skip this slot */
-		if ((c == cave) && player->cave && player->cave->objects[i]) {
+	while (true) {
+		i = free_slots_pop(&c->obj_free);
+		if (!i) {
+			if (c->obj_free.complete) break;
+
+			/* Find all the holes, lowest last so it is used first */
+			free_slots_reset(&c->obj_free, c->obj_max);
+			for (i = c->obj_max - 1; i > 0; i--)
+				if (object_slot_usable(c, i))
+					free_slots_push(&c->obj_free, i);
+			c->obj_free.complete = true;
 			continue;
 		}
 
 		/* Put the object in a hole */
-		if (c->objects[i] == NULL) {
+		if (object_slot_usable(c, i)) {
 			c->objects[i] = obj;
 			obj->oidx = i;
 			return;
@@ -451,6 +930,12 @@ void list_object(struct chunk *c, struct object *obj)
 		c->objects[i] = NULL;
 	c->obj_max += OBJECT_LIST_INCR;
 
+	/* The new holes are the only ones */
+	free_slots_reset(&c->obj_free, c->obj_max);
+	for (i = c->obj_max - 1; i > old_max; i--)
+		free_slots_push(&c->obj_free, i);
+	c->obj_free.complete = true;
+
 	/* If we're on the current level, extend the known list */
 	if ((c == cave) && player->cave) {
 		player->cave->objects = mem_realloc(player->cave->objects, newsize);
@@ -472,6 +957,12 @@ void delist_object(struct chunk *c, struct object *obj)
 	/* Don't delist an actual object if it still has a listed known object */
 	if ((c == cave) && player->cave->objects[obj->oidx]) return;
 
+	/* Forgetting a known object may free the slot of the actual one */
+	if (cave && (c == player->cave))
+		free_slots_push(&cave->obj_free, obj->oidx);
+	else
+		free_slots_push(&c->obj_free, obj->oidx);
+
 	c->objects[obj->oidx] = NULL;
 	obj->oidx = 0;
 }
@@ -505,6 +996,36 @@ void object_lists_check_integrity(struct chunk *c, struct chunk *c_k)
 	}
 }
 
+/**
+ * Check the part of a pair of object lists which relates to the objects on
+ * one grid; this is what object_lists_check_integrity() checks, but only for
+ * the objects the player may be about to learn about
+ */
+void object_pile_check_integrity(struct chunk *c, struct chunk *c_k,
+								 struct loc grid)
+{
+	struct object *obj;
+
+	for (obj = square_object(c, grid); obj; obj = obj->next) {
+		struct object *known_obj;
+
+		if (!obj->oidx) continue;
+		assert(c->objects[obj->oidx] == obj);
+		known_obj = c_k->objects[obj->oidx];
+		if (known_obj) {
+			if (player->upkeep->playing) {
+				assert(known_obj == obj->known);
+			}
+			assert(known_obj->oidx == obj->oidx);
+		}
+	}
+	for (obj = square_object(c_k, grid); obj; obj = obj->next) {
+		assert(obj->oidx);
+		assert(c_k->objects[obj->oidx] == obj);
+		assert(c->objects[obj->oidx]);
+	}
+}
+
 /**
  * Standard "find me a location" function, now with all legal outputs!
  *
@@ -547,8 +1068,18 @@ void scatter(struct chunk *c, struct loc *place, struct loc grid, int d,
  * Get a monster on the current level by its index.
  */
 struct monster *cave_monster(struct chunk *c, int idx) {
+	struct monster **block;
+
 	if (idx <= 0) return NULL;
-	return &c->monsters[idx];
+
+	/* Make the monster's block the first time it is wanted */
+	block = &c->monsters[idx >> MONSTER_BLOCK_SHIFT];
+	if (!*block) {
+		enum mem_tag tag = mem_tag_set(MEM_TAG_CAVE);
+		*block = mem_zalloc(MONSTER_BLOCK * sizeof(struct monster));
+		mem_tag_set(tag);
+	}
+	return &(*block)[idx & (MONSTER_BLOCK - 1)];
 }
 
 /**
@@ -565,6 +1096,82 @@ int cave_monster_count(struct chunk *c) {
 	return c->mon_cnt;
 }
 
+/**
+ * The part of the feature digest for one grid
+ */
+static u32b grid_feat_digest(int i, int feat)
+{
+	u32b h = (u32b) i * 2654435761u ^ (u32b) feat * 40503u;
+
+	h ^= h >> 16;
+	h *= 0x85ebca6bu;
+	h ^= h >> 13;
+	return h;
+}
+
+/**
+ * Keep the feature digest up to date as grid `i` changes feature
+ */
+void cave_feat_digest_change(struct chunk *c, int i, int old_feat,
+							 int new_feat)
+{
+	if (!c->feat_digest_known) return;
+	c->feat_digest += grid_feat_digest(i, new_feat) -
+		grid_feat_digest(i, old_feat);
+}
+
+/**
+ * A digest of the features of all the grids, summed over the grids so that
+ * it can be kept up to date as they change rather than worked out afresh.
+ */
+u32b cave_feat_digest(struct chunk *c)
+{
+	int i;
+
+	if (c->feat_digest_known) return c->feat_digest;
+
+	c->feat_digest = 0;
+	for (i = 0; i < c->height * c->width; i++)
+		c->feat_digest += grid_feat_digest(i, c->feat[i]);
+	c->feat_digest_known = true;
+	return c->feat_digest;
+}
+
+/**
+ * Note a monster coming onto the level, or taking on its race
+ */
+void cave_monster_hearing_add(struct chunk *c, const struct monster *mon) {
+	if (c->hearing_known)
+		c->hearing_max = MAX(c->hearing_max, mon->race->hearing);
+}
+
+/**
+ * Note a monster leaving the level, or giving up its race; if it might have
+ * had the keenest hearing, that is found again when next wanted
+ */
+void cave_monster_hearing_remove(struct chunk *c, const struct monster *mon) {
+	if (mon->race->hearing >= c->hearing_max)
+		c->hearing_known = false;
+}
+
+/**
+ * The keenest hearing of any monster on the level, or 0 if there are none.
+ */
+int cave_monster_hearing(struct chunk *c) {
+	int i;
+
+	if (c->hearing_known) return c->hearing_max;
+
+	c->hearing_max = 0;
+	for (i = 1; i < cave_monster_max(c); i++) {
+		struct monster *mon = cave_monster(c, i);
+		if (mon->race)
+			c->hearing_max = MAX(c->hearing_max, mon->race->hearing);
+	}
+	c->hearing_known = true;
+	return c->hearing_max;
+}
+
 /**
  * Return the number of doors/traps around (or under) the character.
  */
@@ -609,3 +1216,75 @@ struct loc cave_find_decoy(struct chunk *c)
 {
 	return c->decoy;
 }
+
+/**
+ * Step on to the next grid of a rectangle holding a monster (or, if not
+ * monsters, an object), skipping the cells which hold none.
+ */
+static bool cave_next_grid(struct chunk *c, bool monsters, struct loc top_left,
+		struct loc bottom_right, struct loc *grid)
+{
+	const byte *cells = monsters ? c->mon_cells : c->obj_cells;
+	struct loc tl = loc(MAX(top_left.x, 0), MAX(top_left.y, 0));
+	struct loc br = loc(MIN(bottom_right.x, c->width - 1),
+		MIN(bottom_right.y, c->height - 1));
+	struct loc next = loc(grid->x + 1, grid->y);
+
+	if (next.y < tl.y)
+		next = tl;
+	else if (next.x < tl.x)
+		next.x = tl.x;
+
+	while (next.y <= br.y) {
+		int i;
+
+		/* End of a row */
+		if (next.x > br.x) {
+			next = loc(tl.x, next.y + 1);
+			continue;
+		}
+
+		/* Skip to the next cell along if this one is empty */
+		if (!cells[grid_cell(c, next)]) {
+			next.x = (next.x | (GRID_CELL - 1)) + 1;
+			continue;
+		}
+
+		i = grid_to_i(next, c->width);
+		if (monsters ? c->mon[i] > 0 : c->obj[i] != NULL) {
+			*grid = next;
+			return true;
+		}
+		next.x++;
+	}
+
+	return false;
+}
+
+/**
+ * Find the next grid holding a monster in the rectangle from top_left to
+ * bottom_right, going along each row in turn, as a scan of every grid would.
+ * *grid is the last grid found, and should start just left of top_left:
+ *
+ *	struct loc grid = loc(top_left.x - 1, top_left.y);
+ *	while (cave_next_monster_grid(c, top_left, bottom_right, &grid)) ...
+ *
+ * The rectangle is clipped to the chunk.  Only cells of the chunk which hold
+ * monsters are looked at, so the cost follows the number found rather than
+ * the size of the rectangle.
+ */
+bool cave_next_monster_grid(struct chunk *c, struct loc top_left,
+		struct loc bottom_right, struct loc *grid)
+{
+	return cave_next_grid(c, true, top_left, bottom_right, grid);
+}
+
+/**
+ * Find the next grid holding floor objects in a rectangle; see
+ * cave_next_monster_grid().
+ */
+bool cave_next_object_grid(struct chunk *c, struct loc top_left,
+		struct loc bottom_right, struct loc *grid)
+{
+	return cave_next_grid(c, false, top_left, bottom_right, grid);
+}
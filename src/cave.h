@@ -22,9 +22,11 @@
 #include "z-type.h"
 #include "z-bitflag.h"
 
+struct chunk;
 struct player;
 struct monster;
 struct monster_group;
+struct queue;
 
 extern const s16b ddd[9];
 extern const s16b ddx[10];
@@ -155,6 +157,10 @@ struct grid_data {
 	bool hallucinate;
 };
 
+/**
+ * A view of the per-grid data of a chunk at one location, as returned by
+ * square(); the chunk itself stores each field as a flat array.
+ */
 struct square {
 	byte feat;
 	bitflag *info;
@@ -168,6 +174,48 @@ struct heatmap {
     u16b **grids;
 };
 
+/**
+ * The ways of getting about the level which have a flow of their own
+ */
+enum flow_class {
+	FLOW_NOISE,		/* Sound, which rock stops; see make_noise() */
+	FLOW_ROCK,		/* Passing or killing walls, which only permanent
+					 * rock stops */
+	FLOW_MAX
+};
+
+/**
+ * Distances from the player (or decoy) for one flow_class, as computed by
+ * update_flow().
+ *
+ * Rather than being wiped each turn, each grid carries the generation in
+ * which it was last reached; a grid whose stamp is out of date is silent.
+ * The queue is kept between turns so the flood fill doesn't allocate.
+ */
+struct flow_map {
+	u16b *grids;		/* Distance per grid, valid if stamp matches */
+	u32b *stamp;		/* Generation in which each grid was reached */
+	u32b generation;	/* Current generation, 0 if never computed */
+	struct queue *queue;	/* Scratch queue for the flood fill */
+	struct loc source;	/* Grid the flow was last made from */
+	struct loc player;	/* Player grid when the flow was last made */
+	int limit;			/* Furthest distance filled, 0 for no limit */
+	bool stale;			/* Terrain has changed since then */
+};
+
+/**
+ * The player's scent trail, as laid by update_scent().
+ *
+ * Instead of aging every grid each turn, each grid records the strength of
+ * the scent laid there and the scent turn it was laid in; its current value
+ * is that strength plus the number of scent turns since.
+ */
+struct scent_trail {
+	byte *strength;	/* Strength of the scent when laid */
+	u32b *laid;		/* Scent turn it was laid in, 0 if no scent */
+	u32b turn;		/* Scent turn, advanced once per player turn */
+};
+
 struct connector {
 	struct loc grid;
 	byte feat;
@@ -175,6 +223,178 @@ struct connector {
 	struct connector *next;
 };
 
+/**
+ * An entry in a monster schedule; only valid while the monster's own
+ * sched_turn still matches its key
+ */
+struct mon_sched_entry {
+	s32b key;
+	s16b midx;
+};
+
+/**
+ * A binary heap of schedule entries, smallest key first
+ */
+struct mon_heap {
+	struct mon_sched_entry *entries;
+	int num;
+	int size;
+};
+
+/**
+ * The live monsters on a level, ordered by the game turn in which they next
+ * have enough energy to act; maintained by mon-move.c
+ */
+struct mon_schedule {
+	struct mon_heap queue;		/* Keyed by game turn next due */
+	struct mon_heap dormant;	/* Dormant monsters, keyed by travel to wake */
+	s16b *due;			/* Monsters due in due_turn, highest index first */
+	int due_num;
+	int due_pos;		/* Progress of the current pass through due */
+	s32b due_turn;
+	s32b pass_turn;		/* Turn of the last full monster pass, */
+	int pass_pos;		/* and the index that pass has got down to */
+	s32b travel;		/* Distance moved by the player and noise source */
+	struct loc travel_player;
+	struct loc travel_source;
+	bool built;			/* False until built from the monster list */
+	bool keep_energy;	/* Don't rebase stored energy when building */
+};
+
+/**
+ * Number of entries in a chunk's line of sight memo; must be a power of two
+ */
+#define LOS_MEMO_SIZE	1024
+
+/**
+ * A remembered los() answer, good while the chunk's project_stamp is
+ * still the stamp it was worked out under
+ */
+struct los_memo {
+	int from;
+	int to;
+	u32b stamp;
+	bool result;
+};
+
+/**
+ * Number of entries in a chunk's projection path memo (a power of two), and
+ * the longest path an entry can hold
+ */
+#define PATH_MEMO_SIZE	256
+#define PATH_MEMO_LEN	32
+
+/**
+ * A remembered project_path(), good while the chunk's project_stamp is
+ * still the stamp it was traced under
+ */
+struct path_memo {
+	int from;
+	int to;
+	int range;
+	int flg;
+	u32b stamp;
+	int n;
+	struct loc path[PATH_MEMO_LEN];
+};
+
+/**
+ * Classes of terrain kept as a bitplane each in every chunk, so detection and
+ * mapping only visit the grids that can match; grid_class_prop[] gives the
+ * FEAT_PROP_* bit behind each
+ */
+enum grid_class {
+	GRID_CLASS_DOOR,
+	GRID_CLASS_STAIR,
+	GRID_CLASS_GOLD,
+	GRID_CLASS_OPEN,		/* doesn't look like a wall */
+	GRID_CLASS_INTERESTING,	/* worth looking at when targeting */
+	GRID_CLASS_MAX
+};
+
+/**
+ * The floor grids of a level grouped by GRID_CELL, for teleport searches;
+ * rebuilt whenever the chunk's feat_stamp has moved on
+ */
+struct floor_index {
+	u32b stamp;
+	int *cell_start;		/* Where each cell's grids start in grids */
+	struct loc *grids;		/* Row order within each cell */
+	int *cell_score;		/* Workspace for a search */
+	struct loc *found;
+};
+
+/**
+ * The grids of a rectangle of a level which passed a predicate, for
+ * cave_find() and friends during generation.  Grids which have since failed
+ * are dropped as they are come across, and the whole pool is rebuilt whenever
+ * the chunk's feat_stamp has moved on.
+ */
+struct grid_pool {
+	bool (*pred)(struct chunk *c, struct loc grid);
+	struct loc top_left;
+	struct loc bottom_right;
+	u32b stamp;
+	int num;
+	int *grids;			/* Indices from grid_to_i(), in no order */
+	struct grid_pool *next;
+};
+
+/**
+ * What map_info() shows of a known floor pile; valid only while nothing is
+ * added to or taken from the pile, and for the ignore settings and object
+ * knowledge it was worked out with
+ */
+struct pile_summary {
+	struct object_kind *first_kind;
+	bool multiple_objects;
+	bool unseen_object;
+	bool unseen_money;
+	bool valid;
+	bool unignoring;
+	u32b ignore_generation;
+	u32b knowledge_version;
+};
+
+/**
+ * Indexes of slots in one of a chunk's tables which have been freed, to be
+ * handed out again without searching the table.  A slot may be taken by
+ * other means while it is in the list, so each one is checked as it is
+ * popped; once the list runs dry the table is searched once to refill it,
+ * unless it is known to hold every free slot already.
+ */
+struct free_slots {
+	u16b *slots;
+	int num;
+	int size;
+	bool complete;
+};
+
+/**
+ * The per-grid data of a stored chunk, packed by cave_pack(): terrain and
+ * square flags as runs of identical grids, and monsters, objects and traps
+ * for just the grids which have them
+ */
+struct grid_run {
+	u16b length;
+	byte feat;
+	bitflag info[SQUARE_SIZE];
+};
+
+struct grid_contents {
+	int grid;
+	s16b mon;
+	struct object *obj;
+	struct trap *trap;
+};
+
+struct packed_grids {
+	struct grid_run *runs;
+	int num_runs;
+	struct grid_contents *contents;
+	int num_contents;
+};
+
 struct chunk {
 	char *name;
 	s32b turn;
@@ -191,23 +411,88 @@ struct chunk {
 	u16b feeling_squares; /* How many feeling squares the player has visited */
 	int *feat_count;
 
-	struct square **squares;
-	struct heatmap noise;
-	struct heatmap scent;
+	/* Per-grid data, stored as flat arrays indexed by grid_to_i() */
+	byte *feat;
+	bitflag *info;		/* SQUARE_SIZE bitflags per grid */
+	int *light;
+	s16b *mon;
+	struct object **obj;
+	struct trap **trap;
+	bool traps_timed;	/* False only if no trap is disabled for a while */
+
+	/* Number of grids holding monsters or objects in each GRID_CELL */
+	int cell_wid;
+	byte *mon_cells;
+	byte *obj_cells;
+
+	/* Passable and projectable grids, one bit each (see grid_plane_has) */
+	bitflag *passable;
+	bitflag *projectable;
+	bitflag *trapped;		/* Grids with traps, and with visible traps, */
+	bitflag *trap_seen;		/* kept by square_note_traps() */
+	bitflag *classes[GRID_CLASS_MAX];	/* Grids in each grid_class */
+	u32b project_stamp;		/* Bumped whenever a projectable bit changes */
+	u32b feat_stamp;		/* Bumped whenever any grid's feature is set */
+	u32b feat_digest;		/* Digest of the features, if known (see */
+	bool feat_digest_known;	/* cave_feat_digest()) */
+	struct floor_index floors;
+	struct grid_pool *grid_pools;	/* Built by cave_find() and friends */
+	struct los_memo *los_memo;	/* Allocated on first use by los() */
+	struct path_memo *path_memo;	/* Allocated by project_path() */
+	struct pile_summary *pile_summary;	/* Allocated by map_info() */
+
+	struct loc view_tl;		/* Bounding box of the grids which */
+	struct loc view_br;		/* update_view() last put in view, */
+	struct loc view_grid;	/* from where the player stood, */
+	u32b view_stamp;		/* under this project_stamp */
+
+	bitflag *to_player;		/* Grids projectable to the player, for */
+	bitflag *to_player_known;	/* those worked out (see */
+	struct loc to_player_grid;	/* projectable_to_player()) */
+	u32b to_player_stamp;
+
+	struct flow_map flows[FLOW_MAX];
+	struct scent_trail scent;
 	struct loc decoy;
 
 	struct object **objects;
 	u16b obj_max;
+	struct free_slots obj_free;	/* See list_object() */
 
-	struct monster *monsters;
+	struct monster **monsters;	/* Blocks of MONSTER_BLOCK; see cave_monster() */
 	u16b mon_max;
 	u16b mon_cnt;
+	struct free_slots mon_free;	/* See mon_pop() */
+	int hearing_max;		/* Keenest hearing of the monsters, if */
+	bool hearing_known;		/* known (see cave_monster_hearing()) */
 	int mon_current;
 	int num_repro;
 
 	struct monster_group **monster_groups;
+	struct free_slots group_free;	/* See monster_group_index_new() */
+	s16b *mon_changed;		/* Monsters marked by monster_mark_changed() */
+	int mon_changed_num;
+	s16b *mon_handled;		/* Monsters given MFLAG_HANDLED this turn, */
+	int mon_handled_num;
+	bool mon_handled_all;	/* or true if that isn't known */
+	struct mon_schedule schedule;
 
 	struct connector *join;
+
+	/* While set, the per-grid arrays above are freed; see cave_pack() */
+	struct packed_grids *packed;
+
+	/* What wr_chunks() last wrote for this chunk, while it is unchanged on
+	 * the chunk list */
+	byte *saved;
+	u32b saved_size;
+
+	/* Only the name and depth have been read from the savefile, and the
+	 * rest is in saved; see rd_stored_chunk() */
+	bool unread;
+
+	/* Hash of the name, set while the chunk is on the chunk list */
+	u32b name_hash;
 };
 
 /*** Feature Indexes (see "lib/gamedata/terrain.txt") ***/
@@ -241,6 +526,39 @@ extern int FEAT_GRANITE;
 extern int FEAT_PERM;
 extern int FEAT_LAVA;
 
+/*** Terrain properties ***/
+
+/**
+ * The terrain flag tests behind the common square predicates, worked out
+ * for each feature by set_terrain() so that each is a single bit test
+ */
+enum {
+	FEAT_PROP_PASSABLE		= 0x00000001,
+	FEAT_PROP_PROJECT		= 0x00000002,
+	FEAT_PROP_FLOOR			= 0x00000004,
+	FEAT_PROP_WALL			= 0x00000008,
+	FEAT_PROP_ROCK			= 0x00000010,	/* granite, not a door */
+	FEAT_PROP_PERM			= 0x00000020,	/* permanent rock */
+	FEAT_PROP_RUBBLE		= 0x00000040,	/* rock, not a wall */
+	FEAT_PROP_DOOR			= 0x00000080,
+	FEAT_PROP_SECRET_DOOR	= 0x00000100,	/* door that is rock */
+	FEAT_PROP_CLOSED_DOOR	= 0x00000200,
+	FEAT_PROP_OPEN_DOOR		= 0x00000400,	/* closable */
+	FEAT_PROP_STAIR			= 0x00000800,
+	FEAT_PROP_TRAP			= 0x00001000,
+	FEAT_PROP_OBJECT		= 0x00002000,
+	FEAT_PROP_TORCH			= 0x00004000,
+	FEAT_PROP_BRIGHT		= 0x00008000,
+	FEAT_PROP_NO_FLOW		= 0x00010000,
+	FEAT_PROP_NO_SCENT		= 0x00020000,
+	FEAT_PROP_GOLD			= 0x00040000,	/* vein with treasure */
+	FEAT_PROP_OPEN			= 0x00080000,	/* not rock, so not wall-like */
+	FEAT_PROP_INTERESTING	= 0x00100000
+};
+
+extern u32b *feat_props;
+extern const u32b grid_class_prop[GRID_CLASS_MAX];
+
 
 /* Current level */
 extern struct chunk *cave;
@@ -251,6 +569,7 @@ extern u16b chunk_list_max;
 /* cave-view.c */
 int distance(struct loc grid1, struct loc grid2);
 bool los(struct chunk *c, struct loc grid1, struct loc grid2);
+bool los_to_player(struct chunk *c, struct loc grid);
 void update_view(struct chunk *c, struct player *p);
 bool no_light(void);
 
@@ -382,6 +701,9 @@ bool square_suits_stairs_ok(struct chunk *c, struct loc grid);
 struct square square(struct chunk *c, struct loc grid);
 struct feature *square_feat(struct chunk *c, struct loc grid);
 int square_light(struct chunk *c, struct loc grid);
+int square_flow(struct chunk *c, enum flow_class fc, struct loc grid);
+int square_noise(struct chunk *c, struct loc grid);
+int square_scent(struct chunk *c, struct loc grid);
 struct monster *square_monster(struct chunk *c, struct loc grid);
 struct object *square_object(struct chunk *c, struct loc grid);
 struct trap *square_trap(struct chunk *c, struct loc grid);
@@ -395,10 +717,14 @@ int square_num_walls_diagonal(struct chunk *c, struct loc grid);
 
 
 /* Feature placers */
+void square_update_planes(struct chunk *c, struct loc grid);
 void square_set_feat(struct chunk *c, struct loc grid, int feat);
 void square_set_mon(struct chunk *c, struct loc grid, int midx);
 void square_set_obj(struct chunk *c, struct loc grid, struct object *obj);
+void square_insert_object(struct chunk *c, struct loc grid, struct object *obj);
+void square_append_object(struct chunk *c, struct loc grid, struct object *obj);
 void square_set_trap(struct chunk *c, struct loc grid, struct trap *trap);
+void square_note_traps(struct chunk *c, struct loc grid);
 void square_add_trap(struct chunk *c, struct loc grid);
 void square_add_glyph(struct chunk *c, struct loc grid, int type);
 void square_add_web(struct chunk *c, struct loc grid);
@@ -433,26 +759,74 @@ void square_forget(struct chunk *c, struct loc grid);
 void square_mark(struct chunk *c, struct loc grid);
 void square_unmark(struct chunk *c, struct loc grid);
 
+/**
+ * Monsters are kept in blocks of MONSTER_BLOCK, each allocated when the
+ * level first has a monster in it, so that a level pays only for the
+ * monsters it has had and a monster never moves once placed
+ */
+#define MONSTER_BLOCK_SHIFT	5
+#define MONSTER_BLOCK		(1 << MONSTER_BLOCK_SHIFT)
+#define MONSTER_BLOCKS(n)	(((n) + MONSTER_BLOCK - 1) >> MONSTER_BLOCK_SHIFT)
+
+/**
+ * Grids are counted in square cells, GRID_CELL grids on a side, to let
+ * searches for monsters and objects skip empty parts of the map
+ */
+#define GRID_CELL_SHIFT	3
+#define GRID_CELL		(1 << GRID_CELL_SHIFT)
+#define grid_cell(c, grid) \
+	(((grid).y >> GRID_CELL_SHIFT) * (c)->cell_wid + ((grid).x >> GRID_CELL_SHIFT))
+
+/**
+ * Bitplanes hold one bit per grid, indexed by grid_to_i()
+ */
+#define GRID_PLANE_SIZE(n)		(((n) + 7) / 8)
+#define grid_plane_has(p, i)	(((p)[(i) >> 3] >> ((i) & 7)) & 1)
+#define grid_plane_on(p, i)		((p)[(i) >> 3] |= (1 << ((i) & 7)))
+#define grid_plane_off(p, i)	((p)[(i) >> 3] &= ~(1 << ((i) & 7)))
+bool grid_plane_run(const bitflag *p, int i, int n);
+int grid_plane_next(const bitflag *p, int i, int n);
+
 /* cave.c */
+int grid_to_i(struct loc grid, int w);
+void i_to_grid(int i, int w, struct loc *grid);
 int motion_dir(struct loc source, struct loc target);
 struct loc next_grid(struct loc grid, int dir);
 int lookup_feat(const char *name);
+void feat_names_free(void);
 void set_terrain(void);
 struct chunk *cave_new(int height, int width);
 void cave_free(struct chunk *c);
+void cave_pack(struct chunk *c);
+void cave_unpack(struct chunk *c);
+void free_slots_push(struct free_slots *f, int idx);
+int free_slots_pop(struct free_slots *f);
+void free_slots_reset(struct free_slots *f, int size);
 void list_object(struct chunk *c, struct object *obj);
 void delist_object(struct chunk *c, struct object *obj);
 void object_lists_check_integrity(struct chunk *c, struct chunk *c_k);
+void object_pile_check_integrity(struct chunk *c, struct chunk *c_k,
+								 struct loc grid);
 void scatter(struct chunk *c, struct loc *place, struct loc grid, int d,
 			 bool need_los);
 
 struct monster *cave_monster(struct chunk *c, int idx);
 int cave_monster_max(struct chunk *c);
 int cave_monster_count(struct chunk *c);
+void cave_feat_digest_change(struct chunk *c, int i, int old_feat,
+							 int new_feat);
+u32b cave_feat_digest(struct chunk *c);
+void cave_monster_hearing_add(struct chunk *c, const struct monster *mon);
+void cave_monster_hearing_remove(struct chunk *c, const struct monster *mon);
+int cave_monster_hearing(struct chunk *c);
 
 int count_feats(struct loc *grid,
 				bool (*test)(struct chunk *c, struct loc grid), bool under);
 struct loc cave_find_decoy(struct chunk *c);
+bool cave_next_monster_grid(struct chunk *c, struct loc top_left,
+		struct loc bottom_right, struct loc *grid);
+bool cave_next_object_grid(struct chunk *c, struct loc top_left,
+		struct loc bottom_right, struct loc *grid);
 void prepare_next_level(struct chunk **c, struct player *p);
 bool is_quest(int level);
 
@@ -498,6 +498,43 @@ static bool twall(struct loc grid)
  * Uses twall() (above) to do all "terrain feature changing".
  * Returns true if repeated commands may continue.
  */
+/**
+ * The chances of digging with the best digger, as worked out for one try of
+ * a repeated tunnel.  Wielding the digger for each try works out all the
+ * player's bonuses twice over, so the next try of the same repeat uses
+ * these instead as long as nothing about the player has changed.
+ */
+static struct {
+	struct loc grid;
+	int nrepeats;
+	struct object *digger;
+	struct object *weapon;
+	struct player_state state;
+	int chances[DIGGING_MAX];
+} dig_memo;
+
+/**
+ * Check whether this try is the next one of the repeat the digging chances
+ * were worked out for, and if not note it as the one they are for
+ */
+static bool dig_memo_check(struct loc grid, struct object *digger,
+						   struct object *weapon)
+{
+	int nrepeats = cmd_get_nrepeats();
+	bool same = nrepeats > 0 && nrepeats == dig_memo.nrepeats - 1 &&
+		loc_eq(grid, dig_memo.grid) && digger == dig_memo.digger &&
+		weapon == dig_memo.weapon &&
+		!memcmp(&player->state, &dig_memo.state, sizeof(player->state));
+
+	dig_memo.nrepeats = nrepeats;
+	if (same) return true;
+
+	dig_memo.grid = grid;
+	dig_memo.digger = digger;
+	dig_memo.weapon = weapon;
+	return false;
+}
+
 static bool do_cmd_tunnel_aux(struct loc grid)
 {
 	bool more = false;
@@ -514,23 +551,27 @@ static bool do_cmd_tunnel_aux(struct loc grid)
 
 	/* Find what we're digging with and our chance of success */
 	best_digger = player_best_digger(player);
-	if (best_digger && best_digger != current_weapon) {
-		player->body.slots[weapon_slot].obj = best_digger;
-		player->upkeep->update |= (PU_BONUS);
-		update_stuff(player);
+	if (!dig_memo_check(grid, best_digger, current_weapon)) {
+		if (best_digger && best_digger != current_weapon) {
+			player->body.slots[weapon_slot].obj = best_digger;
+			player->upkeep->update |= (PU_BONUS);
+			update_stuff(player);
+		}
+		calc_digging_chances(&player->state, dig_memo.chances);
+
+		/* Swap back */
+		if (best_digger && best_digger != current_weapon) {
+			player->body.slots[weapon_slot].obj = current_weapon;
+			player->upkeep->update |= (PU_BONUS);
+			update_stuff(player);
+		}
+		memcpy(&dig_memo.state, &player->state, sizeof(player->state));
 	}
-	calc_digging_chances(&player->state, digging_chances);
+	memcpy(digging_chances, dig_memo.chances, sizeof(digging_chances));
 
 	/* Do we succeed? */
 	okay = (digging_chances[square_digging(cave, grid) - 1] > randint0(1600));
 
-	/* Swap back */
-	if (best_digger && best_digger != current_weapon) {
-		player->body.slots[weapon_slot].obj = current_weapon;
-		player->upkeep->update |= (PU_BONUS);
-		update_stuff(player);
-	}
-
 	/* Success */
 	if (okay && twall(grid)) {
 		/* Rubble is a special case - could be handled more generally NRM */
@@ -1359,12 +1400,9 @@ void do_cmd_rest(struct command *cmd)
 	if (!player_is_resting(player))
 		return;
 
-	/* Take a turn */
+	/* Take a turn; the game loop redraws the state when it is next shown */
 	player_resting_step_turn(player);
 
-	/* Redraw the state if requested */
-	handle_stuff(player);
-
 	/* Prepare to continue, or cancel and clean up */
 	if (player_resting_count(player) > 0) {
 		cmdq_push(CMD_REST);
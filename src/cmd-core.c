@@ -35,10 +35,11 @@
 #include "target.h"
 
 errr (*cmd_get_hook)(cmd_context c);
+void (*cmd_record_hook)(struct command *cmd, bool done);
 
 /**
  * ------------------------------------------------------------------------
- * A simple list of commands and their handling functions.
+ * A table of commands and their handling functions, indexed by command code.
  * ------------------------------------------------------------------------ */
 struct command_info
 {
@@ -51,91 +52,88 @@ struct command_info
 
 static const struct command_info game_cmds[] =
 {
-	{ CMD_LOADFILE, "load a savefile", NULL, false, 0 },
-	{ CMD_NEWGAME, "start a new game", NULL, false, 0 },
-
-	{ CMD_BIRTH_INIT, "start the character birth process", do_cmd_birth_init, false, 0 },
-	{ CMD_BIRTH_RESET, "go back to the beginning", do_cmd_birth_reset, false, 0 },
-	{ CMD_CHOOSE_RACE, "select race", do_cmd_choose_race, false, 0 },
-	{ CMD_CHOOSE_CLASS, "select class", do_cmd_choose_class, false, 0 },
-	{ CMD_BUY_STAT, "buy points in a stat", do_cmd_buy_stat, false, 0 },
-	{ CMD_SELL_STAT, "sell points in a stat", do_cmd_sell_stat, false, 0 },
-	{ CMD_RESET_STATS, "reset stats", do_cmd_reset_stats, false, 0 },
-	{ CMD_ROLL_STATS, "roll new stats", do_cmd_roll_stats, false, 0 },
-	{ CMD_PREV_STATS, "use previously rolled stats", do_cmd_prev_stats, false, 0 },
-	{ CMD_NAME_CHOICE, "choose name", do_cmd_choose_name, false, 0 },
-	{ CMD_HISTORY_CHOICE, "write history", do_cmd_choose_history, false, 0 },
-	{ CMD_ACCEPT_CHARACTER, "accept character", do_cmd_accept_character, false, 0 },
-
-	{ CMD_GO_UP, "go up stairs", do_cmd_go_up, false, 0 },
-	{ CMD_GO_DOWN, "go down stairs", do_cmd_go_down, false, 0 },
-	{ CMD_WALK, "walk", do_cmd_walk, true, 0 },
-	{ CMD_RUN, "run", do_cmd_run, true, 0 },
-	{ CMD_JUMP, "jump", do_cmd_jump, false, 0 },
-	{ CMD_OPEN, "open", do_cmd_open, true, 99 },
-	{ CMD_CLOSE, "close", do_cmd_close, true, 99 },
-	{ CMD_TUNNEL, "tunnel", do_cmd_tunnel, true, 99 },
-	{ CMD_HOLD, "stay still", do_cmd_hold, true, 0 },
-	{ CMD_DISARM, "disarm", do_cmd_disarm, true, 99 },
-	{ CMD_ALTER, "alter", do_cmd_alter, true, 99 },
-	{ CMD_STEAL, "steal", do_cmd_steal, false, 0 },
-	{ CMD_REST, "rest", do_cmd_rest, false, 0 },
-	{ CMD_SLEEP, "sleep", do_cmd_sleep, false, 0 },
-	{ CMD_PATHFIND, "walk", do_cmd_pathfind, false, 0 },
-	{ CMD_PICKUP, "pickup", do_cmd_pickup, false, 0 },
-	{ CMD_AUTOPICKUP, "autopickup", do_cmd_autopickup, false, 0 },
-	{ CMD_WIELD, "wear or wield", do_cmd_wield, false, 0 },
-	{ CMD_TAKEOFF, "take off", do_cmd_takeoff, false, 0 },
-	{ CMD_DROP, "drop", do_cmd_drop, false, 0 },
-	{ CMD_UNINSCRIBE, "un-inscribe", do_cmd_uninscribe, false, 0 },
-	{ CMD_AUTOINSCRIBE, "autoinscribe", do_cmd_autoinscribe, false, 0 },
-	{ CMD_EAT, "eat", do_cmd_eat_food, false, 0 },
-	{ CMD_QUAFF, "quaff", do_cmd_quaff_potion, false, 0 },
-	{ CMD_USE_ROD, "zap", do_cmd_zap_rod, false, 0 },
-	{ CMD_USE_STAFF, "use", do_cmd_use_staff, false, 0 },
-	{ CMD_USE_WAND, "aim", do_cmd_aim_wand, false, 0 },
-	{ CMD_READ_SCROLL, "read", do_cmd_read_scroll, false, 0 },
-	{ CMD_ACTIVATE, "activate", do_cmd_activate, false, 0 },
-	{ CMD_REFILL, "refuel with", do_cmd_refill, false, 0 },
-	{ CMD_FIRE, "fire", do_cmd_fire, false, 0 },
-	{ CMD_THROW, "throw", do_cmd_throw, false, 0 },
-	{ CMD_INSCRIBE, "inscribe", do_cmd_inscribe, false, 0 },
-	{ CMD_STUDY, "study", do_cmd_study, false, 0 },
-	{ CMD_CAST, "cast", do_cmd_cast, false, 0 },
-	{ CMD_SELL, "sell", do_cmd_sell, false, 0 },
-	{ CMD_STASH, "stash", do_cmd_stash, false, 0 },
-	{ CMD_BUY, "buy", do_cmd_buy, false, 0 },
-	{ CMD_RETRIEVE, "retrieve", do_cmd_retrieve, false, 0 },
-	{ CMD_USE, "use", do_cmd_use, false, 0 },
-	{ CMD_SUICIDE, "kill character", do_cmd_suicide, false, 0 },
-	{ CMD_HELP, "help", NULL, false, 0 },
-	{ CMD_REPEAT, "repeat", NULL, false, 0 },
-
-	{ CMD_COMMAND_MONSTER, "make a monster act", do_cmd_mon_command, false, 0 },
+	[CMD_LOADFILE] = { CMD_LOADFILE, "load a savefile", NULL, false, 0 },
+	[CMD_NEWGAME] = { CMD_NEWGAME, "start a new game", NULL, false, 0 },
+
+	[CMD_BIRTH_INIT] = { CMD_BIRTH_INIT, "start the character birth process", do_cmd_birth_init, false, 0 },
+	[CMD_BIRTH_RESET] = { CMD_BIRTH_RESET, "go back to the beginning", do_cmd_birth_reset, false, 0 },
+	[CMD_CHOOSE_RACE] = { CMD_CHOOSE_RACE, "select race", do_cmd_choose_race, false, 0 },
+	[CMD_CHOOSE_CLASS] = { CMD_CHOOSE_CLASS, "select class", do_cmd_choose_class, false, 0 },
+	[CMD_BUY_STAT] = { CMD_BUY_STAT, "buy points in a stat", do_cmd_buy_stat, false, 0 },
+	[CMD_SELL_STAT] = { CMD_SELL_STAT, "sell points in a stat", do_cmd_sell_stat, false, 0 },
+	[CMD_RESET_STATS] = { CMD_RESET_STATS, "reset stats", do_cmd_reset_stats, false, 0 },
+	[CMD_ROLL_STATS] = { CMD_ROLL_STATS, "roll new stats", do_cmd_roll_stats, false, 0 },
+	[CMD_PREV_STATS] = { CMD_PREV_STATS, "use previously rolled stats", do_cmd_prev_stats, false, 0 },
+	[CMD_NAME_CHOICE] = { CMD_NAME_CHOICE, "choose name", do_cmd_choose_name, false, 0 },
+	[CMD_HISTORY_CHOICE] = { CMD_HISTORY_CHOICE, "write history", do_cmd_choose_history, false, 0 },
+	[CMD_ACCEPT_CHARACTER] = { CMD_ACCEPT_CHARACTER, "accept character", do_cmd_accept_character, false, 0 },
+
+	[CMD_GO_UP] = { CMD_GO_UP, "go up stairs", do_cmd_go_up, false, 0 },
+	[CMD_GO_DOWN] = { CMD_GO_DOWN, "go down stairs", do_cmd_go_down, false, 0 },
+	[CMD_WALK] = { CMD_WALK, "walk", do_cmd_walk, true, 0 },
+	[CMD_RUN] = { CMD_RUN, "run", do_cmd_run, true, 0 },
+	[CMD_JUMP] = { CMD_JUMP, "jump", do_cmd_jump, false, 0 },
+	[CMD_OPEN] = { CMD_OPEN, "open", do_cmd_open, true, 99 },
+	[CMD_CLOSE] = { CMD_CLOSE, "close", do_cmd_close, true, 99 },
+	[CMD_TUNNEL] = { CMD_TUNNEL, "tunnel", do_cmd_tunnel, true, 99 },
+	[CMD_HOLD] = { CMD_HOLD, "stay still", do_cmd_hold, true, 0 },
+	[CMD_DISARM] = { CMD_DISARM, "disarm", do_cmd_disarm, true, 99 },
+	[CMD_ALTER] = { CMD_ALTER, "alter", do_cmd_alter, true, 99 },
+	[CMD_STEAL] = { CMD_STEAL, "steal", do_cmd_steal, false, 0 },
+	[CMD_REST] = { CMD_REST, "rest", do_cmd_rest, false, 0 },
+	[CMD_SLEEP] = { CMD_SLEEP, "sleep", do_cmd_sleep, false, 0 },
+	[CMD_PATHFIND] = { CMD_PATHFIND, "walk", do_cmd_pathfind, false, 0 },
+	[CMD_PICKUP] = { CMD_PICKUP, "pickup", do_cmd_pickup, false, 0 },
+	[CMD_AUTOPICKUP] = { CMD_AUTOPICKUP, "autopickup", do_cmd_autopickup, false, 0 },
+	[CMD_WIELD] = { CMD_WIELD, "wear or wield", do_cmd_wield, false, 0 },
+	[CMD_TAKEOFF] = { CMD_TAKEOFF, "take off", do_cmd_takeoff, false, 0 },
+	[CMD_DROP] = { CMD_DROP, "drop", do_cmd_drop, false, 0 },
+	[CMD_UNINSCRIBE] = { CMD_UNINSCRIBE, "un-inscribe", do_cmd_uninscribe, false, 0 },
+	[CMD_AUTOINSCRIBE] = { CMD_AUTOINSCRIBE, "autoinscribe", do_cmd_autoinscribe, false, 0 },
+	[CMD_EAT] = { CMD_EAT, "eat", do_cmd_eat_food, false, 0 },
+	[CMD_QUAFF] = { CMD_QUAFF, "quaff", do_cmd_quaff_potion, false, 0 },
+	[CMD_USE_ROD] = { CMD_USE_ROD, "zap", do_cmd_zap_rod, false, 0 },
+	[CMD_USE_STAFF] = { CMD_USE_STAFF, "use", do_cmd_use_staff, false, 0 },
+	[CMD_USE_WAND] = { CMD_USE_WAND, "aim", do_cmd_aim_wand, false, 0 },
+	[CMD_READ_SCROLL] = { CMD_READ_SCROLL, "read", do_cmd_read_scroll, false, 0 },
+	[CMD_ACTIVATE] = { CMD_ACTIVATE, "activate", do_cmd_activate, false, 0 },
+	[CMD_REFILL] = { CMD_REFILL, "refuel with", do_cmd_refill, false, 0 },
+	[CMD_FIRE] = { CMD_FIRE, "fire", do_cmd_fire, false, 0 },
+	[CMD_THROW] = { CMD_THROW, "throw", do_cmd_throw, false, 0 },
+	[CMD_INSCRIBE] = { CMD_INSCRIBE, "inscribe", do_cmd_inscribe, false, 0 },
+	[CMD_STUDY] = { CMD_STUDY, "study", do_cmd_study, false, 0 },
+	[CMD_CAST] = { CMD_CAST, "cast", do_cmd_cast, false, 0 },
+	[CMD_SELL] = { CMD_SELL, "sell", do_cmd_sell, false, 0 },
+	[CMD_STASH] = { CMD_STASH, "stash", do_cmd_stash, false, 0 },
+	[CMD_BUY] = { CMD_BUY, "buy", do_cmd_buy, false, 0 },
+	[CMD_RETRIEVE] = { CMD_RETRIEVE, "retrieve", do_cmd_retrieve, false, 0 },
+	[CMD_USE] = { CMD_USE, "use", do_cmd_use, false, 0 },
+	[CMD_SUICIDE] = { CMD_SUICIDE, "kill character", do_cmd_suicide, false, 0 },
+	[CMD_HELP] = { CMD_HELP, "help", NULL, false, 0 },
+	[CMD_REPEAT] = { CMD_REPEAT, "repeat", NULL, false, 0 },
+
+	[CMD_COMMAND_MONSTER] = { CMD_COMMAND_MONSTER, "make a monster act", do_cmd_mon_command, false, 0 },
 };
 
-const char *cmd_verb(cmd_code cmd)
-{
-	size_t i;
-	for (i = 0; i < N_ELEMENTS(game_cmds); i++) {
-		if (game_cmds[i].cmd == cmd)
-			return game_cmds[i].verb;
-	}
-	return NULL;
-}
-
 /**
- * Return the index of the given command in the command array.
+ * Return the index of the given command in the command array, which is
+ * indexed by command code; gaps in it have no verb.
  */
 static int cmd_idx(cmd_code code)
 {
-	size_t i;
+	if (code < 0 || code >= (int) N_ELEMENTS(game_cmds) ||
+		!game_cmds[code].verb)
+		return CMD_ARG_NOT_PRESENT;
 
-	for (i = 0; i < N_ELEMENTS(game_cmds); i++)
-		if (game_cmds[i].cmd == code)
-			return i;
+	assert(game_cmds[code].cmd == code);
+	return code;
+}
 
-	return CMD_ARG_NOT_PRESENT;
+const char *cmd_verb(cmd_code cmd)
+{
+	int idx = cmd_idx(cmd);
+
+	return idx == CMD_ARG_NOT_PRESENT ? NULL : game_cmds[idx].verb;
 }
 
 
@@ -203,7 +201,7 @@ void process_command(cmd_context ctx, struct command *cmd)
 
 	/* Hack - command a monster */
 	if (player->timed[TMD_COMMAND]) {
-		idx = (int) N_ELEMENTS(game_cmds) - 1;
+		idx = CMD_COMMAND_MONSTER;
 	}
 
 	/* Reset so that when selecting items, we look in the default location */
@@ -247,6 +245,7 @@ void process_command(cmd_context ctx, struct command *cmd)
 bool cmdq_pop(cmd_context c)
 {
 	struct command *cmd;
+	bool record = (cmd_record_hook != NULL) && !repeating;
 
 	/* If we're repeating, just pull the last command again. */
 	if (repeating) {
@@ -262,7 +261,9 @@ bool cmdq_pop(cmd_context c)
 	}
 
 	/* Now process it */
+	if (record) cmd_record_hook(cmd, false);
 	process_command(c, cmd);
+	if (record) cmd_record_hook(cmd, true);
 	return true;
 }
 
@@ -230,6 +230,13 @@ struct command *cmdq_peek(void);
  */
 extern errr (*cmd_get_hook)(cmd_context c);
 
+/**
+ * A function told about each command taken off the queue, just before it
+ * is carried out and again just after (with done set); the automatic
+ * repeats of a command are not passed on.
+ */
+extern void (*cmd_record_hook)(struct command *cmd, bool done);
+
 /**
  * Gets the next command from the queue and processes it
  */
@@ -133,8 +133,8 @@ static struct object *find_stack_object_in_inventory(const struct object *obj)
 {
 	struct object *gear_obj;
 	for (gear_obj = player->gear; gear_obj; gear_obj = gear_obj->next) {
-		if (!object_is_equipped(player->body, gear_obj) &&
-				object_stackable(gear_obj, obj, OSTACK_PACK)) {
+		if (object_stackable(gear_obj, obj, OSTACK_PACK) &&
+				!object_is_equipped(player->body, gear_obj)) {
 			/* We found the object */
 			return gear_obj;
 		}
@@ -0,0 +1,609 @@
+/**
+ * \file cmd-stream.c
+ * \brief Feed the game a stream of commands read from a file
+ *
+ * Copyright (c) 2026 The Angband Developers
+ *
+ * This work is free software; you can redistribute it and/or modify it
+ * under the terms of either:
+ *
+ * a) the GNU General Public License as published by the Free Software
+ *    Foundation, version 2, or
+ *
+ * b) the "Angband licence":
+ *    This software may be copied and distributed for educational, research,
+ *    and not for profit purposes provided that this copyright and statement
+ *    are included in all such copies.  Other copyrights may also apply.
+ */
+
+#include "angband.h"
+#include "cmd-stream.h"
+#include "game-world.h"
+#include "obj-util.h"
+#include "parser.h"
+#include "player.h"
+#include "savefile.h"
+#include "target.h"
+
+/**
+ * A command stream is a text file with one directive per line, in the same
+ * style as the data files:
+ *
+ *   cmd:WALK           - start a new command, optionally cmd:TUNNEL:99 to
+ *                        give it a number of repeats
+ *   direction:direction:6
+ *   choice:choice:-2
+ *   number:quantity:3
+ *   target:target:0
+ *   point:point:12:30
+ *   item:item:2        - the item at that position in the player's gear
+ *   floor:item:0       - the item at that position in the pile under the
+ *                        player
+ *   aim:target:12:30   - target the monster at that grid (or the grid
+ *                        itself) and aim the command at the target
+ *   string:name:Bob
+ *   keyframe:5000:rec.3 - the game as it was at turn 5000, saved in the
+ *                        savefile rec.3 next to the stream
+ *
+ * Argument lines apply to the command above them.  Commands are handed to
+ * the queue one at a time, so that a stream can be as long as it likes and
+ * each command sees the game as the ones before it left it; nothing in here
+ * touches the display, so streams play as fast as the game can run.
+ *
+ * Keyframes are passed over in plain play; cmd_stream_seek() uses them to
+ * start part way through a stream.
+ */
+struct cmd_stream {
+	char *path;
+	ang_file *f;
+	struct parser *p;
+	struct command cmd;		/* Command being built */
+	bool pending;			/* Is there one? */
+	bool failed;			/* Did a line fail to parse? */
+	int line;
+};
+
+/**
+ * The commands a stream can give, by the name they have in the stream
+ */
+static const struct {
+	const char *name;
+	cmd_code code;
+} stream_cmds[] = {
+	{ "GO_UP", CMD_GO_UP },
+	{ "GO_DOWN", CMD_GO_DOWN },
+	{ "WALK", CMD_WALK },
+	{ "RUN", CMD_RUN },
+	{ "JUMP", CMD_JUMP },
+	{ "OPEN", CMD_OPEN },
+	{ "CLOSE", CMD_CLOSE },
+	{ "TUNNEL", CMD_TUNNEL },
+	{ "HOLD", CMD_HOLD },
+	{ "DISARM", CMD_DISARM },
+	{ "ALTER", CMD_ALTER },
+	{ "STEAL", CMD_STEAL },
+	{ "REST", CMD_REST },
+	{ "SLEEP", CMD_SLEEP },
+	{ "PATHFIND", CMD_PATHFIND },
+	{ "PICKUP", CMD_PICKUP },
+	{ "AUTOPICKUP", CMD_AUTOPICKUP },
+	{ "WIELD", CMD_WIELD },
+	{ "TAKEOFF", CMD_TAKEOFF },
+	{ "DROP", CMD_DROP },
+	{ "EAT", CMD_EAT },
+	{ "QUAFF", CMD_QUAFF },
+	{ "USE_ROD", CMD_USE_ROD },
+	{ "USE_STAFF", CMD_USE_STAFF },
+	{ "USE_WAND", CMD_USE_WAND },
+	{ "READ_SCROLL", CMD_READ_SCROLL },
+	{ "ACTIVATE", CMD_ACTIVATE },
+	{ "REFILL", CMD_REFILL },
+	{ "FIRE", CMD_FIRE },
+	{ "THROW", CMD_THROW },
+	{ "STUDY", CMD_STUDY },
+	{ "CAST", CMD_CAST },
+	{ "USE", CMD_USE },
+	{ "INSCRIBE", CMD_INSCRIBE },
+	{ "UNINSCRIBE", CMD_UNINSCRIBE },
+	{ "AUTOINSCRIBE", CMD_AUTOINSCRIBE },
+	{ "IGNORE", CMD_IGNORE },
+};
+
+static enum parser_error parse_cmd(struct parser *p) {
+	struct cmd_stream *s = parser_priv(p);
+	const char *name = parser_getsym(p, "name");
+	size_t i;
+
+	for (i = 0; i < N_ELEMENTS(stream_cmds); i++)
+		if (streq(stream_cmds[i].name, name)) break;
+	if (i == N_ELEMENTS(stream_cmds))
+		return PARSE_ERROR_INVALID_VALUE;
+
+	memset(&s->cmd, 0, sizeof(s->cmd));
+	s->cmd.context = CTX_GAME;
+	s->cmd.code = stream_cmds[i].code;
+	if (parser_hasval(p, "repeats"))
+		s->cmd.nrepeats = parser_getuint(p, "repeats");
+	s->pending = true;
+	return PARSE_ERROR_NONE;
+}
+
+/**
+ * Get the command that an argument line applies to
+ */
+static struct command *stream_cmd(struct parser *p) {
+	struct cmd_stream *s = parser_priv(p);
+	return s->pending ? &s->cmd : NULL;
+}
+
+static enum parser_error parse_direction(struct parser *p) {
+	struct command *cmd = stream_cmd(p);
+	if (!cmd) return PARSE_ERROR_MISSING_RECORD_HEADER;
+	cmd_set_arg_direction(cmd, parser_getsym(p, "arg"),
+						  parser_getint(p, "value"));
+	return PARSE_ERROR_NONE;
+}
+
+static enum parser_error parse_choice(struct parser *p) {
+	struct command *cmd = stream_cmd(p);
+	if (!cmd) return PARSE_ERROR_MISSING_RECORD_HEADER;
+	cmd_set_arg_choice(cmd, parser_getsym(p, "arg"), parser_getint(p, "value"));
+	return PARSE_ERROR_NONE;
+}
+
+static enum parser_error parse_number(struct parser *p) {
+	struct command *cmd = stream_cmd(p);
+	if (!cmd) return PARSE_ERROR_MISSING_RECORD_HEADER;
+	cmd_set_arg_number(cmd, parser_getsym(p, "arg"), parser_getint(p, "value"));
+	return PARSE_ERROR_NONE;
+}
+
+static enum parser_error parse_target(struct parser *p) {
+	struct command *cmd = stream_cmd(p);
+	if (!cmd) return PARSE_ERROR_MISSING_RECORD_HEADER;
+	cmd_set_arg_target(cmd, parser_getsym(p, "arg"), parser_getint(p, "value"));
+	return PARSE_ERROR_NONE;
+}
+
+static enum parser_error parse_point(struct parser *p) {
+	struct command *cmd = stream_cmd(p);
+	if (!cmd) return PARSE_ERROR_MISSING_RECORD_HEADER;
+	cmd_set_arg_point(cmd, parser_getsym(p, "arg"), parser_getint(p, "x"),
+					  parser_getint(p, "y"));
+	return PARSE_ERROR_NONE;
+}
+
+static enum parser_error parse_item(struct parser *p) {
+	struct command *cmd = stream_cmd(p);
+	struct object *obj;
+	int n = parser_getuint(p, "index");
+
+	if (!cmd) return PARSE_ERROR_MISSING_RECORD_HEADER;
+	for (obj = player->gear; obj && n; obj = obj->next) n--;
+	if (!obj) return PARSE_ERROR_OUT_OF_BOUNDS;
+	cmd_set_arg_item(cmd, parser_getsym(p, "arg"), obj);
+	return PARSE_ERROR_NONE;
+}
+
+static enum parser_error parse_floor(struct parser *p) {
+	struct command *cmd = stream_cmd(p);
+	struct object *obj;
+	int n = parser_getuint(p, "index");
+
+	if (!cmd) return PARSE_ERROR_MISSING_RECORD_HEADER;
+	for (obj = square_object(cave, player->grid); obj && n; obj = obj->next)
+		n--;
+	if (!obj) return PARSE_ERROR_OUT_OF_BOUNDS;
+	cmd_set_arg_item(cmd, parser_getsym(p, "arg"), obj);
+	return PARSE_ERROR_NONE;
+}
+
+static enum parser_error parse_aim(struct parser *p) {
+	struct command *cmd = stream_cmd(p);
+	struct loc grid = loc(parser_getint(p, "x"), parser_getint(p, "y"));
+	struct monster *mon;
+
+	if (!cmd) return PARSE_ERROR_MISSING_RECORD_HEADER;
+	if (!square_in_bounds(cave, grid)) return PARSE_ERROR_OUT_OF_BOUNDS;
+	mon = square_monster(cave, grid);
+	if (!mon || !target_set_monster(mon))
+		target_set_location(grid.y, grid.x);
+	cmd_set_arg_target(cmd, parser_getsym(p, "arg"), DIR_TARGET);
+	return PARSE_ERROR_NONE;
+}
+
+static enum parser_error parse_keyframe(struct parser *p) {
+	return PARSE_ERROR_NONE;
+}
+
+static enum parser_error parse_string(struct parser *p) {
+	struct command *cmd = stream_cmd(p);
+	if (!cmd) return PARSE_ERROR_MISSING_RECORD_HEADER;
+	cmd_set_arg_string(cmd, parser_getsym(p, "arg"),
+					   parser_getstr(p, "value"));
+	return PARSE_ERROR_NONE;
+}
+
+/**
+ * Open a command stream, or return NULL if the file can't be read
+ */
+struct cmd_stream *cmd_stream_open(const char *path)
+{
+	struct cmd_stream *s;
+	ang_file *f = file_open(path, MODE_READ, FTYPE_TEXT);
+
+	if (!f) return NULL;
+
+	s = mem_zalloc(sizeof(*s));
+	s->path = string_make(path);
+	s->f = f;
+	s->p = parser_new();
+	parser_setpriv(s->p, s);
+	parser_reg(s->p, "cmd sym name ?uint repeats", parse_cmd);
+	parser_reg(s->p, "direction sym arg int value", parse_direction);
+	parser_reg(s->p, "choice sym arg int value", parse_choice);
+	parser_reg(s->p, "number sym arg int value", parse_number);
+	parser_reg(s->p, "target sym arg int value", parse_target);
+	parser_reg(s->p, "point sym arg int x int y", parse_point);
+	parser_reg(s->p, "item sym arg uint index", parse_item);
+	parser_reg(s->p, "floor sym arg uint index", parse_floor);
+	parser_reg(s->p, "aim sym arg int x int y", parse_aim);
+	parser_reg(s->p, "string sym arg str value", parse_string);
+	parser_reg(s->p, "keyframe int turn str file", parse_keyframe);
+	return s;
+}
+
+/**
+ * Close a command stream
+ */
+void cmd_stream_close(struct cmd_stream *s)
+{
+	if (!s) return;
+	if (s->f) file_close(s->f);
+	parser_destroy(s->p);
+	string_free(s->path);
+	mem_free(s);
+}
+
+/**
+ * Push the next command of a stream onto the command queue.  Return false
+ * once the stream is used up, or a line of it can't be used.
+ *
+ * Argument lines are read only when their command is about to be pushed, so
+ * item arguments refer to the gear as it is at that point.
+ */
+bool cmd_stream_next(struct cmd_stream *s)
+{
+	char buf[1024];
+
+	while (!s->failed && s->f && file_getl(s->f, buf, sizeof(buf))) {
+		bool pushed = false;
+		errr err = 0;
+
+		/* A new command finishes the one before */
+		if (prefix(buf, "cmd:") && s->pending) {
+			err = cmdq_push_copy(&s->cmd);
+			s->pending = false;
+			pushed = true;
+		}
+
+		s->line++;
+		if (parser_parse(s->p, buf) != PARSE_ERROR_NONE) {
+			plog_fmt("Command stream line %d: can't use '%s'", s->line, buf);
+			s->failed = true;
+		}
+
+		if (pushed) return !err;
+	}
+
+	/* Push the last one */
+	if (!s->failed && s->pending) {
+		s->pending = false;
+		return !cmdq_push_copy(&s->cmd);
+	}
+
+	return false;
+}
+
+/**
+ * Did the stream stop because of a line it couldn't use?
+ */
+bool cmd_stream_failed(const struct cmd_stream *s)
+{
+	return s->failed;
+}
+
+/**
+ * Play a whole command stream, running the game as far as each command
+ * takes it.  Return the number of commands played.
+ */
+int cmd_stream_play(struct cmd_stream *s)
+{
+	int n = 0;
+
+	while (!player->is_dead && cmd_stream_next(s)) {
+		run_game_loop();
+		n++;
+	}
+
+	return n;
+}
+
+/**
+ * Jump to game turn 'to' in a stream: load the last keyframe taken at or
+ * before it, then play the commands after that keyframe until the game
+ * reaches that turn.  Return false if there is no such keyframe, or it or a
+ * line after it can't be used.
+ */
+bool cmd_stream_seek(struct cmd_stream *s, s32b to)
+{
+	char buf[1024];
+	char key[1024] = "";
+	int line = 0, key_line = 0;
+	ang_file *f = file_open(s->path, MODE_READ, FTYPE_TEXT);
+
+	if (!f) return false;
+
+	/* Find the keyframe */
+	while (file_getl(f, buf, sizeof(buf))) {
+		char *name;
+
+		line++;
+		if (!prefix(buf, "keyframe:")) continue;
+		name = strchr(buf + strlen("keyframe:"), ':');
+		if (!name || atoi(buf + strlen("keyframe:")) > to) continue;
+
+		/* Keyframes are kept next to the stream */
+		my_strcpy(key, s->path, sizeof(key));
+		key[path_filename_index(key)] = '\0';
+		my_strcat(key, name + 1, sizeof(key));
+		key_line = line;
+	}
+	file_close(f);
+	if (!key_line) return false;
+
+	/* Read the stream again from just after the keyframe */
+	if (s->f) file_close(s->f);
+	s->f = file_open(s->path, MODE_READ, FTYPE_TEXT);
+	s->pending = false;
+	s->failed = false;
+	s->line = 0;
+	if (!s->f) return false;
+	while (s->line < key_line && file_getl(s->f, buf, sizeof(buf)))
+		s->line++;
+
+	if (!savefile_load(key, false)) return false;
+
+	/* Fast forward */
+	while (turn < to && !player->is_dead && cmd_stream_next(s))
+		run_game_loop();
+
+	return !s->failed;
+}
+
+
+/**
+ * ------------------------------------------------------------------------
+ * Recording
+ * ------------------------------------------------------------------------ */
+
+/**
+ * A recording writes the game commands the player gives as a command
+ * stream, so that playing the stream from the same start gives the same
+ * game.  Every so often it takes a keyframe, a savefile of the game as it
+ * is just before a command; the savefile holds the state of the random
+ * number generator with everything else, so play can start from any of
+ * them.  A command that can't be written as a stream (one not in
+ * stream_cmds[], or with an item that was neither carried nor underfoot)
+ * is followed by a keyframe instead.
+ */
+struct cmd_record {
+	ang_file *f;
+	char *path;
+	s32b every;				/* Game turns between keyframes */
+	s32b next;				/* When the next one is due */
+	int keyframes;			/* How many have been taken */
+	bool want_keyframe;		/* Take one before the next command */
+
+	/* The command being carried out, if it is being recorded: its repeat
+	 * count as it came off the queue, and the items carried and underfoot
+	 * at that point */
+	bool noting;
+	int nrepeats;
+	struct object **gear;
+	int num_gear;
+	int alloc_gear;
+	struct object **floor;
+	int num_floor;
+	int alloc_floor;
+};
+
+static struct cmd_record *record;
+
+/**
+ * Note the objects in a pile, in order
+ */
+static void record_pile(struct object ***list, int *num, int *alloc,
+						struct object *pile)
+{
+	*num = 0;
+	for (; pile; pile = pile->next) {
+		if (*num == *alloc) {
+			*alloc = *alloc ? *alloc * 2 : 32;
+			*list = mem_realloc(*list, *alloc * sizeof(**list));
+		}
+		(*list)[(*num)++] = pile;
+	}
+}
+
+static int record_pile_index(struct object **list, int num,
+							 const struct object *obj)
+{
+	int i;
+
+	for (i = 0; i < num; i++)
+		if (list[i] == obj) return i;
+	return -1;
+}
+
+/**
+ * Take a keyframe, and note it in the stream
+ */
+static void record_keyframe(void)
+{
+	char path[1024];
+
+	strnfmt(path, sizeof(path), "%s.%d", record->path, record->keyframes);
+	if (savefile_save(path)) {
+		file_putf(record->f, "keyframe:%d:%s\n", turn,
+				  path + path_filename_index(path));
+		record->keyframes++;
+	}
+
+	record->next = turn + record->every;
+	record->want_keyframe = false;
+}
+
+/**
+ * Write a command that has just been carried out to the stream, returning
+ * false if it can't be written
+ */
+static bool record_write(const struct command *cmd)
+{
+	char buf[2048];
+	size_t i;
+
+	for (i = 0; i < N_ELEMENTS(stream_cmds); i++)
+		if (stream_cmds[i].code == cmd->code) break;
+	if (i == N_ELEMENTS(stream_cmds)) return false;
+
+	if (record->nrepeats)
+		strnfmt(buf, sizeof(buf), "cmd:%s:%d\n", stream_cmds[i].name,
+				record->nrepeats);
+	else
+		strnfmt(buf, sizeof(buf), "cmd:%s\n", stream_cmds[i].name);
+
+	for (i = 0; i < CMD_MAX_ARGS; i++) {
+		const struct cmd_arg *arg = &cmd->arg[i];
+		const union cmd_arg_data *data = &arg->data;
+		char line[1024];
+		int n;
+
+		switch (arg->type) {
+			case arg_NONE:
+				continue;
+			case arg_STRING:
+				strnfmt(line, sizeof(line), "string:%s:%s\n", arg->name,
+						data->string);
+				break;
+			case arg_CHOICE:
+				strnfmt(line, sizeof(line), "choice:%s:%d\n", arg->name,
+						data->choice);
+				break;
+			case arg_NUMBER:
+				strnfmt(line, sizeof(line), "number:%s:%d\n", arg->name,
+						data->number);
+				break;
+			case arg_DIRECTION:
+				strnfmt(line, sizeof(line), "direction:%s:%d\n", arg->name,
+						data->direction);
+				break;
+			case arg_TARGET:
+				if (data->direction == DIR_TARGET) {
+					struct loc grid;
+
+					target_get(&grid);
+					strnfmt(line, sizeof(line), "aim:%s:%d:%d\n", arg->name,
+							grid.x, grid.y);
+				} else {
+					strnfmt(line, sizeof(line), "target:%s:%d\n", arg->name,
+							data->direction);
+				}
+				break;
+			case arg_POINT:
+				strnfmt(line, sizeof(line), "point:%s:%d:%d\n", arg->name,
+						data->point.x, data->point.y);
+				break;
+			case arg_ITEM:
+				n = record_pile_index(record->gear, record->num_gear,
+									  data->obj);
+				if (n >= 0) {
+					strnfmt(line, sizeof(line), "item:%s:%d\n", arg->name, n);
+					break;
+				}
+				n = record_pile_index(record->floor, record->num_floor,
+									  data->obj);
+				if (n < 0) return false;
+				strnfmt(line, sizeof(line), "floor:%s:%d\n", arg->name, n);
+				break;
+			default:
+				return false;
+		}
+		my_strcat(buf, line, sizeof(buf));
+	}
+
+	file_put(record->f, buf);
+	return true;
+}
+
+static void record_command(struct command *cmd, bool done)
+{
+	if (!done) {
+		/* Only the game itself is recorded, not the birth of the character */
+		record->noting = character_dungeon && !player->is_dead;
+		if (!record->noting) return;
+
+		if (record->want_keyframe || (turn >= record->next))
+			record_keyframe();
+
+		record->nrepeats = cmd->nrepeats;
+		record_pile(&record->gear, &record->num_gear, &record->alloc_gear,
+					player->gear);
+		record_pile(&record->floor, &record->num_floor, &record->alloc_floor,
+					square_object(cave, player->grid));
+		return;
+	}
+
+	if (!record->noting) return;
+	record->noting = false;
+	if (!record_write(cmd))
+		record->want_keyframe = true;
+	file_flush(record->f);
+}
+
+/**
+ * Start recording the game to a command stream at 'path', taking a keyframe
+ * before the first command and then every 'every' game turns
+ */
+bool cmd_record_start(const char *path, s32b every)
+{
+	ang_file *f;
+
+	cmd_record_stop();
+	f = file_open(path, MODE_WRITE, FTYPE_TEXT);
+	if (!f) return false;
+
+	record = mem_zalloc(sizeof(*record));
+	record->f = f;
+	record->path = string_make(path);
+	record->every = every;
+	record->want_keyframe = true;
+	cmd_record_hook = record_command;
+	return true;
+}
+
+/**
+ * Stop recording
+ */
+void cmd_record_stop(void)
+{
+	if (!record) return;
+
+	cmd_record_hook = NULL;
+	file_close(record->f);
+	string_free(record->path);
+	mem_free(record->gear);
+	mem_free(record->floor);
+	mem_free(record);
+	record = NULL;
+}
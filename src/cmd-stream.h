@@ -0,0 +1,35 @@
+/**
+ * \file cmd-stream.h
+ * \brief Feed the game a stream of commands read from a file
+ *
+ * Copyright (c) 2026 The Angband Developers
+ *
+ * This work is free software; you can redistribute it and/or modify it
+ * under the terms of either:
+ *
+ * a) the GNU General Public License as published by the Free Software
+ *    Foundation, version 2, or
+ *
+ * b) the "Angband licence":
+ *    This software may be copied and distributed for educational, research,
+ *    and not for profit purposes provided that this copyright and statement
+ *    are included in all such copies.  Other copyrights may also apply.
+ */
+
+#ifndef CMD_STREAM_H
+#define CMD_STREAM_H
+
+#include "cmd-core.h"
+
+struct cmd_stream;
+
+struct cmd_stream *cmd_stream_open(const char *path);
+void cmd_stream_close(struct cmd_stream *s);
+bool cmd_stream_next(struct cmd_stream *s);
+bool cmd_stream_failed(const struct cmd_stream *s);
+int cmd_stream_play(struct cmd_stream *s);
+bool cmd_stream_seek(struct cmd_stream *s, s32b to);
+bool cmd_record_start(const char *path, s32b every);
+void cmd_record_stop(void);
+
+#endif /* CMD_STREAM_H */
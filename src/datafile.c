@@ -45,7 +45,7 @@ static void print_error(struct file_parser *fp, struct parser *p) {
 	quit_fmt("Parse error in %s line %d column %d.", fp->name, s.line, s.col);
 }
 
-errr run_parser(struct file_parser *fp) {
+static errr run_parser_aux(struct file_parser *fp) {
 	struct parser *p = fp->init();
 	errr r;
 	if (!p) {
@@ -62,6 +62,17 @@ errr run_parser(struct file_parser *fp) {
 	return r;
 }
 
+/**
+ * Parse a gamedata file, accounting what it allocates to the parser
+ */
+errr run_parser(struct file_parser *fp) {
+	enum mem_tag tag = mem_tag_set(MEM_TAG_PARSER);
+	errr r = run_parser_aux(fp);
+
+	mem_tag_set(tag);
+	return r;
+}
+
 /**
  * The basic file parsing function.  Attempt to load filename through
  * parser and perform a quit if the file is not found.
@@ -75,6 +86,13 @@ errr parse_file_quit_not_found(struct parser *p, const char *filename) {
 	return parse_err;
 }
 
+/**
+ * Where parse_file() is in the file being parsed, for parse_file_mark()
+ */
+static const char *parse_path;
+static const char *parse_path_kept;
+static long parse_offset = -1;
+
 /**
  * The basic file parsing function.
  */
@@ -101,15 +119,82 @@ errr parse_file(struct parser *p, const char *filename) {
 		return PARSE_ERROR_NO_FILE_FOUND;
 
 	/* Parse it */
+	parse_path = path;
+	parse_path_kept = NULL;
+	parse_offset = file_tell(fh);
 	while (file_getl(fh, buf, sizeof(buf))) {
 		r = parser_parse(p, buf);
 		if (r)
 			break;
+		parse_offset = file_tell(fh);
 	}
+	parse_path = NULL;
+	parse_offset = -1;
 	file_close(fh);
 	return r;
 }
 
+/**
+ * Remember where the line being parsed starts, so that parse_file_desc() can
+ * read it back later; gives false when not parsing from a file.
+ */
+bool parse_file_mark(struct file_mark *mark)
+{
+	if (!parse_path || parse_offset < 0)
+		return false;
+
+	/* Keep one copy of the path for all the marks made in a file */
+	if (!parse_path_kept)
+		parse_path_kept = string_pool_make(parse_path);
+
+	mark->path = parse_path_kept;
+	mark->offset = parse_offset;
+	return true;
+}
+
+/**
+ * Read back the text of the desc: lines of a record, starting at `mark` and
+ * running to the next record; returns NULL if there are none.
+ */
+char *parse_file_desc(const struct file_mark *mark)
+{
+	char buf[1024];
+	char *text = NULL;
+	bool first = true;
+	ang_file *fh;
+
+	if (!mark->path)
+		return NULL;
+	fh = file_open(mark->path, MODE_READ, FTYPE_TEXT);
+	if (!fh)
+		return NULL;
+
+	if (file_skip(fh, mark->offset)) {
+		while (file_getl(fh, buf, sizeof(buf))) {
+			const char *line = buf;
+
+			while (*line && isspace((unsigned char)*line))
+				line++;
+
+			/* Stop at the next record */
+			if (prefix(line, "name:"))
+				break;
+
+			/* The mark should be on a desc: line */
+			if (prefix(line, "desc:")) {
+				if (line[5])
+					text = string_append(text, line + 5);
+			} else if (first) {
+				break;
+			}
+			first = false;
+		}
+	}
+
+	file_close(fh);
+	return text;
+}
+
 void cleanup_parser(struct file_parser *fp)
 {
 	fp->cleanup();
@@ -35,6 +35,8 @@ extern const char *parser_error_str[PARSE_ERROR_MAX];
 errr run_parser(struct file_parser *fp);
 errr parse_file_quit_not_found(struct parser *p, const char *filename);
 errr parse_file(struct parser *p, const char *filename);
+bool parse_file_mark(struct file_mark *mark);
+char *parse_file_desc(const struct file_mark *mark);
 void cleanup_parser(struct file_parser *fp);
 int lookup_flag(const char **flag_table, const char *flag_name);
 errr grab_rand_value(random_value *value, const char **value_type,
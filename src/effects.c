@@ -221,13 +221,11 @@ static bool project_touch(int dam, int rad, int typ, bool aware,
  */
 static bool item_tester_uncursable(const struct object *obj)
 {
-	struct curse_data *c = obj->known->curses;
-	if (c) {
-		size_t i;
-		for (i = 1; i < z_info->curse_max; i++) {
-			if (c[i].power < 100) {
-				return true;
-			}
+	int i;
+
+	for (i = 0; i < obj->known->num_curses; i++) {
+		if (obj->known->curses[i].power < 100) {
+			return true;
 		}
 	}
     return false;
@@ -238,26 +236,13 @@ static bool item_tester_uncursable(const struct object *obj)
  */
 static void remove_object_curse(struct object *obj, int index, bool message)
 {
-	struct curse_data *c = &obj->curses[index];
 	char *name = curses[index].name;
 	char *removed = format("The %s curse is removed!", name);
-	int i;
 
-	c->power = 0;
-	c->timeout = 0;
+	object_curse_remove(obj, index);
 	if (message) {
 		msg(removed);
 	}
-
-	/* Check to see if that was the last one */
-	for (i = 1; i < z_info->curse_max; i++) {
-		if (obj->curses[i].power) {
-			return;
-		}
-	}
-
-	mem_free(obj->curses);
-	obj->curses = NULL;
 }
 
 /**
@@ -268,7 +253,7 @@ static bool uncurse_object(struct object *obj, int strength, char *dice_string)
 	int index = 0;
 
 	if (get_curse(&index, obj, dice_string)) {
-		struct curse_data curse = obj->curses[index];
+		struct curse_data curse = *object_curse(obj, index);
 		char o_name[80];
 
 		if (curse.power >= 100) {
@@ -1536,8 +1521,9 @@ bool effect_handler_ALTER_REALITY(effect_handler_context_t *context)
  */
 bool effect_handler_MAP_AREA(effect_handler_context_t *context)
 {
-	int i, x, y;
+	int i, d, x, y;
 	int x1, x2, y1, y2;
+	bitflag *open_grids;
 	int dist_y = context->y ? context->y : context->value.dice;
 	int dist_x = context->x ? context->x : context->value.sides;
 	struct loc centre = origin_get_loc(context->origin);
@@ -1554,34 +1540,45 @@ bool effect_handler_MAP_AREA(effect_handler_context_t *context)
 	if (y2 > cave->height - 1) y2 = cave->height - 1;
 	if (x2 > cave->width - 1) x2 = cave->width - 1;
 
-	/* Scan the dungeon */
+	/* Scan the dungeon a row at a time, visiting only the open grids */
+	open_grids = cave->classes[GRID_CLASS_OPEN];
 	for (y = y1; y < y2; y++) {
-		for (x = x1; x < x2; x++) {
-			struct loc grid = loc(x, y);
+		int row = y * cave->width;
+		int end = row + x2;
+
+		for (i = grid_plane_next(open_grids, row + x1, end); i < end;
+			 i = grid_plane_next(open_grids, i + 1, end)) {
+			struct loc grid = loc(i - row, y);
 
 			/* Some squares can't be mapped */
+			if (!square_in_bounds_fully(cave, grid)) continue;
 			if (square_isno_map(cave, grid)) continue;
 
-			/* All non-walls are "checked" */
-			if (!square_seemslikewall(cave, grid)) {
-				if (!square_in_bounds_fully(cave, grid)) continue;
-
-				/* Memorize normal features */
-				if (!square_isfloor(cave, grid))
-					square_memorize(cave, grid);
+			/* Memorize normal features */
+			if (!square_isfloor(cave, grid) && square_isnotknown(cave, grid))
+				square_memorize(cave, grid);
 
-				/* Memorize known walls */
-				for (i = 0; i < 8; i++) {
-					int yy = y + ddy_ddd[i];
-					int xx = x + ddx_ddd[i];
+			/* Memorize known walls */
+			for (d = 0; d < 8; d++) {
+				struct loc adj = loc_sum(grid, ddgrid_ddd[d]);
 
-					/* Memorize walls (etc) */
-					if (square_seemslikewall(cave, loc(xx, yy)))
-						square_memorize(cave, loc(xx, yy));
-				}
+				if (!grid_plane_has(open_grids, grid_to_i(adj, cave->width)) &&
+					square_isnotknown(cave, adj))
+					square_memorize(cave, adj);
 			}
+		}
 
-			/* Forget unprocessed, unknown grids in the mapping area */
+		/* Forget unprocessed, unknown grids in the mapping area */
+		if (!memcmp(player->cave->feat + row + x1, cave->feat + row + x1,
+					x2 - x1))
+			continue;
+		for (x = x1; x < x2; x++) {
+			struct loc grid = loc(x, y);
+
+			if (square_isno_map(cave, grid)) continue;
+			if (grid_plane_has(open_grids, row + x) &&
+				!square_in_bounds_fully(cave, grid))
+				continue;
 			if (square_isnotknown(cave, grid))
 				square_forget(cave, grid);
 		}
@@ -1672,6 +1669,23 @@ bool effect_handler_DETECT_TRAPS(effect_handler_context_t *context)
 	if (x2 > cave->width - 1) x2 = cave->width - 1;
 
 
+	/* Reveal traps, visiting only the trapped grids of each row */
+	for (y = y1; y < y2; y++) {
+		int row = grid_to_i(loc(0, y), cave->width);
+		int i;
+
+		for (i = grid_plane_next(cave->trapped, row + x1, row + x2);
+			 i < row + x2;
+			 i = grid_plane_next(cave->trapped, i + 1, row + x2)) {
+			struct loc grid = loc(i - row, y);
+
+			if (!square_in_bounds_fully(cave, grid)) continue;
+			if (square_isplayertrap(cave, grid) &&
+				square_reveal_trap(cave, grid, true, false))
+				detect = true;
+		}
+	}
+
 	/* Scan the dungeon */
 	for (y = y1; y < y2; y++) {
 		for (x = x1; x < x2; x++) {
@@ -1679,12 +1693,6 @@ bool effect_handler_DETECT_TRAPS(effect_handler_context_t *context)
 
 			if (!square_in_bounds_fully(cave, grid)) continue;
 
-			/* Detect traps */
-			if (square_isplayertrap(cave, grid))
-				/* Reveal trap */
-				if (square_reveal_trap(cave, grid, true, false))
-					detect = true;
-
 			/* Scan all objects in the grid to look for traps on chests */
 			for (obj = square_object(cave, grid); obj; obj = obj->next) {
 				/* Skip anything not a trapped chest */
@@ -1730,8 +1738,10 @@ bool effect_handler_DETECT_TRAPS(effect_handler_context_t *context)
  */
 bool effect_handler_DETECT_DOORS(effect_handler_context_t *context)
 {
-	int x, y;
+	int i, y;
 	int x1, x2, y1, y2;
+	bitflag *doors_here = cave->classes[GRID_CLASS_DOOR];
+	bitflag *doors_known = player->cave->classes[GRID_CLASS_DOOR];
 
 	bool doors = false;
 
@@ -1741,17 +1751,20 @@ bool effect_handler_DETECT_DOORS(effect_handler_context_t *context)
 	x1 = player->grid.x - context->x;
 	x2 = player->grid.x + context->x;
 
-	if (y1 < 0) y1 = 0;
-	if (x1 < 0) x1 = 0;
+	/* Only grids fully in bounds are detected */
+	if (y1 < 1) y1 = 1;
+	if (x1 < 1) x1 = 1;
 	if (y2 > cave->height - 1) y2 = cave->height - 1;
 	if (x2 > cave->width - 1) x2 = cave->width - 1;
 
-	/* Scan the dungeon */
+	/* Scan the doors, and the doors the player remembers, a row at a time */
 	for (y = y1; y < y2; y++) {
-		for (x = x1; x < x2; x++) {
-			struct loc grid = loc(x, y);
+		int row = y * cave->width;
+		int end = row + x2;
 
-			if (!square_in_bounds_fully(cave, grid)) continue;
+		for (i = grid_plane_next(doors_here, row + x1, end); i < end;
+			 i = grid_plane_next(doors_here, i + 1, end)) {
+			struct loc grid = loc(i - row, y);
 
 			/* Detect secret doors */
 			if (square_issecretdoor(cave, grid)) {
@@ -1760,20 +1773,26 @@ bool effect_handler_DETECT_DOORS(effect_handler_context_t *context)
 
 				/* Memorize */
 				square_memorize(cave, grid);
-				square_light_spot(cave, grid);
 
 				/* Obvious */
 				doors = true;
 			}
+		}
+
+		/* Forget unknown doors in the mapping area */
+		for (i = grid_plane_next(doors_known, row + x1, end); i < end;
+			 i = grid_plane_next(doors_known, i + 1, end)) {
+			struct loc grid = loc(i - row, y);
 
-			/* Forget unknown doors in the mapping area */
-			if (square_isdoor(player->cave, grid) &&
-				square_isnotknown(cave, grid)) {
+			if (square_isnotknown(cave, grid))
 				square_forget(cave, grid);
-			}
 		}
 	}
 
+	/* Redraw the map once for everything found */
+	if (doors)
+		player->upkeep->redraw |= (PR_MAP | PR_ITEMLIST);
+
 	/* Describe */
 	if (doors)
 		msg("You sense the presence of doors!");
@@ -1791,8 +1810,9 @@ bool effect_handler_DETECT_DOORS(effect_handler_context_t *context)
  */
 bool effect_handler_DETECT_STAIRS(effect_handler_context_t *context)
 {
-	int x, y;
+	int i, y;
 	int x1, x2, y1, y2;
+	bitflag *plane = cave->classes[GRID_CLASS_STAIR];
 
 	bool stairs = false;
 
@@ -1802,30 +1822,31 @@ bool effect_handler_DETECT_STAIRS(effect_handler_context_t *context)
 	x1 = player->grid.x - context->x;
 	x2 = player->grid.x + context->x;
 
-	if (y1 < 0) y1 = 0;
-	if (x1 < 0) x1 = 0;
+	/* Only grids fully in bounds are detected */
+	if (y1 < 1) y1 = 1;
+	if (x1 < 1) x1 = 1;
 	if (y2 > cave->height - 1) y2 = cave->height - 1;
 	if (x2 > cave->width - 1) x2 = cave->width - 1;
 
-	/* Scan the dungeon */
+	/* Scan the stairs a row at a time */
 	for (y = y1; y < y2; y++) {
-		for (x = x1; x < x2; x++) {
-			struct loc grid = loc(x, y);
+		int row = y * cave->width;
+		int end = row + x2;
 
-			if (!square_in_bounds_fully(cave, grid)) continue;
+		for (i = grid_plane_next(plane, row + x1, end); i < end;
+			 i = grid_plane_next(plane, i + 1, end)) {
+			/* Memorize */
+			square_memorize(cave, loc(i - row, y));
 
-			/* Detect stairs */
-			if (square_isstairs(cave, grid)) {
-				/* Memorize */
-				square_memorize(cave, grid);
-				square_light_spot(cave, grid);
-
-				/* Obvious */
-				stairs = true;
-			}
+			/* Detect */
+			stairs = true;
 		}
 	}
 
+	/* Redraw the map once for everything found */
+	if (stairs)
+		player->upkeep->redraw |= (PR_MAP | PR_ITEMLIST);
+
 	/* Describe */
 	if (stairs)
 		msg("You sense the presence of stairs!");
@@ -1843,8 +1864,9 @@ bool effect_handler_DETECT_STAIRS(effect_handler_context_t *context)
  */
 bool effect_handler_DETECT_GOLD(effect_handler_context_t *context)
 {
-	int x, y;
+	int i, y;
 	int x1, x2, y1, y2;
+	bitflag *plane = cave->classes[GRID_CLASS_GOLD];
 
 	bool gold_buried = false;
 
@@ -1854,30 +1876,31 @@ bool effect_handler_DETECT_GOLD(effect_handler_context_t *context)
 	x1 = player->grid.x - context->x;
 	x2 = player->grid.x + context->x;
 
-	if (y1 < 0) y1 = 0;
-	if (x1 < 0) x1 = 0;
+	/* Only grids fully in bounds are detected */
+	if (y1 < 1) y1 = 1;
+	if (x1 < 1) x1 = 1;
 	if (y2 > cave->height - 1) y2 = cave->height - 1;
 	if (x2 > cave->width - 1) x2 = cave->width - 1;
 
-	/* Scan the dungeon */
+	/* Scan the gold veins a row at a time */
 	for (y = y1; y < y2; y++) {
-		for (x = x1; x < x2; x++) {
-			struct loc grid = loc(x, y);
+		int row = y * cave->width;
+		int end = row + x2;
 
-			if (!square_in_bounds_fully(cave, grid)) continue;
+		for (i = grid_plane_next(plane, row + x1, end); i < end;
+			 i = grid_plane_next(plane, i + 1, end)) {
+			/* Memorize */
+			square_memorize(cave, loc(i - row, y));
 
-			/* Magma/Quartz + Known Gold */
-			if (square_hasgoldvein(cave, grid)) {
-				/* Memorize */
-				square_memorize(cave, grid);
-				square_light_spot(cave, grid);
-
-				/* Detect */
-				gold_buried = true;
-			}
+			/* Detect */
+			gold_buried = true;
 		}
 	}
 
+	/* Redraw the map once for everything found */
+	if (gold_buried)
+		player->upkeep->redraw |= (PR_MAP | PR_ITEMLIST);
+
 	/* Message unless we're silently detecting */
 	if (context->origin.what != SRC_NONE) {
 		if (gold_buried) {
@@ -1897,7 +1920,7 @@ bool effect_handler_DETECT_GOLD(effect_handler_context_t *context)
  */
 bool effect_handler_SENSE_OBJECTS(effect_handler_context_t *context)
 {
-	int x, y;
+	struct loc grid;
 	int x1, x2, y1, y2;
 
 	bool objects = false;
@@ -1914,20 +1937,13 @@ bool effect_handler_SENSE_OBJECTS(effect_handler_context_t *context)
 	if (x2 > cave->width - 1) x2 = cave->width - 1;
 
 	/* Scan the area for objects */
-	for (y = y1; y <= y2; y++) {
-		for (x = x1; x <= x2; x++) {
-			struct loc grid = loc(x, y);
-			struct object *obj = square_object(cave, grid);
-
-			/* Skip empty grids */
-			if (!obj) continue;
-
-			/* Notice an object is detected */
-			objects = true;
+	grid = loc(x1 - 1, y1);
+	while (cave_next_object_grid(cave, loc(x1, y1), loc(x2, y2), &grid)) {
+		/* Notice an object is detected */
+		objects = true;
 
-			/* Mark the pile as aware */
-			square_sense_pile(cave, grid);
-		}
+		/* Mark the pile as aware */
+		square_sense_pile(cave, grid);
 	}
 
 	if (objects)
@@ -1948,7 +1964,7 @@ bool effect_handler_SENSE_OBJECTS(effect_handler_context_t *context)
  */
 bool effect_handler_DETECT_OBJECTS(effect_handler_context_t *context)
 {
-	int x, y;
+	struct loc grid;
 	int x1, x2, y1, y2;
 
 	bool objects = false;
@@ -1965,22 +1981,17 @@ bool effect_handler_DETECT_OBJECTS(effect_handler_context_t *context)
 	if (x2 > cave->width - 1) x2 = cave->width - 1;
 
 	/* Scan the area for objects */
-	for (y = y1; y <= y2; y++) {
-		for (x = x1; x <= x2; x++) {
-			struct loc grid = loc(x, y);
-			struct object *obj = square_object(cave, grid);
-
-			/* Skip empty grids */
-			if (!obj) continue;
+	grid = loc(x1 - 1, y1);
+	while (cave_next_object_grid(cave, loc(x1, y1), loc(x2, y2), &grid)) {
+		struct object *obj = square_object(cave, grid);
 
-			/* Notice an object is detected */
-			if (!ignore_item_ok(obj)) {
-				objects = true;
-			}
-
-			/* Mark the pile as seen */
-			square_know_pile(cave, grid);
+		/* Notice an object is detected */
+		if (!ignore_item_ok(obj)) {
+			objects = true;
 		}
+
+		/* Mark the pile as seen */
+		square_know_pile(cave, grid);
 	}
 
 	if (objects)
@@ -2002,8 +2013,8 @@ bool effect_handler_DETECT_OBJECTS(effect_handler_context_t *context)
  */
 static bool detect_monsters(int y_dist, int x_dist, monster_predicate pred)
 {
-	int i, x, y;
 	int x1, x2, y1, y2;
+	struct loc grid;
 
 	bool monsters = false;
 
@@ -2018,19 +2029,10 @@ static bool detect_monsters(int y_dist, int x_dist, monster_predicate pred)
 	if (y2 > cave->height - 1) y2 = cave->height - 1;
 	if (x2 > cave->width - 1) x2 = cave->width - 1;
 
-	/* Scan monsters */
-	for (i = 1; i < cave_monster_max(cave); i++) {
-		struct monster *mon = cave_monster(cave, i);
-
-		/* Skip dead monsters */
-		if (!mon->race) continue;
-
-		/* Location */
-		y = mon->grid.y;
-		x = mon->grid.x;
-
-		/* Only detect nearby monsters */
-		if (x < x1 || y < y1 || x > x2 || y > y2) continue;
+	/* Scan the area for monsters */
+	grid = loc(x1 - 1, y1);
+	while (cave_next_monster_grid(cave, loc(x1, y1), loc(x2, y2), &grid)) {
+		struct monster *mon = square_monster(cave, grid);
 
 		/* Detect all appropriate, obvious monsters */
 		if (pred(mon) && !monster_is_camouflaged(mon)) {
@@ -2415,6 +2417,9 @@ bool effect_handler_PROJECT_LOS(effect_handler_context_t *context)
 	struct loc origin = origin_get_loc(context->origin);
 	int flg = PROJECT_JUMP | PROJECT_KILL | PROJECT_HIDE;
 
+	/* Tidy up the player once, after every monster has been hit */
+	hold_stuff(player);
+
 	/* Affect all (nearby) monsters */
 	for (i = 1; i < cave_monster_max(cave); i++) {
 		struct monster *mon = cave_monster(cave, i);
@@ -2430,6 +2435,7 @@ bool effect_handler_PROJECT_LOS(effect_handler_context_t *context)
 					  context->obj);
 		context->ident = true;
 	}
+	release_stuff(player);
 
 	/* Result */
 	return true;
@@ -2451,6 +2457,9 @@ bool effect_handler_PROJECT_LOS_AWARE(effect_handler_context_t *context)
 
 	if (context->aware) flg |= PROJECT_AWARE;
 
+	/* Tidy up the player once, after every monster has been hit */
+	hold_stuff(player);
+
 	/* Affect all (nearby) monsters */
 	for (i = 1; i < cave_monster_max(cave); i++) {
 		struct monster *mon = cave_monster(cave, i);
@@ -2469,6 +2478,7 @@ bool effect_handler_PROJECT_LOS_AWARE(effect_handler_context_t *context)
 		(void)project(source_player(), 0, grid, dam, typ, flg, 0, 0, context->obj);
 		context->ident = true;
 	}
+	release_stuff(player);
 
 	/* Result */
 	return true;
@@ -2747,6 +2757,167 @@ bool effect_handler_PROBE(effect_handler_context_t *context)
 	return true;
 }
 
+/**
+ * Bring the floor index of a level up to date, building it if the terrain
+ * has changed since it was last built
+ */
+static struct floor_index *floor_index_get(struct chunk *c)
+{
+	struct floor_index *idx = &c->floors;
+	int cell_hgt = (c->height + GRID_CELL - 1) >> GRID_CELL_SHIFT;
+	int num_cells = c->cell_wid * cell_hgt;
+	int i, num = 0;
+	struct loc grid;
+
+	if (idx->stamp == c->feat_stamp) return idx;
+
+	if (!idx->cell_start) {
+		idx->cell_start = mem_zalloc((num_cells + 1) * sizeof(int));
+		idx->cell_score = mem_zalloc(num_cells * sizeof(int));
+	}
+	memset(idx->cell_start, 0, (num_cells + 1) * sizeof(int));
+
+	/* Count the floor grids in each cell, leaving the first slot free */
+	for (grid.y = 1; grid.y < c->height - 1; grid.y++) {
+		for (grid.x = 1; grid.x < c->width - 1; grid.x++) {
+			if (!square_isfloor(c, grid)) continue;
+			idx->cell_start[grid_cell(c, grid) + 1]++;
+			num++;
+		}
+	}
+	for (i = 0; i < num_cells; i++)
+		idx->cell_start[i + 1] += idx->cell_start[i];
+
+	idx->grids = mem_realloc(idx->grids, (num + 1) * sizeof(struct loc));
+	idx->found = mem_realloc(idx->found, (num + 1) * sizeof(struct loc));
+
+	/* Fill each cell in row order, using the cell_score as a count */
+	memset(idx->cell_score, 0, num_cells * sizeof(int));
+	for (grid.y = 1; grid.y < c->height - 1; grid.y++) {
+		for (grid.x = 1; grid.x < c->width - 1; grid.x++) {
+			int cell = grid_cell(c, grid);
+
+			if (!square_isfloor(c, grid)) continue;
+			idx->grids[idx->cell_start[cell] + idx->cell_score[cell]++] = grid;
+		}
+	}
+
+	idx->stamp = c->feat_stamp;
+	return idx;
+}
+
+/**
+ * Order grids as a scan of the map, a row at a time, would meet them
+ */
+static int cmp_grid_order(const void *a, const void *b)
+{
+	const struct loc *pa = a;
+	const struct loc *pb = b;
+
+	if (pa->y != pb->y) return pa->y - pb->y;
+	return pa->x - pb->x;
+}
+
+/**
+ * Find every grid a teleport from start could land on whose distance from
+ * start is as close as possible to dis, considering only vault grids or only
+ * grids outside vaults.  The grids are left in idx->found in map order, and
+ * their number returned.
+ *
+ * Each cell of the floor index is given the least miss any of its grids
+ * could score, from the nearest and furthest points of the cell; cells are
+ * then searched in order of that score, stopping once no unsearched cell
+ * could do as well as the best found.
+ */
+static int teleport_find_spots(struct chunk *c, struct floor_index *idx,
+		struct loc start, int dis, bool is_player, bool vault)
+{
+	int cell_hgt = (c->height + GRID_CELL - 1) >> GRID_CELL_SHIFT;
+	int num_cells = c->cell_wid * cell_hgt;
+	int best = 2 * MAX(z_info->dungeon_wid, z_info->dungeon_hgt);
+	int score = 0, num = 0;
+	int i;
+
+	/* Score the cells */
+	for (i = 0; i < num_cells; i++) {
+		int x0 = (i % c->cell_wid) << GRID_CELL_SHIFT;
+		int y0 = (i / c->cell_wid) << GRID_CELL_SHIFT;
+		int x1 = x0 + GRID_CELL - 1, y1 = y0 + GRID_CELL - 1;
+		int near_x, near_y, far_x, far_y, d_near, d_far;
+
+		if (idx->cell_start[i] == idx->cell_start[i + 1]) {
+			idx->cell_score[i] = -1;
+			continue;
+		}
+
+		/* Distance grows with each offset, so check the extremes */
+		near_x = (start.x < x0) ? x0 - start.x :
+			((start.x > x1) ? start.x - x1 : 0);
+		near_y = (start.y < y0) ? y0 - start.y :
+			((start.y > y1) ? start.y - y1 : 0);
+		far_x = MAX(ABS(start.x - x0), ABS(start.x - x1));
+		far_y = MAX(ABS(start.y - y0), ABS(start.y - y1));
+		d_near = distance(loc(0, 0), loc(near_x, near_y));
+		d_far = distance(loc(0, 0), loc(far_x, far_y));
+		if (dis < d_near)
+			idx->cell_score[i] = d_near - dis;
+		else if (dis > d_far)
+			idx->cell_score[i] = dis - d_far;
+		else
+			idx->cell_score[i] = 0;
+	}
+
+	/* Search the cells a score at a time */
+	while (score <= best) {
+		int next = -1;
+
+		for (i = 0; i < num_cells; i++) {
+			int j;
+
+			if (idx->cell_score[i] != score) {
+				if (idx->cell_score[i] > score &&
+					(next < 0 || idx->cell_score[i] < next))
+					next = idx->cell_score[i];
+				continue;
+			}
+
+			for (j = idx->cell_start[i]; j < idx->cell_start[i + 1]; j++) {
+				struct loc grid = idx->grids[j];
+				int d = distance(grid, start);
+				int miss = ABS(d - dis);
+
+				/* Must move */
+				if (d == 0) continue;
+
+				/* Require "naked" floor space */
+				if (!square_isempty(c, grid)) continue;
+
+				/* No monster teleport onto glyph of warding */
+				if (!is_player && square_iswarded(c, grid)) continue;
+
+				/* Right sort of grid */
+				if (square_isvault(c, grid) != vault) continue;
+
+				/* Do we have better spots already? */
+				if (miss > best) continue;
+
+				/* If improving start a new list, otherwise extend it */
+				if (miss < best) {
+					best = miss;
+					num = 0;
+				}
+				idx->found[num++] = grid;
+			}
+		}
+
+		if (next < 0) break;
+		score = next;
+	}
+
+	sort(idx->found, num, sizeof(*(idx->found)), cmp_grid_order);
+	return num;
+}
+
 /**
  * Teleport player or monster up to context->value.base grids away.
  *
@@ -2763,14 +2934,8 @@ bool effect_handler_TELEPORT(effect_handler_context_t *context)
 	int perc = context->value.m_bonus;
 	int pick;
 	struct loc grid;
-
-	struct jumps {
-		struct loc grid;
-		struct jumps *next;
-	} *spots = NULL;
-	int num_spots = 0;
-	int current_score = 2 * MAX(z_info->dungeon_wid, z_info->dungeon_hgt);
-	bool only_vault_grids_possible = true;
+	struct floor_index *floors;
+	int num_spots;
 
 	bool is_player = (context->origin.what != SRC_MONSTER || context->subtype);
 	struct monster *t_mon = monster_target_monster(context);
@@ -2829,61 +2994,15 @@ bool effect_handler_TELEPORT(effect_handler_context_t *context)
 		dis += randint0(dis / 4);
 	}
 
-	/* Make a list of the best grids, scoring by how good an approximation
-	 * the distance from the start is to the distance we want */
-	for (grid.y = 1; grid.y < cave->height - 1; grid.y++) {
-		for (grid.x = 1; grid.x < cave->width - 1; grid.x++) {
-			int d = distance(grid, start);
-			int score = ABS(d - dis);
-			struct jumps *new;
-
-			/* Must move */
-			if (d == 0) continue;
-
-			/* Require "naked" floor space */
-			if (!square_isempty(cave, grid)) continue;
-
-			/* No monster teleport onto glyph of warding */
-			if (!is_player && square_iswarded(cave, grid)) continue;
-
-			/* No teleporting into vaults and such, unless there's no choice */
-			if (square_isvault(cave, grid)) {
-				if (!only_vault_grids_possible) {
-					continue;
-				}
-			} else {
-				/* Just starting to consider non-vault grids, so reset score */
-				if (only_vault_grids_possible) {
-					current_score = 2 * MAX(z_info->dungeon_wid,
-											z_info->dungeon_hgt);
-				}
-				only_vault_grids_possible = false;
-			}
-
-			/* Do we have better spots already? */
-			if (score > current_score) continue;
-
-			/* Make a new spot */
-			new = mem_zalloc(sizeof(struct jumps));
-			new->grid = grid;
-
-			/* If improving start a new list, otherwise extend the old one */
-			if (score < current_score) {
-				current_score = score;
-				while (spots) {
-					struct jumps *next = spots->next;
-					mem_free(spots);
-					spots = next;
-				}
-				spots = new;
-				num_spots = 1;
-			} else {
-				new->next = spots;
-				spots = new;
-				num_spots++;
-			}
-		}
-	}
+	/* Find the best grids, scoring by how good an approximation the
+	 * distance from the start is to the distance we want; no teleporting
+	 * into vaults and such, unless there's no choice */
+	floors = floor_index_get(cave);
+	num_spots = teleport_find_spots(cave, floors, start, dis, is_player,
+									false);
+	if (!num_spots)
+		num_spots = teleport_find_spots(cave, floors, start, dis, is_player,
+										true);
 
 	/* Report failure (very unlikely) */
 	if (!num_spots) {
@@ -2891,23 +3010,18 @@ bool effect_handler_TELEPORT(effect_handler_context_t *context)
 		return true;
 	}
 
-	/* Pick a spot */
+	/* Pick a spot, counting back from the last one found */
 	pick = randint0(num_spots);
-	while (pick) {
-		struct jumps *next = spots->next;
-		mem_free(spots);
-		spots = next;
-		pick--;
-	}
+	grid = floors->found[num_spots - 1 - pick];
 
 	/* Sound */
 	sound(is_player ? MSG_TELEPORT : MSG_TPOTHER);
 
 	/* Move player */
-	monster_swap(start, spots->grid);
+	monster_swap(start, grid);
 
 	/* Clear any projection marker to prevent double processing */
-	sqinfo_off(square(cave, spots->grid).info, SQUARE_PROJECT);
+	sqinfo_off(square(cave, grid).info, SQUARE_PROJECT);
 
 	/* Clear monster target if it's no longer visible */
 	if (!target_able(target_get_monster())) {
@@ -2917,12 +3031,6 @@ bool effect_handler_TELEPORT(effect_handler_context_t *context)
 	/* Lots of updates after monster_swap */
 	handle_stuff(player);
 
-	while (spots) {
-		struct jumps *next = spots->next;
-		mem_free(spots);
-		spots = next;
-	}
-
 	return true;
 }
 
@@ -5459,6 +5567,8 @@ bool effect_do(struct effect *effect,
 			return false;
 		}
 
+		/* Roll the dice; only a random effect uses the total, but the roll
+		 * is always made so a given seed plays out the same */
 		if (effect->dice != NULL)
 			random_choices = dice_roll(effect->dice, &value);
 
@@ -5514,6 +5624,64 @@ bool effect_do(struct effect *effect,
 	return completed;
 }
 
+/**
+ * Dice for effect_simple(), which is called with the same few dice strings
+ * over and over in combat, so that each is parsed once.  Each slot keeps the
+ * last short string that hashed to it.
+ */
+#define SIMPLE_DICE_CACHE_SIZE 64
+static struct {
+	char string[16];
+	dice_t *dice;
+} simple_dice_cache[SIMPLE_DICE_CACHE_SIZE];
+
+/**
+ * Get parsed dice for a dice string, and whether the caller must free them
+ */
+static dice_t *simple_dice(const char *dice_string, bool *temporary)
+{
+	int slot = djb2_hash(dice_string) % SIMPLE_DICE_CACHE_SIZE;
+	dice_t *dice;
+
+	if (simple_dice_cache[slot].dice &&
+		streq(simple_dice_cache[slot].string, dice_string)) {
+		*temporary = false;
+		return simple_dice_cache[slot].dice;
+	}
+
+	dice = dice_new();
+	dice_parse_string(dice, dice_string);
+
+	/* Long strings are not worth keeping */
+	if (strlen(dice_string) >= sizeof(simple_dice_cache[slot].string)) {
+		*temporary = true;
+		return dice;
+	}
+
+	/* Nothing still running can be using the old dice, see effect_do() */
+	if (simple_dice_cache[slot].dice)
+		dice_free(simple_dice_cache[slot].dice);
+	my_strcpy(simple_dice_cache[slot].string, dice_string,
+			  sizeof(simple_dice_cache[slot].string));
+	simple_dice_cache[slot].dice = dice;
+	*temporary = false;
+	return dice;
+}
+
+/**
+ * Free the dice kept for effect_simple()
+ */
+void effect_simple_cleanup(void)
+{
+	int i;
+
+	for (i = 0; i < SIMPLE_DICE_CACHE_SIZE; i++) {
+		if (simple_dice_cache[i].dice)
+			dice_free(simple_dice_cache[i].dice);
+		simple_dice_cache[i].dice = NULL;
+	}
+}
+
 /**
  * Perform a single effect with a simple dice string and parameters
  * Calling with ident a valid pointer will (depending on effect) give success
@@ -5532,12 +5700,12 @@ void effect_simple(int index,
 	struct effect effect;
 	int dir = DIR_TARGET;
 	bool dummy_ident = false;
+	bool temporary;
 
 	/* Set all the values */
 	memset(&effect, 0, sizeof(effect));
 	effect.index = index;
-	effect.dice = dice_new();
-	dice_parse_string(effect.dice, dice_string);
+	effect.dice = simple_dice(dice_string, &temporary);
 	effect.subtype = subtype;
 	effect.radius = radius;
 	effect.other = other;
@@ -5554,5 +5722,6 @@ void effect_simple(int index,
 	}
 
 	effect_do(&effect, origin, NULL, ident, true, dir, 0, 0);
-	dice_free(effect.dice);
+	if (temporary)
+		dice_free(effect.dice);
 }
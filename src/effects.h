@@ -58,6 +58,7 @@ void effect_simple(int index,
 	int y,
 	int x,
 	bool *ident);
+void effect_simple_cleanup(void);
 int recharge_failure_chance(const struct object *obj, int strength);
 
 #endif /* INCLUDED_EFFECTS_H */
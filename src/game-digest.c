@@ -0,0 +1,272 @@
+/**
+ * \file game-digest.c
+ * \brief Digests of the game state, turn by turn
+ *
+ * Copyright (c) 2026 The Angband Developers
+ *
+ * This work is free software; you can redistribute it and/or modify it
+ * under the terms of either:
+ *
+ * a) the GNU General Public License as published by the Free Software
+ *    Foundation, version 2, or
+ *
+ * b) the "Angband licence":
+ *    This software may be copied and distributed for educational, research,
+ *    and not for profit purposes provided that this copyright and statement
+ *    are included in all such copies.  Other copyrights may also apply.
+ */
+#include "angband.h"
+#include "game-digest.h"
+#include "game-world.h"
+#include "init.h"
+#include "monster.h"
+#include "obj-util.h"
+#include "object.h"
+#include "player-timed.h"
+
+ang_file *digest_log;
+ang_file *digest_reference;
+
+/**
+ * The first turn whose digests didn't match the reference, or -1
+ */
+static s32b mismatch_turn = -1;
+static struct game_digest mismatch_expected, mismatch_found;
+
+/**
+ * Add a value to a running digest, a word at a time in the manner of FNV-1a
+ */
+static void digest_add(u32b *h, u32b v)
+{
+	*h = (*h ^ v) * 16777619u;
+	*h ^= *h >> 15;
+}
+
+#define DIGEST_START 2166136261u
+
+static void digest_add_loc(u32b *h, struct loc grid)
+{
+	digest_add(h, (u32b) grid.x);
+	digest_add(h, (u32b) grid.y);
+}
+
+/**
+ * Digest an object, leaving out where it is in memory and what the player
+ * knows of it
+ */
+static u32b object_digest(const struct object *obj)
+{
+	u32b h = DIGEST_START;
+	int i;
+
+	digest_add(&h, obj->kind ? obj->kind->kidx : 0);
+	digest_add(&h, obj->ego ? obj->ego->eidx : 0);
+	digest_add(&h, obj->artifact ? obj->artifact->aidx : 0);
+	digest_add_loc(&h, obj->grid);
+	digest_add(&h, (u32b) obj->pval);
+	digest_add(&h, (u32b) obj->weight);
+	digest_add(&h, obj->dd);
+	digest_add(&h, obj->ds);
+	digest_add(&h, (u32b) obj->ac);
+	digest_add(&h, (u32b) obj->to_a);
+	digest_add(&h, (u32b) obj->to_h);
+	digest_add(&h, (u32b) obj->to_d);
+	for (i = 0; i < OBJ_MOD_MAX; i++)
+		digest_add(&h, (u32b) obj->modifiers[i]);
+	digest_add(&h, (u32b) obj->timeout);
+	digest_add(&h, obj->number);
+	digest_add(&h, obj->held_m_idx ? 1 : 0);
+	digest_add(&h, obj->origin);
+	digest_add(&h, obj->origin_depth);
+	return h;
+}
+
+/**
+ * Digest a monster, leaving out its index and flags kept for the game's
+ * own bookkeeping
+ */
+static u32b monster_digest(const struct monster *mon)
+{
+	u32b h = DIGEST_START;
+	int i;
+
+	digest_add(&h, (u32b) mon->race->ridx);
+	digest_add(&h, mon->original_race ? mon->original_race->ridx + 1 : 0);
+	digest_add_loc(&h, mon->grid);
+	digest_add(&h, (u32b) mon->hp);
+	digest_add(&h, (u32b) mon->maxhp);
+	for (i = 0; i < MON_TMD_MAX; i++)
+		digest_add(&h, (u32b) mon->m_timed[i]);
+	digest_add(&h, mon->mspeed);
+	digest_add(&h, mon->energy);
+	digest_add(&h, (u32b) mon->energy_turn);
+	return h;
+}
+
+static u32b rng_digest(void)
+{
+	u32b h = DIGEST_START;
+	int i;
+
+	digest_add(&h, Rand_default.quick);
+	digest_add(&h, Rand_default.value);
+	digest_add(&h, Rand_default.state_i);
+	for (i = 0; i < RAND_DEG; i++)
+		digest_add(&h, Rand_default.state[i]);
+	return h;
+}
+
+static u32b player_digest(struct player *p)
+{
+	u32b h = DIGEST_START;
+	struct object *obj;
+	u32b gear = 0;
+	int i;
+
+	digest_add_loc(&h, p->grid);
+	digest_add(&h, (u32b) p->au);
+	digest_add(&h, (u32b) p->depth);
+	digest_add(&h, (u32b) p->max_depth);
+	digest_add(&h, (u32b) p->lev);
+	digest_add(&h, (u32b) p->exp);
+	digest_add(&h, p->exp_frac);
+	digest_add(&h, (u32b) p->mhp);
+	digest_add(&h, (u32b) p->chp);
+	digest_add(&h, p->chp_frac);
+	digest_add(&h, (u32b) p->msp);
+	digest_add(&h, (u32b) p->csp);
+	digest_add(&h, p->csp_frac);
+	for (i = 0; i < STAT_MAX; i++) {
+		digest_add(&h, (u32b) p->stat_max[i]);
+		digest_add(&h, (u32b) p->stat_cur[i]);
+	}
+	for (i = 0; i < TMD_MAX; i++)
+		digest_add(&h, (u32b) p->timed[i]);
+	digest_add(&h, (u32b) p->word_recall);
+	digest_add(&h, (u32b) p->deep_descent);
+	digest_add(&h, (u32b) p->energy);
+	digest_add(&h, p->total_energy);
+	digest_add(&h, (u32b) p->food);
+
+	/* The gear, in any order */
+	for (obj = p->gear; obj; obj = obj->next)
+		gear += object_digest(obj);
+	digest_add(&h, gear);
+	return h;
+}
+
+/**
+ * Work out the digests of the game as it is now.
+ *
+ * Monsters and objects are summed over, so that moving them around in their
+ * lists doesn't change the digests; the features are summed over the grids
+ * as they are set, by cave_feat_digest().
+ */
+void game_digest(struct chunk *c, struct player *p, struct game_digest *d)
+{
+	int i;
+
+	d->rng = rng_digest();
+	d->player = player_digest(p);
+
+	d->monsters = 0;
+	for (i = 1; i < cave_monster_max(c); i++) {
+		struct monster *mon = cave_monster(c, i);
+		if (mon->race) d->monsters += monster_digest(mon);
+	}
+
+	d->objects = 0;
+	for (i = 1; i < c->obj_max; i++) {
+		struct object *obj = c->objects[i];
+		if (obj) d->objects += object_digest(obj);
+	}
+
+	d->feats = cave_feat_digest(c);
+}
+
+/**
+ * One digest for everything
+ */
+u32b game_digest_all(const struct game_digest *d)
+{
+	u32b h = DIGEST_START;
+
+	digest_add(&h, d->rng);
+	digest_add(&h, d->player);
+	digest_add(&h, d->monsters);
+	digest_add(&h, d->objects);
+	digest_add(&h, d->feats);
+	return h;
+}
+
+/**
+ * Check this turn's digests against the reference, noting the first turn
+ * where they differ or where the reference runs out
+ */
+static void digest_check(const struct game_digest *d)
+{
+	char buf[1024];
+	long ref_turn = -1;
+	unsigned long all, rng, pl, mon, obj, feat;
+	struct game_digest expected;
+
+	memset(&expected, 0, sizeof(expected));
+	if (file_getl(digest_reference, buf, sizeof(buf)) &&
+		sscanf(buf, "%ld %lx %lx %lx %lx %lx %lx", &ref_turn, &all, &rng,
+			   &pl, &mon, &obj, &feat) == 7) {
+		expected.rng = rng;
+		expected.player = pl;
+		expected.monsters = mon;
+		expected.objects = obj;
+		expected.feats = feat;
+		if (ref_turn == turn && !memcmp(&expected, d, sizeof(expected)))
+			return;
+	}
+
+	mismatch_turn = turn;
+	mismatch_expected = expected;
+	mismatch_found = *d;
+}
+
+/**
+ * Write and check the digests at the end of a game turn, as asked for
+ */
+void digest_tick(void)
+{
+	struct game_digest d;
+
+	if (!digest_log && !(digest_reference && mismatch_turn < 0)) return;
+	game_digest(cave, player, &d);
+
+	if (digest_log)
+		file_putf(digest_log,
+				  "%ld\t%08lx\t%08lx\t%08lx\t%08lx\t%08lx\t%08lx\n",
+				  (long) turn, (unsigned long) game_digest_all(&d),
+				  (unsigned long) d.rng, (unsigned long) d.player,
+				  (unsigned long) d.monsters, (unsigned long) d.objects,
+				  (unsigned long) d.feats);
+	if (digest_reference && mismatch_turn < 0)
+		digest_check(&d);
+}
+
+/**
+ * The first turn whose digests didn't match the reference, with the digests
+ * expected and found then, or -1 if there is none yet
+ */
+s32b digest_first_mismatch(struct game_digest *expected,
+						   struct game_digest *found)
+{
+	if (mismatch_turn >= 0) {
+		if (expected) *expected = mismatch_expected;
+		if (found) *found = mismatch_found;
+	}
+	return mismatch_turn;
+}
+
+/**
+ * Forget any mismatch, for a new check
+ */
+void digest_reset(void)
+{
+	mismatch_turn = -1;
+}
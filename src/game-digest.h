@@ -0,0 +1,60 @@
+/**
+ * \file game-digest.h
+ * \brief Digests of the game state, turn by turn
+ *
+ * Copyright (c) 2026 The Angband Developers
+ *
+ * This work is free software; you can redistribute it and/or modify it
+ * under the terms of either:
+ *
+ * a) the GNU General Public License as published by the Free Software
+ *    Foundation, version 2, or
+ *
+ * b) the "Angband licence":
+ *    This software may be copied and distributed for educational, research,
+ *    and not for profit purposes provided that this copyright and statement
+ *    are included in all such copies.  Other copyrights may also apply.
+ */
+
+#ifndef GAME_DIGEST_H
+#define GAME_DIGEST_H
+
+#include "cave.h"
+#include "player.h"
+#include "z-file.h"
+
+/**
+ * Digests of the parts of the game state which decide how the game plays
+ * out.  Only the state itself goes in, not anything worked out from it or
+ * kept to make it faster to use, such as the view, flows, caches or where
+ * things are in memory; so a change meant only to make the game faster
+ * should leave every digest of every turn as it was.
+ */
+struct game_digest {
+	u32b rng;		/* The random number generator */
+	u32b player;	/* The player and their gear */
+	u32b monsters;	/* The monsters on the level, in any order */
+	u32b objects;	/* The objects on the level, in any order */
+	u32b feats;		/* The features of the grids */
+};
+
+/**
+ * While this is set, a line with the turn and the digests is written to it
+ * at the end of each game turn
+ */
+extern ang_file *digest_log;
+
+/**
+ * While this is set, each game turn's digests are checked against the next
+ * line of it, as written to digest_log by an earlier run
+ */
+extern ang_file *digest_reference;
+
+void game_digest(struct chunk *c, struct player *p, struct game_digest *d);
+u32b game_digest_all(const struct game_digest *d);
+void digest_tick(void);
+s32b digest_first_mismatch(struct game_digest *expected,
+						   struct game_digest *found);
+void digest_reset(void);
+
+#endif /* !GAME_DIGEST_H */
@@ -23,99 +23,141 @@
 
 struct event_handler_entry
 {
-	struct event_handler_entry *next;	
 	game_event_handler *fn;
 	void *user;
 };
 
-static struct event_handler_entry *event_handlers[N_GAME_EVENTS];
+/**
+ * The handlers for one type of event, kept in one block in the order they
+ * were added; the most recently added handler is called first.
+ */
+struct event_handler_list
+{
+	struct event_handler_entry *entries;
+	size_t count;
+	size_t alloc;
+	bool removed;
+};
+
+static struct event_handler_list event_handlers[N_GAME_EVENTS];
+
+/**
+ * How many dispatches are under way; while there are any, removed entries
+ * are only blanked, so that the entries being walked don't move.
+ */
+static int event_dispatching;
+
+/**
+ * Close up the gaps left by handlers removed during a dispatch.
+ */
+static void event_compact_handlers(void)
+{
+	int type;
+
+	for (type = 0; type < N_GAME_EVENTS; type++) {
+		struct event_handler_list *list = &event_handlers[type];
+		size_t i, n = 0;
+
+		if (!list->removed) continue;
+		for (i = 0; i < list->count; i++)
+			if (list->entries[i].fn)
+				list->entries[n++] = list->entries[i];
+		list->count = n;
+		list->removed = false;
+	}
+}
 
 static void game_event_dispatch(game_event_type type, game_event_data *data)
 {
-	struct event_handler_entry *this = event_handlers[type];
+	struct event_handler_list *list = &event_handlers[type];
+	size_t i = list->count;
 
 	/* 
-	 * Send the word out to all interested event handlers.
+	 * Send the word out to all interested event handlers.  Handlers added
+	 * on the way go on the end, so aren't called this time, as before.
 	 */
-	while (this)
+	event_dispatching++;
+	while (i > 0)
 	{
+		struct event_handler_entry *this = &list->entries[--i];
+
 		/* Call the handler with the relevant data */
-		this->fn(type, data, this->user);
-		this = this->next;
+		if (this->fn)
+			this->fn(type, data, this->user);
 	}
+	if (--event_dispatching == 0)
+		event_compact_handlers();
 }
 
 void event_add_handler(game_event_type type, game_event_handler *fn, void *user)
 {
-	struct event_handler_entry *new;
+	struct event_handler_list *list = &event_handlers[type];
 
 	assert(fn != NULL);
 
-	/* Make a new entry */
-	new = mem_alloc(sizeof *new);
-	new->fn = fn;
-	new->user = user;
+	/* Make room for a new entry */
+	if (list->count == list->alloc) {
+		list->alloc = list->alloc ? list->alloc * 2 : 4;
+		list->entries = mem_realloc(list->entries,
+			list->alloc * sizeof(*list->entries));
+	}
 
-	/* Add it to the head of the appropriate list */
-	new->next = event_handlers[type];
-	event_handlers[type] = new;
+	/* Add it to the end, so it is called first */
+	list->entries[list->count].fn = fn;
+	list->entries[list->count].user = user;
+	list->count++;
 }
 
 void event_remove_handler(game_event_type type, game_event_handler *fn, void *user)
 {
-	struct event_handler_entry *prev = NULL;
-	struct event_handler_entry *this = event_handlers[type];
+	struct event_handler_list *list = &event_handlers[type];
+	size_t i = list->count;
 
-	/* Look for the entry in the list */
-	while (this)
+	/* Look for the most recent matching entry, as the old list did */
+	while (i > 0)
 	{
+		i--;
+
 		/* Check if this is the entry we want to remove */
-		if (this->fn == fn && this->user == user)
+		if (list->entries[i].fn == fn && list->entries[i].user == user)
 		{
-			if (!prev)
-			{
-				event_handlers[type] = this->next;
-			}
-			else
-			{
-				prev->next = this->next;
+			if (event_dispatching) {
+				list->entries[i].fn = NULL;
+				list->removed = true;
+				return;
 			}
-
-			mem_free(this);
+			memmove(&list->entries[i], &list->entries[i + 1],
+				(list->count - i - 1) * sizeof(*list->entries));
+			list->count--;
 			return;
 		}
-
-		prev = this;
-		this = this->next;
 	}
 }
 
 void event_remove_handler_type(game_event_type type)
 {
-	struct event_handler_entry *handler = event_handlers[type];
+	if (event_dispatching) {
+		size_t i;
 
-	while (handler) {
-		struct event_handler_entry *next = handler->next;
-		mem_free(handler);
-		handler = next;
+		for (i = 0; i < event_handlers[type].count; i++)
+			event_handlers[type].entries[i].fn = NULL;
+		event_handlers[type].removed = true;
+		return;
 	}
-	event_handlers[type] = NULL;
+
+	mem_free(event_handlers[type].entries);
+	event_handlers[type].entries = NULL;
+	event_handlers[type].count = 0;
+	event_handlers[type].alloc = 0;
+	event_handlers[type].removed = false;
 }
 
 void event_remove_all_handlers(void)
 {
 	int type;
-	struct event_handler_entry *handler, *next;
 
-	for (type = 0; type < N_GAME_EVENTS; type++) {
-		handler = event_handlers[type];
-		while (handler) {
-			next = handler->next;
-			mem_free(handler);
-			handler = next;
-		}
-		event_handlers[type] = NULL;
-	}
+	for (type = 0; type < N_GAME_EVENTS; type++)
+		event_remove_handler_type(type);
 }
 
 void event_add_handler_set(game_event_type *type, size_t n_types, game_event_handler *fn, void *user)
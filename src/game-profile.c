@@ -0,0 +1,431 @@
+/**
+ * \file game-profile.c
+ * \brief Timing of the parts of the game loop and of level generation
+ *
+ * Copyright (c) 2026 The Angband Developers
+ *
+ * This work is free software; you can redistribute it and/or modify it
+ * under the terms of either:
+ *
+ * a) the GNU General Public License as published by the Free Software
+ *    Foundation, version 2, or
+ *
+ * b) the "Angband licence":
+ *    This software may be copied and distributed for educational, research,
+ *    and not for profit purposes provided that this copyright and statement
+ *    are included in all such copies.  Other copyrights may also apply.
+ */
+
+#include "angband.h"
+#include "game-profile.h"
+#include "z-file.h"
+
+#include <time.h>
+
+/**
+ * Whether the game loop and level generation are being timed
+ */
+bool profile_enabled = false;
+
+static const char *phase_names[PROFILE_MAX] = {
+	"process_player",
+	"process_world",
+	"process_monsters",
+	"update_stuff",
+	"redraw_stuff",
+	"Term_fresh",
+	"cave_generate",
+	"room_build",
+	"build_tunnel",
+	"build_streamer",
+	"alloc_objects",
+	"distant monster"
+};
+
+static const char *bin_names[PROFILE_BINS] = {
+	"<1us", "<4us", "<16us", "<64us", "<256us", "<1ms", "<4ms", ">=4ms"
+};
+
+/**
+ * Timings since the last reset
+ */
+static struct profile_stats cumulative[PROFILE_MAX];
+
+/**
+ * Timings for recent game turns; window[window_slot] is being filled, and
+ * window_used slots hold data
+ */
+static struct profile_stats window[PROFILE_WINDOW][PROFILE_MAX];
+static int window_slot;
+static int window_used = 1;
+static int window_turns;
+
+/**
+ * What became of handle_stuff() calls since the last reset, and who forced
+ * the early flushes
+ */
+static u32b flush_counts[PROFILE_FLUSH_MAX];
+static struct {
+	const char *who;
+	u32b count;
+} flush_callers[PROFILE_FLUSH_CALLERS];
+
+const char *profile_phase_name(enum profile_phase phase)
+{
+	return phase_names[phase];
+}
+
+/**
+ * A monotonic clock in nanoseconds, or the best we can do
+ */
+u64b profile_clock(void)
+{
+#if defined(CLOCK_MONOTONIC)
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (u64b) now.tv_sec * 1000000000 + now.tv_nsec;
+#else
+	return (u64b) clock() * (1000000000 / CLOCKS_PER_SEC);
+#endif
+}
+
+/**
+ * Start timing something; pass the result to profile_end()
+ */
+u64b profile_begin(void)
+{
+#ifdef GAME_TRACE
+	return profile_clock();
+#else
+	return profile_enabled ? profile_clock() : 0;
+#endif
+}
+
+static void add_time(struct profile_stats *stats, u64b time, int bin)
+{
+	stats->total += time;
+	stats->longest = MAX(stats->longest, time);
+	stats->count++;
+	stats->bins[bin]++;
+}
+
+/**
+ * Count the time since `start` against `phase`
+ */
+void profile_end(enum profile_phase phase, u64b start)
+{
+	u64b time, limit = 1000;
+	int bin = 0;
+
+	if (!start) return;
+	trace_end(phase, 0, start);
+	if (!profile_enabled) return;
+
+	time = profile_clock() - start;
+	while (bin < PROFILE_BINS - 1 && time >= limit) {
+		bin++;
+		limit *= 4;
+	}
+
+	add_time(&cumulative[phase], time, bin);
+	add_time(&window[window_slot][phase], time, bin);
+}
+
+/**
+ * Note that a game turn has passed, moving the rolling window on if needed
+ */
+void profile_tick(void)
+{
+	if (!profile_enabled || ++window_turns < PROFILE_SLOT_TURNS) return;
+
+	window_turns = 0;
+	window_slot = (window_slot + 1) % PROFILE_WINDOW;
+	memset(window[window_slot], 0, sizeof(window[window_slot]));
+	if (window_used < PROFILE_WINDOW) window_used++;
+}
+
+/**
+ * Count a handle_stuff() which had something to do; `who` names the caller
+ * of an early flush, and is ignored otherwise
+ */
+void profile_flush(enum profile_flush what, const char *who)
+{
+	int i;
+
+	if (!profile_enabled) return;
+	flush_counts[what]++;
+	if (what != PROFILE_FLUSH_FORCED || !who) return;
+
+	/* Callers are static strings, so the pointer will do to tell them
+	 * apart; any past the last slot are left out */
+	for (i = 0; i < PROFILE_FLUSH_CALLERS; i++) {
+		if (!flush_callers[i].who) flush_callers[i].who = who;
+		if (flush_callers[i].who == who) {
+			flush_callers[i].count++;
+			return;
+		}
+	}
+}
+
+/**
+ * Number of handle_stuff() calls which came to `what` since the last reset
+ */
+u32b profile_flush_count(enum profile_flush what)
+{
+	return flush_counts[what];
+}
+
+void profile_reset(void)
+{
+	memset(flush_counts, 0, sizeof(flush_counts));
+	memset(flush_callers, 0, sizeof(flush_callers));
+	memset(cumulative, 0, sizeof(cumulative));
+	memset(window, 0, sizeof(window));
+	window_slot = 0;
+	window_used = 1;
+	window_turns = 0;
+}
+
+/**
+ * Total time in nanoseconds spent in `phase` since the last reset
+ */
+u64b profile_total(enum profile_phase phase)
+{
+	return cumulative[phase].total;
+}
+
+/**
+ * Number of times `phase` has been timed since the last reset
+ */
+u32b profile_count(enum profile_phase phase)
+{
+	return cumulative[phase].count;
+}
+
+/**
+ * Get the timings for `phase`, either since the last reset or, if `rolling`
+ * is set, over the rolling window
+ */
+void profile_get_stats(enum profile_phase phase, bool rolling,
+					   struct profile_stats *stats)
+{
+	int i, j;
+
+	if (!rolling) {
+		*stats = cumulative[phase];
+		return;
+	}
+
+	memset(stats, 0, sizeof(*stats));
+	for (i = 0; i < PROFILE_WINDOW; i++) {
+		struct profile_stats *slot = &window[i][phase];
+		stats->total += slot->total;
+		stats->longest = MAX(stats->longest, slot->longest);
+		stats->count += slot->count;
+		for (j = 0; j < PROFILE_BINS; j++)
+			stats->bins[j] += slot->bins[j];
+	}
+}
+
+static void describe_stats(textblock *tb, bool rolling)
+{
+	struct profile_stats stats[PROFILE_MAX];
+	u64b all = 0;
+	int i, j;
+
+	for (i = 0; i < PROFILE_MAX; i++) {
+		profile_get_stats(i, rolling, &stats[i]);
+		if (i == PROFILE_PLAYER || i == PROFILE_WORLD || i == PROFILE_MONSTERS)
+			all += stats[i].total;
+	}
+
+	textblock_append(tb, "%-17s %8s %10s %6s %9s %9s\n", "", "calls",
+					 "total ms", "share", "mean us", "max us");
+	for (i = 0; i < PROFILE_MAX; i++) {
+		struct profile_stats *s = &stats[i];
+		textblock_append(tb, "%-17s %8lu %10.1f %5.1f%% %9.1f %9.1f\n",
+						 phase_names[i], (unsigned long) s->count,
+						 s->total / 1e6, all ? 100.0 * s->total / all : 0.0,
+						 s->count ? s->total / 1e3 / s->count : 0.0,
+						 s->longest / 1e3);
+	}
+
+	textblock_append(tb, "\n%-17s", "");
+	for (j = 0; j < PROFILE_BINS; j++)
+		textblock_append(tb, " %6s", bin_names[j]);
+	textblock_append(tb, "\n");
+	for (i = 0; i < PROFILE_MAX; i++) {
+		textblock_append(tb, "%-17s", phase_names[i]);
+		for (j = 0; j < PROFILE_BINS; j++) {
+			u32b n = stats[i].bins[j];
+			if (n)
+				textblock_append(tb, " %5.1f%%",
+								 100.0 * n / stats[i].count);
+			else
+				textblock_append(tb, " %6s", "-");
+		}
+		textblock_append(tb, "\n");
+	}
+}
+
+/**
+ * Describe the timings gathered so far
+ */
+void profile_describe(textblock *tb)
+{
+	int i;
+
+	textblock_append(tb, "Game loop profiling is %s.  Shares are of the "
+					 "time spent in process_player, process_world and "
+					 "process_monsters; the other phases are mostly called "
+					 "from within those, so the shares add up to more than "
+					 "100%%.\n\n",
+					 profile_enabled ? "on" : "off");
+
+	textblock_append(tb, "Since the last reset:\n\n");
+	describe_stats(tb, false);
+
+	textblock_append(tb, "\nOver the last %d game turns:\n\n",
+					 (window_used - 1) * PROFILE_SLOT_TURNS + window_turns);
+	describe_stats(tb, true);
+
+	textblock_append(tb, "\nSince the last reset, handle_stuff() drew %lu "
+					 "times, put off %lu and was forced early %lu times",
+					 (unsigned long) flush_counts[PROFILE_FLUSH_DONE],
+					 (unsigned long) flush_counts[PROFILE_FLUSH_PUT_OFF],
+					 (unsigned long) flush_counts[PROFILE_FLUSH_FORCED]);
+	for (i = 0; i < PROFILE_FLUSH_CALLERS && flush_callers[i].who; i++)
+		textblock_append(tb, "%s %s %lu", i ? "," : " by",
+						 flush_callers[i].who,
+						 (unsigned long) flush_callers[i].count);
+	textblock_append(tb, ".\n");
+}
+
+/**
+ * Describe what each part of the game has allocated, if that is being kept
+ * track of
+ */
+void profile_describe_memory(textblock *tb)
+{
+	int i;
+
+	if (!(mem_flags & MEM_ACCOUNT)) {
+		textblock_append(tb, "Memory accounting is off; start the game with "
+						 "-xmem-account to turn it on.\n");
+		return;
+	}
+
+	textblock_append(tb, "Memory allocated by each part of the game; peaks "
+					 "and counts are since the last reset.\n\n");
+	textblock_append(tb, "%-17s %10s %10s %10s %10s\n", "", "KB", "peak KB",
+					 "allocs", "frees");
+	for (i = 0; i < MEM_TAG_MAX; i++) {
+		struct mem_tag_stats stats;
+
+		mem_tag_get_stats(i, &stats);
+		textblock_append(tb, "%-17s %10.1f %10.1f %10lu %10lu\n",
+						 mem_tag_name(i), stats.bytes / 1024.0,
+						 stats.peak / 1024.0, (unsigned long) stats.allocs,
+						 (unsigned long) stats.frees);
+	}
+}
+
+#ifdef GAME_TRACE
+
+/**
+ * One traced span; times are in nanoseconds
+ */
+struct trace_record {
+	u64b start;
+	u32b length;
+	u16b span;
+	s16b arg;
+};
+
+static const char *trace_names[TRACE_MAX - PROFILE_MAX] = {
+	"run_game_loop",
+	"monster turn",
+	"project"
+};
+
+static const char *trace_arg_names[TRACE_MAX - PROFILE_MAX] = {
+	NULL,
+	"race",
+	"type"
+};
+
+/**
+ * The most recent spans; trace_count counts every span ever recorded, so
+ * the oldest one kept is at trace_count once the ring has filled
+ */
+static struct trace_record trace_ring[TRACE_RING_SIZE];
+static u32b trace_count;
+static char trace_exit_path[1024];
+
+/**
+ * Record the span from `start` until now, with a number `arg` to go with it
+ */
+void trace_end(int span, int arg, u64b start)
+{
+	struct trace_record *rec = &trace_ring[trace_count++ % TRACE_RING_SIZE];
+	u64b length = profile_clock() - start;
+
+	rec->start = start;
+	rec->length = (u32b) MIN(length, 0xFFFFFFFF);
+	rec->span = (u16b) span;
+	rec->arg = (s16b) arg;
+}
+
+/**
+ * Write the spans in the ring to `path` as a Chrome trace, which can be
+ * loaded into chrome://tracing or Perfetto
+ */
+bool trace_dump(const char *path)
+{
+	u32b num = MIN(trace_count, TRACE_RING_SIZE);
+	u32b first = trace_count - num, i;
+	u64b base = num ? trace_ring[first % TRACE_RING_SIZE].start : 0;
+	ang_file *fh = file_open(path, MODE_WRITE, FTYPE_TEXT);
+
+	if (!fh) return false;
+
+	file_putf(fh, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+	for (i = 0; i < num; i++) {
+		struct trace_record *rec = &trace_ring[(first + i) % TRACE_RING_SIZE];
+		const char *name, *arg_name = NULL;
+
+		if (rec->span < PROFILE_MAX) {
+			name = phase_names[rec->span];
+		} else {
+			name = trace_names[rec->span - PROFILE_MAX];
+			arg_name = trace_arg_names[rec->span - PROFILE_MAX];
+		}
+
+		file_putf(fh, "%s\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,"
+				  "\"tid\":1,\"ts\":%.3f,\"dur\":%.3f", i ? "," : "", name,
+				  (rec->start - base) / 1e3, rec->length / 1e3);
+		if (arg_name)
+			file_putf(fh, ",\"args\":{\"%s\":%d}", arg_name, rec->arg);
+		file_putf(fh, "}");
+	}
+	file_putf(fh, "\n]}\n");
+
+	return file_close(fh);
+}
+
+static void trace_exit(void)
+{
+	trace_dump(trace_exit_path);
+}
+
+/**
+ * Have the trace written to `path` when the game exits
+ */
+void trace_dump_at_exit(const char *path)
+{
+	if (!trace_exit_path[0])
+		atexit(trace_exit);
+	my_strcpy(trace_exit_path, path, sizeof(trace_exit_path));
+}
+
+#endif /* GAME_TRACE */
@@ -0,0 +1,133 @@
+/**
+ * \file game-profile.h
+ * \brief Timing of the parts of the game loop and of level generation
+ *
+ * Copyright (c) 2026 The Angband Developers
+ *
+ * This work is free software; you can redistribute it and/or modify it
+ * under the terms of either:
+ *
+ * a) the GNU General Public License as published by the Free Software
+ *    Foundation, version 2, or
+ *
+ * b) the "Angband licence":
+ *    This software may be copied and distributed for educational, research,
+ *    and not for profit purposes provided that this copyright and statement
+ *    are included in all such copies.  Other copyrights may also apply.
+ */
+
+#ifndef GAME_PROFILE_H
+#define GAME_PROFILE_H
+
+#include "h-basic.h"
+#include "z-textblock.h"
+
+/**
+ * The parts of the game loop and of level generation which are timed; the
+ * times are inclusive, so time updating the player during process_player()
+ * counts towards both, as does time placing the monsters of a vault towards
+ * room_build and cave_generate
+ */
+enum profile_phase {
+	PROFILE_PLAYER,
+	PROFILE_WORLD,
+	PROFILE_MONSTERS,
+	PROFILE_UPDATE,
+	PROFILE_REDRAW,
+	PROFILE_FRESH,
+	PROFILE_GENERATE,
+	PROFILE_GEN_ROOMS,
+	PROFILE_GEN_TUNNELS,
+	PROFILE_GEN_STREAMERS,
+	PROFILE_GEN_OBJECTS,
+	PROFILE_GEN_MONSTERS,
+
+	PROFILE_MAX
+};
+
+/**
+ * Timings are binned by duration; bin n holds those shorter than 4^n
+ * microseconds, and the last bin holds everything longer
+ */
+#define PROFILE_BINS 8
+
+/**
+ * The rolling window covers the last PROFILE_WINDOW slots of
+ * PROFILE_SLOT_TURNS game turns each
+ */
+#define PROFILE_WINDOW 100
+#define PROFILE_SLOT_TURNS 10
+
+/**
+ * Timings for one phase
+ */
+struct profile_stats {
+	u64b total;		/* Nanoseconds spent */
+	u64b longest;	/* Longest single call in nanoseconds */
+	u32b count;		/* Number of calls */
+	u32b bins[PROFILE_BINS];
+};
+
+/**
+ * What came of a handle_stuff() which had something to do: done there and
+ * then, put off by a hold or frame, or done early within one because the
+ * screen was about to be shown (see flush_stuff())
+ */
+enum profile_flush {
+	PROFILE_FLUSH_DONE,
+	PROFILE_FLUSH_PUT_OFF,
+	PROFILE_FLUSH_FORCED,
+
+	PROFILE_FLUSH_MAX
+};
+
+/**
+ * The callers forcing early flushes are counted by name, up to this many
+ */
+#define PROFILE_FLUSH_CALLERS 8
+
+extern bool profile_enabled;
+
+const char *profile_phase_name(enum profile_phase phase);
+u64b profile_clock(void);
+u64b profile_begin(void);
+void profile_end(enum profile_phase phase, u64b start);
+void profile_tick(void);
+void profile_flush(enum profile_flush what, const char *who);
+u32b profile_flush_count(enum profile_flush what);
+void profile_reset(void);
+u64b profile_total(enum profile_phase phase);
+u32b profile_count(enum profile_phase phase);
+void profile_get_stats(enum profile_phase phase, bool rolling,
+					   struct profile_stats *stats);
+void profile_describe(textblock *tb);
+void profile_describe_memory(textblock *tb);
+
+/**
+ * Spans of time kept by the trace when it is compiled in (with GAME_TRACE
+ * defined); the profile phases are traced as well, under their own names
+ */
+enum trace_span {
+	TRACE_GAME_LOOP = PROFILE_MAX,
+	TRACE_MONSTER_TURN,
+	TRACE_PROJECT,
+
+	TRACE_MAX
+};
+
+/**
+ * The trace keeps the last TRACE_RING_SIZE spans
+ */
+#define TRACE_RING_SIZE 65536
+
+#ifdef GAME_TRACE
+# define trace_begin() profile_clock()
+void trace_end(int span, int arg, u64b start);
+bool trace_dump(const char *path);
+void trace_dump_at_exit(const char *path);
+#else
+# define trace_begin() 0
+# define trace_end(span, arg, start) ((void)(arg), (void)(start))
+#endif
+
+#endif /* !GAME_PROFILE_H */
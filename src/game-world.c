@@ -19,11 +19,14 @@
 #include "angband.h"
 #include "cmds.h"
 #include "effects.h"
+#include "game-digest.h"
+#include "game-profile.h"
 #include "game-world.h"
 #include "generate.h"
 #include "init.h"
 #include "mon-make.h"
 #include "mon-move.h"
+#include "mon-predicate.h"
 #include "mon-util.h"
 #include "obj-curse.h"
 #include "obj-desc.h"
@@ -45,6 +48,7 @@ u32b seed_flavor;		/* Hack -- consistent object colors */
 s32b turn;				/* Current game turn */
 bool character_generated;	/* The character exists */
 bool character_dungeon;		/* The character has a dungeon */
+bool display_null;		/* Nothing is ever shown, so don't prepare any */
 struct level *world;
 
 /**
@@ -205,6 +209,9 @@ static void recharge_objects(void)
 		/* Skip non-objects */
 		assert(obj->kind);
 
+		/* Nothing is charging */
+		if (obj->timeout <= 0) continue;
+
 		/* Recharge equipment */
 		if (object_is_equipped(player->body, obj)) {
 			/* Recharge activatable objects */
@@ -242,7 +249,7 @@ static void recharge_objects(void)
 	/* Recharge other level objects */
 	for (i = 1; i < cave->obj_max; i++) {
 		obj = cave->objects[i];
-		if (!obj) continue;
+		if (!obj || obj->timeout <= 0) continue;
 
 		/* Recharge rods */
 		if (tval_can_have_timeout(obj))
@@ -334,23 +341,22 @@ static void decrease_timeouts(void)
 
 	/* Curse effects always decrement by 1 */
 	for (i = 0; i < player->body.count; i++) {
-		struct curse_data *curse = NULL;
-		if (player->body.slots[i].obj == NULL) {
+		struct object *obj = player->body.slots[i].obj;
+		int j;
+		if (obj == NULL) {
 			continue;
 		}
-		curse = player->body.slots[i].obj->curses;
-		if (curse) {
-			int j;
-			for (j = 0; j < z_info->curse_max; j++) {
-				if (curse[j].power) {
-					curse[j].timeout--;
-					if (!curse[j].timeout) {
-						struct curse *c = &curses[j];
-						if (do_curse_effect(j, player->body.slots[i].obj)) {
-							player_learn_curse(player, c);
-						}
-						curse[j].timeout = randcalc(c->obj->time, 0, RANDOMISE);
+		for (j = 0; j < obj->num_curses; j++) {
+			struct curse_data *curse = &obj->curses[j];
+			if (curse->power) {
+				curse->timeout--;
+				if (!curse->timeout) {
+					struct curse *c = &curses[curse->index];
+					if (do_curse_effect(curse->index, obj)) {
+						player_learn_curse(player, c);
 					}
+					obj->curses[j].timeout = randcalc(c->obj->time, 0,
+													  RANDOMISE);
 				}
 			}
 		}
@@ -361,83 +367,135 @@ static void decrease_timeouts(void)
 
 
 /**
- * Every turn, the character makes enough noise that nearby monsters can use
- * it to home in.
- *
- * This function actually just computes distance from the player; this is
- * used in combination with the player's stealth value to determine what
- * monsters can hear.  We mark the player's grid with 0, then fill in the noise
- * field of every grid that the player can reach with that "noise"
- * (actally distance) plus the number of steps needed to reach that grid
- * - so higher values mean further from the player.
- *
- * Monsters use this information by moving to adjacent grids with lower noise
- * values, thereby homing in on the player even though twisty tunnels and
- * mazes.  Monsters have a hearing value, which is the largest sound value
- * they can detect.
+ * Whether a grid stops a flow of the given class
  */
-static void make_noise(struct player *p)
+static bool flow_blocked(struct chunk *c, enum flow_class fc, struct loc grid)
 {
-	struct loc next = p->grid;
-	int y, x, d;
-	int noise = 0;
-    struct queue *queue = q_new(cave->height * cave->width);
-	struct loc decoy = cave_find_decoy(cave);
+	switch (fc) {
+		case FLOW_ROCK: return square_isperm(c, grid);
+		default: return square_isnoflow(c, grid);
+	}
+}
 
-	/* Set all the grids to silence */
-	for (y = 1; y < cave->height - 1; y++) {
-		for (x = 1; x < cave->width - 1; x++) {
-			cave->noise.grids[y][x] = 0;
-		}
+/**
+ * Bring the flow of class `fc` up to date, as the number of steps from
+ * `source` to every grid the flow can reach in at most `limit` steps (or
+ * any number, if `limit` is 0).
+ *
+ * We mark the source grid with 0, then fill in every grid that can be
+ * reached from there with the number of steps needed to reach it - so
+ * higher values mean further from the source.  The flow is only filled
+ * again when the source or the player has moved, or the terrain has changed
+ * in a way that matters to it, since it was last filled.
+ */
+void update_flow(struct chunk *c, enum flow_class fc, struct loc source,
+				 int limit, struct player *p)
+{
+	struct flow_map *flow = &c->flows[fc];
+	struct loc next = source;
+	int d;
+	int dist = 0;
+
+	/* The first use of a flow on the level makes its map */
+	if (!flow->grids) {
+		flow->grids = mem_zalloc(c->height * c->width * sizeof(*flow->grids));
+		flow->stamp = mem_zalloc(c->height * c->width * sizeof(*flow->stamp));
+		flow->generation = 0;
 	}
 
-	/* If there's a decoy, use that instead of the player */
-	if (!loc_is_zero(decoy)) {
-		next = decoy;
+	/* Nothing has changed, so the existing flow is still correct */
+	if (flow->generation && !flow->stale && loc_eq(flow->source, source) &&
+		loc_eq(flow->player, p->grid) && flow->limit == limit) {
+		return;
+	}
+	flow->source = source;
+	flow->player = p->grid;
+	flow->limit = limit;
+	flow->stale = false;
+
+	/* Clear all the grids by starting a new generation */
+	if (++flow->generation == 0) {
+		memset(flow->stamp, 0, c->height * c->width * sizeof(*flow->stamp));
+		flow->generation = 1;
+	}
+	if (!flow->queue) {
+		flow->queue = q_new(c->height * c->width);
 	}
 
-	/* Player makes noise */
-	cave->noise.grids[next.y][next.x] = noise;
-	q_push_int(queue, grid_to_i(next, cave->width));
-	noise++;
+	/* Start at the source */
+	flow->grids[grid_to_i(next, c->width)] = dist;
+	flow->stamp[grid_to_i(next, c->width)] = flow->generation;
+	q_push_int(flow->queue, grid_to_i(next, c->width));
+	dist++;
 
-	/* Propagate noise */
-	while (q_len(queue) > 0) {
+	/* Propagate the flow */
+	while (q_len(flow->queue) > 0) {
 		/* Get the next grid */
-		i_to_grid(q_pop_int(queue), cave->width, &next);
+		i_to_grid(q_pop_int(flow->queue), c->width, &next);
 
-		/* If we've reached the current noise level, put it back and step */
-		if (cave->noise.grids[next.y][next.x] == noise) {
-			q_push_int(queue, grid_to_i(next, cave->width));
-			noise++;
+		/* If we've reached the current distance, put it back and step */
+		if (square_flow(c, fc, next) == dist) {
+			/* Everything as far as the limit is filled */
+			if (dist == limit) {
+				q_reset(flow->queue);
+				break;
+			}
+			q_push_int(flow->queue, grid_to_i(next, c->width));
+			dist++;
 			continue;
 		}
 
-		/* Assign noise to the children and enqueue them */
+		/* Assign distance to the children and enqueue them */
 		for (d = 0; d < 8; d++)	{
 			/* Child location */
 			struct loc grid = loc_sum(next, ddgrid_ddd[d]);
+			int i = grid_to_i(grid, c->width);
 
-			if (!square_in_bounds(cave, grid)) continue;
+			if (!square_in_bounds(c, grid)) continue;
 
-			/* Ignore features that don't transmit sound */
-			if (square_isnoflow(cave, grid)) continue;
+			/* Ignore features the flow doesn't pass */
+			if (flow_blocked(c, fc, grid)) continue;
 
-			/* Skip grids that already have noise */
-			if (cave->noise.grids[grid.y][grid.x] != 0) continue;
+			/* Skip grids that the flow has already reached */
+			if (square_flow(c, fc, grid) != 0) continue;
 
 			/* Skip the player grid */
-			if (loc_eq(player->grid, grid)) continue;
+			if (loc_eq(p->grid, grid)) continue;
 
-			/* Save the noise */
-			cave->noise.grids[grid.y][grid.x] = noise;
+			/* Save the distance */
+			flow->grids[i] = dist;
+			flow->stamp[i] = flow->generation;
 
 			/* Enqueue that entry */
-			q_push_int(queue, grid_to_i(grid, cave->width));
+			q_push_int(flow->queue, i);
 		}
 	}
+}
 
-	q_free(queue);
+/**
+ * Every turn, the character makes enough noise that nearby monsters can use
+ * it to home in.
+ *
+ * This function actually just computes distance from the player; this is
+ * used in combination with the player's stealth value to determine what
+ * monsters can hear.  The noise of each grid the player can reach is the
+ * number of steps needed to reach it (see update_flow()).
+ *
+ * Monsters use this information by moving to adjacent grids with lower noise
+ * values, thereby homing in on the player even though twisty tunnels and
+ * mazes.  Monsters have a hearing value, which is the largest sound value
+ * they can detect, so the noise need go no further than the keenest hearing
+ * of the monsters on the level, with a margin for those fleeing.
+ */
+void make_noise(struct player *p)
+{
+	struct loc decoy = cave_find_decoy(cave);
+	int stealth = p->state.skills[SKILL_STEALTH] / 3;
+	int limit = cave_monster_hearing(cave) - MIN(stealth, 0) + NOISE_MARGIN;
+
+	/* If there's a decoy, use that instead of the player */
+	update_flow(cave, FLOW_NOISE, loc_is_zero(decoy) ? p->grid : decoy,
+				MAX(limit, NOISE_WAKE_MAX), p);
 }
 
 /**
@@ -453,10 +511,13 @@ static void make_noise(struct player *p)
  * value which indicates the oldest scent they can detect.  Grids where the
  * player has never been will have scent 0.  The player's grid will also have
  * scent 0, but this is OK as no monster will ever be smelling it.
+ *
+ * Aging is done by advancing the chunk's scent turn; square_scent() works
+ * out the age of each grid's scent from the turn it was laid.
  */
 static void update_scent(void)
 {
-	int y, x;
+	int y, x, i;
 	int scent_strength[5][5] = {
 		{2, 2, 2, 2, 2},
 		{2, 1, 1, 1, 2},
@@ -465,13 +526,15 @@ static void update_scent(void)
 		{2, 2, 2, 2, 2},
 	};
 
-	/* Update scent for all grids */
-	for (y = 1; y < cave->height - 1; y++) {
-		for (x = 1; x < cave->width - 1; x++) {
-			if (cave->scent.grids[y][x] > 0) {
-				cave->scent.grids[y][x]++;
-			}
-		}
+	/* Age the scent on all grids */
+	cave->scent.turn++;
+
+	/* The first scent on the level makes its map */
+	if (!cave->scent.laid) {
+		cave->scent.strength = mem_zalloc(cave->height * cave->width *
+										  sizeof(*cave->scent.strength));
+		cave->scent.laid = mem_zalloc(cave->height * cave->width *
+									  sizeof(*cave->scent.laid));
 	}
 
 	/* Scentless player */
@@ -507,7 +570,7 @@ static void update_scent(void)
 				}
 
 				/* Adjacent to a closer grid, so valid */
-				if (cave->scent.grids[adj.y][adj.x] == new_scent - 1) {
+				if (square_scent(cave, adj) == new_scent - 1) {
 					add_scent = true;
 				}
 			}
@@ -517,8 +580,10 @@ static void update_scent(void)
 				continue;
 			}
 
-			/* Mark the scent */
-			cave->scent.grids[scent.y][scent.x] = new_scent;
+			/* Mark the scent; zero strength is no scent at all */
+			i = grid_to_i(scent, cave->width);
+			cave->scent.strength[i] = new_scent;
+			cave->scent.laid[i] = new_scent ? cave->scent.turn : 0;
 		}
 	}
 }
@@ -528,7 +593,7 @@ static void update_scent(void)
  */
 void process_world(struct chunk *c)
 {
-	int i, y, x;
+	int i;
 
 	/* Compact the monster list if we're approaching the limit */
 	if (cave_monster_count(c) + 32 > z_info->level_monster_max)
@@ -727,18 +792,24 @@ void process_world(struct chunk *c)
 	if (!(turn % 100))
 		equip_learn_after_time(player);
 
-	/* Decrease trap timeouts */
-	for (y = 0; y < c->height; y++) {
-		for (x = 0; x < c->width; x++) {
-			struct loc grid = loc(x, y);
-			struct trap *trap = square(c, grid).trap;
-			while (trap) {
+	/* Decrease trap timeouts, if there are any left */
+	if (c->traps_timed) {
+		int size = c->height * c->width;
+
+		c->traps_timed = false;
+		for (i = grid_plane_next(c->trapped, 0, size); i < size;
+			 i = grid_plane_next(c->trapped, i + 1, size)) {
+			struct trap *trap;
+			for (trap = c->trap[i]; trap; trap = trap->next) {
+				if (!trap->timeout) continue;
+				trap->timeout--;
 				if (trap->timeout) {
-					trap->timeout--;
-					if (!trap->timeout)
-						square_light_spot(c, grid);
+					c->traps_timed = true;
+				} else {
+					struct loc grid;
+					i_to_grid(i, c->width, &grid);
+					square_light_spot(c, grid);
 				}
-				trap = trap->next;
 			}
 		}
 	}
@@ -875,6 +946,66 @@ static void process_player_cleanup(void)
  * also reduces the number of times that the recall window must
  * be redrawn.
  */
+/**
+ * While resting or repeating a command undisturbed, only show every this many
+ * turns of it
+ */
+#define FAST_FORWARD_TURNS 10
+
+/**
+ * Is there a monster in view which can be seen?
+ */
+static bool visible_monster_in_view(void)
+{
+	int i;
+
+	for (i = 1; i < cave_monster_max(cave); i++) {
+		struct monster *mon = cave_monster(cave, i);
+		if (mon->race && monster_is_in_view(mon) && monster_is_visible(mon))
+			return true;
+	}
+	return false;
+}
+
+/**
+ * Is there nothing for the player to see at this point?
+ *
+ * That is so for the game turns between a resting or running player's moves,
+ * and for all but every FAST_FORWARD_TURNS turns of a rest.  Anything that
+ * would be worth seeing disturbs the player, which stops the rest or run.
+ *
+ * A repeated command, such as tunnelling, disarming or opening a lock, is
+ * treated like a rest while no monster is in view; one coming into view
+ * disturbs the player, which stops the repeat.
+ */
+static bool fast_forward(bool player_turn)
+{
+	int nrepeats = cmd_get_nrepeats();
+
+	if (player->upkeep->running)
+		return !player_turn;
+	if (player_is_resting(player))
+		return !player_turn || (player->resting_turn % FAST_FORWARD_TURNS);
+	if (nrepeats > 0 && !visible_monster_in_view())
+		return !player_turn || (nrepeats % FAST_FORWARD_TURNS);
+	return false;
+}
+
+/**
+ * Bring the player up to date, and the screen too unless fast forwarding;
+ * the redraw is then left until there is something to see
+ */
+static void refresh_stuff(bool player_turn)
+{
+	notice_stuff(player);
+	if (fast_forward(player_turn)) {
+		if (player->upkeep->update) update_stuff(player);
+		return;
+	}
+	handle_stuff(player);
+	event_signal(EVENT_REFRESH);
+}
+
 void process_player(void)
 {
 	/* Check for interrupts */
@@ -884,9 +1015,7 @@ void process_player(void)
 	/* Repeat until energy is reduced */
 	do {
 		/* Refresh */
-		notice_stuff(player);
-		handle_stuff(player);
-		event_signal(EVENT_REFRESH);
+		refresh_stuff(true);
 
 		/* Hack -- Pack Overflow */
 		pack_overflow(NULL);
@@ -922,7 +1051,8 @@ void process_player(void)
 				player->upkeep->redraw |= (PR_MONSTER);
 
 			/* Place cursor on player/target */
-			event_signal(EVENT_REFRESH);
+			if (!fast_forward(true))
+				event_signal(EVENT_REFRESH);
 		}
 
 		/* Get a command from the queue if there is one */
@@ -1013,16 +1143,38 @@ static void on_leave_level(void) {
 
 	/* Flush messages */
 	event_signal(EVENT_MESSAGE_FLUSH);
+
+	/* Monsters don't gain energy while the player is away */
+	monster_schedule_reset(cave);
 }
 
 
 /**
- * The main game loop.
- *
- * This function will run until the player needs to enter a command, or closes
- * the game, or the character dies.
+ * Run `call`, counting the time it takes against `phase` if the game loop
+ * is being timed
  */
-void run_game_loop(void)
+#define PROFILE_CALL(phase, call) \
+	do { \
+		u64b profile_start = profile_begin(); \
+		call; \
+		profile_end(phase, profile_start); \
+	} while (0)
+
+/**
+ * Run `call` as a frame (see frame_begin()), timed as `phase`; the game loop
+ * brings the screen up to date after each
+ */
+#define FRAME_CALL(phase, call) \
+	do { \
+		frame_begin(player); \
+		PROFILE_CALL(phase, call); \
+		frame_end(player); \
+	} while (0)
+
+/**
+ * The main game loop, as run_game_loop() but untraced
+ */
+static void run_game_loop_aux(void)
 {
 	/* Tidy up after the player's command */
 	process_player_cleanup();
@@ -1030,7 +1182,7 @@ void run_game_loop(void)
 	/* Keep processing the player until they use some energy or
 	 * another command is needed */
 	while (player->upkeep->playing) {
-		process_player();
+		PROFILE_CALL(PROFILE_PLAYER, process_player());
 		if (player->upkeep->energy_use)
 			break;
 		else
@@ -1044,14 +1196,15 @@ void run_game_loop(void)
 		event_signal(EVENT_ANIMATE);
 		
 		/* Process monster with even more energy first */
-		process_monsters(cave, player->energy + 1);
+		FRAME_CALL(PROFILE_MONSTERS,
+					 process_monsters(cave, player->energy + 1));
 		if (player->is_dead || !player->upkeep->playing ||
 			player->upkeep->generate_level)
 			break;
 
 		/* Process the player until they use some energy */
 		while (player->upkeep->playing) {
-			process_player();
+			PROFILE_CALL(PROFILE_PLAYER, process_player());
 			if (player->upkeep->energy_use)
 				break;
 			else
@@ -1062,9 +1215,7 @@ void run_game_loop(void)
 	/* Now that the player's turn is fully complete, we run the main loop 
 	 * until player input is needed again */
 	while (true) {
-		notice_stuff(player);
-		handle_stuff(player);
-		event_signal(EVENT_REFRESH);
+		refresh_stuff(false);
 
 		/* Process the rest of the world, give the player energy and 
 		 * increment the turn counter unless we need to stop playing or
@@ -1073,26 +1224,22 @@ void run_game_loop(void)
 			return;
 		else if (!player->upkeep->generate_level) {
 			/* Process the rest of the monsters */
-			process_monsters(cave, 0);
+			FRAME_CALL(PROFILE_MONSTERS, process_monsters(cave, 0));
 
 			/* Mark all monsters as ready to act when they have the energy */
 			reset_monsters();
 
 			/* Refresh */
-			notice_stuff(player);
-			handle_stuff(player);
-			event_signal(EVENT_REFRESH);
+			refresh_stuff(false);
 			if (player->is_dead || !player->upkeep->playing)
 				return;
 
 			/* Process the world every ten turns */
 			if (!(turn % 10) && !player->upkeep->generate_level) {
-				process_world(cave);
+				FRAME_CALL(PROFILE_WORLD, process_world(cave));
 
 				/* Refresh */
-				notice_stuff(player);
-				handle_stuff(player);
-				event_signal(EVENT_REFRESH);
+				refresh_stuff(false);
 				if (player->is_dead || !player->upkeep->playing)
 					return;
 			}
@@ -1102,6 +1249,8 @@ void run_game_loop(void)
 
 			/* Count game turns */
 			turn++;
+			profile_tick();
+			digest_tick();
 		}
 
 		/* Make a new level if requested */
@@ -1133,14 +1282,15 @@ void run_game_loop(void)
 			event_signal(EVENT_ANIMATE);
 
 			/* Process monster with even more energy first */
-			process_monsters(cave, player->energy + 1);
+			FRAME_CALL(PROFILE_MONSTERS,
+						 process_monsters(cave, player->energy + 1));
 			if (player->is_dead || !player->upkeep->playing ||
 				player->upkeep->generate_level)
 				break;
 
 			/* Process the player until they use some energy */
 			while (player->upkeep->playing) {
-				process_player();
+				PROFILE_CALL(PROFILE_PLAYER, process_player());
 				if (player->upkeep->energy_use)
 					break;
 				else
@@ -1149,3 +1299,17 @@ void run_game_loop(void)
 		}
 	}
 }
+
+/**
+ * The main game loop.
+ *
+ * This function will run until the player needs to enter a command, or closes
+ * the game, or the character dies.
+ */
+void run_game_loop(void)
+{
+	u64b start = trace_begin();
+
+	run_game_loop_aux();
+	trace_end(TRACE_GAME_LOOP, 0, start);
+}
@@ -35,6 +35,7 @@ extern u32b seed_flavor;
 extern s32b turn;
 extern bool character_generated;
 extern bool character_dungeon;
+extern bool display_null;
 extern const byte extract_energy[200];
 extern struct level *world;
 
@@ -43,6 +44,18 @@ struct level *level_by_depth(int depth);
 bool is_daytime(void);
 int turn_energy(int speed);
 void play_ambient_sound(void);
+/**
+ * How far past the keenest hearing on the level make_noise() spreads, so
+ * that frightened monsters can weigh up the grids around them (see
+ * get_move_find_safety()); and the furthest noise which hurries sleeping
+ * monsters awake, which it always spreads to
+ */
+#define NOISE_MARGIN	20
+#define NOISE_WAKE_MAX	50
+
+void update_flow(struct chunk *c, enum flow_class fc, struct loc source,
+				 int limit, struct player *p);
+void make_noise(struct player *p);
 void process_world(struct chunk *c);
 void on_new_level(void);
 void process_player(void);
@@ -62,6 +62,7 @@
 #include "cave.h"
 #include "datafile.h"
 #include "game-event.h"
+#include "game-profile.h"
 #include "game-world.h"
 #include "generate.h"
 #include "init.h"
@@ -92,6 +93,55 @@ static bool square_is_granite_with_flag(struct chunk *c, struct loc grid,
 	return true;
 }
 
+/**
+ * Counts of what build_tunnel() has done, for benchmarks and debugging
+ */
+struct tunnel_stats tunnel_stats;
+
+/**
+ * Check whether a tunnel at `grid` may take a step along `offset`; see
+ * build_tunnel() for the rules
+ */
+static bool tunnel_step_allowed(struct chunk *c, struct loc grid,
+								struct loc offset)
+{
+	struct loc next = loc_sum(grid, offset);
+
+	/* Avoid the edge of the dungeon and "solid" granite walls */
+	if (!square_in_bounds(c, next)) return false;
+	if (square_isperm(c, next)) return false;
+	if (square_is_granite_with_flag(c, next, SQUARE_WALL_SOLID)) return false;
+
+	/* "Outer" walls of rooms can only be pierced if the grid beyond is in
+	 * bounds and not permanent, outer or solid wall */
+	if (square_is_granite_with_flag(c, next, SQUARE_WALL_OUTER)) {
+		struct loc beyond = loc_sum(next, offset);
+
+		if (!square_in_bounds(c, beyond)) return false;
+		if (square_isperm(c, beyond)) return false;
+		if (square_is_granite_with_flag(c, beyond, SQUARE_WALL_OUTER))
+			return false;
+		if (square_is_granite_with_flag(c, beyond, SQUARE_WALL_SOLID))
+			return false;
+	}
+
+	return true;
+}
+
+/**
+ * Check whether a tunnel at `grid` can't take a step in any direction.
+ * Tunnels only move in cardinal directions, and the map only changes when
+ * they move, so such a tunnel can never move again.
+ */
+static bool tunnel_boxed_in(struct chunk *c, struct loc grid)
+{
+	int i;
+
+	for (i = 0; i < 4; i++)
+		if (tunnel_step_allowed(c, grid, ddgrid_ddd[i])) return false;
+	return true;
+}
+
 /**
  * Places a streamer of rock through dungeon.
  *
@@ -106,6 +156,8 @@ static bool square_is_granite_with_flag(struct chunk *c, struct loc grid,
  */
 static void build_streamer(struct chunk *c, int feat, int chance)
 {
+	u64b start_time = profile_begin();
+
     /* Hack -- Choose starting point */
 	struct loc grid = rand_loc(loc(c->width / 2, c->height / 2), 15, 10);
 
@@ -140,6 +192,8 @@ static void build_streamer(struct chunk *c, int feat, int chance)
 		/* Stop at dungeon edge */
 		if (!square_in_bounds(c, grid)) break;
     }
+
+	profile_end(PROFILE_GEN_STREAMERS, start_time);
 }
 
 
@@ -166,16 +220,26 @@ static void build_streamer(struct chunk *c, int feat, int chance)
  *
  * The solid wall check prevents corridors from chopping the corners of rooms
  * off, as well as silly door placement, and excessively wide room entrances.
+ *
+ * The first time a step is refused after a move, we check whether any step
+ * is possible; if not, the tunnel is given up at once rather than trying
+ * again until the step limit.
  */
 static void build_tunnel(struct chunk *c, struct loc grid1, struct loc grid2)
 {
     int i;
     int main_loop_count = 0;
 	struct loc start = grid1, tmp_grid, offset;
+	u64b start_time = profile_begin();
 
     /* Used to prevent excessive door creation along overlapping corridors. */
     bool door_flag = false;
 
+	/* Whether we have checked for being boxed in since the last move */
+	bool checked = false;
+
+	tunnel_stats.tunnels++;
+
     /* Reset the arrays */
     dun->tunn_n = 0;
     dun->wall_n = 0;
@@ -189,7 +253,10 @@ static void build_tunnel(struct chunk *c, struct loc grid1, struct loc grid2)
     /* Keep going until done (or bored) */
     while (!loc_eq(grid1, grid2)) {
 		/* Mega-Hack -- Paranoia -- prevent infinite loops */
-		if (main_loop_count++ > 2000) break;
+		if (main_loop_count++ > 2000) {
+			tunnel_stats.timed_out++;
+			break;
+		}
 
 		/* Allow bends in the tunnel */
 		if (randint0(100) < dun->profile->tun.chg) {
@@ -217,29 +284,21 @@ static void build_tunnel(struct chunk *c, struct loc grid1, struct loc grid2)
 		}
 
 
-		/* Avoid the edge of the dungeon */
-		if (square_isperm(c, tmp_grid)) continue;
-
-		/* Avoid "solid" granite walls */
-		if (square_is_granite_with_flag(c, tmp_grid, SQUARE_WALL_SOLID)) 
+		/* Avoid the edge of the dungeon, "solid" granite walls, and outer
+		 * walls we can't get through */
+		if (!tunnel_step_allowed(c, grid1, offset)) {
+			if (!checked && tunnel_boxed_in(c, grid1)) {
+				tunnel_stats.boxed_in++;
+				break;
+			}
+			checked = true;
 			continue;
+		}
+		checked = false;
 
 		/* Pierce "outer" walls of rooms */
 		if (square_is_granite_with_flag(c, tmp_grid, SQUARE_WALL_OUTER)) {
-			/* Get the "next" location */
-			struct loc grid = loc_sum(tmp_grid, offset);
-
-			/* Stay in bounds */
-			if (!square_in_bounds(c, grid)) continue;
- 
-			/* Hack -- Avoid solid permanent walls */
-			if (square_isperm(c, grid)) continue;
-
-			/* Hack -- Avoid outer/solid granite walls */
-			if (square_is_granite_with_flag(c, grid, SQUARE_WALL_OUTER)) 
-				continue;
-			if (square_is_granite_with_flag(c, grid, SQUARE_WALL_SOLID)) 
-				continue;
+			struct loc grid;
 
 			/* Accept this location */
 			grid1 = tmp_grid;
@@ -290,6 +349,7 @@ static void build_tunnel(struct chunk *c, struct loc grid1, struct loc grid2)
 				if (dun->door_n < z_info->level_door_max) {
 					dun->door[dun->door_n] = grid1;
 					dun->door_n++;
+					tunnel_stats.doors++;
 				}
 
 				/* No door in next grid */
@@ -302,10 +362,17 @@ static void build_tunnel(struct chunk *c, struct loc grid1, struct loc grid2)
 				offset = loc_diff(grid1, start);
 
 				/* Terminate the tunnel if too far vertically or horizontally */
-				if ((ABS(offset.x) > 10) || (ABS(offset.y) > 10)) break;
+				if ((ABS(offset.x) > 10) || (ABS(offset.y) > 10)) {
+					tunnel_stats.stopped++;
+					break;
+				}
 			}
 		}
     }
+	if (loc_eq(grid1, grid2)) tunnel_stats.arrived++;
+	tunnel_stats.steps += main_loop_count;
+	tunnel_stats.dug += dun->tunn_n;
+	tunnel_stats.pierced += dun->wall_n;
 
 
     /* Turn the tunnel into corridor */
@@ -324,6 +391,8 @@ static void build_tunnel(struct chunk *c, struct loc grid1, struct loc grid2)
 		if (randint0(100) < dun->profile->tun.pen)
 			place_random_door(c, dun->wall[i]);
     }
+
+	profile_end(PROFILE_GEN_TUNNELS, start_time);
 }
 
 /**
@@ -447,9 +516,7 @@ struct chunk *classic_gen(struct player *p, int min_height, int min_width) {
     dun->col_blocks = c->width / dun->block_wid;
 
     /* Initialize the room table */
-	dun->room_map = mem_zalloc(dun->row_blocks * sizeof(bool*));
-	for (i = 0; i < dun->row_blocks; i++)
-		dun->room_map[i] = mem_zalloc(dun->col_blocks * sizeof(bool));
+	room_map_new();
 
     /* Initialize the block table */
     blocks_tried = mem_zalloc(dun->row_blocks * sizeof(bool*));
@@ -522,12 +589,10 @@ struct chunk *classic_gen(struct player *p, int min_height, int min_width) {
 		}
     }
 
-	for (i = 0; i < dun->row_blocks; i++){
+	for (i = 0; i < dun->row_blocks; i++)
 		mem_free(blocks_tried[i]);
-		mem_free(dun->room_map[i]);
-	}
 	mem_free(blocks_tried);
-	mem_free(dun->room_map);
+	room_map_free();
 
     /* Generate permanent walls around the edge of the generated area */
     draw_rectangle(c, 0, 0, c->height - 1, c->width - 1, 
@@ -619,23 +684,35 @@ struct chunk *classic_gen(struct player *p, int min_height, int min_width) {
 
 /**
  * Given an adjoining wall (a wall which separates two labyrinth cells)
- * set a and b to point to the cell indices which are separated. Used by
- * labyrinth_gen().
- * \param i is the wall index
- * \param w is the width of the labyrinth
+ * set a and b to the indices of the cells which are separated.  Cells are
+ * the grids with both co-ordinates even, numbered across the lattice of
+ * cells only. Used by labyrinth_gen().
+ * \param grid is the wall's position in the labyrinth
+ * \param cw is the number of cells across the labyrinth
  * \param a are the two cell indices
  * \param b are the two cell indices
  */
-static void lab_get_adjoin(int i, int w, int *a, int *b) {
-    struct loc grid;
-    i_to_grid(i, w, &grid);
-    if (grid.x % 2 == 0) {
-		*a = grid_to_i(next_grid(grid, DIR_N), w);
-		*b = grid_to_i(next_grid(grid, DIR_S), w);
-    } else {
-		*a = grid_to_i(next_grid(grid, DIR_W), w);
-		*b = grid_to_i(next_grid(grid, DIR_E), w);
+static void lab_get_adjoin(struct loc grid, int cw, int *a, int *b) {
+    /* Rounding down finds the cell above or to the left */
+    *a = (grid.y / 2) * cw + grid.x / 2;
+    if (grid.x % 2 == 0)
+		*b = *a + cw;
+    else
+		*b = *a + 1;
+}
+
+/**
+ * Return the root of the set a labyrinth cell is in, halving the path to it
+ * as we go.
+ * \param parent is the parent of each cell; roots are their own parent
+ * \param cell is the cell index
+ */
+static int lab_find(int *parent, int cell) {
+    while (parent[cell] != cell) {
+		parent[cell] = parent[parent[cell]];
+		cell = parent[cell];
     }
+    return cell;
 }
 
 /**
@@ -680,24 +757,27 @@ struct chunk *labyrinth_chunk(int depth, int h, int w, bool lit, bool soft)
     /* This is the number of squares in the labyrinth */
     int n = h * w;
 
-    /* NOTE: 'sets' and 'walls' are too large... we only need to use about
-     * 1/4 as much memory. However, in that case, the addressing math becomes
-     * a lot more complicated, so let's just stick with this because it's
-     * easier to read. */
+    /* The cells are the grids with both co-ordinates even; the adjoining
+     * walls are the grids between two of them, with one of each */
+    int cw = (w + 1) / 2, ch = (h + 1) / 2;
+    int cells = cw * ch;
+    int num_walls = ch * (cw - 1) + cw * (ch - 1);
 
-    /* 'sets' tracks connectedness; if sets[i] == sets[j] then cells i and j
-     * are connected to each other in the maze. */
-    int *sets;
+    /* 'parent' and 'rank' make a disjoint-set forest over the cells; cells
+     * i and j are connected in the maze if they have the same root. */
+    int *parent;
+    byte *rank;
 
-    /* 'walls' is a list of wall coordinates which we will randomize */
+    /* 'walls' is a list of adjoining wall positions which we will randomize */
     int *walls;
 
 	/* The labyrinth chunk */
 	struct chunk *c = cave_new(h + 2, w + 2);
 	c->depth = depth;
     /* allocate our arrays */
-    sets = mem_zalloc(n * sizeof(int));
-    walls = mem_zalloc(n * sizeof(int));
+    parent = mem_zalloc(cells * sizeof(int));
+    rank = mem_zalloc(cells * sizeof(byte));
+    walls = mem_zalloc(MAX(num_walls, 1) * sizeof(int));
 
     /* Bound with perma-rock */
     draw_rectangle(c, 0, 0, h + 1, w + 1, FEAT_PERM, SQUARE_NONE);
@@ -708,54 +788,54 @@ struct chunk *labyrinth_chunk(int depth, int h, int w, bool lit, bool soft)
 	else
 		fill_rectangle(c, 1, 1, h, w, FEAT_PERM, SQUARE_NONE);
 
-    /* Initialize each wall. */
-    for (i = 0; i < n; i++) {
-		walls[i] = i;
-		sets[i] = -1;
-    }
+    /* Each cell starts in a set of its own */
+    for (i = 0; i < cells; i++)
+		parent[i] = i;
 
     /* Cut out a grid of 1x1 rooms which we will call "cells" */
     for (grid.y = 0; grid.y < h; grid.y += 2) {
 		for (grid.x = 0; grid.x < w; grid.x += 2) {
-			int k_local = grid_to_i(grid, w);
 			struct loc diag = next_grid(grid, DIR_SE);
-			sets[k_local] = k_local;
 			square_set_feat(c, diag, FEAT_FLOOR);
 			if (lit) sqinfo_on(square(c, diag).info, SQUARE_GLOW);
 		}
     }
 
+    /* List the adjoining walls */
+    for (i = 0, k = 0; i < n; i++) {
+		i_to_grid(i, w, &grid);
+		if (grid.x % 2 != grid.y % 2) walls[k++] = i;
+    }
+    assert(k == num_walls);
+
     /* Shuffle the walls, using Knuth's shuffle. */
-    shuffle(walls, n);
+    shuffle(walls, num_walls);
 
     /* For each adjoining wall, look at the cells it divides. If they aren't
      * in the same set, remove the wall and join their sets.
      *
      * This is a randomized version of Kruskal's algorithm. */
-    for (i = 0; i < n; i++) {
+    for (i = 0; i < num_walls; i++) {
 		int a, b;
 
-		j = walls[i];
-
-		/* If this cell isn't an adjoining wall, skip it */
-		i_to_grid(j, w, &grid);
-		if ((grid.x < 1 && grid.y < 1) || (grid.x > w - 2 && grid.y > h - 2))
-			continue;
-		if (grid.x % 2 == grid.y % 2) continue;
-
 		/* Figure out which cells are separated by this wall */
-		lab_get_adjoin(j, w, &a, &b);
-
-		/* If the cells aren't connected, kill the wall and join the sets */
-		if (sets[a] != sets[b]) {
-			int sa = sets[a];
-			int sb = sets[b];
+		i_to_grid(walls[i], w, &grid);
+		lab_get_adjoin(grid, cw, &a, &b);
+		a = lab_find(parent, a);
+		b = lab_find(parent, b);
+
+		/* If the cells aren't connected, kill the wall and join the sets,
+		 * hanging the shallower tree under the deeper */
+		if (a != b) {
 			square_set_feat(c, next_grid(grid, DIR_SE), FEAT_FLOOR);
 			if (lit) {
 				sqinfo_on(square(c, next_grid(grid, DIR_SE)).info, SQUARE_GLOW);
 			}
-			for (k = 0; k < n; k++) {
-				if (sets[k] == sb) sets[k] = sa;
+			if (rank[a] < rank[b]) {
+				parent[a] = b;
+			} else {
+				parent[b] = a;
+				if (rank[a] == rank[b]) rank[a]++;
 			}
 		}
     }
@@ -782,7 +862,8 @@ struct chunk *labyrinth_chunk(int depth, int h, int w, bool lit, bool soft)
 					  ORIGIN_LABYRINTH);
 
     /* Deallocate our lists */
-    mem_free(sets);
+    mem_free(parent);
+    mem_free(rank);
     mem_free(walls);
 
 	return c;
@@ -899,58 +980,70 @@ static void init_cavern(struct chunk *c, int density) {
 }
 
 /**
- * Return the number of walls (0-8) adjacent to this square.
- * \param c is the current chunk
- * \param y are the co-ordinates
- * \param x are the co-ordinates
- */
-static int count_adj_walls(struct chunk *c, struct loc grid) {
-    int d;
-    int count = 0;
-
-    for (d = 0; d < 8; d++) {
-		if (square_isfloor(c, loc_sum(grid, ddgrid_ddd[d]))) continue;
-		count++;
-	}
-
-    return count;
-}
-
-/**
- * Run a single pass of the cellular automata rules (4,5) on the dungeon.
+ * Run passes of the cellular automata rules (4,5) on the dungeon.
  * \param c is the chunk being mutated
+ * \param times is the number of passes
+ *
+ * The passes work on a map of the floor, one byte per grid, where each row
+ * is first summed in columns of three and then across; these loops have no
+ * branches, so the compiler can vectorise them.  Only the grids which end
+ * up different are written back to the chunk.
  */
-static void mutate_cavern(struct chunk *c) {
+static void mutate_cavern(struct chunk *c, int times) {
 	struct loc grid;
     int h = c->height;
     int w = c->width;
+    int i, n;
 
-    int *temp = mem_zalloc(h * w * sizeof(int));
+    byte *floor = mem_zalloc(h * w);
+    byte *next = mem_zalloc(h * w);
+    byte *cols = mem_zalloc(w);
 
-    for (grid.y = 1; grid.y < h - 1; grid.y++) {
-		for (grid.x = 1; grid.x < w - 1; grid.x++) {
-			int count = count_adj_walls(c, grid);
-			if (count > 5)
-				temp[grid_to_i(grid, w)] = FEAT_GRANITE;
-			else if (count < 4)
-				temp[grid_to_i(grid, w)] = FEAT_FLOOR;
-			else
-				temp[grid_to_i(grid, w)] = square(c, grid).feat;
+    for (n = 0; n < h * w; n++)
+		floor[n] = (feat_props[c->feat[n]] & FEAT_PROP_FLOOR) ? 1 : 0;
+    memcpy(next, floor, h * w);
+
+    for (i = 0; i < times; i++) {
+		byte *swap;
+		int y, x;
+
+		for (y = 1; y < h - 1; y++) {
+			const byte *row = floor + y * w;
+			byte *out = next + y * w;
+
+			for (x = 0; x < w; x++)
+				cols[x] = row[x - w] + row[x] + row[x + w];
+
+			/* Of the eight neighbours, more than five walls make rock and
+			 * fewer than four make floor */
+			for (x = 1; x < w - 1; x++) {
+				int floors = cols[x - 1] + cols[x] + cols[x + 1] - row[x];
+				out[x] = (floors >= 5) | (row[x] & (floors >= 3));
+			}
 		}
+
+		swap = floor;
+		floor = next;
+		next = swap;
     }
 
     for (grid.y = 1; grid.y < h - 1; grid.y++) {
 		for (grid.x = 1; grid.x < w - 1; grid.x++) {
-			if (temp[grid_to_i(grid, w)] == FEAT_GRANITE)
-				set_marked_granite(c, grid, SQUARE_WALL_SOLID);
+			n = grid_to_i(grid, w);
+			if (floor[n] == ((feat_props[c->feat[n]] & FEAT_PROP_FLOOR) ? 1 : 0))
+				continue;
+
+			if (floor[n])
+				square_set_feat(c, grid, FEAT_FLOOR);
 			else
-				square_set_feat(c, grid, temp[grid_to_i(grid, w)]);
+				set_marked_granite(c, grid, SQUARE_WALL_SOLID);
 		}
     }
 
-    mem_free(temp);
+    mem_free(floor);
+    mem_free(next);
+    mem_free(cols);
 }
-
 /**
  * Fill an int[] with a single value.
  * \param data is the array
@@ -962,6 +1055,75 @@ static void array_filler(int data[], int value, int size) {
     for (i = 0; i < size; i++) data[i] = value;
 }
 
+/**
+ * The connected regions of a chunk.  Each grid is colored once, with the
+ * label of the region it was first found in; joining two regions then just
+ * links their labels in a union-find forest, and the color of a grid is the
+ * root of its label.
+ */
+struct region_map {
+    int *colors;	/* Label of each grid, 0 for none */
+    int *counts;	/* Number of grids in each region, held by its root */
+    int *parent;	/* Parent of each label; roots are their own parent */
+    int size;		/* Number of grids, and so the most labels there can be */
+    struct queue *queue;	/* Scratch queue shared by the flood fills */
+};
+
+/**
+ * Allocate an empty region map for a chunk.
+ * \param c is the current chunk
+ */
+static struct region_map *region_map_new(struct chunk *c) {
+    struct region_map *r = mem_zalloc(sizeof(*r));
+    int i;
+
+    r->size = c->height * c->width;
+    r->colors = mem_zalloc(r->size * sizeof(int));
+    r->counts = mem_zalloc((r->size + 1) * sizeof(int));
+    r->parent = mem_zalloc((r->size + 1) * sizeof(int));
+    for (i = 0; i <= r->size; i++) r->parent[i] = i;
+    r->queue = q_new(c->width * 4);
+
+    return r;
+}
+
+/**
+ * Free a region map.
+ * \param r is the region map
+ */
+static void region_map_free(struct region_map *r) {
+    mem_free(r->colors);
+    mem_free(r->counts);
+    mem_free(r->parent);
+    q_free(r->queue);
+    mem_free(r);
+}
+
+/**
+ * Return the current color of a label, halving the path to it as we go.
+ * \param r is the region map
+ * \param label is the label; 0 (no region) is always its own color
+ */
+static int region_find(struct region_map *r, int label) {
+    while (r->parent[label] != label) {
+		r->parent[label] = r->parent[r->parent[label]];
+		label = r->parent[label];
+    }
+    return label;
+}
+
+/**
+ * Fold one color into another.
+ * \param r is the region map
+ * \param from is the color to change
+ * \param to is the color to change to
+ */
+static void region_merge(struct region_map *r, int from, int to) {
+    r->parent[from] = to;
+    r->counts[to] += r->counts[from];
+    r->counts[from] = 0;
+}
+
 /**
  * Determine if we need to worry about coloring a point, or can ignore it.
  * \param c is the current chunk
@@ -982,26 +1144,23 @@ static int ignore_point(struct chunk *c, int colors[], struct loc grid) {
 /**
  * Color a particular point, and all adjacent points.
  * \param c is the current chunk
- * \param colors is the array of current point colors
- * \param counts is the array of current color counts
+ * \param r is the region map
  * \param grid is the location
  * \param color is the color we are coloring
  * \param diagonal controls whether we can progress diagonally
+ *
+ * Points are colored as they are queued, so colors[] doubles as the record
+ * of which points have been seen; the queue is left empty for the next call.
  */
-static void build_color_point(struct chunk *c, int colors[], int counts[],
+static void build_color_point(struct chunk *c, struct region_map *r,
 							  struct loc grid, int color, bool diagonal) {
-    int h = c->height;
+    struct queue *queue = r->queue;
     int w = c->width;
-    int size = h * w;
-    struct queue *queue = q_new(size);
-
-    int *added = mem_zalloc(size * sizeof(int));
+    int n = grid_to_i(grid, w);
 
-    array_filler(added, 0, size);
-
-    q_push_int(queue, grid_to_i(grid, w));
-
-    counts[color] = 0;
+    q_push_int(queue, n);
+    r->colors[n] = color;
+    r->counts[color] = 1;
 
     while (q_len(queue) > 0) {
 		int i;
@@ -1010,34 +1169,25 @@ static void build_color_point(struct chunk *c, int colors[], int counts[],
 
 		i_to_grid(n1, w, &grid1);
 
-		if (ignore_point(c, colors, grid1)) continue;
-
-		colors[n1] = color;
-		counts[color]++;
-
 		for (i = 0; i < (diagonal ? 8 : 4); i++) {
 			struct loc grid2 = loc_sum(grid1, ddgrid_ddd[i]);
 			int n2 = grid_to_i(grid2, w);
-			if (ignore_point(c, colors, grid2)) continue;
-			if (added[n2]) continue;
+			if (ignore_point(c, r->colors, grid2)) continue;
 
 			q_push_int(queue, n2);
-			added[n2] = 1;
+			r->colors[n2] = color;
+			r->counts[color]++;
 		}
     }
-
-    mem_free(added);
-    q_free(queue);
 }
 
 /**
  * Create a color for each "NESW contiguous" region of the dungeon.
  * \param c is the current chunk
- * \param colors is the array of current point colors
- * \param counts is the array of current color counts
+ * \param r is an empty region map for c
  * \param diagonal controls whether we can progress diagonally
  */
-static void build_colors(struct chunk *c, int colors[], int counts[], bool diagonal) {
+static void build_colors(struct chunk *c, struct region_map *r, bool diagonal) {
     int y, x;
     int h = c->height;
     int w = c->width;
@@ -1045,8 +1195,8 @@ static void build_colors(struct chunk *c, int colors[], int counts[], bool diago
 
     for (y = 0; y < h; y++) {
 		for (x = 0; x < w; x++) {
-			if (ignore_point(c, colors, loc(x, y))) continue;
-			build_color_point(c, colors, counts, loc(x, y), color, diagonal);
+			if (ignore_point(c, r->colors, loc(x, y))) continue;
+			build_color_point(c, r, loc(x, y), color, diagonal);
 			color++;
 		}
     }
@@ -1055,22 +1205,19 @@ static void build_colors(struct chunk *c, int colors[], int counts[], bool diago
 /**
  * Find and delete all small (<9 square) open regions.
  * \param c is the current chunk
- * \param colors is the array of current point colors
- * \param counts is the array of current color counts
+ * \param r is the region map, before any regions have been joined
  */
-static void clear_small_regions(struct chunk *c, int colors[], int counts[]) {
+static void clear_small_regions(struct chunk *c, struct region_map *r) {
     int i, y, x;
-    int h = c->height;
     int w = c->width;
-    int size = h * w;
 
-    int *deleted = mem_zalloc(size * sizeof(int));
-    array_filler(deleted, 0, size);
+    int *deleted = mem_zalloc((r->size + 1) * sizeof(int));
+    array_filler(deleted, 0, r->size + 1);
 
-    for (i = 0; i < size; i++) {
-		if (counts[i] < 9) {
+    for (i = 0; i <= r->size; i++) {
+		if (r->counts[i] < 9) {
 			deleted[i] = 1;
-			counts[i] = 0;
+			r->counts[i] = 0;
 		}
     }
 
@@ -1079,9 +1226,9 @@ static void clear_small_regions(struct chunk *c, int colors[], int counts[]) {
 			struct loc grid = loc(x, y);
 			i = grid_to_i(grid, w);
 
-			if (!deleted[colors[i]]) continue;
+			if (!deleted[r->colors[i]]) continue;
 
-			colors[i] = 0;
+			r->colors[i] = 0;
 			set_marked_granite(c, grid, SQUARE_WALL_SOLID);
 		}
     }
@@ -1090,52 +1237,34 @@ static void clear_small_regions(struct chunk *c, int colors[], int counts[]) {
 
 /**
  * Return the number of colors which have active cells.
- * \param counts is the array of current color counts
- * \param size is the total area
+ * \param r is the region map
  */
-static int count_colors(int counts[], int size) {
+static int count_colors(struct region_map *r) {
     int i;
     int num = 0;
-    for (i = 0; i < size; i++) if (counts[i] > 0) num++;
+    for (i = 0; i <= r->size; i++) if (r->counts[i] > 0) num++;
     return num;
 }
 
 /**
  * Return the first color which has one or more active cells.
- * \param counts is the array of current color counts
- * \param size is the total area
+ * \param r is the region map
  */
-static int first_color(int counts[], int size) {
+static int first_color(struct region_map *r) {
     int i;
-    for (i = 0; i < size; i++) if (counts[i] > 0) return i;
+    for (i = 0; i <= r->size; i++) if (r->counts[i] > 0) return i;
     return -1;
 }
 
-/**
- * Find all cells of 'fromcolor' and repaint them to 'tocolor'.
- * \param colors is the array of current point colors
- * \param counts is the array of current color counts
- * \param from is the color to change
- * \param to is the color to change to
- * \param size is the total area
- */
-static void fix_colors(int colors[], int counts[], int from, int to, int size) {
-    int i;
-    for (i = 0; i < size; i++) if (colors[i] == from) colors[i] = to;
-    counts[to] += counts[from];
-    counts[from] = 0;
-}
-
 /**
  * Create a tunnel connecting a region to one of its nearest neighbors.
  * Set new_color = -1 for any neighbour, the required color for a specific one
  * \param c is the current chunk
- * \param colors is the array of current point colors
- * \param counts is the array of current color counts
+ * \param r is the region map
  * \param color is the color of the region we want to connect
  * \param new_color is the color of the region we want to connect to (if used)
  */
-static void join_region(struct chunk *c, int colors[], int counts[], int color,
+static void join_region(struct chunk *c, struct region_map *r, int color,
 	int new_color)
 {
     int i;
@@ -1143,8 +1272,8 @@ static void join_region(struct chunk *c, int colors[], int counts[], int color,
     int w = c->width;
     int size = h * w;
 
-    /* Allocate a processing queue */
-    struct queue *queue = q_new(size);
+    /* Use the region map's processing queue */
+    struct queue *queue = r->queue;
 
     /* Allocate an array to keep track of handled squares, and which square
      * we reached them from.
@@ -1152,9 +1281,13 @@ static void join_region(struct chunk *c, int colors[], int counts[], int color,
     int *previous = mem_zalloc(size * sizeof(int));
     array_filler(previous, -1, size);
 
+    /* Work with the current colors of the regions */
+    color = region_find(r, color);
+    if (new_color != -1) new_color = region_find(r, new_color);
+
     /* Push all squares of the given color onto the queue */
     for (i = 0; i < size; i++) {
-		if (colors[i] == color) {
+		if (region_find(r, r->colors[i]) == color) {
 			q_push_int(queue, i);
 			previous[i] = i;
 		}
@@ -1164,7 +1297,8 @@ static void join_region(struct chunk *c, int colors[], int counts[], int color,
     while (q_len(queue) > 0) {
 		/* Get the current square and its color */
 		int n1 = q_pop_int(queue);
-		int color2 = colors[n1];
+		int color2 = region_find(r, r->colors[n1]);
+		int x1, y1;
 
 		/* If we're not looking for a specific color, any new one will do */
 		if ((new_color == -1) && color2 && (color2 != color))
@@ -1173,47 +1307,48 @@ static void join_region(struct chunk *c, int colors[], int counts[], int color,
 		/* See if we've reached a square with a new color */
 		if (color2 == new_color) {
 			/* Step backward through the path, turning stone to tunnel */
-			while (colors[n1] != color) {
+			while (region_find(r, r->colors[n1]) != color) {
 				struct loc grid;
 				i_to_grid(n1, w, &grid);
-				colors[n1] = color;
+				r->colors[n1] = color;
 				if (!square_isperm(c, grid) && !square_isvault(c, grid)) {
 					square_set_feat(c, grid, FEAT_FLOOR);
 				}
 				n1 = previous[n1];
 			}
 
-			/* Update the color mapping to combine the two colors */
-			fix_colors(colors, counts, color2, color, size);
+			/* Combine the two colors */
+			region_merge(r, color2, color);
 
 			/* We're done now */
 			break;
 		}
 
 		/* If we haven't reached a new color, add all the unprocessed adjacent
-		 * squares to our queue.
+		 * squares to our queue.  This runs for most of the map on every
+		 * join, so work on the grid index directly.
 		 */
+		x1 = n1 % w;
+		y1 = n1 / w;
 		for (i = 0; i < 4; i++) {
-			int n2;
-			struct loc grid;
-			i_to_grid(n1, w, &grid);
-
 			/* Move to the adjacent square */
-			grid = loc_sum(grid, ddgrid_ddd[i]);
+			int x2 = x1 + ddgrid_ddd[i].x;
+			int y2 = y1 + ddgrid_ddd[i].y;
+			int n2;
 
 			/* Make sure we stay inside the boundaries */
-			if (!square_in_bounds(c, grid)) continue;
+			if (x2 < 0 || x2 >= w || y2 < 0 || y2 >= h) continue;
 
 			/* If the cell hasn't already been procssed, add it to the queue */
-			n2 = grid_to_i(grid, w);
+			n2 = y2 * w + x2;
 			if (previous[n2] >= 0) continue;
 			q_push_int(queue, n2);
 			previous[n2] = n1;
 		}
     }
 
-    /* Free the memory we've allocated */
-    q_free(queue);
+    /* Free the memory we've allocated, leaving the queue empty for reuse */
+    q_reset(queue);
     mem_free(previous);
 }
 
@@ -1221,21 +1356,20 @@ static void join_region(struct chunk *c, int colors[], int counts[], int color,
 /**
  * Start connecting regions, stopping when the cave is entirely connected.
  * \param c is the current chunk
- * \param colors is the array of current point colors
- * \param counts is the array of current color counts
+ * \param r is the region map
  */
-static void join_regions(struct chunk *c, int colors[], int counts[]) {
-    int h = c->height;
-    int w = c->width;
-    int size = h * w;
-    int num = count_colors(counts, size);
+static void join_regions(struct chunk *c, struct region_map *r) {
+    int num = count_colors(r);
+
+    /* The first region absorbs each region it is joined to, so it stays
+     * the first color with any cells and only needs finding once */
+    int color = first_color(r);
 
     /* While we have multiple colors (i.e. disconnected regions), join one of
      * the regions to another one.
      */
     while (num > 1) {
-		int color = first_color(counts, size);
-		join_region(c, colors, counts, color, -1);
+		join_region(c, r, color, -1);
 		num--;
     }
 }
@@ -1249,15 +1383,12 @@ static void join_regions(struct chunk *c, int colors[], int counts[]) {
  * information to join them into one conected region.
  */
 void ensure_connectedness(struct chunk *c) {
-    int size = c->height * c->width;
-    int *colors = mem_zalloc(size * sizeof(int));
-    int *counts = mem_zalloc(size * sizeof(int));
+    struct region_map *r = region_map_new(c);
 
-    build_colors(c, colors, counts, true);
-    join_regions(c, colors, counts);
+    build_colors(c, r, true);
+    join_regions(c, r);
 
-    mem_free(colors);
-    mem_free(counts);
+    region_map_free(r);
 }
 
 
@@ -1271,14 +1402,12 @@ void ensure_connectedness(struct chunk *c) {
  */
 struct chunk *cavern_chunk(int depth, int h, int w)
 {
-    int i;
     int size = h * w;
     int limit = size / 13;
     int density = rand_range(25, 40);
     int times = rand_range(3, 6);
 
-    int *colors = mem_zalloc(size * sizeof(int));
-    int *counts = mem_zalloc(size * sizeof(int));
+    struct region_map *r;
 
     int tries;
 
@@ -1292,7 +1421,7 @@ struct chunk *cavern_chunk(int depth, int h, int w)
 	for (tries = 0; tries < MAX_CAVERN_TRIES; tries++) {
 		/* Build a random cavern and mutate it a number of times */
 		init_cavern(c, density);
-		for (i = 0; i < times; i++) mutate_cavern(c);
+		mutate_cavern(c, times);
 
 		/* If there are enough open squares then we're done */
 		if (c->feat_count[FEAT_FLOOR] >= limit) {
@@ -1305,18 +1434,15 @@ struct chunk *cavern_chunk(int depth, int h, int w)
 
 	/* If we couldn't make a big enough cavern then fail */
 	if (tries == MAX_CAVERN_TRIES) {
-		mem_free(colors);
-		mem_free(counts);
 		cave_free(c);
 		return NULL;
 	}
 
-	build_colors(c, colors, counts, false);
-	clear_small_regions(c, colors, counts);
-	join_regions(c, colors, counts);
-
-    mem_free(colors);
-    mem_free(counts);
+	r = region_map_new(c);
+	build_colors(c, r, false);
+	clear_small_regions(c, r);
+	join_regions(c, r);
+	region_map_free(r);
 
 	return c;
 }
@@ -1549,6 +1675,7 @@ struct chunk *town_gen(struct player *p, int min_height, int min_width)
 		town_gen_layout(c_new, p);
 	} else {
 		/* Copy from the chunk list, remove the old one */
+		cave_unpack(c_old);
 		if (!chunk_copy(c_new, c_old, 0, 0, 0, 0))
 			quit_fmt("chunk_copy() level bounds failed!");
 		chunk_list_remove("Town");
@@ -1620,9 +1747,7 @@ struct chunk *modified_chunk(int depth, int height, int width)
     dun->col_blocks = c->width / dun->block_wid;
 
     /* Initialize the room table */
-	dun->room_map = mem_zalloc(dun->row_blocks * sizeof(bool*));
-	for (i = 0; i < dun->row_blocks; i++)
-		dun->room_map[i] = mem_zalloc(dun->col_blocks * sizeof(bool));
+	room_map_new();
 
     /* No rooms yet, pits or otherwise. */
     dun->pit_num = 0;
@@ -1675,9 +1800,7 @@ struct chunk *modified_chunk(int depth, int height, int width)
 		}
     }
 
-	for (i = 0; i < dun->row_blocks; i++)
-		mem_free(dun->room_map[i]);
-	mem_free(dun->room_map);
+	room_map_free();
 
     /* Hack -- Scramble the room order */
     for (i = 0; i < dun->cent_n; i++) {
@@ -1869,9 +1992,7 @@ struct chunk *moria_chunk(int depth, int height, int width)
     dun->col_blocks = c->width / dun->block_wid;
 
     /* Initialize the room table */
-	dun->room_map = mem_zalloc(dun->row_blocks * sizeof(bool*));
-	for (i = 0; i < dun->row_blocks; i++)
-		dun->room_map[i] = mem_zalloc(dun->col_blocks * sizeof(bool));
+	room_map_new();
 
     /* No rooms yet, pits or otherwise. */
     dun->pit_num = 0;
@@ -1906,9 +2027,7 @@ struct chunk *moria_chunk(int depth, int height, int width)
 		}
     }
 
-	for (i = 0; i < dun->row_blocks; i++)
-		mem_free(dun->room_map[i]);
-	mem_free(dun->room_map);
+	room_map_free();
 
     /* Hack -- Scramble the room order */
     for (i = 0; i < dun->cent_n; i++) {
@@ -2087,32 +2206,24 @@ struct chunk *vault_chunk(struct player *p)
 void connect_caverns(struct chunk *c, struct loc floor[])
 {
 	int i;
-    int size = c->height * c->width;
-    int *colors = mem_zalloc(size * sizeof(int));
-    int *counts = mem_zalloc(size * sizeof(int));
+    struct region_map *r = region_map_new(c);
 	int color_of_floor[4];
 
 	/* Color the regions, find which cavern is which color */
-    build_colors(c, colors, counts, true);
+    build_colors(c, r, true);
 	for (i = 0; i < 4; i++) {
 		int spot = grid_to_i(floor[i], c->width);
-		color_of_floor[i] = colors[spot];
+		color_of_floor[i] = r->colors[spot];
 	}
 
 	/* Join left and upper, right and lower */
-	join_region(c, colors, counts, color_of_floor[0], color_of_floor[1]);
-	join_region(c, colors, counts, color_of_floor[2], color_of_floor[3]);
+	join_region(c, r, color_of_floor[0], color_of_floor[1]);
+	join_region(c, r, color_of_floor[2], color_of_floor[3]);
 
-	/* Redo the colors, join the two big caverns */
-    build_colors(c, colors, counts, true);
-	for (i = 1; i < 3; i++) {
-		int spot = grid_to_i(floor[i], c->width);
-		color_of_floor[i] = colors[spot];
-	}
-	join_region(c, colors, counts, color_of_floor[1], color_of_floor[2]);
+	/* Join the two big caverns; join_region() looks up their new colors */
+	join_region(c, r, color_of_floor[1], color_of_floor[2]);
 
-    mem_free(colors);
-    mem_free(counts);
+    region_map_free(r);
 }
 /**
  * Generate a hard centre level - a greater vault surrounded by caverns
@@ -2610,8 +2721,8 @@ struct chunk *arena_gen(struct player *p, int min_height, int min_width) {
 	player_place(c, p, loc(1, c->height - 2));
 
 	/* Place the monster */
-	memcpy(&c->monsters[mon->midx], mon, sizeof(*mon));
-	mon = &c->monsters[mon->midx];
+	memcpy(cave_monster(c, mon->midx), mon, sizeof(*mon));
+	mon = cave_monster(c, mon->midx);
 	mon->grid = loc(c->width - 2, 1);
 	square_set_mon(c, mon->grid, mon->midx);
 	c->mon_max = mon->midx + 1;
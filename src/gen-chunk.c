@@ -28,11 +28,19 @@
 #include "game-world.h"
 #include "generate.h"
 #include "init.h"
+#include "savefile.h"
 #include "mon-make.h"
+#include "obj-pile.h"
 #include "obj-util.h"
 #include "trap.h"
 
 #define CHUNK_LIST_INCR 10
+
+/**
+ * How many chunks on the list may be kept read in; see chunk_list_trim()
+ */
+#define CHUNK_LIST_READ_MAX 16
+
 struct chunk **chunk_list;     /**< list of pointers to saved chunks */
 u16b chunk_list_max = 0;      /**< current max actual chunk index */
 
@@ -44,25 +52,113 @@ u16b chunk_list_max = 0;      /**< current max actual chunk index */
  */
 struct chunk *chunk_write(struct chunk *c)
 {
-	int x, y;
+	int size = c->height * c->width;
 
 	struct chunk *new = cave_new(c->height, c->width);
 
 	/* Write the location stuff */
-	for (y = 0; y < new->height; y++) {
-		for (x = 0; x < new->width; x++) {
-			/* Terrain */
-			new->squares[y][x].feat = square(c, loc(x, y)).feat;
-			sqinfo_copy(square(new, loc(x, y)).info, square(c, loc(x, y)).info);
-		}
-	}
+	memcpy(new->feat, c->feat, size * sizeof(byte));
+	memcpy(new->info, c->info, size * SQUARE_SIZE * sizeof(bitflag));
 
 	return new;
 }
 
+/**
+ * Find the position of a chunk on the list by name, or -1
+ */
+static int chunk_list_find(const char *name)
+{
+	u32b hash = djb2_hash(name);
+	int i;
+
+	for (i = 0; i < chunk_list_max; i++) {
+		if (chunk_list[i]->name_hash == hash &&
+			streq(name, chunk_list[i]->name))
+			return i;
+	}
+
+	return -1;
+}
+
+/**
+ * Replace a read chunk on the list by what was saved for it, just as it
+ * would be after loading a savefile
+ */
+static void chunk_list_unread(int i)
+{
+	struct chunk *c = chunk_list[i];
+	struct chunk *stub = mem_zalloc(sizeof(*stub));
+	int j;
+
+	stub->name = string_make(c->name);
+	stub->name_hash = c->name_hash;
+	stub->depth = c->depth;
+	stub->turn = c->turn;
+	stub->saved = c->saved;
+	stub->saved_size = c->saved_size;
+	stub->unread = true;
+	c->saved = NULL;
+
+	/* Monsters stay counted, as rd_chunks() counts those of unread chunks,
+	 * but what they carry isn't freed with the chunk */
+	for (j = 1; j < c->mon_max; j++) {
+		struct monster *mon = cave_monster(c, j);
+		if (mon->race && mon->held_obj)
+			object_pile_free(mon->held_obj);
+	}
+	cave_free(c);
+	chunk_list[i] = stub;
+}
+
+/**
+ * Keep at most CHUNK_LIST_READ_MAX chunks read in, dropping the levels
+ * stored longest ago back to what was last saved for them.  A level and its
+ * known version go together, and only if neither has changed since the
+ * last save, as rd_stored_chunk() will bring them back.
+ */
+static void chunk_list_trim(void)
+{
+	int i, num_read = 0;
+
+	for (i = 0; i < chunk_list_max; i++)
+		if (!chunk_list[i]->unread) num_read++;
+
+	while (num_read > CHUNK_LIST_READ_MAX) {
+		int oldest = -1, oldest_known = -1;
+
+		for (i = 0; i < chunk_list_max; i++) {
+			struct chunk *c = chunk_list[i];
+			int known;
+
+			if (c->unread || !c->saved || suffix(c->name, " known"))
+				continue;
+			if (oldest >= 0 && c->turn >= chunk_list[oldest]->turn)
+				continue;
+
+			/* The known version must be ready to go too */
+			known = chunk_list_find(format("%s known", c->name));
+			if (known >= 0 && !chunk_list[known]->unread &&
+				!chunk_list[known]->saved)
+				continue;
+			oldest = i;
+			oldest_known = known;
+		}
+		if (oldest < 0) break;
+
+		chunk_list_unread(oldest);
+		num_read--;
+		if (oldest_known >= 0 && !chunk_list[oldest_known]->unread) {
+			chunk_list_unread(oldest_known);
+			num_read--;
+		}
+	}
+}
+
 /**
  * Add an entry to the chunk list - any problems with the length of this will
- * be more in the memory used by the chunks themselves rather than the list
+ * be more in the memory used by the chunks themselves rather than the list,
+ * so the chunk is packed until it is next used, and the oldest chunks are
+ * only kept as they were last saved
  * \param c the chunk being added to the list
  */
 void chunk_list_add(struct chunk *c)
@@ -76,35 +172,38 @@ void chunk_list_add(struct chunk *c)
 		chunk_list = (struct chunk **) mem_realloc(chunk_list, newsize);
 
 	/* Add the new one */
+	cave_pack(c);
+	c->name_hash = djb2_hash(c->name);
 	chunk_list[chunk_list_max++] = c;
+	chunk_list_trim();
 }
 
 /**
- * Remove an entry from the chunk list, return whether it was found
+ * Remove an entry from the chunk list, return whether it was found; the
+ * chunk may be changed once it is off the list, so what was saved for it
+ * is dropped
  * \param name the name of the chunk being removed from the list
  * \return whether it was found; success means it was successfully removed
  */
 bool chunk_list_remove(char *name)
 {
-	int i;
+	int i = chunk_list_find(name), j;
 
-	/* Find the match */
-	for (i = 0; i < chunk_list_max; i++) {
-		if (!strcmp(name, chunk_list[i]->name)) {
-			/* Copy all the succeeding chunks back one */
-			int j;
-			for (j = i + 1; j < chunk_list_max; j++) {
-				chunk_list[j - 1] = chunk_list[j];
-			}
+	if (i < 0) return false;
 
-			/* Shorten the list and return */
-			chunk_list_max--;
-			chunk_list[chunk_list_max] = NULL;
-			return true;
-		}
+	mem_free(chunk_list[i]->saved);
+	chunk_list[i]->saved = NULL;
+	chunk_list[i]->saved_size = 0;
+
+	/* Copy all the succeeding chunks back one */
+	for (j = i + 1; j < chunk_list_max; j++) {
+		chunk_list[j - 1] = chunk_list[j];
 	}
 
-	return false;
+	/* Shorten the list and return */
+	chunk_list_max--;
+	chunk_list[chunk_list_max] = NULL;
+	return true;
 }
 
 /**
@@ -114,13 +213,16 @@ bool chunk_list_remove(char *name)
  */
 struct chunk *chunk_find_name(char *name)
 {
-	int i;
+	int i = chunk_list_find(name);
 
-	for (i = 0; i < chunk_list_max; i++)
-		if (!strcmp(name, chunk_list[i]->name))
-			return chunk_list[i];
+	if (i < 0) return NULL;
 
-	return NULL;
+	/* Chunks from the savefile are read when first wanted */
+	if (chunk_list[i]->unread) {
+		chunk_list[i] = rd_stored_chunk(chunk_list[i]);
+		chunk_list[i]->name_hash = djb2_hash(chunk_list[i]->name);
+	}
+	return chunk_list[i];
 }
 
 /**
@@ -214,28 +316,33 @@ bool chunk_copy(struct chunk *dest, struct chunk *source, int y0, int x0,
 	}
 
 	/* Write the location stuff */
+	dest->feat_digest_known = false;
 	for (y = 0; y < h; y++) {
 		for (x = 0; x < w; x++) {
 			/* Work out where we're going */
 			int dest_y = y;
 			int dest_x = x;
+			int src_i = grid_to_i(loc(x, y), source->width), dest_i;
 			symmetry_transform(&dest_y, &dest_x, y0, x0, h, w, rotate, reflect);
+			dest_i = grid_to_i(loc(dest_x, dest_y), dest->width);
 
 			/* Terrain */
-			dest->squares[dest_y][dest_x].feat = square(source, loc(x, y)).feat;
+			dest->feat[dest_i] = source->feat[src_i];
+			square_update_planes(dest, loc(dest_x, dest_y));
 			sqinfo_copy(square(dest, loc(dest_x, dest_y)).info,
 						square(source, loc(x, y)).info);
 
 			/* Dungeon objects */
 			if (square_object(source, loc(x, y))) {
 				struct object *obj;
-				dest->squares[dest_y][dest_x].obj = square_object(source, loc(x, y));
+				square_set_obj(dest, loc(dest_x, dest_y),
+							   square_object(source, loc(x, y)));
 
 				for (obj = square_object(source, loc(x, y)); obj; obj = obj->next) {
 					/* Adjust position */
 					obj->grid = loc(dest_x, dest_y);
 				}
-				source->squares[y][x].obj = NULL;
+				square_set_obj(source, loc(x, y), NULL);
 			}
 
 			/* Monsters */
@@ -257,8 +364,9 @@ bool chunk_copy(struct chunk *dest, struct chunk *source, int y0, int x0,
 
 				/* Copy over */
 				dest_mon = cave_monster(dest, idx);
-				dest->squares[dest_y][dest_x].mon = idx;
+				square_set_mon(dest, loc(dest_x, dest_y), idx);
 				memcpy(dest_mon, source_mon, sizeof(*source_mon));
+				cave_monster_hearing_add(dest, dest_mon);
 
 				/* Adjust stuff */
 				dest_mon->midx = idx;
@@ -272,7 +380,7 @@ bool chunk_copy(struct chunk *dest, struct chunk *source, int y0, int x0,
 			/* Traps */
 			if (square(source, loc(x, y)).trap) {
 				struct trap *trap = square(source, loc(x, y)).trap;
-				dest->squares[dest_y][dest_x].trap = trap;
+				square_set_trap(dest, loc(dest_x, dest_y), trap);
 
 				/* Traverse the trap list */
 				while (trap) {
@@ -280,12 +388,12 @@ bool chunk_copy(struct chunk *dest, struct chunk *source, int y0, int x0,
 					trap->grid = loc(dest_x, dest_y);
 					trap = trap->next;
 				}
-				source->squares[y][x].trap = NULL;
+				square_set_trap(source, loc(x, y), NULL);
 			}
 
 			/* Player */
 			if (square(source, loc(x, y)).mon == -1) 
-				dest->squares[dest_y][dest_x].mon = -1;
+				square_set_mon(dest, loc(dest_x, dest_y), -1);
 		}
 	}
 
@@ -299,6 +407,7 @@ bool chunk_copy(struct chunk *dest, struct chunk *source, int y0, int x0,
 			dest->objects[dest->obj_max + i]->oidx = dest->obj_max + i;
 	}
 	dest->obj_max += source->obj_max + 1;
+	dest->obj_free.complete = false;
 
 	/* Copy monster group list */
 	for (i = 0; i < z_info->level_monster_max; i++) {
@@ -307,6 +416,7 @@ bool chunk_copy(struct chunk *dest, struct chunk *source, int y0, int x0,
 	for (i = 0; i < z_info->level_monster_max - max_group_id; i++) {
 		dest->monster_groups[i + max_group_id] = source->monster_groups[i];
 	}
+	dest->group_free.complete = false;
 
 	/* Miscellany */
 	for (i = 0; i < z_info->f_max + 1; i++)
@@ -264,19 +264,14 @@ void spread_monsters(struct chunk *c, const char *type, int depth, int num,
  * get expensive), we handle monsters of a specified race separately.
  *
  * \param c the current chunk being generated
- * \param racial_symbol the allowable monster_base symbols
- * \param vault_type the type of vault, which affects monster selection depth
- * \param data the vault text description, which contains the racial symbol
- * \param y1 the limits of the vault
- * \param y2 the limits of the vault
- * \param x1 the limits of the vault
- * \param x2 the limits of the vault
+ * \param v the vault, whose type affects monster selection depth
+ * \param y1 the top of the vault
+ * \param x1 the left side of the vault
  */
-void get_vault_monsters(struct chunk *c, char racial_symbol[], char *vault_type,
-						const char *data, int y1, int y2, int x1, int x2)
+void get_vault_monsters(struct chunk *c, const struct vault *v, int y1, int x1)
 {
-    int i, y, x, depth;
-    const char *t;
+    const char *racial_symbol = v->races, *vault_type = v->typ;
+    int i, j, depth;
 
     for (i = 0; racial_symbol[i] != '\0'; i++) {
 		/* Require correct race, allow uniques. */
@@ -303,13 +298,13 @@ void get_vault_monsters(struct chunk *c, char racial_symbol[], char *vault_type,
 
 
 		/* Place the monsters */
-		for (t = data, y = y1; y <= y2; y++) {
-			for (x = x1; x <= x2; x++, t++) {
-				if (*t == racial_symbol[i]) {
-					/* Place a monster */
-					pick_and_place_monster(c, loc(x, y), depth, false,
-										   false, ORIGIN_DROP_SPECIAL);
-				}
+		for (j = 0; j < v->num_grids; j++) {
+			const struct template_grid *t = &v->grids[j];
+
+			if (t->symbol == racial_symbol[i]) {
+				/* Place a monster */
+				pick_and_place_monster(c, loc(x1 + t->x, y1 + t->y), depth,
+									   false, false, ORIGIN_DROP_SPECIAL);
 			}
 		}
     }
@@ -33,6 +33,7 @@
 #include "datafile.h"
 #include "math.h"
 #include "game-event.h"
+#include "game-profile.h"
 #include "generate.h"
 #include "init.h"
 #include "mon-group.h"
@@ -838,6 +839,66 @@ void set_pit_type(int depth, int type)
 	dun->pit_type = &pit_info[pit_idx];
 }
 
+/**
+ * Set up an empty room table for the current block sizes
+ */
+void room_map_new(void)
+{
+	int i;
+
+	dun->room_map = mem_zalloc(dun->row_blocks * sizeof(bool*));
+	for (i = 0; i < dun->row_blocks; i++)
+		dun->room_map[i] = mem_zalloc(dun->col_blocks * sizeof(bool));
+	dun->room_sum = mem_zalloc((dun->row_blocks + 1) * (dun->col_blocks + 1) *
+							   sizeof(int));
+}
+
+void room_map_free(void)
+{
+	int i;
+
+	for (i = 0; i < dun->row_blocks; i++)
+		mem_free(dun->room_map[i]);
+	mem_free(dun->room_map);
+	mem_free(dun->room_sum);
+	dun->room_map = NULL;
+	dun->room_sum = NULL;
+}
+
+/**
+ * Check that no block from (by1, bx1) to (by2, bx2) inclusive is used; the
+ * caller makes sure they are all on the level
+ */
+static bool room_blocks_free(int by1, int bx1, int by2, int bx2)
+{
+	int w = dun->col_blocks + 1;
+	int *sum = dun->room_sum;
+
+	return sum[(by2 + 1) * w + bx2 + 1] - sum[by1 * w + bx2 + 1] -
+		sum[(by2 + 1) * w + bx1] + sum[by1 * w + bx1] == 0;
+}
+
+/**
+ * Mark the blocks from (by1, bx1) to (by2, bx2) inclusive as used
+ */
+static void room_blocks_reserve(int by1, int bx1, int by2, int bx2)
+{
+	int w = dun->col_blocks + 1;
+	int *sum = dun->room_sum;
+	int by, bx;
+
+	for (by = by1; by <= by2; by++)
+		for (bx = bx1; bx <= bx2; bx++)
+			dun->room_map[by][bx] = true;
+
+	/* Only sums below and to the right of the first block change */
+	for (by = by1; by < dun->row_blocks; by++)
+		for (bx = bx1; bx < dun->col_blocks; bx++)
+			sum[(by + 1) * w + bx + 1] = dun->room_map[by][bx] +
+				sum[by * w + bx + 1] + sum[(by + 1) * w + bx] -
+				sum[by * w + bx];
+}
+
 /**
  * Find a good spot for the next room.
  *
@@ -862,8 +923,6 @@ static bool find_space(struct loc *centre, int height, int width)
 	int i;
 	int by, bx, by1, bx1, by2, bx2;
 
-	bool filled;
-
 	/* Find out how many blocks we need. */
 	int blocks_high = 1 + ((height - 1) / dun->block_hgt);
 	int blocks_wide = 1 + ((width - 1) / dun->block_wid);
@@ -898,8 +957,8 @@ static bool find_space(struct loc *centre, int height, int width)
 				dun->cent_n++;
 			}
 
-			/* Reserve a block, marked with the room index */
-			dun->room_map[by][bx] = dun->cent_n;
+			/* Reserve a block */
+			room_blocks_reserve(by, bx, by, bx);
 
 			/* Success. */
 			return (true);
@@ -908,8 +967,6 @@ static bool find_space(struct loc *centre, int height, int width)
 
 	/* We'll allow twenty-five guesses. */
 	for (i = 0; i < 25; i++) {
-		filled = false;
-
 		/* Pick a top left block at random */
 		by1 = randint0(dun->row_blocks);
 		bx1 = randint0(dun->col_blocks);
@@ -922,16 +979,8 @@ static bool find_space(struct loc *centre, int height, int width)
 		if (by1 < 0 || by2 >= dun->row_blocks) continue;
 		if (bx1 < 0 || bx2 >= dun->col_blocks) continue;
 
-		/* Verify open space */
-		for (by = by1; by <= by2; by++) {
-			for (bx = bx1; bx <= bx2; bx++) {
-				if (dun->room_map[by][bx])
-					filled = true;
-			}
-		}
-
 		/* If space filled, try again. */
-		if (filled)	continue;
+		if (!room_blocks_free(by1, bx1, by2, bx2)) continue;
 
 		/* Get the location of the room */
 		centre->y = ((by1 + by2 + 1) * dun->block_hgt) / 2;
@@ -944,11 +993,7 @@ static bool find_space(struct loc *centre, int height, int width)
 		}
 
 		/* Reserve some blocks */
-		for (by = by1; by <= by2; by++) {
-			for (bx = bx1; bx <= bx2; bx++) {
-				dun->room_map[by][bx] = true;
-			}
-		}
+		room_blocks_reserve(by1, bx1, by2, bx2);
 
 		/* Success. */
 		return (true);
@@ -959,21 +1004,18 @@ static bool find_space(struct loc *centre, int height, int width)
 }
 
 /**
- * Build a room template from its string representation.
+ * Build a room template from its compiled grids.
  * \param c the chunk the room is being built in
  *\ param centre the room centre; out of chunk centre invokes find_space()
- * \param ymax the room dimensions
- * \param xmax the room dimensions
- * \param doors the door position
- * \param data the room template text description
- * \param tval the object type for any included objects
+ * \param room the room template
  * \return success
  */
-static bool build_room_template(struct chunk *c, struct loc centre, int ymax,
-								int xmax, int doors, const char *data, int tval)
+static bool build_room_template(struct chunk *c, struct loc centre,
+								const struct room_template *room)
 {
-	int dx, dy, rnddoors, doorpos;
-	const char *t;
+	int ymax = room->hgt, xmax = room->wid;
+	int doors = room->dor, tval = room->tval;
+	int i, rnddoors, doorpos;
 	bool rndwalls, light;
 	
 
@@ -996,117 +1038,114 @@ static bool build_room_template(struct chunk *c, struct loc centre, int ymax,
 	}
 
 	/* Place dungeon features and objects */
-	for (t = data, dy = 0; dy < ymax && *t; dy++) {
-		for (dx = 0; dx < xmax && *t; dx++, t++) {
-			/* Extract the location */
-			struct loc grid = loc(centre.x - (xmax / 2) + dx,
-								  centre.y - (ymax / 2) + dy);
-
-			/* Skip non-grids */
-			if (*t == ' ') continue;
-
-			/* Lay down a floor */
-			square_set_feat(c, grid, FEAT_FLOOR);
-
-			/* Debugging assertion */
-			assert(square_isempty(c, grid));
-
-			/* Analyze the grid */
-			switch (*t) {
-			case '%': set_marked_granite(c, grid, SQUARE_WALL_OUTER); break;
-			case '#': set_marked_granite(c, grid, SQUARE_WALL_SOLID); break;
-			case '+': place_closed_door(c, grid); break;
-			case '^': if (one_in_(4)) place_trap(c, grid, -1, c->depth); break;
-			case 'x': {
-
-				/* If optional walls are generated, put a wall in this square */
-				if (rndwalls)
-					set_marked_granite(c, grid, SQUARE_WALL_SOLID);
-				break;
-			}
-			case '(': {
+	for (i = 0; i < room->num_grids; i++) {
+		const struct template_grid *t = &room->grids[i];
+
+		/* Extract the location */
+		struct loc grid = loc(centre.x - (xmax / 2) + t->x,
+							  centre.y - (ymax / 2) + t->y);
+
+		/* Lay down a floor */
+		square_set_feat(c, grid, FEAT_FLOOR);
+
+		/* Debugging assertion */
+		assert(square_isempty(c, grid));
+
+		/* Analyze the grid */
+		switch (t->symbol) {
+		case '%': set_marked_granite(c, grid, SQUARE_WALL_OUTER); break;
+		case '#': set_marked_granite(c, grid, SQUARE_WALL_SOLID); break;
+		case '+': place_closed_door(c, grid); break;
+		case '^': if (one_in_(4)) place_trap(c, grid, -1, c->depth); break;
+		case 'x': {
+
+			/* If optional walls are generated, put a wall in this square */
+			if (rndwalls)
+				set_marked_granite(c, grid, SQUARE_WALL_SOLID);
+			break;
+		}
+		case '(': {
 
-				/* If optional walls are generated, put a door in this square */
-				if (rndwalls)
-					place_secret_door(c, grid);
-				break;
-			}
-			case ')': {
-				/* If no optional walls generated, put a door in this square */
-				if (!rndwalls)
-					place_secret_door(c, grid);
-				else
-					set_marked_granite(c, grid, SQUARE_WALL_SOLID);
-				break;
-			}
-			case '8': {
+			/* If optional walls are generated, put a door in this square */
+			if (rndwalls)
+				place_secret_door(c, grid);
+			break;
+		}
+		case ')': {
+			/* If no optional walls generated, put a door in this square */
+			if (!rndwalls)
+				place_secret_door(c, grid);
+			else
+				set_marked_granite(c, grid, SQUARE_WALL_SOLID);
+			break;
+		}
+		case '8': {
 
-				/* Put something nice in this square
-				 * Object (80%) or Stairs (20%) */
-				if ((randint0(100) < 80) || OPT(player, birth_levels_persist))
-					place_object(c, grid, c->depth, false, false,
-								 ORIGIN_SPECIAL, 0);
-				else
-					place_random_stairs(c, grid);
+			/* Put something nice in this square
+			 * Object (80%) or Stairs (20%) */
+			if ((randint0(100) < 80) || OPT(player, birth_levels_persist))
+				place_object(c, grid, c->depth, false, false,
+							 ORIGIN_SPECIAL, 0);
+			else
+				place_random_stairs(c, grid);
 
-				/* Some monsters to guard it */
-				vault_monsters(c, grid, c->depth + 2, randint0(2) + 3);
+			/* Some monsters to guard it */
+			vault_monsters(c, grid, c->depth + 2, randint0(2) + 3);
 
-				break;
-			}
-			case '9': {
-				/* Create some interesting stuff nearby */
-				struct loc off2 = loc(2, -2);
-				struct loc off3 = loc(3, 3);
-
-				/* A few monsters */
-				vault_monsters(c, loc_diff(grid, off3), c->depth + randint0(2),
-							   randint1(2));
-				vault_monsters(c, loc_sum(grid, off3), c->depth + randint0(2),
-							   randint1(2));
-
-				/* And maybe a bit of treasure */
-				if (one_in_(2))
-					vault_objects(c, loc_sum(grid, off2), c->depth,
-								  1 + randint0(2));
-
-				if (one_in_(2))
-					vault_objects(c, loc_diff(grid, off2), c->depth,
-								  1 + randint0(2));
+			break;
+		}
+		case '9': {
+			/* Create some interesting stuff nearby */
+			struct loc off2 = loc(2, -2);
+			struct loc off3 = loc(3, 3);
 
-				break;
+			/* A few monsters */
+			vault_monsters(c, loc_diff(grid, off3), c->depth + randint0(2),
+						   randint1(2));
+			vault_monsters(c, loc_sum(grid, off3), c->depth + randint0(2),
+						   randint1(2));
 
-			}
-			case '[': {
-				
-				/* Place an object of the template's specified tval */
-				place_object(c, grid, c->depth, false, false, ORIGIN_SPECIAL,
-							 tval);
-				break;
-			}
-			case '1':
-			case '2':
-			case '3':
-			case '4':
-			case '5':
-			case '6': {
-				/* Check if this is chosen random door position */
-				doorpos = (int) (*t - '0');
-
-				if (doorpos == rnddoors)
-					place_secret_door(c, grid);
-				else
-					set_marked_granite(c, grid, SQUARE_WALL_SOLID);
+			/* And maybe a bit of treasure */
+			if (one_in_(2))
+				vault_objects(c, loc_sum(grid, off2), c->depth,
+							  1 + randint0(2));
 
-				break;
-			}
-			}
+			if (one_in_(2))
+				vault_objects(c, loc_diff(grid, off2), c->depth,
+							  1 + randint0(2));
+
+			break;
 
-			/* Part of a room */
-			sqinfo_on(square(c, grid).info, SQUARE_ROOM);
-			if (light)
-				sqinfo_on(square(c, grid).info, SQUARE_GLOW);
 		}
+		case '[': {
+			
+			/* Place an object of the template's specified tval */
+			place_object(c, grid, c->depth, false, false, ORIGIN_SPECIAL,
+						 tval);
+			break;
+		}
+		case '1':
+		case '2':
+		case '3':
+		case '4':
+		case '5':
+		case '6': {
+			/* Check if this is chosen random door position */
+			doorpos = (int) (t->symbol - '0');
+
+			if (doorpos == rnddoors)
+				place_secret_door(c, grid);
+			else
+				set_marked_granite(c, grid, SQUARE_WALL_SOLID);
+
+			break;
+		}
+		}
+
+		/* Part of a room */
+		sqinfo_on(square(c, grid).info, SQUARE_ROOM);
+		if (light)
+			sqinfo_on(square(c, grid).info, SQUARE_GLOW);
 	}
 
 	return true;
@@ -1128,8 +1167,7 @@ static bool build_room_template_type(struct chunk *c, struct loc centre,
 		return false;
 
 	/* Build the room */
-	if (!build_room_template(c, centre, room->hgt, room->wid, room->dor,
-							 room->text, room->tval))
+	if (!build_room_template(c, centre, room))
 		return false;
 
 	ROOM_LOG("Room template (%s)", room->name);
@@ -1138,7 +1176,7 @@ static bool build_room_template_type(struct chunk *c, struct loc centre,
 }
 
 /**
- * Build a vault from its string representation.
+ * Build a vault from its compiled grids.
  * \param c the chunk the room is being built in
  *\ param centre the room centre; out of chunk centre invokes find_space()
  * \param v pointer to the vault template
@@ -1146,11 +1184,8 @@ static bool build_room_template_type(struct chunk *c, struct loc centre,
  */
 bool build_vault(struct chunk *c, struct loc centre, struct vault *v)
 {
-	const char *data = v->text;
 	int y1, x1, y2, x2;
-	int x, y, races_local = 0;
-	const char *t;
-	char racial_symbol[30] = "";
+	int i;
 	bool icky;
 
 	assert(c);
@@ -1171,236 +1206,219 @@ bool build_vault(struct chunk *c, struct loc centre, struct vault *v)
 	generate_mark(c, y1, x1, y2, x2, SQUARE_MON_RESTRICT);
 
 	/* Place dungeon features and objects */
-	for (t = data, y = y1; y <= y2 && *t; y++) {
-		for (x = x1; x <= x2 && *t; x++, t++) {
-			struct loc grid = loc(x, y);
-			/* Skip non-grids */
-			if (*t == ' ') continue;
-
-			/* Lay down a floor */
-			square_set_feat(c, grid, FEAT_FLOOR);
-
-			/* Debugging assertion */
-			assert(square_isempty(c, grid));
-
-			/* By default vault squares are marked icky */
-			icky = true;
-
-			/* Analyze the grid */
-			switch (*t) {
-			case '%': {
-				/* In this case, the square isn't really part of the
-				 * vault, but rather is part of the "door step" to the
-				 * vault. We don't mark it icky so that the tunneling
-				 * code knows its allowed to remove this wall. */
-				set_marked_granite(c, grid, SQUARE_WALL_OUTER);
-				icky = false;
-				break;
-			}
-				/* Inner granite wall */
-			case '#': set_marked_granite(c, grid, SQUARE_WALL_INNER); break;
-				/* Permanent wall */
-			case '@': square_set_feat(c, grid, FEAT_PERM); break;
-				/* Gold seam */
-			case '*': {
-				square_set_feat(c, grid, one_in_(2) ? FEAT_MAGMA_K :
-								FEAT_QUARTZ_K);
-				break;
-			}
-				/* Rubble */
-			case ':': {
-				square_set_feat(c, grid, one_in_(2) ? FEAT_PASS_RUBBLE :
-								FEAT_RUBBLE);
-				break;
-			}
-				/* Secret door */
-			case '+': place_secret_door(c, grid); break;
-				/* Trap */
-			case '^': if (one_in_(4)) place_trap(c, grid, -1, c->depth); break;
-				/* Treasure or a trap */
-			case '&': {
-				if (randint0(100) < 75) {
-					place_object(c, grid, c->depth, false, false, ORIGIN_VAULT,
-								 0);
-				} else if (one_in_(4)) {
-					place_trap(c, grid, -1, c->depth);
-				}
-				break;
-			}
-				/* Stairs */
-			case '<': {
-				if (OPT(player, birth_levels_persist)) break;
-				square_set_feat(c, grid, FEAT_LESS); break;
-			}
-			case '>': {
-				if (OPT(player, birth_levels_persist)) break;
-				/* No down stairs at bottom or on quests */
-				if (is_quest(c->depth) || c->depth >= z_info->max_depth - 1)
-					square_set_feat(c, grid, FEAT_LESS);
-				else
-					square_set_feat(c, grid, FEAT_MORE);
-				break;
-			}
-				/* Lava */
-			case '`': square_set_feat(c, grid, FEAT_LAVA); break;
-				/* Included to allow simple inclusion of FA vaults */
-			case '/': /*square_set_feat(c, grid, FEAT_WATER)*/; break;
-			case ';': /*square_set_feat(c, grid, FEAT_TREE)*/; break;
+	for (i = 0; i < v->num_grids; i++) {
+		const struct template_grid *t = &v->grids[i];
+		struct loc grid = loc(x1 + t->x, y1 + t->y);
+
+		/* Lay down a floor */
+		square_set_feat(c, grid, FEAT_FLOOR);
+
+		/* Debugging assertion */
+		assert(square_isempty(c, grid));
+
+		/* By default vault squares are marked icky */
+		icky = true;
+
+		/* Analyze the grid */
+		switch (t->symbol) {
+		case '%': {
+			/* In this case, the square isn't really part of the
+			 * vault, but rather is part of the "door step" to the
+			 * vault. We don't mark it icky so that the tunneling
+			 * code knows its allowed to remove this wall. */
+			set_marked_granite(c, grid, SQUARE_WALL_OUTER);
+			icky = false;
+			break;
+		}
+			/* Inner granite wall */
+		case '#': set_marked_granite(c, grid, SQUARE_WALL_INNER); break;
+			/* Permanent wall */
+		case '@': square_set_feat(c, grid, FEAT_PERM); break;
+			/* Gold seam */
+		case '*': {
+			square_set_feat(c, grid, one_in_(2) ? FEAT_MAGMA_K :
+							FEAT_QUARTZ_K);
+			break;
+		}
+			/* Rubble */
+		case ':': {
+			square_set_feat(c, grid, one_in_(2) ? FEAT_PASS_RUBBLE :
+							FEAT_RUBBLE);
+			break;
+		}
+			/* Secret door */
+		case '+': place_secret_door(c, grid); break;
+			/* Trap */
+		case '^': if (one_in_(4)) place_trap(c, grid, -1, c->depth); break;
+			/* Treasure or a trap */
+		case '&': {
+			if (randint0(100) < 75) {
+				place_object(c, grid, c->depth, false, false, ORIGIN_VAULT,
+							 0);
+			} else if (one_in_(4)) {
+				place_trap(c, grid, -1, c->depth);
 			}
-
-			/* Part of a vault */
-			sqinfo_on(square(c, grid).info, SQUARE_ROOM);
-			if (icky) sqinfo_on(square(c, grid).info, SQUARE_VAULT);
+			break;
+		}
+			/* Stairs */
+		case '<': {
+			if (OPT(player, birth_levels_persist)) break;
+			square_set_feat(c, grid, FEAT_LESS); break;
+		}
+		case '>': {
+			if (OPT(player, birth_levels_persist)) break;
+			/* No down stairs at bottom or on quests */
+			if (is_quest(c->depth) || c->depth >= z_info->max_depth - 1)
+				square_set_feat(c, grid, FEAT_LESS);
+			else
+				square_set_feat(c, grid, FEAT_MORE);
+			break;
+		}
+			/* Lava */
+		case '`': square_set_feat(c, grid, FEAT_LAVA); break;
+			/* Included to allow simple inclusion of FA vaults */
+		case '/': /*square_set_feat(c, grid, FEAT_WATER)*/; break;
+		case ';': /*square_set_feat(c, grid, FEAT_TREE)*/; break;
 		}
+
+		/* Part of a vault */
+		sqinfo_on(square(c, grid).info, SQUARE_ROOM);
+		if (icky) sqinfo_on(square(c, grid).info, SQUARE_VAULT);
 	}
 
 
 	/* Place regular dungeon monsters and objects */
-	for (t = data, y = y1; y <= y2 && *t; y++) {
-		for (x = x1; x <= x2 && *t; x++, t++) {
-			struct loc grid = loc(x, y);
-			/* Hack -- skip "non-grids" */
-			if (*t == ' ') continue;
-
-			/* Most alphabetic characters signify monster races. */
-			if (isalpha(*t) && (*t != 'x') && (*t != 'X')) {
-				/* If the symbol is not yet stored, ... */
-				if (!strchr(racial_symbol, *t)) {
-					/* ... store it for later processing. */
-					if (races_local < 30)
-						racial_symbol[races_local++] = *t;
-				}
+	for (i = 0; i < v->num_grids; i++) {
+		const struct template_grid *t = &v->grids[i];
+		struct loc grid = loc(x1 + t->x, y1 + t->y);
+
+		/* Letters signify monster races, which are placed below */
+		switch (t->symbol) {
+			/* An ordinary monster, object (sometimes good), or trap. */
+		case '1': {
+			if (one_in_(2)) {
+				pick_and_place_monster(c, grid, c->depth , true, true,
+									   ORIGIN_DROP_VAULT);
+			} else if (one_in_(2)) {
+				place_object(c, grid, c->depth,
+							 one_in_(8) ? true : false, false,
+							 ORIGIN_VAULT, 0);
+			} else if (one_in_(4)) {
+				place_trap(c, grid, -1, c->depth);
 			}
-
-			/* Otherwise, analyze the symbol */
-			else
-				switch (*t) {
-					/* An ordinary monster, object (sometimes good), or trap. */
-				case '1': {
-					if (one_in_(2)) {
-						pick_and_place_monster(c, grid, c->depth , true, true,
-											   ORIGIN_DROP_VAULT);
-					} else if (one_in_(2)) {
-						place_object(c, grid, c->depth,
-									 one_in_(8) ? true : false, false,
-									 ORIGIN_VAULT, 0);
-					} else if (one_in_(4)) {
-						place_trap(c, grid, -1, c->depth);
-					}
-					break;
-				}
-					/* Slightly out of depth monster. */
-				case '2': pick_and_place_monster(c, grid, c->depth + 5, true,
-												 true, ORIGIN_DROP_VAULT);
-					break;
-					/* Slightly out of depth object. */
-				case '3': place_object(c, grid, c->depth + 3, false, false, 
-									   ORIGIN_VAULT, 0); break;
-					/* Monster and/or object */
-				case '4': {
-					if (one_in_(2))
-						pick_and_place_monster(c, grid, c->depth + 3, true, 
-											   true, ORIGIN_DROP_VAULT);
-					if (one_in_(2))
-						place_object(c, grid, c->depth + 7, false, false,
-									 ORIGIN_VAULT, 0);
-					break;
-				}
-					/* Out of depth object. */
-				case '5': place_object(c, grid, c->depth + 7, false, false,
-									   ORIGIN_VAULT, 0); break;
-					/* Out of depth monster. */
-				case '6': pick_and_place_monster(c, grid, c->depth + 11, true,
-												 true, ORIGIN_DROP_VAULT);
-					break;
-					/* Very out of depth object. */
-				case '7': place_object(c, grid, c->depth + 15, false, false,
-									   ORIGIN_VAULT, 0); break;
-					/* Very out of depth monster. */
-				case '0': pick_and_place_monster(c, grid, c->depth + 20, true,
-												 true, ORIGIN_DROP_VAULT);
-					break;
-					/* Meaner monster, plus treasure */
-				case '9': {
-					pick_and_place_monster(c, grid, c->depth + 9, true, true,
-										   ORIGIN_DROP_VAULT);
-					place_object(c, grid, c->depth + 7, true, false,
-								 ORIGIN_VAULT, 0);
-					break;
-				}
-					/* Nasty monster and treasure */
-				case '8': {
-					pick_and_place_monster(c, grid, c->depth + 40, true, true,
-										   ORIGIN_DROP_VAULT);
-					place_object(c, grid, c->depth + 20, true, true,
-								 ORIGIN_VAULT, 0);
-					break;
-				}
-					/* A chest. */
-				case '~': place_object(c, grid, c->depth + 5, false, false,
-									   ORIGIN_VAULT, TV_CHEST); break;
-					/* Treasure. */
-				case '$': place_gold(c, grid, c->depth, ORIGIN_VAULT);break;
-					/* Armour. */
-				case ']': {
-					int	tval = 0, temp = one_in_(3) ? randint1(9) : randint1(8);
-					switch (temp) {
-					case 1: tval = TV_BOOTS; break;
-					case 2: tval = TV_GLOVES; break;
-					case 3: tval = TV_HELM; break;
-					case 4: tval = TV_CROWN; break;
-					case 5: tval = TV_SHIELD; break;
-					case 6: tval = TV_CLOAK; break;
-					case 7: tval = TV_SOFT_ARMOR; break;
-					case 8: tval = TV_HARD_ARMOR; break;
-					case 9: tval = TV_DRAG_ARMOR; break;
-					}
-					place_object(c, grid, c->depth + 3, true, false,
-								 ORIGIN_VAULT, tval);
-					break;
-				}
-					/* Weapon. */
-				case '|': {
-					int	tval = 0, temp = randint1(4);
-					switch (temp) {
-					case 1: tval = TV_SWORD; break;
-					case 2: tval = TV_POLEARM; break;
-					case 3: tval = TV_HAFTED; break;
-					case 4: tval = TV_BOW; break;
-					}
-					place_object(c, grid, c->depth + 3, true, false,
-								 ORIGIN_VAULT, tval);
-					break;
-				}
-					/* Ring. */
-				case '=': place_object(c, grid, c->depth + 3, one_in_(4), false,
-									   ORIGIN_VAULT, TV_RING); break;
-					/* Amulet. */
-				case '"': place_object(c, grid, c->depth + 3, one_in_(4), false,
-									   ORIGIN_VAULT, TV_AMULET); break;
-					/* Potion. */
-				case '!': place_object(c, grid, c->depth + 3, one_in_(4), false,
-									   ORIGIN_VAULT, TV_POTION); break;
-					/* Scroll. */
-				case '?': place_object(c, grid, c->depth + 3, one_in_(4), false,
-									   ORIGIN_VAULT, TV_SCROLL); break;
-					/* Staff. */
-				case '_': place_object(c, grid, c->depth + 3, one_in_(4), false,
-									   ORIGIN_VAULT, TV_STAFF); break;
-					/* Wand or rod. */
-				case '-': place_object(c, grid, c->depth + 3, one_in_(4), false,
-									   ORIGIN_VAULT,
-									   one_in_(2) ? TV_WAND : TV_ROD);
-					break;
-					/* Food or mushroom. */
-				case ',': place_object(c, grid, c->depth + 3, one_in_(4), false,
-									   ORIGIN_VAULT, TV_FOOD); break;
-				}
+			break;
+		}
+			/* Slightly out of depth monster. */
+		case '2': pick_and_place_monster(c, grid, c->depth + 5, true,
+										 true, ORIGIN_DROP_VAULT);
+			break;
+			/* Slightly out of depth object. */
+		case '3': place_object(c, grid, c->depth + 3, false, false, 
+							   ORIGIN_VAULT, 0); break;
+			/* Monster and/or object */
+		case '4': {
+			if (one_in_(2))
+				pick_and_place_monster(c, grid, c->depth + 3, true, 
+									   true, ORIGIN_DROP_VAULT);
+			if (one_in_(2))
+				place_object(c, grid, c->depth + 7, false, false,
+							 ORIGIN_VAULT, 0);
+			break;
+		}
+			/* Out of depth object. */
+		case '5': place_object(c, grid, c->depth + 7, false, false,
+							   ORIGIN_VAULT, 0); break;
+			/* Out of depth monster. */
+		case '6': pick_and_place_monster(c, grid, c->depth + 11, true,
+										 true, ORIGIN_DROP_VAULT);
+			break;
+			/* Very out of depth object. */
+		case '7': place_object(c, grid, c->depth + 15, false, false,
+							   ORIGIN_VAULT, 0); break;
+			/* Very out of depth monster. */
+		case '0': pick_and_place_monster(c, grid, c->depth + 20, true,
+										 true, ORIGIN_DROP_VAULT);
+			break;
+			/* Meaner monster, plus treasure */
+		case '9': {
+			pick_and_place_monster(c, grid, c->depth + 9, true, true,
+								   ORIGIN_DROP_VAULT);
+			place_object(c, grid, c->depth + 7, true, false,
+						 ORIGIN_VAULT, 0);
+			break;
+		}
+			/* Nasty monster and treasure */
+		case '8': {
+			pick_and_place_monster(c, grid, c->depth + 40, true, true,
+								   ORIGIN_DROP_VAULT);
+			place_object(c, grid, c->depth + 20, true, true,
+						 ORIGIN_VAULT, 0);
+			break;
+		}
+			/* A chest. */
+		case '~': place_object(c, grid, c->depth + 5, false, false,
+							   ORIGIN_VAULT, TV_CHEST); break;
+			/* Treasure. */
+		case '$': place_gold(c, grid, c->depth, ORIGIN_VAULT);break;
+			/* Armour. */
+		case ']': {
+			int	tval = 0, temp = one_in_(3) ? randint1(9) : randint1(8);
+			switch (temp) {
+			case 1: tval = TV_BOOTS; break;
+			case 2: tval = TV_GLOVES; break;
+			case 3: tval = TV_HELM; break;
+			case 4: tval = TV_CROWN; break;
+			case 5: tval = TV_SHIELD; break;
+			case 6: tval = TV_CLOAK; break;
+			case 7: tval = TV_SOFT_ARMOR; break;
+			case 8: tval = TV_HARD_ARMOR; break;
+			case 9: tval = TV_DRAG_ARMOR; break;
+			}
+			place_object(c, grid, c->depth + 3, true, false,
+						 ORIGIN_VAULT, tval);
+			break;
+		}
+			/* Weapon. */
+		case '|': {
+			int	tval = 0, temp = randint1(4);
+			switch (temp) {
+			case 1: tval = TV_SWORD; break;
+			case 2: tval = TV_POLEARM; break;
+			case 3: tval = TV_HAFTED; break;
+			case 4: tval = TV_BOW; break;
+			}
+			place_object(c, grid, c->depth + 3, true, false,
+						 ORIGIN_VAULT, tval);
+			break;
+		}
+			/* Ring. */
+		case '=': place_object(c, grid, c->depth + 3, one_in_(4), false,
+							   ORIGIN_VAULT, TV_RING); break;
+			/* Amulet. */
+		case '"': place_object(c, grid, c->depth + 3, one_in_(4), false,
+							   ORIGIN_VAULT, TV_AMULET); break;
+			/* Potion. */
+		case '!': place_object(c, grid, c->depth + 3, one_in_(4), false,
+							   ORIGIN_VAULT, TV_POTION); break;
+			/* Scroll. */
+		case '?': place_object(c, grid, c->depth + 3, one_in_(4), false,
+							   ORIGIN_VAULT, TV_SCROLL); break;
+			/* Staff. */
+		case '_': place_object(c, grid, c->depth + 3, one_in_(4), false,
+							   ORIGIN_VAULT, TV_STAFF); break;
+			/* Wand or rod. */
+		case '-': place_object(c, grid, c->depth + 3, one_in_(4), false,
+							   ORIGIN_VAULT,
+							   one_in_(2) ? TV_WAND : TV_ROD);
+			break;
+			/* Food or mushroom. */
+		case ',': place_object(c, grid, c->depth + 3, one_in_(4), false,
+							   ORIGIN_VAULT, TV_FOOD); break;
 		}
 	}
 
 	/* Place specified monsters */
-	get_vault_monsters(c, racial_symbol, v->typ, data, y1, y2, x1, x2);
+	get_vault_monsters(c, v, y1, x1);
 
 	return true;
 }
@@ -3121,7 +3139,8 @@ bool room_build(struct chunk *c, int by0, int bx0, struct room_profile profile,
 	int bx2 = bx0 + profile.width / dun->block_wid;
 
 	struct loc centre;
-	int by, bx;
+	u64b start_time;
+	bool built;
 
 	/* Enforce the room profile's minimum depth */
 	if (c->depth < profile.level) return false;
@@ -3136,27 +3155,27 @@ bool room_build(struct chunk *c, int by0, int bx0, struct room_profile profile,
 	/* Does the profile allocate space, or the room find it? */
 	if (finds_own_space) {
 		/* Try to build a room, pass silly place so room finds its own */
-		if (!profile.builder(c, loc(c->width, c->height), profile.rating))
-			return false;
+		start_time = profile_begin();
+		built = profile.builder(c, loc(c->width, c->height), profile.rating);
+		profile_end(PROFILE_GEN_ROOMS, start_time);
+		if (!built) return false;
 	} else {
 		/* Never run off the screen */
 		if (by1 < 0 || by2 >= dun->row_blocks) return false;
 		if (bx1 < 0 || bx2 >= dun->col_blocks) return false;
 
-		/* Verify open space */
-		for (by = by1; by <= by2; by++) {
-			for (bx = bx1; bx <= bx2; bx++) {
-				/* previous rooms prevent new ones */
-				if (dun->room_map[by][bx]) return false;
-			}
-		}
+		/* Verify open space; previous rooms prevent new ones */
+		if (!room_blocks_free(by1, bx1, by2, bx2)) return false;
 
 		/* Get the location of the room */
 		centre = loc(((bx1 + bx2 + 1) * dun->block_wid) / 2,
 					 ((by1 + by2 + 1) * dun->block_hgt) / 2);
 
 		/* Try to build a room */
-		if (!profile.builder(c, centre, profile.rating)) return false;
+		start_time = profile_begin();
+		built = profile.builder(c, centre, profile.rating);
+		profile_end(PROFILE_GEN_ROOMS, start_time);
+		if (!built) return false;
 
 		/* Save the room location */
 		if (dun->cent_n < z_info->level_room_max) {
@@ -3165,11 +3184,8 @@ bool room_build(struct chunk *c, int by0, int bx0, struct room_profile profile,
 		}
 
 		/* Reserve some blocks */
-		for (by = by1; by < by2; by++) {
-			for (bx = bx1; bx < bx2; bx++) {
-				dun->room_map[by][bx] = true;
-			}
-		}
+		if (by2 > by1 && bx2 > bx1)
+			room_blocks_reserve(by1, bx1, by2 - 1, bx2 - 1);
 	}
 
 	/* Count pit/nests rooms */
@@ -25,6 +25,7 @@
 #include "datafile.h"
 #include "math.h"
 #include "game-event.h"
+#include "game-profile.h"
 #include "generate.h"
 #include "init.h"
 #include "mon-make.h"
@@ -107,29 +108,6 @@ byte get_angle_to_grid[41][41] =
 };
 
 
-/**
- * Used to convert grid into an array index (i) in a chunk of width w.
- * \param grid location
- * \param w area width
- * \return index
- */
-int grid_to_i(struct loc grid, int w)
-{
-    return grid.y * w + grid.x;
-}
-
-/**
- * Used to convert an array index (i) into grid in a chunk of width w.
- * \param i grid index
- * \param w area width
- * \param grid location
- */
-void i_to_grid(int i, int w, struct loc *grid)
-{
-    grid->y = i / w;
-    grid->x = i % w;
-}
-
 /**
  * Shuffle an array using Knuth's shuffle.
  * \param arr array
@@ -188,6 +166,90 @@ static bool cave_find_in_range(struct chunk *c, struct loc *grid,
 }
 
 
+/**
+ * Get the pool of grids in a rectangle which satisfy the given predicate,
+ * building it if this is the first time it has been asked for or if the
+ * terrain has changed since it was built.
+ *
+ * \param c current chunk
+ * \param top_left top left grid of rectangle
+ * \param bottom_right bottom right grid of rectangle
+ * \param pred square_predicate specifying what we're looking for
+ * \return the pool
+ */
+static struct grid_pool *grid_pool_get(struct chunk *c, struct loc top_left,
+									   struct loc bottom_right,
+									   square_predicate pred)
+{
+	struct grid_pool *pool;
+	struct loc grid;
+
+	for (pool = c->grid_pools; pool; pool = pool->next) {
+		if (pool->pred == pred && loc_eq(pool->top_left, top_left) &&
+			loc_eq(pool->bottom_right, bottom_right))
+			break;
+	}
+
+	if (!pool) {
+		struct loc diff = loc_diff(bottom_right, top_left);
+
+		pool = mem_zalloc(sizeof(*pool));
+		pool->pred = pred;
+		pool->top_left = top_left;
+		pool->bottom_right = bottom_right;
+		pool->grids = mem_zalloc(MAX(diff.y * diff.x, 1) * sizeof(int));
+		pool->next = c->grid_pools;
+		c->grid_pools = pool;
+	} else if (pool->stamp == c->feat_stamp) {
+		return pool;
+	}
+
+	/* Same rectangle as cave_find_in_range(), which leaves out the far edge */
+	pool->num = 0;
+	for (grid.y = top_left.y; grid.y < bottom_right.y; grid.y++)
+		for (grid.x = top_left.x; grid.x < bottom_right.x; grid.x++)
+			if (pred(c, grid))
+				pool->grids[pool->num++] = grid_to_i(grid, c->width);
+
+	pool->stamp = c->feat_stamp;
+	return pool;
+}
+
+
+/**
+ * Locate a square in a rectangle which satisfies the given predicate, in the
+ * same way as cave_find_in_range() but drawing from a pool kept with the
+ * chunk.  Monsters and objects placed since the pool was built don't touch
+ * the terrain, so grids they fill are only dropped when they are drawn; this
+ * makes placing many things on a level cost about one scan of it in all.
+ *
+ * \param c current chunk
+ * \param grid found grid
+ * \param top_left top left grid of rectangle
+ * \param bottom_right bottom right grid of rectangle
+ * \param pred square_predicate specifying what we're looking for
+ * \return success
+ */
+static bool cave_find_pooled(struct chunk *c, struct loc *grid,
+							 struct loc top_left, struct loc bottom_right,
+							 square_predicate pred)
+{
+	struct grid_pool *pool = grid_pool_get(c, top_left, bottom_right, pred);
+
+	while (pool->num > 0) {
+		int j = randint0(pool->num);
+
+		i_to_grid(pool->grids[j], c->width, grid);
+		if (pred(c, *grid)) return true;
+
+		/* No longer suitable, so swap it out of the pool */
+		pool->grids[j] = pool->grids[--pool->num];
+	}
+
+	return false;
+}
+
+
 /**
  * Locate a square in the dungeon which satisfies the given predicate.
  * \param c current chunk
@@ -199,7 +261,7 @@ bool cave_find(struct chunk *c, struct loc *grid, square_predicate pred)
 {
 	struct loc top_left = loc(0, 0);
 	struct loc bottom_right = loc(c->width - 1, c->height - 1);
-    return cave_find_in_range(c, grid, top_left, bottom_right, pred);
+    return cave_find_pooled(c, grid, top_left, bottom_right, pred);
 }
 
 
@@ -294,12 +356,12 @@ void rand_dir(struct loc *offset)
 static bool find_start(struct chunk *c, struct loc *grid)
 {
 	/* Find the best possible place */
-	if (cave_find_in_range(c, grid, loc(1, 1), loc(c->width - 2, c->height - 2),
-						   square_suits_stairs_well)) {
+	if (cave_find_pooled(c, grid, loc(1, 1), loc(c->width - 2, c->height - 2),
+						 square_suits_stairs_well)) {
 			return true;
-	} else if (cave_find_in_range(c, grid, loc(1, 1),
-								  loc(c->width - 2, c->height - 2),
-								  square_suits_stairs_ok)) {
+	} else if (cave_find_pooled(c, grid, loc(1, 1),
+								loc(c->width - 2, c->height - 2),
+								square_suits_stairs_ok)) {
 		return true;
 	} else {
 		int walls = 6;
@@ -312,9 +374,9 @@ static bool find_start(struct chunk *c, struct loc *grid)
 			for (j = 0; j < 10000; j++) {
 				int total_walls = 0;
 
-				cave_find_in_range(c, grid, loc(1, 1),
-								   loc(c->width - 2, c->height - 2),
-								   square_isempty);
+				cave_find_pooled(c, grid, loc(1, 1),
+								 loc(c->width - 2, c->height - 2),
+								 square_isempty);
 				if (square_isvault(c, *grid) || square_isno_stairs(c, *grid)) {
 					continue;
 				}
@@ -540,13 +602,13 @@ void alloc_stairs(struct chunk *c, int feat, int num)
 		bool done = false;
 
 		/* Find the best possible place for the stairs */
-		if (cave_find_in_range(c, &grid, loc(1, 1),
-							   loc(c->width - 2, c->height - 2),
-							   square_suits_stairs_well)) {
+		if (cave_find_pooled(c, &grid, loc(1, 1),
+							 loc(c->width - 2, c->height - 2),
+							 square_suits_stairs_well)) {
 			place_stairs(c, grid, feat);
-		} else if (cave_find_in_range(c, &grid, loc(1, 1),
-									  loc(c->width - 2, c->height - 2),
-									  square_suits_stairs_ok)) {
+		} else if (cave_find_pooled(c, &grid, loc(1, 1),
+									loc(c->width - 2, c->height - 2),
+									square_suits_stairs_ok)) {
 			place_stairs(c, grid, feat);
 		} else {
 			int walls = 6;
@@ -559,9 +621,9 @@ void alloc_stairs(struct chunk *c, int feat, int num)
 				for (j = 0; j < 1000; j++) {
 					int total_walls = 0;
 
-					cave_find_in_range(c, &grid, loc(1, 1),
-									   loc(c->width - 2, c->height - 2),
-									   square_isempty);
+					cave_find_pooled(c, &grid, loc(1, 1),
+									 loc(c->width - 2, c->height - 2),
+									 square_isempty);
 					if (square_isvault(c, grid) || square_isno_stairs(c, grid)){
 						continue;
 					}
@@ -598,10 +660,34 @@ void alloc_objects(struct chunk *c, int set, int typ, int num, int depth,
 				   byte origin)
 {
     int k, l = 0;
+	u64b start_time = profile_begin();
     for (k = 0; k < num; k++) {
 		bool ok = alloc_object(c, set, typ, depth, origin);
 		if (!ok) l++;
     }
+	profile_end(PROFILE_GEN_OBJECTS, start_time);
+}
+
+
+/**
+ * Determine whether the given grid is empty and outside any room.
+ * \param c current chunk
+ * \param grid location
+ */
+static bool square_isempty_corridor(struct chunk *c, struct loc grid)
+{
+	return square_isempty(c, grid) && !square_isroom(c, grid);
+}
+
+
+/**
+ * Determine whether the given grid is empty and inside a room.
+ * \param c current chunk
+ * \param grid location
+ */
+static bool square_isempty_room(struct chunk *c, struct loc grid)
+{
+	return square_isempty(c, grid) && square_isroom(c, grid);
 }
 
 
@@ -618,23 +704,15 @@ void alloc_objects(struct chunk *c, int set, int typ, int num, int depth,
  */
 bool alloc_object(struct chunk *c, int set, int typ, int depth, byte origin)
 {
-    int tries = 0;
 	struct loc grid;
+	square_predicate pred = square_isempty;
 
     /* Pick a "legal" spot */
-    while (tries < 2000) {
-		tries++;
-
-		find_empty(c, &grid);
-
-		/* If we are ok with a corridor and we're in one, we're done */
-		if (set & SET_CORR && !square_isroom(c, grid)) break;
-
-		/* If we are ok with a room and we're in one, we're done */
-		if (set & SET_ROOM && square_isroom(c, grid)) break;
-    }
-
-    if (tries == 2000) return false;
+	if (!(set & SET_ROOM))
+		pred = square_isempty_corridor;
+	else if (!(set & SET_CORR))
+		pred = square_isempty_room;
+	if (!cave_find(c, &grid, pred)) return false;
 
     /* Place something */
     switch (typ) {
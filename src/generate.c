@@ -32,6 +32,7 @@
 #include "datafile.h"
 #include "game-event.h"
 #include "game-input.h"
+#include "game-profile.h"
 #include "game-world.h"
 #include "generate.h"
 #include "init.h"
@@ -55,6 +56,8 @@
 struct pit_profile *pit_info;
 struct vault *vaults;
 static struct cave_profile *cave_profiles;
+static struct gen_attempts *profile_attempts;
+const struct cave_profile *gen_forced_profile;
 struct dun_data *dun;
 struct room_template *room_templates;
 
@@ -222,6 +225,8 @@ static errr finish_parse_profile(struct parser *p) {
 
 	/* Allocate the array and copy the records to it */
 	cave_profiles = mem_zalloc(z_info->profile_max * sizeof(*c));
+	profile_attempts = mem_zalloc(z_info->profile_max *
+								  sizeof(*profile_attempts));
 	num = z_info->profile_max - 1;
 	for (c = parser_priv(p); c; c = n) {
 		struct room_profile *r_new = NULL;
@@ -292,6 +297,7 @@ static void cleanup_profile(void)
 		string_free((char *) cave_profiles[i].name);
 	}
 	mem_free(cave_profiles);
+	mem_free(profile_attempts);
 }
 
 static struct file_parser profile_parser = {
@@ -394,6 +400,37 @@ static enum parser_error parse_room_tval(struct parser *p) {
 	return PARSE_ERROR_NONE;
 }
 
+/**
+ * Compile the text of a room or vault template into the list of grids that
+ * aren't blank, stopping early if the text runs out
+ */
+static struct template_grid *compile_template(const char *text, int hgt,
+											  int wid, int *num)
+{
+	struct template_grid *grids;
+	const char *t = text;
+	int y, x, n = 0;
+
+	if (!text) {
+		*num = 0;
+		return NULL;
+	}
+
+	grids = mem_zalloc(MAX(hgt * wid, 1) * sizeof(*grids));
+	for (y = 0; y < hgt && *t; y++) {
+		for (x = 0; x < wid && *t; x++, t++) {
+			if (*t == ' ') continue;
+			grids[n].y = y;
+			grids[n].x = x;
+			grids[n].symbol = *t;
+			n++;
+		}
+	}
+
+	*num = n;
+	return mem_realloc(grids, MAX(n, 1) * sizeof(*grids));
+}
+
 static enum parser_error parse_room_d(struct parser *p) {
 	struct room_template *t = parser_priv(p);
 
@@ -422,8 +459,13 @@ static errr run_parse_room(struct parser *p) {
 }
 
 static errr finish_parse_room(struct parser *p) {
+	struct room_template *t;
+
 	room_templates = parser_priv(p);
 	parser_destroy(p);
+
+	for (t = room_templates; t; t = t->next)
+		t->grids = compile_template(t->text, t->hgt, t->wid, &t->num_grids);
 	return 0;
 }
 
@@ -434,6 +476,7 @@ static void cleanup_room(void)
 		next = t->next;
 		mem_free(t->name);
 		mem_free(t->text);
+		mem_free(t->grids);
 		mem_free(t);
 	}
 }
@@ -569,8 +612,27 @@ static errr run_parse_vault(struct parser *p) {
 }
 
 static errr finish_parse_vault(struct parser *p) {
+	struct vault *v;
+
 	vaults = parser_priv(p);
 	parser_destroy(p);
+
+	for (v = vaults; v; v = v->next) {
+		int i, n = 0;
+
+		v->grids = compile_template(v->text, v->hgt, v->wid, &v->num_grids);
+
+		/* Most alphabetic characters signify monster races */
+		for (i = 0; i < v->num_grids; i++) {
+			char symbol = v->grids[i].symbol;
+
+			if (!isalpha((unsigned char) symbol)) continue;
+			if (symbol == 'x' || symbol == 'X') continue;
+			if (strchr(v->races, symbol)) continue;
+			if (n < (int) sizeof(v->races) - 1)
+				v->races[n++] = symbol;
+		}
+	}
 	return 0;
 }
 
@@ -582,6 +644,7 @@ static void cleanup_vault(void)
 		mem_free(v->name);
 		mem_free(v->typ);
 		mem_free(v->text);
+		mem_free(v->grids);
 		mem_free(v);
 	}
 }
@@ -765,6 +828,31 @@ const struct cave_profile *find_cave_profile(char *name)
 	return NULL;
 }
 
+/**
+ * Forget how often each cave profile has been tried
+ */
+void gen_attempts_reset(void)
+{
+	memset(profile_attempts, 0, z_info->profile_max *
+		   sizeof(*profile_attempts));
+}
+
+/**
+ * Get how often a cave profile has been tried, and has failed, since the
+ * last reset
+ * \param i is the index of the profile
+ * \param name is set to the name of the profile
+ * \param attempts is filled in with the counts
+ * \return false if there is no profile with that index
+ */
+bool gen_attempts_get(int i, const char **name, struct gen_attempts *attempts)
+{
+	if (i < 0 || i >= z_info->profile_max) return false;
+	*name = cave_profiles[i].name;
+	*attempts = profile_attempts[i];
+	return true;
+}
+
 /**
  * Choose a cave profile
  * \param p is the player
@@ -773,6 +861,9 @@ const struct cave_profile *choose_profile(struct player *p)
 {
 	const struct cave_profile *profile = NULL;
 
+	/* Benchmarks can ask for every level to be built the same way */
+	if (gen_forced_profile) return gen_forced_profile;
+
 	/* A bit of a hack, but worth it for now NRM */
 	if (player->noscore & NOSCORE_JUMPING) {
 		char name[30] = "";
@@ -932,6 +1023,7 @@ static struct chunk *cave_generate(struct player *p, int height, int width)
 	const char *error = "no generation";
 	int i, tries = 0;
 	struct chunk *chunk = NULL;
+	u64b start_time = profile_begin();
 
 	/* Arena levels handled separately */
 	if (p->upkeep->arena_level) {
@@ -951,6 +1043,7 @@ static struct chunk *cave_generate(struct player *p, int height, int width)
 		wiz_light(chunk, p, false);
 		chunk->turn = turn;
 
+		profile_end(PROFILE_GENERATE, start_time);
 		return chunk;
 	}
 
@@ -958,6 +1051,7 @@ static struct chunk *cave_generate(struct player *p, int height, int width)
 	for (tries = 0; tries < 100 && error; tries++) {
 		int y, x;
 		struct dun_data dun_body;
+		struct gen_attempts *attempts;
 
 		error = NULL;
 
@@ -979,9 +1073,12 @@ static struct chunk *cave_generate(struct player *p, int height, int width)
 
 		/* Choose a profile and build the level */
 		dun->profile = choose_profile(p);
+		attempts = &profile_attempts[dun->profile - cave_profiles];
+		attempts->tries++;
 		chunk = dun->profile->builder(p, height, width);
 		if (!chunk) {
 			error = "Failed to find builder";
+			attempts->failures++;
 			mem_free(dun->join);
 			mem_free(dun->cent);
 			mem_free(dun->door);
@@ -1043,6 +1140,7 @@ static struct chunk *cave_generate(struct player *p, int height, int width)
 			if (OPT(p, cheat_room)) {
 				msg("Generation restarted: %s.", error);
 			}
+			attempts->failures++;
 			cave_clear(chunk, p);
 		}
 
@@ -1081,6 +1179,7 @@ static struct chunk *cave_generate(struct player *p, int height, int width)
 
 	chunk->turn = turn;
 
+	profile_end(PROFILE_GENERATE, start_time);
 	return chunk;
 }
 
@@ -1170,6 +1269,7 @@ static void sanitize_player_loc(struct chunk *c, struct player *p)
 void prepare_next_level(struct chunk **c, struct player *p)
 {
 	bool persist = OPT(p, birth_levels_persist) || p->upkeep->arena_level;
+	enum mem_tag tag = mem_tag_set(MEM_TAG_CAVE);
 
 	/* Deal with any existing current level */
 	if (character_dungeon) {
@@ -1245,6 +1345,8 @@ void prepare_next_level(struct chunk **c, struct player *p)
 			assert(old_known);
 
 			/* Assign the new ones */
+			cave_unpack(old_level);
+			cave_unpack(old_known);
 			*c = old_level;
 			p->cave = old_known;
 
@@ -1279,8 +1381,8 @@ void prepare_next_level(struct chunk **c, struct player *p)
 				/* Failed to find, try near the killed monster */
 				if (!found) {
 					int k;
-					int ty = (*c)->monsters[1].grid.y;
-					int tx = (*c)->monsters[1].grid.x;
+					int ty = cave_monster(*c, 1)->grid.y;
+					int tx = cave_monster(*c, 1)->grid.x;
 					for (k = 1; k < 10; k++) {
 						for (y = ty - k; y <= ty + k; y++) {
 							for (x = tx - k; x <= tx + k; x++) {
@@ -1301,7 +1403,7 @@ void prepare_next_level(struct chunk **c, struct player *p)
 
 				/* Still failed to find, try anywhere */
 				if (!found) {
-					p->grid = (*c)->monsters[1].grid;
+					p->grid = cave_monster(*c, 1)->grid;
 					sanitize_player_loc(*c, p);
 				}
 
@@ -1358,6 +1460,7 @@ void prepare_next_level(struct chunk **c, struct player *p)
 
 	/* The dungeon is ready */
 	character_dungeon = true;
+	mem_tag_set(tag);
 }
 
 /**
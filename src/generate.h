@@ -123,6 +123,10 @@ struct dun_data {
     /*!< Array of which blocks are used */
     bool **room_map;
 
+    /*!< Summed-area table of room_map, with a row and column of zeroes
+     * first, so any rectangle of blocks can be checked in one go */
+    int *room_sum;
+
     /*!< Number of pits/nests on the level */
     int pit_num;
 
@@ -204,11 +208,25 @@ struct room_profile {
 /*
  * Information about vault generation
  */
+/**
+ * A grid of a room or vault template that isn't blank.  Templates are
+ * compiled into a list of these, in the order the text gives them, when
+ * they are loaded, so building one needn't walk the text.
+ */
+struct template_grid {
+	byte y;				/*!< Row within the template */
+	byte x;				/*!< Column within the template */
+	char symbol;		/*!< Character from the template text */
+};
+
 struct vault {
     struct vault *next; /*!< Pointer to next vault template */
 
     char *name;         /*!< Vault name */
     char *text;         /*!< Grid by grid description of vault layout */
+    struct template_grid *grids;	/*!< The grids of text which aren't blank */
+    int num_grids;		/*!< Number of grids */
+    char races[31];		/*!< Monster race symbols, in order of appearance */
 
     char *typ;			/*!< Vault type */
 
@@ -231,6 +249,8 @@ struct room_template {
 
     char *name;         /*!< Room name */
     char *text;         /*!< Grid by grid description of room layout */
+    struct template_grid *grids;	/*!< The grids of text which aren't blank */
+    int num_grids;		/*!< Number of grids */
 
     byte typ;			/*!< Room type */
 
@@ -242,9 +262,39 @@ struct room_template {
     byte tval;			/*!< tval for objects in this room */
 };
 
+/**
+ * How often levels have been tried, and have failed, with a cave profile
+ */
+struct gen_attempts {
+	u32b tries;
+	u32b failures;
+};
+
+/**
+ * What build_tunnel() has done since the counts were last cleared
+ */
+struct tunnel_stats {
+	u32b tunnels;		/* Tunnels started */
+	u32b arrived;		/* Tunnels which got where they were going */
+	u32b stopped;		/* Tunnels which stopped on meeting another corridor */
+	u32b boxed_in;		/* Tunnels given up because they could go no further */
+	u32b timed_out;		/* Tunnels given up at the step limit */
+	u32b steps;			/* Steps tried, including those which were refused */
+	u32b dug;			/* Grids dug out into corridor */
+	u32b pierced;		/* Room walls pierced */
+	u32b doors;			/* Places noted for doors at corridor crossings */
+};
+
 extern struct dun_data *dun;
 extern struct vault *vaults;
 extern struct room_template *room_templates;
+extern const struct cave_profile *gen_forced_profile;
+extern struct tunnel_stats tunnel_stats;
+
+/* generate.c */
+const struct cave_profile *find_cave_profile(char *name);
+void gen_attempts_reset(void);
+bool gen_attempts_get(int i, const char **name, struct gen_attempts *attempts);
 
 /* gen-cave.c */
 struct chunk *town_gen(struct player *p, int min_height, int min_width);
@@ -304,6 +354,8 @@ bool build_greater_vault(struct chunk *c, struct loc centre, int rating);
 bool build_moria(struct chunk *c, struct loc centre, int rating);
 bool build_room_of_chambers(struct chunk *c, struct loc centre, int rating);
 bool build_huge(struct chunk *c, struct loc centre, int rating);
+void room_map_new(void);
+void room_map_free(void);
 bool room_build(struct chunk *c, int by0, int bx0, struct room_profile profile,
 	bool finds_own_space);
 
@@ -311,8 +363,6 @@ bool room_build(struct chunk *c, int by0, int bx0, struct room_profile profile,
 /* gen-util.c */
 extern byte get_angle_to_grid[41][41];
 
-int grid_to_i(struct loc grid, int w);
-void i_to_grid(int i, int w, struct loc *grid);
 void shuffle(int *arr, int n);
 bool cave_find(struct chunk *c, struct loc *grid, square_predicate pred);
 bool find_empty(struct chunk *c, struct loc *grid);
@@ -341,8 +391,7 @@ bool alloc_object(struct chunk *c, int set, int typ, int depth, byte origin);
 bool mon_restrict(const char *monster_type, int depth, bool unique_ok);
 void spread_monsters(struct chunk *c, const char *type, int depth, int num, 
 					 int y0, int x0, int dy, int dx, byte origin);
-void get_vault_monsters(struct chunk *c, char racial_symbol[], char *vault_type,
-						const char *data, int y1, int y2, int x1, int x2);
+void get_vault_monsters(struct chunk *c, const struct vault *v, int y1, int x1);
 void get_chamber_monsters(struct chunk *c, int y1, int x1, int y2, int x2, char *name, int area);
 
 
@@ -1093,7 +1093,7 @@ static enum parser_error parse_monster_name(struct parser *p) {
 	struct monster_race *h = parser_priv(p);
 	struct monster_race *r = mem_zalloc(sizeof *r);
 	r->next = h;
-	r->name = string_make(parser_getstr(p, "name"));
+	r->name = string_pool_make(parser_getstr(p, "name"));
 	parser_setpriv(p, r);
 	return PARSE_ERROR_NONE;
 }
@@ -1325,7 +1325,11 @@ static enum parser_error parse_monster_desc(struct parser *p) {
 
 	if (!r)
 		return PARSE_ERROR_MISSING_RECORD_HEADER;
-	r->text = string_append(r->text, parser_getstr(p, "desc"));
+
+	/* Text read from a file stays there until it is shown */
+	if (!r->text && (r->text_mark.path || parse_file_mark(&r->text_mark)))
+		return PARSE_ERROR_NONE;
+	r->text = string_pool_append(r->text, parser_getstr(p, "desc"));
 	return PARSE_ERROR_NONE;
 }
 
@@ -1691,7 +1695,7 @@ static errr finish_parse_monster(struct parser *p) {
 			if (!my_stricmp(f->name, "same")) {
 				f->race = race;
 			} else {
-				f->race = lookup_monster(f->name);
+				f->race = lookup_closest_monster(f->name);
 			}
 			if (!f->race) {
 				quit_fmt("Couldn't find friend named '%s' for monster '%s'",
@@ -1701,7 +1705,7 @@ static errr finish_parse_monster(struct parser *p) {
 		}
 		for (s = race->shapes; s; s = s->next) {
 			if (!s->base) {
-				s->race = lookup_monster(s->name);
+				s->race = lookup_closest_monster(s->name);
 				if (!s->race) {
 					quit_fmt("Couldn't find shape named '%s' for monster '%s'",
 							 s->name, race->name);
@@ -1772,6 +1776,7 @@ static void cleanup_monster(void)
 	}
 
 	mem_free(r_info);
+	monster_names_free();
 }
 
 struct file_parser monster_parser = {
@@ -2434,7 +2439,7 @@ static errr finish_parse_lore(struct parser *p) {
 			if (!my_stricmp(f->name, "same"))
 				f->race = r;
 			else
-				f->race = lookup_monster(f->name);
+				f->race = lookup_closest_monster(f->name);
 
 			string_free(f->name);
 		}
@@ -2451,6 +2456,7 @@ static void cleanup_lore(void)
 {
 	int ridx;
 
+	lore_entries_free();
 	for (ridx = 0; ridx < z_info->r_max; ridx++) {
 		struct monster_lore *l = &l_list[ridx];
 		struct monster_drop *d;
@@ -956,7 +956,7 @@ static enum parser_error parse_curse_name(struct parser *p) {
 	struct curse *h = parser_priv(p);
 
 	struct curse *curse = mem_zalloc(sizeof *curse);
-	curse->obj = mem_zalloc(sizeof(struct object));
+	curse->obj = object_new();
 	curse->next = h;
 	parser_setpriv(p, curse);
 	curse->name = string_make(name);
@@ -1269,7 +1269,7 @@ static void cleanup_curse(void)
 			free_effect(curses[idx].obj->effect);
 			mem_free(curses[idx].obj->effect_msg);
 			object_free(curses[idx].obj->known);
-			mem_free(curses[idx].obj);
+			object_free(curses[idx].obj);
 		}
 		mem_free(curses[idx].poss);
 	}
@@ -1536,7 +1536,7 @@ static enum parser_error parse_object_name(struct parser *p) {
 	struct object_kind *k = mem_zalloc(sizeof *k);
 	k->next = h;
 	parser_setpriv(p, k);
-	k->name = string_make(name);
+	k->name = string_pool_make(name);
 	return PARSE_ERROR_NONE;
 }
 
@@ -1816,7 +1816,11 @@ static enum parser_error parse_object_time(struct parser *p) {
 static enum parser_error parse_object_desc(struct parser *p) {
 	struct object_kind *k = parser_priv(p);
 	assert(k);
-	k->text = string_append(k->text, parser_getstr(p, "text"));
+
+	/* Text read from a file stays there until it is shown */
+	if (!k->text && (k->text_mark.path || parse_file_mark(&k->text_mark)))
+		return PARSE_ERROR_NONE;
+	k->text = string_pool_append(k->text, parser_getstr(p, "text"));
 	return PARSE_ERROR_NONE;
 }
 
@@ -1999,6 +2003,7 @@ static void cleanup_object(void)
 		free_effect(kind->effect);
 	}
 	mem_free(k_info);
+	object_names_free();
 }
 
 struct file_parser object_parser = {
@@ -2021,7 +2026,7 @@ static enum parser_error parse_ego_name(struct parser *p) {
 	struct ego_item *e = mem_zalloc(sizeof *e);
 	e->next = h;
 	parser_setpriv(p, e);
-	e->name = string_make(name);
+	e->name = string_pool_make(name);
 	return PARSE_ERROR_NONE;
 }
 
@@ -2301,7 +2306,7 @@ static enum parser_error parse_ego_desc(struct parser *p) {
 
 	if (!e)
 		return PARSE_ERROR_MISSING_RECORD_HEADER;
-	e->text = string_append(e->text, parser_getstr(p, "text"));
+	e->text = string_pool_append(e->text, parser_getstr(p, "text"));
 	return PARSE_ERROR_NONE;
 }
 
@@ -2469,7 +2474,7 @@ static enum parser_error parse_artifact_name(struct parser *p) {
 	struct artifact *a = mem_zalloc(sizeof *a);
 	a->next = h;
 	parser_setpriv(p, a);
-	a->name = string_make(name);
+	a->name = string_pool_make(name);
 
 	/* Ignore all base elements */
 	for (i = ELEM_BASE_MIN; i < ELEM_HIGH_MIN; i++)
@@ -2688,7 +2693,10 @@ static enum parser_error parse_artifact_desc(struct parser *p) {
 	struct artifact *a = parser_priv(p);
 	assert(a);
 
-	a->text = string_append(a->text, parser_getstr(p, "text"));
+	/* Text read from a file stays there until it is shown */
+	if (!a->text && (a->text_mark.path || parse_file_mark(&a->text_mark)))
+		return PARSE_ERROR_NONE;
+	a->text = string_pool_append(a->text, parser_getstr(p, "text"));
 	return PARSE_ERROR_NONE;
 }
 
@@ -2833,6 +2841,7 @@ static void cleanup_artifact(void)
 		mem_free(art->curses);
 	}
 	mem_free(a_info);
+	object_names_free();
 }
 
 struct file_parser artifact_parser = {
@@ -2882,6 +2891,12 @@ static errr finish_parse_randart(struct parser *p) {
 	}
 	z_info->a_max += 1;
 
+	/* The randart file is archived once read, so its text can't wait */
+	for (aidx = 1; aidx < z_info->a_max; aidx++) {
+		artifact_text(&a_info[aidx]);
+		a_info[aidx].text_mark.path = NULL;
+	}
+
 	parser_destroy(p);
 	return 0;
 }
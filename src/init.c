@@ -61,6 +61,7 @@
 #include "player-timed.h"
 #include "project.h"
 #include "randname.h"
+#include "savefile.h"
 #include "store.h"
 #include "trap.h"
 
@@ -945,8 +946,8 @@ static enum parser_error parse_trap_name(struct parser *p) {
 
     struct trap_kind *t = mem_zalloc(sizeof *t);
     t->next = h;
-    t->name = string_make(name);
-	t->desc = string_make(desc);
+    t->name = string_pool_make(name);
+	t->desc = string_pool_make(desc);
     parser_setpriv(p, t);
     return PARSE_ERROR_NONE;
 }
@@ -1287,7 +1288,7 @@ static enum parser_error parse_trap_desc(struct parser *p) {
     struct trap_kind *t = parser_priv(p);
     assert(t);
 
-    t->text = string_append(t->text, parser_getstr(p, "text"));
+    t->text = string_pool_append(t->text, parser_getstr(p, "text"));
     return PARSE_ERROR_NONE;
 }
 
@@ -1424,7 +1425,7 @@ static enum parser_error parse_feat_name(struct parser *p) {
 
 	struct feature *f = mem_zalloc(sizeof *f);
 	f->next = h;
-	f->name = string_make(name);
+	f->name = string_pool_make(name);
 	parser_setpriv(p, f);
 	return PARSE_ERROR_NONE;
 }
@@ -1508,7 +1509,7 @@ static enum parser_error parse_feat_desc(struct parser *p) {
     struct feature *f = parser_priv(p);
     assert(f);
 
-    f->desc = string_append(f->desc, parser_getstr(p, "text"));
+    f->desc = string_pool_append(f->desc, parser_getstr(p, "text"));
     return PARSE_ERROR_NONE;
 }
 
@@ -1629,6 +1630,9 @@ static void cleanup_feat(void) {
 		string_free(f_info[idx].name);
 	}
 	mem_free(f_info);
+	feat_names_free();
+	mem_free(feat_props);
+	feat_props = NULL;
 }
 
 static struct file_parser feat_parser = {
@@ -2301,7 +2305,7 @@ static enum parser_error parse_shape_name(struct parser *p) {
 	struct player_shape *shape = mem_zalloc(sizeof *shape);
 
 	shape->next = h;
-	shape->name = string_make(parser_getstr(p, "name"));
+	shape->name = string_pool_make(parser_getstr(p, "name"));
 	parser_setpriv(p, shape);
 	shape->sidx = z_info->shape_max++;
 	return PARSE_ERROR_NONE;
@@ -3523,6 +3527,7 @@ extern struct init_module player_module;
 extern struct init_module store_module;
 extern struct init_module messages_module;
 extern struct init_module options_module;
+extern struct init_module project_module;
 
 static struct init_module *modules[] = {
 	&z_quark_module,
@@ -3536,6 +3541,7 @@ static struct init_module *modules[] = {
 	&mon_make_module,
 	&store_module,
 	&options_module,
+	&project_module,
 	NULL
 };
 
@@ -3586,6 +3592,10 @@ bool init_angband(void)
 void cleanup_angband(void)
 {
 	int i;
+
+	/* Let any save still being written finish */
+	savefile_finish();
+
 	for (i = 0; modules[i]; i++)
 		if (modules[i]->cleanup)
 			modules[i]->cleanup();
@@ -3606,9 +3616,13 @@ void cleanup_angband(void)
 
 	monster_list_finalize();
 	object_list_finalize();
+	effect_simple_cleanup();
 
 	cleanup_game_constants();
 
+	/* Gamedata text goes last, as the cleanups above may still free it */
+	string_pool_free();
+
 	cmdq_flush();
 
 	if (play_again) return;
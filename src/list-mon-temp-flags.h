@@ -14,3 +14,5 @@ MFLAG(CAMOUFLAGE,"Player doesn't know this is a monster")
 MFLAG(AWARE,	"Monster is aware of the player")
 MFLAG(HANDLED,	"Monster has been processed this turn")
 MFLAG(TRACKING,	"Monster is tracking the player by sound or scent")
+MFLAG(DORMANT,	"Monster is parked until the player comes near")
+MFLAG(CHANGED,	"Monster is waiting for update_changed_monsters()")
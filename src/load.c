@@ -163,8 +163,7 @@ static struct object *rd_item(void)
 	}
 	rd_byte(&obj->notice);
 
-	for (i = 0; i < of_size; i++)
-		rd_byte(&obj->flags[i]);
+	rd_bytes(obj->flags, of_size);
 
 	for (i = 0; i < obj_mod_max; i++) {
 		rd_s16b(&obj->modifiers[i]);
@@ -193,12 +192,14 @@ static struct object *rd_item(void)
 	/* Read curses */
 	rd_byte(&tmp8u);
 	if (tmp8u) {
-		obj->curses = mem_zalloc(z_info->curse_max * sizeof(struct curse_data));
 		for (i = 0; i < curse_max; i++) {
 			rd_byte(&tmp8u);
-			obj->curses[i].power = tmp8u;
 			rd_u16b(&tmp16u);
-			obj->curses[i].timeout = tmp16u;
+			if (tmp8u) {
+				struct curse_data *c = object_curse_add(obj, i);
+				c->power = tmp8u;
+				c->timeout = tmp16u;
+			}
 		}
 	}
 
@@ -289,11 +290,8 @@ static bool rd_monster(struct chunk *c, struct monster *mon)
 		rd_s16b(&mon->m_timed[j]);
 
 	/* Read and extract the flag */
-	for (j = 0; j < mflag_size; j++)
-		rd_byte(&mon->mflag[j]);
-
-	for (j = 0; j < of_size; j++)
-		rd_byte(&mon->known_pstate.flags[j]);
+	rd_bytes(mon->mflag, mflag_size);
+	rd_bytes(mon->known_pstate.flags, of_size);
 
 	for (j = 0; j < elem_max; j++)
 		rd_s16b(&mon->known_pstate.el_info[j].res_level);
@@ -347,7 +345,6 @@ static bool rd_monster(struct chunk *c, struct monster *mon)
  */
 static void rd_trap(struct trap *trap)
 {
-	int i;
 	byte tmp8u;
 	char buf[80];
 
@@ -363,8 +360,7 @@ static void rd_trap(struct trap *trap)
 	rd_byte(&trap->power);
 	rd_byte(&trap->timeout);
 
-	for (i = 0; i < trf_size; i++)
-		rd_byte(&trap->flags[i]);
+	rd_bytes(trap->flags, trf_size);
 }
 
 /**
@@ -383,19 +379,19 @@ int rd_randomizer(void)
 	rd_u32b(&Rand_value);
 
 	/* state index */
-	rd_u32b(&state_i);
+	rd_u32b(&Rand_default.state_i);
 
 	/* for safety, make sure state_i < RAND_DEG */
-	state_i = state_i % RAND_DEG;
+	Rand_default.state_i = Rand_default.state_i % RAND_DEG;
     
-	/* RNG variables */
-	rd_u32b(&z0);
-	rd_u32b(&z1);
-	rd_u32b(&z2);
+	/* RNG variables, no longer used */
+	rd_u32b(&noop);
+	rd_u32b(&noop);
+	rd_u32b(&noop);
     
 	/* RNG state */
 	for (i = 0; i < RAND_DEG; i++)
-		rd_u32b(&STATE[i]);
+		rd_u32b(&Rand_default.state[i]);
 
 	/* NULL padding */
 	for (i = 0; i < 59 - RAND_DEG; i++)
@@ -837,6 +833,7 @@ int rd_ignore(void)
 	} else {
 		for (i = 0; i < ignore_size; i++)
 			rd_byte(&ignore_level[i]);
+		ignore_settings_changed();
 	}
 
 	/* Read the number of saved ego-item */
@@ -962,8 +959,7 @@ int rd_misc(void)
 
 	/* Property knowledge */
 	/* Flags */
-	for (i = 0; i < OF_SIZE; i++)
-		rd_byte(&player->obj_k->flags[i]);
+	rd_bytes(player->obj_k->flags, OF_SIZE);
 
 	/* Modifiers */
 	for (i = 0; i < OBJ_MOD_MAX; i++) {
@@ -991,7 +987,8 @@ int rd_misc(void)
 	/* Read curses */
 	for (i = 0; i < curse_max; i++) {
 		rd_byte(&tmp8u);
-		player->obj_k->curses[i].power = tmp8u;
+		if (tmp8u)
+			object_curse_add(player->obj_k, i)->power = tmp8u;
 	}
 
 	/* Combat data */
@@ -1164,7 +1161,7 @@ int rd_gear(void)
 /**
  * Read store contents
  */
-static int rd_stores_aux(rd_item_t rd_item_version)
+static int rd_stores_aux(rd_item_t rd_item_version, bool maint)
 {
 	int i;
 	u16b tmp16u;
@@ -1178,6 +1175,9 @@ static int rd_stores_aux(rd_item_t rd_item_version)
 
 		/* Read the basic info */
 		rd_byte(&own);
+		store->maint_days = 0;
+		if (maint)
+			rd_u16b(&store->maint_days);
 		rd_byte(&num);
 
 		/* XXX: refactor into store.c */
@@ -1216,7 +1216,8 @@ static int rd_stores_aux(rd_item_t rd_item_version)
 /**
  * Read the stores - wrapper functions
  */
-int rd_stores(void) { return rd_stores_aux(rd_item); }
+int rd_stores_1(void) { return rd_stores_aux(rd_item, false); }
+int rd_stores(void) { return rd_stores_aux(rd_item, true); }
 
 
 /**
@@ -1260,7 +1261,7 @@ static int rd_dungeon_aux(struct chunk **c)
 	c1 = cave_new(height, width);
 	c1->name = string_make(name);
 
-    /* Run length decoding of cave->squares[y][x].info */
+    /* Run length decoding of cave->info */
 	for (n = 0; n < square_size; n++) {
 		/* Load the dungeon data */
 		for (x = y = 0; y < c1->height; ) {
@@ -1271,7 +1272,7 @@ static int rd_dungeon_aux(struct chunk **c)
 			/* Apply the RLE info */
 			for (i = count; i > 0; i--) {
 				/* Extract "info" */
-				c1->squares[y][x].info[n] = tmp8u;
+				square(c1, loc(x, y)).info[n] = tmp8u;
 
 				/* Advance/Wrap */
 				if (++x >= c1->width) {
@@ -1366,7 +1367,7 @@ static int rd_objects_aux(rd_item_t rd_item_version, struct chunk *c)
 			break;
 
 		if (square_in_bounds_fully(c, obj->grid)) {
-			pile_insert_end(&c->squares[obj->grid.y][obj->grid.x].obj, obj);
+			square_append_object(c, obj->grid, obj);
 		}
 		assert(obj->oidx);
 		assert(c->objects[obj->oidx] == NULL);
@@ -1558,7 +1559,62 @@ int rd_traps(void)
 /**
  * Read the chunk list
  */
-int rd_chunks(void)
+/**
+ * Read one chunk for the chunk list
+ */
+static int rd_chunk_aux(struct chunk **c)
+{
+	/* Read the dungeon */
+	if (rd_dungeon_aux(c))
+		return -1;
+
+	/* Read the objects */
+	if (rd_objects_aux(rd_item, *c))
+		return -1;
+
+	/* Read the monsters */
+	if (rd_monsters_aux(*c))
+		return -1;
+
+	/* Read traps */
+	if (rd_traps_aux(*c))
+		return -1;
+
+	/* Read other chunk info */
+	if (OPT(player, birth_levels_persist)) {
+		char buf[80];
+		int i;
+		byte tmp8u;
+		u16b tmp16u;
+
+		rd_string(buf, sizeof(buf));
+		(*c)->name = string_make(buf);
+		rd_s32b(&(*c)->turn);
+		rd_u16b(&tmp16u);
+		(*c)->depth = tmp16u;
+		rd_byte(&(*c)->feeling);
+		rd_u32b(&(*c)->obj_rating);
+		rd_u32b(&(*c)->mon_rating);
+		rd_byte(&tmp8u);
+		(*c)->good_item  = tmp8u ? true : false;
+		rd_u16b(&tmp16u);
+		(*c)->height = tmp16u;
+		rd_u16b(&tmp16u);
+		(*c)->width = tmp16u;
+		rd_u16b(&(*c)->feeling_squares);
+		for (i = 0; i < z_info->f_max + 1; i++) {
+			rd_u16b(&tmp16u);
+			(*c)->feat_count[i] = tmp16u;
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * Read the chunk list from before chunks could be left unread
+ */
+int rd_chunks_1(void)
 {
 	int j;
 	u16b chunk_max;
@@ -1570,57 +1626,112 @@ int rd_chunks(void)
 	for (j = 0; j < chunk_max; j++) {
 		struct chunk *c;
 
-		/* Read the dungeon */
-		if (rd_dungeon_aux(&c))
+		if (rd_chunk_aux(&c))
 			return -1;
 
-		/* Read the objects */
-		if (rd_objects_aux(rd_item, c))
-			return -1;
+		chunk_list_add(c);
+	}
 
-		/* Read the monsters */
-		if (rd_monsters_aux(c))
-			return -1;
+	return 0;
+}
+
+/**
+ * Add the count of monsters of each race in a stored chunk to, or take it
+ * from, the race counts
+ */
+static int race_count_sign;
+
+static int rd_chunk_races(void)
+{
+	u16b num, r_idx, count;
+	int i;
 
-		/* Read traps */
-		if (rd_traps_aux(c))
+	rd_u16b(&num);
+	for (i = 0; i < num; i++) {
+		rd_u16b(&r_idx);
+		rd_u16b(&count);
+		if (r_idx >= z_info->r_max) {
+			note(format("Monster race %d out of range!", r_idx));
 			return -1;
+		}
+		r_info[r_idx].cur_num += race_count_sign * count;
+	}
 
+	return 0;
+}
 
-		/* Read other chunk info */
-		if (OPT(player, birth_levels_persist)) {
-			char buf[80];
-			int i;
-			byte tmp8u;
-			u16b tmp16u;
+/**
+ * Read the chunk list.  Only the name and depth of each chunk are read
+ * now, and what was written for the rest is kept for rd_stored_chunk();
+ * monsters on stored levels are counted, though, so uniques stay unique.
+ */
+int rd_chunks(void)
+{
+	int j;
+	u16b chunk_max;
 
-			rd_string(buf, sizeof(buf));
-			c->name = string_make(buf);
-			rd_s32b(&c->turn);
-			rd_u16b(&tmp16u);
-			c->depth = tmp16u;
-			rd_byte(&c->feeling);
-			rd_u32b(&c->obj_rating);
-			rd_u32b(&c->mon_rating);
-			rd_byte(&tmp8u);
-			c->good_item  = tmp8u ? true : false;
-			rd_u16b(&tmp16u);
-			c->height = tmp16u;
-			rd_u16b(&tmp16u);
-			c->width = tmp16u;
-			rd_u16b(&c->feeling_squares);
-			for (i = 0; i < z_info->f_max + 1; i++) {
-				rd_u16b(&tmp16u);
-				c->feat_count[i] = tmp16u;
-			}
-		}
+	if (player->is_dead)
+		return 0;
+
+	rd_u16b(&chunk_max);
+	for (j = 0; j < chunk_max; j++) {
+		struct chunk *c = mem_zalloc(sizeof(*c));
+		char buf[80];
+		u16b tmp16u;
 
+		rd_string(buf, sizeof(buf));
+		c->name = string_make(buf);
+		rd_u16b(&tmp16u);
+		c->depth = tmp16u;
+		rd_u32b(&c->saved_size);
+		c->saved = mem_alloc(MAX(c->saved_size, 1));
+		rd_bytes(c->saved, c->saved_size);
+		c->unread = true;
 		chunk_list_add(c);
+
+		race_count_sign = 1;
+		if (rd_saved(c->saved, c->saved_size, rd_chunk_races))
+			return -1;
 	}
 
 	return 0;
 }
 
+/**
+ * Read a stored chunk which rd_chunks() left unread
+ */
+static struct chunk *stored_chunk;
+
+static int rd_stored_chunk_aux(void)
+{
+	/* Placing the monsters counts them again */
+	race_count_sign = -1;
+	if (rd_chunk_races())
+		return -1;
+
+	return rd_chunk_aux(&stored_chunk);
+}
+
+struct chunk *rd_stored_chunk(struct chunk *c)
+{
+	struct chunk *read;
+
+	assert(c->unread);
+	if (rd_saved(c->saved, c->saved_size, rd_stored_chunk_aux))
+		quit_fmt("Broken savefile - couldn't read %s", c->name);
+	read = stored_chunk;
+	stored_chunk = NULL;
+	cave_pack(read);
+
+	/* It is still what was saved */
+	read->saved = c->saved;
+	read->saved_size = c->saved_size;
+	c->saved = NULL;
+	cave_free(c);
+
+	return read;
+}
+
 
 int rd_history(void)
 {
@@ -75,6 +75,7 @@ _stdcall void Sleep(int);
  */
 #ifdef USE_TPOSIX
 # include <termios.h>
+# include <sys/time.h>
 #endif
 
 /**
@@ -154,6 +155,17 @@ static term_data data[MAX_TERM_DATA];
 /* Number of initialized "term" structures */
 static int active = 0;
 
+/**
+ * Screen updates.  Each window's changes are only copied to curses' picture
+ * of the whole screen when the window is refreshed; the terminal itself is
+ * then brought up to date with one doupdate(), which sends just what differs
+ * from what it already shows.  With a frame cap, updates closer together
+ * than the cap are held back until the next one, or until we wait for input.
+ */
+static int frame_ms = 0;			/* Least time between updates, or 0 */
+static bool update_pending = false;	/* Windows refreshed, screen not updated */
+static long last_update_ms = 0;		/* When the screen was last updated */
+
 #ifdef A_COLOR
 
 /**
@@ -264,6 +276,38 @@ static void keymap_game_prepare(void) {
 }
 
 
+/**
+ * Milliseconds since some fixed time, or 0 if we can't tell
+ */
+static long gcu_time_ms(void) {
+#ifdef USE_TPOSIX
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return tv.tv_sec * 1000L + tv.tv_usec / 1000;
+#else
+	return 0;
+#endif
+}
+
+/**
+ * Send refreshed windows to the terminal; unless forced, not if the screen
+ * was updated too recently for the frame cap
+ */
+static void gcu_update(bool force) {
+	long now;
+
+	if (!update_pending) return;
+
+	now = gcu_time_ms();
+	if (!force && frame_ms && now - last_update_ms < frame_ms
+		&& now >= last_update_ms)
+		return;
+
+	doupdate();
+	update_pending = false;
+	last_update_ms = now;
+}
+
 /**
  * Suspend/Resume
  */
@@ -284,6 +328,7 @@ static errr Term_xtra_gcu_alive(int v) {
 		Term_xtra(TERM_XTRA_SHAPE, 1);
 
 		/* Flush the curses buffer */
+		gcu_update(true);
 		refresh();
 
 		/* Get current cursor position */
@@ -314,16 +359,17 @@ static errr Term_xtra_gcu_alive(int v) {
 	return 0;
 }
 
-const char help_gcu[] = "Text mode, subopts\n              -a     Use ASCII walls\n              -B     Use brighter bold characters\n              -nN    Use N terminals (up to 6)";
+const char help_gcu[] = "Text mode, subopts\n              -a     Use ASCII walls\n              -B     Use brighter bold characters\n              -nN    Use N terminals (up to 6)\n              -fN    Update the screen at most N times a second";
 
 /**
  * Usage:
  *
- * angband -mgcu -- [-a] [-B] [-nN]
+ * angband -mgcu -- [-a] [-B] [-nN] [-fN]
  *
  *   -a      Use ASCII walls
  *   -B      Use brighter bold characters
  *   -nN     Use N terminals (up to 6)
+ *   -fN     Update the screen at most N times a second
  */
 
 /**
@@ -525,6 +571,25 @@ static void do_gcu_resize(void) {
 }
 
 
+/**
+ * Sleep in curses until a key arrives or ms milliseconds pass (forever if ms
+ * is negative), leaving any key for Term_xtra_gcu_event() to read
+ */
+static errr Term_wait_gcu(int ms) {
+	int i;
+
+	/* Show everything before waiting */
+	gcu_update(true);
+
+	timeout(ms);
+	i = getch();
+	timeout(-1);
+
+	if (i == ERR) return (1);
+	ungetch(i);
+	return (0);
+}
+
 /**
  * Process events, with optional wait
  */
@@ -532,6 +597,9 @@ static errr Term_xtra_gcu_event(int v) {
 	int i, j, k, mods=0;
 
 	if (v) {
+		/* Show everything before waiting */
+		gcu_update(true);
+
 		/* Wait for a keypress; use halfdelay(1) so if the user takes more */
 		/* than 0.2 seconds we get a chance to do updates. */
 		halfdelay(2);
@@ -539,9 +607,13 @@ static errr Term_xtra_gcu_event(int v) {
 		while (i == ERR) {
 			i = getch();
 			idle_update();
+			gcu_update(true);
 		}
 		cbreak();
 	} else {
+		/* Catch up on anything the frame cap held back */
+		gcu_update(false);
+
 		/* Do not wait for it */
 		nodelay(stdscr, true);
 
@@ -762,7 +834,11 @@ static errr Term_xtra_gcu(int n, int v) {
 		case TERM_XTRA_NOISE: write(1, "\007", 1); return 0;
 
 		/* Flush the Curses buffer */
-		case TERM_XTRA_FRESH: wrefresh(td->win); return 0;
+		case TERM_XTRA_FRESH:
+			wnoutrefresh(td->win);
+			update_pending = true;
+			gcu_update(false);
+			return 0;
 
 #ifdef USE_CURS_SET
 		/* Change the cursor visibility */
@@ -779,7 +855,10 @@ static errr Term_xtra_gcu(int n, int v) {
 		case TERM_XTRA_FLUSH: while (!Term_xtra_gcu_event(false)); return 0;
 
 		/* Delay */
-		case TERM_XTRA_DELAY: if (v > 0) usleep(1000 * v); return 0;
+		case TERM_XTRA_DELAY:
+			gcu_update(true);
+			if (v > 0) usleep(1000 * v);
+			return 0;
 
 		/* React to events */
 		case TERM_XTRA_REACT: Term_xtra_gcu_react(); return 0;
@@ -893,6 +972,7 @@ static errr term_data_init_gcu(term_data *td, int rows, int cols, int y, int x)
 	t->wipe_hook = Term_wipe_gcu;
 	t->curs_hook = Term_curs_gcu;
 	t->xtra_hook = Term_xtra_gcu;
+	t->wait_hook = Term_wait_gcu;
 
 	/* Save the data */
 	t->data = td;
@@ -983,6 +1063,9 @@ errr init_gcu(int argc, char **argv) {
 			term_count = atoi(&argv[i][2]);
 			if (term_count > MAX_TERM_DATA) term_count = MAX_TERM_DATA;
 			else if (term_count < 1) term_count = 1;
+		} else if (prefix(argv[i], "-f")) {
+			int fps = atoi(&argv[i][2]);
+			frame_ms = (fps > 0) ? 1000 / fps : 0;
 		}
 	}
 
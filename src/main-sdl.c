@@ -971,6 +971,7 @@ static void term_windowFree(term_window* win)
 }
 
 static errr save_prefs(void);
+static void tile_cache_flush(void);
 static void hook_quit(const char *str)
 {
 	int i;
@@ -987,6 +988,7 @@ static void hook_quit(const char *str)
 
 	/* Free the graphics surface */
 	if (GfxSurface) SDL_FreeSurface(GfxSurface);
+	tile_cache_flush();
 
 	close_graphics_modes();
 	if (GfxButtons) mem_free(GfxButtons);
@@ -2932,92 +2934,128 @@ static void sdl_StretchBlit(SDL_Surface *src, SDL_Rect *srcRect, SDL_Surface *de
 }
 
 /**
- * Make the 'pre-stretched' tiles for this window
- * Assumes the tiles surface was freed elsewhere
+ * Pre-stretched tile sheets for the current graphics, by tile size.  Windows
+ * with the same tile size share a sheet, and a size that comes back after a
+ * font change or a resize is not stretched again.  Each entry holds one
+ * reference to its surface, and each window using it another, so windows
+ * free theirs as before.
  */
-static errr sdl_BuildTileset(term_window *win)
+#define TILE_CACHE_MAX 8
+
+static struct tile_sheet
 {
-	int x, y;
-	int ta, td;
-	int xx, yy;
-	graphics_mode *info;
+	int wid, hgt;
+	SDL_Surface *tiles;
+} tile_cache[TILE_CACHE_MAX];
 
-	if (!GfxSurface) return (1);
+/* The entry to replace next once the cache is full */
+static int tile_cache_next = 0;
 
-	info = get_graphics_mode(use_graphics);
-	if (info->grafID == 0) return (1);
+/**
+ * Forget every pre-stretched sheet, as when the graphics change
+ */
+static void tile_cache_flush(void)
+{
+	int i;
+
+	for (i = 0; i < TILE_CACHE_MAX; i++) {
+		if (tile_cache[i].tiles) SDL_FreeSurface(tile_cache[i].tiles);
+		tile_cache[i].tiles = NULL;
+	}
+	tile_cache_next = 0;
+}
+
+/**
+ * Get the graphics with every tile stretched to dwid x dhgt, with a
+ * reference for the caller
+ */
+static SDL_Surface *sdl_StretchTiles(int dwid, int dhgt)
+{
+	int i;
+	int ta, td;
+	int xx, yy;
+	graphics_mode *info = get_graphics_mode(use_graphics);
+	struct tile_sheet *sheet;
+	SDL_Surface *tiles;
+
+	/* Already stretched */
+	for (i = 0; i < TILE_CACHE_MAX; i++) {
+		sheet = &tile_cache[i];
+		if (sheet->tiles && (sheet->wid == dwid) && (sheet->hgt == dhgt)) {
+			sheet->tiles->refcount++;
+			return sheet->tiles;
+		}
+	}
 
 	/* Calculate the number of tiles across & down*/
 	ta = GfxSurface->w / info->cell_width;
 	td = GfxSurface->h / info->cell_height;
 
-	/* Calculate the size of the new surface */
-	x = ta * win->tile_wid * tile_width;
-	y = td * win->tile_hgt * tile_height;
-
 	/* Make it */
-	win->tiles = SDL_CreateRGBSurface(SDL_SWSURFACE, x, y,
-									  GfxSurface->format->BitsPerPixel,
-									  GfxSurface->format->Rmask,
-									  GfxSurface->format->Gmask,
-									  GfxSurface->format->Bmask,
-									  GfxSurface->format->Amask);
+	tiles = SDL_CreateRGBSurface(SDL_SWSURFACE, ta * dwid, td * dhgt,
+								 GfxSurface->format->BitsPerPixel,
+								 GfxSurface->format->Rmask,
+								 GfxSurface->format->Gmask,
+								 GfxSurface->format->Bmask,
+								 GfxSurface->format->Amask);
 
 	/* Bugger */
-	if (!win->tiles) return (1);
+	if (!tiles) return NULL;
 
 	/* For every tile... */
 	for (xx = 0; xx < ta; xx++) {
 		for (yy = 0; yy < td; yy++) {
 			SDL_Rect src, dest;
-			int dwid = win->tile_wid * tile_width;
-			int dhgt = win->tile_hgt * tile_height;
 
 			/* Source rectangle (on GfxSurface) */
 			RECT(xx * info->cell_width, yy * info->cell_height,
 				 info->cell_width, info->cell_height, &src);
 
-			/* Destination rectangle (win->tiles) */
+			/* Destination rectangle (on the new sheet) */
 			RECT(xx * dwid, yy * dhgt, dwid, dhgt, &dest);
 
 			/* Do the stretch thing */
-			sdl_StretchBlit(GfxSurface, &src, win->tiles, &dest);
+			sdl_StretchBlit(GfxSurface, &src, tiles, &dest);
 		}
 	}
 
-	/* see if we need to make a seperate surface for the map view */
-	if (!((tile_width == 1) && (tile_height == 1))) {
-		/* Calculate the size of the new surface */
-		x = ta * win->tile_wid;
-		y = td * win->tile_hgt;
+	/* Keep it, in place of the oldest */
+	sheet = &tile_cache[tile_cache_next];
+	tile_cache_next = (tile_cache_next + 1) % TILE_CACHE_MAX;
+	if (sheet->tiles) SDL_FreeSurface(sheet->tiles);
+	sheet->wid = dwid;
+	sheet->hgt = dhgt;
+	sheet->tiles = tiles;
+	tiles->refcount++;
 
-		/* Make it */
-		win->onebyone = SDL_CreateRGBSurface(SDL_SWSURFACE, x, y,
-				GfxSurface->format->BitsPerPixel,
-				GfxSurface->format->Rmask, GfxSurface->format->Gmask,
-				GfxSurface->format->Bmask, GfxSurface->format->Amask);
+	return tiles;
+}
 
-		/* Bugger */
-		if (!win->onebyone) return (1);
+/**
+ * Make the 'pre-stretched' tiles for this window
+ * Assumes the tiles surface was freed elsewhere
+ */
+static errr sdl_BuildTileset(term_window *win)
+{
+	graphics_mode *info;
 
-		/* For every tile... */
-		for (xx = 0; xx < ta; xx++) {
-			for (yy = 0; yy < td; yy++) {
-				SDL_Rect src, dest;
-				int dwid = win->tile_wid;
-				int dhgt = win->tile_hgt;
+	if (!GfxSurface) return (1);
 
-				/* Source rectangle (on GfxSurface) */
-				RECT(xx * info->cell_width, yy * info->cell_height,
-					 info->cell_width, info->cell_height, &src);
+	info = get_graphics_mode(use_graphics);
+	if (info->grafID == 0) return (1);
 
-				/* Destination rectangle (win->tiles) */
-				RECT(xx * dwid, yy * dhgt, dwid, dhgt, &dest);
+	win->tiles = sdl_StretchTiles(win->tile_wid * tile_width,
+								  win->tile_hgt * tile_height);
 
-				/* Do the stretch thing */
-				sdl_StretchBlit(GfxSurface, &src, win->onebyone, &dest);
-			}
-		}
+	/* Bugger */
+	if (!win->tiles) return (1);
+
+	/* see if we need to make a seperate surface for the map view */
+	if (!((tile_width == 1) && (tile_height == 1))) {
+		win->onebyone = sdl_StretchTiles(win->tile_wid, win->tile_hgt);
+
+		/* Bugger */
+		if (!win->onebyone) return (1);
 	}
 
 	return (0);
@@ -3320,8 +3358,9 @@ static errr load_gfx(void)
 		filename = NULL;
 	}
 
-	/* Free the old surface */
+	/* Free the old surface, and everything stretched from it */
 	if (GfxSurface) SDL_FreeSurface(GfxSurface);
+	tile_cache_flush();
 
 	/* This may be called when GRAPHICS_NONE is set */
 	if (!filename) return (0);
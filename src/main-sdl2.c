@@ -561,6 +561,26 @@ struct font_info {
  * those are at the end of the file */
 const char help_sdl2[] = "SDL2 frontend";
 static SDL_Color g_colors[MAX_COLORS];
+
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+/* term_batch_hook() sorts the quads of a frame by what they are drawn
+ * from, so that each of these needs only one SDL_RenderGeometry() call */
+enum quad_layer {
+	QUAD_LAYER_FILL,
+	QUAD_LAYER_TILE,
+	QUAD_LAYER_GLYPH,
+
+	QUAD_LAYER_MAX
+};
+struct quad_batch {
+	SDL_Vertex *vertices;
+	int *indices;
+	/* number of quads; each has 4 vertices and 6 indices */
+	int num;
+	int size;
+};
+static struct quad_batch g_quad_batches[QUAD_LAYER_MAX];
+#endif
 static struct font_info g_font_info[MAX_FONTS];
 
 /* Forward declarations */
@@ -604,6 +624,7 @@ static void render_borders(struct subwindow *subwindow);
 static SDL_Texture *load_image(const struct window *window, const char *path);
 static void reload_all_graphics(graphics_mode *mode);
 static void free_graphics(struct graphics *graphics);
+static void free_tile_sheet(void);
 static void load_terms(void);
 static void load_term(struct subwindow *subwindow);
 static void clear_pw_flag(struct subwindow *subwindow);
@@ -3622,6 +3643,16 @@ static errr term_xtra_event(int v)
 	return 0;
 }
 
+static errr term_wait_hook(int ms)
+{
+	redraw_all_windows(true);
+
+	if (ms < 0) {
+		return SDL_WaitEvent(NULL) ? 0 : 1;
+	}
+	return SDL_WaitEventTimeout(NULL, ms) ? 0 : 1;
+}
+
 static errr term_xtra_flush(void)
 {
 	SDL_Event event;
@@ -3813,6 +3844,250 @@ static errr term_pict_hook(int col, int row, int n,
 	return 0;
 }
 
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+static void push_quad(struct quad_batch *batch, const SDL_Rect *dst,
+		const SDL_Rect *src, int tex_w, int tex_h, SDL_Color color)
+{
+	if (batch->num == batch->size) {
+		batch->size = batch->size ? batch->size * 2 : 256;
+		batch->vertices = mem_realloc(batch->vertices,
+				sizeof(*batch->vertices) * 4 * batch->size);
+		batch->indices = mem_realloc(batch->indices,
+				sizeof(*batch->indices) * 6 * batch->size);
+	}
+
+	SDL_Vertex *v = &batch->vertices[4 * batch->num];
+	int *i = &batch->indices[6 * batch->num];
+	int first = 4 * batch->num;
+
+	float x1 = (float) dst->x;
+	float y1 = (float) dst->y;
+	float x2 = (float) (dst->x + dst->w);
+	float y2 = (float) (dst->y + dst->h);
+
+	float u1 = 0.0f, v1 = 0.0f, u2 = 0.0f, v2 = 0.0f;
+	if (src != NULL) {
+		u1 = (float) src->x / tex_w;
+		v1 = (float) src->y / tex_h;
+		u2 = (float) (src->x + src->w) / tex_w;
+		v2 = (float) (src->y + src->h) / tex_h;
+	}
+
+	v[0] = (SDL_Vertex) {{x1, y1}, color, {u1, v1}};
+	v[1] = (SDL_Vertex) {{x2, y1}, color, {u2, v1}};
+	v[2] = (SDL_Vertex) {{x2, y2}, color, {u2, v2}};
+	v[3] = (SDL_Vertex) {{x1, y2}, color, {u1, v2}};
+
+	i[0] = first;
+	i[1] = first + 1;
+	i[2] = first + 2;
+	i[3] = first;
+	i[4] = first + 2;
+	i[5] = first + 3;
+
+	batch->num++;
+}
+
+/* does not SetRenderTarget */
+static void render_quad_batch(const struct window *window,
+		SDL_Texture *texture, struct quad_batch *batch)
+{
+	if (batch->num > 0) {
+		SDL_RenderGeometry(window->renderer, texture,
+				batch->vertices, 4 * batch->num,
+				batch->indices, 6 * batch->num);
+	}
+
+	batch->num = 0;
+}
+
+static void free_quad_batches(void)
+{
+	for (size_t i = 0; i < N_ELEMENTS(g_quad_batches); i++) {
+		mem_free(g_quad_batches[i].vertices);
+		mem_free(g_quad_batches[i].indices);
+		memset(&g_quad_batches[i], 0, sizeof(g_quad_batches[i]));
+	}
+}
+
+/* the same as render_tile_font_scaled(), but only queues the tile */
+static void push_tile_quad(const struct subwindow *subwindow,
+		int col, int row, int a, int c, int tex_w, int tex_h)
+{
+	struct graphics *graphics = &subwindow->window->graphics;
+	SDL_Color white = {0xFF, 0xFF, 0xFF, 0xFF};
+
+	SDL_Rect dst = {
+		subwindow->inner_rect.x + col * subwindow->font_width,
+		subwindow->inner_rect.y + row * subwindow->font_height,
+		subwindow->font_width * tile_width,
+		subwindow->font_height * tile_height
+	};
+
+	SDL_Rect src = {0, 0, graphics->tile_pixel_w, graphics->tile_pixel_h};
+
+	int src_row = a & 0x7f;
+	int src_col = c & 0x7f;
+
+	src.x = src_col * src.w;
+	src.y = src_row * src.h;
+
+	if (graphics->overdraw_row != 0
+			&& row > 2
+			&& src_row >= graphics->overdraw_row
+			&& src_row <= graphics->overdraw_max)
+	{
+		src.y -= src.h;
+		dst.y -= dst.h;
+		dst.h *= 2;
+		src.h *= 2;
+
+		Term_mark(col, row - tile_height);
+		Term_mark(col, row);
+	}
+
+	push_quad(&g_quad_batches[QUAD_LAYER_TILE], &dst, &src, tex_w, tex_h, white);
+}
+
+static SDL_Color get_text_bg_color(const struct subwindow *subwindow, int a)
+{
+	SDL_Color bg;
+
+	switch (a / MAX_COLORS) {
+		case BG_BLACK:
+			bg = subwindow->color;
+			break;
+		case BG_SAME:
+			bg = g_colors[a % MAX_COLORS];
+			break;
+		case BG_DARK:
+			bg = g_colors[DEFAULT_SHADE_COLOR];
+			break;
+		default:
+			/* debugging */
+			bg = g_colors[DEFAULT_ERROR_COLOR];
+			break;
+	}
+
+	bg.a = subwindow->color.a;
+
+	return bg;
+}
+
+/* draws a whole frame of changed grids with (at most) one SDL_RenderGeometry()
+ * call for the backgrounds, one for the tiles and one for the cached glyphs;
+ * they are drawn in that order, so the frame looks the same as when it
+ * is drawn one run at a time by the wipe, text and pict hooks */
+static errr term_batch_hook(const struct term_glyph *glyphs, int n)
+{
+	struct subwindow *subwindow = Term->data;
+	assert(subwindow != NULL);
+
+	struct window *window = subwindow->window;
+	struct font *font = subwindow->font;
+
+	int tile_tex_w = 0, tile_tex_h = 0;
+	if (window->graphics.texture != NULL) {
+		SDL_QueryTexture(window->graphics.texture,
+				NULL, NULL, &tile_tex_w, &tile_tex_h);
+	}
+	int glyph_tex_w = 0, glyph_tex_h = 0;
+	SDL_QueryTexture(font->cache.texture,
+			NULL, NULL, &glyph_tex_w, &glyph_tex_h);
+
+	bool uncached = false;
+
+	for (int i = 0; i < n; i++) {
+		const struct term_glyph *g = &glyphs[i];
+
+		SDL_Rect dst = {
+			subwindow->inner_rect.x + g->x * subwindow->font_width,
+			subwindow->inner_rect.y + g->y * subwindow->font_height,
+			subwindow->font_width,
+			subwindow->font_height
+		};
+
+		if (Term->higher_pict && (g->a & 0x80)) {
+			/* 2nd byte of bigtile */
+			if (g->a == 255) {
+				continue;
+			}
+
+			assert(window->graphics.texture != NULL);
+
+			dst.w *= tile_width;
+			dst.h *= tile_height;
+			push_quad(&g_quad_batches[QUAD_LAYER_FILL],
+					&dst, NULL, 0, 0, subwindow->color);
+
+			push_tile_quad(subwindow, g->x, g->y, g->ta, g->tc,
+					tile_tex_w, tile_tex_h);
+			if (g->ta != g->a || g->tc != g->c) {
+				push_tile_quad(subwindow, g->x, g->y, g->a, g->c,
+						tile_tex_w, tile_tex_h);
+			}
+		} else if (g->a == 0 && !Term->always_text) {
+			push_quad(&g_quad_batches[QUAD_LAYER_FILL],
+					&dst, NULL, 0, 0, subwindow->color);
+		} else {
+			SDL_Color bg = get_text_bg_color(subwindow, g->a);
+			push_quad(&g_quad_batches[QUAD_LAYER_FILL],
+					&dst, NULL, 0, 0, bg);
+
+			uint32_t codepoint = (uint32_t) g->c;
+			if (codepoint == DEFAULT_CHAR_BLANK) {
+				continue;
+			}
+			if (!IS_CACHED_ASCII_CODEPOINT(codepoint)) {
+				/* drawn one by one after the batches */
+				uncached = true;
+				continue;
+			}
+
+			SDL_Rect src = font->cache.rects[codepoint];
+			dst.w = font->ttf.glyph.w;
+			dst.h = font->ttf.glyph.h;
+			crop_rects(&src, &dst);
+
+			push_quad(&g_quad_batches[QUAD_LAYER_GLYPH], &dst, &src,
+					glyph_tex_w, glyph_tex_h, g_colors[g->a % MAX_COLORS]);
+		}
+	}
+
+	SDL_SetRenderTarget(window->renderer, subwindow->texture);
+
+	render_quad_batch(window, NULL, &g_quad_batches[QUAD_LAYER_FILL]);
+	render_quad_batch(window, window->graphics.texture,
+			&g_quad_batches[QUAD_LAYER_TILE]);
+	/* render_glyph_mono() leaves its color in the texture;
+	 * here the color comes from the vertices */
+	SDL_SetTextureColorMod(font->cache.texture, 0xFF, 0xFF, 0xFF);
+	render_quad_batch(window, font->cache.texture,
+			&g_quad_batches[QUAD_LAYER_GLYPH]);
+
+	for (int i = 0; uncached && i < n; i++) {
+		const struct term_glyph *g = &glyphs[i];
+		uint32_t codepoint = (uint32_t) g->c;
+
+		if ((Term->higher_pict && (g->a & 0x80))
+				|| (g->a == 0 && !Term->always_text)
+				|| codepoint == DEFAULT_CHAR_BLANK
+				|| IS_CACHED_ASCII_CODEPOINT(codepoint)) {
+			continue;
+		}
+
+		render_glyph_mono(window, font, subwindow->texture,
+				subwindow->inner_rect.x + g->x * subwindow->font_width,
+				subwindow->inner_rect.y + g->y * subwindow->font_height,
+				&g_colors[g->a % MAX_COLORS], codepoint);
+	}
+
+	window->dirty = true;
+
+	return 0;
+}
+#endif
+
 static void term_view_map_shared(struct subwindow *subwindow,
 		SDL_Texture *map, int w, int h)
 {
@@ -4039,6 +4314,38 @@ static void load_default_window_icon(const struct window *window)
 	SDL_FreeSurface(surface);
 }
 
+/* The tile sheet last decoded; every window makes its texture from it, so a
+ * graphics change decodes the file once rather than once per window */
+static struct {
+	char path[4096];
+	SDL_Surface *surface;
+} g_tile_sheet;
+
+static SDL_Surface *load_tile_sheet(const char *path)
+{
+	if (g_tile_sheet.surface != NULL && streq(g_tile_sheet.path, path)) {
+		return g_tile_sheet.surface;
+	}
+
+	free_tile_sheet();
+
+	g_tile_sheet.surface = IMG_Load(path);
+	if (g_tile_sheet.surface == NULL) {
+		quit_fmt("cant load image '%s': %s", path, IMG_GetError());
+	}
+	my_strcpy(g_tile_sheet.path, path, sizeof(g_tile_sheet.path));
+
+	return g_tile_sheet.surface;
+}
+
+static void free_tile_sheet(void)
+{
+	if (g_tile_sheet.surface != NULL) {
+		SDL_FreeSurface(g_tile_sheet.surface);
+		g_tile_sheet.surface = NULL;
+	}
+}
+
 static void load_graphics(struct window *window, graphics_mode *mode)
 {
 	assert(window->graphics.texture == NULL);
@@ -4056,8 +4363,11 @@ static void load_graphics(struct window *window, graphics_mode *mode)
 			quit_fmt("cant load graphcis: file '%s' doesnt exist", path);
 		}
 
-		window->graphics.texture = load_image(window, path);
-		assert(window->graphics.texture != NULL);
+		window->graphics.texture = SDL_CreateTextureFromSurface(window->renderer,
+				load_tile_sheet(path));
+		if (window->graphics.texture == NULL) {
+			quit_fmt("cant create texture from image '%s': %s", path, SDL_GetError());
+		}
 
 		window->graphics.tile_pixel_w = mode->cell_width;
 		window->graphics.tile_pixel_h = mode->cell_height;
@@ -5129,11 +5439,15 @@ static void link_term(struct subwindow *subwindow)
 	subwindow->term->char_blank = DEFAULT_CHAR_BLANK;
 
 	subwindow->term->xtra_hook = term_xtra_hook;
+	subwindow->term->wait_hook = term_wait_hook;
 	subwindow->term->curs_hook = term_curs_hook;
 	subwindow->term->bigcurs_hook = term_bigcurs_hook;
 	subwindow->term->wipe_hook = term_wipe_hook;
 	subwindow->term->text_hook = term_text_hook;
 	subwindow->term->pict_hook = term_pict_hook;
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+	subwindow->term->batch_hook = term_batch_hook;
+#endif
 	subwindow->term->view_map_hook = term_view_map_hook;
 
 	subwindow->term->data = subwindow;
@@ -5656,6 +5970,10 @@ static void free_globals(void)
 		assert(!g_subwindows[i].loaded);
 		assert(!g_subwindows[i].linked);
 	}
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+	free_quad_batches();
+#endif
+	free_tile_sheet();
 }
 
 static void start_windows(void)
@@ -42,6 +42,9 @@
 #include "store.h"
 #include <stddef.h>
 #include <time.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
 
 #define OBJ_FEEL_MAX	 11
 #define MON_FEEL_MAX 	 10
@@ -66,13 +69,25 @@
 static int randarts = 0;
 static int no_selling = 0;
 static u32b num_runs = 1;
+static u32b first_run = 1;
+static int num_workers = 1;
+static u32b seed_base;
+static bool seed_given = false;
+static const char *shard_path = NULL;
+static const char **merge_paths = NULL;
+static int num_merges = 0;
 static bool quiet = false;
 static int nextkey = 0;
 static int running_stats = 0;
 static char *ANGBAND_DIR_STATS;
 
+static bool csv_output = false;
+static bool wal_mode = false;
+
 static int *consumables_index;
 static int *wearables_index;
+static int *consumables_kidx;
+static int *wearables_kidx;
 static int wearable_count = 0;
 static int consumable_count = 0;
 
@@ -97,7 +112,10 @@ static struct level_data {
 	long long gold[ORIGIN_STATS];
 	u32b *artifacts[ORIGIN_STATS];
 	u32b *consumables[ORIGIN_STATS];
-	struct wearables_data *wearables[ORIGIN_STATS];
+
+	/* Most kinds are never found at a given depth from a given origin, so
+	 * these are only made when one is */
+	struct wearables_data **wearables[ORIGIN_STATS];
 } level_data[LEVEL_MAX];
 
 static void create_indices()
@@ -121,11 +139,48 @@ static void create_indices()
 		else
 			consumables_index[i] = ++consumable_count;
 	}
+
+	/* And the other way; unused slots say where they are, negated */
+	consumables_kidx = mem_zalloc((consumable_count + 1) * sizeof(int));
+	wearables_kidx = mem_zalloc((wearable_count + 1) * sizeof(int));
+	for (i = 0; i <= consumable_count; i++)
+		consumables_kidx[i] = -i;
+	for (i = 0; i <= wearable_count; i++)
+		wearables_kidx[i] = -i;
+	for (i = z_info->k_max - 1; i >= 0; i--) {
+		consumables_kidx[consumables_index[i]] = i;
+		wearables_kidx[wearables_index[i]] = i;
+	}
+}
+
+/**
+ * Make the counters for one kind of wearable at one depth from one origin
+ */
+static struct wearables_data *stats_new_wearables(void)
+{
+	struct wearables_data *w = mem_zalloc(sizeof(*w));
+	int l;
+
+	w->egos = mem_zalloc(z_info->e_max * sizeof(u32b));
+	for (l = 0; l < TOP_MOD; l++)
+		w->modifiers[l] = mem_zalloc((OBJ_MOD_MAX + 1) * sizeof(u32b));
+	return w;
+}
+
+static void stats_free_wearables(struct wearables_data *w)
+{
+	int l;
+
+	if (!w) return;
+	for (l = 0; l < TOP_MOD; l++)
+		mem_free(w->modifiers[l]);
+	mem_free(w->egos);
+	mem_free(w);
 }
 
 static void alloc_memory()
 {
-	int i, j, k, l;
+	int i, j;
 
 	for (i = 0; i < LEVEL_MAX; i++) {
 		level_data[i].monsters = mem_zalloc(z_info->r_max * sizeof(u32b));
@@ -139,22 +194,14 @@ static void alloc_memory()
 													  sizeof(u32b));
 			level_data[i].wearables[j]
 				= mem_zalloc((wearable_count + 1) *
-							 sizeof(struct wearables_data));
-
-			for (k = 0; k < wearable_count + 1; k++) {
-				level_data[i].wearables[j][k].egos
-					= mem_zalloc(z_info->e_max * sizeof(u32b));
-				for (l = 0; l < TOP_MOD; l++)
-					level_data[i].wearables[j][k].modifiers[l]
-						= mem_zalloc((OBJ_MOD_MAX + 1) * sizeof(u32b));
-			}
+							 sizeof(struct wearables_data *));
 		}
 	}
 }
 
 static void free_stats_memory(void)
 {
-	int i, j, k, l;
+	int i, j, k;
 	for (i = 0; i < LEVEL_MAX; i++) {
 		mem_free(level_data[i].monsters);
 /*		mem_free(level_data[i].vaults);
@@ -162,17 +209,15 @@ static void free_stats_memory(void)
 		for (j = 0; j < ORIGIN_STATS; j++) {
 			mem_free(level_data[i].artifacts[j]);
 			mem_free(level_data[i].consumables[j]);
-			for (k = 0; k < wearable_count + 1; k++) {
-				for (l = 0; l < TOP_MOD; l++) {
-					mem_free(level_data[i].wearables[j][k].modifiers[l]);
-				}
-				mem_free(level_data[i].wearables[j][k].egos);
-			}
+			for (k = 0; k < wearable_count + 1; k++)
+				stats_free_wearables(level_data[i].wearables[j][k]);
 			mem_free(level_data[i].wearables[j]);
 		}
 	}
 	mem_free(consumables_index);
 	mem_free(wearables_index);
+	mem_free(consumables_kidx);
+	mem_free(wearables_kidx);
 	string_free(ANGBAND_DIR_STATS);
 }
 
@@ -213,18 +258,19 @@ static void generate_player_for_stats()
 	player->history = get_history(player->race->history);
 }
 
-static void initialize_character(void)
+/**
+ * Set up the character for the given run; each run gets its own seed, so
+ * that runs started in the same second, or in different workers, differ
+ */
+static void initialize_character(u32b run)
 {
-	u32b seed;
-
 	if (!quiet) {
 		printf(" [I  ]\b\b\b\b\b\b");
 		fflush(stdout);
 	}
 
-	seed = (time(NULL));
 	Rand_quick = false;
-	Rand_state_init(seed);
+	Rand_state_init(seed_base + run);
 
 	player_init(player);
 	generate_player_for_stats();
@@ -252,6 +298,12 @@ static void kill_all_monsters(int level)
 
 		level_data[level].monsters[mon->race->ridx]++;
 
+		/* Mimicked objects are still on the floor, so take them off first */
+		if (mon->mimicked_obj) {
+			square_excise_object(cave, mon->grid, mon->mimicked_obj);
+			delist_object(cave, mon->mimicked_obj);
+		}
+
 		monster_death(mon, true);
 
 		if (rf_has(mon->race->flags, RF_UNIQUE))
@@ -302,6 +354,9 @@ static void log_all_objects(int level)
 			for (obj = square_object(cave, grid); obj; obj = obj->next) {
 				/*	u32b o_power = 0; */
 
+				/* Only the first ORIGIN_STATS origins are counted */
+				if (obj->origin >= ORIGIN_STATS) continue;
+
 /*				o_power = object_power(obj, false, NULL, true); */
 
 				/* Capture gold amounts */
@@ -314,9 +369,12 @@ static void log_all_objects(int level)
 
 				/* Capture kind details */
 				if (tval_has_variable_power(obj)) {
-					struct wearables_data *w
+					struct wearables_data **slot
 						= &level_data[level].wearables[obj->origin][wearables_index[obj->kind->kidx]];
+					struct wearables_data *w;
 
+					if (!*slot) *slot = stats_new_wearables();
+					w = *slot;
 					w->count++;
 					w->dice[MIN(obj->dd, TOP_DICE - 1)][MIN(obj->ds, TOP_SIDES - 1)]++;
 					w->ac[MIN(MAX(obj->ac + obj->to_a, 0), TOP_AC - 1)]++;
@@ -810,11 +868,11 @@ static int stats_dump_lists(void)
 	STATS_DB_FINALIZE(sql_stmt)
 
 	err = stats_db_stmt_prep(&sql_stmt, 
-		"INSERT INTO object_flags_list VALUES(?,?);");
+		"INSERT INTO object_flags_list(idx, name) VALUES(?,?);");
 	if (err) return err;
 
 	for (idx = 0; idx < OF_MAX; idx++) {
-		err = stats_db_bind_ints(sql_stmt, 1, idx);
+		err = stats_db_bind_ints(sql_stmt, 1, 0, idx);
 		if (err) return err;
 		err = sqlite3_bind_text(sql_stmt, 2, object_flag_names[idx],
 			strlen(object_flag_names[idx]), SQLITE_STATIC);
@@ -825,11 +883,11 @@ static int stats_dump_lists(void)
 	STATS_DB_FINALIZE(sql_stmt)
 
 	err = stats_db_stmt_prep(&sql_stmt, 
-		"INSERT INTO object_mods_list VALUES(?,?);");
+		"INSERT INTO object_mods_list(idx, name) VALUES(?,?);");
 	if (err) return err;
 
 	for (idx = 0; object_mods[idx] != NULL; idx++) {
-		err = stats_db_bind_ints(sql_stmt, 1, idx);
+		err = stats_db_bind_ints(sql_stmt, 1, 0, idx);
 		if (err) return err;
 		err = sqlite3_bind_text(sql_stmt, 2, object_mods[idx],
 			strlen(object_mods[idx]), SQLITE_STATIC);
@@ -963,6 +1021,11 @@ static bool stats_prep_db(void)
 	status = stats_db_open();
 	if (!status) return status;
 
+	if (wal_mode) {
+		err = stats_db_exec("PRAGMA journal_mode=WAL;");
+		if (err) return false;
+	}
+
 	/* Create some tables */
 	err = stats_db_exec("CREATE TABLE metadata(field TEXT UNIQUE NOT NULL, value TEXT);");
 	if (err) return false;
@@ -1136,30 +1199,101 @@ static int stats_wearables_data_offsetof(const char *member)
 }
 
 /**
- * Given a pointer to a dynamically allocated array and a value, look up
- * the index with that value; e.g. given wearables_index[k_idx], return k_idx.
- * If not found, return -1 * value.
+ * Count tables are written either through a prepared statement, which is
+ * kept from one checkpoint to the next, or as a CSV file next to the
+ * database, rewritten in full at each checkpoint.
  */
+struct stats_sink {
+	sqlite3_stmt *stmt;
+	ang_file *csv;
+	int cols;
+};
 
-static int stats_lookup_index(const int *index, int max_idx, int value)
+static int stats_sink_open(struct stats_sink *sink, const char *table,
+						   int cols)
 {
-	int idx;
+	char sql_buf[256];
+	char buf[1024];
+	sqlite3_stmt *names;
+	size_t len;
+	int err, i;
+
+	sink->stmt = NULL;
+	sink->csv = NULL;
+	sink->cols = cols;
+
+	if (!csv_output) {
+		strnfmt(sql_buf, 256, "INSERT INTO %s VALUES(?", table);
+		for (i = 1; i < cols; i++)
+			my_strcat(sql_buf, ",?", sizeof(sql_buf));
+		my_strcat(sql_buf, ");", sizeof(sql_buf));
+		return stats_db_stmt_cached(&sink->stmt, sql_buf);
+	}
+
+	/* Name the file after the database */
+	my_strcpy(buf, stats_db_filename(), sizeof(buf));
+	len = strlen(buf);
+	if (len > 3 && streq(buf + len - 3, ".db"))
+		buf[len - 3] = '\0';
+	my_strcat(buf, format("-%s.csv", table), sizeof(buf));
+	sink->csv = file_open(buf, MODE_WRITE, FTYPE_TEXT);
+	if (!sink->csv) return SQLITE_CANTOPEN;
+
+	/* The header comes from the table definition */
+	strnfmt(sql_buf, 256, "SELECT * FROM %s;", table);
+	err = stats_db_stmt_prep(&names, sql_buf);
+	if (err) return err;
+	for (i = 0; i < sqlite3_column_count(names); i++)
+		file_putf(sink->csv, "%s%s", i ? "," : "",
+				  sqlite3_column_name(names, i));
+	file_put(sink->csv, "\n");
+
+	return sqlite3_finalize(names);
+}
+
+/**
+ * Write a row of sink->cols ints
+ */
+static int stats_sink_row(struct stats_sink *sink, ...)
+{
+	va_list vp;
+	int err = SQLITE_OK;
+	int col;
+
+	va_start(vp, sink);
+	for (col = 1; col <= sink->cols; col++) {
+		u32b value = va_arg(vp, u32b);
+		if (sink->csv) {
+			file_putf(sink->csv, col > 1 ? ",%d" : "%d", (int) value);
+		} else {
+			err = sqlite3_bind_int(sink->stmt, col, value);
+			if (err) break;
+		}
+	}
+	va_end(vp);
+	if (err) return err;
 
-	for (idx = 0; idx < max_idx; idx ++) {
-		if (index[idx] == value) return idx;
+	if (sink->csv) {
+		file_put(sink->csv, "\n");
+		return SQLITE_OK;
 	}
 
-	return -1 * value;
+	STATS_DB_STEP_RESET(sink->stmt)
+	return SQLITE_OK;
+}
+
+static int stats_sink_close(struct stats_sink *sink)
+{
+	if (sink->csv && !file_close(sink->csv)) return SQLITE_IOERR;
+	return SQLITE_OK;
 }
 
 static int stats_write_db_level_data(const char *table, int max_idx)
 {
-	char sql_buf[256];
-	sqlite3_stmt *sql_stmt;
+	struct stats_sink sink;
 	int err, level, i, offset;
 
-	strnfmt(sql_buf, 256, "INSERT INTO %s VALUES(?,?,?);", table);
-	err = stats_db_stmt_prep(&sql_stmt, sql_buf);
+	err = stats_sink_open(&sink, table, 3);
 	if (err) return err;
 
 	offset = stats_level_data_offsetof(table);
@@ -1171,30 +1305,27 @@ static int stats_write_db_level_data(const char *table, int max_idx)
 			u32b count;
 			if (streq(table, "gold"))
 				count = *((long long *)((byte *)&level_data[level] + offset) + i);
+			else if (streq(table, "monsters"))
+				count = level_data[level].monsters[i];
 			else
 				count = *((u32b *)((byte *)&level_data[level] + offset) + i);
 
 			if (!count) continue;
 
-			err = stats_db_bind_ints(sql_stmt, 3, 0,
-				level, count, i);
+			err = stats_sink_row(&sink, level, count, i);
 			if (err) return err;
-
-			STATS_DB_STEP_RESET(sql_stmt)
 		}
 
-	return sqlite3_finalize(sql_stmt);
+	return stats_sink_close(&sink);
 }
 
 static int stats_write_db_level_data_items(const char *table, int max_idx, 
 	bool translate_consumables)
 {
-	char sql_buf[256];
-	sqlite3_stmt *sql_stmt;
+	struct stats_sink sink;
 	int err, level, origin, i, offset;
 
-	strnfmt(sql_buf, 256, "INSERT INTO %s VALUES(?,?,?,?);", table);
-	err = stats_db_stmt_prep(&sql_stmt, sql_buf);
+	err = stats_sink_open(&sink, table, 4);
 	if (err) return err;
 
 	offset = stats_level_data_offsetof(table);
@@ -1207,45 +1338,40 @@ static int stats_write_db_level_data_items(const char *table, int max_idx,
 				u32b count = ((u32b **)((byte *)&level_data[level] + offset))[origin][i];
 				if (!count) continue;
 				
-				err = stats_db_bind_ints(sql_stmt, 4, 0, level, count, translate_consumables ? stats_lookup_index(consumables_index, z_info->k_max, i) : i, origin);
+				err = stats_sink_row(&sink, level, count, translate_consumables ? consumables_kidx[i] : i, origin);
 				if (err) return err;
-
-				STATS_DB_STEP_RESET(sql_stmt)
 			}
 
-	return sqlite3_finalize(sql_stmt);
+	return stats_sink_close(&sink);
 }
 
 static int stats_write_db_wearables_count(void)
 {
-	sqlite3_stmt *sql_stmt;
+	struct stats_sink sink;
 	int err, level, origin, k_idx, idx;
 
-	err = stats_db_stmt_prep(&sql_stmt, 
-		"INSERT INTO wearables_count VALUES(?,?,?,?);");
+	err = stats_sink_open(&sink, "wearables_count", 4);
 	if (err) return err;
 
 	for (level = 1; level < LEVEL_MAX; level++)
 		for (origin = 0; origin < ORIGIN_STATS; origin++)
 			for (idx = 0; idx < wearable_count + 1; idx++) {
-				u32b count = level_data[level].wearables[origin][idx].count;
+				struct wearables_data *w = level_data[level].wearables[origin][idx];
+				u32b count = w ? w->count : 0;
+
 				/* Skip if object did not appear */
 				if (!count) continue;
 
-				k_idx = stats_lookup_index(wearables_index, 
-					z_info->k_max, idx);
+				k_idx = wearables_kidx[idx];
 
 				/* Skip if pile */
 				if (! k_idx) continue;
 
-				err = stats_db_bind_ints(sql_stmt, 4, 0,
-					level, count, k_idx, origin);
+				err = stats_sink_row(&sink, level, count, k_idx, origin);
 				if (err) return err;
-
-				STATS_DB_STEP_RESET(sql_stmt)
 			}
 
-	return sqlite3_finalize(sql_stmt);
+	return stats_sink_close(&sink);
 }
 
 /**
@@ -1256,12 +1382,12 @@ static int stats_write_db_wearables_count(void)
  */
 static int stats_write_db_wearables_array(const char *field, int max_val, bool array_p)
 {
-	char sql_buf[256];
-	sqlite3_stmt *sql_stmt;
+	char table[256];
+	struct stats_sink sink;
 	int err, level, origin, idx, k_idx, i, offset;
 
-	strnfmt(sql_buf, 256, "INSERT INTO wearables_%s VALUES(?,?,?,?,?);", field);
-	err = stats_db_stmt_prep(&sql_stmt, sql_buf);
+	strnfmt(table, 256, "wearables_%s", field);
+	err = stats_sink_open(&sink, table, 5);
 	if (err) return err;
 
 	offset = stats_wearables_data_offsetof(field);
@@ -1269,32 +1395,30 @@ static int stats_write_db_wearables_array(const char *field, int max_val, bool a
 	for (level = 1; level < LEVEL_MAX; level++)
 		for (origin = 0; origin < ORIGIN_STATS; origin++)
 			for (idx = 0; idx < wearable_count + 1; idx++) {
-				k_idx = stats_lookup_index(wearables_index, 
-					z_info->k_max, idx);
+				struct wearables_data *w = level_data[level].wearables[origin][idx];
 
-				/* Skip if pile */
-				if (! k_idx) continue;
+				k_idx = wearables_kidx[idx];
+
+				/* Skip if pile, or if the object did not appear */
+				if (!k_idx || !w) continue;
 
 				for (i = 0; i < max_val; i++) {
 					/* This arcane expression finds the value of
-					 * level_data[level].wearables[origin][idx].<field>[i] */
+					 * level_data[level].wearables[origin][idx]-><field>[i] */
 					u32b count;
 					if (array_p)
-						count = ((u32b *)((byte *)&level_data[level].wearables[origin][idx] + offset))[i];
+						count = ((u32b *)((byte *)w + offset))[i];
 					else
-						count = ((u32b *)*((u32b **)((byte *)&level_data[level].wearables[origin][idx] + offset)))[i];
+						count = ((u32b *)*((u32b **)((byte *)w + offset)))[i];
 
 					if (!count) continue;
 
-					err = stats_db_bind_ints(sql_stmt, 5, 0,
-						level, count, k_idx, origin, i);
+					err = stats_sink_row(&sink, level, count, k_idx, origin, i);
 					if (err) return err;
-
-					STATS_DB_STEP_RESET(sql_stmt)
 				}
 			}
 
-	return sqlite3_finalize(sql_stmt);
+	return stats_sink_close(&sink);
 }
 
 /**
@@ -1306,13 +1430,12 @@ static int stats_write_db_wearables_array(const char *field, int max_val, bool a
 static int stats_write_db_wearables_2d_array(const char *field, 
 	int max_val1, int max_val2, bool array_p)
 {
-	char sql_buf[256];
-	sqlite3_stmt *sql_stmt;
+	char table[256];
+	struct stats_sink sink;
 	int err, level, origin, idx, k_idx, i, j, offset;
 
-	strnfmt(sql_buf, 256, "INSERT INTO wearables_%s VALUES(?,?,?,?,?,?);",
-			field);
-	err = stats_db_stmt_prep(&sql_stmt, sql_buf);
+	strnfmt(table, 256, "wearables_%s", field);
+	err = stats_sink_open(&sink, table, 6);
 	if (err) return err;
 
 	offset = stats_wearables_data_offsetof(field);
@@ -1320,38 +1443,36 @@ static int stats_write_db_wearables_2d_array(const char *field,
 	for (level = 1; level < LEVEL_MAX; level++)
 		for (origin = 0; origin < ORIGIN_STATS; origin++)
 			for (idx = 0; idx < wearable_count + 1; idx++) {
-				k_idx = stats_lookup_index(wearables_index, 
-					z_info->k_max, idx);
+				struct wearables_data *w = level_data[level].wearables[origin][idx];
 
-				/* Skip if pile */
-				if (! k_idx) continue;
+				k_idx = wearables_kidx[idx];
+
+				/* Skip if pile, or if the object did not appear */
+				if (!k_idx || !w) continue;
 
 				for (i = 0; i < max_val1; i++)
 					for (j = 0; j < max_val2; j++) {
 						/* This arcane expression finds the value of
-				 		* level_data[level].wearables[origin][idx].<field>[i][j]
+				 		* level_data[level].wearables[origin][idx]-><field>[i][j]
 						*/
 						u32b count;
 
 						if (i == 0 && j == 0) continue;
 
 						if (array_p)
-							count = ((u32b *)((byte *)&level_data[level].wearables[origin][idx] + offset))[i * max_val2 + j];
+							count = ((u32b *)((byte *)w + offset))[i * max_val2 + j];
 						else
-							count = *(*((u32b **)((byte *)&level_data[level].wearables[origin][idx] + offset) + i) + j);
+							count = *(*((u32b **)((byte *)w + offset) + i) + j);
 
 						if (!count) continue;
 
-						err = stats_db_bind_ints(sql_stmt, 6, 0,
-							level, count, k_idx, origin, 
-							i, j);
+						err = stats_sink_row(&sink, level, count, k_idx,
+											 origin, i, j);
 						if (err) return err;
-
-						STATS_DB_STEP_RESET(sql_stmt)
 					}
 			}
 
-	return sqlite3_finalize(sql_stmt);
+	return stats_sink_close(&sink);
 }
 
 static int stats_write_db(u32b run)
@@ -1421,18 +1542,18 @@ static int stats_write_db(u32b run)
 }
 
 /**
- * Call with the number of runs that have been completed.
+ * Call with the number of runs that have been completed out of `runs`.
  */
 
 #define STATS_PROGRESS_BAR_LEN 30
 
-void progress_bar(u32b run, time_t start) {
+void progress_bar(u32b run, u32b runs, time_t start) {
 	u32b i;
-	u32b n = (run * STATS_PROGRESS_BAR_LEN) / num_runs;
-	u32b p10 = ((long long)run * 1000) / num_runs;
+	u32b n = (run * STATS_PROGRESS_BAR_LEN) / runs;
+	u32b p10 = ((long long)run * 1000) / runs;
 
 	time_t delta = time(NULL) - start;
-	u32b togo = num_runs - run;
+	u32b togo = runs - run;
 	u32b expect = delta ? ((long long)delta * (long long)togo) / run 
 		: 0;
 
@@ -1443,11 +1564,33 @@ void progress_bar(u32b run, time_t start) {
 	printf("\r|");
 	for (i = 0; i < n; i++) printf("*");
 	for (i = 0; i < STATS_PROGRESS_BAR_LEN - n; i++) printf(" ");
-	printf("| %d/%d (%5.1f%%) %3d:%02d:%02d ", run, num_runs, p10/10.0, h, m,
+	printf("| %d/%d (%5.1f%%) %3d:%02d:%02d ", run, runs, p10/10.0, h, m,
 		   s);
 	fflush(stdout);
 }
 
+/**
+ * Show the memory allocated by each part of the game, if it was counted
+ */
+static void stats_print_memory(void)
+{
+	int i;
+
+	if (!(mem_flags & MEM_ACCOUNT)) return;
+
+	printf("\n%-10s %10s %10s %10s %10s\n", "Memory", "KB", "peak KB",
+		   "allocs", "frees");
+	for (i = 0; i < MEM_TAG_MAX; i++) {
+		struct mem_tag_stats stats;
+
+		mem_tag_get_stats(i, &stats);
+		printf("%-10s %10.1f %10.1f %10lu %10lu\n", mem_tag_name(i),
+			   stats.bytes / 1024.0, stats.peak / 1024.0,
+			   (unsigned long) stats.allocs, (unsigned long) stats.frees);
+	}
+	fflush(stdout);
+}
+
 /**
  * Clean up memory after each run. Should only affect character and
  * dungeon structs allocated during normal initialization, not persistent 
@@ -1456,63 +1599,281 @@ void progress_bar(u32b run, time_t start) {
 
 static void stats_cleanup_angband_run(void)
 {
-	if (player->history) mem_free(player->history);
+	string_free(player->history);
+	player->history = NULL;
+
+	/* Drop the last level, as player_init() is about to forget it */
+	if (cave) {
+		wipe_mon_list(cave, player);
+		cave_free(cave);
+		cave = NULL;
+	}
+	if (player->cave) {
+		cave_free(player->cave);
+		player->cave = NULL;
+	}
+	character_dungeon = false;
 }
 
-static errr run_stats(void)
+/**
+ * Call `func` on each array of counters in level_data, always in the same
+ * order; `wide` is true for arrays of long long rather than u32b.
+ *
+ * The counters for a wearable which has not been found yet are not there;
+ * for them `func` is called once with NULL data, standing for that many
+ * zero counters, and if it returns true they are made and gone through.
+ */
+typedef bool (*stats_counter_func)(void *data, size_t num, bool wide,
+								   void *user);
+
+/**
+ * Get the number of counters for one wearable
+ */
+static size_t stats_wearables_counters(void)
 {
-	u32b run;
-	struct artifact *a_info_save;
-	unsigned int i;
-	int err;
-	bool status; 
+	return 1 + TOP_DICE * TOP_SIDES + TOP_AC + 2 * TOP_PLUS + z_info->e_max +
+		OF_MAX + TOP_MOD * (OBJ_MOD_MAX + 1);
+}
 
-	time_t start;
+static void stats_visit_counters(stats_counter_func func, void *user)
+{
+	size_t num = stats_wearables_counters();
+	int i, j, k, l;
 
-	prep_output_dir();
-	create_indices();
-	alloc_memory();
-	if (randarts) {
-		a_info_save = mem_zalloc(z_info->a_max * sizeof(struct artifact));
-		for (i = 0; i < z_info->a_max; i++) {
-			if (!a_info[i].name) continue;
+	for (i = 0; i < LEVEL_MAX; i++) {
+		func(level_data[i].monsters, z_info->r_max, false, user);
+		func(level_data[i].obj_feelings, OBJ_FEEL_MAX, false, user);
+		func(level_data[i].mon_feelings, MON_FEEL_MAX, false, user);
+		func(level_data[i].gold, ORIGIN_STATS, true, user);
 
-			memcpy(&a_info_save[i], &a_info[i], sizeof(struct artifact));
+		for (j = 0; j < ORIGIN_STATS; j++) {
+			func(level_data[i].artifacts[j], z_info->a_max, false, user);
+			func(level_data[i].consumables[j], consumable_count + 1, false,
+				 user);
+
+			for (k = 0; k < wearable_count + 1; k++) {
+				struct wearables_data **slot = &level_data[i].wearables[j][k];
+				struct wearables_data *w;
+
+				if (!*slot) {
+					if (!func(NULL, num, false, user)) continue;
+					*slot = stats_new_wearables();
+				}
+				w = *slot;
+
+				func(&w->count, 1, false, user);
+				func(w->dice, TOP_DICE * TOP_SIDES, false, user);
+				func(w->ac, TOP_AC, false, user);
+				func(w->hit, TOP_PLUS, false, user);
+				func(w->dam, TOP_PLUS, false, user);
+				func(w->egos, z_info->e_max, false, user);
+				func(w->flags, OF_MAX, false, user);
+				for (l = 0; l < TOP_MOD; l++)
+					func(w->modifiers[l], OBJ_MOD_MAX + 1, false, user);
+			}
 		}
 	}
+}
 
-	if (!quiet) printf("Creating the database and dumping info...\n");
-	status = stats_prep_db();
-	if (!status) quit("Couldn't prepare database!");
+/**
+ * Workers send their counters to the parent as (position, value) pairs for
+ * the non-zero counters only, position being the counter's place in the
+ * order stats_visit_counters() goes through them.  Most counters are zero,
+ * and most of those are for wearables which are not there at all.
+ */
+struct stats_transfer {
+	FILE *fp;
+	u32b pos;
+	bool more;
+	u32b next_pos;
+	long long next_value;
+	bool failed;
+};
 
-	if (!quiet) {
-		printf("Beginning %d runs...\n", num_runs);
-		fflush(stdout);
+static bool stats_send_counters(void *data, size_t num, bool wide, void *user)
+{
+	struct stats_transfer *t = user;
+	size_t i;
+
+	for (i = 0; data && i < num; i++) {
+		long long value = wide ? ((long long *) data)[i] : ((u32b *) data)[i];
+		u32b pos = t->pos + i;
+
+		if (!value) continue;
+		if (fwrite(&pos, sizeof(pos), 1, t->fp) != 1 ||
+			fwrite(&value, sizeof(value), 1, t->fp) != 1)
+			t->failed = true;
 	}
+	t->pos += num;
+	return false;
+}
+
+static void stats_read_pair(struct stats_transfer *t)
+{
+	t->more = fread(&t->next_pos, sizeof(t->next_pos), 1, t->fp) == 1 &&
+		fread(&t->next_value, sizeof(t->next_value), 1, t->fp) == 1;
+}
 
-	start = time(NULL);
-	for (run = 1; run <= num_runs; run++) {
-		if (!quiet) progress_bar(run - 1, start);
+static bool stats_add_counters(void *data, size_t num, bool wide, void *user)
+{
+	struct stats_transfer *t = user;
+
+	/* Counters which are not there yet are wanted if any are coming */
+	if (!data) {
+		if (t->more && t->next_pos < t->pos + num) return true;
+		t->pos += num;
+		return false;
+	}
+
+	while (t->more && t->next_pos < t->pos + num) {
+		if (t->next_pos < t->pos) {
+			t->failed = true;
+			break;
+		}
+		if (wide)
+			((long long *) data)[t->next_pos - t->pos] += t->next_value;
+		else
+			((u32b *) data)[t->next_pos - t->pos] += (u32b) t->next_value;
+		stats_read_pair(t);
+	}
+	t->pos += num;
+	return false;
+}
+
+/**
+ * A shard is the counters from a range of runs, kept in a file so that
+ * ranges done on different machines can be put together in one database.
+ * The file starts with STATS_SHARD_HEAD u32b, then has the non-zero
+ * counters as stats_send_counters() writes them; like the pipes from the
+ * workers, it is in the byte order of the machine that wrote it.
+ */
+#define STATS_SHARD_MAGIC	0x41535453
+#define STATS_SHARD_HEAD	7
+
+enum {
+	SHARD_MAGIC,
+	SHARD_SEED,
+	SHARD_FIRST,
+	SHARD_DONE,
+	SHARD_COUNTERS,
+	SHARD_RANDARTS,
+	SHARD_NO_SELLING
+};
+
+static bool stats_count_counters(void *data, size_t num, bool wide,
+								 void *user)
+{
+	*((u32b *) user) += num;
+	return false;
+}
+
+/**
+ * Get the number of counters, which shards must agree on to be added up
+ */
+static u32b stats_num_counters(void)
+{
+	u32b num = 0;
+
+	stats_visit_counters(stats_count_counters, &num);
+	return num;
+}
+
+/**
+ * Write the counters from the `done` runs so far to the shard file,
+ * replacing it only once the new one is complete
+ */
+static bool stats_write_shard(u32b done)
+{
+	char path[1024];
+	struct stats_transfer t = { NULL, 0, false, 0, 0, false };
+	u32b head[STATS_SHARD_HEAD];
+
+	head[SHARD_MAGIC] = STATS_SHARD_MAGIC;
+	head[SHARD_SEED] = seed_base;
+	head[SHARD_FIRST] = first_run;
+	head[SHARD_DONE] = done;
+	head[SHARD_COUNTERS] = stats_num_counters();
+	head[SHARD_RANDARTS] = randarts;
+	head[SHARD_NO_SELLING] = no_selling;
+
+	strnfmt(path, sizeof(path), "%s.new", shard_path);
+	t.fp = fopen(path, "wb");
+	if (!t.fp) return false;
+	if (fwrite(head, sizeof(head), 1, t.fp) != 1) t.failed = true;
+	stats_visit_counters(stats_send_counters, &t);
+	if (fclose(t.fp) || t.failed) return false;
+	return !rename(path, shard_path);
+}
+
+/**
+ * Add the counters from a shard file into level_data, filling in `head`
+ */
+static bool stats_read_shard(const char *path, u32b *head)
+{
+	struct stats_transfer t = { NULL, 0, false, 0, 0, false };
+
+	t.fp = fopen(path, "rb");
+	if (!t.fp) return false;
+	if (fread(head, sizeof(u32b), STATS_SHARD_HEAD, t.fp) != STATS_SHARD_HEAD
+		|| head[SHARD_MAGIC] != STATS_SHARD_MAGIC
+		|| head[SHARD_COUNTERS] != stats_num_counters()) {
+		fclose(t.fp);
+		return false;
+	}
+
+	stats_read_pair(&t);
+	stats_visit_counters(stats_add_counters, &t);
+	fclose(t.fp);
+	return !t.more && !t.failed;
+}
+
+/**
+ * Save a checkpoint of the `done` runs so far, to the shard file if there
+ * is one and otherwise to the database
+ */
+static void stats_checkpoint(u32b done)
+{
+	int err;
+
+	if (shard_path) {
+		if (!stats_write_shard(done))
+			quit_fmt("Problems writing to shard file %s!", shard_path);
+		return;
+	}
+
+	err = stats_write_db(done);
+	if (err) {
+		stats_db_close();
+		quit_fmt("Problems writing to database!  sqlite3 errno %d.", err);
+	}
+}
+
+/**
+ * Do runs `first` to `last` inclusive, checkpointing if `checkpoint` is set
+ */
+static void stats_do_runs(u32b first, u32b last, struct artifact *a_info_save,
+						  bool checkpoint)
+{
+	u32b run;
+	unsigned int i;
+	time_t start = time(NULL);
+
+	for (run = first; run <= last; run++) {
+		if (!quiet) progress_bar(run - first, last - first + 1, start);
 
 		if (randarts)
 			for (i = 0; i < z_info->a_max; i++)
 				memcpy(&a_info[i], &a_info_save[i], sizeof(struct artifact));
 
-		initialize_character();
+		initialize_character(run);
 		unkill_uniques();
 		reset_artifacts();
 		descend_dungeon();
 		stats_cleanup_angband_run();
 
 		/* Checkpoint every so many runs */
-		if (run % RUNS_PER_CHECKPOINT == 0) {
-			err = stats_write_db(run);
-			if (err) {
-				stats_db_close();
-				quit_fmt("Problems writing to database!  sqlite3 errno %d.",
-						 err);
-			}
-		}
+		if (checkpoint && (run - first_run + 1) % RUNS_PER_CHECKPOINT == 0)
+			stats_checkpoint(run - first_run + 1);
 
 		if (quiet && run % 1000 == 0) {
 			printf("Finished %d runs.\n", run);
@@ -1520,18 +1881,202 @@ static errr run_stats(void)
 		}
 	}
 
+	if (!quiet) progress_bar(last - first + 1, last - first + 1, start);
+	if (!quiet) stats_print_memory();
+}
+
+/**
+ * Split runs `first` to `last` between num_workers child processes and add
+ * what they found into level_data.  Only the first worker shows progress.
+ */
+static void stats_run_workers(u32b first, u32b last,
+							  struct artifact *a_info_save)
+{
+	pid_t *pids = mem_zalloc(num_workers * sizeof(pid_t));
+	FILE **pipes = mem_zalloc(num_workers * sizeof(FILE *));
+	u32b runs = last - first + 1;
+	int w;
+
+	fflush(stdout);
+	for (w = 0; w < num_workers; w++) {
+		u32b share = runs / num_workers + (w < (int) (runs % num_workers));
+		int fd[2];
+
+		if (pipe(fd)) quit("Couldn't create a pipe for a worker!");
+		pids[w] = fork();
+		if (pids[w] < 0) quit("Couldn't start a worker!");
+
+		if (pids[w] == 0) {
+			/* Worker: do the runs and send back the counters */
+			struct stats_transfer t = { NULL, 0, false, 0, 0, false };
+
+			close(fd[0]);
+			if (w) quiet = true;
+			if (share) stats_do_runs(first, first + share - 1, a_info_save,
+									 false);
+			t.fp = fdopen(fd[1], "wb");
+			if (!t.fp) _exit(1);
+			stats_visit_counters(stats_send_counters, &t);
+			if (fclose(t.fp) || t.failed) _exit(1);
+			_exit(0);
+		}
+
+		close(fd[1]);
+		pipes[w] = fdopen(fd[0], "rb");
+		if (!pipes[w]) quit("Couldn't read from a worker!");
+		first += share;
+	}
+
+	/* Collect the results */
+	for (w = 0; w < num_workers; w++) {
+		struct stats_transfer t = { pipes[w], 0, false, 0, 0, false };
+		int status;
+
+		stats_read_pair(&t);
+		stats_visit_counters(stats_add_counters, &t);
+		fclose(pipes[w]);
+
+		if (waitpid(pids[w], &status, 0) != pids[w] || !WIFEXITED(status) ||
+			WEXITSTATUS(status) || t.more || t.failed)
+			quit_fmt("Worker %d failed!", w + 1);
+	}
+
+	mem_free(pipes);
+	mem_free(pids);
+}
+
+/**
+ * Pick up a shard where it was left off, if its file is there; returns the
+ * number of runs already done
+ */
+static u32b stats_resume_shard(void)
+{
+	u32b head[STATS_SHARD_HEAD];
+
+	if (!file_exists(shard_path)) return 0;
+	if (!stats_read_shard(shard_path, head))
+		quit_fmt("Couldn't read shard file %s!", shard_path);
+
+	if (!seed_given) seed_base = head[SHARD_SEED];
+	if (head[SHARD_SEED] != seed_base || head[SHARD_FIRST] != first_run ||
+		head[SHARD_RANDARTS] != (u32b) randarts ||
+		head[SHARD_NO_SELLING] != (u32b) no_selling ||
+		head[SHARD_DONE] > num_runs)
+		quit_fmt("Shard file %s is for other runs!", shard_path);
+
+	if (!quiet)
+		printf("Resuming after %d runs...\n", head[SHARD_DONE]);
+	return head[SHARD_DONE];
+}
+
+/**
+ * Add up the counters from all the shard files given; returns the number
+ * of runs they cover between them
+ */
+static u32b stats_merge_shards(void)
+{
+	u32b (*heads)[STATS_SHARD_HEAD] = mem_zalloc(num_merges * sizeof(*heads));
+	u32b runs = 0;
+	int i, j;
+
+	for (i = 0; i < num_merges; i++) {
+		u32b *head = heads[i];
+
+		if (!stats_read_shard(merge_paths[i], head))
+			quit_fmt("Couldn't read shard file %s!", merge_paths[i]);
+		if (head[SHARD_RANDARTS] != heads[0][SHARD_RANDARTS] ||
+			head[SHARD_NO_SELLING] != heads[0][SHARD_NO_SELLING])
+			quit_fmt("Shard file %s was made with other options!",
+					 merge_paths[i]);
+
+		/* The same run counted twice would skew everything */
+		for (j = 0; j < i; j++) {
+			if (heads[j][SHARD_SEED] == head[SHARD_SEED] &&
+				heads[j][SHARD_FIRST] < head[SHARD_FIRST] + head[SHARD_DONE] &&
+				head[SHARD_FIRST] < heads[j][SHARD_FIRST] + heads[j][SHARD_DONE])
+				quit_fmt("Shard files %s and %s have runs in common!",
+						 merge_paths[j], merge_paths[i]);
+		}
+
+		runs += head[SHARD_DONE];
+	}
+
+	randarts = heads[0][SHARD_RANDARTS];
+	no_selling = heads[0][SHARD_NO_SELLING];
+	mem_free(heads);
+	return runs;
+}
+
+static errr run_stats(void)
+{
+	struct artifact *a_info_save = NULL;
+	unsigned int i;
+	int err;
+	bool status; 
+	u32b start = first_run, last = first_run + num_runs - 1;
+
+	prep_output_dir();
+	create_indices();
+	alloc_memory();
+
+	/* Shards are put together instead of doing runs */
+	if (num_merges) {
+		shard_path = NULL;
+		num_runs = stats_merge_shards();
+		if (!quiet) printf("Merged %d runs from %d shards.\n", num_runs,
+						   num_merges);
+	} else {
+		if (!seed_given) seed_base = time(NULL);
+		if (shard_path) start += stats_resume_shard();
+	}
+
+	if (randarts) {
+		a_info_save = mem_zalloc(z_info->a_max * sizeof(struct artifact));
+		for (i = 0; i < z_info->a_max; i++) {
+			if (!a_info[i].name) continue;
+
+			memcpy(&a_info_save[i], &a_info[i], sizeof(struct artifact));
+		}
+	}
+
+	/* A shard only has counters, which go into the database when merged */
+	if (!shard_path) {
+		if (!quiet) printf("Creating the database and dumping info...\n");
+		status = stats_prep_db();
+		if (!status) quit("Couldn't prepare database!");
+	}
+
+	if (!num_merges && start <= last) {
+		if (!quiet) {
+			printf("Beginning %d runs...\n", last - start + 1);
+			fflush(stdout);
+		}
+
+		if (num_workers > 1) {
+			stats_run_workers(start, last, a_info_save);
+		} else {
+			stats_do_runs(start, last, a_info_save, true);
+		}
+	}
+
 	if (!quiet) {
-		progress_bar(num_runs, start);
 		printf("\nSaving the data...\n");
 		fflush(stdout);
 	}
 
-	err = stats_write_db(run);
-	stats_db_close();
-	if (err) quit_fmt("Problems writing to database!  sqlite3 errno %d.", err);
+	if (shard_path) {
+		if (!stats_write_shard(num_runs))
+			quit_fmt("Problems writing to shard file %s!", shard_path);
+	} else {
+		err = stats_write_db(num_runs);
+		stats_db_close();
+		if (err)
+			quit_fmt("Problems writing to database!  sqlite3 errno %d.", err);
+	}
 
 	if (randarts)
 		mem_free(a_info_save);
+	mem_free(merge_paths);
 	free_stats_memory();
 	cleanup_angband();
 	if (!quiet) printf("Done!\n");
@@ -1661,17 +2206,36 @@ static void term_data_link(int i) {
 	angband_term[i] = t;
 }
 
-const char help_stats[] = "Stats mode, subopts -q(uiet) -r(andarts) -n(# of runs) -s(no selling)";
+const char help_stats[] = "Stats mode, subopts -q(uiet) -r(andarts) -n(# of runs) -s(no selling) -j(# of workers) -w(al journal) -c(sv counts) -b(ase seed) -f(irst run) -p(artial shard file) -m(erge shard file)";
 
 /**
  * Usage:
  *
- * angband -mstats -- [-q] [-r] [-nNNNN] [-s]
+ * angband -mstats -- [-q] [-r] [-nNNNN] [-s] [-jNN] [-w] [-c] [-bNNNN]
+ *                     [-fNNNN] [-pFILE] [-mFILE ...]
  *
  *   -q      Quiet mode (turn off progress messages)
  *   -r      Turn on randarts
  *   -nNNNN  Make NNNN runs through the dungeon (default: 1)
  *   -s      Turn on no-selling
+ *   -jNN    Share the runs between NN worker processes (default: 1); the
+ *           database is then only written once all the runs are done
+ *   -w      Use a write-ahead log for the database
+ *   -c      Write the count tables as CSV files next to the database
+ *           instead of into it
+ *   -bNNNN  Base the seed for each run on NNNN rather than the time, so
+ *           runs on different machines can be told apart by number
+ *   -fNNNN  Number the runs from NNNN (default: 1)
+ *   -pFILE  Make a shard: write the counters to FILE instead of making a
+ *           database, checkpointing as the runs go; if FILE is there
+ *           already, carry on from its last checkpoint
+ *   -mFILE  Make the database from shard FILE rather than doing runs; give
+ *           it once for each shard
+ *
+ * To spread a study over several machines, give each the same -b and its
+ * own -f and -n, with -p to make a shard, then put the shards together
+ * with -m on one of them.  Shards are only read on the same kind of
+ * machine as wrote them.
  */
 
 errr init_stats(int argc, char *argv[]) {
@@ -1691,13 +2255,47 @@ errr init_stats(int argc, char *argv[]) {
 			num_runs = atoi(&argv[i][2]);
 			continue;
 		}
+		if (streq(argv[i], "-w")) {
+			wal_mode = true;
+			continue;
+		}
+		if (streq(argv[i], "-c")) {
+			csv_output = true;
+			continue;
+		}
+		if (prefix(argv[i], "-j")) {
+			num_workers = MAX(atoi(&argv[i][2]), 1);
+			continue;
+		}
 		if (prefix(argv[i], "-s")) {
 			no_selling = 1;
 			continue;
 		}
+		if (prefix(argv[i], "-b")) {
+			seed_base = strtoul(&argv[i][2], NULL, 10);
+			seed_given = true;
+			continue;
+		}
+		if (prefix(argv[i], "-f")) {
+			first_run = MAX(atoi(&argv[i][2]), 1);
+			continue;
+		}
+		if (prefix(argv[i], "-p") && argv[i][2]) {
+			shard_path = &argv[i][2];
+			continue;
+		}
+		if (prefix(argv[i], "-m") && argv[i][2]) {
+			merge_paths = mem_realloc(merge_paths,
+				(num_merges + 1) * sizeof(*merge_paths));
+			merge_paths[num_merges++] = &argv[i][2];
+			continue;
+		}
 		printf("init-stats: bad argument '%s'\n", argv[i]);
 	}
 
+	/* Nothing is ever drawn */
+	display_null = true;
+
 	term_data_link(0);
 	return 0;
 }
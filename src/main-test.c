@@ -18,6 +18,8 @@
 
 #include "angband.h"
 #include "buildid.h"
+#include "cmd-stream.h"
+#include "game-world.h"
 #include "main.h"
 #include "player.h"
 #include "player-birth.h"
@@ -110,6 +112,50 @@ static void c_player_race(char *rest) {
 	printf("player-race: %s\n", player->race->name);
 }
 
+/**
+ * Play a command stream file, with nothing drawn
+ */
+static void c_cmd_stream(char *rest) {
+	struct cmd_stream *s = cmd_stream_open(rest);
+	int n;
+
+	if (!s) {
+		printf("cmd-stream: can't open '%s'\n", rest);
+		return;
+	}
+
+	n = cmd_stream_play(s);
+	printf("cmd-stream: played %d%s\n", n,
+		   cmd_stream_failed(s) ? " (stopped at a bad line)" : "");
+	cmd_stream_close(s);
+}
+
+/**
+ * Jump to a game turn in a recorded command stream, with nothing drawn
+ */
+static void c_cmd_seek(char *rest) {
+	char *path = strchr(rest, ' ');
+	struct cmd_stream *s;
+
+	if (!path) {
+		printf("cmd-seek: usage: cmd-seek <turn> <file>\n");
+		return;
+	}
+	*path++ = '\0';
+
+	s = cmd_stream_open(path);
+	if (!s) {
+		printf("cmd-seek: can't open '%s'\n", path);
+		return;
+	}
+
+	if (cmd_stream_seek(s, atoi(rest)))
+		printf("cmd-seek: at turn %d\n", turn);
+	else
+		printf("cmd-seek: can't reach turn %s\n", rest);
+	cmd_stream_close(s);
+}
+
 typedef struct {
 	const char *name;
 	void (*func)(char *args);
@@ -127,6 +173,9 @@ static test_cmd cmds[] = {
 	{ "player-class?", c_player_class },
 	{ "player-race?", c_player_race },
 
+	{ "cmd-stream", c_cmd_stream },
+	{ "cmd-seek", c_cmd_seek },
+
 	{ NULL, NULL }
 };
 
@@ -295,7 +344,7 @@ static void term_data_link(int i) {
 	angband_term[i] = t;
 }
 
-const char help_test[] = "Test mode, subopts -p(rompt)";
+const char help_test[] = "Test mode, subopts -p(rompt) -n(o display)";
 
 errr init_test(int argc, char *argv[]) {
 	int i;
@@ -306,6 +355,10 @@ errr init_test(int argc, char *argv[]) {
 			prompt = 1;
 			continue;
 		}
+		if (!strcmp(argv[i], "-n")) {
+			display_null = true;
+			continue;
+		}
 		printf("init-test: bad argument '%s'\n", argv[i]);
 	}
 
@@ -1110,6 +1110,110 @@ static bool init_graphics(void)
 	return (can_use_graphics);
 }
 
+
+/**
+ * Free the copy of the tiles a window keeps stretched to its cell size
+ */
+static void tile_cache_free(term_data *td)
+{
+	if (td->tile_cache) DeleteObject(td->tile_cache);
+	if (td->tile_cache_mask) DeleteObject(td->tile_cache_mask);
+	td->tile_cache = NULL;
+	td->tile_cache_mask = NULL;
+	td->tile_cache_wid = 0;
+	td->tile_cache_hgt = 0;
+}
+
+
+/**
+ * Copy the bitmap "src" of tiles "w1" by "h1" with every tile stretched to
+ * "tw" by "th".  With "alpha", the copy is a 32 bit DIB section so that the
+ * premultiplied alpha of the tiles is kept for AlphaBlend().
+ */
+static HBITMAP tile_cache_stretch(HDC hdc, HBITMAP src, int w1, int h1,
+								  int tw, int th, bool alpha)
+{
+	int cols = infGraph.ImageWidth / w1;
+	int rows = infGraph.ImageHeight / h1;
+	int row, col;
+	HDC hdcSrc, hdcDst;
+	HBITMAP hbm, hbmSrcOld, hbmDstOld;
+
+	if (alpha) {
+		BITMAPINFO bmi;
+		void *bits;
+
+		memset(&bmi, 0, sizeof(bmi));
+		bmi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+		bmi.bmiHeader.biWidth = cols * tw;
+		bmi.bmiHeader.biHeight = -(rows * th);
+		bmi.bmiHeader.biPlanes = 1;
+		bmi.bmiHeader.biBitCount = 32;
+		bmi.bmiHeader.biCompression = BI_RGB;
+		hbm = CreateDIBSection(hdc, &bmi, DIB_RGB_COLORS, &bits, NULL, 0);
+	} else {
+		hbm = CreateCompatibleBitmap(hdc, cols * tw, rows * th);
+	}
+	if (!hbm) return NULL;
+
+	hdcSrc = CreateCompatibleDC(hdc);
+	hbmSrcOld = SelectObject(hdcSrc, src);
+	hdcDst = CreateCompatibleDC(hdc);
+	hbmDstOld = SelectObject(hdcDst, hbm);
+
+	/* Tile by tile, so no tile picks up the edge of its neighbours */
+	SetStretchBltMode(hdcDst, COLORONCOLOR);
+	for (row = 0; row < rows; row++) {
+		for (col = 0; col < cols; col++) {
+			StretchBlt(hdcDst, col * tw, row * th, tw, th, hdcSrc, col * w1,
+					   row * h1, w1, h1, SRCCOPY);
+		}
+	}
+
+	/* Release */
+	SelectObject(hdcDst, hbmDstOld);
+	DeleteDC(hdcDst);
+	SelectObject(hdcSrc, hbmSrcOld);
+	DeleteDC(hdcSrc);
+
+	return hbm;
+}
+
+
+/**
+ * Make sure the window has the tiles (and their mask) stretched to "tw" by
+ * "th", so its cells are drawn by plain copies rather than by stretching
+ * every tile every time it is drawn.  Made again only if the cell size has
+ * changed; false if they can't be made.
+ */
+static bool tile_cache_get(term_data *td, HDC hdc, int tw, int th, bool alpha)
+{
+	int w1 = infGraph.CellWidth;
+	int h1 = infGraph.CellHeight;
+
+	if (td->tile_cache && (td->tile_cache_wid == tw) &&
+		(td->tile_cache_hgt == th))
+		return true;
+
+	tile_cache_free(td);
+	if (!w1 || !h1) return false;
+
+	td->tile_cache = tile_cache_stretch(hdc, infGraph.hBitmap, w1, h1, tw, th,
+										alpha);
+	if (td->tile_cache && infMask.hBitmap) {
+		td->tile_cache_mask = tile_cache_stretch(hdc, infMask.hBitmap, w1, h1,
+												 tw, th, false);
+	}
+	if (!td->tile_cache || (infMask.hBitmap && !td->tile_cache_mask)) {
+		tile_cache_free(td);
+		return false;
+	}
+
+	td->tile_cache_wid = tw;
+	td->tile_cache_hgt = th;
+	return true;
+}
+
 #ifdef SOUND
 
 /* Supported file types */
@@ -1641,6 +1745,8 @@ static errr Term_xtra_win_react(void)
 		/* Free the bitmap stuff */
 		FreeDIB(&infGraph);
 		FreeDIB(&infMask);
+		for (i = 0; i < MAX_TERM_DATA; i++)
+			tile_cache_free(&data[i]);
 
 		/* Initialize (if needed) */
 		if (arg_graphics && !init_graphics()) {
@@ -2108,6 +2214,7 @@ static errr Term_pict_win(int x, int y, int n,
 	HDC hdc;
 	HDC hdcSrc;
 	HBITMAP hbmSrcOld;
+	HBITMAP hbmMask;
 
 	/* Erase the grids */
 	Term_wipe_win(x, y, n);
@@ -2140,11 +2247,22 @@ static errr Term_pict_win(int x, int y, int n,
 
 	/* More info */
 	hdcSrc = CreateCompatibleDC(hdc);
-	hbmSrcOld = SelectObject(hdcSrc, infGraph.hBitmap);
 
-	if (infMask.hBitmap) {
+	/* Use the tiles already stretched to the cell size, if they can be had */
+	if (!td->map_active && ((w1 != tw2) || (h1 != th2)) &&
+		tile_cache_get(td, hdc, tw2, th2, false)) {
+		w1 = tw2;
+		h1 = th2;
+		hbmSrcOld = SelectObject(hdcSrc, td->tile_cache);
+		hbmMask = td->tile_cache_mask;
+	} else {
+		hbmSrcOld = SelectObject(hdcSrc, infGraph.hBitmap);
+		hbmMask = infMask.hBitmap;
+	}
+
+	if (hbmMask) {
 		hdcMask = CreateCompatibleDC(hdc);
-		SelectObject(hdcMask, infMask.hBitmap);
+		SelectObject(hdcMask, hbmMask);
 	} else {
 		hdcMask = NULL;
 	}
@@ -2330,7 +2448,16 @@ static errr Term_pict_win_alpha(int x, int y, int n,
 
 	/* More info */
 	hdcSrc = CreateCompatibleDC(hdc);
-	hbmSrcOld = SelectObject(hdcSrc, infGraph.hBitmap);
+
+	/* Use the tiles already stretched to the cell size, if they can be had */
+	if (!td->map_active && ((w1 != tw2) || (h1 != th2)) &&
+		tile_cache_get(td, hdc, tw2, th2, true)) {
+		w1 = tw2;
+		h1 = th2;
+		hbmSrcOld = SelectObject(hdcSrc, td->tile_cache);
+	} else {
+		hbmSrcOld = SelectObject(hdcSrc, infGraph.hBitmap);
+	}
 
 	/* Draw attr/char pairs */
 	for (i = n-1; i >= 0; i--, x2 -= w2) {
@@ -4801,6 +4928,8 @@ static void hook_quit(const char *str)
 	}
 
 	/* Free the bitmap stuff */
+	for (i = 0; i < MAX_TERM_DATA; i++)
+		tile_cache_free(&data[i]);
 	FreeDIB(&infGraph);
 	FreeDIB(&infMask);
 
@@ -112,6 +112,7 @@
 #include <X11/keysym.h>
 #include <X11/keysymdef.h>
 #include <X11/XKBlib.h>
+#include <sys/select.h>
 
 #include "main.h"
 
@@ -387,6 +388,7 @@ struct infofnt
 
 	unsigned int mono:1;
 	unsigned int nuke:1;
+	unsigned int fixed:1;
 };
 
 
@@ -1376,6 +1378,16 @@ static errr Infofnt_prepare(XFontSet fs)
 	ifnt->wid = extents->max_logical_extent.width;
 	ifnt->twid = extents->max_logical_extent.width;
 
+	/* Note whether every printable ASCII glyph advances by a full cell */
+	ifnt->fixed = 1;
+	for (i = 0x20; i < 0x7f; i++) {
+		wchar_t c = (wchar_t)i;
+		if (XwcTextEscapement(fs, &c, 1) != ifnt->wid) {
+			ifnt->fixed = 0;
+			break;
+		}
+	}
+
 	/* Success */
 	return (0);
 }
@@ -1481,8 +1493,16 @@ static errr Infofnt_text_std(int x, int y, const wchar_t *str, int len)
 
 	/*** Handle the fake mono we can enforce on fonts ***/
 
-	/* Monotize the font */
-	if (Infofnt->mono) {
+	/* A run of fixed-width ASCII glyphs lines up with the cells anyway */
+	if (Infofnt->mono && Infofnt->fixed && td->tile_wid == Infofnt->wid) {
+		for (i = 0; i < len; i++)
+			if (str[i] < 0x20 || str[i] >= 0x7f) break;
+	} else {
+		i = 0;
+	}
+
+	/* Monotize the font, unless one request will place every glyph */
+	if (Infofnt->mono && i < len) {
 		/* Do each character */
 		for (i = 0; i < len; ++i) {
 			/* Note that the Infoclr is set up to contain the Infofnt */
@@ -1493,7 +1513,7 @@ static errr Infofnt_text_std(int x, int y, const wchar_t *str, int len)
 	} else {
 		/* Note that the Infoclr is set up to contain the Infofnt */
 		XwcDrawImageString(Metadpy->dpy, Infowin->win, Infofnt->fs, Infoclr->gc,
-		                 x, y, str, len);
+		                 x + (Infofnt->mono ? Infofnt->off : 0), y, str, len);
 	}
 
 	/* Success */
@@ -1718,6 +1738,28 @@ static void pixel_to_square(int * const x, int * const y,
 
 
 
+/**
+ * Sleep until the X server has sent something, or ms milliseconds pass
+ * (forever if ms is negative)
+ */
+static errr Term_wait_x11(int ms)
+{
+	int fd = ConnectionNumber(Metadpy->dpy);
+	fd_set fds;
+	struct timeval tv;
+
+	/* Send anything still queued, and check what is already in */
+	if (XPending(Metadpy->dpy)) return (0);
+
+	FD_ZERO(&fds);
+	FD_SET(fd, &fds);
+	tv.tv_sec = ms / 1000;
+	tv.tv_usec = (ms % 1000) * 1000;
+
+	return (select(fd + 1, &fds, NULL, NULL, (ms < 0) ? NULL : &tv) > 0) ?
+		0 : 1;
+}
+
 /**
  * Process events
  */
@@ -2078,6 +2120,49 @@ static errr Term_text_x11(int x, int y, int n, int a, const wchar_t *s)
 }
 
 
+/**
+ * Draw all the changed grids of a frame, one colour at a time, so each
+ * colour is only set up once
+ */
+static errr Term_batch_x11(const struct term_glyph *glyphs, int n)
+{
+	bool used[MAX_COLORS * BG_MAX] = { false };
+	wchar_t buf[256];
+	int a, i;
+
+	for (i = 0; i < n; i++)
+		if (glyphs[i].a >= 0 && glyphs[i].a < MAX_COLORS * BG_MAX)
+			used[glyphs[i].a] = true;
+
+	for (a = 0; a < MAX_COLORS * BG_MAX; a++) {
+		if (!used[a]) continue;
+		Infoclr_set(clr[a]);
+
+		/* Draw each run of this colour along a row */
+		for (i = 0; i < n;) {
+			int x = glyphs[i].x, y = glyphs[i].y, len = 0;
+
+			if (glyphs[i].a != a) {
+				i++;
+				continue;
+			}
+			while (i < n && glyphs[i].a == a && glyphs[i].y == y &&
+				   glyphs[i].x == x + len && len < (int) N_ELEMENTS(buf))
+				buf[len++] = glyphs[i++].c;
+
+			/* Black text is just erased */
+			if (a)
+				Infofnt_text_std(x, y, buf, len);
+			else
+				Infofnt_text_non(x, y, L"", len);
+		}
+	}
+
+	/* Success */
+	return (0);
+}
+
+
 
 
 static void save_prefs(void)
@@ -2476,10 +2561,12 @@ static errr term_data_init(term_data *td, int i)
 
 	/* Hooks */
 	t->xtra_hook = Term_xtra_x11;
+	t->wait_hook = Term_wait_x11;
 	t->curs_hook = Term_curs_x11;
 	t->bigcurs_hook = Term_bigcurs_x11;
 	t->wipe_hook = Term_wipe_x11;
 	t->text_hook = Term_text_x11;
+	t->batch_hook = Term_batch_x11;
 
 	/* Save the data */
 	t->data = td;
@@ -526,6 +526,29 @@ static errr Term_pict_xxx(int x, int y, int n, const byte *ap, const char *cp,
 }
 
 
+/**
+ * Draw every changed grid of a frame in one call (optional).
+ *
+ * When this hook is set, "Term_fresh()" collects the changed grids of
+ * the whole frame instead of calling "Term_text_xxx()", "Term_wipe_xxx()"
+ * and "Term_pict_xxx()" once per run, and hands them over here in row
+ * order.  Each glyph has an attr of zero when it should be erased (unless
+ * "always_text" is set), and tiles carry their terrain in "ta"/"tc".
+ *
+ * Frontends whose drawing calls are expensive to set up (changing colours,
+ * binding textures) can sort or group the glyphs before drawing them.
+ */
+static errr Term_batch_xxx(const struct term_glyph *glyphs, int n)
+{
+	term_data *td = (term_data*)(Term->data);
+
+	/* XXX XXX XXX */
+
+	/* Success */
+	return (0);
+}
+
+
 
 /**
  * ------------------------------------------------------------------------
@@ -601,6 +624,7 @@ static void term_data_link(int i)
 	t->wipe_hook = Term_wipe_xxx;
 	t->text_hook = Term_text_xxx;
 	t->pict_hook = Term_pict_xxx;
+	t->batch_hook = Term_batch_xxx;
 
 	/* Remember where we came from */
 	t->data = td;
@@ -17,6 +17,8 @@
  */
 
 #include "angband.h"
+#include "cmd-stream.h"
+#include "game-profile.h"
 #include "init.h"
 #include "savefile.h"
 #include "ui-command.h"
@@ -31,6 +33,8 @@
 #include "sound.h"
 #endif
 
+#include <signal.h>
+
 /**
  * locale junk
  */
@@ -98,6 +102,22 @@ static void quit_hook(const char *s)
 	}
 }
 
+/**
+ * Where frames for observers go, if anywhere
+ */
+static ang_file *observe_file;
+
+/**
+ * Write each frame to the file named with -o; if nobody is reading it any
+ * more, stop sending them
+ */
+static void observe_write(const byte *buf, size_t len)
+{
+	if (!file_write(observe_file, (const char *)buf, len) ||
+		!file_flush(observe_file))
+		Term_observe_hook = NULL;
+}
+
 /**
  * Initialize and verify the file paths, and the score file.
  *
@@ -281,16 +301,30 @@ static void list_saves(void)
 
 static bool new_game;
 
+#ifdef GAME_TRACE
+static bool trace_at_exit;
+#endif
+
 
 static void debug_opt(const char *arg) {
 	if (streq(arg, "mem-poison-alloc"))
 		mem_flags |= MEM_POISON_ALLOC;
 	else if (streq(arg, "mem-poison-free"))
 		mem_flags |= MEM_POISON_FREE;
+	else if (streq(arg, "mem-account"))
+		mem_flags |= MEM_ACCOUNT;
+#ifdef GAME_TRACE
+	else if (streq(arg, "trace"))
+		trace_at_exit = true;
+#endif
 	else {
 		puts("Debug flags:");
 		puts("  mem-poison-alloc: Poison all memory allocations");
 		puts("   mem-poison-free: Poison all freed memory");
+		puts("       mem-account: Keep count of memory use by subsystem");
+#ifdef GAME_TRACE
+		puts("             trace: Write the game loop trace to trace.json on exit");
+#endif
 		exit(0);
 	}
 }
@@ -312,6 +346,8 @@ int main(int argc, char *argv[])
 #ifdef SOUND
 	const char *soundstr = NULL;
 #endif
+	const char *observestr = NULL;
+	const char *recordstr = NULL;
 	bool args = true;
 
 	/* Save the "program name" XXX XXX XXX */
@@ -408,9 +444,25 @@ int main(int argc, char *argv[])
 				soundstr = arg;
 				continue;
 #endif
+			case 'r':
+				if (atoi(arg) <= 0) goto usage;
+				Term_frame_ms = 1000 / atoi(arg);
+				continue;
+
 			case 'd':
 				change_path(arg);
 				continue;
+#ifndef SETGID
+			case 'o':
+				if (!*arg) goto usage;
+				observestr = arg;
+				continue;
+
+			case 'c':
+				if (!*arg) goto usage;
+				recordstr = arg;
+				continue;
+#endif
 
 			case 'x':
 				debug_opt(arg);
@@ -431,6 +483,11 @@ int main(int argc, char *argv[])
 				puts("  -w             Resurrect dead character (marks savefile)");
 				puts("  -g             Request graphics mode");
 				puts("  -x<opt>        Debug options; see -xhelp");
+				puts("  -r<fps>        Show at most <fps> frames a second while the game runs on");
+#ifndef SETGID
+				puts("  -o<file>       Write screen changes to <file> (or a pipe) for spectators");
+				puts("  -c<file>       Record the commands played to <file>, with savefile keyframes");
+#endif
 				puts("  -u<who>        Use your <who> savefile");
 				puts("  -d<dir>=<path> Override a specific directory with <path>. <path> can be:");
 				for (i = 0; i < (int)N_ELEMENTS(change_path_values); i++) {
@@ -466,6 +523,14 @@ int main(int argc, char *argv[])
 	/* Install "quit" hook */
 	quit_aux = quit_hook;
 
+#ifdef GAME_TRACE
+	if (trace_at_exit) {
+		char buf[1024];
+		path_build(buf, sizeof(buf), ANGBAND_DIR_USER, "trace.json");
+		trace_dump_at_exit(buf);
+	}
+#endif
+
 	/* If we were told which mode to use, then use it */
 	if (mstr)
 		ANGBAND_SYS = mstr;
@@ -509,6 +574,20 @@ int main(int argc, char *argv[])
 	/* Catch nasty signals */
 	signals_init();
 
+	/* Send frames to spectators; a reader going away only stops them */
+	if (observestr) {
+		observe_file = file_open(observestr, MODE_WRITE, FTYPE_RAW);
+		if (!observe_file) quit_fmt("Cannot write to '%s'", observestr);
+#ifdef SIGPIPE
+		(void)signal(SIGPIPE, SIG_IGN);
+#endif
+		Term_observe_hook = observe_write;
+	}
+
+	/* Record the game, with a keyframe every thousand player turns */
+	if (recordstr && !cmd_record_start(recordstr, 10000))
+		quit_fmt("Cannot write to '%s'", recordstr);
+
 	/* Set up the command hook */
 	cmd_get_hook = textui_get_cmd;
 
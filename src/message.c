@@ -24,11 +24,12 @@
 #include "init.h"
 #include "player.h"
 
+/**
+ * A stored message; the text lives in the queue's string arena
+ */
 typedef struct _message_t
 {
-	char *str;
-	struct _message_t *newer;
-	struct _message_t *older;
+	u32b str;
 	u16b type;
 	u16b count;
 } message_t;
@@ -40,10 +41,18 @@ typedef struct _msgcolor_t
 	struct _msgcolor_t *next;
 } msgcolor_t;
 
+/**
+ * Messages are kept in a ring of `max` entries, newest at `head`.  Their text
+ * is written in the same order round the arena, so the oldest messages are
+ * always the ones in the way of the next string.
+ */
 typedef struct _msgqueue_t
 {
-	message_t *head;
-	message_t *tail;
+	message_t *ring;
+	u32b head;
+	char *arena;
+	u32b arena_size;
+	u32b arena_pos;
 	msgcolor_t *colors;
 	u32b count;
 	u32b max;
@@ -63,6 +72,9 @@ void messages_init(void)
 {
 	messages = mem_zalloc(sizeof(msgqueue_t));
 	messages->max = 2048;
+	messages->ring = mem_zalloc(messages->max * sizeof(message_t));
+	messages->arena_size = messages->max * 64;
+	messages->arena = mem_alloc(messages->arena_size);
 }
 
 /**
@@ -72,15 +84,6 @@ void messages_free(void)
 {
 	msgcolor_t *c = messages->colors;
 	msgcolor_t *nextc;
-	message_t *m = messages->head;
-	message_t *nextm;
-
-	while (m) {
-		nextm = m->older;
-		mem_free(m->str);
-		mem_free(m);
-		m = nextm;
-	}
 
 	while (c) {
 		nextc = c->next;
@@ -88,6 +91,8 @@ void messages_free(void)
 		c = nextc;
 	}
 
+	mem_free(messages->ring);
+	mem_free(messages->arena);
 	mem_free(messages);
 }
 
@@ -104,63 +109,124 @@ u16b messages_num(void)
  * Functions for individual messages
  * ------------------------------------------------------------------------ */
 /**
- * Save a new message into the memory buffer, with text `str` and type `type`.
- * The type should be one of the MSG_ constants defined in message.h.
- *
- * The new message may not be saved if it is identical to the one saved before
- * it, in which case the "count" of the message will be increased instead.
- * This count can be fetched using the message_count() function.
+ * Returns the message of age `age`.
  */
-void message_add(const char *str, u16b type)
+static message_t *message_get(u16b age)
 {
-	message_t *m;
+	if (age >= messages->count)
+		return NULL;
 
-	if (messages->head &&
-	    messages->head->type == type &&
-	    !strcmp(messages->head->str, str)) {
-		messages->head->count++;
-		return;
-	}
+	return &messages->ring[(messages->head + messages->max - age) %
+						   messages->max];
+}
 
-	m = mem_zalloc(sizeof(message_t));
-	m->str = string_make(str);
-	m->type = type;
-	m->count = 1;
-	m->older = messages->head;
+/**
+ * Longest message text, terminator included
+ */
+#define MESSAGE_LEN_MAX 1024
 
-	if (messages->head)
-		messages->head->newer = m;
+/**
+ * Where in the arena a string of `len` bytes goes; strings never straddle the
+ * end of it
+ */
+static u32b message_start(u32b len)
+{
+	if (messages->arena_pos + len > messages->arena_size)
+		return 0;
+	return messages->arena_pos;
+}
 
-	messages->head = m;
-	messages->count++;
+/**
+ * Drop the oldest messages whose text is in the way of `len` bytes at
+ * `start`, and, if `slot`, the oldest one too if the ring is full
+ */
+static void message_make_room(u32b start, u32b len, bool slot)
+{
+	bool wrap = (start != messages->arena_pos);
 
-	if (!messages->tail)
-		messages->tail = m;
+	while (messages->count) {
+		message_t *oldest = message_get(messages->count - 1);
+		bool in_way;
 
-	if (messages->count > messages->max) {
-		message_t *old_tail = messages->tail;
+		if (wrap) {
+			in_way = (oldest->str >= messages->arena_pos) ||
+				(oldest->str < start + len);
+		} else {
+			in_way = (oldest->str >= start) && (oldest->str < start + len);
+		}
 
-		messages->tail = old_tail->newer;
-		messages->tail->older = NULL;
-		mem_free(old_tail->str);
-		mem_free(old_tail);
+		if (!in_way && (!slot || messages->count < messages->max))
+			break;
 		messages->count--;
 	}
 }
 
 /**
- * Returns the message of age `age`.
+ * Take the text at `start` in the arena as the newest message
  */
-static message_t *message_get(u16b age)
+static void message_push(u32b start, u32b len, u16b type)
+{
+	message_t *m;
+
+	messages->head = (messages->head + 1) % messages->max;
+	messages->count++;
+	m = &messages->ring[messages->head];
+	m->str = start;
+	m->type = type;
+	m->count = 1;
+	messages->arena_pos = start + len;
+}
+
+/**
+ * Save a new message into the memory buffer, with text `str` and type `type`.
+ * The type should be one of the MSG_ constants defined in message.h.
+ *
+ * The new message may not be saved if it is identical to the one saved before
+ * it, in which case the "count" of the message will be increased instead.
+ * This count can be fetched using the message_count() function.
+ */
+void message_add(const char *str, u16b type)
 {
-	message_t *m = messages->head;
+	message_t *m = message_get(0);
+	u32b len = MIN(strlen(str) + 1, messages->arena_size);
+	u32b start;
 
-	while (m && age--)
-		m = m->older;
+	if (m && m->type == type && !strcmp(messages->arena + m->str, str)) {
+		m->count++;
+		return;
+	}
 
-	return m;
+	start = message_start(len);
+	message_make_room(start, len, true);
+	my_strcpy(messages->arena + start, str, len);
+	message_push(start, len, type);
 }
 
+/**
+ * Format a new message straight into the memory buffer, as message_add()
+ * would save it, and return its text.  The room a message of the longest
+ * length would need is written over first, so the oldest messages there are
+ * dropped even if the new one turns out to be a repeat.
+ */
+static const char *message_vadd(u16b type, const char *fmt, va_list vp)
+{
+	message_t *m = message_get(0);
+	u32b start = message_start(MESSAGE_LEN_MAX);
+	char *text = messages->arena + start;
+	u32b len = vstrnfmt(text, MESSAGE_LEN_MAX, fmt, vp) + 1;
+	bool repeat = m && m->type == type &&
+		!strcmp(messages->arena + m->str, text);
+
+	message_make_room(start, len, !repeat);
+
+	if (repeat) {
+		m->count++;
+		return messages->arena + m->str;
+	}
+
+	message_push(start, len, type);
+	return text;
+}
 
 /**
  * Returns the text of the message of age `age`.  The age of the most recently
@@ -172,7 +238,7 @@ static message_t *message_get(u16b age)
 const char *message_str(u16b age)
 {
 	message_t *m = message_get(age);
-	return (m ? m->str : "");
+	return (m ? messages->arena + m->str : "");
 }
 
 /**
@@ -361,26 +427,18 @@ void sound(int type)
 void bell(const char *fmt, ...)
 {
 	va_list vp;
-
-	char buf[1024];
-
-	/* Begin the Varargs Stuff */
-	va_start(vp, fmt);
-
-	/* Format the args, save the length */
-	(void)vstrnfmt(buf, sizeof(buf), fmt, vp);
-
-	/* End the Varargs Stuff */
-	va_end(vp);
+	const char *text;
 
 	/* Fail if messages not loaded */
 	if (!messages) return;
 
-	/* Add to message log */
-	message_add(buf, MSG_BELL);
+	/* Format it into the message log */
+	va_start(vp, fmt);
+	text = message_vadd(MSG_BELL, fmt, vp);
+	va_end(vp);
 
 	/* Send bell event */
-	event_signal_message(EVENT_BELL, MSG_BELL, buf);
+	event_signal_message(EVENT_BELL, MSG_BELL, text);
 }
 
 /**
@@ -395,26 +453,18 @@ void bell(const char *fmt, ...)
 void msg(const char *fmt, ...)
 {
 	va_list vp;
-
-	char buf[1024];
-
-	/* Begin the Varargs Stuff */
-	va_start(vp, fmt);
-
-	/* Format the args, save the length */
-	(void)vstrnfmt(buf, sizeof(buf), fmt, vp);
-
-	/* End the Varargs Stuff */
-	va_end(vp);
+	const char *text;
 
 	/* Fail if messages not loaded */
 	if (!messages) return;
 
-	/* Add to message log */
-	message_add(buf, MSG_GENERIC);
+	/* Format it into the message log */
+	va_start(vp, fmt);
+	text = message_vadd(MSG_GENERIC, fmt, vp);
+	va_end(vp);
 
 	/* Send refresh event */
-	event_signal_message(EVENT_MESSAGE, MSG_GENERIC, buf);
+	event_signal_message(EVENT_MESSAGE, MSG_GENERIC, text);
 
 }
 
@@ -428,23 +478,21 @@ void msg(const char *fmt, ...)
 void msgt(unsigned int type, const char *fmt, ...)
 {
 	va_list vp;
-	char buf[1024];
-	va_start(vp, fmt);
-	vstrnfmt(buf, sizeof(buf), fmt, vp);
-	va_end(vp);
+	const char *text;
 
 	/* Fail if messages not loaded */
 	if (!messages) return;
 
-	/* Add to message log */
-	message_add(buf, type);
+	/* Format it into the message log */
+	va_start(vp, fmt);
+	text = message_vadd(type, fmt, vp);
+	va_end(vp);
 
 	/* Send refresh event */
 	sound(type);
-	event_signal_message(EVENT_MESSAGE, type, buf);
+	event_signal_message(EVENT_MESSAGE, type, text);
 }
 
-
 struct init_module messages_module = {
 	.name = "messages",
 	.init = messages_init,
@@ -76,7 +76,7 @@ static bool monster_can_cast(struct monster *mon, bool innate)
 	if (mon->cdis > z_info->max_range) return false;
 
 	/* Check path */
-	if (!projectable(cave, mon->grid, player->grid, PROJECT_NONE))
+	if (!projectable_to_player(cave, mon->grid))
 		return false;
 
 	return true;
@@ -211,23 +211,24 @@ static bool summon_possible(struct loc grid)
  */
 int choose_attack_spell(bitflag *f, bool innate, bool non_innate)
 {
-	int num = 0;
-	byte spells[RSF_MAX];
-
-	int i;
+	bitflag spells[RSF_SIZE], innate_spells[RSF_SIZE];
+	int num, i;
 
 	/* Extract spells, filtering as necessary */
-	for (i = FLAG_START, num = 0; i < RSF_MAX; i++) {
-		if (!innate && mon_spell_is_innate(i)) continue;
-		if (!non_innate && !mon_spell_is_innate(i)) continue;
-		if (rsf_has(f, i)) spells[num++] = i;
-	}
+	rsf_copy(spells, f);
+	create_mon_spell_mask(innate_spells, RST_INNATE, RST_NONE);
+	if (!innate) rsf_diff(spells, innate_spells);
+	if (!non_innate) rsf_inter(spells, innate_spells);
+	num = rsf_count(spells);
 
 	/* Paranoia */
 	if (num == 0) return 0;
 
 	/* Pick at random */
-	return (spells[randint0(num)]);
+	num = randint0(num);
+	for (i = rsf_next(spells, FLAG_START); num; i = rsf_next(spells, i + 1))
+		num--;
+	return i;
 }
 
 /**
@@ -63,6 +63,19 @@ void get_mon_name(char *buf, size_t buflen,
     }
 }
 
+/**
+ * Pronouns and indefinites for hidden or pronominalized monsters, by
+ * gender (neuter, male, female) and the low three bits of the mode
+ */
+static const char *mon_pronouns[3][8] = {
+	{ "it", "it", "its", "itself",
+	  "something", "something", "something's", "itself" },
+	{ "he", "him", "his", "himself",
+	  "someone", "someone", "someone's", "himself" },
+	{ "she", "her", "her", "herself",
+	  "someone", "someone", "someone's", "herself" }
+};
+
 /**
  * Builds a string describing a monster in some way.
  *
@@ -121,54 +134,19 @@ void monster_desc(char *desc, size_t max, const struct monster *mon, int mode)
 
 	/* First, try using pronouns, or describing hidden monsters */
 	if (!seen || use_pronoun) {
-		const char *choice = "it";
-
 		/* an encoding of the monster "sex" */
-		int msex = 0x00;
+		int msex = 0;
 
 		/* Extract the gender (if applicable) */
 		if (use_pronoun) {
 			if (rf_has(mon->race->flags, RF_FEMALE)) {
-				msex = 0x20;
+				msex = 2;
 			} else if (rf_has(mon->race->flags, RF_MALE)) {
-				msex = 0x10;
+				msex = 1;
 			}
 		}
 
-		/* Brute force: split on the possibilities */
-		switch (msex + (mode & 0x07)) {
-			/* Neuter */
-			case 0x00: choice = "it"; break;
-			case 0x01: choice = "it"; break;
-			case 0x02: choice = "its"; break;
-			case 0x03: choice = "itself"; break;
-			case 0x04: choice = "something"; break;
-			case 0x05: choice = "something"; break;
-			case 0x06: choice = "something's"; break;
-			case 0x07: choice = "itself"; break;
-
-			/* Male */
-			case 0x10: choice = "he"; break;
-			case 0x11: choice = "him"; break;
-			case 0x12: choice = "his"; break;
-			case 0x13: choice = "himself"; break;
-			case 0x14: choice = "someone"; break;
-			case 0x15: choice = "someone"; break;
-			case 0x16: choice = "someone's"; break;
-			case 0x17: choice = "himself"; break;
-
-			/* Female */
-			case 0x20: choice = "she"; break;
-			case 0x21: choice = "her"; break;
-			case 0x22: choice = "her"; break;
-			case 0x23: choice = "herself"; break;
-			case 0x24: choice = "someone"; break;
-			case 0x25: choice = "someone"; break;
-			case 0x26: choice = "someone's"; break;
-			case 0x27: choice = "herself"; break;
-		}
-
-		my_strcpy(desc, choice, max);
+		my_strcpy(desc, mon_pronouns[msex][mode & 0x07], max);
 	} else if ((mode & MDESC_POSS) && (mode & MDESC_OBJE)) {
 		/* The monster is visible, so use its gender */
 		if (rf_has(mon->race->flags, RF_FEMALE))
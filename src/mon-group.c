@@ -29,7 +29,10 @@
  */
 struct monster_group *monster_group_new(void)
 {
+	enum mem_tag tag = mem_tag_set(MEM_TAG_MONSTER);
 	struct monster_group *group = mem_zalloc(sizeof(struct monster_group));
+
+	mem_tag_set(tag);
 	return group;
 }
 
@@ -38,14 +41,81 @@ struct monster_group *monster_group_new(void)
  */
 void monster_group_free(struct chunk *c, struct monster_group *group)
 {
-	/* Free the member list */
-	while (group->member_list) {
-		struct mon_group_list_entry *next = group->member_list->next;
-		mem_free(group->member_list);
-		group->member_list = next;
+	mem_free(group->members);
+	mem_free(group);
+}
+
+/**
+ * Add a monster index to the members of a group
+ */
+static void monster_group_add_member(struct monster_group *group, int midx)
+{
+	if (group->num_members == group->members_size) {
+		enum mem_tag tag = mem_tag_set(MEM_TAG_MONSTER);
+
+		group->members_size = group->members_size ?
+			group->members_size * 2 : 8;
+		group->members = mem_realloc(group->members,
+									 group->members_size * sizeof(int));
+		mem_tag_set(tag);
 	}
+	group->members[group->num_members++] = midx;
+}
 
-	mem_free(group);
+/**
+ * Remove a monster index from the members of a group, moving the last member
+ * into its place; return false if it wasn't a member
+ */
+static bool monster_group_remove_member(struct monster_group *group, int midx)
+{
+	int i;
+
+	for (i = 0; i < group->num_members; i++) {
+		if (group->members[i] == midx) {
+			group->members[i] = group->members[--group->num_members];
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/**
+ * Verify the integrity of one monster group
+ */
+static void monster_group_verify(struct chunk *c, int index)
+{
+	struct monster_group *group = c->monster_groups[index];
+	int i, tracking = 0;
+
+	if (!group) return;
+
+	for (i = 0; i < group->num_members; i++) {
+		struct monster *mon = cave_monster(c, group->members[i]);
+		struct monster_group_info *info = mon->group_info;
+		if (info[PRIMARY_GROUP].index == index &&
+			mflag_has(mon->mflag, MFLAG_TRACKING))
+			tracking++;
+		if (info[PRIMARY_GROUP].index != index) {
+			if (info[SUMMON_GROUP].index) {
+				if (info[SUMMON_GROUP].index != index) {
+					quit_fmt("Bad group index: group: %d, monster: %d",
+							 index, info[SUMMON_GROUP].index);
+				}
+				if (info[SUMMON_GROUP].role != MON_GROUP_LEADER) {
+					quit_fmt("Bad monster role: group: %d, monster: %d",
+							 index, info[SUMMON_GROUP].index);
+				}
+			} else {
+				quit_fmt("Bad group index: group: %d, monster: %d",
+						 index, info[PRIMARY_GROUP].index);
+			}
+		}
+	}
+	if (tracking != group->tracking) {
+		quit_fmt("Bad tracking count: group: %d, count: %d, real: %d",
+				 index, group->tracking, tracking);
+	}
 }
 
 /**
@@ -54,23 +124,23 @@ void monster_group_free(struct chunk *c, struct monster_group *group)
 static void monster_group_split(struct chunk *c, struct monster_group *group,
 								struct monster *leader)
 {
-	struct mon_group_list_entry *entry = group->member_list;
+	int j;
 
 	/* Keep a list of groups made for easy checking */
 	int *temp = mem_zalloc(z_info->level_monster_max * sizeof(int));
 	int current = 0;
 
 	/* Go through the monsters in the group */
-	for (entry = group->member_list; entry; entry = entry->next) {
+	for (j = 0; j < group->num_members; j++) {
 		int i;
-		struct monster *mon = &c->monsters[entry->midx];
+		struct monster *mon = cave_monster(c, group->members[j]);
 
 		/* Check all groups to see if they contain a monster of this race */
 		for (i = 0; i < current; i++) {
 			struct monster_group *new_group = c->monster_groups[temp[i]];
 
 			/* If it's the right group, add the monster and stop checking */
-			if (c->monsters[new_group->member_list->midx].race == mon->race) {
+			if (cave_monster(c, new_group->members[0])->race == mon->race) {
 				mon->group_info[PRIMARY_GROUP].index = temp[i];
 				mon->group_info[PRIMARY_GROUP].role = MON_GROUP_MEMBER;
 				monster_add_to_group(c, mon, new_group);
@@ -86,6 +156,8 @@ static void monster_group_split(struct chunk *c, struct monster_group *group,
 			temp[current++] = mon->group_info[PRIMARY_GROUP].index;
 		}
 	}
+	for (j = 0; j < current; j++)
+		monster_group_verify(c, temp[j]);
 	mem_free(temp);
 }
 
@@ -96,12 +168,11 @@ static void monster_group_split(struct chunk *c, struct monster_group *group,
 static void monster_group_remove_leader(struct chunk *c, struct monster *leader,
 										struct monster_group *group)
 {
-	struct mon_group_list_entry *list_entry = group->member_list;
-	int poss_leader = 0;
+	int i, poss_leader = 0;
 
 	/* Look for another leader */
-	while (list_entry) {
-		struct monster *mon = cave_monster(c, list_entry->midx);
+	for (i = 0; i < group->num_members; i++) {
+		struct monster *mon = cave_monster(c, group->members[i]);
 
 		/* Monsters of the same race can take over as leader */
 		if ((leader->race == mon->race) && !poss_leader
@@ -113,31 +184,23 @@ static void monster_group_remove_leader(struct chunk *c, struct monster *leader,
 		if (rf_has(mon->race->flags, RF_UNIQUE)) {
 			poss_leader = mon->midx;
 		}
-		list_entry = list_entry->next;
 	}
 
 	/* If no new leader, group fractures and old group is removed */
 	if (!poss_leader) {
+		int index = group->index;
+
 		monster_group_split(c, group, leader);
-		c->monster_groups[group->index] = NULL;
+		c->monster_groups[index] = NULL;
+		free_slots_push(&c->group_free, index);
 		monster_group_free(c, group);
 	} else {
 		/* If there is a successor, appoint them and finalise changes */
 		group->leader = poss_leader;
-		list_entry = group->member_list;
-		assert(list_entry);
-		while (list_entry) {
-			struct monster *mon = cave_monster(c, list_entry->midx);
-
-			/* Record the leader */
-			if (mon->midx == poss_leader) {
-				mon->group_info[PRIMARY_GROUP].role = MON_GROUP_LEADER;
-				break;
-			}
-			list_entry = list_entry->next;
-		}
+		cave_monster(c, poss_leader)->group_info[PRIMARY_GROUP].role =
+			MON_GROUP_LEADER;
+		monster_group_verify(c, group->index);
 	}
-	monster_groups_verify(c);
 }
 
 /**
@@ -147,66 +210,63 @@ static void monster_group_remove_leader(struct chunk *c, struct monster *leader,
 void monster_remove_from_groups(struct chunk *c, struct monster *mon)
 {
 	int i;
-	struct monster_group *group;
-	struct mon_group_list_entry *list_entry;
 
 	for (i = 0; i < 2; i++) {
-		group =	c->monster_groups[mon->group_info[i].index];
+		int index = mon->group_info[i].index;
+		struct monster_group *group = c->monster_groups[index];
 
 		/* Most monsters won't have a second group */
 		if (!group) return;
-		list_entry = group->member_list;
-
-		/* Check if the first entry is the one we want */
-		if (list_entry->midx == mon->midx) {
-			if (!list_entry->next) {
-				/* If it's the only monster, remove the group */
-				monster_group_free(c, group);
-				c->monster_groups[mon->group_info[i].index] = NULL;
-				continue;
-			} else {
-				/* Otherwise remove the first entry */
-				group->member_list = list_entry->next;
-				mem_free(list_entry);
-				if (group->leader == mon->midx) {
-					monster_group_remove_leader(c, mon, group);
-				}
-				continue;
-			}
-		}
 
-		/* Check - necessary? */
-		if (list_entry->next == NULL) {
-			quit_fmt("Bad group: index=%d, monster=%d",
-					 mon->group_info[i].index, mon->midx);
+		/* A tracker leaving its primary group no longer counts */
+		if (i == PRIMARY_GROUP && mflag_has(mon->mflag, MFLAG_TRACKING))
+			group->tracking--;
+
+		if (!monster_group_remove_member(group, mon->midx)) {
+			quit_fmt("Bad group: index=%d, monster=%d", index, mon->midx);
 		}
 
-		/* We have to look further down the member list */
-		while (list_entry) {
-			if (list_entry->next->midx == mon->midx) {
-				struct mon_group_list_entry *remove = list_entry->next;
-				list_entry->next = list_entry->next->next;
-				mem_free(remove);
-				if (group->leader == mon->midx) {
-					monster_group_remove_leader(c, mon, group);
-				}
-				break;
-			}
-			list_entry = list_entry->next;
+		if (!group->num_members) {
+			/* If it was the only monster, remove the group */
+			monster_group_free(c, group);
+			c->monster_groups[index] = NULL;
+			free_slots_push(&c->group_free, index);
+		} else if (group->leader == mon->midx) {
+			monster_group_remove_leader(c, mon, group);
+		} else {
+			monster_group_verify(c, index);
 		}
 	}
-	monster_groups_verify(c);
 }
 
 /**
  * Get the next available monster group index
+ *
+ * The index isn't taken until a group is put there, so freed indices are
+ * kept in c->group_free and the one on top is checked and left in place.
  */
 int monster_group_index_new(struct chunk *c)
 {
-	int index;
+	while (true) {
+		int index = free_slots_pop(&c->group_free);
+
+		if (!index) {
+			if (c->group_free.complete) break;
+
+			/* Find all the unused indices, lowest last so it is used first */
+			free_slots_reset(&c->group_free, z_info->level_monster_max);
+			for (index = z_info->level_monster_max - 1; index >= 1; index--)
+				if (!c->monster_groups[index])
+					free_slots_push(&c->group_free, index);
+			c->group_free.complete = true;
+			continue;
+		}
 
-	for (index = 1; index < z_info->level_monster_max; index++) {
-		if (!(c->monster_groups[index])) return index;
+		/* Skip indices that have been taken since they were freed */
+		if (index < z_info->level_monster_max && !c->monster_groups[index]) {
+			free_slots_push(&c->group_free, index);
+			return index;
+		}
 	}
 
 	/* Fail, very unlikely */
@@ -219,16 +279,12 @@ int monster_group_index_new(struct chunk *c)
 void monster_add_to_group(struct chunk *c, struct monster *mon,
 						  struct monster_group *group)
 {
-	struct mon_group_list_entry *list_entry;
-
 	/* Confirm we're adding to the right group */
 	assert(mon->group_info[PRIMARY_GROUP].index == group->index);
 
-	/* Make a new list entry and add it to the start of the list */
-	list_entry = mem_zalloc(sizeof(struct mon_group_list_entry));
-	list_entry->midx = mon->midx;
-	list_entry->next = group->member_list;
-	group->member_list = list_entry;
+	monster_group_add_member(group, mon->midx);
+	if (mflag_has(mon->mflag, MFLAG_TRACKING))
+		group->tracking++;
 }
 
 
@@ -248,8 +304,9 @@ void monster_group_start(struct chunk *c, struct monster *mon, int which)
 	/* Fill out the group */
 	group->index = index;
 	group->leader = mon->midx;
-	group->member_list = mem_zalloc(sizeof(struct mon_group_list_entry));
-	group->member_list->midx = mon->midx;
+	monster_group_add_member(group, mon->midx);
+	if (which == PRIMARY_GROUP && mflag_has(mon->mflag, MFLAG_TRACKING))
+		group->tracking = 1;
 
 	/* Write the index to the monster's group info, make it leader */
 	mon->group_info[which].index = index;
@@ -277,8 +334,6 @@ void monster_group_assign(struct chunk *c, struct monster *mon,
 		int i;
 
 		for (i = 0; i < GROUP_MAX; i++) {
-			struct mon_group_list_entry *entry = mem_zalloc(sizeof(*entry));
-
 			/* Check the index */
 			index = info[i].index;
 			if (!index) {
@@ -287,7 +342,6 @@ void monster_group_assign(struct chunk *c, struct monster *mon,
 					quit_fmt("Monster %d has no group", mon->midx);
 				} else {
 					/* Plenty of things have no summon group */
-					mem_free(entry);
 					return;
 				}
 			}
@@ -304,9 +358,9 @@ void monster_group_assign(struct chunk *c, struct monster *mon,
 			}
 
 			/* Add this monster */
-			entry->midx = mon->midx;
-			entry->next = group->member_list;
-			group->member_list = entry;
+			monster_group_add_member(group, mon->midx);
+			if (i == PRIMARY_GROUP && mflag_has(mon->mflag, MFLAG_TRACKING))
+				group->tracking++;
 		}
 	}
 }
@@ -336,32 +390,29 @@ bool monster_group_change_index(struct chunk *c, int new, int old)
 	int index1 = cave_monster(c, old)->group_info[SUMMON_GROUP].index;
 	struct monster_group *group0 = monster_group_by_index(c, index0);
 	struct monster_group *group1 = monster_group_by_index(c, index1);
-	struct mon_group_list_entry *entry = group0->member_list;
+	int i;
 
 	if (group0->leader == old) {
 		group0->leader = new;
 	}
-	while (entry) {
-		if (entry->midx == old) {
-			entry->midx = new;
+	for (i = 0; i < group0->num_members; i++) {
+		if (group0->members[i] == old) {
+			group0->members[i] = new;
 			if (!group1) {
 				return true;
 			}
 		}
-		entry = entry->next;
 	}
 
 	if (group1) {
 		if (group1->leader == old) {
 			group1->leader = new;
 		}
-		entry = group1->member_list;
-		while (entry) {
-			if (entry->midx == old) {
-				entry->midx = new;
+		for (i = 0; i < group1->num_members; i++) {
+			if (group1->members[i] == old) {
+				group1->members[i] = new;
 				return true;
 			}
-			entry = entry->next;
 		}
 	}
 
@@ -401,13 +452,13 @@ void monster_group_rouse(struct chunk *c, struct monster *mon)
 {
 	int index = mon->group_info[PRIMARY_GROUP].index;
 	struct monster_group *group = c->monster_groups[index];
-	struct mon_group_list_entry *entry = group->member_list;
+	int i;
 
 	/* Not aware means don't rouse */
 	if (!mflag_has(mon->mflag, MFLAG_AWARE)) return;
 
-	while (entry) {
-		struct monster *friend = &c->monsters[entry->midx];
+	for (i = 0; i < group->num_members; i++) {
+		struct monster *friend = cave_monster(c, group->members[i]);
 		struct loc fgrid = friend->grid;
 		if (friend->m_timed[MON_TMD_SLEEP] && monster_can_see(c, mon, fgrid)) {
 			int dist = distance(mon->grid, fgrid);
@@ -417,7 +468,6 @@ void monster_group_rouse(struct chunk *c, struct monster *mon)
 				monster_wake(friend, true, 50);
 			}
 		}
-		entry = entry->next;
 	}
 }
 
@@ -426,32 +476,49 @@ void monster_group_rouse(struct chunk *c, struct monster *mon)
  */
 int monster_primary_group_size(struct chunk *c, const struct monster *mon)
 {
-	int count = 0;
 	int index = mon->group_info[PRIMARY_GROUP].index;
 	struct monster_group *group = c->monster_groups[index];
-	struct mon_group_list_entry *entry = group->member_list;
 
-	while (entry) {
-		count++;
-		entry = entry->next;
+	return group->num_members;
+}
+
+/**
+ * Mark a monster as tracking the player or not, keeping count for its group
+ */
+void monster_group_track(struct chunk *c, struct monster *mon, bool tracking)
+{
+	int index = mon->group_info[PRIMARY_GROUP].index;
+	struct monster_group *group = c->monster_groups[index];
+
+	if (mflag_has(mon->mflag, MFLAG_TRACKING) == tracking) return;
+	if (tracking) {
+		mflag_on(mon->mflag, MFLAG_TRACKING);
+		if (group) group->tracking++;
+	} else {
+		mflag_off(mon->mflag, MFLAG_TRACKING);
+		if (group) group->tracking--;
 	}
-	return count;
 }
 
 /**
  * Find a group monster which is tracking
+ *
+ * Members that aren't tracking look for one every turn, so the group keeps
+ * count and a pack that has lost the player doesn't walk its whole list for
+ * each member.
  */
 struct monster *group_monster_tracking(struct chunk *c,
 									   const struct monster *mon)
 {
 	int index = mon->group_info[PRIMARY_GROUP].index;
 	struct monster_group *group = c->monster_groups[index];
-	struct mon_group_list_entry *entry = group->member_list;
+	int i;
 
-	while (entry) {
-		struct monster *tracker = cave_monster(c, entry->midx);
+	if (!group->tracking) return NULL;
+
+	for (i = 0; i < group->num_members; i++) {
+		struct monster *tracker = cave_monster(c, group->members[i]);
 		if (mflag_has(tracker->mflag, MFLAG_TRACKING)) return tracker;
-		entry = entry->next;
 	}
 
 	return NULL;
@@ -483,29 +550,6 @@ void monster_groups_verify(struct chunk *c)
 	int i;
 
 	for (i = 0; i < z_info->level_monster_max; i++) {
-		if (c->monster_groups[i]) {
-			struct monster_group *group = c->monster_groups[i];
-			struct mon_group_list_entry *entry = group->member_list;
-			while (entry) {
-				struct monster *mon = cave_monster(c, entry->midx);
-				struct monster_group_info *info = mon->group_info;
-				if (info[PRIMARY_GROUP].index != i) {
-					if (info[SUMMON_GROUP].index) {
-						if (info[SUMMON_GROUP].index != i) {
-							quit_fmt("Bad group index: group: %d, monster: %d",
-									 i, info[SUMMON_GROUP].index);
-						}
-						if (info[SUMMON_GROUP].role != MON_GROUP_LEADER) {
-							quit_fmt("Bad monster role: group: %d, monster: %d",
-									 i, info[SUMMON_GROUP].index);
-						}
-					} else {
-						quit_fmt("Bad group index: group: %d, monster: %d",
-								 i, info[PRIMARY_GROUP].index);
-					}
-				}
-				entry = entry->next;
-			}
-		}
+		monster_group_verify(c, i);
 	}
 }
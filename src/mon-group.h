@@ -20,15 +20,13 @@
 
 #include "monster.h"
 
-struct mon_group_list_entry {
-	int midx;
-	struct mon_group_list_entry *next;
-};
-
 struct monster_group {
 	int index;
 	int leader;
-	struct mon_group_list_entry *member_list;
+	int *members;		/* Monster indices of the members, in no order */
+	int num_members;
+	int members_size;
+	int tracking;		/* Members of this primary group that are tracking */
 };
 
 struct monster_group *monster_group_new(void);
@@ -46,6 +44,7 @@ bool monster_group_change_index(struct chunk *c, int new, int old);
 struct monster_group *summon_group(struct chunk *c, int midx);
 void monster_group_rouse(struct chunk *c, struct monster *mon);
 int monster_primary_group_size(struct chunk *c, const struct monster *mon);
+void monster_group_track(struct chunk *c, struct monster *mon, bool tracking);
 struct monster *group_monster_tracking(struct chunk *c,
 									   const struct monster *mon);
 int monster_group_leader_idx(struct monster_group *group);
@@ -18,6 +18,7 @@
  */
 
 #include "game-world.h"
+#include "init.h"
 #include "mon-desc.h"
 #include "mon-list.h"
 #include "mon-predicate.h"
@@ -43,6 +44,7 @@ monster_list_t *monster_list_new(void)
 	}
 
 	list->entries_size = size;
+	list->race_entry = mem_zalloc(z_info->r_max * sizeof(u16b));
 
 	return list;
 }
@@ -59,6 +61,7 @@ void monster_list_free(monster_list_t *list)
 		mem_free(list->entries);
 		list->entries = NULL;
 	}
+	mem_free(list->race_entry);
 
 	mem_free(list);
 	list = NULL;
@@ -137,7 +140,7 @@ void monster_list_reset(monster_list_t *list)
  */
 void monster_list_collect(monster_list_t *list)
 {
-	int i;
+	int i, used;
 
 	if (list == NULL || list->entries == NULL)
 		return;
@@ -145,11 +148,20 @@ void monster_list_collect(monster_list_t *list)
 	if (!monster_list_can_update(list))
 		return;
 
+	/* Note where each race already in the list is, in case it has been
+	 * sorted since it was last collected */
+	memset(list->race_entry, 0, z_info->r_max * sizeof(u16b));
+	for (used = 0; used < (int)list->entries_size; used++) {
+		if (list->entries[used].race == NULL)
+			break;
+		list->race_entry[list->entries[used].race->ridx] = used + 1;
+	}
+
 	/* Use cave_monster_max() here in case the monster list isn't compacted. */
 	for (i = 1; i < cave_monster_max(cave); i++) {
 		struct monster *mon = cave_monster(cave, i);
 		monster_list_entry_t *entry = NULL;
-		int j, field;
+		int field;
 		bool los = false;
 
 		/* Only consider visible, known monsters */
@@ -157,19 +169,15 @@ void monster_list_collect(monster_list_t *list)
 			continue;
 
 		/* Find or add a list entry. */
-		for (j = 0; j < (int)list->entries_size; j++) {
-			if (list->entries[j].race == NULL) {
-				/* We found an empty slot, so add this race here. */
-				entry = &list->entries[j];
-				memset(entry, 0, sizeof(monster_list_entry_t));
-				entry->race = mon->race;
-				break;
-			}
-			else if (list->entries[j].race == mon->race) {
-				/* We found a matching race and we'll use that. */
-				entry = &list->entries[j];
-				break;
-			}
+		if (list->race_entry[mon->race->ridx]) {
+			/* We found a matching race and we'll use that. */
+			entry = &list->entries[list->race_entry[mon->race->ridx] - 1];
+		} else if (used < (int)list->entries_size) {
+			/* Add this race in the next empty slot. */
+			entry = &list->entries[used++];
+			memset(entry, 0, sizeof(monster_list_entry_t));
+			entry->race = mon->race;
+			list->race_entry[mon->race->ridx] = used;
 		}
 
 		if (entry == NULL)
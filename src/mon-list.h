@@ -39,6 +39,7 @@ typedef struct monster_list_entry_s {
 typedef struct monster_list_s {
 	monster_list_entry_t *entries;
 	size_t entries_size;
+	u16b *race_entry;	/* One more than each race's entry, or 0 if none */
 	u16b distinct_entries;
 	s32b creation_turn;
 	bool sorted;
@@ -888,12 +888,17 @@ void lore_append_kills(textblock *tb, const struct monster_race *race,
 void lore_append_flavor(textblock *tb, const struct monster_race *race,
 						bool append_utf8)
 {
+	const char *text;
+
 	assert(tb && race);
 
+	text = monster_race_text(race);
+	if (!text)
+		text = "";
 	if (append_utf8)
-		textblock_append_utf8(tb, race->text);
+		textblock_append_utf8(tb, text);
 	else
-		textblock_append(tb, race->text);
+		textblock_append(tb, text);
 
 	textblock_append(tb, "\n");
 }
@@ -1647,156 +1652,277 @@ struct monster_lore *get_lore(const struct monster_race *race)
 
 
 /**
- * Write the monster lore
+ * Each race's entry in the lore file as it was last written, and the lore it
+ * was written from; saving only remakes the entries whose lore has changed
  */
-void write_lore_entries(ang_file *fff)
+static struct lore_entry {
+	struct monster_lore lore;
+	struct monster_blow *blows;
+	bool *blow_known;
+	char *text;
+	size_t len, size;
+} *lore_entries;
+
+/**
+ * Add formatted text to an entry
+ */
+static void lore_entry_putf(struct lore_entry *e, const char *fmt, ...)
 {
-	int i, n;
+	char buf[1024];
+	size_t n;
+	va_list vp;
+
+	va_start(vp, fmt);
+	n = vstrnfmt(buf, sizeof(buf), fmt, vp);
+	va_end(vp);
+
+	if (e->len + n + 1 > e->size) {
+		while (e->len + n + 1 > e->size)
+			e->size = e->size ? 2 * e->size : 256;
+		e->text = mem_realloc(e->text, e->size);
+	}
+	memcpy(e->text + e->len, buf, n + 1);
+	e->len += n;
+}
 
-	for (i = 0; i < z_info->r_max; i++) {
-		/* Current entry */
-		struct monster_race *race = &r_info[i];
-		struct monster_lore *lore = &l_list[i];
+/**
+ * Add the names of a set of flags to an entry, as write_flags() would
+ */
+static void lore_entry_flags(struct lore_entry *e, const char *intro_text,
+							 bitflag *flags, int flag_size,
+							 const char *names[])
+{
+	int flag;
+	char buf[1024] = "";
+	int pointer = 0;
+
+	for (flag = flag_next(flags, flag_size, FLAG_START); flag != FLAG_END;
+		 flag = flag_next(flags, flag_size, flag + 1)) {
+		if (strlen(buf)) {
+			my_strcat(buf, " | ", sizeof(buf));
+			pointer += 3;
+		}
 
-		/* Ignore non-existent or unseen monsters */
-		if (!race->name) continue;
-		if (!lore->sights && !lore->all_known) continue;
+		/* If no name, we're past the real flags */
+		if (!names[flag]) break;
+		my_strcat(buf, names[flag], sizeof(buf));
+		pointer += strlen(names[flag]);
 
-		/* Output 'name' */
-		file_putf(fff, "name:%s\n", race->name);
+		/* Move to a new line if this one is long enough */
+		if (pointer >= 60) {
+			lore_entry_putf(e, "%s%s\n", intro_text, buf);
+			my_strcpy(buf, "", sizeof(buf));
+			pointer = 0;
+		}
+	}
 
-		/* Output base if we're remembering everything */
-		if (lore->all_known)
-			file_putf(fff, "base:%s\n", race->base->name);
+	if (pointer)
+		lore_entry_putf(e, "%s%s\n", intro_text, buf);
+}
 
-		/* Output counts */
-		file_putf(fff, "counts:%d:%d:%d:%d:%d:%d:%d\n", lore->sights,
-				  lore->deaths, lore->tkills, lore->wake, lore->ignore,
-				  lore->cast_innate, lore->cast_spell);
+/**
+ * Make the lore file entry for a race
+ */
+static void lore_entry_make(struct lore_entry *e,
+							const struct monster_race *race,
+							const struct monster_lore *lore)
+{
+	int n;
 
-		/* Output blow (up to max blows) */
-		for (n = 0; n < z_info->mon_blows_max; n++) {
-			/* End of blows */
-			if (!lore->blow_known[n] && !lore->all_known) continue;
-			if (!lore->blows[n].method) continue;
+	e->len = 0;
 
-			/* Output blow method */
-			file_putf(fff, "blow:%s", lore->blows[n].method->name);
+	/* Output 'name' */
+	lore_entry_putf(e, "name:%s\n", race->name);
 
-			/* Output blow effect (may be none) */
-			file_putf(fff, ":%s", lore->blows[n].effect->name);
+	/* Output base if we're remembering everything */
+	if (lore->all_known)
+		lore_entry_putf(e, "base:%s\n", race->base->name);
+
+	/* Output counts */
+	lore_entry_putf(e, "counts:%d:%d:%d:%d:%d:%d:%d\n", lore->sights,
+					lore->deaths, lore->tkills, lore->wake, lore->ignore,
+					lore->cast_innate, lore->cast_spell);
+
+	/* Output blow (up to max blows) */
+	for (n = 0; n < z_info->mon_blows_max; n++) {
+		/* End of blows */
+		if (!lore->blow_known[n] && !lore->all_known) continue;
+		if (!lore->blows[n].method) continue;
+
+		/* Output blow method, effect (may be none), damage (may be 0),
+		 * number of times that blow has been seen and blow index */
+		lore_entry_putf(e, "blow:%s:%s:%d+%dd%dM%d:%d:%d\n",
+						lore->blows[n].method->name,
+						lore->blows[n].effect->name,
+						lore->blows[n].dice.base, lore->blows[n].dice.dice,
+						lore->blows[n].dice.sides,
+						lore->blows[n].dice.m_bonus,
+						lore->blows[n].times_seen, n);
+	}
 
-			/* Output blow damage (may be 0) */
-			file_putf(fff, ":%d+%dd%dM%d", lore->blows[n].dice.base,
-					lore->blows[n].dice.dice,
-					lore->blows[n].dice.sides,
-					lore->blows[n].dice.m_bonus);
+	/* Output flags */
+	lore_entry_flags(e, "flags:", (bitflag *) lore->flags, RF_SIZE,
+					 r_info_flags);
 
-			/* Output number of times that blow has been seen */
-			file_putf(fff, ":%d", lore->blows[n].times_seen);
+	/* Output spell flags (multiple lines) */
+	lore_entry_flags(e, "spells:", (bitflag *) lore->spell_flags, RSF_SIZE,
+					 r_info_spell_flags);
 
-			/* Output blow index */
-			file_putf(fff, ":%d", n);
+	/* Output 'drop' */
+	if (lore->drops) {
+		struct monster_drop *drop = lore->drops;
+		struct object_kind *kind = drop->kind;
+		char name[120] = "";
 
-			/* End line */
-			file_putf(fff, "\n");
+		while (drop) {
+			if (kind) {
+				object_short_name(name, sizeof name, kind->name);
+				lore_entry_putf(e, "drop:%s:%s:%d:%d:%d\n",
+								tval_find_name(kind->tval), name,
+								drop->percent_chance, drop->min, drop->max);
+			} else {
+				lore_entry_putf(e, "drop-base:%s:%d:%d:%d\n",
+								tval_find_name(drop->tval),
+								drop->percent_chance, drop->min, drop->max);
+			}
+			drop = drop->next;
 		}
+	}
 
-		/* Output flags */
-		write_flags(fff, "flags:", lore->flags, RF_SIZE, r_info_flags);
+	/* Output 'friends' */
+	if (lore->friends) {
+		struct monster_friends *f = lore->friends;
 
-		/* Output spell flags (multiple lines) */
-		rsf_inter(lore->spell_flags, race->spell_flags);
-		write_flags(fff, "spells:", lore->spell_flags, RSF_SIZE,
-					r_info_spell_flags);
-
-		/* Output 'drop' */
-		if (lore->drops) {
-			struct monster_drop *drop = lore->drops;
-			struct object_kind *kind = drop->kind;
-			char name[120] = "";
-
-			while (drop) {
-				if (kind) {
-					object_short_name(name, sizeof name, kind->name);
-					file_putf(fff, "drop:%s:%s:%d:%d:%d\n",
-							  tval_find_name(kind->tval), name,
-							  drop->percent_chance, drop->min, drop->max);
-					drop = drop->next;
-				} else {
-					file_putf(fff, "drop-base:%s:%d:%d:%d\n",
-							  tval_find_name(drop->tval), drop->percent_chance,
-							  drop->min, drop->max);
-					drop = drop->next;
+		while (f) {
+			if (f->role == MON_GROUP_MEMBER) {
+				lore_entry_putf(e, "friends:%d:%dd%d:%s\n", f->percent_chance,
+								f->number_dice, f->number_side,
+								f->race->name);
+			} else {
+				const char *role_name = NULL;
+				if (f->role == MON_GROUP_SERVANT) {
+					role_name = "servant";
+				} else if (f->role == MON_GROUP_BODYGUARD) {
+					role_name = "bodyguard";
 				}
+				lore_entry_putf(e, "friends:%d:%dd%d:%s:%s\n",
+								f->percent_chance, f->number_dice,
+								f->number_side, f->race->name, role_name);
 			}
+			f = f->next;
 		}
+	}
 
-		/* Output 'friends' */
-		if (lore->friends) {
-			struct monster_friends *f = lore->friends;
+	/* Output 'friends-base' */
+	if (lore->friends_base) {
+		struct monster_friends_base *b = lore->friends_base;
 
-			while (f) {
-				if (f->role == MON_GROUP_MEMBER) {
-					file_putf(fff, "friends:%d:%dd%d:%s\n", f->percent_chance,
-							  f->number_dice, f->number_side, f->race->name);
-				} else {
-					char *role_name = NULL;
-					if (f->role == MON_GROUP_SERVANT) {
-						role_name = string_make("servant");
-					} else if (f->role == MON_GROUP_BODYGUARD) {
-						role_name = string_make("bodyguard");
-					}
-					file_putf(fff, "friends:%d:%dd%d:%s:%s\n",
-							  f->percent_chance, f->number_dice,
-							  f->number_side, f->race->name, role_name);
-					string_free(role_name);
+		while (b) {
+			if (b->role == MON_GROUP_MEMBER) {
+				lore_entry_putf(e, "friends-base:%d:%dd%d:%s\n",
+								b->percent_chance, b->number_dice,
+								b->number_side, b->base->name);
+			} else {
+				const char *role_name = NULL;
+				if (b->role == MON_GROUP_SERVANT) {
+					role_name = "servant";
+				} else if (b->role == MON_GROUP_BODYGUARD) {
+					role_name = "bodyguard";
 				}
-				f = f->next;
+				lore_entry_putf(e, "friends-base:%d:%dd%d:%s:%s\n",
+								b->percent_chance, b->number_dice,
+								b->number_side, b->base->name, role_name);
 			}
+			b = b->next;
 		}
+	}
 
-		/* Output 'friends-base' */
-		if (lore->friends_base) {
-			struct monster_friends_base *b = lore->friends_base;
-
-			while (b) {
-				if (b->role == MON_GROUP_MEMBER) {
-					file_putf(fff, "friends-base:%d:%dd%d:%s\n",
-							  b->percent_chance, b->number_dice,
-							  b->number_side, b->base->name);
-				} else {
-					char *role_name = NULL;
-					if (b->role == MON_GROUP_SERVANT) {
-						role_name = string_make("servant");
-					} else if (b->role == MON_GROUP_BODYGUARD) {
-						role_name = string_make("bodyguard");
-					}
-					file_putf(fff, "friends-base:%d:%dd%d:%s:%s\n",
-							  b->percent_chance, b->number_dice,
-							  b->number_side, b->base->name, role_name);
-					string_free(role_name);
-				}
-				b = b->next;
-			}
+	/* Output 'mimic' */
+	if (lore->mimic_kinds) {
+		struct monster_mimic *m = lore->mimic_kinds;
+		struct object_kind *kind = m->kind;
+		char name[120] = "";
+
+		while (m) {
+			object_short_name(name, sizeof name, kind->name);
+			lore_entry_putf(e, "mimic:%s:%s\n", tval_find_name(kind->tval),
+							name);
+			m = m->next;
 		}
+	}
 
-		/* Output 'mimic' */
-		if (lore->mimic_kinds) {
-			struct monster_mimic *m = lore->mimic_kinds;
-			struct object_kind *kind = m->kind;
-			char name[120] = "";
+	lore_entry_putf(e, "\n");
+}
 
-			while (m) {
-				object_short_name(name, sizeof name, kind->name);
-				file_putf(fff, "mimic:%s:%s\n",
-						  tval_find_name(kind->tval), name);
-				m = m->next;
-			}
-		}
+/**
+ * Check whether a race's entry was made from its lore as it is now, and if
+ * not remember the lore and return false
+ */
+static bool lore_entry_check(struct lore_entry *e,
+							 const struct monster_lore *lore)
+{
+	size_t n_blows = z_info->mon_blows_max;
+
+	if (!e->blows) {
+		e->blows = mem_zalloc(n_blows * sizeof(struct monster_blow));
+		e->blow_known = mem_zalloc(n_blows * sizeof(bool));
+	}
+
+	if (e->text && !memcmp(lore, &e->lore, sizeof(*lore)) &&
+		!memcmp(lore->blows, e->blows, n_blows * sizeof(*lore->blows)) &&
+		!memcmp(lore->blow_known, e->blow_known, n_blows * sizeof(bool)))
+		return true;
+
+	memcpy(&e->lore, lore, sizeof(*lore));
+	memcpy(e->blows, lore->blows, n_blows * sizeof(*lore->blows));
+	memcpy(e->blow_known, lore->blow_known, n_blows * sizeof(bool));
+	return false;
+}
+
+/**
+ * Write the monster lore
+ */
+void write_lore_entries(ang_file *fff)
+{
+	int i;
 
-		file_putf(fff, "\n");
+	if (!lore_entries)
+		lore_entries = mem_zalloc(z_info->r_max * sizeof(*lore_entries));
+
+	for (i = 0; i < z_info->r_max; i++) {
+		/* Current entry */
+		struct monster_race *race = &r_info[i];
+		struct monster_lore *lore = &l_list[i];
+		struct lore_entry *e = &lore_entries[i];
+
+		/* Ignore non-existent or unseen monsters */
+		if (!race->name) continue;
+		if (!lore->sights && !lore->all_known) continue;
+
+		/* Only spells the race has are written */
+		rsf_inter(lore->spell_flags, race->spell_flags);
+
+		if (!lore_entry_check(e, lore))
+			lore_entry_make(e, race, lore);
+		file_put(fff, e->text);
+	}
+}
+
+/**
+ * Forget the lore file entries, as the races they are for go
+ */
+void lore_entries_free(void)
+{
+	int i;
+
+	if (!lore_entries) return;
+	for (i = 0; i < z_info->r_max; i++) {
+		mem_free(lore_entries[i].blows);
+		mem_free(lore_entries[i].blow_known);
+		mem_free(lore_entries[i].text);
 	}
+	mem_free(lore_entries);
+	lore_entries = NULL;
 }
 
 
@@ -121,6 +121,8 @@ void monster_flags_known(const struct monster_race *race,
 						 bitflag flags[RF_SIZE]);
 void lore_treasure(struct monster *mon, int num_item, int num_gold);
 struct monster_lore *get_lore(const struct monster_race *race);
+void write_lore_entries(ang_file *fff);
 bool lore_save(const char *name);
+void lore_entries_free(void);
 
 #endif /* MONSTER_LORE_H */
@@ -18,11 +18,13 @@
 
 #include "angband.h"
 #include "alloc.h"
+#include "game-profile.h"
 #include "game-world.h"
 #include "init.h"
 #include "mon-group.h"
 #include "mon-lore.h"
 #include "mon-make.h"
+#include "mon-move.h"
 #include "mon-predicate.h"
 #include "mon-timed.h"
 #include "mon-util.h"
@@ -52,6 +54,26 @@
 static s16b alloc_race_size;
 static struct alloc_entry *alloc_race_table;
 
+/**
+ * get_mon_num() keeps the running totals of prob3 for the last level it was
+ * asked about, and reuses them as long as nothing they depend on changes.
+ * Unique monsters can come and go at any time, so their entries are checked
+ * each time; everything else only changes with the restriction function,
+ * the player's depth or the date.
+ */
+static long *alloc_race_cumul;
+static s16b *alloc_race_uniques;
+static s16b alloc_race_unique_num;
+static u32b alloc_race_prep_stamp = 1;
+static struct {
+	u32b prep_stamp;
+	int level;
+	int depth;
+	bool christmas;
+	int num;
+	long total;
+} alloc_race_cache;
+
 /**
  * Initialize monster allocation info
  */
@@ -132,9 +154,21 @@ static void init_race_allocs(void) {
 	}
 	mem_free(already_counted);
 	mem_free(num);
+
+	/* Note where the uniques are */
+	alloc_race_cumul = mem_zalloc(alloc_race_size * sizeof(long));
+	alloc_race_uniques = mem_zalloc(alloc_race_size * sizeof(s16b));
+	alloc_race_unique_num = 0;
+	for (i = 0; i < alloc_race_size; i++) {
+		if (rf_has(r_info[table[i].index].flags, RF_UNIQUE))
+			alloc_race_uniques[alloc_race_unique_num++] = i;
+	}
+	alloc_race_cache.prep_stamp = 0;
 }
 
 static void cleanup_race_allocs(void) {
+	mem_free(alloc_race_uniques);
+	mem_free(alloc_race_cumul);
 	mem_free(alloc_race_table);
 }
 
@@ -163,31 +197,112 @@ void get_mon_num_prep(bool (*get_mon_num_hook)(struct monster_race *race))
 			entry->prob2 = 0;
 		}
 	}
+
+	/* Cached totals are now out of date */
+	alloc_race_prep_stamp++;
+}
+
+/**
+ * The prob3 for an allocation table entry, given the level being generated
+ * and whether it is Christmas
+ */
+static int get_mon_race_prob(const alloc_entry *entry, int level,
+							 bool christmas)
+{
+	struct monster_race *race = &r_info[entry->index];
+
+	/* No town monsters in dungeon */
+	if ((level > 0) && (entry->level <= 0)) return 0;
+
+	/* No seasonal monsters outside of Christmas */
+	if (rf_has(race->flags, RF_SEASONAL) && !christmas) return 0;
+
+	/* Only one copy of a a unique must be around at the same time */
+	if (rf_has(race->flags, RF_UNIQUE) && race->cur_num >= race->max_num)
+		return 0;
+
+	/* Some monsters never appear out of depth */
+	if (rf_has(race->flags, RF_FORCE_DEPTH) && race->level > player->depth)
+		return 0;
+
+	/* Accept */
+	return entry->prob2;
 }
 
 /**
- * Helper function for get_mon_num(). Scans the prepared monster allocation
- * table and picks a random monster. Returns the index of a monster in
- * `table`.
+ * Helper function for get_mon_num(). Makes sure prob3 and its running
+ * totals are right for `level`, and returns the total.
  */
-static struct monster_race *get_mon_race_aux(long total,
-											 const alloc_entry *table)
+static long get_mon_race_totals(int level)
 {
+	time_t cur_time = time(NULL);
+	struct tm *date = localtime(&cur_time);
+	bool christmas = date->tm_mon == 11 && date->tm_mday >= 24 &&
+		date->tm_mday <= 26;
+	alloc_entry *table = alloc_race_table;
 	int i;
+	long total = 0L;
+
+	/* See if the last totals will do */
+	if (alloc_race_cache.prep_stamp == alloc_race_prep_stamp &&
+		alloc_race_cache.level == level &&
+		alloc_race_cache.depth == player->depth &&
+		alloc_race_cache.christmas == christmas) {
+		bool valid = true;
+
+		for (i = 0; i < alloc_race_unique_num; i++) {
+			int n = alloc_race_uniques[i];
+			if (n >= alloc_race_cache.num) break;
+			if (table[n].prob3 != get_mon_race_prob(&table[n], level,
+													christmas)) {
+				valid = false;
+				break;
+			}
+		}
+		if (valid)
+			return alloc_race_cache.total;
+	}
+
+	/* Process probabilities */
+	for (i = 0; i < alloc_race_size; i++) {
+		/* Monsters are sorted by depth */
+		if (table[i].level > level) break;
 
+		table[i].prob3 = get_mon_race_prob(&table[i], level, christmas);
+		total += table[i].prob3;
+		alloc_race_cumul[i] = total;
+	}
+
+	alloc_race_cache.prep_stamp = alloc_race_prep_stamp;
+	alloc_race_cache.level = level;
+	alloc_race_cache.depth = player->depth;
+	alloc_race_cache.christmas = christmas;
+	alloc_race_cache.num = i;
+	alloc_race_cache.total = total;
+
+	return total;
+}
+
+/**
+ * Helper function for get_mon_num(). Picks a race from the prepared monster
+ * allocation table, weighted by prob3.
+ */
+static struct monster_race *get_mon_race_aux(long total)
+{
 	/* Pick a monster */
 	long value = randint0(total);
 
-	/* Find the monster */
-	for (i = 0; i < alloc_race_size; i++) {
-		/* Found the entry */
-		if (value < table[i].prob3) break;
-
-		/* Decrement */
-		value -= table[i].prob3;
+	/* Find the first entry whose running total passes it */
+	int lo = 0, hi = alloc_race_cache.num - 1;
+	while (lo < hi) {
+		int mid = (lo + hi) / 2;
+		if (alloc_race_cumul[mid] > value)
+			hi = mid;
+		else
+			lo = mid + 1;
 	}
 
-	return &r_info[table[i].index];
+	return &r_info[alloc_race_table[lo].index];
 }
 
 /**
@@ -214,59 +329,22 @@ static struct monster_race *get_mon_race_aux(long total,
  */
 struct monster_race *get_mon_num(int level)
 {
-	int i, p;
+	int p;
 	long total;
 	struct monster_race *race;
-	alloc_entry *table = alloc_race_table;
 
 	/* Occasionally produce a nastier monster in the dungeon */
 	if (level > 0 && one_in_(z_info->ood_monster_chance))
 		level += MIN(level / 4 + 2, z_info->ood_monster_amount);
 
-	total = 0L;
-
 	/* Process probabilities */
-	for (i = 0; i < alloc_race_size; i++) {
-		time_t cur_time = time(NULL);
-		struct tm *date = localtime(&cur_time);
-
-		/* Monsters are sorted by depth */
-		if (table[i].level > level) break;
-
-		/* Default */
-		table[i].prob3 = 0;
-
-		/* No town monsters in dungeon */
-		if ((level > 0) && (table[i].level <= 0)) continue;
-
-		/* Get the chosen monster */
-		race = &r_info[table[i].index];
-
-		/* No seasonal monsters outside of Christmas */
-		if (rf_has(race->flags, RF_SEASONAL) &&
-			!(date->tm_mon == 11 && date->tm_mday >= 24 && date->tm_mday <= 26))
-			continue;
-
-		/* Only one copy of a a unique must be around at the same time */
-		if (rf_has(race->flags, RF_UNIQUE) && race->cur_num >= race->max_num)
-			continue;
-
-		/* Some monsters never appear out of depth */
-		if (rf_has(race->flags, RF_FORCE_DEPTH) && race->level > player->depth)
-			continue;
-
-		/* Accept */
-		table[i].prob3 = table[i].prob2;
-
-		/* Total */
-		total += table[i].prob3;
-	}
+	total = get_mon_race_totals(level);
 
 	/* No legal monsters */
 	if (total <= 0) return NULL;
 
 	/* Pick a monster */
-	race = get_mon_race_aux(total, table);
+	race = get_mon_race_aux(total);
 
 	/* Try for a "harder" monster once (50%) or twice (10%) */
 	p = randint0(100);
@@ -275,7 +353,7 @@ struct monster_race *get_mon_num(int level)
 		struct monster_race *old = race;
 
 		/* Pick a new monster */
-		race = get_mon_race_aux(total, table);
+		race = get_mon_race_aux(total);
 
 		/* Keep the deepest one */
 		if (race->level < old->level) race = old;
@@ -286,7 +364,7 @@ struct monster_race *get_mon_num(int level)
 		struct monster_race *old = race;
 
 		/* Pick a monster */
-		race = get_mon_race_aux(total, table);
+		race = get_mon_race_aux(total);
 
 		/* Keep the deepest one */
 		if (race->level < old->level) race = old;
@@ -316,6 +394,7 @@ void delete_monster_idx(int m_idx)
 
 	/* Hack -- Reduce the racial counter */
 	mon->race->cur_num--;
+	cave_monster_hearing_remove(cave, mon);
 
 	/* Count the number of "reproducers" */
 	if (rf_has(mon->race->flags, RF_MULTIPLY)) {
@@ -360,6 +439,7 @@ void delete_monster_idx(int m_idx)
 
 	/* Wipe the Monster */
 	memset(mon, 0, sizeof(struct monster));
+	free_slots_push(&cave->mon_free, m_idx);
 
 	/* Count monsters */
 	cave->mon_cnt--;
@@ -426,6 +506,9 @@ void monster_index_move(int i1, int i2)
 	if (player->upkeep->health_who == mon)
 		player->upkeep->health_who = cave_monster(cave, i2);
 
+	/* The schedule refers to monsters by index */
+	monster_schedule_reindex(cave);
+
 	/* Move monster */
 	memcpy(cave_monster(cave, i2),
 			cave_monster(cave, i1),
@@ -433,6 +516,17 @@ void monster_index_move(int i1, int i2)
 
 	/* Wipe hole */
 	memset(cave_monster(cave, i1), 0, sizeof(struct monster));
+
+	/* Mark the monster again under its new index */
+	mon = cave_monster(cave, i2);
+	if (mflag_has(mon->mflag, MFLAG_CHANGED)) {
+		mflag_off(mon->mflag, MFLAG_CHANGED);
+		monster_mark_changed(cave, mon);
+	}
+	if (mflag_has(mon->mflag, MFLAG_HANDLED)) {
+		mflag_off(mon->mflag, MFLAG_HANDLED);
+		monster_mark_handled(cave, mon);
+	}
 }
 
 
@@ -518,6 +612,10 @@ void compact_monsters(int num_to_compact)
 		/* Compress "cave->mon_max" */
 		cave->mon_max--;
 	}
+
+	/* There are no holes left */
+	free_slots_reset(&cave->mon_free, z_info->level_monster_max);
+	cave->mon_free.complete = true;
 }
 
 
@@ -568,14 +666,20 @@ void wipe_mon_list(struct chunk *c, struct player *p)
 	for (i = 1; i < z_info->level_monster_max; i++) {
 		if (c->monster_groups[i]) {
 			monster_group_free(c, c->monster_groups[i]);
+			c->monster_groups[i] = NULL;
 		}
 	}
+	free_slots_reset(&c->group_free, z_info->level_monster_max);
 
 	/* Reset "cave->mon_max" */
 	c->mon_max = 1;
 
 	/* Reset "mon_cnt" */
 	c->mon_cnt = 0;
+	c->hearing_max = 0;
+	c->hearing_known = true;
+	free_slots_reset(&c->mon_free, z_info->level_monster_max);
+	c->mon_free.complete = true;
 
 	/* Reset "reproducer" count */
 	c->num_repro = 0;
@@ -619,11 +723,22 @@ s16b mon_pop(struct chunk *c)
 	}
 
 	/* Recycle dead monsters if we've run out of room */
-	for (m_idx = 1; m_idx < cave_monster_max(c); m_idx++) {
-		struct monster *mon = cave_monster(c, m_idx);
+	while (true) {
+		m_idx = free_slots_pop(&c->mon_free);
+		if (!m_idx) {
+			if (c->mon_free.complete) break;
+
+			/* Find all the dead monsters, lowest last so it is used first */
+			free_slots_reset(&c->mon_free, z_info->level_monster_max);
+			for (m_idx = cave_monster_max(c) - 1; m_idx >= 1; m_idx--)
+				if (!cave_monster(c, m_idx)->race)
+					free_slots_push(&c->mon_free, m_idx);
+			c->mon_free.complete = true;
+			continue;
+		}
 
 		/* Skip live monsters */
-		if (!mon->race) {
+		if (m_idx < cave_monster_max(c) && !cave_monster(c, m_idx)->race) {
 			/* Count monsters */
 			c->mon_cnt++;
 
@@ -733,7 +848,7 @@ static bool mon_create_drop(struct chunk *c, struct monster *mon, byte origin)
 			}
 
 			/* Allocate by hand, prep, apply magic */
-			obj = mem_zalloc(sizeof(*obj));
+			obj = object_new();
 			object_prep(obj, kind, 100, RANDOMISE);
 			obj->artifact = art;
 			copy_artifact_data(obj, obj->artifact);
@@ -750,8 +865,7 @@ static bool mon_create_drop(struct chunk *c, struct monster *mon, byte origin)
 				any = true;
 			} else {
 				obj->artifact->created = false;
-				object_wipe(obj);
-				mem_free(obj);
+				object_delete(&obj);
 			}
 		}
 	}
@@ -764,7 +878,7 @@ static bool mon_create_drop(struct chunk *c, struct monster *mon, byte origin)
 		/* Specified by tval or by kind */
 		if (drop->kind) {
 			/* Allocate by hand, prep, apply magic */
-			obj = mem_zalloc(sizeof(*obj));
+			obj = object_new();
 			object_prep(obj, drop->kind, level, RANDOMISE);
 			apply_magic(obj, level, true, good, great, extra_roll);
 		} else {
@@ -787,8 +901,7 @@ static bool mon_create_drop(struct chunk *c, struct monster *mon, byte origin)
 		if (monster_carry(c, mon, obj)) {
 			any = true;
 		} else {
-			object_wipe(obj);
-			mem_free(obj);
+			object_delete(&obj);
 		}
 	}
 
@@ -810,9 +923,9 @@ static bool mon_create_drop(struct chunk *c, struct monster *mon, byte origin)
 		if (monster_carry(c, mon, obj)) {
 			any = true;
 		} else {
-			obj->artifact->created = false;
-			object_wipe(obj);
-			mem_free(obj);
+			if (obj->artifact)
+				obj->artifact->created = false;
+			object_delete(&obj);
 		}
 	}
 
@@ -947,10 +1060,14 @@ s16b place_monster(struct chunk *c, struct loc grid, struct monster *mon,
 	/* Copy the monster */
 	new_mon = cave_monster(c, m_idx);
 	memcpy(new_mon, mon, sizeof(struct monster));
+	cave_monster_hearing_add(c, new_mon);
 
 	/* Set the ID */
 	new_mon->midx = m_idx;
 
+	/* Count its energy from now */
+	monster_set_energy(c, new_mon, new_mon->energy);
+
 	/* Set the location */
 	square_set_mon(c, grid, new_mon->midx);
 	new_mon->grid = grid;
@@ -1412,6 +1529,8 @@ bool pick_and_place_distant_monster(struct chunk *c, struct player *p, int dis,
 {
 	struct loc grid;
 	int	attempts_left = 10000;
+	bool placed = false;
+	u64b start_time = profile_begin();
 
 	assert(c);
 
@@ -1434,16 +1553,14 @@ bool pick_and_place_distant_monster(struct chunk *c, struct player *p, int dis,
 	if (!attempts_left) {
 		if (OPT(p, cheat_xtra) || OPT(p, cheat_hear))
 			msg("Warning! Could not allocate a new monster.");
-
-		return false;
+	} else {
+		/* Attempt to place the monster, allow groups */
+		placed = pick_and_place_monster(c, grid, depth, sleep, true,
+										ORIGIN_DROP);
 	}
 
-	/* Attempt to place the monster, allow groups */
-	if (pick_and_place_monster(c, grid, depth, sleep, true, ORIGIN_DROP))
-		return (true);
-
-	/* Nope */
-	return (false);
+	profile_end(PROFILE_GEN_MONSTERS, start_time);
+	return placed;
 }
 
 struct init_module mon_make_module = {
@@ -24,6 +24,7 @@
 
 #include "angband.h"
 #include "cave.h"
+#include "game-profile.h"
 #include "game-world.h"
 #include "init.h"
 #include "monster.h"
@@ -52,36 +53,6 @@
  * ------------------------------------------------------------------------
  * Routines to enable decisions on monster behaviour
  * ------------------------------------------------------------------------ */
-/**
- * From Will Asher in DJA:
- * Find whether a monster is near a permanent wall
- *
- * this decides whether PASS_WALL & KILL_WALL monsters use the monster flow code
- */
-static bool monster_near_permwall(const struct monster *mon, struct chunk *c)
-{
-	int y, x;
-	int my = mon->grid.y;
-	int mx = mon->grid.x;
-
-	/* If player is in LOS, there's no need to go around walls */
-    if (projectable(c, mon->grid, player->grid, PROJECT_NONE))
-		return false;
-
-    /* PASS_WALL & KILL_WALL monsters occasionally flow for a turn anyway */
-    if (randint0(99) < 5) return true;
-
-	/* Search the nearby grids, which are always in bounds */
-	for (y = (my - 2); y <= (my + 2); y++) {
-		for (x = (mx - 2); x <= (mx + 2); x++) {
-			struct loc grid = loc(x, y);
-           if (!square_in_bounds_fully(c, grid)) continue;
-            if (square_isperm(c, grid)) return true;
-		}
-	}
-	return false;
-}
-
 /**
  * Check if the monster can hear anything
  */
@@ -89,10 +60,10 @@ static bool monster_can_hear(struct chunk *c, struct monster *mon)
 {
 	int base_hearing = mon->race->hearing
 		- player->state.skills[SKILL_STEALTH] / 3;
-	if (c->noise.grids[mon->grid.y][mon->grid.x] == 0) {
+	if (square_noise(c, mon->grid) == 0) {
 		return false;
 	}
-	return base_hearing > c->noise.grids[mon->grid.y][mon->grid.x];
+	return base_hearing > square_noise(c, mon->grid);
 }
 
 /**
@@ -100,10 +71,10 @@ static bool monster_can_hear(struct chunk *c, struct monster *mon)
  */
 static bool monster_can_smell(struct chunk *c, struct monster *mon)
 {
-	if (c->scent.grids[mon->grid.y][mon->grid.x] == 0) {
+	if (square_scent(c, mon->grid) == 0) {
 		return false;
 	}
-	return mon->race->smell > c->scent.grids[mon->grid.y][mon->grid.x];
+	return mon->race->smell > square_scent(c, mon->grid);
 }
 
 /**
@@ -340,12 +311,58 @@ static bool get_move_bodyguard(struct chunk *c, struct monster *mon)
 }
 
 
+/**
+ * Choose the adjacent grid which takes a monster that passes or kills walls
+ * closest to the target through rock, using the FLOW_ROCK flow.
+ *
+ * The flow is only filled when a monster like this asks for it, and then
+ * only again when the target moves or permanent rock changes, so all such
+ * monsters on the level share it.
+ */
+static bool get_move_through_rock(struct chunk *c, struct monster *mon,
+								  struct loc target)
+{
+	int i, best;
+	bool found = false;
+
+	update_flow(c, FLOW_ROCK, target, 0, player);
+
+	/* Sealed off from the target by permanent rock */
+	best = square_flow(c, FLOW_ROCK, mon->grid);
+	if (!best) return false;
+
+	for (i = 0; i < 8; i++) {
+		struct loc grid = loc_sum(mon->grid, ddgrid_ddd[i]);
+		int dist;
+
+		if (!square_in_bounds(c, grid)) continue;
+
+		/* The target itself is as close as can be */
+		dist = loc_eq(grid, target) ? 0 : square_flow(c, FLOW_ROCK, grid);
+		if (dist >= best || (dist == 0 && !loc_eq(grid, target))) continue;
+
+		/* There's a monster blocking that we can't deal with */
+		if (!monster_can_kill(c, mon, grid) && !monster_can_move(c, mon, grid))
+			continue;
+
+		/* There's damaging terrain */
+		if (monster_hates_grid(c, mon, grid)) continue;
+
+		mon->target.grid = grid;
+		best = dist;
+		found = true;
+	}
+
+	return found;
+}
+
 /**
  * Choose the best direction to advance toward the player, using sound or scent.
  *
- * Ghosts and rock-eaters generally just head straight for the player. Other
- * monsters try sight, then current sound as saved in c->noise.grids[y][x],
- * then current scent as saved in c->scent.grids[y][x].
+ * Ghosts and rock-eaters head straight for the player if nothing is in the
+ * way, and otherwise follow the flow through rock.  Other monsters try
+ * sight, then current sound as given by square_noise(), then current scent
+ * as given by square_scent().
  *
  * This function assumes the monster is moving to an adjacent grid, and so the
  * noise can be louder by at most 1.  The monster target grid set by sound or
@@ -368,7 +385,7 @@ static bool get_move_advance(struct chunk *c, struct monster *mon, bool *track)
 
 	int base_hearing = mon->race->hearing
 		- player->state.skills[SKILL_STEALTH] / 3;
-	int current_noise = base_hearing - c->noise.grids[mon->grid.y][mon->grid.x];
+	int current_noise = base_hearing - square_noise(c, mon->grid);
 	int best_scent = 0;
 
 	struct loc best_grid;
@@ -383,10 +400,19 @@ static bool get_move_advance(struct chunk *c, struct monster *mon, bool *track)
 		}
 	}
 
-	/* If the monster can pass through nearby walls, do that */
-	if (monster_passes_walls(mon) && !monster_near_permwall(mon, c)) {
-		mon->target.grid = target;
-		return true;
+	/* If the monster can pass through walls, do that */
+	if (monster_passes_walls(mon)) {
+		/* Nothing in the way, so head straight there */
+		if (projectable_to_player(c, mon->grid)) {
+			mon->target.grid = target;
+			return true;
+		}
+
+		/* Go round any permanent rock */
+		if (get_move_through_rock(c, mon, target)) {
+			*track = true;
+			return true;
+		}
 	}
 
 	/* If the player can see monster, set target and run towards them */
@@ -399,15 +425,16 @@ static bool get_move_advance(struct chunk *c, struct monster *mon, bool *track)
 	for (i = 0; i < 8; i++) {
 		/* Get the location */
 		struct loc grid = loc_sum(mon->grid, ddgrid_ddd[i]);
-		int heard_noise = base_hearing - c->noise.grids[grid.y][grid.x];
+		int heard_noise;
 
 		/* Bounds check */
 		if (!square_in_bounds(c, grid)) {
 			continue;
 		}
+		heard_noise = base_hearing - square_noise(c, grid);
 
 		/* Must be some noise */
-		if (c->noise.grids[grid.y][grid.x] == 0) {
+		if (square_noise(c, grid) == 0) {
 			continue;
 		}
 
@@ -442,9 +469,9 @@ static bool get_move_advance(struct chunk *c, struct monster *mon, bool *track)
 			int smelled_scent;
 
 			/* If no good sound yet, use scent */
-			smelled_scent = mon->race->smell - c->scent.grids[grid.y][grid.x];
+			smelled_scent = mon->race->smell - square_scent(c, grid);
 			if ((smelled_scent > best_scent) &&
-				(c->scent.grids[grid.y][grid.x] != 0)) {
+				(square_scent(c, grid) != 0)) {
 				best_scent = smelled_scent;
 				best_grid = grid;
 				found = true;
@@ -483,6 +510,7 @@ static bool get_move_advance(struct chunk *c, struct monster *mon, bool *track)
 static bool get_move_find_safety(struct chunk *c, struct monster *mon)
 {
 	int i, dy, dx, d, dis, gdis = 0;
+	int noise = square_noise(c, mon->grid);
 
 	const int *y_offsets;
 	const int *x_offsets;
@@ -504,12 +532,15 @@ static bool get_move_find_safety(struct chunk *c, struct monster *mon)
 			/* Skip illegal locations */
 			if (!square_in_bounds_fully(c, grid)) continue;
 
+			/* Check for absence of shot (more or less); this is the test
+			 * most grids near a frightened monster fail, so it goes first */
+			if (square_isview(c, grid)) continue;
+
 			/* Skip locations in a wall */
 			if (!square_ispassable(c, grid)) continue;
 
 			/* Ignore too-distant grids */
-			if (c->noise.grids[grid.y][grid.x] >
-				c->noise.grids[mon->grid.y][mon->grid.x] + 2 * d)
+			if (square_noise(c, grid) > noise + 2 * d)
 				continue;
 
 			/* Ignore damaging terrain if they can't handle it */
@@ -517,16 +548,13 @@ static bool get_move_find_safety(struct chunk *c, struct monster *mon)
 				!rf_has(mon->race->flags, square_feat(c, grid)->resist_flag))
 				continue;
 
-			/* Check for absence of shot (more or less) */
-			if (!square_isview(c, grid)) {
-				/* Calculate distance from player */
-				dis = distance(grid, player->grid);
+			/* Calculate distance from player */
+			dis = distance(grid, player->grid);
 
-				/* Remember if further than previous */
-				if (dis > gdis) {
-					best = grid;
-					gdis = dis;
-				}
+			/* Remember if further than previous */
+			if (dis > gdis) {
+				best = grid;
+				gdis = dis;
 			}
 		}
 
@@ -579,17 +607,18 @@ static bool get_move_find_hiding(struct chunk *c, struct monster *mon)
 			/* Skip occupied locations */
 			if (!square_isempty(c, grid)) continue;
 
-			/* Check for hidden, available grid */
-			if (!square_isview(c, grid) &&
-				projectable(c, mon->grid, grid, PROJECT_STOP)) {
-				/* Calculate distance from player */
-				dis = distance(grid, player->grid);
+			/* Skip grids the player can see */
+			if (square_isview(c, grid)) continue;
 
-				/* Remember if closer than previous */
-				if (dis < gdis && dis >= min) {
-					best = grid;
-					gdis = dis;
-				}
+			/* Calculate distance from player */
+			dis = distance(grid, player->grid);
+
+			/* Remember if closer than previous and reachable; the path
+			 * check is much the dearest, so it comes last */
+			if (dis < gdis && dis >= min &&
+				projectable(c, mon->grid, grid, PROJECT_STOP)) {
+				best = grid;
+				gdis = dis;
 			}
 		}
 
@@ -648,7 +677,7 @@ static bool get_move_flee(struct chunk *c, struct monster *mon)
 		 * First half of calculation is inversely proportional to distance
 		 * Second half is inversely proportional to grid's distance from player
 		 */
-		score = 5000 / (dis + 3) - 500 / (c->noise.grids[grid.y][grid.x] + 1);
+		score = 5000 / (dis + 3) - 500 / (square_noise(c, grid) + 1);
 
 		/* No negative scores */
 		if (score < 0) score = 0;
@@ -794,7 +823,7 @@ static bool get_move(struct chunk *c, struct monster *mon, int *dir, bool *good)
 	if (get_move_advance(c, mon, good)) {
 		/* We have a good move, use it */
 		grid = loc_diff(mon->target.grid, mon->grid);
-		mflag_on(mon->mflag, MFLAG_TRACKING);
+		monster_group_track(c, mon, true);
 	} else {
 		/* Try to follow someone who knows where they're going */
 		struct monster *tracker = group_monster_tracking(c, mon);
@@ -806,7 +835,7 @@ static bool get_move(struct chunk *c, struct monster *mon, int *dir, bool *good)
 		}
 
 		/* No longer tracking */
-		mflag_off(mon->mflag, MFLAG_TRACKING);
+		monster_group_track(c, mon, false);
 	}
 
 	/* Monster is taking damage from terrain */
@@ -843,7 +872,7 @@ static bool get_move(struct chunk *c, struct monster *mon, int *dir, bool *good)
 				grid = loc_diff(mon->target.grid, mon->grid);
 
 				/* No longer tracking */
-				mflag_off(mon->mflag, MFLAG_TRACKING);
+				monster_group_track(c, mon, false);
 			}
 		}
 	}
@@ -861,7 +890,7 @@ static bool get_move(struct chunk *c, struct monster *mon, int *dir, bool *good)
 		}
 
 		/* No longer tracking */
-		mflag_off(mon->mflag, MFLAG_TRACKING);
+		monster_group_track(c, mon, false);
 		done = true;
 	}
 
@@ -916,31 +945,25 @@ static bool get_move(struct chunk *c, struct monster *mon, int *dir, bool *good)
  */
 bool multiply_monster(struct chunk *c, const struct monster *mon)
 {
-	struct loc grid;
-	int i;
-	bool result = false;
+	struct loc grids[8];
+	int i, n = 0;
 	struct monster_group_info info = { 0, 0 };
 
-	/* Try up to 18 times */
-	for (i = 0; i < 18; i++) {
-		int d = 1;
-
-		/* Pick a location */
-		scatter(c, &grid, mon->grid, d, true);
+	/* Find the empty floor grids next to the monster */
+	for (i = 0; i < 8; i++) {
+		struct loc grid = loc_sum(mon->grid, ddgrid_ddd[i]);
 
-		/* Require an "empty" floor grid */
+		if (!square_in_bounds_fully(c, grid)) continue;
 		if (!square_isempty(c, grid)) continue;
-
-		/* Create a new monster (awake, no groups) */
-		result = place_new_monster(c, grid, mon->race, false, false, info,
-								   ORIGIN_DROP_BREED);
-
-		/* Done */
-		break;
+		grids[n++] = grid;
 	}
 
-	/* Result */
-	return (result);
+	/* No room */
+	if (!n) return false;
+
+	/* Create a new monster (awake, no groups) in one of them */
+	return place_new_monster(c, grids[randint0(n)], mon->race, false, false,
+							 info, ORIGIN_DROP_BREED);
 }
 
 /**
@@ -1570,11 +1593,11 @@ static void monster_reduce_sleep(struct chunk *c, struct monster *mon)
 
 	} else if ((notice * notice * notice) <= player_noise) {
 		int sleep_reduction = 1;
-		int local_noise = c->noise.grids[mon->grid.y][mon->grid.x];
+		int local_noise = square_noise(c, mon->grid);
 
 		/* Test - wake up faster in hearing distance of the player 
 		 * Note no dependence on stealth for now */
-		if ((local_noise > 0) && (local_noise < 50)) {
+		if ((local_noise > 0) && (local_noise < NOISE_WAKE_MAX)) {
 			sleep_reduction = (100 / local_noise);
 		}
 
@@ -1688,125 +1711,679 @@ static void regen_monster(struct monster *mon, int num)
 
 /**
  * ------------------------------------------------------------------------
- * Monster processing routines to be called by the main game loop
+ * Monster energy and scheduling
+ *
+ * Rather than every monster being given energy on every game turn, each
+ * monster records its energy as of the start of some game turn, and the
+ * energy gained since is worked out when it is needed.  Since a monster's
+ * energy only increases between its moves, the turn in which it will next
+ * have enough energy to move can be calculated in advance; the chunk keeps
+ * its monsters in a heap ordered by that turn, so monsters which are not
+ * due to move are never visited by process_monsters().
+ *
+ * Anything that changes a monster's energy or speed must go through the
+ * functions here so that the schedule stays correct.
  * ------------------------------------------------------------------------ */
 /**
- * Process all the "live" monsters, once per game turn.
+ * The amount of energy a monster gains in a game turn at its current speed
+ */
+int monster_turn_energy(const struct monster *mon)
+{
+	int mspeed = mon->mspeed;
+
+	if (mon->m_timed[MON_TMD_FAST])
+		mspeed += 10;
+	if (mon->m_timed[MON_TMD_SLOW]) {
+		int slow_level = monster_effect_level((struct monster *)mon,
+											  MON_TMD_SLOW);
+		mspeed -= (2 * slow_level);
+	}
+
+	return turn_energy(mspeed);
+}
+
+/**
+ * Has the monster already had its energy for the current game turn?
  *
- * During each game turn, we scan through the list of all the "live" monsters,
- * (backwards, so we can excise any "freshly dead" monsters), energizing each
- * monster, and allowing fully energized monsters to move, attack, pass, etc.
+ * That is true if it has been handled this turn, or if the final monster
+ * pass of the turn has already gone past its index.
+ */
+static bool monster_turn_done(struct chunk *c, const struct monster *mon)
+{
+	if (mflag_has(mon->mflag, MFLAG_HANDLED)) return true;
+	return c->schedule.pass_turn == turn && mon->midx > c->schedule.pass_pos;
+}
+
+/**
+ * Bring a monster's stored energy up to date, at a rate of `gain` per turn
+ */
+static void monster_energy_sync(struct chunk *c, struct monster *mon,
+								int gain)
+{
+	s32b target = turn + (monster_turn_done(c, mon) ? 1 : 0);
+
+	if (target > mon->energy_turn) {
+		mon->energy += (target - mon->energy_turn) * gain;
+		mon->energy_turn = target;
+	}
+}
+
+/**
+ * Add an entry to a heap
+ */
+static void mon_heap_push(struct mon_heap *h, s32b key, s16b midx)
+{
+	struct mon_sched_entry entry;
+	int i;
+
+	if (h->num == h->size) {
+		h->size = h->size ? h->size * 2 : 64;
+		h->entries = mem_realloc(h->entries, h->size * sizeof(*h->entries));
+	}
+
+	/* Sift up from the end */
+	entry.key = key;
+	entry.midx = midx;
+	for (i = h->num++; i > 0; i = (i - 1) / 2) {
+		int parent = (i - 1) / 2;
+		if (h->entries[parent].key <= key) break;
+		h->entries[i] = h->entries[parent];
+	}
+	h->entries[i] = entry;
+}
+
+/**
+ * Remove the entry with the smallest key from a heap
+ */
+static struct mon_sched_entry mon_heap_pop(struct mon_heap *h)
+{
+	struct mon_sched_entry top = h->entries[0], last;
+	int i = 0;
+
+	last = h->entries[--h->num];
+	while (true) {
+		int child = 2 * i + 1;
+		if (child >= h->num) break;
+		if ((child + 1 < h->num) &&
+			(h->entries[child + 1].key < h->entries[child].key))
+			child++;
+		if (last.key <= h->entries[child].key) break;
+		h->entries[i] = h->entries[child];
+		i = child;
+	}
+	if (h->num) h->entries[i] = last;
+
+	return top;
+}
+
+/**
+ * Add a monster to the list of those due this turn, keeping it in order
+ */
+static void schedule_add_due(struct mon_schedule *s, s16b midx)
+{
+	int i, pos = 0;
+
+	while (pos < s->due_num && s->due[pos] > midx) pos++;
+	if (pos < s->due_num && s->due[pos] == midx) return;
+
+	for (i = s->due_num; i > pos; i--)
+		s->due[i] = s->due[i - 1];
+	s->due[pos] = midx;
+	s->due_num++;
+
+	/* Keep the current pass where it was */
+	if (pos <= s->due_pos) s->due_pos++;
+}
+
+/**
+ * Work out when a monster will next be due to act, and schedule it
+ */
+static void monster_schedule(struct chunk *c, struct monster *mon)
+{
+	struct mon_schedule *s = &c->schedule;
+	int gain = monster_turn_energy(mon);
+	s32b due;
+
+	if (!s->built || !mon->race) return;
+	if (mflag_has(mon->mflag, MFLAG_DORMANT)) return;
+
+	/* Gain is never less than one, so the monster will move eventually */
+	if (mon->energy >= z_info->move_energy) {
+		due = mon->energy_turn;
+	} else {
+		due = mon->energy_turn +
+			(z_info->move_energy - mon->energy + gain - 1) / gain;
+	}
+
+	/* Already scheduled for then */
+	if (due == mon->sched_turn) return;
+	mon->sched_turn = due;
+	mon_heap_push(&s->queue, due, mon->midx);
+
+	/* Due now, but this turn's monsters have already been picked */
+	if (due <= turn && s->due_turn == turn)
+		schedule_add_due(s, mon->midx);
+}
+
+/**
+ * ------------------------------------------------------------------------
+ * Dormant monsters
  *
- * This function and its children are responsible for a considerable fraction
- * of the processor time in normal situations, greater if the character is
- * resting.
+ * A monster which is inactive when its turn comes round does nothing but
+ * use up energy, and will stay that way until the player comes near or
+ * something happens to it.  Monsters far enough away are taken out of the
+ * schedule, and put back in with their energy fast-forwarded when the
+ * player or the source of noise has moved far enough to be able to affect
+ * them, or when they are disturbed by damage, timed effects, being moved,
+ * or the terrain under them changing.
+ * ------------------------------------------------------------------------ */
+/**
+ * Distance in the metric the noise and view maps spread in
  */
-void process_monsters(struct chunk *c, int minimum_energy)
+static int grid_steps(struct loc grid1, struct loc grid2)
 {
+	return MAX(ABS(grid1.x - grid2.x), ABS(grid1.y - grid2.y));
+}
+
+/**
+ * Add up how far the player and the noise source have moved since last time
+ */
+static void schedule_update_travel(struct chunk *c)
+{
+	struct mon_schedule *s = &c->schedule;
+
+	s->travel += grid_steps(s->travel_player, player->grid);
+	s->travel += grid_steps(s->travel_source, c->flows[FLOW_NOISE].source);
+	s->travel_player = player->grid;
+	s->travel_source = c->flows[FLOW_NOISE].source;
+}
+
+/**
+ * How far the player and noise source can move before an inactive monster
+ * could become active; zero if it could happen right away.
+ *
+ * Noise spreads one grid per step, so a monster can't hear anything until
+ * the noise source is within its hearing; it can't see, smell or sense the
+ * player by passing walls until the player is within sight, scent-laying or
+ * hearing range; and nothing but the monster itself being disturbed can make
+ * it hurt or put it on damaging terrain.  Stealth only ever reduces hearing.
+ */
+static int monster_dormant_slack(struct chunk *c, struct monster *mon)
+{
+	int hearing = mon->race->hearing;
+	int range = MAX(MAX(hearing, z_info->max_sight), 2);
+	int slack = grid_steps(mon->grid, player->grid) - range;
 	int i;
-	int mspeed;
 
-	/* Only process some things every so often */
-	bool regen = false;
+	/* No timed effects pending */
+	for (i = 0; i < MON_TMD_MAX; i++)
+		if (mon->m_timed[i]) return 0;
 
-	/* Regenerate hitpoints and mana every 100 game turns */
-	if (turn % 100 == 0)
-		regen = true;
+	/* Mimics are left alone */
+	if (monster_is_mimicking(mon)) return 0;
 
-	/* Process the monsters (backwards) */
-	for (i = cave_monster_max(c) - 1; i >= 1; i--) {
-		struct monster *mon;
-		bool moving;
+	/* Must be unable to act for now, not just busy with something else */
+	if (mon->hp < mon->maxhp || monster_can_smell(c, mon) ||
+		monster_taking_terrain_damage(mon))
+		return 0;
 
-		/* Handle "leaving" */
-		if (player->is_dead || player->upkeep->generate_level) break;
+	return MAX(0, MIN(slack,
+					  grid_steps(mon->grid, c->flows[FLOW_NOISE].source) - hearing + 1));
+}
 
-		/* Get a 'live' monster */
-		mon = cave_monster(c, i);
-		if (!mon->race) continue;
+/**
+ * Fast-forward the energy of a monster which has done nothing but use up
+ * energy whenever it could since its energy was last counted
+ */
+static void monster_energy_fast_forward(struct chunk *c, struct monster *mon)
+{
+	int gain = monster_turn_energy(mon);
+	s32b target = turn + (monster_turn_done(c, mon) ? 1 : 0);
+
+	while (mon->energy_turn < target) {
+		s32b steps;
 
-		/* Ignore monsters that have already been handled */
-		if (mflag_has(mon->mflag, MFLAG_HANDLED))
+		/* Take a turn */
+		if (mon->energy >= z_info->move_energy) {
+			mon->energy += gain - z_info->move_energy;
+			mon->energy_turn++;
 			continue;
+		}
+
+		/* Build up to the next one */
+		steps = (z_info->move_energy - mon->energy + gain - 1) / gain;
+		steps = MIN(steps, target - mon->energy_turn);
+		mon->energy += steps * gain;
+		mon->energy_turn += steps;
+	}
+}
+
+/**
+ * Take an inactive monster out of the schedule if the player is far enough
+ * away; returns whether it was
+ */
+static bool monster_park(struct chunk *c, struct monster *mon)
+{
+	struct mon_schedule *s = &c->schedule;
+	int slack = monster_dormant_slack(c, mon);
 
-		/* Not enough energy to move yet */
-		if (mon->energy < minimum_energy) continue;
+	if (!slack) return false;
 
-		/* Does this monster have enough energy to move? */
-		moving = mon->energy >= z_info->move_energy ? true : false;
+	mflag_on(mon->mflag, MFLAG_DORMANT);
+	mon->sched_turn = s->travel + slack;
+	mon_heap_push(&s->dormant, mon->sched_turn, mon->midx);
+	return true;
+}
 
-		/* Prevent reprocessing */
-		mflag_on(mon->mflag, MFLAG_HANDLED);
+/**
+ * Put a dormant monster back in the schedule
+ */
+void monster_rejoin(struct chunk *c, struct monster *mon)
+{
+	if (!mflag_has(mon->mflag, MFLAG_DORMANT)) return;
 
-		/* Handle monster regeneration if requested */
-		if (regen)
-			regen_monster(mon, 1);
+	mflag_off(mon->mflag, MFLAG_DORMANT);
+	monster_energy_fast_forward(c, mon);
+	mon->sched_turn = -1;
+	monster_schedule(c, mon);
+}
 
-		/* Calculate the net speed */
-		mspeed = mon->mspeed;
-		if (mon->m_timed[MON_TMD_FAST])
-			mspeed += 10;
-		if (mon->m_timed[MON_TMD_SLOW]) {
-			int slow_level = monster_effect_level(mon, MON_TMD_SLOW);
-			mspeed -= (2 * slow_level);
+/**
+ * Return the monsters the player has come close enough to affect
+ */
+static void schedule_wake_dormant(struct chunk *c)
+{
+	struct mon_schedule *s = &c->schedule;
+
+	schedule_update_travel(c);
+	while (s->dormant.num && s->dormant.entries[0].key <= s->travel) {
+		struct mon_sched_entry entry = mon_heap_pop(&s->dormant);
+		struct monster *mon = cave_monster(c, entry.midx);
+
+		/* Discard entries for monsters which have since rejoined */
+		if (!mon->race || !mflag_has(mon->mflag, MFLAG_DORMANT)) continue;
+		if (mon->sched_turn != entry.key) continue;
+
+		/* Check again, as it would have on its last turn */
+		mflag_off(mon->mflag, MFLAG_DORMANT);
+		monster_energy_fast_forward(c, mon);
+		if (!monster_park(c, mon)) {
+			mon->sched_turn = -1;
+			monster_schedule(c, mon);
 		}
+	}
+}
 
-		/* Give this monster some energy */
-		mon->energy += turn_energy(mspeed);
+/**
+ * Put all dormant monsters back in the schedule
+ */
+static void schedule_rejoin_all(struct chunk *c)
+{
+	int i;
 
-		/* End the turn of monsters without enough energy to move */
-		if (!moving)
-			continue;
+	for (i = 1; i < cave_monster_max(c); i++) {
+		struct monster *mon = cave_monster(c, i);
+		if (!mon->race) continue;
+		if (!mflag_has(mon->mflag, MFLAG_DORMANT)) continue;
+		mflag_off(mon->mflag, MFLAG_DORMANT);
+		monster_energy_fast_forward(c, mon);
+	}
+	c->schedule.dormant.num = 0;
+}
+
+/**
+ * Build the schedule for a chunk from its monster list.
+ *
+ * Stored energy is normally taken to be current as of now, so monsters on a
+ * level don't gain energy while the player is elsewhere; after monsters are
+ * only moved round the monster list it is kept as it was.
+ */
+static void schedule_build(struct chunk *c)
+{
+	struct mon_schedule *s = &c->schedule;
+	int i;
 
-		/* Use up "some" energy */
-		mon->energy -= z_info->move_energy;
+	s->queue.num = 0;
+	s->dormant.num = 0;
+	s->due_num = 0;
+	s->due_turn = -1;
+	s->travel_player = player->grid;
+	s->travel_source = c->flows[FLOW_NOISE].source;
+	if (!s->due)
+		s->due = mem_zalloc(z_info->level_monster_max * sizeof(*s->due));
+	s->built = true;
+
+	for (i = 1; i < cave_monster_max(c); i++) {
+		struct monster *mon = cave_monster(c, i);
+		if (!mon->race) continue;
+		mflag_off(mon->mflag, MFLAG_DORMANT);
+		if (!s->keep_energy)
+			mon->energy_turn = turn + (monster_turn_done(c, mon) ? 1 : 0);
+		mon->sched_turn = -1;
+		monster_schedule(c, mon);
+	}
+	s->keep_energy = false;
+}
+
+/**
+ * Sort by descending index
+ */
+static int cmp_midx_desc(const void *a, const void *b)
+{
+	return *(const s16b *)b - *(const s16b *)a;
+}
+
+/**
+ * Take the monsters due to act this turn off the heap
+ */
+static void schedule_extract_due(struct chunk *c)
+{
+	struct mon_schedule *s = &c->schedule;
+	int i, n = 0;
+
+	s->due_num = 0;
+	while (s->queue.num && s->queue.entries[0].key <= turn) {
+		struct mon_sched_entry entry = mon_heap_pop(&s->queue);
+		struct monster *mon = cave_monster(c, entry.midx);
+
+		/* Discard entries superseded by rescheduling, parking or death */
+		if (!mon->race || mflag_has(mon->mflag, MFLAG_DORMANT)) continue;
+		if (mon->sched_turn != entry.key) continue;
+		s->due[s->due_num++] = entry.midx;
+	}
+	sort(s->due, s->due_num, sizeof(*s->due), cmp_midx_desc);
+
+	/* Remove duplicates */
+	for (i = 0; i < s->due_num; i++) {
+		if (n && s->due[n - 1] == s->due[i]) continue;
+		s->due[n++] = s->due[i];
+	}
+	s->due_num = n;
+	s->due_turn = turn;
+}
+
+/**
+ * Get a monster's current energy
+ */
+int monster_energy(struct chunk *c, struct monster *mon)
+{
+	monster_rejoin(c, mon);
+	monster_energy_sync(c, mon, monster_turn_energy(mon));
+	return mon->energy;
+}
+
+/**
+ * Set a monster's current energy
+ */
+void monster_set_energy(struct chunk *c, struct monster *mon, int energy)
+{
+	monster_rejoin(c, mon);
+	mon->energy = energy;
+	mon->sched_turn = -1;
+	mon->energy_turn = turn + (monster_turn_done(c, mon) ? 1 : 0);
+	monster_schedule(c, mon);
+}
+
+/**
+ * Reschedule a monster whose speed has changed; `old_gain` is its gain in
+ * energy per turn before the change
+ */
+void monster_speed_changed(struct chunk *c, struct monster *mon, int old_gain)
+{
+	monster_energy_sync(c, mon, old_gain);
+	monster_schedule(c, mon);
+}
 
-		/* Mimics lie in wait */
-		if (monster_is_mimicking(mon)) continue;
+/**
+ * Bring the energy of every monster on a level up to date, and drop the
+ * schedule so it is rebuilt when next needed.
+ *
+ * This is needed when the level is left, so that no energy accrues while
+ * it is stored, and before saving.
+ */
+void monster_schedule_reset(struct chunk *c)
+{
+	int i;
 
+	if (!c->schedule.built) return;
+	schedule_rejoin_all(c);
+	for (i = 1; i < cave_monster_max(c); i++) {
+		struct monster *mon = cave_monster(c, i);
+		if (!mon->race) continue;
+		monster_energy_sync(c, mon, monster_turn_energy(mon));
+	}
+	c->schedule.built = false;
+	c->schedule.keep_energy = false;
+}
+
+/**
+ * Rebuild the schedule for a level once monsters have changed index
+ */
+void monster_schedule_reindex(struct chunk *c)
+{
+	if (!c->schedule.built) return;
+	schedule_rejoin_all(c);
+	c->schedule.built = false;
+	c->schedule.keep_energy = true;
+}
+
+/**
+ * Mark a monster as having had its turn, noting it so that reset_monsters()
+ * needn't look at every monster to find it again
+ */
+void monster_mark_handled(struct chunk *c, struct monster *mon)
+{
+	if (mflag_has(mon->mflag, MFLAG_HANDLED)) return;
+	mflag_on(mon->mflag, MFLAG_HANDLED);
+
+	/* Too many to track, so clear everyone */
+	if (c->mon_handled_num >= z_info->level_monster_max)
+		c->mon_handled_all = true;
+	else
+		c->mon_handled[c->mon_handled_num++] = mon->midx;
+}
+
+/**
+ * Give a monster its energy for this turn, and let it act if it can.
+ */
+static void process_monster_turn(struct chunk *c, struct monster *mon,
+								 bool regen)
+{
+	/* Does this monster have enough energy to move? */
+	bool moving = mon->energy >= z_info->move_energy ? true : false;
+	bool active = false;
+
+	/* Prevent reprocessing */
+	monster_mark_handled(c, mon);
+
+	/* Update monster visibility after this */
+	if (moving)
+		monster_mark_changed(c, mon);
+
+	/* Handle monster regeneration if requested */
+	if (regen)
+		regen_monster(mon, 1);
+
+	/* Give this monster some energy */
+	mon->energy += monster_turn_energy(mon);
+	mon->energy_turn = turn + 1;
+
+	/* End the turn of monsters without enough energy to move */
+	if (!moving)
+		return;
+
+	/* Use up "some" energy */
+	mon->energy -= z_info->move_energy;
+
+	/* Mimics lie in wait */
+	if (!monster_is_mimicking(mon)) {
 		/* Check if the monster is active */
-		if (monster_check_active(c, mon)) {
+		active = monster_check_active(c, mon);
+		if (active) {
 			/* Process timed effects - skip turn if necessary */
-			if (process_monster_timed(c, mon))
-				continue;
+			if (!process_monster_timed(c, mon)) {
+				u64b start = trace_begin();
+				int ridx = mon->race->ridx;
 
-			/* Set this monster to be the current actor */
-			c->mon_current = i;
+				/* Set this monster to be the current actor */
+				c->mon_current = mon->midx;
 
-			/* The monster takes its turn */
-			monster_turn(c, mon);
+				/* The monster takes its turn */
+				monster_turn(c, mon);
+				trace_end(TRACE_MONSTER_TURN, ridx, start);
 
-			/* Monster is no longer current */
-			c->mon_current = -1;
+				/* Monster is no longer current */
+				c->mon_current = -1;
+			}
 		}
 	}
 
-	/* Update monster visibility after this */
-	/* XXX This may not be necessary */
-	player->upkeep->update |= PU_MONSTERS;
+	/* Inactive monsters far from the player can be left until needed */
+	if (mon->race && !active && monster_park(c, mon))
+		return;
+
+	/* Work out when it gets to move next */
+	monster_schedule(c, mon);
+}
+
+/**
+ * ------------------------------------------------------------------------
+ * Monster processing routines to be called by the main game loop
+ * ------------------------------------------------------------------------ */
+/**
+ * Process all the "live" monsters, once per game turn.
+ *
+ * During each game turn, every "live" monster is energized, and fully
+ * energized monsters move, attack, pass, etc, in order of index (backwards,
+ * so we can excise any "freshly dead" monsters).  Only the monsters due to
+ * act are actually visited; the rest get their energy lazily.  On turns when
+ * monsters regenerate, all but dormant ones are visited as they used to be.
+ *
+ * Monsters with less than `minimum_energy` are left for a later call in the
+ * same game turn.  A call with `minimum_energy` zero is the final pass of
+ * the turn, after which every monster has been energized.
+ *
+ * This function and its children are responsible for a considerable fraction
+ * of the processor time in normal situations, greater if the character is
+ * resting.
+ */
+void process_monsters(struct chunk *c, int minimum_energy)
+{
+	struct mon_schedule *s = &c->schedule;
+	int i;
+	enum mem_tag tag = mem_tag_set(MEM_TAG_MONSTER);
+
+	/* Regenerate hitpoints and mana every 100 game turns */
+	bool regen = (turn % 100 == 0) ? true : false;
+
+	/* Find who is due to move */
+	if (!s->built)
+		schedule_build(c);
+	if (s->due_turn != turn)
+		schedule_extract_due(c);
+	schedule_wake_dormant(c);
+
+	/* The final pass gives energy to everyone it passes */
+	if (!minimum_energy) {
+		s->pass_turn = turn;
+		s->pass_pos = cave_monster_max(c);
+	}
+
+	if (regen) {
+		/* Process the monsters (backwards) */
+		for (i = cave_monster_max(c) - 1; i >= 1; i--) {
+			struct monster *mon;
+
+			/* Handle "leaving" */
+			if (player->is_dead || player->upkeep->generate_level) break;
+
+			/* Get a 'live' monster not yet handled this turn */
+			mon = cave_monster(c, i);
+			if (!minimum_energy) s->pass_pos = i;
+			if (!mon->race) continue;
+			if (mflag_has(mon->mflag, MFLAG_HANDLED)) continue;
+			if (mflag_has(mon->mflag, MFLAG_DORMANT)) continue;
+
+			/* Not enough energy to move yet */
+			monster_energy_sync(c, mon, monster_turn_energy(mon));
+			if (mon->energy < minimum_energy) continue;
+
+			process_monster_turn(c, mon, regen);
+		}
+	} else {
+		/* Process the monsters due to move (backwards) */
+		for (s->due_pos = 0; s->due_pos < s->due_num; s->due_pos++) {
+			struct monster *mon;
+			s16b midx = s->due[s->due_pos];
+
+			/* Handle "leaving" */
+			if (player->is_dead || player->upkeep->generate_level) break;
+
+			/* Get a 'live' monster not yet handled this turn */
+			mon = cave_monster(c, midx);
+			if (!minimum_energy) s->pass_pos = midx;
+			if (!mon->race) continue;
+			if (mflag_has(mon->mflag, MFLAG_HANDLED)) continue;
+			if (mflag_has(mon->mflag, MFLAG_DORMANT)) continue;
+
+			/* Not enough energy to move yet */
+			monster_energy_sync(c, mon, monster_turn_energy(mon));
+			if (mon->energy < minimum_energy) continue;
+			if (mon->energy < z_info->move_energy) continue;
+
+			process_monster_turn(c, mon, regen);
+		}
+	}
+
+	/* Every monster has now had its energy */
+	if (!minimum_energy && !player->is_dead &&
+		!player->upkeep->generate_level)
+		s->pass_pos = 0;
+
+	mem_tag_set(tag);
 }
 
 /**
  * Clear 'moved' status from all monsters.
  *
  * Clear noise if appropriate.
+ *
+ * This runs every game turn, so only the monsters noted by
+ * monster_mark_handled() are visited, and the monster list is only walked for
+ * terrain damage when the level has some damaging terrain.
  */
 void reset_monsters(void)
 {
 	int i;
 	struct monster *mon;
+	bool fiery = false;
 
-	/* Process the monsters (backwards) */
-	for (i = cave_monster_max(cave) - 1; i >= 1; i--) {
+	/* Look for terrain that damages monsters standing in it */
+	for (i = 0; i < z_info->f_max && !fiery; i++)
+		if (cave->feat_count[i] && feat_is_fiery(i))
+			fiery = true;
+
+	/* Dungeon hurts monsters (backwards) */
+	for (i = cave_monster_max(cave) - 1; fiery && i >= 1; i--) {
 		/* Access the monster */
 		mon = cave_monster(cave, i);
+		if (!mon->race) continue;
 
-		/* Dungeon hurts monsters */
 		monster_take_terrain_damage(mon);
+	}
 
-		/* Monster is ready to go again */
-		mflag_off(mon->mflag, MFLAG_HANDLED);
+	/* Monsters are ready to go again */
+	if (cave->mon_handled_all) {
+		for (i = cave_monster_max(cave) - 1; i >= 1; i--)
+			mflag_off(cave_monster(cave, i)->mflag, MFLAG_HANDLED);
+		cave->mon_handled_all = false;
+	} else {
+		for (i = 0; i < cave->mon_handled_num; i++) {
+			mon = cave_monster(cave, cave->mon_handled[i]);
+			mflag_off(mon->mflag, MFLAG_HANDLED);
+		}
 	}
+	cave->mon_handled_num = 0;
 }
 
 /**
@@ -20,7 +20,16 @@
 
 
 bool multiply_monster(struct chunk *c, const struct monster *mon);
+int monster_energy(struct chunk *c, struct monster *mon);
+void monster_set_energy(struct chunk *c, struct monster *mon, int energy);
+void monster_speed_changed(struct chunk *c, struct monster *mon,
+						   int old_gain);
+int monster_turn_energy(const struct monster *mon);
+void monster_schedule_reset(struct chunk *c);
+void monster_schedule_reindex(struct chunk *c);
+void monster_rejoin(struct chunk *c, struct monster *mon);
 void process_monsters(struct chunk *c, int minimum_energy);
+void monster_mark_handled(struct chunk *c, struct monster *mon);
 void reset_monsters(void);
 void restore_monsters(void);
 
@@ -36,6 +36,13 @@
 #define MON_MSG_FLAG_OFFSCREEN	0x01
 #define MON_MSG_FLAG_INVISIBLE	0x02
 
+/**
+ * Sizes of the hash tables for finding stacked messages and history; powers
+ * of two, at least twice the number of entries so probes stay short
+ */
+#define MON_MSG_HASH_SIZE		512
+#define MON_HIST_HASH_SIZE		1024
+
 /**
  * A stacked monster message entry
  */
@@ -45,6 +52,7 @@ struct monster_race_message {
 	int msg_code;				/* The coded message */
 	int count;					/* How many monsters triggered this message */
 	int delay;					/* messages will be processed in this order: delay = 0, 1, 2 */
+	int slot;					/* Where it is in mon_msg_hash */
 };
 
 /**
@@ -53,6 +61,7 @@ struct monster_race_message {
 struct monster_message_history {
 	struct monster *mon;	/* The monster */
 	int message_code;		/* The coded message */
+	int slot;				/* Where it is in mon_hist_hash */
 };
 
 static int size_mon_hist = 0;
@@ -60,6 +69,26 @@ static int size_mon_msg = 0;
 static struct monster_race_message mon_msg[MAX_STORED_MON_MSG];
 static struct monster_message_history mon_message_hist[MAX_STORED_MON_CODES];
 
+/**
+ * Hash tables of one more than the index of each entry in the arrays above,
+ * or 0 for an empty slot, probed linearly
+ */
+static s16b mon_msg_hash[MON_MSG_HASH_SIZE];
+static s16b mon_hist_hash[MON_HIST_HASH_SIZE];
+
+/**
+ * Hash a pointer and two small numbers to a slot in a table of the given
+ * size
+ */
+static int mon_msg_slot(const void *ptr, int a, int b, int size)
+{
+	size_t h = (size_t) ptr;
+
+	h = (h >> 4) ^ ((size_t) a * 131 + (size_t) b);
+	h *= 2654435761U;
+	return (int) ((h >> 8) & (size_t) (size - 1));
+}
+
 /**
  * An array of monster messages in order of monster message type.
  *
@@ -123,10 +152,14 @@ static bool redundant_monster_message(struct monster *mon, int msg_code)
 	assert(msg_code >= 0);
 	assert(msg_code < MON_MSG_MAX);
 
-	for (int i = 0; i < size_mon_hist; i++) {
+	int slot = mon_msg_slot(mon, msg_code, 0, MON_HIST_HASH_SIZE);
+
+	for (; mon_hist_hash[slot]; slot = (slot + 1) % MON_HIST_HASH_SIZE) {
+		struct monster_message_history *hist =
+			&mon_message_hist[mon_hist_hash[slot] - 1];
+
 		/* Check for a matched monster & monster code */
-		if (mon == mon_message_hist[i].mon &&
-				msg_code == mon_message_hist[i].message_code) {
+		if (mon == hist->mon && msg_code == hist->message_code) {
 			return true;
 		}
 	}
@@ -159,9 +192,15 @@ static void store_monster(struct monster *mon, int msg_code)
 {
 	/* Record which monster had this message stored */
 	if (size_mon_hist < MAX_STORED_MON_CODES) {
+		int slot = mon_msg_slot(mon, msg_code, 0, MON_HIST_HASH_SIZE);
+
+		while (mon_hist_hash[slot])
+			slot = (slot + 1) % MON_HIST_HASH_SIZE;
 		mon_message_hist[size_mon_hist].mon = mon;
 		mon_message_hist[size_mon_hist].message_code = msg_code;
+		mon_message_hist[size_mon_hist].slot = slot;
 		size_mon_hist++;
+		mon_hist_hash[slot] = size_mon_hist;
 	}
 }
 
@@ -172,14 +211,16 @@ static void store_monster(struct monster *mon, int msg_code)
  */
 static bool stack_message(struct monster *mon, int msg_code, int flags)
 {
-	int i;
+	int slot = mon_msg_slot(mon->race, msg_code, flags, MON_MSG_HASH_SIZE);
+
+	for (; mon_msg_hash[slot]; slot = (slot + 1) % MON_MSG_HASH_SIZE) {
+		struct monster_race_message *msg = &mon_msg[mon_msg_hash[slot] - 1];
 
-	for (i = 0; i < size_mon_msg; i++) {
 		/* We found the race and the message code */
-		if (mon_msg[i].race == mon->race &&
-					mon_msg[i].flags == flags &&
-					mon_msg[i].msg_code == msg_code) {
-			mon_msg[i].count++;
+		if (msg->race == mon->race &&
+					msg->flags == flags &&
+					msg->msg_code == msg_code) {
+			msg->count++;
 			store_monster(mon, msg_code);
 			return true;
 		}
@@ -214,12 +255,18 @@ bool add_monster_message(struct monster *mon, int msg_code, bool delay)
 	if (!redundant_monster_message(mon, msg_code) &&
 			!stack_message(mon, msg_code, flags) &&
 			size_mon_msg < MAX_STORED_MON_MSG) {
+		int slot = mon_msg_slot(mon->race, msg_code, flags, MON_MSG_HASH_SIZE);
+
+		while (mon_msg_hash[slot])
+			slot = (slot + 1) % MON_MSG_HASH_SIZE;
 		mon_msg[size_mon_msg].race = mon->race;
 		mon_msg[size_mon_msg].flags = flags;
 		mon_msg[size_mon_msg].msg_code = msg_code;
 		mon_msg[size_mon_msg].count = 1;
 		mon_msg[size_mon_msg].delay = what_delay(msg_code, delay);
+		mon_msg[size_mon_msg].slot = slot;
 		size_mon_msg++;
+		mon_msg_hash[slot] = size_mon_msg;
 
 		store_monster(mon, msg_code);
 
@@ -420,5 +467,9 @@ void show_monster_messages(void)
 	}
 
 	/* Delete all the stacked messages and history */
+	for (int i = 0; i < size_mon_msg; i++)
+		mon_msg_hash[mon_msg[i].slot] = 0;
+	for (int i = 0; i < size_mon_hist; i++)
+		mon_hist_hash[mon_message_hist[i].slot] = 0;
 	size_mon_msg = size_mon_hist = 0;
 }
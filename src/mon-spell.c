@@ -312,6 +312,39 @@ bool mon_spell_is_innate(int index)
 	return mon_spell_types[index].type & (RST_INNATE);
 }
 
+/**
+ * The spells of each type, one mask for each RST_ bit, made on first use
+ */
+#define RST_BITS 16
+static bitflag spell_type_masks[RST_BITS][RSF_SIZE];
+static bool spell_type_masks_made = false;
+
+/**
+ * Fill a spell bitflag with all the spells of any of the given types
+ *
+ * \param f is the set of spell flags we're filling
+ * \param types is the spell type(s) we're looking for
+ */
+static void spell_type_mask(bitflag *f, int types)
+{
+	int bit;
+
+	if (!spell_type_masks_made) {
+		const struct mon_spell_info *info;
+
+		for (info = mon_spell_types; info->index < RSF_MAX; info++)
+			for (bit = 0; bit < RST_BITS; bit++)
+				if (info->type & (1 << bit))
+					rsf_on(spell_type_masks[bit], info->index);
+		spell_type_masks_made = true;
+	}
+
+	rsf_wipe(f);
+	for (bit = 0; bit < RST_BITS; bit++)
+		if (types & (1 << bit))
+			rsf_union(f, spell_type_masks[bit]);
+}
+
 /**
  * Test a spell bitflag for a type of spell.
  * Returns true if any desired type is among the flagset
@@ -321,13 +354,10 @@ bool mon_spell_is_innate(int index)
  */
 bool test_spells(bitflag *f, int types)
 {
-	const struct mon_spell_info *info;
-
-	for (info = mon_spell_types; info->index < RSF_MAX; info++)
-		if (rsf_has(f, info->index) && (info->type & types))
-			return true;
+	bitflag mask[RSF_SIZE];
 
-	return false;
+	spell_type_mask(mask, types);
+	return rsf_is_inter(f, mask);
 }
 
 /**
@@ -338,11 +368,10 @@ bool test_spells(bitflag *f, int types)
  */
 void ignore_spells(bitflag *f, int types)
 {
-	const struct mon_spell_info *info;
+	bitflag mask[RSF_SIZE];
 
-	for (info = mon_spell_types; info->index < RSF_MAX; info++)
-		if (rsf_has(f, info->index) && (info->type & types))
-			rsf_off(f, info->index);
+	spell_type_mask(mask, types);
+	rsf_diff(f, mask);
 }
 
 /**
@@ -498,26 +527,19 @@ static int mon_spell_dam(int index, int hp, const struct monster_race *race,
  */
 void create_mon_spell_mask(bitflag *f, ...)
 {
-	const struct mon_spell_info *rs;
-	int i;
+	int i, types = RST_NONE;
 	va_list args;
 
-	rsf_wipe(f);
-
 	va_start(args, f);
 
 	/* Process each type in the va_args */
     for (i = va_arg(args, int); i != RST_NONE; i = va_arg(args, int)) {
-		for (rs = mon_spell_types; rs->index < RSF_MAX; rs++) {
-			if (rs->type & i) {
-				rsf_on(f, rs->index);
-			}
-		}
+		types |= i;
 	}
 
 	va_end(args);
 
-	return;
+	spell_type_mask(f, types);
 }
 
 const char *mon_spell_lore_description(int index,
@@ -18,8 +18,10 @@
 
 #include "angband.h"
 #include "cave.h"
+#include "init.h"
 #include "mon-group.h"
 #include "mon-make.h"
+#include "mon-move.h"
 #include "mon-summon.h"
 #include "mon-util.h"
 
@@ -43,6 +45,17 @@ struct monster_base *kin_base;
  */
 struct summon *summons;
 
+/**
+ * The summon type that uses kin_base
+ */
+static int summon_kin_type = -1;
+
+/**
+ * For each summon type, which races are eligible apart from the kin_base
+ * check; each table is filled in the first time its type is used
+ */
+static bool **summon_races;
+
 
 /**
  * Lookup function to translate names of summons to indices
@@ -119,6 +132,7 @@ void create_summons(struct summon *parsed_summons)
 		char *name = summons[count].fallback_name;
 		summons[count].fallback = summon_name_to_idx(name);
 	}
+	summon_kin_type = summon_name_to_idx("KIN");
 }
 
 /**
@@ -137,25 +151,25 @@ void free_summons(void)
 		string_free(summons[idx].desc);
 		string_free(summons[idx].fallback_name);
 		string_free(summons[idx].name);
+		if (summon_races)
+			mem_free(summon_races[idx]);
 	}
+	mem_free(summon_races);
+	summon_races = NULL;
 	mem_free(summons);
 }
 
 /**
- * Decide if a monster race is "okay" to summon.
- *
- * Compares the given monster to the monster type specified by
- * summon_specific_type. Returns true if the monster is eligible to
- * be summoned, false otherwise.
+ * Decide if a monster race can be summoned by a summon type, leaving aside
+ * the kin base
  */
-static bool summon_specific_okay(struct monster_race *race)
+static bool summon_race_eligible(const struct summon *summon,
+								 const struct monster_race *race)
 {
-	struct summon *summon = &summons[summon_specific_type];
 	struct monster_base_list *bases = summon->bases;
-	bool unique = rf_has(race->flags, RF_UNIQUE);
 
 	/* Forbid uniques? */
-	if (!summon->unique_allowed && unique) {
+	if (!summon->unique_allowed && rf_has(race->flags, RF_UNIQUE)) {
 		return false;
 	}
 
@@ -171,12 +185,41 @@ static bool summon_specific_okay(struct monster_race *race)
 		return false;
 	}
 
+	/* If we made it here, we're fine */
+	return true;
+}
+
+/**
+ * Decide if a monster race is "okay" to summon.
+ *
+ * Compares the given monster to the monster type specified by
+ * summon_specific_type. Returns true if the monster is eligible to
+ * be summoned, false otherwise.
+ */
+static bool summon_specific_okay(struct monster_race *race)
+{
+	bool *eligible;
+
+	/* Work out the eligible races for this type the first time */
+	if (!summon_races)
+		summon_races = mem_zalloc(summon_max * sizeof(*summon_races));
+	eligible = summon_races[summon_specific_type];
+	if (!eligible) {
+		int i;
+
+		eligible = mem_zalloc(z_info->r_max * sizeof(*eligible));
+		for (i = 0; i < z_info->r_max; i++)
+			eligible[i] = summon_race_eligible(&summons[summon_specific_type],
+											   &r_info[i]);
+		summon_races[summon_specific_type] = eligible;
+	}
+	if (!eligible[race->ridx]) return false;
+
 	/* Special case - summon kin */
-	if (summon_specific_type == summon_name_to_idx("KIN")) {
-		return (!unique && race->base == kin_base);
+	if (summon_specific_type == summon_kin_type) {
+		return (!rf_has(race->flags, RF_UNIQUE) && race->base == kin_base);
 	}
 
-	/* If we made it here, we're fine */
 	return true;
 }
 
@@ -250,19 +293,62 @@ static int call_monster(struct loc grid)
 	monster_wake(mon, false, 100);
 
 	/* Set it's energy to 0 */
-	mon->energy = 0;
+	monster_set_energy(cave, mon, 0);
 
 	return (mon->race->level);
 }
 
 
+/**
+ * Find a grid for a summoned monster up to 4 grids from the given location.
+ *
+ * The grid is chosen at random from the usable grids nearest the summoner,
+ * which must be empty floor in line of sight that is not warded or decoyed.
+ */
+static bool summon_location(struct loc grid, struct loc *near)
+{
+	struct loc rings[4][81];
+	int num[4] = { 0, 0, 0, 0 };
+	int d, x, y;
+
+	/* Sort the usable grids by distance */
+	for (y = grid.y - 4; y <= grid.y + 4; y++) {
+		for (x = grid.x - 4; x <= grid.x + 4; x++) {
+			struct loc try = loc(x, y);
+
+			d = MAX(distance(grid, try), 1);
+			if (d > 4) continue;
+			if (!square_in_bounds_fully(cave, try)) continue;
+			if (!los(cave, grid, try)) continue;
+
+			/* Require "empty" floor grid */
+			if (!square_isempty(cave, try)) continue;
+
+			/* No summon on glyphs */
+			if (square_iswarded(cave, try) || square_isdecoyed(cave, try)) {
+				continue;
+			}
+
+			rings[d - 1][num[d - 1]++] = try;
+		}
+	}
+
+	/* Pick from the nearest ring with room */
+	for (d = 0; d < 4; d++) {
+		if (num[d]) {
+			*near = rings[d][randint0(num[d])];
+			return true;
+		}
+	}
+
+	return false;
+}
+
 /**
  * Places a monster (of the specified "type") near the given
  * location.  Return the siummoned monster's level iff a monster was
  * actually summoned.
  *
- * We will attempt to place the monster up to 10 times before giving up.
- *
  * This function takes the "monster level"
  * of the summoning monster as a parameter, and use that, along with
  * the current dungeon level, to help determine the level of the
@@ -279,34 +365,13 @@ static int call_monster(struct loc grid)
  */
 int summon_specific(struct loc grid, int lev, int type, bool delay, bool call)
 {
-	int i;
 	struct loc near;
 	struct monster *mon;
 	struct monster_race *race;
 	struct monster_group_info info = { 0, 0 };
 
 	/* Look for a location, allow up to 4 squares away */
-	for (i = 0; i < 60; ++i) {
-		/* Pick a distance */
-		int d = (i / 15) + 1;
-
-		/* Pick a location */
-		scatter(cave, &near, grid, d, true);
-
-		/* Require "empty" floor grid */
-		if (!square_isempty(cave, near)) continue;
-
-		/* No summon on glyphs */
-		if (square_iswarded(cave, near) || square_isdecoyed(cave, near)) {
-			continue;
-		}
-
-		/* Okay */
-		break;
-	}
-
-	/* Failure */
-	if (i == 60) return (0);
+	if (!summon_location(grid, &near)) return (0);
 
 	/* Save the "summon" type */
 	summon_specific_type = type;
@@ -349,7 +414,7 @@ int summon_specific(struct loc grid, int lev, int type, bool delay, bool call)
 	 * including holding faster monsters for the required number of turns */
 	if (delay) {
 		int turns = (mon->race->speed + 9 - player->state.speed) / 10;
-		mon->energy = 0;
+		monster_set_energy(cave, mon, 0);
 		if (turns) {
 			/* Set timer directly to avoid resistance */
 			mon->m_timed[MON_TMD_HOLD] = turns;
@@ -17,8 +17,10 @@
  */
 
 #include "angband.h"
+#include "game-world.h"
 #include "mon-desc.h"
 #include "mon-lore.h"
+#include "mon-move.h"
 #include "mon-msg.h"
 #include "mon-predicate.h"
 #include "mon-spell.h"
@@ -150,6 +152,11 @@ static bool mon_set_timed(struct monster *mon,
 
 	int m_note = 0;
 	int old_timer = mon->m_timed[effect_type];
+	int old_gain;
+
+	/* Anything affecting a dormant monster brings it back */
+	monster_rejoin(cave, mon);
+	old_gain = monster_turn_energy(mon);
 
 	/* Limit time of effect */
 	if (timer > effect->max_timer) {
@@ -201,6 +208,10 @@ static bool mon_set_timed(struct monster *mon,
 		}
 	}
 
+	/* Speed changes affect when the monster next acts */
+	if (character_dungeon && (monster_turn_energy(mon) != old_gain))
+		monster_speed_changed(cave, mon, old_gain);
+
 	/* Print a message if there is one, if the effect allows for it, and if
 	 * either the monster is visible, or we're trying to ID something */
 	if (m_note &&
@@ -212,6 +223,7 @@ static bool mon_set_timed(struct monster *mon,
 
 	/* Update the visuals, as appropriate. */
 	if (update) {
+		monster_mark_changed(cave, mon);
 		if (player->upkeep->health_who == mon)
 			player->upkeep->redraw |= (PR_HEALTH);
 
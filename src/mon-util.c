@@ -17,6 +17,7 @@
  */
 
 #include "angband.h"
+#include "datafile.h"
 #include "effects.h"
 #include "game-world.h"
 #include "init.h"
@@ -24,6 +25,7 @@
 #include "mon-list.h"
 #include "mon-lore.h"
 #include "mon-make.h"
+#include "mon-move.h"
 #include "mon-msg.h"
 #include "mon-predicate.h"
 #include "mon-spell.h"
@@ -45,6 +47,7 @@
 #include "player-util.h"
 #include "project.h"
 #include "trap.h"
+#include "z-names.h"
 #include "z-set.h"
 
 static const struct monster_flag monster_flag_table[] =
@@ -104,32 +107,65 @@ void create_mon_flag_mask(bitflag *f, ...)
 
 
 /**
- * Returns the monster with the given name. If no monster has the exact name
- * given, returns the first monster with the given name as a (case-insensitive)
- * substring.
+ * Returns the description of a monster race, reading it from its data file
+ * the first time it is asked for.
+ */
+const char *monster_race_text(const struct monster_race *race)
+{
+	if (!race->text && race->text_mark.path)
+		((struct monster_race *)race)->text = parse_file_desc(&race->text_mark);
+	return race->text;
+}
+
+/**
+ * Monster race indices by name, ignoring case, made when the first is
+ * looked for
+ */
+static struct name_table *race_names;
+
+/**
+ * Returns the monster with the given name, ignoring case, or NULL.
  */
 struct monster_race *lookup_monster(const char *name)
 {
 	int i;
-	struct monster_race *closest = NULL;
 
-	/* Look for it */
-	for (i = 0; i < z_info->r_max; i++) {
-		struct monster_race *race = &r_info[i];
-		if (!race->name)
-			continue;
-
-		/* Test for equality */
-		if (my_stricmp(name, race->name) == 0)
-			return race;
-
-		/* Test for close matches */
-		if (!closest && my_stristr(race->name, name))
-			closest = race;
+	if (!race_names) {
+		race_names = name_table_new(z_info->r_max, true);
+		for (i = 0; i < z_info->r_max; i++)
+			if (r_info[i].name)
+				name_table_add(race_names, r_info[i].name, 0, i);
 	}
 
-	/* Return our best match */
-	return closest;
+	i = name_table_find(race_names, name, 0);
+	return i >= 0 ? &r_info[i] : NULL;
+}
+
+/**
+ * Returns the monster with the given name, or if there is none the first
+ * with the given name as a (case-insensitive) substring; for names typed in
+ * by the player.
+ */
+struct monster_race *lookup_closest_monster(const char *name)
+{
+	struct monster_race *race = lookup_monster(name);
+	int i;
+
+	for (i = 0; !race && i < z_info->r_max; i++) {
+		if (r_info[i].name && my_stristr(r_info[i].name, name))
+			race = &r_info[i];
+	}
+
+	return race;
+}
+
+/**
+ * Forget the race names, when r_info is freed
+ */
+void monster_names_free(void)
+{
+	name_table_free(race_names);
+	race_names = NULL;
 }
 
 /**
@@ -455,10 +491,55 @@ void update_monsters(bool full)
 	for (i = 1; i < cave_monster_max(cave); i++) {
 		struct monster *mon = cave_monster(cave, i);
 
+		/* Everyone is up to date after this */
+		mflag_off(mon->mflag, MFLAG_CHANGED);
+
 		/* Update the monster if alive */
 		if (mon->race)
 			update_mon(mon, cave, full);
 	}
+	cave->mon_changed_num = 0;
+}
+
+/**
+ * Note that a monster has done something which may change whether the
+ * player can see it, so that it is updated by the next
+ * update_changed_monsters() rather than by a pass over every monster.
+ *
+ * Anything which changes what the player can see, or where the player is,
+ * still needs PU_MONSTERS or PU_DISTANCE.
+ */
+void monster_mark_changed(struct chunk *c, struct monster *mon)
+{
+	if (c != cave || mflag_has(mon->mflag, MFLAG_CHANGED)) return;
+
+	/* Too many to track, so update everyone */
+	if (c->mon_changed_num >= z_info->level_monster_max) {
+		player->upkeep->update |= PU_MONSTERS;
+		return;
+	}
+
+	mflag_on(mon->mflag, MFLAG_CHANGED);
+	c->mon_changed[c->mon_changed_num++] = mon->midx;
+	player->upkeep->update |= PU_MON_CHANGED;
+}
+
+/**
+ * Updates the monsters marked by monster_mark_changed() via update_mon().
+ */
+void update_changed_monsters(void)
+{
+	while (cave->mon_changed_num) {
+		int midx = cave->mon_changed[--cave->mon_changed_num];
+		struct monster *mon = cave_monster(cave, midx);
+
+		/* Skip monsters which have died or moved index since being marked */
+		if (!mflag_has(mon->mflag, MFLAG_CHANGED)) continue;
+		mflag_off(mon->mflag, MFLAG_CHANGED);
+
+		if (mon->race)
+			update_mon(mon, cave, false);
+	}
 }
 
 
@@ -525,8 +606,8 @@ void monster_swap(struct loc grid1, struct loc grid2)
 	struct loc pgrid = player->grid;
 
 	/* Monsters */
-	m1 = cave->squares[grid1.y][grid1.x].mon;
-	m2 = cave->squares[grid2.y][grid2.x].mon;
+	m1 = square(cave, grid1).mon;
+	m2 = square(cave, grid2).mon;
 
 	/* Update grids */
 	square_set_mon(cave, grid1, m2);
@@ -537,6 +618,7 @@ void monster_swap(struct loc grid1, struct loc grid2)
 		/* Monster */
 		mon = cave_monster(cave, m1);
 		mon->grid = grid2;
+		monster_rejoin(cave, mon);
 
 		/* Update monster */
 		update_mon(mon, cave, true);
@@ -567,6 +649,7 @@ void monster_swap(struct loc grid1, struct loc grid2)
 		/* Monster */
 		mon = cave_monster(cave, m2);
 		mon->grid = grid1;
+		monster_rejoin(cave, mon);
 
 		/* Update monster */
 		update_mon(mon, cave, true);
@@ -603,6 +686,7 @@ void monster_swap(struct loc grid1, struct loc grid2)
 void monster_wake(struct monster *mon, bool notify, int aware_chance)
 {
 	int flag = notify ? MON_TMD_FLG_NOTIFY : MON_TMD_FLG_NOMESSAGE;
+	monster_rejoin(cave, mon);
 	mon_clear_timed(mon, MON_TMD_SLEEP, flag);
 	if (randint0(100) < aware_chance) {
 		mflag_on(mon->mflag, MFLAG_AWARE);
@@ -614,6 +698,8 @@ void monster_wake(struct monster *mon, bool notify, int aware_chance)
  */
 bool monster_can_see(struct chunk *c, struct monster *mon, struct loc grid)
 {
+	if (loc_eq(grid, player->grid))
+		return los_to_player(c, mon->grid);
 	return los(c, mon->grid, grid);
 }
 
@@ -771,14 +857,15 @@ static struct monster *get_injured_kin(struct chunk *c,
  */
 bool find_any_nearby_injured_kin(struct chunk *c, const struct monster *mon)
 {
-	struct loc grid;
-	for (grid.y = mon->grid.y - MAX_KIN_RADIUS;
-		 grid.y <= mon->grid.y + MAX_KIN_RADIUS; grid.y++) {
-		for (grid.x = mon->grid.x - MAX_KIN_RADIUS;
-			 grid.x <= mon->grid.x + MAX_KIN_RADIUS; grid.x++) {
-			if (get_injured_kin(c, mon, grid) != NULL) {
-				return true;
-			}
+	struct loc tl = loc(mon->grid.x - MAX_KIN_RADIUS,
+						mon->grid.y - MAX_KIN_RADIUS);
+	struct loc br = loc(mon->grid.x + MAX_KIN_RADIUS,
+						mon->grid.y + MAX_KIN_RADIUS);
+	struct loc grid = loc(tl.x - 1, tl.y);
+
+	while (cave_next_monster_grid(c, tl, br, &grid)) {
+		if (get_injured_kin(c, mon, grid) != NULL) {
+			return true;
 		}
 	}
 
@@ -795,16 +882,16 @@ struct monster *choose_nearby_injured_kin(struct chunk *c,
 										  const struct monster *mon)
 {
 	struct set *set = set_new();
-	struct loc grid;
-
-	for (grid.y = mon->grid.y - MAX_KIN_RADIUS;
-		 grid.y <= mon->grid.y + MAX_KIN_RADIUS; grid.y++) {
-		for (grid.x = mon->grid.x - MAX_KIN_RADIUS;
-			 grid.x <= mon->grid.x + MAX_KIN_RADIUS; grid.x++) {
-			struct monster *kin = get_injured_kin(c, mon, grid);
-			if (kin != NULL) {
-				set_add(set, kin);
-			}
+	struct loc tl = loc(mon->grid.x - MAX_KIN_RADIUS,
+						mon->grid.y - MAX_KIN_RADIUS);
+	struct loc br = loc(mon->grid.x + MAX_KIN_RADIUS,
+						mon->grid.y + MAX_KIN_RADIUS);
+	struct loc grid = loc(tl.x - 1, tl.y);
+
+	while (cave_next_monster_grid(c, tl, br, &grid)) {
+		struct monster *kin = get_injured_kin(c, mon, grid);
+		if (kin != NULL) {
+			set_add(set, kin);
 		}
 	}
 
@@ -1514,8 +1601,10 @@ bool monster_change_shape(struct monster *mon)
 
 	/* Set the race */
 	if (race) {
+		cave_monster_hearing_remove(cave, mon);
 		mon->original_race = mon->race;
 		mon->race = race;
+		cave_monster_hearing_add(cave, mon);
 		mon->mspeed += mon->race->speed - mon->original_race->speed;
 	}
 
@@ -1545,8 +1634,10 @@ bool monster_revert_shape(struct monster *mon)
 			square_light_spot(cave, mon->grid);
 		}
 		mon->mspeed += mon->original_race->speed - mon->race->speed;
+		cave_monster_hearing_remove(cave, mon);
 		mon->race = mon->original_race;
 		mon->original_race = NULL;
+		cave_monster_hearing_add(cave, mon);
 
 		/* Emergency teleport if needed */
 		if (!monster_passes_walls(mon) && square_iswall(cave, mon->grid)) {
@@ -24,11 +24,16 @@
 
 const char *describe_race_flag(int flag);
 void create_mon_flag_mask(bitflag *f, ...);
+const char *monster_race_text(const struct monster_race *race);
 struct monster_race *lookup_monster(const char *name);
+struct monster_race *lookup_closest_monster(const char *name);
+void monster_names_free(void);
 struct monster_base *lookup_monster_base(const char *name);
 bool match_monster_bases(const struct monster_base *base, ...);
 void update_mon(struct monster *mon, struct chunk *c, bool full);
 void update_monsters(bool full);
+void monster_mark_changed(struct chunk *c, struct monster *mon);
+void update_changed_monsters(void);
 bool monster_carry(struct chunk *c, struct monster *mon, struct object *obj);
 void monster_swap(struct loc grid1, struct loc grid2);
 void monster_wake(struct monster *mon, bool notify, int aware_chance);
@@ -22,6 +22,7 @@
 #include "h-basic.h"
 #include "z-bitflag.h"
 #include "z-rand.h"
+#include "z-file.h"
 #include "cave.h"
 #include "target.h"
 #include "mon-timed.h"
@@ -311,6 +312,7 @@ struct monster_race {
 
 	char *name;
 	char *text;
+	struct file_mark text_mark;	/* Where text is read from when needed */
 	char *plural;			/* Optional pluralized name */
 
 	struct monster_base *base;
@@ -367,8 +369,9 @@ struct monster_race {
  * of objects (if any) being carried by the monster (see above).
  */
 struct monster {
+	/* The fields the monster passes read every game turn come first, so
+	 * those passes touch as little of each record as possible */
 	struct monster_race *race;			/* Monster's (current) race */
-	struct monster_race *original_race;	/* Changed monster's original race */
 	int midx;
 
 	struct loc grid;					/* Location on map */
@@ -379,7 +382,9 @@ struct monster {
 	s16b m_timed[MON_TMD_MAX];			/* Timed monster status effects */
 
 	byte mspeed;						/* Monster "speed" */
-	byte energy;						/* Monster "energy" */
+	byte energy;						/* Monster "energy" at energy_turn */
+	s32b energy_turn;					/* Game turn energy is counted to */
+	s32b sched_turn;					/* Game turn next due, or travel to wake */
 
 	byte cdis;							/* Current dis from player */
 
@@ -388,6 +393,8 @@ struct monster {
 	struct object *mimicked_obj;		/* Object this monster is mimicking */
 	struct object *held_obj;			/* Object being held (if any) */
 
+	struct monster_race *original_race;	/* Changed monster's original race */
+
 	byte attr;  						/* attr last used for drawing monster */
 
 	struct player_state known_pstate;	/* Known player state */
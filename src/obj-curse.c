@@ -42,6 +42,93 @@ int lookup_curse(const char *name)
 	return 0;
 }
 
+/**
+ * Find an object's data for one curse
+ *
+ * \param obj the object
+ * \param index the index of the curse
+ * \return the curse data, or NULL if the object doesn't have that curse
+ */
+struct curse_data *object_curse(const struct object *obj, int index)
+{
+	int i;
+
+	for (i = 0; i < obj->num_curses; i++) {
+		if (obj->curses[i].index == index) return &obj->curses[i];
+		if (obj->curses[i].index > index) break;
+	}
+	return NULL;
+}
+
+/**
+ * The power of one of an object's curses, or 0 if it doesn't have it
+ */
+int object_curse_power(const struct object *obj, int index)
+{
+	struct curse_data *c = object_curse(obj, index);
+	return c ? c->power : 0;
+}
+
+/**
+ * Find an object's data for one curse, giving the object the curse (with
+ * no power yet) if it doesn't have it
+ *
+ * \param obj the object
+ * \param index the index of the curse
+ */
+struct curse_data *object_curse_add(struct object *obj, int index)
+{
+	struct curse_data *c = object_curse(obj, index);
+	int i;
+
+	if (c) return c;
+
+	/* Keep the list in order of curse index */
+	obj->curses = mem_realloc(obj->curses,
+							  (obj->num_curses + 1) * sizeof(*obj->curses));
+	for (i = obj->num_curses; i > 0 && obj->curses[i - 1].index > index; i--)
+		obj->curses[i] = obj->curses[i - 1];
+	obj->num_curses++;
+	c = &obj->curses[i];
+	c->index = index;
+	c->power = 0;
+	c->timeout = 0;
+	return c;
+}
+
+/**
+ * Take a curse off an object, freeing the curse list if it was the last
+ *
+ * \param obj the object
+ * \param index the index of the curse
+ */
+void object_curse_remove(struct object *obj, int index)
+{
+	struct curse_data *c = object_curse(obj, index);
+
+	if (!c) return;
+	obj->num_curses--;
+	memmove(c, c + 1, (obj->curses + obj->num_curses - c) * sizeof(*c));
+	if (!obj->num_curses) {
+		mem_free(obj->curses);
+		obj->curses = NULL;
+	}
+}
+
+/**
+ * Copy the curses of one object to another which has none
+ */
+void object_curses_copy(struct object *dest, const struct object *src)
+{
+	size_t size = src->num_curses * sizeof(*src->curses);
+
+	assert(!dest->curses);
+	dest->num_curses = src->num_curses;
+	if (!size) return;
+	dest->curses = mem_alloc(size);
+	memcpy(dest->curses, src->curses, size);
+}
+
 /**
  * Copy all the curses from a template to an actual object.
  *
@@ -54,16 +141,15 @@ void copy_curses(struct object *obj, int *source)
 
 	if (!source) return;
 
-	if (!obj->curses) {
-		obj->curses = mem_zalloc(z_info->curse_max * sizeof(struct curse_data));
-	}
-
 	for (i = 0; i < z_info->curse_max; i++) {
+		struct curse_data *c;
+
 		if (!source[i]) continue;
-		obj->curses[i].power = source[i];
+		c = object_curse_add(obj, i);
+		c->power = source[i];
 
 		/* Timeouts need to be set for new objects */
-		obj->curses[i].timeout = randcalc(curses[i].obj->time, 0, RANDOMISE);
+		c->timeout = randcalc(curses[i].obj->time, 0, RANDOMISE);
 	}
 }
 
@@ -77,11 +163,10 @@ bool curses_are_equal(const struct object *obj1, const struct object *obj2)
 {
 	int i;
 
-	if (!obj1->curses && !obj2->curses) return true;
-	if (obj1->curses && !obj2->curses) return false;
-	if (!obj1->curses && obj2->curses) return false;
+	if (obj1->num_curses != obj2->num_curses) return false;
 
-	for (i = 0; i < z_info->curse_max; i++) {
+	for (i = 0; i < obj1->num_curses; i++) {
+		if (obj1->curses[i].index != obj2->curses[i].index) return false;
 		if (obj1->curses[i].power != obj2->curses[i].power) return false;
 	}
 
@@ -111,27 +196,6 @@ static bool curses_conflict(int first, int second)
 	return false;
 }
 
-/**
- * Check an object for active curses, and remove the "curses" field if
- * none is found
- */
-static void check_object_curses(struct object *obj)
-{
-	int i;
-
-	/* Look for a valid curse, return if one found */
-	for (i = 0; i < z_info->curse_max; i++) {
-		if (obj->curses[i].power) {
-			return;
-		}
-	}
-
-	/* Free the curse structure */
-	mem_free(obj->curses);
-	obj->curses = NULL;
-}
-
-
 /**
  * Append a given curse with a given power to an object
  *
@@ -142,15 +206,12 @@ static void check_object_curses(struct object *obj)
 bool append_object_curse(struct object *obj, int pick, int power)
 {
 	struct curse *c = &curses[pick];
+	struct curse_data *existing;
 	int i;
 
-	if (!obj->curses)
-		obj->curses = mem_zalloc(z_info->curse_max * sizeof(struct curse_data));
-
 	/* Reject conflicting curses */
-	for (i = 0; i < z_info->curse_max; i++) {
-		if (obj->curses[i].power && curses_conflict(i, pick)) {
-			check_object_curses(obj);
+	for (i = 0; i < obj->num_curses; i++) {
+		if (curses_conflict(obj->curses[i].index, pick)) {
 			return false;
 		}
 	}
@@ -163,17 +224,14 @@ bool append_object_curse(struct object *obj, int pick, int power)
 		status = &timed_effects[idx];
 		if (status->fail_code == TMD_FAIL_FLAG_OBJECT) {
 			if (of_has(obj->flags, status->fail)) {
-				check_object_curses(obj);
 				return false;
 			}
 		} else if (status->fail_code == TMD_FAIL_FLAG_RESIST) {
 			if (obj->el_info[status->fail].res_level > 0) {
-				check_object_curses(obj);
 				return false;
 			}
 		} else if (status->fail_code == TMD_FAIL_FLAG_VULN) {
 			if (obj->el_info[status->fail].res_level < 0) {
-				check_object_curses(obj);
 				return false;
 			}
 		}
@@ -183,19 +241,18 @@ bool append_object_curse(struct object *obj, int pick, int power)
 	for (i = of_next(c->conflict_flags, FLAG_START); i != FLAG_END;
 		 i = of_next(c->conflict_flags, i + 1)) {
 		if (of_has(obj->flags, i)) {
-			check_object_curses(obj);
 			return false;
 		}
 	}
 
 	/* Adjust power if our pick is a duplicate */
-	if (power > obj->curses[pick].power) {
-		obj->curses[pick].power = power;
-		obj->curses[pick].timeout = randcalc(c->obj->time, 0, RANDOMISE);
+	if (power > object_curse_power(obj, pick)) {
+		existing = object_curse_add(obj, pick);
+		existing->power = power;
+		existing->timeout = randcalc(c->obj->time, 0, RANDOMISE);
 		return true;
 	}
 
-	check_object_curses(obj);
 	return false;
 }
 
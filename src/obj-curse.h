@@ -24,6 +24,11 @@ extern struct curse *curses;
 
 void init_curse_knowledge(void);
 int lookup_curse(const char *name);
+struct curse_data *object_curse(const struct object *obj, int index);
+int object_curse_power(const struct object *obj, int index);
+struct curse_data *object_curse_add(struct object *obj, int index);
+void object_curse_remove(struct object *obj, int index);
+void object_curses_copy(struct object *dest, const struct object *src);
 void copy_curses(struct object *obj, int *source);
 bool curses_are_equal(const struct object *obj1, const struct object *obj2);
 bool append_object_curse(struct object *obj, int pick, int power);
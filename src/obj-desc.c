@@ -605,6 +605,40 @@ static size_t obj_desc_aware(const struct object *obj, char *buf, size_t max,
 }
 
 
+/**
+ * Descriptions remembered during a knowledge cache pass, when nothing changes
+ * objects, so that an object shown in several places is only described once
+ */
+#define DESC_CACHE_SIZE	64
+#define DESC_CACHE_TEXT	128
+
+struct desc_cache_entry {
+	u32b stamp;
+	const struct object *obj;
+	int mode;
+	int number;
+	size_t max;
+	size_t len;
+	char text[DESC_CACHE_TEXT];
+};
+
+static struct desc_cache_entry desc_cache[DESC_CACHE_SIZE];
+
+/**
+ * Find where a description would be remembered, or NULL if it can't be
+ */
+static struct desc_cache_entry *desc_cache_slot(const struct object *obj,
+												int mode, size_t max)
+{
+	unsigned long hash = (unsigned long) obj / sizeof(*obj);
+
+	if (!object_knowledge_cache_stamp() || max > DESC_CACHE_TEXT) return NULL;
+	return &desc_cache[(hash * 31 + mode) % DESC_CACHE_SIZE];
+}
+
+static size_t object_desc_aux(char *buf, size_t max, const struct object *obj,
+							  int mode);
+
 /**
  * Describes item `obj` into buffer `buf` of size `max`.
  *
@@ -622,6 +656,43 @@ static size_t obj_desc_aware(const struct object *obj, char *buf, size_t max,
  * \returns The number of bytes used of the buffer.
  */
 size_t object_desc(char *buf, size_t max, const struct object *obj, int mode)
+{
+	struct desc_cache_entry *slot;
+
+	if (!obj || !obj->known || !max)
+		return object_desc_aux(buf, max, obj, mode);
+
+	/* Use the description from earlier in this pass if there is one */
+	slot = desc_cache_slot(obj, mode, max);
+	if (slot && slot->stamp == object_knowledge_cache_stamp() &&
+		slot->obj == obj && slot->mode == mode && slot->max == max &&
+		slot->number == obj->number) {
+		memcpy(buf, slot->text, slot->len + 1);
+		return slot->len;
+	}
+
+	if (!slot)
+		return object_desc_aux(buf, max, obj, mode);
+
+	slot->len = object_desc_aux(buf, max, obj, mode);
+	if (slot->len >= sizeof(slot->text)) {
+		slot->stamp = 0;
+		return slot->len;
+	}
+	slot->stamp = object_knowledge_cache_stamp();
+	slot->obj = obj;
+	slot->mode = mode;
+	slot->number = obj->number;
+	slot->max = max;
+	my_strcpy(slot->text, buf, sizeof(slot->text));
+	return slot->len;
+}
+
+/**
+ * Build the description for object_desc()
+ */
+static size_t object_desc_aux(char *buf, size_t max, const struct object *obj,
+							  int mode)
 {
 	bool prefix = mode & ODESC_PREFIX ? true : false;
 	bool spoil = mode & ODESC_SPOIL ? true : false;
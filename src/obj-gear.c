@@ -528,8 +528,8 @@ int inven_carry_num(const struct object *obj, bool stack)
 		struct object *gear_obj;
 
 		for (gear_obj = player->gear; gear_obj; gear_obj = gear_obj->next) {
-			if (!object_is_equipped(player->body, gear_obj) &&
-					object_stackable(gear_obj, obj, OSTACK_PACK)) {
+			if (object_stackable(gear_obj, obj, OSTACK_PACK) &&
+					!object_is_equipped(player->body, gear_obj)) {
 				break;
 			}
 		}
@@ -613,8 +613,8 @@ void inven_carry(struct player *p, struct object *obj, bool absorb,
 
 		struct object *gear_obj = p->gear;
 		while ((combine_item == NULL) && (gear_obj != NULL)) {
-			if (!object_is_equipped(p->body, gear_obj) &&
-					object_similar(gear_obj, obj, OSTACK_PACK)) {
+			if (object_similar(gear_obj, obj, OSTACK_PACK) &&
+					!object_is_equipped(p->body, gear_obj)) {
 				combine_item = gear_obj;
 			}
 
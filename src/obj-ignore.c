@@ -110,6 +110,52 @@ bool **ego_ignore_types;
 /* Hackish - ego_ignore_types should be initialised with arrays */
 static int num_ego_types;
 
+/* Ignore type of each object kind, worked out once at startup */
+static byte *kind_ignore_types;
+
+/* Changes whenever any ignore setting does */
+static u32b ignore_generation = 1;
+
+/**
+ * Note that ignore settings have changed, so remembered ignore decisions
+ * are out of date
+ */
+void ignore_settings_changed(void)
+{
+	if (!++ignore_generation) ignore_generation++;
+}
+
+/**
+ * Get the ignore settings generation; it is never 0
+ */
+u32b ignore_settings_generation(void)
+{
+	return ignore_generation;
+}
+
+/**
+ * Find the ignore type of an object kind, or ITYPE_MAX if none
+ */
+static ignore_type_t ignore_type_of_kind(const struct object_kind *kind)
+{
+	size_t i;
+
+	/* Find the appropriate ignore group */
+	for (i = 0; i < N_ELEMENTS(quality_mapping); i++) {
+		if (quality_mapping[i].tval == kind->tval) {
+			/* If there's an identifier, it must match */
+			if (quality_mapping[i].identifier[0]) {
+				if (!strstr(kind->name, quality_mapping[i].identifier))
+					continue;
+			}
+			/* Otherwise we're fine */
+			return quality_mapping[i].ignore_type;
+		}
+	}
+
+	return ITYPE_MAX;
+}
+
 
 /**
  * Initialise the ignore package 
@@ -122,6 +168,11 @@ void init_ignore(void)
 	ego_ignore_types = mem_zalloc(z_info->e_max * sizeof(bool*));
 	for (i = 0; i < z_info->e_max; i++)
 		ego_ignore_types[i] = mem_zalloc(ITYPE_MAX * sizeof(bool));
+
+	kind_ignore_types = mem_zalloc(z_info->k_max * sizeof(byte));
+	for (i = 0; i < z_info->k_max; i++)
+		kind_ignore_types[i] = k_info[i].name ?
+			ignore_type_of_kind(&k_info[i]) : ITYPE_MAX;
 }
 
 
@@ -134,6 +185,7 @@ void cleanup_ignore(void)
 	for (i = 0; i < num_ego_types; i++)
 		mem_free(ego_ignore_types[i]);
 	mem_free(ego_ignore_types);
+	mem_free(kind_ignore_types);
 }
 
 
@@ -156,6 +208,8 @@ void ignore_birth_init(void)
 	for (i = 0; i < z_info->e_max; i++)
 		for (j = ITYPE_NONE; j < ITYPE_MAX; j++)
 			ego_ignore_types[i][j] = 0;
+
+	ignore_settings_changed();
 }
 
 
@@ -368,6 +422,7 @@ void object_ignore_flavor_of(const struct object *obj)
 		obj->kind->ignore |= IGNORE_IF_AWARE;
 	else
 		obj->kind->ignore |= IGNORE_IF_UNAWARE;
+	ignore_settings_changed();
 }
 
 
@@ -376,22 +431,7 @@ void object_ignore_flavor_of(const struct object *obj)
  */
 ignore_type_t ignore_type_of(const struct object *obj)
 {
-	size_t i;
-
-	/* Find the appropriate ignore group */
-	for (i = 0; i < N_ELEMENTS(quality_mapping); i++) {
-		if (quality_mapping[i].tval == obj->tval) {
-			/* If there's an identifier, it must match */
-			if (quality_mapping[i].identifier[0]) {
-				if (!strstr(obj->kind->name, quality_mapping[i].identifier))
-					continue;
-			}
-			/* Otherwise we're fine */
-			return quality_mapping[i].ignore_type;
-		}
-	}
-
-	return ITYPE_MAX;
+	return kind_ignore_types[obj->kind->kidx];
 }
 
 /**
@@ -514,6 +554,7 @@ byte ignore_level_of(const struct object *obj)
 void kind_ignore_clear(struct object_kind *kind)
 {
 	kind->ignore = 0;
+	ignore_settings_changed();
 	player->upkeep->notice |= PN_IGNORE;
 }
 
@@ -521,6 +562,7 @@ void ego_ignore(struct object *obj)
 {
 	assert(obj->ego);
 	ego_ignore_types[obj->ego->eidx][ignore_type_of(obj)] = true;
+	ignore_settings_changed();
 	player->upkeep->notice |= PN_IGNORE;
 }
 
@@ -528,12 +570,14 @@ void ego_ignore_clear(struct object *obj)
 {
 	assert(obj->ego);
 	ego_ignore_types[obj->ego->eidx][ignore_type_of(obj)] = false;
+	ignore_settings_changed();
 	player->upkeep->notice |= PN_IGNORE;
 }
 
 void ego_ignore_toggle(int e_idx, int itype)
 {
 	ego_ignore_types[e_idx][itype] = !ego_ignore_types[e_idx][itype];
+	ignore_settings_changed();
 	player->upkeep->notice |= PN_IGNORE;
 }
 
@@ -555,20 +599,22 @@ bool kind_is_ignored_unaware(const struct object_kind *kind)
 void kind_ignore_when_aware(struct object_kind *kind)
 {
 	kind->ignore |= IGNORE_IF_AWARE;
+	ignore_settings_changed();
 	player->upkeep->notice |= PN_IGNORE;
 }
 
 void kind_ignore_when_unaware(struct object_kind *kind)
 {
 	kind->ignore |= IGNORE_IF_UNAWARE;
+	ignore_settings_changed();
 	player->upkeep->notice |= PN_IGNORE;
 }
 
 
 /**
- * Determines if an object is already ignored.
+ * Work out whether an object is ignored
  */
-bool object_is_ignored(const struct object *obj)
+static bool object_is_ignored_aux(const struct object *obj)
 {
 	byte type;
 
@@ -611,6 +657,28 @@ bool object_is_ignored(const struct object *obj)
 		return false;
 }
 
+/**
+ * Determines if an object is already ignored.
+ *
+ * The answer is remembered for the rest of a knowledge cache pass, as long
+ * as the ignore settings stay the same.
+ */
+bool object_is_ignored(const struct object *obj)
+{
+	struct object_knowledge_cache *cache = object_knowledge_cache(obj);
+
+	if (cache && (cache->have & KNOWN_CACHE_IGNORED) &&
+		cache->ignore_generation == ignore_generation)
+		return cache->ignored;
+
+	if (!cache) return object_is_ignored_aux(obj);
+
+	cache->ignored = object_is_ignored_aux(obj);
+	cache->ignore_generation = ignore_generation;
+	cache->have |= KNOWN_CACHE_IGNORED;
+	return cache->ignored;
+}
+
 /**
  * Determines if an object is eligible for ignoring.
  */
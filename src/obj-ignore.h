@@ -86,6 +86,8 @@ extern bool **ego_ignore_types;
 
 /* obj-ignore.c */
 void ignore_birth_init(void);
+void ignore_settings_changed(void);
+u32b ignore_settings_generation(void);
 void rune_autoinscribe(int i);
 const char *get_autoinscription(struct object_kind *kind, bool aware);
 int apply_autoinscription(struct object *obj);
@@ -134,10 +134,10 @@ static bool describe_curses(textblock *tb, const struct object *obj,
 
 	if (!c)
 		return false;
-	for (i = 1; i < z_info->curse_max; i++) {
+	for (i = 0; i < obj->known->num_curses; i++) {
 		if (c[i].power) {
 			textblock_append(tb, "It ");
-			textblock_append_c(tb, COLOUR_L_RED, curses[i].desc);
+			textblock_append_c(tb, COLOUR_L_RED, curses[c[i].index].desc);
 			if (c[i].power == 100) {
 				textblock_append(tb, "; this curse cannot be removed");
 			}
@@ -624,6 +624,8 @@ static int obj_known_blows(const struct object *obj, int max_num,
 	int str_faster = -1, str_done = -1;
 	int dex_plus_bound;
 	int str_plus_bound;
+	int str_ind, dex_ind;
+	bool quick;
 
 	struct player_state state;
 
@@ -651,8 +653,15 @@ static int obj_known_blows(const struct object *obj, int max_num,
 
 	/* Check to see if extra STR or DEX would yield extra blows */
 	old_blows = state.num_blows;
-	dex_plus_bound = STAT_RANGE - state.stat_ind[STAT_DEX];
-	str_plus_bound = STAT_RANGE - state.stat_ind[STAT_STR];
+	str_ind = state.stat_ind[STAT_STR];
+	dex_ind = state.stat_ind[STAT_DEX];
+	dex_plus_bound = STAT_RANGE - dex_ind;
+	str_plus_bound = STAT_RANGE - str_ind;
+
+	/* Only blows change with STR and DEX, so they can be worked out from this
+	 * state; calc_bonuses() lifts very low indexes to 3, though, so then the
+	 * starting index isn't known and the whole state has to be redone */
+	quick = (str_ind > 3) && (dex_ind > 3);
 
 	/* Re-calculate with increased stats */
 	for (dex_plus = 0; dex_plus < dex_plus_bound; dex_plus++) {
@@ -665,10 +674,16 @@ static int obj_known_blows(const struct object *obj, int max_num,
 				return num;
 			}
 
-			state.stat_ind[STAT_STR] = str_plus; //Hack - NRM
-			state.stat_ind[STAT_DEX] = dex_plus; //Hack - NRM
-			calc_bonuses(player, &state, true, false);
-			new_blows = state.num_blows;
+			if (quick) {
+				new_blows = calc_blows_at(player, obj, &state,
+										  str_ind + str_plus,
+										  dex_ind + dex_plus);
+			} else {
+				state.stat_ind[STAT_STR] = str_plus; //Hack - NRM
+				state.stat_ind[STAT_DEX] = dex_plus; //Hack - NRM
+				calc_bonuses(player, &state, true, false);
+				new_blows = state.num_blows;
+			}
 
 			/* Test to make sure that this extra blow is a
 			 * new str/dex combination, not a repeat */
@@ -1209,6 +1224,79 @@ static bool describe_damage(textblock *tb, const struct object *obj, bool throw)
 	return true;
 }
 
+/**
+ * Gets the average damage/turn (x10) each of `num` objects would do to every
+ * monster race, as object_info() would state it, into `damage`, which must
+ * hold `num` rows of z_info->r_max entries; objects whose dice aren't known
+ * and races with no name get 0.
+ *
+ * Which brands and slays hurt each race is found once for all the objects,
+ * and the player's state, blows and criticals once for each object, so a
+ * whole table costs little more than describing each object once.
+ */
+void obj_known_damage_races(const struct object **objs, int num, bool throw,
+							int *damage)
+{
+	int i, r, j;
+	bool *hurt_brand = mem_zalloc(z_info->r_max * z_info->brand_max *
+								  sizeof(bool));
+	bool *hurt_slay = mem_zalloc(z_info->r_max * z_info->slay_max *
+								 sizeof(bool));
+	int *brand_damage = mem_alloc(z_info->brand_max * sizeof(int));
+	int *slay_damage = mem_alloc(z_info->slay_max * sizeof(int));
+
+	/* What hurts each race doesn't depend on the object */
+	for (r = 0; r < z_info->r_max; r++) {
+		struct monster_race *race = &r_info[r];
+		if (!race->name) continue;
+
+		for (j = 1; j < z_info->brand_max; j++)
+			hurt_brand[r * z_info->brand_max + j] =
+				!rf_has(race->flags, brands[j].resist_flag);
+		for (j = 1; j < z_info->slay_max; j++)
+			hurt_slay[r * z_info->slay_max + j] =
+				react_to_slay_race(&slays[j], race);
+	}
+
+	for (i = 0; i < num; i++) {
+		int *row = damage + i * z_info->r_max;
+		int normal_damage = 0;
+		bool nonweap_slay = false;
+
+		memset(row, 0, z_info->r_max * sizeof(int));
+		memset(brand_damage, 0, z_info->brand_max * sizeof(int));
+		memset(slay_damage, 0, z_info->slay_max * sizeof(int));
+		if (OPT(player, birth_percent_damage)) {
+			o_obj_known_damage(objs[i], &normal_damage, brand_damage,
+							   slay_damage, &nonweap_slay, throw);
+		} else {
+			obj_known_damage(objs[i], &normal_damage, brand_damage,
+							 slay_damage, &nonweap_slay, throw);
+		}
+
+		/* The best brand or slay that works, as in an attack */
+		for (r = 0; r < z_info->r_max; r++) {
+			int best = normal_damage;
+			if (!r_info[r].name) continue;
+
+			for (j = 1; j < z_info->brand_max; j++) {
+				if (hurt_brand[r * z_info->brand_max + j])
+					best = MAX(best, brand_damage[j]);
+			}
+			for (j = 1; j < z_info->slay_max; j++) {
+				if (hurt_slay[r * z_info->slay_max + j])
+					best = MAX(best, slay_damage[j]);
+			}
+			row[r] = best;
+		}
+	}
+
+	mem_free(hurt_brand);
+	mem_free(hurt_slay);
+	mem_free(brand_damage);
+	mem_free(slay_damage);
+}
+
 /**
  * Gets miscellaneous combat information about the given object.
  *
@@ -1966,14 +2054,14 @@ static void describe_flavor_text(textblock *tb, const struct object *obj,
 {
 	/* Display the known artifact or object description */
 	if (!OPT(player, birth_randarts) && obj->artifact &&
-		obj->known->artifact && obj->artifact->text) {
-		textblock_append(tb, "%s\n\n", obj->artifact->text);
+		obj->known->artifact && artifact_text(obj->artifact)) {
+		textblock_append(tb, "%s\n\n", artifact_text(obj->artifact));
 
 	} else if (object_flavor_is_aware(obj) || ego) {
 		bool did_desc = false;
 
-		if (!ego && obj->kind->text) {
-			textblock_append(tb, "%s", obj->kind->text);
+		if (!ego && object_kind_text(obj->kind)) {
+			textblock_append(tb, "%s", object_kind_text(obj->kind));
 			did_desc = true;
 		}
 
@@ -64,5 +64,7 @@ textblock *object_info(const struct object *obj, oinfo_detail_t mode);
 textblock *object_info_ego(struct ego_item *ego);
 void object_info_spoil(ang_file *f, const struct object *obj, int wrap);
 void object_info_chardump(ang_file *f, const struct object *obj, int indent, int wrap);
+void obj_known_damage_races(const struct object **objs, int num, bool throw,
+							int *damage);
 
 #endif /* OBJECT_INFO_H */
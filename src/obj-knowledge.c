@@ -294,7 +294,7 @@ bool player_knows_rune(struct player *p, size_t i)
 		/* Curse runes */
 		case RUNE_VAR_CURSE: {
 			assert(r->index < z_info->curse_max);
-			if (p->obj_k->curses[r->index].power) {
+			if (object_curse_power(p->obj_k, r->index)) {
 				return true;
 			}
 			break;
@@ -451,7 +451,7 @@ bool player_knows_slay(struct player *p, int i)
  */
 bool player_knows_curse(struct player *p, int index)
 {
-	return p->obj_k->curses[index].power == 1;
+	return object_curse_power(p->obj_k, index) == 1;
 }
 
 /**
@@ -626,7 +626,7 @@ bool object_has_rune(const struct object *obj, int rune_no)
 		}
 		/* Curse runes */
 		case RUNE_VAR_CURSE: {
-			if (obj->curses && obj->curses[r->index].power)
+			if (object_curse_power(obj, r->index))
 				return true;
 			break;
 		}
@@ -642,6 +642,83 @@ bool object_has_rune(const struct object *obj, int rune_no)
 	return false;
 }
 
+/**
+ * ------------------------------------------------------------------------
+ * Knowledge cache
+ *
+ * Object properties are changed directly in too many places to keep cached
+ * knowledge up to date in general, so answers are only remembered during a
+ * cache pass, such as a redraw, when objects are not being changed.  A pass
+ * gets a new stamp, as does any change in player or object knowledge.
+ * ------------------------------------------------------------------------ */
+static u32b knowledge_stamp = 1;
+static u32b knowledge_version = 1;
+static int knowledge_passes = 0;
+
+static void knowledge_new_stamp(void)
+{
+	if (!++knowledge_stamp) knowledge_stamp++;
+}
+
+static void knowledge_changed(void)
+{
+	if (!++knowledge_version) knowledge_version++;
+	knowledge_new_stamp();
+}
+
+/**
+ * Start remembering knowledge answers; passes may nest
+ */
+void object_knowledge_cache_begin(void)
+{
+	if (!knowledge_passes++) knowledge_new_stamp();
+}
+
+/**
+ * Stop remembering knowledge answers
+ */
+void object_knowledge_cache_end(void)
+{
+	assert(knowledge_passes > 0);
+	knowledge_passes--;
+}
+
+/**
+ * Get the stamp of the running cache pass, or 0 if there is none
+ */
+u32b object_knowledge_cache_stamp(void)
+{
+	return knowledge_passes ? knowledge_stamp : 0;
+}
+
+/**
+ * Get a number which changes whenever player or object knowledge does; it
+ * is never 0, and unlike the pass stamp it holds between passes
+ */
+u32b object_knowledge_version(void)
+{
+	return knowledge_version;
+}
+
+/**
+ * Get the knowledge cache for an object, emptied if it is out of date, or
+ * NULL if no cache pass is running
+ */
+struct object_knowledge_cache *object_knowledge_cache(const struct object *obj)
+{
+	/* The cache is not part of the object's state, so may change */
+	struct object_knowledge_cache *cache =
+		&((struct object *) obj)->known_cache;
+
+	if (!knowledge_passes) return NULL;
+
+	if (cache->stamp != knowledge_stamp) {
+		cache->stamp = knowledge_stamp;
+		cache->have = 0;
+	}
+	return cache;
+}
+
 /**
  * Check if all non-curse runes on an object are known to the player
  *
@@ -705,16 +782,25 @@ static bool object_non_curse_runes_known(const struct object *obj)
  */
 bool object_runes_known(const struct object *obj)
 {
+	struct object_knowledge_cache *cache;
+	bool known;
+
 	/* No known object */
 	if (!obj->known) return false;
 
-	/* Not all curses known */
-	if (!curses_are_equal(obj, obj->known)) {
-		return false;
-	}
+	cache = object_knowledge_cache(obj);
+	if (cache && (cache->have & KNOWN_CACHE_RUNES))
+		return cache->runes_known;
 
-	/* Answer is now the same as for non-curse runes */
-	return object_non_curse_runes_known(obj);
+	/* Not all curses known, otherwise the same as for non-curse runes */
+	known = curses_are_equal(obj, obj->known) &&
+		object_non_curse_runes_known(obj);
+
+	if (cache) {
+		cache->runes_known = known;
+		cache->have |= KNOWN_CACHE_RUNES;
+	}
+	return known;
 }
 
 
@@ -725,13 +811,20 @@ bool object_runes_known(const struct object *obj)
  */
 bool object_fully_known(const struct object *obj)
 {
-	/* Not all runes known */
-	if (!object_runes_known(obj)) return false;
+	struct object_knowledge_cache *cache = object_knowledge_cache(obj);
+	bool known;
 
-	/* Effect not known */
-	if (!object_effect_is_known(obj)) return false;
+	if (cache && (cache->have & KNOWN_CACHE_FULLY))
+		return cache->fully_known;
 
-	return true;
+	/* All runes and the effect known */
+	known = object_runes_known(obj) && object_effect_is_known(obj);
+
+	if (cache) {
+		cache->fully_known = known;
+		cache->have |= KNOWN_CACHE_FULLY;
+	}
+	return known;
 }
 
 
@@ -853,7 +946,7 @@ void object_sense(struct player *p, struct object *obj)
 
 		/* Attach it to the current floor pile */
 		new_obj->grid = grid;
-		pile_insert_end(&p->cave->squares[grid.y][grid.x].obj, new_obj);
+		square_append_object(p->cave, grid, new_obj);
 	}
 }
 
@@ -890,7 +983,7 @@ void object_see(struct player *p, struct object *obj)
 		new_obj->grid = grid;
 		new_obj->number = obj->number;
 		if (!square_holds_object(p->cave, grid, new_obj)) {
-			pile_insert_end(&p->cave->squares[grid.y][grid.x].obj, new_obj);
+			square_append_object(p->cave, grid, new_obj);
 		}
 	} else if (known_obj->kind != obj->kind) {
 		struct loc old = known_obj->grid;
@@ -910,7 +1003,7 @@ void object_see(struct player *p, struct object *obj)
 		known_obj->grid = grid;
 		known_obj->held_m_idx = 0;
 		if (!square_holds_object(p->cave, grid, known_obj)) {
-			pile_insert_end(&p->cave->squares[grid.y][grid.x].obj, known_obj);
+			square_append_object(p->cave, grid, known_obj);
 		}
 	} else if (!square_holds_object(p->cave, grid, known_obj)) {
 		struct loc old = known_obj->grid;
@@ -927,7 +1020,7 @@ void object_see(struct player *p, struct object *obj)
 		/* Attach it to the current floor pile */
 		known_obj->grid = grid;
 		known_obj->held_m_idx = 0;
-		pile_insert_end(&p->cave->squares[grid.y][grid.x].obj, known_obj);
+		square_append_object(p->cave, grid, known_obj);
 	}
 }
 
@@ -1007,6 +1100,8 @@ void player_know_object(struct player *p, struct object *obj)
 	if (!obj->known) return;
 	if (obj->kind != obj->known->kind) return;
 
+	knowledge_changed();
+
 	/* Distant objects just get base properties */
 	if (obj->kind && !(obj->known->notice & OBJ_NOTICE_ASSESSED)) {
 		object_set_base_known(obj);
@@ -1077,27 +1172,14 @@ void player_know_object(struct player *p, struct object *obj)
 	}
 
 	/* Set curses - be very careful to keep knowledge aligned */
-	if (obj->curses) {
-		bool known_cursed = false;
-		for (i = 1; i < z_info->curse_max; i++) {
-			if (p->obj_k->curses[i].power && obj->curses[i].power) {
-				if (!obj->known->curses) {
-					obj->known->curses = mem_zalloc(z_info->curse_max *
-													sizeof(struct curse_data));
-				}
-				obj->known->curses[i].power = obj->curses[i].power;
-				known_cursed = true;
-			} else if (obj->known->curses) {
-				obj->known->curses[i].power = 0;
-			}
+	mem_free(obj->known->curses);
+	obj->known->curses = NULL;
+	obj->known->num_curses = 0;
+	for (i = 0; i < obj->num_curses; i++) {
+		const struct curse_data *c = &obj->curses[i];
+		if (c->power && object_curse_power(p->obj_k, c->index)) {
+			object_curse_add(obj->known, c->index)->power = c->power;
 		}
-		if (!known_cursed) {
-			mem_free(obj->known->curses);
-			obj->known->curses = NULL;
-		}
-	} else if (obj->known->curses) {
-		mem_free(obj->known->curses);
-		obj->known->curses = NULL;
 	}
 
 	/* Set ego type, jewellery type if known */
@@ -1148,6 +1230,8 @@ void update_player_object_knowledge(struct player *p)
 	int i;
 	struct object *obj;
 
+	knowledge_changed();
+
 	/* Level objects */
 	if (cave)
 		for (i = 0; i < cave->obj_max; i++)
@@ -1173,6 +1257,7 @@ void update_player_object_knowledge(struct player *p)
 	if (cave)
 		autoinscribe_ground();
 	autoinscribe_pack();
+	p->upkeep->update |= (PU_BONUS);
 	event_signal(EVENT_INVENTORY);
 	event_signal(EVENT_EQUIPMENT);
 }
@@ -1183,13 +1268,76 @@ void update_player_object_knowledge(struct player *p)
  * These functions are for increasing player knowledge of object properties
  * ------------------------------------------------------------------------ */
 /**
- * Learn a given rune
+ * Whether learning a rune can change what is known of an object: either the
+ * object has the rune, or it is a rune for an element the object has other
+ * properties for, which player_know_object() passes on along with the resist
+ */
+static bool rune_affects_object(const struct object *obj, size_t i)
+{
+	struct rune *r = &rune_list[i];
+
+	if (!obj || !obj->known) return false;
+	if (object_has_rune(obj, i)) return true;
+	return (r->variety == RUNE_VAR_RESIST) && obj->el_info[r->index].flags;
+}
+
+/**
+ * Propagate the learning of one rune to the objects it affects, then do the
+ * updates which update_player_object_knowledge() does
+ *
+ * \param p is the player
+ * \param i is the rune index
+ */
+static void update_player_rune_knowledge(struct player *p, size_t i)
+{
+	int j;
+	struct object *obj;
+
+	knowledge_changed();
+
+	/* Level objects */
+	if (cave)
+		for (j = 0; j < cave->obj_max; j++)
+			if (rune_affects_object(cave->objects[j], i))
+				player_know_object(p, cave->objects[j]);
+
+	/* Player objects */
+	for (obj = p->gear; obj; obj = obj->next)
+		if (rune_affects_object(obj, i))
+			player_know_object(p, obj);
+
+	/* Store objects */
+	for (j = 0; j < MAX_STORES; j++) {
+		struct store *s = &stores[j];
+		for (obj = s->stock; obj; obj = obj->next)
+			if (rune_affects_object(obj, i))
+				player_know_object(p, obj);
+	}
+
+	/* Curse objects */
+	for (j = 1; j < z_info->curse_max; j++)
+		if (rune_affects_object(curses[j].obj, i))
+			player_know_object(p, curses[j].obj);
+
+	/* Update */
+	if (cave)
+		autoinscribe_ground();
+	autoinscribe_pack();
+	p->upkeep->update |= (PU_BONUS);
+	event_signal(EVENT_INVENTORY);
+	event_signal(EVENT_EQUIPMENT);
+}
+
+/**
+ * Add a given rune to the player's knowledge, without passing it on to
+ * objects
  *
  * \param p is the player
  * \param i is the rune index
  * \param message is whether or not to print a message
+ * \return whether the rune was new
  */
-static void player_learn_rune(struct player *p, size_t i, bool message)
+static bool player_add_rune(struct player *p, size_t i, bool message)
 {
 	struct rune *r = &rune_list[i];
 	bool learned = false;
@@ -1273,7 +1421,7 @@ static void player_learn_rune(struct player *p, size_t i, bool message)
 
 			/* If the curse was unknown, add it to known curses */
 			if (!player_knows_curse(p, i)) {
-				p->obj_k->curses[i].power = 1;
+				object_curse_add(p->obj_k, i)->power = 1;
 				learned = true;
 			}
 			break;
@@ -1291,35 +1439,49 @@ static void player_learn_rune(struct player *p, size_t i, bool message)
 	}
 
 	/* Nothing learned */
-	if (!learned) return;
+	if (!learned) return false;
 
 	/* Give a message */
 	if (message)
 		msgt(MSG_RUNE, "You have learned the rune of %s.", rune_name(i));
 
-	/* Update knowledge */
-	update_player_object_knowledge(p);
+	return true;
+}
+
+/**
+ * Learn a given rune
+ *
+ * \param p is the player
+ * \param i is the rune index
+ * \param message is whether or not to print a message
+ */
+static void player_learn_rune(struct player *p, size_t i, bool message)
+{
+	if (player_add_rune(p, i, message))
+		update_player_rune_knowledge(p, i);
 }
 
 /**
- * Learn a flag
+ * Learn a flag; objects with the flag are updated even if it was known, as
+ * an object may just have been given it
  */
 void player_learn_flag(struct player *p, int flag)
 {
-	player_learn_rune(p, rune_index(RUNE_VAR_FLAG, flag), true);
-	update_player_object_knowledge(p);
+	int index = rune_index(RUNE_VAR_FLAG, flag);
+	player_add_rune(p, index, true);
+	update_player_rune_knowledge(p, index);
 }
 
 /**
- * Learn a curse
+ * Learn a curse, updating the objects with it as for player_learn_flag()
  */
 void player_learn_curse(struct player *p, struct curse *curse)
 {
 	int index = rune_index(RUNE_VAR_CURSE, lookup_curse(curse->name));
 	if (index >= 0) {
-		player_learn_rune(p, index, true);
+		player_add_rune(p, index, true);
+		update_player_rune_knowledge(p, index);
 	}
-	update_player_object_knowledge(p);
 }
 
 /**
@@ -1334,14 +1496,14 @@ void player_learn_innate(struct player *p)
 	/* Elements */
 	for (element = 0; element < ELEM_MAX; element++) {
 		if (p->race->el_info[element].res_level != 0) {
-			player_learn_rune(p, rune_index(RUNE_VAR_RESIST, element), false);
+			player_add_rune(p, rune_index(RUNE_VAR_RESIST, element), false);
 		}
 	}
 
 	/* Flags */
 	for (flag = of_next(p->race->flags, FLAG_START); flag != FLAG_END;
 		 flag = of_next(p->race->flags, flag + 1)) {
-		player_learn_rune(p, rune_index(RUNE_VAR_FLAG, flag), false);
+		player_add_rune(p, rune_index(RUNE_VAR_FLAG, flag), false);
 	}
 
 	update_player_object_knowledge(p);
@@ -1356,8 +1518,15 @@ void player_learn_all_runes(struct player *p)
 {
 	size_t i;
 
+	bool learned = false;
+
 	for (i = 0; i < rune_max; i++)
-		player_learn_rune(p, i, false);
+		if (player_add_rune(p, i, false))
+			learned = true;
+
+	/* Update the objects once for all the runes */
+	if (learned)
+		update_player_object_knowledge(p);
 }
 
 /**
@@ -1443,10 +1612,11 @@ void object_curses_find_to_a(struct player *p, struct object *obj)
 {
 	int index = rune_index(RUNE_VAR_COMBAT, COMBAT_RUNE_TO_A);
 	if (obj->curses) {
-		int i;
+		int i, k;
 
-		for (i = 1; i < z_info->curse_max; i++) {
-			if (!obj->curses[i].power || !curses[i].obj)
+		for (k = 0; k < obj->num_curses; k++) {
+			i = obj->curses[k].index;
+			if (!obj->curses[k].power || !curses[i].obj)
 				continue;
 
 			if (curses[i].obj->to_a != 0) {
@@ -1466,10 +1636,11 @@ void object_curses_find_to_h(struct player *p, struct object *obj)
 {
 	int index = rune_index(RUNE_VAR_COMBAT, COMBAT_RUNE_TO_H);
 	if (obj->curses) {
-		int i;
+		int i, k;
 
-		for (i = 1; i < z_info->curse_max; i++) {
-			if (!obj->curses[i].power || !curses[i].obj)
+		for (k = 0; k < obj->num_curses; k++) {
+			i = obj->curses[k].index;
+			if (!obj->curses[k].power || !curses[i].obj)
 				continue;
 
 			if (curses[i].obj->to_h != 0) {
@@ -1489,10 +1660,11 @@ void object_curses_find_to_d(struct player *p, struct object *obj)
 {
 	int index = rune_index(RUNE_VAR_COMBAT, COMBAT_RUNE_TO_D);
 	if (obj->curses) {
-		int i;
+		int i, k;
 
-		for (i = 1; i < z_info->curse_max; i++) {
-			if (!obj->curses[i].power || !curses[i].obj)
+		for (k = 0; k < obj->num_curses; k++) {
+			i = obj->curses[k].index;
+			if (!obj->curses[k].power || !curses[i].obj)
 				continue;
 
 			if (curses[i].obj->to_d != 0) {
@@ -1524,13 +1696,14 @@ bool object_curses_find_flags(struct player *p, struct object *obj,
 
 	object_desc(o_name, sizeof(o_name), obj, ODESC_BASE);
 	if (obj->curses) {
-		int i;
+		int i, k;
 		int index;
 		bitflag f[OF_SIZE];
 		int flag;
 
-		for (i = 1; i < z_info->curse_max; i++) {
-			if (!obj->curses[i].power || !curses[i].obj)
+		for (k = 0; k < obj->num_curses; k++) {
+			i = obj->curses[k].index;
+			if (!obj->curses[k].power || !curses[i].obj)
 				continue;
 
 			/* Get all the relevant flags */
@@ -1567,14 +1740,15 @@ bool object_curses_find_flags(struct player *p, struct object *obj,
  */
 void object_curses_find_modifiers(struct player *p, struct object *obj)
 {
-	int i;
+	int k;
 
 	if (obj->curses) {
-		for (i = 1; i < z_info->curse_max; i++) {
+		for (k = 0; k < obj->num_curses; k++) {
+			int i = obj->curses[k].index;
 			int index = rune_index(RUNE_VAR_CURSE, i);
 			int j;
 
-			if (!obj->curses[i].power || !curses[i].obj)
+			if (!obj->curses[k].power || !curses[i].obj)
 				continue;
 
 			/* Learn all modifiers */
@@ -1612,12 +1786,13 @@ bool object_curses_find_element(struct player *p, struct object *obj, int elem)
 
 	object_desc(o_name, sizeof(o_name), obj, ODESC_BASE);
 	if (obj->curses) {
-		int i;
+		int k;
 
-		for (i = 1; i < z_info->curse_max; i++) {
+		for (k = 0; k < obj->num_curses; k++) {
+			int i = obj->curses[k].index;
 			int index = rune_index(RUNE_VAR_CURSE, i);
 
-			if (!obj->curses[i].power || !curses[i].obj)
+			if (!obj->curses[k].power || !curses[i].obj)
 				continue;
 
 			/* Does the object affect the player's resistance to the element? */
@@ -1832,7 +2007,6 @@ void object_learn_slay(struct player *p, struct object *obj, int index)
 
 		/* Learn the rune */
 		player_learn_rune(p, rune_index(RUNE_VAR_SLAY, i), true);
-		update_player_object_knowledge(p);
 	}
 }
 
@@ -1858,7 +2032,6 @@ void object_learn_brand(struct player *p, struct object *obj, int index)
 
 		/* Learn the rune */
 		player_learn_rune(p, rune_index(RUNE_VAR_BRAND, i), true);
-		update_player_object_knowledge(p);
 	}
 }
 
@@ -2226,6 +2399,7 @@ void object_flavor_aware(struct object *obj)
 	assert(obj->known);
 	if (obj->kind->aware) return;
 	obj->kind->aware = true;
+	knowledge_changed();
 	obj->known->effect = obj->effect;
 
 	/* Fix ignore/autoinscribe */
@@ -62,6 +62,11 @@ bool object_is_known_artifact(const struct object *obj);
 bool object_is_in_store(const struct object *obj);
 bool object_has_standard_to_h(const struct object *obj);
 bool object_has_rune(const struct object *obj, int rune_no);
+void object_knowledge_cache_begin(void);
+void object_knowledge_cache_end(void);
+u32b object_knowledge_cache_stamp(void);
+u32b object_knowledge_version(void);
+struct object_knowledge_cache *object_knowledge_cache(const struct object *obj);
 bool object_runes_known(const struct object *obj);
 bool object_fully_known(const struct object *obj);
 bool object_flag_is_known(const struct object *obj, int flag);
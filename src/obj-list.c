@@ -122,7 +122,8 @@ void object_list_reset(object_list_t *list)
 	if (!object_list_needs_update(list))
 		return;
 
-	memset(list->entries, 0, list->entries_size * sizeof(object_list_entry_t));
+	/* Only the entries used by the last collection can be filled */
+	memset(list->entries, 0, list->distinct_entries * sizeof(object_list_entry_t));
 	memset(list->total_entries, 0, OBJECT_LIST_SECTION_MAX * sizeof(u16b));
 	memset(list->total_objects, 0, OBJECT_LIST_SECTION_MAX * sizeof(u16b));
 	list->distinct_entries = 0;
@@ -154,7 +155,7 @@ static bool object_list_should_ignore_object(const struct object *obj)
  */
 void object_list_collect(object_list_t *list)
 {
-	int i;
+	int i, used;
 	struct loc pgrid = player->grid;
 
 	if (list == NULL || list->entries == NULL)
@@ -163,10 +164,14 @@ void object_list_collect(object_list_t *list)
 	if (!object_list_needs_update(list))
 		return;
 
+	/* Find the first empty slot; each object gets its own entry after it */
+	for (used = 0; used < (int)list->entries_size; used++)
+		if (list->entries[used].object == NULL) break;
+
 	/* Scan each object in the dungeon. */
 	for (i = 1; i < player->cave->obj_max; i++) {
 		object_list_entry_t *entry = NULL;
-		int entry_index;
+		int j;
 		int current_distance;
 		int entry_distance;
 		struct loc grid;
@@ -182,33 +187,22 @@ void object_list_collect(object_list_t *list)
 			grid = obj->grid;
 		}
 
+		if (object_list_should_ignore_object(obj)) continue;
+
 		/* Determine which section of the list the object entry is in */
 		los = projectable(cave, pgrid, grid, PROJECT_NONE) ||
 			loc_eq(grid, pgrid);
 		field = (los) ? OBJECT_LIST_SECTION_LOS : OBJECT_LIST_SECTION_NO_LOS;
 
-		if (object_list_should_ignore_object(obj)) continue;
-
-		/* Find or add a list entry. */
-		for (entry_index = 0; entry_index < (int)list->entries_size;
-			 entry_index++) {
-			int j;
-			struct object *list_obj = list->entries[entry_index].object;
-
-			if (list_obj == NULL) {
-				/* We found an empty slot, so add this object here. */
-				list->entries[entry_index].object = obj;
-				for (j = 0; j < OBJECT_LIST_SECTION_MAX; j++)
-					list->entries[entry_index].count[j] = 0;
-				list->entries[entry_index].dy = grid.y - pgrid.y;
-				list->entries[entry_index].dx = grid.x - pgrid.x;
-				entry = &list->entries[entry_index];
-				break;
-			}
-		}
-
-		if (entry == NULL)
-			return;
+		/* Add a list entry in the next empty slot, if there is one. */
+		if (used == (int)list->entries_size)
+			break;
+		entry = &list->entries[used++];
+		entry->object = obj;
+		for (j = 0; j < OBJECT_LIST_SECTION_MAX; j++)
+			entry->count[j] = 0;
+		entry->dy = grid.y - pgrid.y;
+		entry->dx = grid.x - pgrid.x;
 
 		/* We only know the number of objects we've actually seen */
 		if (obj->kind == cave->objects[obj->oidx]->kind)
@@ -229,7 +223,7 @@ void object_list_collect(object_list_t *list)
 	}
 
 	/* Collect totals for easier calculations of the list. */
-	for (i = 0; i < (int)list->entries_size; i++) {
+	for (i = 0; i < used; i++) {
 		if (list->entries[i].object == NULL)
 			continue;
 
@@ -367,19 +361,15 @@ void object_list_format_name(const object_list_entry_t *entry,
 	const char *chunk;
 	char *source;
 	bool has_singular_prefix;
-	bool los = false;
 	int field;
 	byte old_number;
-	struct loc pgrid = player->grid;
 	struct object *base_obj;
-	struct loc grid;
 	bool object_is_recognized_artifact;
 
 	if (entry == NULL || entry->object == NULL || entry->object->kind == NULL)
 		return;
 
 	base_obj = cave->objects[entry->object->oidx];
-	grid = entry->object->grid;
 	object_is_recognized_artifact = object_is_known_artifact(base_obj);
 
 	/* Hack - these don't have a prefix when there is only one, so just pad
@@ -408,9 +398,9 @@ void object_list_format_name(const object_list_entry_t *entry,
 	if (entry->object->kind != base_obj->kind)
 		has_singular_prefix = true;
 
-	/* Work out if the object is in view */
-	los = projectable(cave, pgrid, grid, PROJECT_NONE) || loc_eq(grid, pgrid);
-	field = los ? OBJECT_LIST_SECTION_LOS : OBJECT_LIST_SECTION_NO_LOS;
+	/* Collection counted the object in the section it is in view from */
+	field = entry->count[OBJECT_LIST_SECTION_LOS] ?
+		OBJECT_LIST_SECTION_LOS : OBJECT_LIST_SECTION_NO_LOS;
 
 	/*
 	 * Because each entry points to a specific object and not something more
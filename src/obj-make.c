@@ -31,16 +31,36 @@
 #include "obj-tval.h"
 #include "obj-util.h"
 
-/** Arrays holding an index of objects to generate for a given level */
-static u32b *obj_total;
-static byte *obj_alloc;
+/**
+ * Arrays holding, for each level, the running total of allocation
+ * probabilities over the object kinds in kidx order, so that a kind can
+ * be picked with a binary search; the last entry of a level's row is the
+ * total for that level.
+ */
+static u32b *obj_alloc;
+static u32b *obj_alloc_great;
 
-static u32b *obj_total_great;
-static byte *obj_alloc_great;
+/**
+ * The same running totals taken over the kinds grouped by tval, for
+ * choosing a kind of a given tval.  The kinds of tval t are
+ * obj_tval_kinds[obj_tval_start[t]] to obj_tval_kinds[obj_tval_start[t + 1] - 1].
+ */
+static s16b *obj_tval_kinds;
+static int obj_tval_start[TV_MAX + 1];
+static u32b *obj_tval_alloc;
+static u32b *obj_tval_alloc_great;
 
 static s16b alloc_ego_size = 0;
 static alloc_entry *alloc_ego_table;
 
+/**
+ * The entries of alloc_ego_table which can apply to each object kind; those
+ * for kind k are ego_kind_egos[ego_kind_start[k]] to
+ * ego_kind_egos[ego_kind_start[k + 1] - 1], in table order.
+ */
+static int *ego_kind_start;
+static s16b *ego_kind_egos;
+
 struct money {
 	char *name;
 	int type;
@@ -53,38 +73,69 @@ static int num_money_types;
  * Initialize object allocation info
  */
 static void alloc_init_objects(void) {
-	int item, lev;
+	int item, lev, tval;
 	int k_max = z_info->k_max;
+	size_t size = (z_info->max_obj_depth + 1) * k_max * sizeof(u32b);
 
 	/* Allocate and wipe */
-	obj_alloc = mem_zalloc((z_info->max_obj_depth + 1) * k_max * sizeof(byte));
-	obj_alloc_great = mem_zalloc((z_info->max_obj_depth + 1) * k_max * sizeof(byte));
-	obj_total = mem_zalloc((z_info->max_obj_depth + 1) * sizeof(u32b));
-	obj_total_great = mem_zalloc((z_info->max_obj_depth + 1) * sizeof(u32b));
+	obj_alloc = mem_zalloc(size);
+	obj_alloc_great = mem_zalloc(size);
+	obj_tval_alloc = mem_zalloc(size);
+	obj_tval_alloc_great = mem_zalloc(size);
+	obj_tval_kinds = mem_zalloc(k_max * sizeof(s16b));
+
+	/* Group the kinds by tval */
+	memset(obj_tval_start, 0, sizeof(obj_tval_start));
+	for (item = 0; item < k_max; item++)
+		obj_tval_start[k_info[item].tval + 1]++;
+	for (tval = 1; tval <= TV_MAX; tval++)
+		obj_tval_start[tval] += obj_tval_start[tval - 1];
+	for (tval = 0, item = 0; tval < TV_MAX; tval++) {
+		int kidx;
+		for (kidx = 0; kidx < k_max; kidx++)
+			if (k_info[kidx].tval == tval)
+				obj_tval_kinds[item++] = kidx;
+	}
 
 	/* Init allocation data */
-	for (item = 0; item < k_max; item++) {
-		const struct object_kind *kind = &k_info[item];
+	for (lev = 0; lev <= z_info->max_obj_depth; lev++) {
+		u32b total = 0, total_great = 0;
+		u32b *row = obj_alloc + lev * k_max;
+		u32b *row_great = obj_alloc_great + lev * k_max;
+
+		/* Running totals in kidx order */
+		for (item = 0; item < k_max; item++) {
+			const struct object_kind *kind = &k_info[item];
+			int rarity = kind->alloc_prob;
 
-		int min = kind->alloc_min;
-		int max = kind->alloc_max;
+			/* Save the probability in the standard table */
+			if ((lev < kind->alloc_min) || (lev > kind->alloc_max))
+				rarity = 0;
+			total += rarity;
+			row[item] = total;
 
-		/* If an item doesn't have a rarity, move on */
-		if (!kind->alloc_prob) continue;
+			/* Save the probability in the "great" table if relevant */
+			if (!kind_is_good(kind)) rarity = 0;
+			total_great += rarity;
+			row_great[item] = total_great;
+		}
 
-		/* Go through all the dungeon levels */
-		for (lev = 0; lev <= z_info->max_obj_depth; lev++) {
+		/* Running totals in tval order */
+		row = obj_tval_alloc + lev * k_max;
+		row_great = obj_tval_alloc_great + lev * k_max;
+		total = total_great = 0;
+		for (item = 0; item < k_max; item++) {
+			const struct object_kind *kind = &k_info[obj_tval_kinds[item]];
 			int rarity = kind->alloc_prob;
 
-			/* Save the probability in the standard table */
-			if ((lev < min) || (lev > max)) rarity = 0;
-			obj_total[lev] += rarity;
-			obj_alloc[(lev * k_max) + item] = rarity;
+			if ((lev < kind->alloc_min) || (lev > kind->alloc_max))
+				rarity = 0;
+			total += rarity;
+			row[item] = total;
 
-			/* Save the probability in the "great" table if relevant */
 			if (!kind_is_good(kind)) rarity = 0;
-			obj_total_great[lev] += rarity;
-			obj_alloc_great[(lev * k_max) + item] = rarity;
+			total_great += rarity;
+			row_great[item] = total_great;
 		}
 	}
 }
@@ -100,7 +151,7 @@ static void alloc_init_egos(void) {
 	int *num = mem_zalloc((z_info->max_obj_depth + 1) * sizeof(int));
 	int *level_total = mem_zalloc((z_info->max_obj_depth + 1) * sizeof(int));
 
-	int i;
+	int i, pass;
 
 	for (i = 0; i < z_info->e_max; i++) {
 		struct ego_item *ego = &e_info[i];
@@ -149,6 +200,29 @@ static void alloc_init_egos(void) {
 
 	mem_free(level_total);
 	mem_free(num);
+
+	/* List the egos each kind can have, counting first then filling in */
+	ego_kind_start = mem_zalloc((z_info->k_max + 1) * sizeof(int));
+	for (pass = 0; pass < 2; pass++) {
+		int n = 0, k;
+		for (k = 0; k < z_info->k_max; k++) {
+			if (pass) ego_kind_start[k] = n;
+			for (i = 0; i < alloc_ego_size; i++) {
+				struct ego_item *ego = &e_info[alloc_ego_table[i].index];
+				struct poss_item *poss;
+
+				for (poss = ego->poss_items; poss; poss = poss->next)
+					if (poss->kidx == (u32b) k) break;
+				if (!poss) continue;
+				if (pass) ego_kind_egos[n] = i;
+				n++;
+			}
+		}
+		if (pass)
+			ego_kind_start[z_info->k_max] = n;
+		else
+			ego_kind_egos = mem_zalloc((n + 1) * sizeof(s16b));
+	}
 }
 
 /*
@@ -187,9 +261,13 @@ static void cleanup_obj_make(void) {
 		string_free(money_type[i].name);
 	}
 	mem_free(money_type);
+	mem_free(ego_kind_egos);
+	mem_free(ego_kind_start);
 	mem_free(alloc_ego_table);
-	mem_free(obj_total_great);
-	mem_free(obj_total);
+	alloc_ego_size = 0;
+	mem_free(obj_tval_kinds);
+	mem_free(obj_tval_alloc_great);
+	mem_free(obj_tval_alloc);
 	mem_free(obj_alloc_great);
 	mem_free(obj_alloc);
 }
@@ -284,44 +362,59 @@ static int random_high_resist(struct object *obj, int *resist)
  */
 static struct ego_item *ego_find_random(struct object *obj, int level)
 {
-	int i;
+	int i, lo, hi;
 	long total = 0L;
+	int first = ego_kind_start[obj->kind->kidx];
+	int last = ego_kind_start[obj->kind->kidx + 1];
 
 	alloc_entry *table = alloc_ego_table;
 
-	/* Go through all possible ego items and find ones which fit this item */
-	for (i = 0; i < alloc_ego_size; i++) {
+	/* Egos are sorted by minimum depth; find the first one out of depth */
+	lo = 0;
+	hi = alloc_ego_size;
+	while (lo < hi) {
+		int mid = (lo + hi) / 2;
+		if (table[mid].level > level)
+			hi = mid;
+		else
+			lo = mid + 1;
+	}
+
+	/* Every out of depth ego gets its chance, whether it fits or not */
+	for (i = lo; i < alloc_ego_size; i++) {
 		struct ego_item *ego = &e_info[table[i].index];
 
-		/* Reset any previous probability of this type being picked */
 		table[i].prob3 = 0;
-
 		if (level <= ego->alloc_max) {
 			int ood_chance = MAX(2, (ego->alloc_min - level) / 3);
-			if (level >= ego->alloc_min || one_in_(ood_chance)) {
-				struct poss_item *poss;
+			if (one_in_(ood_chance))
+				table[i].prob3 = table[i].prob2;
+		}
+	}
 
-				for (poss = ego->poss_items; poss; poss = poss->next)
-					if (poss->kidx == obj->kind->kidx) {
-						table[i].prob3 = table[i].prob2;
-						break;
-					}
+	/* Go through the ego items which fit this item */
+	for (i = first; i < last; i++) {
+		alloc_entry *entry = &table[ego_kind_egos[i]];
 
-				/* Total */
-				total += table[i].prob3;
-			}
-		}
+		if (entry->level <= level)
+			entry->prob3 =
+				(level <= e_info[entry->index].alloc_max) ? entry->prob2 : 0;
+
+		/* Total */
+		total += entry->prob3;
 	}
 
 	if (total) {
 		long value = randint0(total);
-		for (i = 0; i < alloc_ego_size; i++) {
+		for (i = first; i < last; i++) {
+			alloc_entry *entry = &table[ego_kind_egos[i]];
+
 			/* Found the entry */
-			if (value < table[i].prob3) {
-				return &e_info[table[i].index];
+			if (value < entry->prob3) {
+				return &e_info[entry->index];
 			} else {
 				/* Decrement */
-				value = value - table[i].prob3;
+				value = value - entry->prob3;
 			}
 		}
 	}
@@ -1024,39 +1117,45 @@ bool kind_is_good(const struct object_kind *kind)
 }
 
 
+/**
+ * Find the first of `num` running totals which is greater than `value`
+ */
+static size_t alloc_search(const u32b *totals, size_t num, u32b value)
+{
+	size_t lo = 0, hi = num;
+
+	while (lo < hi) {
+		size_t mid = (lo + hi) / 2;
+		if (totals[mid] > value)
+			hi = mid;
+		else
+			lo = mid + 1;
+	}
+
+	return lo;
+}
+
 /**
  * Choose an object kind of a given tval given a dungeon level.
  */
 static struct object_kind *get_obj_num_by_kind(int level, bool good, int tval)
 {
-	/* This is the base index into obj_alloc for this dlev */
-	size_t ind, item;
+	/* This is the base index into the tables for this dlev */
+	size_t ind = level * z_info->k_max;
+	const u32b *totals = (good ? obj_tval_alloc_great : obj_tval_alloc) + ind;
+	int first = obj_tval_start[tval], last = obj_tval_start[tval + 1];
+	u32b base = first ? totals[first - 1] : 0;
 	u32b value;
-	int total = 0;
-	byte *objects = good ? obj_alloc_great : obj_alloc;
-
-	/* Pick an object */
-	ind = level * z_info->k_max;
-
-	/* Get new total */
-	for (item = 0; item < z_info->k_max; item++)
-		if (objkind_byid(item)->tval == tval)
-			total += objects[ind + item];
+	size_t item;
 
 	/* No appropriate items of that tval */
-	if (!total) return NULL;
-	
-	value = randint0(total);
-	
-	for (item = 0; item < z_info->k_max; item++)
-		if (objkind_byid(item)->tval == tval) {
-			if (value < objects[ind + item]) break;
+	if (first == last || totals[last - 1] == base) return NULL;
 
-			value -= objects[ind + item];
-		}
+	value = base + randint0(totals[last - 1] - base);
+	item = first + alloc_search(totals + first, last - first, value);
 
 	/* Return the item index */
-	return objkind_byid(item);
+	return objkind_byid(obj_tval_kinds[item]);
 }
 
 /**
@@ -1066,15 +1165,25 @@ static struct object_kind *get_obj_num_by_kind(int level, bool good, int tval)
  */
 struct object_kind *get_obj_num(int level, bool good, int tval)
 {
-	/* This is the base index into obj_alloc for this dlev */
-	size_t ind, item;
-	u32b value;
-
 	/* Occasional level boost */
 	if ((level > 0) && one_in_(z_info->great_obj))
 		/* What a bizarre calculation */
 		level = 1 + (level * z_info->max_obj_depth / randint1(z_info->max_obj_depth));
 
+	return get_obj_num_at(level, good, tval);
+}
+
+/**
+ * Choose an object kind as get_obj_num() does, but for exactly the given
+ * level, without the occasional level boost.
+ */
+struct object_kind *get_obj_num_at(int level, bool good, int tval)
+{
+	/* This is the base index into the tables for this dlev */
+	size_t ind;
+	const u32b *totals;
+	u32b value;
+
 	/* Paranoia */
 	level = MIN(level, z_info->max_obj_depth);
 	level = MAX(level, 0);
@@ -1084,29 +1193,12 @@ struct object_kind *get_obj_num(int level, bool good, int tval)
 	
 	if (tval)
 		return get_obj_num_by_kind(level, good, tval);
-	
-	if (!good) {
-		value = randint0(obj_total[level]);
-		for (item = 0; item < z_info->k_max; item++) {
-			/* Found it */
-			if (value < obj_alloc[ind + item]) break;
-
-			/* Decrement */
-			value -= obj_alloc[ind + item];
-		}
-	} else {
-		value = randint0(obj_total_great[level]);
-		for (item = 0; item < z_info->k_max; item++) {
-			/* Found it */
-			if (value < obj_alloc_great[ind + item]) break;
-
-			/* Decrement */
-			value -= obj_alloc_great[ind + item];
-		}
-	}
+
+	totals = (good ? obj_alloc_great : obj_alloc) + ind;
+	value = randint0(totals[z_info->k_max - 1]);
 
 	/* Return the item index */
-	return objkind_byid(item);
+	return objkind_byid(alloc_search(totals, z_info->k_max, value));
 }
 
 
@@ -36,6 +36,7 @@ int apply_magic(struct object *obj, int lev, bool okay, bool good,
 				bool great, bool extra_roll);
 bool kind_is_good(const struct object_kind *kind);
 struct object_kind *get_obj_num(int level, bool good, int tval);
+struct object_kind *get_obj_num_at(int level, bool good, int tval);
 struct object *make_object(struct chunk *c, int lev, bool good, bool great,
 						   bool extra_roll, s32b *value, int tval);
 void acquirement(struct loc grid, int level, int num, bool great);
@@ -282,7 +282,11 @@ bool pile_contains(const struct object *top, const struct object *obj)
  */
 struct object *object_new(void)
 {
-	return mem_zalloc(sizeof(struct object));
+	enum mem_tag tag = mem_tag_set(MEM_TAG_OBJECT);
+	struct object *obj = mem_zalloc(sizeof(struct object));
+
+	mem_tag_set(tag);
+	return obj;
 }
 
 /**
@@ -337,14 +341,19 @@ void object_delete(struct object **obj_address)
 		return;
 	}
 
-	/* Remove from any lists */
+	/* Remove from any lists, either of which may free a slot */
 	if (player && player->cave && player->cave->objects && obj->oidx
-		&& (obj == player->cave->objects[obj->oidx]))
+		&& (obj == player->cave->objects[obj->oidx])) {
 		player->cave->objects[obj->oidx] = NULL;
+		if (cave)
+			free_slots_push(&cave->obj_free, obj->oidx);
+	}
 
 	if (cave && cave->objects && obj->oidx
-		&& (obj == cave->objects[obj->oidx]))
+		&& (obj == cave->objects[obj->oidx])) {
 		cave->objects[obj->oidx] = NULL;
+		free_slots_push(&cave->obj_free, obj->oidx);
+	}
 
 	object_free(obj);
 	*obj_address = NULL;
@@ -385,34 +394,13 @@ bool object_stackable(const struct object *obj1, const struct object *obj2,
 {
 	int i;
 
-	/* Equipment items don't stack */
-	if (object_is_equipped(player->body, obj1))
-		return false;
-	if (object_is_equipped(player->body, obj2))
-		return false;
-
-	/* If either item is unknown, do not stack */
-	if (mode & OSTACK_LIST && obj1->kind != obj1->known->kind) return false;
-	if (mode & OSTACK_LIST && obj2->kind != obj2->known->kind) return false;
-
 	/* Hack -- identical items cannot be stacked */
 	if (obj1 == obj2) return false;
 
-	/* Require identical object kinds */
+	/* Require identical object kinds; almost every pair that won't stack is
+	 * turned away here, before the dearer tests below */
 	if (obj1->kind != obj2->kind) return false;
 
-	/* Different flags don't stack */
-	if (!of_is_equal(obj1->flags, obj2->flags)) return false;
-
-	/* Different elements don't stack */
-	for (i = 0; i < ELEM_MAX; i++) {
-		if (obj1->el_info[i].res_level != obj2->el_info[i].res_level)
-			return false;
-		if ((obj1->el_info[i].flags & (EL_INFO_HATES | EL_INFO_IGNORE)) !=
-			(obj2->el_info[i].flags & (EL_INFO_HATES | EL_INFO_IGNORE)))
-			return false;
-	}
-
 	/* Artifacts never stack */
 	if (obj1->artifact || obj2->artifact) return false;
 
@@ -435,9 +423,6 @@ bool object_stackable(const struct object *obj1, const struct object *obj2,
 		/* ... otherwise ok */
 	} else if (tval_is_weapon(obj1) || tval_is_armor(obj1) ||
 		tval_is_jewelry(obj1) || tval_is_light(obj1)) {
-		bool obj1_is_known = object_fully_known((struct object *)obj1);
-		bool obj2_is_known = object_fully_known((struct object *)obj2);
-
 		/* Require identical values */
 		if (obj1->ac != obj2->ac) return false;
 		if (obj1->dd != obj2->dd) return false;
@@ -456,9 +441,6 @@ bool object_stackable(const struct object *obj1, const struct object *obj2,
 		/* Require identical ego-item types */
 		if (obj1->ego != obj2->ego) return false;
 
-		/* Require identical curses */
-		if (!curses_are_equal(obj1, obj2)) return false;
-
 		/* Hack - Never stack recharging wearables ... */
 		if ((obj1->timeout || obj2->timeout) &&
 			!tval_is_light(obj1)) return false;
@@ -467,8 +449,13 @@ bool object_stackable(const struct object *obj1, const struct object *obj2,
 		else if ((obj1->timeout != obj2->timeout) &&
 				 tval_is_light(obj1)) return false;
 
+		/* Require identical curses */
+		if (!curses_are_equal(obj1, obj2)) return false;
+
 		/* Prevent unIDd items stacking with IDd items in the object list */
-		if (mode & OSTACK_LIST && (obj1_is_known != obj2_is_known))
+		if ((mode & OSTACK_LIST) &&
+			(object_fully_known((struct object *)obj1) !=
+			 object_fully_known((struct object *)obj2)))
 			return false;
 	} else {
 		/* Anything else probably okay */
@@ -478,6 +465,28 @@ bool object_stackable(const struct object *obj1, const struct object *obj2,
 	if (obj1->note && obj2->note && (obj1->note != obj2->note))
 		return false;
 
+	/* Different flags don't stack */
+	if (!of_is_equal(obj1->flags, obj2->flags)) return false;
+
+	/* Different elements don't stack */
+	for (i = 0; i < ELEM_MAX; i++) {
+		if (obj1->el_info[i].res_level != obj2->el_info[i].res_level)
+			return false;
+		if ((obj1->el_info[i].flags & (EL_INFO_HATES | EL_INFO_IGNORE)) !=
+			(obj2->el_info[i].flags & (EL_INFO_HATES | EL_INFO_IGNORE)))
+			return false;
+	}
+
+	/* If either item is unknown, do not stack */
+	if (mode & OSTACK_LIST && obj1->kind != obj1->known->kind) return false;
+	if (mode & OSTACK_LIST && obj2->kind != obj2->known->kind) return false;
+
+	/* Equipment items don't stack; this walks the body, so it comes last */
+	if (object_is_equipped(player->body, obj1))
+		return false;
+	if (object_is_equipped(player->body, obj2))
+		return false;
+
 	/* They must be similar enough */
 	return true;
 }
@@ -636,22 +645,22 @@ void object_wipe(struct object *obj)
  */
 void object_copy(struct object *dest, const struct object *src)
 {
+	enum mem_tag tag = mem_tag_set(MEM_TAG_OBJECT);
+
 	/* Copy the structure */
 	memcpy(dest, src, sizeof(struct object));
 
 	if (src->slays) {
-		dest->slays = mem_zalloc(z_info->slay_max * sizeof(bool));
+		dest->slays = mem_alloc(z_info->slay_max * sizeof(bool));
 		memcpy(dest->slays, src->slays, z_info->slay_max * sizeof(bool));
 	}
 	if (src->brands) {
-		dest->brands = mem_zalloc(z_info->brand_max * sizeof(bool));
+		dest->brands = mem_alloc(z_info->brand_max * sizeof(bool));
 		memcpy(dest->brands, src->brands, z_info->brand_max * sizeof(bool));
 	}
-	if (src->curses) {
-		size_t array_size = z_info->curse_max * sizeof(struct curse_data);
-		dest->curses = mem_zalloc(array_size);
-		memcpy(dest->curses, src->curses, array_size);
-	}
+	dest->curses = NULL;
+	object_curses_copy(dest, src);
+	mem_tag_set(tag);
 
 	/* Detach from any pile */
 	dest->prev = NULL;
@@ -882,7 +891,7 @@ bool floor_carry(struct chunk *c, struct loc grid, struct object *drop,
 	drop->held_m_idx = 0;
 
 	/* Link to the first object in the pile */
-	pile_insert(&c->squares[grid.y][grid.x].obj, drop);
+	square_insert_object(c, grid, drop);
 
 	/* Record in the level list */
 	list_object(c, drop);
@@ -1224,10 +1233,6 @@ int scan_items(struct object **item_list, size_t item_max, int mode,
 	bool use_quiver = ((mode & USE_QUIVER) ? true : false);
 	bool use_floor = ((mode & USE_FLOOR) ? true : false);
 
-	int floor_max = z_info->floor_size;
-	struct object **floor_list = mem_zalloc(floor_max * sizeof(struct object *));
-	int floor_num;
-
 	int i;
 	size_t item_num = 0;
 
@@ -1249,17 +1254,12 @@ int scan_items(struct object **item_list, size_t item_max, int mode,
 				item_list[item_num++] = player->upkeep->quiver[i];
 		}
 
-	/* Scan all non-gold objects in the grid */
-	if (use_floor) {
-		floor_num = scan_floor(floor_list, floor_max,
+	/* Scan all non-gold objects in the grid straight into the list */
+	if (use_floor && item_num < item_max)
+		item_num += scan_floor(item_list + item_num, item_max - item_num,
 							   OFLOOR_TEST | OFLOOR_SENSE | OFLOOR_VISIBLE,
 							   tester);
 
-		for (i = 0; i < floor_num && item_num < item_max; i++)
-			item_list[item_num++] = floor_list[i];
-	}
-
-	mem_free(floor_list);
 	return item_num;
 }
 
@@ -199,9 +199,11 @@ static int artifact_power(int a_idx, char *reason, bool verbose)
 
 	object_copy(known_obj, obj);
 	obj->known = known_obj;
-	object_desc(buf, 256 * sizeof(char), obj,
-				ODESC_PREFIX | ODESC_FULL | ODESC_SPOIL);
-	file_putf(log_file, "%s\n", buf);
+	if (log_file) {
+		object_desc(buf, 256 * sizeof(char), obj,
+					ODESC_PREFIX | ODESC_FULL | ODESC_SPOIL);
+		file_putf(log_file, "%s\n", buf);
+	}
 
 	power = object_power(obj, verbose, log_file);
 
@@ -2848,7 +2850,7 @@ void write_randart_entry(ang_file *fff, struct artifact *art)
 	if (!art->name) return;
 
 	/* Output description */
-	file_putf(fff, "# %s\n", art->text);
+	file_putf(fff, "# %s\n", artifact_text(art));
 
 	/* Output name */
 	file_putf(fff, "name:%s\n", art->name);
@@ -2926,7 +2928,7 @@ void write_randart_entry(ang_file *fff, struct artifact *art)
 	}
 
 	/* Output description again */
-	file_putf(fff, "desc:%s\n", art->text);
+	file_putf(fff, "desc:%s\n", artifact_text(art));
 
 	file_putf(fff, "\n");
 }
@@ -2944,13 +2946,15 @@ void do_randart(u32b randart_seed, bool create_file)
 	Rand_value = randart_seed;
 	Rand_quick = true;
 
-	/* Open the log file for writing */
-	path_build(fname, sizeof(fname), ANGBAND_DIR_USER, "randart.log");
-	log_file = file_open(fname, MODE_WRITE, FTYPE_TEXT);
-	if (!log_file) {
-		msg("Error - can't open randart.log for writing.");
-		artifact_set_data_free(standarts);
-		exit(1);
+	/* Open the log file for writing; only a set that is kept is logged */
+	if (create_file) {
+		path_build(fname, sizeof(fname), ANGBAND_DIR_USER, "randart.log");
+		log_file = file_open(fname, MODE_WRITE, FTYPE_TEXT);
+		if (!log_file) {
+			msg("Error - can't open randart.log for writing.");
+			artifact_set_data_free(standarts);
+			exit(1);
+		}
 	}
 
 	/* Store the original power ratings */
@@ -2962,6 +2966,7 @@ void do_randart(u32b randart_seed, bool create_file)
 	/* Generate the random artifacts */
 	create_artifact_set(standarts);
 	artifact_set_data_free(standarts);
+	object_names_free();
 
 	/* Look at the frequencies on the finished items */
 	randarts = artifact_set_data_new();
@@ -2970,10 +2975,11 @@ void do_randart(u32b randart_seed, bool create_file)
 	artifact_set_data_free(randarts);
 
 	/* Close the log file */
-	if (!file_close(log_file)) {
+	if (log_file && !file_close(log_file)) {
 		msg("Error - can't close randart.log file.");
 		exit(1);
 	}
+	log_file = NULL;
 
 	/* Write a data file if required */
 	if (create_file) {
@@ -2995,6 +3001,7 @@ void do_randart(u32b randart_seed, bool create_file)
 		if (!file_close(log_file)) {
 			quit_fmt("Error - can't close %s.", fname);
 		}
+		log_file = NULL;
 	}
 
 	/* When done, resume use of the Angband "complex" RNG. */
@@ -247,16 +247,28 @@ int slay_count(bool *slays)
  * \param mon is the monster we're testing for being slain
  */
 bool react_to_specific_slay(struct slay *slay, const struct monster *mon)
+{
+	return react_to_slay_race(slay, mon->race);
+}
+
+/**
+ * React to slays which hurt any monster of a race
+ *
+ * \param slay is the slay we're testing for effectiveness
+ * \param race is the race we're testing for being slain
+ */
+bool react_to_slay_race(const struct slay *slay,
+						const struct monster_race *race)
 {
 	if (!slay->name) return false;
-	if (!mon->race->base) return false;
+	if (!race->base) return false;
 
 	/* Check the race flag */
-	if (rf_has(mon->race->flags, slay->race_flag))
+	if (rf_has(race->flags, slay->race_flag))
 		return true;
 
 	/* Check for monster base */
-	if (slay->base && streq(slay->base, mon->race->base->name))
+	if (slay->base && streq(slay->base, race->base->name))
 		return true;
 
 	return false;
@@ -307,39 +319,65 @@ bool player_has_temporary_slay(int idx)
 }
 
 /**
- * Extract the multiplier from a given object hitting a given monster.
+ * ------------------------------------------------------------------------
+ * Attack modifier cache
+ *
+ * What an object's slays and brands (or the temporary ones, for no object)
+ * do to a monster is the same for every blow of an attack, and so is what
+ * the player learns from them after the first blow, so during a pass over
+ * one attack command the answers are remembered.
+ * ------------------------------------------------------------------------ */
+#define SLAY_CACHE_SIZE 16
+
+static struct slay_cache_entry {
+	const struct object *obj;
+	const struct monster_race *race;
+	bool range;
+	bool visible;
+	int brand;
+	int slay;
+	int mult;
+} slay_cache[SLAY_CACHE_SIZE];
+static int slay_cache_num;
+static bool slay_cache_on = false;
+
+/**
+ * Start remembering attack modifiers; objects must not change until
+ * slay_cache_end()
+ */
+void slay_cache_begin(void)
+{
+	slay_cache_on = true;
+	slay_cache_num = 0;
+}
+
+/**
+ * Stop remembering attack modifiers
+ */
+void slay_cache_end(void)
+{
+	slay_cache_on = false;
+}
+
+/**
+ * Find the best slay or brand of an object against a monster, or of the
+ * player's temporary ones if there is no object, learning as we go
  *
  * \param obj is the object being used to attack
  * \param mon is the monster being attacked
- * \param brand_used is the brand that gave the best multiplier, or NULL
- * \param slay_used is the slay that gave the best multiplier, or NULL
- * \param verb is the verb used in the attack ("smite", etc)
- * \param real is whether this is a real attack (where we update lore) or a
- *  simulation (where we don't)
+ * \param brand is set to the best brand, or 0
+ * \param slay is set to the best slay if it beats the best brand, or 0
+ * \param mult is set to the multiplier of the best, or 1 if there is none
  */
-void improve_attack_modifier(struct object *obj, const struct monster *mon,
-							 int *brand_used, int *slay_used, char *verb,
-							 bool range)
+static void best_attack_modifier(struct object *obj, const struct monster *mon,
+								 int *brand, int *slay, int *mult)
 {
-	int i, best_mult = 1;
+	int i;
 	struct monster_lore *lore = get_lore(mon->race);
 
-	/* Set the current best multiplier */
-	if (*brand_used) {
-		struct brand *b = &brands[*brand_used];
-		if (!OPT(player, birth_percent_damage)) {
-			best_mult = MAX(best_mult, b->multiplier);
-		} else {
-			best_mult = MAX(best_mult, b->o_multiplier);
-		}
-	} else if (*slay_used) {
-		struct slay *s = &slays[*slay_used];
-		if (!OPT(player, birth_percent_damage)) {
-			best_mult = MAX(best_mult, s->multiplier);
-		} else {
-			best_mult = MAX(best_mult, s->o_multiplier);
-		}
-	}
+	*brand = 0;
+	*slay = 0;
+	*mult = 1;
 
 	/* Brands */
 	for (i = 1; i < z_info->brand_max; i++) {
@@ -354,16 +392,13 @@ void improve_attack_modifier(struct object *obj, const struct monster *mon,
  
 		/* Is the monster is vulnerable? */
 		if (!rf_has(mon->race->flags, b->resist_flag)) {
-			int mult = OPT(player, birth_percent_damage) ?
+			int b_mult = OPT(player, birth_percent_damage) ?
 				b->o_multiplier : b->multiplier;
 
 			/* Record the best multiplier */
-			if (best_mult < mult) {
-				best_mult = mult;
-				*brand_used = i;
-				my_strcpy(verb, b->verb, 20);
-				if (range)
-					my_strcat(verb, "s", 20);
+			if (*mult < b_mult) {
+				*mult = b_mult;
+				*brand = i;
 			}
 			/* Learn about the brand */
 			if (obj) {
@@ -394,19 +429,14 @@ void improve_attack_modifier(struct object *obj, const struct monster *mon,
  
 		/* Is the monster is vulnerable? */
 		if (react_to_specific_slay(s, mon)) {
-			int mult = OPT(player, birth_percent_damage) ?
+			int s_mult = OPT(player, birth_percent_damage) ?
 				s->o_multiplier : s->multiplier;
 
 			/* Record the best multiplier */
-			if (best_mult < mult) {
-				best_mult = mult;
-				*brand_used = 0;
-				*slay_used = i;
-				if (range) {
-					my_strcpy(verb, s->range_verb, 20);
-				} else {
-					my_strcpy(verb, s->melee_verb, 20);
-				}
+			if (*mult < s_mult) {
+				*mult = s_mult;
+				*brand = 0;
+				*slay = i;
 			}
 			/* Learn about the monster */
 			if (monster_is_visible(mon)) {
@@ -424,6 +454,85 @@ void improve_attack_modifier(struct object *obj, const struct monster *mon,
 	}
 }
 
+/**
+ * Extract the multiplier from a given object hitting a given monster.
+ *
+ * \param obj is the object being used to attack
+ * \param mon is the monster being attacked
+ * \param brand_used is the brand that gave the best multiplier, or NULL
+ * \param slay_used is the slay that gave the best multiplier, or NULL
+ * \param verb is the verb used in the attack ("smite", etc)
+ * \param real is whether this is a real attack (where we update lore) or a
+ *  simulation (where we don't)
+ */
+void improve_attack_modifier(struct object *obj, const struct monster *mon,
+							 int *brand_used, int *slay_used, char *verb,
+							 bool range)
+{
+	int i, best_mult = 1;
+	int brand = 0, slay = 0, mult = 1;
+	bool visible = monster_is_visible(mon);
+
+	/* Set the current best multiplier */
+	if (*brand_used) {
+		struct brand *b = &brands[*brand_used];
+		if (!OPT(player, birth_percent_damage)) {
+			best_mult = MAX(best_mult, b->multiplier);
+		} else {
+			best_mult = MAX(best_mult, b->o_multiplier);
+		}
+	} else if (*slay_used) {
+		struct slay *s = &slays[*slay_used];
+		if (!OPT(player, birth_percent_damage)) {
+			best_mult = MAX(best_mult, s->multiplier);
+		} else {
+			best_mult = MAX(best_mult, s->o_multiplier);
+		}
+	}
+
+	/* Look for a remembered answer, or work it out */
+	for (i = 0; slay_cache_on && i < slay_cache_num; i++) {
+		struct slay_cache_entry *entry = &slay_cache[i];
+		if (entry->obj == obj && entry->race == mon->race &&
+			entry->range == range && entry->visible == visible) {
+			brand = entry->brand;
+			slay = entry->slay;
+			mult = entry->mult;
+			break;
+		}
+	}
+	if (!slay_cache_on || i == slay_cache_num) {
+		best_attack_modifier(obj, mon, &brand, &slay, &mult);
+		if (slay_cache_on && slay_cache_num < SLAY_CACHE_SIZE) {
+			struct slay_cache_entry *entry = &slay_cache[slay_cache_num++];
+			entry->obj = obj;
+			entry->race = mon->race;
+			entry->range = range;
+			entry->visible = visible;
+			entry->brand = brand;
+			entry->slay = slay;
+			entry->mult = mult;
+		}
+	}
+
+	/* Use it if it beats what we have */
+	if (best_mult >= mult) return;
+	if (brand) {
+		*brand_used = brand;
+		my_strcpy(verb, brands[brand].verb, 20);
+		if (range)
+			my_strcat(verb, "s", 20);
+	} else {
+		*brand_used = 0;
+		*slay_used = slay;
+		if (range) {
+			my_strcpy(verb, slays[slay].range_verb, 20);
+		} else {
+			my_strcpy(verb, slays[slay].melee_verb, 20);
+		}
+	}
+}
+
 
 /**
  * React to slays which hurt a monster
@@ -31,8 +31,12 @@ bool append_random_brand(bool **current, struct brand **brand);
 bool append_random_slay(bool **current, struct slay **slay);
 int brand_count(bool *brands);
 int slay_count(bool *slays);
+bool react_to_slay_race(const struct slay *slay,
+						const struct monster_race *race);
 bool player_has_temporary_brand(int idx);
 bool player_has_temporary_slay(int idx);
+void slay_cache_begin(void);
+void slay_cache_end(void);
 void improve_attack_modifier(struct object *obj, const struct monster *mon, 
 							 int *brand_used, int *slay_used, char *verb,
 							 bool range);
@@ -17,6 +17,7 @@
  */
 
 #include "angband.h"
+#include "datafile.h"
 #include "cave.h"
 #include "cmd-core.h"
 #include "effects.h"
@@ -41,6 +42,7 @@
 #include "player-spell.h"
 #include "player-util.h"
 #include "randname.h"
+#include "z-names.h"
 #include "z-queue.h"
 
 struct object_base *kb_info;
@@ -273,20 +275,30 @@ void object_flags(const struct object *obj, bitflag flags[OF_SIZE])
  */
 void object_flags_known(const struct object *obj, bitflag flags[OF_SIZE])
 {
-	object_flags(obj, flags);
-	of_inter(flags, obj->known->flags);
+	struct object_knowledge_cache *cache = object_knowledge_cache(obj);
 
-	if (!obj->kind) {
+	if (cache && (cache->have & KNOWN_CACHE_FLAGS)) {
+		of_copy(flags, cache->flags);
 		return;
 	}
 
-	if (object_flavor_is_aware(obj)) {
-		of_union(flags, obj->kind->flags);
+	object_flags(obj, flags);
+	of_inter(flags, obj->known->flags);
+
+	if (obj->kind) {
+		if (object_flavor_is_aware(obj)) {
+			of_union(flags, obj->kind->flags);
+		}
+
+		if (obj->ego && easy_know(obj)) {
+			of_union(flags, obj->ego->flags);
+			of_diff(flags, obj->ego->flags_off);
+		}
 	}
 
-	if (obj->ego && easy_know(obj)) {
-		of_union(flags, obj->ego->flags);
-		of_diff(flags, obj->ego->flags_off);
+	if (cache) {
+		of_copy(cache->flags, flags);
+		cache->have |= KNOWN_CACHE_FLAGS;
 	}
 }
 
@@ -359,18 +371,72 @@ unsigned check_for_inscrip(const struct object *obj, const char *inscrip)
 /*** Object kind lookup functions ***/
 
 /**
- * Return the object kind with the given `tval` and `sval`, or NULL.
+ * Object kind indices by tval and sval name (ignoring case), and by tval and
+ * sval; made when the first kind is looked for, and again if more kinds
+ * have been added since (as books and artifacts add them while parsing)
  */
-struct object_kind *lookup_kind(int tval, int sval)
+static struct name_table *kind_names;
+static int *kind_svals;
+static int kind_sval_max;
+static int kinds_indexed;
+
+static void kind_names_free(void)
+{
+	name_table_free(kind_names);
+	kind_names = NULL;
+	mem_free(kind_svals);
+	kind_svals = NULL;
+	kind_sval_max = 0;
+	kinds_indexed = 0;
+}
+
+static void index_kinds(void)
 {
 	int k;
 
-	/* Look for it */
+	kind_names_free();
+	for (k = 0; k < z_info->k_max; k++)
+		kind_sval_max = MAX(kind_sval_max, k_info[k].sval);
+	kind_svals = mem_alloc(TV_MAX * (kind_sval_max + 1) * sizeof(int));
+	for (k = 0; k < TV_MAX * (kind_sval_max + 1); k++)
+		kind_svals[k] = -1;
+	kind_names = name_table_new(z_info->k_max, true);
+
 	for (k = 0; k < z_info->k_max; k++) {
 		struct object_kind *kind = &k_info[k];
-		if (kind->tval == tval && kind->sval == sval)
-			return kind;
+		int *slot;
+
+		if (kind->tval < 0 || kind->tval >= TV_MAX || kind->sval < 0)
+			continue;
+		slot = &kind_svals[kind->tval * (kind_sval_max + 1) + kind->sval];
+		if (*slot < 0)
+			*slot = k;
+
+		if (kind->name) {
+			char name[1024];
+
+			obj_desc_name_format(name, sizeof name, 0, kind->name, 0, false);
+			name_table_add(kind_names, name, kind->tval, k);
+		}
 	}
+	kinds_indexed = z_info->k_max;
+}
+
+/**
+ * Return the object kind with the given `tval` and `sval`, or NULL.
+ */
+struct object_kind *lookup_kind(int tval, int sval)
+{
+	int k = -1;
+
+	if (kinds_indexed != z_info->k_max)
+		index_kinds();
+
+	/* Look for it */
+	if (tval >= 0 && tval < TV_MAX && sval >= 0 && sval <= kind_sval_max)
+		k = kind_svals[tval * (kind_sval_max + 1) + sval];
+	if (k >= 0)
+		return &k_info[k];
 
 	/* Failure */
 	msg("No object: %d:%d (%s)", tval, sval, tval_find_name(tval));
@@ -384,32 +450,82 @@ struct object_kind *objkind_byid(int kidx) {
 }
 
 
+/**
+ * Return the description of an object kind, reading it from its data file
+ * the first time it is asked for
+ */
+const char *object_kind_text(const struct object_kind *kind)
+{
+	if (!kind->text && kind->text_mark.path)
+		((struct object_kind *)kind)->text = parse_file_desc(&kind->text_mark);
+	return kind->text;
+}
+
+/**
+ * Return the description of an artifact, reading it from its data file
+ * the first time it is asked for
+ */
+const char *artifact_text(const struct artifact *art)
+{
+	if (!art->text && art->text_mark.path)
+		((struct artifact *)art)->text = parse_file_desc(&art->text_mark);
+	return art->text;
+}
+
+
 /*** Textual<->numeric conversion ***/
 
 /**
- * Return the a_idx of the artifact with the given name
+ * Artifact indices by name, made when the first is looked for
+ */
+static struct name_table *artifact_names;
+
+/**
+ * Return the artifact with the given name, or NULL
  */
 struct artifact *lookup_artifact_name(const char *name)
 {
 	int i;
-	int a_idx = -1;
 
-	/* Look for it */
-	for (i = 0; i < z_info->a_max; i++) {
-		struct artifact *art = &a_info[i];
-
-		/* Test for equality */
-		if (art->name && streq(name, art->name))
-			return art;
-		
-		/* Test for close matches */
-		if (strlen(name) >= 3 && art->name && my_stristr(art->name, name)
-			&& a_idx == -1)
-			a_idx = i;
+	if (!artifact_names) {
+		artifact_names = name_table_new(z_info->a_max, false);
+		for (i = 0; i < z_info->a_max; i++)
+			if (a_info[i].name)
+				name_table_add(artifact_names, a_info[i].name, 0, i);
+	}
+
+	i = name_table_find(artifact_names, name, 0);
+	return i >= 0 ? &a_info[i] : NULL;
+}
+
+/**
+ * Return the artifact with the given name, or if there is none the first
+ * with the given name as a (case-insensitive) substring of at least three
+ * letters; for names typed in by the player.
+ */
+struct artifact *lookup_closest_artifact(const char *name)
+{
+	struct artifact *art = lookup_artifact_name(name);
+	int i;
+
+	for (i = 0; !art && strlen(name) >= 3 && i < z_info->a_max; i++) {
+		if (a_info[i].name && my_stristr(a_info[i].name, name))
+			art = &a_info[i];
 	}
 
-	/* Return our best match */
-	return a_idx > 0 ? &a_info[a_idx] : NULL;
+	/* The first entry isn't an artifact */
+	return art && art != &a_info[0] ? art : NULL;
+}
+
+/**
+ * Forget the object kind and artifact names, when k_info or a_info is freed
+ * or artifacts are renamed
+ */
+void object_names_free(void)
+{
+	kind_names_free();
+	name_table_free(artifact_names);
+	artifact_names = NULL;
 }
 
 /**
@@ -456,22 +572,12 @@ int lookup_sval(int tval, const char *name)
 	if (sscanf(name, "%u", &r) == 1)
 		return r;
 
-	/* Look for it */
-	for (k = 0; k < z_info->k_max; k++) {
-		struct object_kind *kind = &k_info[k];
-		char cmp_name[1024];
-
-		if (!kind || !kind->name) continue;
+	if (kinds_indexed != z_info->k_max)
+		index_kinds();
 
-		obj_desc_name_format(cmp_name, sizeof cmp_name, 0, kind->name, 0,
-							 false);
-
-		/* Found a match */
-		if (kind->tval == tval && !my_stricmp(cmp_name, name))
-			return kind->sval;
-	}
-
-	return -1;
+	/* Look for it */
+	k = name_table_find(kind_names, name, tval);
+	return k >= 0 ? k_info[k].sval : -1;
 }
 
 void object_short_name(char *buf, size_t max, const char *name)
@@ -679,8 +785,8 @@ bool obj_has_flag(const struct object *obj, int flag)
 	/* Check any curse object flags */
 	if (c) {
 		int i;
-		for (i = 1; i < z_info->curse_max; i++) {
-			if (c[i].power && of_has(curses[i].obj->flags, flag)) {
+		for (i = 0; i < obj->num_curses; i++) {
+			if (c[i].power && of_has(curses[c[i].index].obj->flags, flag)) {
 				return true;
 			}
 		}
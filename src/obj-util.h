@@ -35,7 +35,11 @@ bool is_unknown(const struct object *obj);
 unsigned check_for_inscrip(const struct object *obj, const char *inscrip);
 struct object_kind *lookup_kind(int tval, int sval);
 struct object_kind *objkind_byid(int kidx);
+const char *object_kind_text(const struct object_kind *kind);
+const char *artifact_text(const struct artifact *art);
 struct artifact *lookup_artifact_name(const char *name);
+struct artifact *lookup_closest_artifact(const char *name);
+void object_names_free(void);
 struct ego_item *lookup_ego_item(const char *name, int tval, int sval);
 int lookup_sval(int tval, const char *name);
 void object_short_name(char *buf, size_t max, const char *name);
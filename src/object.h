@@ -9,6 +9,7 @@
 #include "z-quark.h"
 #include "z-bitflag.h"
 #include "z-dice.h"
+#include "z-file.h"
 #include "obj-properties.h"
 
 
@@ -165,6 +166,7 @@ extern struct object_base *kb_info;
 struct object_kind {
 	char *name;
 	char *text;
+	struct file_mark text_mark;	/**< Where text is read from when needed */
 
 	struct object_base *base;
 
@@ -246,6 +248,7 @@ extern struct object_kind *curse_object_kind;
 struct artifact {
 	char *name;
 	char *text;
+	struct file_mark text_mark;	/**< Where text is read from when needed */
 
 	u32b aidx;
 
@@ -367,11 +370,35 @@ enum {
 	OBJ_NOTICE_IMAGINED = 0x08,
 };
 
+/**
+ * One curse on an object; an object's curses are a short array of these in
+ * order of curse index, with room for no more than it has
+ */
 struct curse_data {
+	int index;
 	int power;
 	int timeout;
 };
 
+/**
+ * Answers about what the player knows of an object, remembered during a
+ * knowledge cache pass (see object_knowledge_cache_begin())
+ */
+struct object_knowledge_cache {
+	u32b stamp;					/**< Pass the answers belong to */
+	byte have;					/**< Answers filled in (KNOWN_CACHE_*) */
+	bool runes_known;			/**< object_runes_known() */
+	bool fully_known;			/**< object_fully_known() */
+	bitflag flags[OF_SIZE];		/**< object_flags_known() */
+	bool ignored;				/**< object_is_ignored() */
+	u32b ignore_generation;		/**< Ignore settings the answer used */
+};
+
+#define KNOWN_CACHE_RUNES	0x01
+#define KNOWN_CACHE_FULLY	0x02
+#define KNOWN_CACHE_FLAGS	0x04
+#define KNOWN_CACHE_IGNORED	0x08
+
 /**
  * Object information, for a specific object.
  *
@@ -430,7 +457,8 @@ struct object {
 	struct element_info el_info[ELEM_MAX];	/**< Object element info */
 	bool *brands;			/**< Array of brand structures */
 	bool *slays;			/**< Array of slay structures */
-	struct curse_data *curses;	/**< Array of curse powers and timeouts */
+	struct curse_data *curses;	/**< Curses, num_curses of them */
+	byte num_curses;		/**< Number of curses */
 
 	struct effect *effect;	/**< Effect this item produces (effects.c) */
 	char *effect_msg;		/**< Message on use */
@@ -449,6 +477,8 @@ struct object {
 	struct monster_race *origin_race;	/**< Monster race that dropped it */
 
 	quark_t note; 			/**< Inscription index */
+
+	struct object_knowledge_cache known_cache;	/**< Remembered knowledge */
 };
 
 /**
@@ -479,6 +509,7 @@ static struct object const OBJECT_NULL = {
 	.brands = NULL,
 	.slays = NULL,
 	.curses = NULL,
+	.num_curses = 0,
 	.effect = NULL,
 	.effect_msg = NULL,
 	.activation = NULL,
@@ -492,6 +523,7 @@ static struct object const OBJECT_NULL = {
 	.origin_depth = 0,
 	.origin_race = NULL,
 	.note = 0,
+	.known_cache = { 0, 0, false, false, { 0 } },
 };
 
 struct flavor
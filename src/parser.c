@@ -65,6 +65,7 @@ struct parser_value {
 
 struct parser_hook {
 	struct parser_hook *next;
+	u32b hash;
 	enum parser_error (*func)(struct parser *p);
 	char *dir;
 	struct parser_spec *fhead;
@@ -77,8 +78,13 @@ struct parser {
 	unsigned int colno;
 	char errmsg[1024];
 	struct parser_hook *hooks;
-	struct parser_value *fhead;
-	struct parser_value *ftail;
+	struct parser_hook **htable;	/* Hooks by directive, open addressed */
+	size_t htable_size;
+	size_t nhooks;
+	struct parser_value *values;	/* Values for the current line */
+	unsigned int nvalues;
+	unsigned int avalues;
+	unsigned int lastval;			/* Where the last value lookup ended */
 	void *priv;
 };
 
@@ -90,26 +96,62 @@ struct parser *parser_new(void) {
 	return p;
 }
 
-static struct parser_hook *findhook(struct parser *p, const char *dir) {
-	struct parser_hook *h = p->hooks;
-	while (h) {
-		if (!strcmp(h->dir, dir))
+/**
+ * Finds the slot in the hook table for directive `dir`; the slot is either
+ * empty or holds the hook for that directive.
+ */
+static size_t hookslot(struct parser *p, const char *dir, u32b hash) {
+	size_t mask = p->htable_size - 1;
+	size_t i = hash & mask;
+	while (p->htable[i]) {
+		if (p->htable[i]->hash == hash && !strcmp(p->htable[i]->dir, dir))
 			break;
-		h = h->next;
+		i = (i + 1) & mask;
 	}
-	return h;
+	return i;
+}
+
+static struct parser_hook *findhook(struct parser *p, const char *dir) {
+	if (!p->htable_size)
+		return NULL;
+	return p->htable[hookslot(p, dir, djb2_hash(dir))];
+}
+
+/**
+ * Adds a hook to the hook table, superseding any with the same directive.
+ */
+static void addhook(struct parser *p, struct parser_hook *h) {
+	size_t i;
+
+	/* Keep the table at most half full */
+	if (2 * (p->nhooks + 1) > p->htable_size) {
+		struct parser_hook **old = p->htable;
+		size_t old_size = p->htable_size;
+
+		p->htable_size = old_size ? old_size * 2 : 32;
+		p->htable = mem_zalloc(p->htable_size * sizeof(*p->htable));
+		for (i = 0; i < old_size; i++) {
+			if (old[i])
+				p->htable[hookslot(p, old[i]->dir, old[i]->hash)] = old[i];
+		}
+		mem_free(old);
+	}
+
+	i = hookslot(p, h->dir, h->hash);
+	if (!p->htable[i])
+		p->nhooks++;
+	p->htable[i] = h;
 }
 
 static void parser_freeold(struct parser *p) {
-	struct parser_value *v;
-	while (p->fhead) {
-		int t = p->fhead->spec.type & ~PARSE_T_OPT;
-		v = (struct parser_value *)p->fhead->spec.next;
+	unsigned int i;
+	for (i = 0; i < p->nvalues; i++) {
+		int t = p->values[i].spec.type & ~PARSE_T_OPT;
 		if (t == PARSE_T_SYM || t == PARSE_T_STR)
-			mem_free(p->fhead->u.sval);
-		mem_free(p->fhead);
-		p->fhead = v;
+			mem_free(p->values[i].u.sval);
 	}
+	p->nvalues = 0;
+	p->lastval = 0;
 }
 
 static bool parse_random(const char *str, random_value *bonus) {
@@ -217,8 +259,6 @@ enum parser_error parser_parse(struct parser *p, const char *line) {
 
 	p->lineno++;
 	p->colno = 1;
-	p->fhead = NULL;
-	p->ftail = NULL;
 
 	/* Ignore empty lines and comments. */
 	while (*line && (isspace(*line)))
@@ -275,8 +315,13 @@ enum parser_error parser_parse(struct parser *p, const char *line) {
 			break;
 		}
 
-		/* Allocate a value node. */
-		v = mem_alloc(sizeof *v);
+		/* Take the next value slot. */
+		if (p->nvalues == p->avalues) {
+			p->avalues = p->avalues ? p->avalues * 2 : 8;
+			p->values = mem_realloc(p->values,
+				p->avalues * sizeof(*p->values));
+		}
+		v = &p->values[p->nvalues];
 		v->spec.next = NULL;
 		v->spec.type = s->type;
 		v->spec.name = s->name;
@@ -286,7 +331,6 @@ enum parser_error parser_parse(struct parser *p, const char *line) {
 			char *z = NULL;
 			v->u.ival = strtol(tok, &z, 0);
 			if (z == tok) {
-				mem_free(v);
 				mem_free(cline);
 				my_strcpy(p->errmsg, s->name, sizeof(p->errmsg));
 				p->error = PARSE_ERROR_NOT_NUMBER;
@@ -296,7 +340,6 @@ enum parser_error parser_parse(struct parser *p, const char *line) {
 			char *z = NULL;
 			v->u.uval = strtoul(tok, &z, 0);
 			if (z == tok || *tok == '-') {
-				mem_free(v);
 				mem_free(cline);
 				my_strcpy(p->errmsg, s->name, sizeof(p->errmsg));
 				p->error = PARSE_ERROR_NOT_NUMBER;
@@ -308,7 +351,6 @@ enum parser_error parser_parse(struct parser *p, const char *line) {
 			v->u.sval = string_make(tok);
 		} else if (t == PARSE_T_RAND) {
 			if (!parse_random(tok, &v->u.rval)) {
-				mem_free(v);
 				mem_free(cline);
 				my_strcpy(p->errmsg, s->name, sizeof(p->errmsg));
 				p->error = PARSE_ERROR_NOT_RANDOM;
@@ -316,12 +358,8 @@ enum parser_error parser_parse(struct parser *p, const char *line) {
 			}
 		}
 
-		/* Link it into the value list. */
-		if (!p->fhead)
-			p->fhead = v;
-		else
-			p->ftail->spec.next = &v->spec;
-		p->ftail = v;
+		/* Keep it. */
+		p->nvalues++;
 	}
 
 	mem_free(cline);
@@ -384,6 +422,8 @@ static void clean_specs(struct parser_hook *h) {
 void parser_destroy(struct parser *p) {
 	struct parser_hook *h;
 	parser_freeold(p);
+	mem_free(p->values);
+	mem_free(p->htable);
 	while (p->hooks) {
 		h = p->hooks->next;
 		clean_specs(p->hooks);
@@ -487,7 +527,9 @@ errr parser_reg(struct parser *p, const char *fmt,
 		return r;
 	}
 
+	h->hash = djb2_hash(h->dir);
 	p->hooks = h;
+	addhook(p, h);
 	mem_free(cfmt);
 	return 0;
 }
@@ -504,22 +546,29 @@ enum parser_error ignored(struct parser *p) {
  *
  * Used to test for presence of optional values.
  */
-bool parser_hasval(struct parser *p, const char *name) {
-	struct parser_value *v;
-	for (v = p->fhead; v; v = (struct parser_value *)v->spec.next) {
-		if (!strcmp(v->spec.name, name))
-			return true;
+static struct parser_value *findval(struct parser *p, const char *name) {
+	unsigned int i, n;
+
+	/* Handlers mostly read values in order, so start after the last one */
+	for (n = 0, i = p->lastval; n < p->nvalues; n++, i++) {
+		if (i >= p->nvalues)
+			i = 0;
+		if (!strcmp(p->values[i].spec.name, name)) {
+			p->lastval = i + 1;
+			return &p->values[i];
+		}
 	}
-	return false;
+	return NULL;
+}
+
+bool parser_hasval(struct parser *p, const char *name) {
+	return findval(p, name) ? true : false;
 }
 
 static struct parser_value *parser_getval(struct parser *p, const char *name) {
-	struct parser_value *v;
-	for (v = p->fhead; v; v = (struct parser_value *)v->spec.next) {
-		if (!strcmp(v->spec.name, name)) {
-			return v;
-		}
-	}
+	struct parser_value *v = findval(p, name);
+	if (v)
+		return v;
 	quit_fmt("parser_getval error: name is %s\n", name);
 	return 0; /* Needed to avoid Windows compiler warning */
 }
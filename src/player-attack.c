@@ -992,6 +992,7 @@ void py_attack(struct player *p, struct loc grid)
 
 	/* Attack until energy runs out or enemy dies. We limit energy use to 100
 	 * to avoid giving monsters a possible double move. */
+	slay_cache_begin();
 	while (p->energy >= blow_energy * (blows + 1)) {
 		bool stop = py_attack_real(player, grid, &fear);
 		p->upkeep->energy_use += blow_energy;
@@ -999,6 +1000,7 @@ void py_attack(struct player *p, struct loc grid)
 			stop) break;
 		blows++;
 	}
+	slay_cache_end();
 
 	/* Hack - delay fear messages */
 	if (fear && monster_is_visible(mon)) {
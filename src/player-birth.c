@@ -405,12 +405,8 @@ void player_init(struct player *p)
 	}
 	if (p->timed)
 		mem_free(p->timed);
-	if (p->obj_k) {
-		mem_free(p->obj_k->brands);
-		mem_free(p->obj_k->slays);
-		mem_free(p->obj_k->curses);
-		mem_free(p->obj_k);
-	}
+	if (p->obj_k)
+		object_free(p->obj_k);
 	if (p->history) {
 		string_free(p->history);
 	}
@@ -454,11 +450,9 @@ void player_init(struct player *p)
 	p->upkeep->quiver = mem_zalloc(z_info->quiver_size *
 								   sizeof(struct object *));
 	p->timed = mem_zalloc(TMD_MAX * sizeof(s16b));
-	p->obj_k = mem_zalloc(sizeof(struct object));
+	p->obj_k = object_new();
 	p->obj_k->brands = mem_zalloc(z_info->brand_max * sizeof(bool));
 	p->obj_k->slays = mem_zalloc(z_info->slay_max * sizeof(bool));
-	p->obj_k->curses = mem_zalloc(z_info->curse_max *
-								  sizeof(struct curse_data));
 
 	/* Options should persist */
 	p->opts = opts_save;
@@ -22,6 +22,7 @@
 #include "cave.h"
 #include "game-event.h"
 #include "game-input.h"
+#include "game-profile.h"
 #include "game-world.h"
 #include "init.h"
 #include "mon-msg.h"
@@ -1008,20 +1009,65 @@ int equipped_item_slot(struct player_body body, struct object *item)
 	return i;
 }
 
+/**
+ * A gear object and its place in the gear list, for sorting
+ */
+struct gear_order {
+	struct object *obj;
+	int idx;
+};
+
+/**
+ * Compare gear objects by earlier_object(), keeping gear list order for
+ * objects neither of which comes first
+ */
+static int cmp_gear_order(const void *a, const void *b)
+{
+	const struct gear_order *pa = a;
+	const struct gear_order *pb = b;
+
+	if (earlier_object(pa->obj, pb->obj, false)) return 1;
+	if (earlier_object(pb->obj, pa->obj, false)) return -1;
+	return pa->idx - pb->idx;
+}
+
+/**
+ * Check whether an object is in a list of objects
+ */
+static bool in_list(struct object **list, int n, const struct object *obj)
+{
+	int i;
+
+	for (i = 0; i < n; i++)
+		if (list[i] == obj) return true;
+
+	return false;
+}
+
 /**
  * Put the player's inventory and quiver into easily accessible arrays.  The
  * pack may be overfull by one item
+ *
+ * Rather than picking the first remaining object for each slot in turn,
+ * the candidates are sorted once; earlier_object() orders by a fixed list
+ * of keys, so the result is the same.
  */
 void calc_inventory(struct player_upkeep *upkeep, struct object *gear,
 					struct player_body body)
 {
-	int i;
+	int i, j, num;
 	int old_inven_cnt = upkeep->inven_cnt;
+	struct object *current;
+	struct gear_order *order;
 	struct object **old_quiver = mem_zalloc(z_info->quiver_size *
 												sizeof(struct object *));
 	struct object **old_pack = mem_zalloc(z_info->pack_size *
 											  sizeof(struct object *));
 
+	/* Room to sort the whole gear list */
+	for (num = 0, current = gear; current; current = current->next) num++;
+	order = mem_zalloc(MAX(num, 1) * sizeof(*order));
+
 	/* Prepare to fill the quiver */
 	upkeep->quiver_cnt = 0;
 
@@ -1034,8 +1080,6 @@ void calc_inventory(struct player_upkeep *upkeep, struct object *gear,
 
 	/* First, allocate inscribed items */
 	for (i = 0; i < z_info->quiver_size; i++) {
-		struct object *current;
-
 		/* Start with an empty slot */
 		upkeep->quiver[i] = NULL;
 
@@ -1067,38 +1111,29 @@ void calc_inventory(struct player_upkeep *upkeep, struct object *gear,
 	}
 
 	/* Now fill the rest of the slots in order */
-	for (i = 0; i < z_info->quiver_size; i++) {
-		struct object *current, *first = NULL;
-		int j;
-
-		/* If the slot is full, move on */
-		if (upkeep->quiver[i]) continue;
-
-		/* Find the first quiver object not yet allocated */
-		for (current = gear; current; current = current->next) {
-			bool already = false;
-
-			/* Ignore non-ammo */
-			if (!tval_is_ammo(current)) continue;
+	num = 0;
+	for (current = gear; current; current = current->next) {
+		/* Ignore non-ammo */
+		if (!tval_is_ammo(current)) continue;
 
-			/* Ignore stuff already quivered */
-			for (j = 0; j < z_info->quiver_size; j++)
-				if (upkeep->quiver[j] == current)
-					already = true;
-			if (already) continue;
+		/* Ignore stuff already quivered */
+		if (in_list(upkeep->quiver, z_info->quiver_size, current)) continue;
 
-			/* Choose the first in order */
-			if (earlier_object(first, current, false)) {
-				first = current;
-			}
-		}
+		order[num].obj = current;
+		order[num].idx = num;
+		num++;
+	}
+	sort(order, num, sizeof(*order), cmp_gear_order);
+	for (i = 0, j = 0; i < z_info->quiver_size && j < num; i++) {
+		struct object *first = order[j].obj;
 
-		/* Stop looking if there's nothing left */
-		if (!first) break;
+		/* If the slot is full, move on */
+		if (upkeep->quiver[i]) continue;
 
 		/* If we have an item, slot it */
 		upkeep->quiver[i] = first;
 		upkeep->quiver_cnt += first->number;
+		j++;
 
 		/* In the quiver counts as worn */
 		object_learn_on_wield(player, first);
@@ -1119,37 +1154,22 @@ void calc_inventory(struct player_upkeep *upkeep, struct object *gear,
 	/* Prepare to fill the inventory */
 	upkeep->inven_cnt = 0;
 
-	for (i = 0; i <= z_info->pack_size; i++) {
-		struct object *current, *first = NULL;
-		for (current = gear; current; current = current->next) {
-			bool possible = true;
-			int j;
-
-			/* Skip equipment */
-			if (object_is_equipped(body, current))
-				possible = false;
-
-			/* Skip quivered objects */
-			for (j = 0; j < z_info->quiver_size; j++)
-				if (upkeep->quiver[j] == current)
-					possible = false;
-
-			/* Skip objects already allocated to the inventory */
-			for (j = 0; j < upkeep->inven_cnt; j++)
-				if (upkeep->inven[j] == current)
-					possible = false;
-
-			/* If still possible, choose the first in order */
-			if (!possible)
-				continue;
-			else if (earlier_object(first, current, false)) {
-				first = current;
-			}
-		}
+	/* Put everything not worn or quivered in order */
+	num = 0;
+	for (current = gear; current; current = current->next) {
+		if (object_is_equipped(body, current)) continue;
+		if (in_list(upkeep->quiver, z_info->quiver_size, current)) continue;
+
+		order[num].obj = current;
+		order[num].idx = num;
+		num++;
+	}
+	sort(order, num, sizeof(*order), cmp_gear_order);
 
-		/* Allocate */
-		upkeep->inven[i] = first;
-		if (first)
+	/* Allocate */
+	for (i = 0; i <= z_info->pack_size; i++) {
+		upkeep->inven[i] = (i < num) ? order[i].obj : NULL;
+		if (upkeep->inven[i])
 			upkeep->inven_cnt++;
 	}
 
@@ -1162,6 +1182,7 @@ void calc_inventory(struct player_upkeep *upkeep, struct object *gear,
 				break;
 			}
 
+	mem_free(order);
 	mem_free(old_quiver);
 	mem_free(old_pack);
 }
@@ -1643,6 +1664,32 @@ int calc_blows(struct player *p, const struct object *obj,
 }
 
 
+/**
+ * Calculate the blows a player would get with other STR and DEX indexes.
+ *
+ * \param weapon is the wielded weapon, or NULL
+ * \param state is the state calc_bonuses() worked out with that weapon
+ * \param str_ind is the STR index to calculate blows at
+ * \param dex_ind is the DEX index to calculate blows at
+ *
+ * This gives the same blows as calc_bonuses() would at those indexes, without
+ * going through the rest of the player's state.
+ */
+int calc_blows_at(struct player *p, const struct object *weapon,
+				  const struct player_state *state, int str_ind, int dex_ind)
+{
+	struct player_state hypo;
+
+	/* Too heavy to get more than the default blow */
+	if (weapon && adj_str_hold[str_ind] < weapon->weight / 10)
+		return 100;
+
+	memcpy(&hypo, state, sizeof(hypo));
+	hypo.stat_ind[STAT_STR] = str_ind;
+	hypo.stat_ind[STAT_DEX] = dex_ind;
+	return calc_blows(p, weapon, &hypo, state->extra_blows);
+}
+
 /**
  * Computes current weight limit.
  */
@@ -1743,47 +1790,24 @@ static void calc_shapechange(struct player_state *state,
 }
 
 /**
- * Calculate the players current "state", taking into account
- * not only race/class intrinsics, but also objects being worn
- * and temporary spell effects.
- *
- * See also calc_mana() and calc_hitpoints().
- *
- * Take note of the new "speed code", in particular, a very strong
- * player will start slowing down as soon as he reaches 150 pounds,
- * but not until he reaches 450 pounds will he be half as fast as
- * a normal kobold.  This both hurts and helps the player, hurts
- * because in the old days a player could just avoid 300 pounds,
- * and helps because now carrying 300 pounds is not very painful.
- *
- * The "weapon" and "bow" do *not* add to the bonuses to hit or to
- * damage, since that would affect non-combat things.  These values
- * are actually added in later, at the appropriate place.
+ * Calculate the part of the player state that comes from race, class and
+ * equipment, ready for calc_bonuses() to add shapechanges, stats, timed
+ * effects and so on.
  *
- * If known_only is true, calc_bonuses() will only use the known
- * information of objects; thus it returns what the player _knows_
- * the character state to be.
+ * If known_only is true, only the known information about objects is used.
  */
-void calc_bonuses(struct player *p, struct player_state *state, bool known_only,
-				  bool update)
+static void calc_equipment_layer(struct player *p,
+								 struct player_bonus_layer *layer,
+								 bool known_only)
 {
-	int i, j, hold;
-	int extra_blows = 0;
-	int extra_shots = 0;
-	int extra_might = 0;
-	int extra_moves = 0;
-	struct object *launcher = equipped_item_by_slot_name(p, "shooting");
-	struct object *weapon = equipped_item_by_slot_name(p, "weapon");
+	struct player_state *state = &layer->state;
+	int i, j;
 	bitflag f[OF_SIZE];
 	bitflag collect_f[OF_SIZE];
 	bool vuln[ELEM_MAX];
 
-	/* Hack to allow calculating hypothetical blows for extra STR, DEX - NRM */
-	int str_ind = state->stat_ind[STAT_STR];
-	int dex_ind = state->stat_ind[STAT_DEX];
-
 	/* Reset */
-	memset(state, 0, sizeof *state);
+	memset(layer, 0, sizeof(*layer));
 
 	/* Set various defaults */
 	state->speed = 110;
@@ -1813,9 +1837,10 @@ void calc_bonuses(struct player *p, struct player_state *state, bool known_only,
 
 	/* Analyze equipment */
 	for (i = 0; i < p->body.count; i++) {
-		int index = 0;
+		int index = -1;
 		struct object *obj = slot_object(p, i);
 		struct curse_data *curse = obj ? obj->curses : NULL;
+		int num_curses = obj ? obj->num_curses : 0;
 
 		while (obj) {
 			int dig = 0;
@@ -1861,13 +1886,13 @@ void calc_bonuses(struct player *p, struct player_state *state, bool known_only,
 				* p->obj_k->modifiers[OBJ_MOD_SPEED];
 			state->dam_red += obj->modifiers[OBJ_MOD_DAM_RED]
 				* p->obj_k->modifiers[OBJ_MOD_DAM_RED];
-			extra_blows += obj->modifiers[OBJ_MOD_BLOWS]
+			layer->extra_blows += obj->modifiers[OBJ_MOD_BLOWS]
 				* p->obj_k->modifiers[OBJ_MOD_BLOWS];
-			extra_shots += obj->modifiers[OBJ_MOD_SHOTS]
+			layer->extra_shots += obj->modifiers[OBJ_MOD_SHOTS]
 				* p->obj_k->modifiers[OBJ_MOD_SHOTS];
-			extra_might += obj->modifiers[OBJ_MOD_MIGHT]
+			layer->extra_might += obj->modifiers[OBJ_MOD_MIGHT]
 				* p->obj_k->modifiers[OBJ_MOD_MIGHT];
-			extra_moves += obj->modifiers[OBJ_MOD_MOVES]
+			layer->extra_moves += obj->modifiers[OBJ_MOD_MOVES]
 				* p->obj_k->modifiers[OBJ_MOD_MOVES];
 
 			/* Apply element info, noting vulnerabilites for later processing */
@@ -1899,9 +1924,9 @@ void calc_bonuses(struct player *p, struct player_state *state, bool known_only,
 			if (curse) {
 				index++;
 				obj = NULL;
-				while (index < z_info->curse_max) {
+				while (index < num_curses) {
 					if (curse[index].power) {
-						obj = curses[index].obj;
+						obj = curses[curse[index].index].obj;
 						break;
 					} else {
 						index++;
@@ -1921,6 +1946,60 @@ void calc_bonuses(struct player *p, struct player_state *state, bool known_only,
 		if (vuln[i] && (state->el_info[i].res_level < 3))
 			state->el_info[i].res_level--;
 	}
+}
+
+/**
+ * Calculate the players current "state", taking into account
+ * not only race/class intrinsics, but also objects being worn
+ * and temporary spell effects.
+ *
+ * See also calc_mana() and calc_hitpoints().
+ *
+ * Take note of the new "speed code", in particular, a very strong
+ * player will start slowing down as soon as he reaches 150 pounds,
+ * but not until he reaches 450 pounds will he be half as fast as
+ * a normal kobold.  This both hurts and helps the player, hurts
+ * because in the old days a player could just avoid 300 pounds,
+ * and helps because now carrying 300 pounds is not very painful.
+ *
+ * The "weapon" and "bow" do *not* add to the bonuses to hit or to
+ * damage, since that would affect non-combat things.  These values
+ * are actually added in later, at the appropriate place.
+ *
+ * If known_only is true, calc_bonuses() will only use the known
+ * information of objects; thus it returns what the player _knows_
+ * the character state to be.
+ */
+void calc_bonuses(struct player *p, struct player_state *state, bool known_only,
+				  bool update)
+{
+	int i, j, hold;
+	int extra_blows, extra_shots, extra_might, extra_moves;
+	struct object *launcher = equipped_item_by_slot_name(p, "shooting");
+	struct object *weapon = equipped_item_by_slot_name(p, "weapon");
+	struct player_bonus_layer scratch, *layer;
+
+	/* Hack to allow calculating hypothetical blows for extra STR, DEX - NRM */
+	int str_ind = state->stat_ind[STAT_STR];
+	int dex_ind = state->stat_ind[STAT_DEX];
+
+	/* Start from race, class and equipment, reusing them where we can */
+	if (update) {
+		layer = &p->upkeep->bonus_layer[known_only ? 1 : 0];
+		if (!layer->valid) {
+			calc_equipment_layer(p, layer, known_only);
+			layer->valid = true;
+		}
+	} else {
+		/* Hypothetical equipment, so work it out afresh */
+		layer = &scratch;
+		calc_equipment_layer(p, layer, known_only);
+	}
+	memcpy(state, &layer->state, sizeof(*state));
+	extra_blows = layer->extra_blows;
+	extra_shots = layer->extra_shots;
+	extra_might = layer->extra_might;
+	extra_moves = layer->extra_moves;
 
 	/* Add shapechange info */
 	calc_shapechange(state, p->shape, &extra_blows, &extra_shots, &extra_might,
@@ -2199,6 +2278,7 @@ void calc_bonuses(struct player *p, struct player_state *state, bool known_only,
 
 
 	/* Analyze weapon */
+	state->extra_blows = extra_blows;
 	state->heavy_wield = false;
 	state->bless_wield = false;
 	if (weapon) {
@@ -2238,14 +2318,21 @@ void calc_bonuses(struct player *p, struct player_state *state, bool known_only,
 
 /**
  * Calculate bonuses, and print various things on changes.
+ *
+ * Race, class and equipment are only looked at again if `equipment` is set;
+ * otherwise only timed effects are assumed to have changed.
  */
-static void update_bonuses(struct player *p)
+static void update_bonuses(struct player *p, bool equipment)
 {
 	int i;
 
 	struct player_state state = p->state;
 	struct player_state known_state = p->known_state;
 
+	if (equipment) {
+		p->upkeep->bonus_layer[0].valid = false;
+		p->upkeep->bonus_layer[1].valid = false;
+	}
 
 	/* ------------------------------------
 	 * Calculate bonuses
@@ -2442,6 +2529,9 @@ void notice_stuff(struct player *p)
 	/* Deal with ignore stuff */
 	if (p->upkeep->notice & PN_IGNORE) {
 		p->upkeep->notice &= ~(PN_IGNORE);
+
+		/* An inscription or ignore mark may have changed what is ignored */
+		ignore_settings_changed();
 		ignore_drop();
 	}
 
@@ -2474,9 +2564,11 @@ void update_stuff(struct player *p)
 		update_inventory(p);
 	}
 
-	if (p->upkeep->update & (PU_BONUS)) {
-		p->upkeep->update &= ~(PU_BONUS);
-		update_bonuses(p);
+	if (p->upkeep->update & (PU_BONUS | PU_TIMED)) {
+		bool equipment = (p->upkeep->update & (PU_BONUS)) ? true : false;
+		p->upkeep->update &= ~(PU_BONUS | PU_TIMED);
+		update_bonuses(p, equipment);
+		p->upkeep->spell_stamp++;
 	}
 
 	if (p->upkeep->update & (PU_TORCH)) {
@@ -2499,6 +2591,7 @@ void update_stuff(struct player *p)
 		if (p->class->magic.total_spells > 0) {
 			calc_spells(p);
 		}
+		p->upkeep->spell_stamp++;
 	}
 
 	/* Character is not ready yet, no map updates */
@@ -2510,19 +2603,27 @@ void update_stuff(struct player *p)
 	if (p->upkeep->update & (PU_UPDATE_VIEW)) {
 		p->upkeep->update &= ~(PU_UPDATE_VIEW);
 		update_view(cave, p);
+
+		/* A new view may reveal or hide anyone */
+		p->upkeep->update |= (PU_MONSTERS);
 	}
 
 	if (p->upkeep->update & (PU_DISTANCE)) {
 		p->upkeep->update &= ~(PU_DISTANCE);
-		p->upkeep->update &= ~(PU_MONSTERS);
+		p->upkeep->update &= ~(PU_MONSTERS | PU_MON_CHANGED);
 		update_monsters(true);
 	}
 
 	if (p->upkeep->update & (PU_MONSTERS)) {
-		p->upkeep->update &= ~(PU_MONSTERS);
+		p->upkeep->update &= ~(PU_MONSTERS | PU_MON_CHANGED);
 		update_monsters(false);
 	}
 
+	if (p->upkeep->update & (PU_MON_CHANGED)) {
+		p->upkeep->update &= ~(PU_MON_CHANGED);
+		update_changed_monsters();
+	}
+
 
 	if (p->upkeep->update & (PU_PANEL)) {
 		p->upkeep->update &= ~(PU_PANEL);
@@ -2584,6 +2685,12 @@ void redraw_stuff(struct player *p)
 	/* Redraw stuff */
 	if (!redraw) return;
 
+	/* Nobody to redraw for */
+	if (display_null) {
+		p->upkeep->redraw = 0;
+		return;
+	}
+
 	/* Character is not ready yet, no screen updates */
 	if (!character_generated) return;
 
@@ -2596,6 +2703,9 @@ void redraw_stuff(struct player *p)
 		&& !(redraw & PR_MESSAGE))
 		return;
 
+	/* Nothing changes objects while redrawing, so remember knowledge */
+	object_knowledge_cache_begin();
+
 	/* For each listed flag, send the appropriate signal to the UI */
 	for (i = 0; i < N_ELEMENTS(redraw_events); i++) {
 		const struct flag_event_trigger *hnd = &redraw_events[i];
@@ -2605,7 +2715,7 @@ void redraw_stuff(struct player *p)
 	}
 
 	/* Then the ones that require parameters to be supplied. */
-	if (redraw & PR_MAP) {
+	if (redraw & (PR_MAP | PR_MAP_VIEW)) {
 		/* Mark the whole map to be redrawn */
 		event_signal_point(EVENT_MAP, -1, -1);
 	}
@@ -2613,13 +2723,15 @@ void redraw_stuff(struct player *p)
 	p->upkeep->redraw &= ~redraw;
 
 	/* Map is not shown, subwindow updates only */
-	if (!map_is_visible()) return;
+	if (map_is_visible()) {
+		/*
+		 * Do any plotting, etc. delayed from earlier - this set of updates
+		 * is over.
+		 */
+		event_signal(EVENT_END);
+	}
 
-	/*
-	 * Do any plotting, etc. delayed from earlier - this set of updates
-	 * is over.
-	 */
-	event_signal(EVENT_END);
+	object_knowledge_cache_end();
 }
 
 
@@ -2628,7 +2740,102 @@ void redraw_stuff(struct player *p)
  */
 void handle_stuff(struct player *p)
 {
-	if (p->upkeep->update) update_stuff(p);
-	if (p->upkeep->redraw) redraw_stuff(p);
+	u64b start;
+
+	/* Leave it all for release_stuff() */
+	if (p->upkeep->hold_stuff) {
+		if (p->upkeep->update || p->upkeep->redraw) {
+			p->upkeep->stuff_held = true;
+			profile_flush(PROFILE_FLUSH_PUT_OFF, NULL);
+		}
+		return;
+	}
+
+	if (p->upkeep->update) {
+		start = profile_begin();
+		update_stuff(p);
+		profile_end(PROFILE_UPDATE, start);
+	}
+	if (p->upkeep->redraw) {
+		enum mem_tag tag;
+
+		/* Leave the redraw for the end of the frame */
+		if (p->upkeep->frame) {
+			profile_flush(PROFILE_FLUSH_PUT_OFF, NULL);
+			return;
+		}
+
+		tag = mem_tag_set(MEM_TAG_UI);
+		start = profile_begin();
+		redraw_stuff(p);
+		profile_end(PROFILE_REDRAW, start);
+		mem_tag_set(tag);
+		profile_flush(PROFILE_FLUSH_DONE, NULL);
+	}
+}
+
+/**
+ * Put off handle_stuff() until the matching release_stuff(), so that a run of
+ * changes (such as every kill in a blast) is only handled once.  Holds nest.
+ */
+void hold_stuff(struct player *p)
+{
+	p->upkeep->hold_stuff++;
 }
 
+/**
+ * End a hold_stuff(), doing any handle_stuff() that was put off when the
+ * last hold ends
+ */
+void release_stuff(struct player *p)
+{
+	assert(p->upkeep->hold_stuff > 0);
+	if (--p->upkeep->hold_stuff) return;
+	if (p->upkeep->stuff_held) {
+		p->upkeep->stuff_held = false;
+		handle_stuff(p);
+	}
+}
+
+/**
+ * Start a frame, a stretch of the game loop (such as a round of monster
+ * turns) which ends at a point where the loop brings the screen up to date
+ * anyway.  Within a frame handle_stuff() still does the updates, so the game
+ * sees the player as it always would, but leaves the redraws, so that
+ * however often the flags are set again they are only drawn once.  Frames
+ * nest.
+ */
+void frame_begin(struct player *p)
+{
+	p->upkeep->frame++;
+}
+
+/**
+ * End a frame; whatever it left is done by the next handle_stuff()
+ */
+void frame_end(struct player *p)
+{
+	assert(p->upkeep->frame > 0);
+	p->upkeep->frame--;
+}
+
+/**
+ * Do everything a hold or frame has put off, as `who` is about to show the
+ * screen to the player (to wait for a key, say); the hold or frame then
+ * carries on.  These early flushes are counted by the profiler under `who`.
+ */
+void flush_stuff(struct player *p, const char *who)
+{
+	int hold = p->upkeep->hold_stuff, frame = p->upkeep->frame;
+
+	if (!hold && !frame) return;
+	if (!p->upkeep->update && !p->upkeep->redraw) return;
+
+	profile_flush(PROFILE_FLUSH_FORCED, who);
+	p->upkeep->hold_stuff = 0;
+	p->upkeep->frame = 0;
+	p->upkeep->stuff_held = false;
+	handle_stuff(p);
+	p->upkeep->hold_stuff = hold;
+	p->upkeep->frame = frame;
+}
@@ -43,6 +43,8 @@
 #define PU_DISTANCE		0x00000080L	/* Update distances */
 #define PU_PANEL		0x00000100L	/* Update panel */
 #define PU_INVEN		0x00000200L	/* Update inventory */
+#define PU_TIMED		0x00000400L	/* Calculate bonuses, equipment unchanged */
+#define PU_MON_CHANGED	0x00000800L	/* Update monsters marked as changed */
 
 
 /**
@@ -74,6 +76,7 @@
 #define PR_ITEMLIST		0x00800000L /* Display item list */
 #define PR_FEELING		0x01000000L /* Display level feeling */
 #define PR_LIGHT		0x02000000L /* Display light level */
+#define PR_MAP_VIEW		0x04000000L /* Show whole map again, unchanged */
 
 /**
  * Display Basic Info
@@ -112,6 +115,8 @@ void calc_bonuses(struct player *p, struct player_state *state, bool known_only,
 void calc_digging_chances(struct player_state *state, int chances[DIGGING_MAX]);
 int calc_blows(struct player *p, const struct object *obj,
 			   struct player_state *state, int extra_blows);
+int calc_blows_at(struct player *p, const struct object *weapon,
+				  const struct player_state *state, int str_ind, int dex_ind);
 
 void health_track(struct player_upkeep *upkeep, struct monster *mon);
 void monster_race_track(struct player_upkeep *upkeep, 
@@ -125,6 +130,11 @@ void notice_stuff(struct player *p);
 void update_stuff(struct player *p);
 void redraw_stuff(struct player *p);
 void handle_stuff(struct player *p);
+void hold_stuff(struct player *p);
+void release_stuff(struct player *p);
+void frame_begin(struct player *p);
+void frame_end(struct player *p);
+void flush_stuff(struct player *p, const char *who);
 int weight_remaining(struct player *p);
 
 #endif /* !PLAYER_CALCS_H */
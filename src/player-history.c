@@ -18,6 +18,7 @@
 #include "angband.h"
 #include "cave.h"
 #include "game-world.h"
+#include "init.h"
 #include "obj-desc.h"
 #include "obj-make.h"
 #include "obj-pile.h"
@@ -61,11 +62,27 @@ void history_clear(struct player *p)
 		mem_free(h->entries);
 		h->entries = NULL;
 	}
+	mem_free(h->artifact_entry);
+	h->artifact_entry = NULL;
+	mem_free(h->artifact_known);
+	h->artifact_known = NULL;
 
 	h->next = 0;
 	h->length = 0;
 }
 
+/**
+ * Get the latest entry for an artifact, or NULL if there is none.
+ */
+static struct history_info *history_artifact_entry(struct player_history *h,
+		const struct artifact *artifact)
+{
+	assert(artifact);
+	if (!h->artifact_entry || !h->artifact_entry[artifact->aidx])
+		return NULL;
+	return &h->entries[h->artifact_entry[artifact->aidx] - 1];
+}
+
 /**
  * Add an entry with text `text` to the history list, with type `type`
  * ("HIST_xxx" in player-history.h), and artifact number `id` (0 for
@@ -99,6 +116,19 @@ bool history_add_full(struct player *p,
 			text,
 			sizeof(h->entries[h->next].event));
 
+	/* Index artifacts, so their entries needn't be looked for */
+	if (aidx) {
+		if (!h->artifact_entry) {
+			h->artifact_entry = mem_zalloc(z_info->a_max *
+				sizeof(*h->artifact_entry));
+			h->artifact_known = mem_zalloc(z_info->a_max *
+				sizeof(*h->artifact_known));
+		}
+		h->artifact_entry[aidx] = h->next + 1;
+		if (hist_has(type, HIST_ARTIFACT_KNOWN))
+			h->artifact_known[aidx] = true;
+	}
+
 	h->next++;
 
 	return true;
@@ -140,16 +170,8 @@ bool history_is_artifact_known(struct player *p, const struct artifact *artifact
 {
 	struct player_history *h = &p->hist;
 
-	size_t i = h->next;
 	assert(artifact);
-
-	while (i--) {
-		if (hist_has(h->entries[i].type, HIST_ARTIFACT_KNOWN) &&
-				h->entries[i].a_idx == artifact->aidx)
-			return true;
-	}
-
-	return false;
+	return h->artifact_known && h->artifact_known[artifact->aidx];
 }
 
 /**
@@ -158,18 +180,13 @@ bool history_is_artifact_known(struct player *p, const struct artifact *artifact
 static bool history_mark_artifact_known(struct player_history *h,
 		const struct artifact *artifact)
 {
-	assert(artifact);
+	struct history_info *entry = history_artifact_entry(h, artifact);
 
-	size_t i = h->next;
-	while (i--) {
-		if (h->entries[i].a_idx == artifact->aidx) {
-			hist_off(h->entries[i].type, HIST_ARTIFACT_UNKNOWN);
-			hist_on(h->entries[i].type, HIST_ARTIFACT_KNOWN);
-			return true;
-		}
-	}
-
-	return false;
+	if (!entry) return false;
+	hist_off(entry->type, HIST_ARTIFACT_UNKNOWN);
+	hist_on(entry->type, HIST_ARTIFACT_KNOWN);
+	h->artifact_known[artifact->aidx] = true;
+	return true;
 }
 
 /**
@@ -178,17 +195,11 @@ static bool history_mark_artifact_known(struct player_history *h,
 static bool history_mark_artifact_lost(struct player_history *h,
 		const struct artifact *artifact)
 {
-	assert(artifact);
+	struct history_info *entry = history_artifact_entry(h, artifact);
 
-	size_t i = h->next;
-	while (i--) {
-		if (h->entries[i].a_idx == artifact->aidx) {
-			hist_on(h->entries[i].type, HIST_ARTIFACT_LOST);
-			return true;
-		}
-	}
-
-	return false;
+	if (!entry) return false;
+	hist_on(entry->type, HIST_ARTIFACT_LOST);
+	return true;
 }
 
 /**
@@ -277,6 +288,8 @@ void history_unmask_unknown(struct player *p)
 		if (hist_has(h->entries[i].type, HIST_ARTIFACT_UNKNOWN)) {
 			hist_off(h->entries[i].type, HIST_ARTIFACT_UNKNOWN);
 			hist_on(h->entries[i].type, HIST_ARTIFACT_KNOWN);
+			if (h->entries[i].a_idx)
+				h->artifact_known[h->entries[i].a_idx] = true;
 		}
 	}
 }
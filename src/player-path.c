@@ -34,24 +34,31 @@
  * Pathfinding code
  * ------------------------------------------------------------------------ */
 
-/**
- * Maximum size around the player to consider in the pathfinder
- */
-#define MAX_PF_RADIUS 100
-
 /**
  * Maximum distance to consider in the pathfinder
  */
 #define MAX_PF_LENGTH 500
 
 
-static int terrain[MAX_PF_RADIUS][MAX_PF_RADIUS];
 static char pf_result[MAX_PF_LENGTH];
 static int pf_result_index;
 
-static int ox, oy, ex, ey;
 static int dir_search[8] = {2,4,6,8,1,3,7,9};
 
+/**
+ * The open list of the pathfinder, a heap ordered by estimated path length
+ */
+struct pf_node {
+	int key;
+	int idx;
+};
+
+struct pf_heap {
+	struct pf_node *nodes;
+	int num;
+	int size;
+};
+
 
 static bool is_valid_pf(int y, int x)
 {
@@ -70,113 +77,161 @@ static bool is_valid_pf(int y, int x)
 	return (square_ispassable(cave, grid));
 }
 
-static void fill_terrain_info(void)
+/**
+ * Add a grid to the open list
+ */
+static void pf_heap_push(struct pf_heap *h, int key, int idx)
 {
-	int i, j;
-
-	ox = MAX(player->grid.x - MAX_PF_RADIUS / 2, 0);
-	oy = MAX(player->grid.y - MAX_PF_RADIUS / 2, 0);
+	struct pf_node node;
+	int i;
 
-	ex = MIN(player->grid.x + MAX_PF_RADIUS / 2 - 1, cave->width);
-	ey = MIN(player->grid.y + MAX_PF_RADIUS / 2 - 1, cave->height);
+	if (h->num == h->size) {
+		h->size = h->size ? h->size * 2 : 256;
+		h->nodes = mem_realloc(h->nodes, h->size * sizeof(*h->nodes));
+	}
 
-	for (i = 0; i < MAX_PF_RADIUS; i++)
-		for (j = 0; j < MAX_PF_RADIUS; j++)
-			terrain[i][j] = -1;
+	/* Sift up from the end */
+	node.key = key;
+	node.idx = idx;
+	for (i = h->num++; i > 0; i = (i - 1) / 2) {
+		int parent = (i - 1) / 2;
+		if (h->nodes[parent].key <= key) break;
+		h->nodes[i] = h->nodes[parent];
+	}
+	h->nodes[i] = node;
+}
 
-	for (j = oy; j < ey; j++)
-		for (i = ox; i < ex; i++)
-			if (is_valid_pf(j, i))
-				terrain[j - oy][i - ox] = MAX_PF_LENGTH;
+/**
+ * Take the grid with the shortest estimated path off the open list
+ */
+static struct pf_node pf_heap_pop(struct pf_heap *h)
+{
+	struct pf_node top = h->nodes[0], last;
+	int i = 0;
+
+	last = h->nodes[--h->num];
+	while (true) {
+		int child = 2 * i + 1;
+		if (child >= h->num) break;
+		if ((child + 1 < h->num) &&
+			(h->nodes[child + 1].key < h->nodes[child].key))
+			child++;
+		if (last.key <= h->nodes[child].key) break;
+		h->nodes[i] = h->nodes[child];
+		i = child;
+	}
+	if (h->num) h->nodes[i] = last;
 
-	terrain[player->grid.y - oy][player->grid.x - ox] = 1;
+	return top;
 }
 
-#define MARK_DISTANCE(c,d) if ((c <= MAX_PF_LENGTH) && (c > d)) \
-							{ c = d; try_again = true; }
-
+/**
+ * Find a path from the player to (y, x) through the grids the player knows
+ * to be safe (or does not know at all), and store it for run_step().
+ *
+ * This is an A* search over the whole level, with each step costing one and
+ * the longer of the two axis distances as the estimate of what is left; that
+ * never overestimates, so the first time the target comes off the open list
+ * the path to it is a shortest one.  The distance from the player to every
+ * grid reached is kept, counting the player's grid as 1, and the path is then
+ * read back from the target by stepping to a neighbour one closer, trying
+ * the cardinal directions first.
+ */
 bool findpath(int y, int x)
 {
-	int i, j, k;
+	int k;
 	int dir = 10;
-	bool try_again;
-	int cur_distance;
+	int w = cave->width;
 	struct loc grid = loc(x, y);
+	struct pf_heap open = { NULL, 0, 0 };
+	int from = player->grid.y * w + player->grid.x;
+	int *dist;
+	int cur_distance;
+	bool found = false;
 
-	fill_terrain_info();
-
-	terrain[player->grid.y - oy][player->grid.x - ox] = 1;
-
-	if ((x >= ox) && (x < ex) && (y >= oy) && (y < ey)) {
-		if ((square(cave, grid).mon > 0) &&
-			monster_is_visible(square_monster(cave, grid))) {
-			terrain[y - oy][x - ox] = MAX_PF_LENGTH;
-		}
-	} else {
+	if (!square_in_bounds(cave, grid)) {
 		bell("Target out of range.");
 		return false;
 	}
 
-	/* 
-	 * And now starts the very naive and very 
-	 * inefficient pathfinding algorithm
-	 */
-	do {
-		try_again = false;
-
-		for (j = oy + 1; j < ey - 1; j++) {
-			for (i = ox + 1; i < ex - 1; i++) {
-				cur_distance = terrain[j - oy][i - ox] + 1;
-
-				if ((cur_distance > 0) && (cur_distance < MAX_PF_LENGTH)) {
-					for (dir = 1; dir < 10; dir++) {
-						int next_y, next_x;
-						if (dir == 5)
-							dir++;
-						next_y = j - oy + ddy[dir];
-						next_x = i - ox + ddx[dir];
-
-						MARK_DISTANCE(terrain[next_y][next_x], cur_distance);
-					}
-				}
-			}
+	/* Distance from the player, or 0 for grids not reached yet */
+	dist = mem_zalloc(w * cave->height * sizeof(*dist));
+	dist[from] = 1;
+	pf_heap_push(&open, 1 + MAX(ABS(x - player->grid.x),
+								ABS(y - player->grid.y)), from);
+
+	while (open.num) {
+		struct pf_node node = pf_heap_pop(&open);
+		struct loc cur = loc(node.idx % w, node.idx / w);
+		int h = MAX(ABS(x - cur.x), ABS(y - cur.y));
+
+		/* Skip grids which have been reached more cheaply since */
+		cur_distance = dist[node.idx];
+		if (node.key != cur_distance + h) continue;
+
+		if (loc_eq(cur, grid)) {
+			found = true;
+			break;
 		}
 
-		if (terrain[y - oy][x - ox] < MAX_PF_LENGTH)
-			try_again = false;
+		/* Paths are only so long, and the edge of the level is not crossed */
+		if (cur_distance + 1 >= MAX_PF_LENGTH) continue;
+		if (!square_in_bounds_fully(cave, cur)) continue;
+
+		for (dir = 1; dir < 10; dir++) {
+			struct loc next;
+			int idx;
+
+			if (dir == 5) continue;
+			next = loc_sum(cur, ddgrid[dir]);
+			idx = next.y * w + next.x;
+			if (dist[idx] && (dist[idx] <= cur_distance + 1)) continue;
 
+			/* A visible monster on the target doesn't stop us going there */
+			if (!is_valid_pf(next.y, next.x) &&
+				!(loc_eq(next, grid) && (square(cave, grid).mon > 0) &&
+				  monster_is_visible(square_monster(cave, grid)))) {
+				continue;
+			}
+
+			dist[idx] = cur_distance + 1;
+			pf_heap_push(&open, dist[idx] + MAX(ABS(x - next.x),
+												ABS(y - next.y)), idx);
+		}
 	}
-	while (try_again) ;
+	mem_free(open.nodes);
 
 	/* Failure */
-	if (terrain[y - oy][x - ox] == -1 || terrain[y - oy][x - ox] == MAX_PF_LENGTH) {
+	if (!found) {
+		mem_free(dist);
 		bell("Target space unreachable.");
 		return false;
 	}
 
 	/* Success */
-	i = x;
-	j = y;
-
 	pf_result_index = 0;
 
-	while ((i != player->grid.x) || (j != player->grid.y)) {
-		cur_distance = terrain[j - oy][i - ox] - 1;
+	while (!loc_eq(grid, player->grid)) {
+		cur_distance = dist[grid.y * w + grid.x] - 1;
 		for (k = 0; k < 8; k++) {
+			struct loc prev;
+
 			dir = dir_search[k];
-			if (terrain[j - oy + ddy[dir]][i - ox + ddx[dir]] == cur_distance)
+			prev = loc_sum(grid, ddgrid[dir]);
+			if (square_in_bounds(cave, prev) &&
+				dist[prev.y * w + prev.x] == cur_distance)
 				break;
 		}
 
 		/* Should never happen */
-		assert ((dir != 10) && (dir != 5));
+		assert(k < 8);
 
 		pf_result[pf_result_index++] = '0' + (char)(10 - dir);
-		i += ddx[dir];
-		j += ddy[dir];
+		grid = loc_sum(grid, ddgrid[dir]);
 	}
 
 	pf_result_index--;
+	mem_free(dist);
 
 	return true;
 }
@@ -123,6 +123,35 @@ static const int adj_mag_stat[STAT_RANGE] =
 	57	/* 18/220+ */
 };
 
+/**
+ * Everything a spell's fail rate and info string depend on which can change
+ * without update_stuff() redoing the player's bonuses or spells
+ */
+struct spell_key {
+	u32b stamp;			/* player->upkeep->spell_stamp */
+	int lev;
+	int csp;
+	int chp;
+	int depth;
+	int stun;
+	bool amnesia;
+	bool unlight_lit;
+	const struct monster *target;
+	int target_hp;
+};
+
+/**
+ * A spell's fail rate and (if asked for) info string, as last worked out
+ * under key
+ */
+struct spell_memo {
+	struct spell_key key;
+	bool valid;
+	bool has_info;
+	s16b chance;
+	char info[30];
+};
+
 /**
  * Initialise player spells
  */
@@ -136,6 +165,7 @@ void player_spells_init(struct player *p)
 	/* Allocate */
 	p->spell_flags = mem_zalloc(num_spells * sizeof(byte));
 	p->spell_order = mem_zalloc(num_spells * sizeof(byte));
+	p->spell_memo = mem_zalloc(num_spells * sizeof(struct spell_memo));
 
 	/* None of the spells have been learned yet */
 	for (i = 0; i < num_spells; i++)
@@ -149,6 +179,8 @@ void player_spells_free(struct player *p)
 {
 	mem_free(p->spell_flags);
 	mem_free(p->spell_order);
+	mem_free(p->spell_memo);
+	p->spell_memo = NULL;
 }
 
 /**
@@ -648,6 +680,72 @@ void get_spell_info(int spell_index, char *p, size_t len)
 	}
 }
 
+/**
+ * Fill in the current spell_key
+ */
+static void spell_key_get(struct spell_key *key)
+{
+	struct monster *mon = target_get_monster();
+
+	/* Clear the padding too, so keys can be compared whole */
+	memset(key, 0, sizeof(*key));
+	key->stamp = player->upkeep->spell_stamp;
+	key->lev = player->lev;
+	key->csp = player->csp;
+	key->chp = player->chp;
+	key->depth = cave ? cave->depth : 0;
+	key->stun = player->timed[TMD_STUN] > 50 ? 2 :
+		(player->timed[TMD_STUN] ? 1 : 0);
+	key->amnesia = player->timed[TMD_AMNESIA] ? true : false;
+	key->unlight_lit = player_has(player, PF_UNLIGHT) && cave &&
+		square_islit(cave, player->grid);
+	key->target = mon;
+	key->target_hp = mon ? mon->hp : 0;
+}
+
+/**
+ * Get the fail rate and info string of a spell for a spell menu.
+ *
+ * Menus ask for these for every row on every redraw, so each spell keeps
+ * what it last got along with the spell_key it was worked out under, and
+ * only works them out again when that has changed.  The bonuses and level
+ * the answers rest on are covered by the upkeep's spell_stamp, which
+ * update_stuff() moves on whenever it redoes either.  info may be NULL if
+ * only the fail rate is wanted; the string stays valid until the next call.
+ */
+s16b spell_chance_info(int spell_index, const char **info)
+{
+	struct spell_memo *memo;
+	struct spell_key key;
+
+	if (!player->spell_memo) {
+		static char buf[30];
+
+		if (info) {
+			get_spell_info(spell_index, buf, sizeof(buf));
+			*info = buf;
+		}
+		return spell_chance(spell_index);
+	}
+
+	memo = &player->spell_memo[spell_index];
+	spell_key_get(&key);
+	if (!memo->valid || memcmp(&memo->key, &key, sizeof(key))) {
+		memo->key = key;
+		memo->valid = true;
+		memo->has_info = false;
+		memo->chance = spell_chance(spell_index);
+	}
+	if (info) {
+		if (!memo->has_info) {
+			get_spell_info(spell_index, memo->info, sizeof(memo->info));
+			memo->has_info = true;
+		}
+		*info = memo->info;
+	}
+	return memo->chance;
+}
+
 static int spell_value_base_spell_power(void)
 {
 	int power = 0;
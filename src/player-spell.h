@@ -37,6 +37,7 @@ void spell_learn(int spell_index);
 bool spell_cast(int spell_index, int dir);
 
 extern void get_spell_info(int index, char *buf, size_t len);
+s16b spell_chance_info(int spell_index, const char **info);
 extern bool cast_spell(int tval, int index, int dir);
 extern bool spell_needs_aim(int spell_index);
 extern expression_base_value_f spell_value_base_by_name(const char *name);
@@ -1244,11 +1244,10 @@ void disturb(struct player *p, int stop_search)
 		cmdq_flush();
 
 		/* Check for new panel if appropriate */
-		event_signal(EVENT_PLAYERMOVED);
-		p->upkeep->update |= PU_TORCH;
+		p->upkeep->update |= (PU_TORCH | PU_PANEL);
 
-		/* Mark the whole map to be redrawn */
-		event_signal_point(EVENT_MAP, -1, -1);
+		/* Mark the whole map to be redrawn with the rest of the redraws */
+		p->upkeep->redraw |= PR_MAP;
 	}
 
 	/* Flush input */
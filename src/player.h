@@ -375,6 +375,9 @@ struct player_history {
 	struct history_info *entries;	/**< List of entries */
 	size_t next;					/**< First unused entry */
 	size_t length;					/**< Current length */
+	size_t *artifact_entry;			/**< Latest entry for each artifact,
+									 * plus one, or 0 if none */
+	bool *artifact_known;			/**< Whether each artifact is known */
 };
 
 /**
@@ -393,6 +396,7 @@ struct player_state {
 	int speed;			/**< Current speed */
 
 	int num_blows;		/**< Number of blows x100 */
+	int extra_blows;	/**< Extra blows from equipment, shape and effects */
 	int num_shots;		/**< Number of shots x10 */
 	int num_moves;		/**< Number of movement actions */
 
@@ -422,6 +426,20 @@ struct player_state {
 
 #define player_has(p, flag)       (pf_has(p->state.pflags, (flag)))
 
+/**
+ * The part of the player state which comes from race, class and equipment,
+ * kept so that timed effects changing can be handled without looking at the
+ * equipment again
+ */
+struct player_bonus_layer {
+	bool valid;					/**< Layer is up to date */
+	struct player_state state;	/**< State from race, class and equipment */
+	int extra_blows;			/**< Equipment modifiers which are */
+	int extra_shots;			/**< applied later in calc_bonuses() */
+	int extra_might;
+	int extra_moves;
+};
+
 /**
  * Temporary, derived, player-related variables used during play but not saved
  *
@@ -433,9 +451,12 @@ struct player_upkeep {
 	bool generate_level;	/* True if level needs regenerating */
 	bool only_partial;		/* True if only partial updates are needed */
 	bool dropping;			/* True if auto-drop is in progress */
+	bool stuff_held;		/* True if handle_stuff() was put off */
 
 	int energy_use;			/* Energy use this turn */
 	int new_spells;			/* Number of spells available */
+	int hold_stuff;			/* Depth of handle_stuff() holds */
+	int frame;				/* Depth of frame_begin()s */
 
 	struct monster *health_who;			/* Health bar trackee */
 	struct monster_race *monster_race;	/* Monster race trackee */
@@ -466,6 +487,9 @@ struct player_upkeep {
 	bool running_withpathfind;	/* Are we using the pathfinder ? */
 	bool running_firststep;		/* Is this our first step running? */
 
+	struct player_bonus_layer bonus_layer[2];	/* Equipment part of state,
+												 * and of known_state */
+
 	struct object **quiver;	/* Quiver objects */
 	struct object **inven;	/* Inventory objects */
 	int total_weight;		/* Total weight being carried */
@@ -473,6 +497,7 @@ struct player_upkeep {
 	int equip_cnt;			/* Number of items in equipment */
 	int quiver_cnt;			/* Number of items in the quiver */
 	int recharge_pow;		/* Power of recharge effect */
+	u32b spell_stamp;		/* Moved on when bonuses or spells are redone */
 };
 
 /**
@@ -539,6 +564,7 @@ struct player {
 
 	byte *spell_flags;			/* Spell flags */
 	byte *spell_order;			/* Spell order */
+	struct spell_memo *spell_memo;	/* See spell_chance_info() */
 	byte searching;		/* Currently searching */
 
 	char full_name[PLAYER_NAME_LEN];	/* Full name */
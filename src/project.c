@@ -20,6 +20,7 @@
 #include "cave.h"
 #include "game-event.h"
 #include "game-input.h"
+#include "game-profile.h"
 #include "generate.h"
 #include "init.h"
 #include "mon-predicate.h"
@@ -120,8 +121,8 @@ const char *proj_idx_to_name(int type)
  * This algorithm is similar to, but slightly different from, the one used
  * by "update_view_los()", and very different from the one used by "los()".
  */
-int project_path(struct loc *gp, int range, struct loc grid1, struct loc grid2,
-				 int flg)
+static int project_path_trace(struct loc *gp, int range, struct loc grid1,
+							  struct loc grid2, int flg)
 {
 	int y, x;
 
@@ -334,6 +335,50 @@ int project_path(struct loc *gp, int range, struct loc grid1, struct loc grid2,
 	return (n);
 }
 
+/**
+ * Find the projection path from grid1 to grid2 (see project_path_trace()).
+ *
+ * Paths which depend only on the terrain are remembered in a direct-mapped
+ * memo owned by the current level, so that the same path asked for again
+ * (as when a monster is both checked for visibility and picks a spell
+ * target) is copied rather than traced.  Entries are stamped with the
+ * level's project_stamp, so any change to which grids are projectable
+ * discards them all; paths which stop at monsters or consult the player's
+ * memory are always traced afresh.
+ */
+int project_path(struct loc *gp, int range, struct loc grid1, struct loc grid2,
+				 int flg)
+{
+	int from, to;
+	u32b hash;
+	struct path_memo *memo;
+
+	if ((flg & (PROJECT_STOP | PROJECT_INFO)) || range > PATH_MEMO_LEN ||
+		!square_in_bounds(cave, grid1) || !square_in_bounds(cave, grid2))
+		return project_path_trace(gp, range, grid1, grid2, flg);
+
+	if (!cave->path_memo)
+		cave->path_memo = mem_zalloc(PATH_MEMO_SIZE * sizeof(struct path_memo));
+
+	from = grid_to_i(grid1, cave->width);
+	to = grid_to_i(grid2, cave->width);
+	hash = ((u32b) from * 2654435761U) ^ (u32b) to ^ ((u32b) flg << 7) ^
+		(u32b) range;
+	memo = &cave->path_memo[(hash ^ (hash >> 16)) & (PATH_MEMO_SIZE - 1)];
+
+	if (memo->stamp != cave->project_stamp || memo->from != from ||
+		memo->to != to || memo->range != range || memo->flg != flg) {
+		memo->from = from;
+		memo->to = to;
+		memo->range = range;
+		memo->flg = flg;
+		memo->stamp = cave->project_stamp;
+		memo->n = project_path_trace(memo->path, range, grid1, grid2, flg);
+	}
+	memcpy(gp, memo->path, memo->n * sizeof(struct loc));
+	return memo->n;
+}
+
 
 /**
  * Determine if a bolt spell cast from grid1 to grid2 will arrive
@@ -366,6 +411,45 @@ bool projectable(struct chunk *c, struct loc grid1, struct loc grid2, int flg)
 	return (true);
 }
 
+/**
+ * Determine if a bolt from a grid would reach the player, as
+ * projectable(c, grid, player->grid, PROJECT_NONE) does.
+ *
+ * Monsters ask this every turn, and paths are not the same both ways, so
+ * the player's view cannot answer it; but the answer only changes when the
+ * player moves or the terrain does.  So it is kept for each grid the first
+ * time it is asked, and all are forgotten when either of those happens.
+ */
+bool projectable_to_player(struct chunk *c, struct loc grid)
+{
+	size_t size = GRID_PLANE_SIZE(c->height * c->width) * sizeof(bitflag);
+	int i;
+
+	if (c != cave || !square_in_bounds(c, grid))
+		return projectable(c, grid, player->grid, PROJECT_NONE);
+
+	if (!c->to_player) {
+		c->to_player = mem_zalloc(size);
+		c->to_player_known = mem_zalloc(size);
+	}
+	if (c->to_player_stamp != c->feat_stamp ||
+		!loc_eq(c->to_player_grid, player->grid)) {
+		memset(c->to_player_known, 0, size);
+		c->to_player_stamp = c->feat_stamp;
+		c->to_player_grid = player->grid;
+	}
+
+	i = grid_to_i(grid, c->width);
+	if (!grid_plane_has(c->to_player_known, i)) {
+		grid_plane_on(c->to_player_known, i);
+		if (projectable(c, grid, player->grid, PROJECT_NONE))
+			grid_plane_on(c->to_player, i);
+		else
+			grid_plane_off(c->to_player, i);
+	}
+	return grid_plane_has(c->to_player, i);
+}
+
 
 
 
@@ -547,62 +631,150 @@ struct loc origin_get_loc(struct source origin)
  *
  * Note that we must call "handle_stuff()" after affecting terrain features
  * in the blast radius, in case the illumination of the grid was changed,
- * and "update_view()" and "update_monsters()" need to be called.
+ * and "update_view()" and "update_monsters()" need to be called.  Anything
+ * the blast does that would call it (each kill's experience, say) is held
+ * until the whole blast is done, and handled once then.
  */
-bool project(struct source origin, int rad, struct loc finish,
-			 int dam, int typ, int flg,
-			 int degrees_of_arc, byte diameter_of_source,
-			 const struct object *obj)
-{
-	int i, j, k, dist_from_centre;
+/**
+ * ------------------------------------------------------------------------
+ * Blast areas
+ * ------------------------------------------------------------------------ */
+/**
+ * The grids within some radius of an explosion centre, other than the centre
+ * itself, in the order project() looks at them (by row, then by column)
+ */
+struct blast_template {
+	int num;
+	struct loc *offset;
+	int *dist;
+};
 
-	u32b dam_temp;
+static struct blast_template *blast_templates;
+static int blast_templates_num;
 
-	struct loc centre;
-	struct loc start;
+/**
+ * Get the blast template for a radius, building it the first time it is needed
+ */
+static const struct blast_template *blast_template(int rad)
+{
+	struct blast_template *t;
+
+	if (rad >= blast_templates_num) {
+		blast_templates = mem_realloc(blast_templates,
+									  (rad + 1) * sizeof(*blast_templates));
+		memset(blast_templates + blast_templates_num, 0,
+			   (rad + 1 - blast_templates_num) * sizeof(*blast_templates));
+		blast_templates_num = rad + 1;
+	}
 
-	int n1y = 0;
-	int n1x = 0;
+	t = &blast_templates[rad];
+	if (!t->offset) {
+		int size = (2 * rad + 1) * (2 * rad + 1);
+		int y, x;
 
-	/* Assume the player sees nothing */
-	bool notice = false;
+		t->offset = mem_alloc(size * sizeof(*t->offset));
+		t->dist = mem_alloc(size * sizeof(*t->dist));
+		for (y = -rad; y <= rad; y++) {
+			for (x = -rad; x <= rad; x++) {
+				int d = distance(loc(0, 0), loc(x, y));
 
-	/* Notify the UI if it can draw this projection */
-	bool drawing = false;
+				if ((y == 0 && x == 0) || d > rad) continue;
+				t->offset[t->num] = loc(x, y);
+				t->dist[t->num] = d;
+				t->num++;
+			}
+		}
+	}
 
-	/* Is the player blind? */
-	bool blind = (player->timed[TMD_BLIND] ? true : false);
+	return t;
+}
 
-	/* Number of grids in the "path" */
-	int num_path_grids = 0;
+static void cleanup_blast_templates(void)
+{
+	int i;
 
-	/* Actual grids in the "path" */
-	struct loc path_grid[512];
+	for (i = 0; i < blast_templates_num; i++) {
+		mem_free(blast_templates[i].offset);
+		mem_free(blast_templates[i].dist);
+	}
+	mem_free(blast_templates);
+	blast_templates = NULL;
+	blast_templates_num = 0;
+}
+
+struct init_module project_module = {
+	.name = "project",
+	.init = NULL,
+	.cleanup = cleanup_blast_templates
+};
 
-	/* Number of grids in the "blast area" (including the "beam" path) */
-	int num_grids = 0;
+/**
+ * Work out the damage a projection does at some distance from its centre
+ */
+static int project_dam_at_dist(int dam, int rad, int diameter_of_source,
+							   int dist)
+{
+	u32b dam_temp;
 
-	/* Coordinates of the affected grids */
-	struct loc blast_grid[256];
+	if (dist > rad) {
+		/* No damage outside the radius. */
+		dam_temp = 0;
+	} else if ((!diameter_of_source) || (dist == 0)) {
+		/* Standard damage calc. for 10' source diameters, or at origin. */
+		dam_temp = (dam + dist) / (dist + 1);
+	} else {
+		/* If a particular diameter for the source of the explosion's
+		 * energy is given, it is full strength to that diameter and
+		 * then reduces */
+		dam_temp = (diameter_of_source * dam) / ((dist + 1) * 10);
+		if (dam_temp > (u32b) dam) {
+			dam_temp = dam;
+		}
+	}
 
-	/* Distance to each of the affected grids. */
-	int distance_to_grid[256];
+	return dam_temp;
+}
 
-	/* Player visibility of each of the affected grids. */
-	bool player_sees_grid[256];
+/**
+ * ------------------------------------------------------------------------
+ * Projection stages
+ * ------------------------------------------------------------------------ */
+/**
+ * The grids a projection affects, with their distances from its centre
+ */
+struct project_area {
+	int num;
+	struct loc centre;
+	struct loc grid[256];
+	int dist[256];
+};
 
-	/* Precalculated damage values for each distance. */
-	int *dam_at_dist = malloc((z_info->max_range + 1) * sizeof(*dam_at_dist));
+/**
+ * Add a grid to the area of a projection, marking it as being projected on
+ */
+static void project_area_add(struct project_area *area, struct loc grid,
+							 int dist)
+{
+	area->grid[area->num] = grid;
+	area->dist[area->num] = dist;
+	sqinfo_on(square(cave, grid).info, SQUARE_PROJECT);
+	area->num++;
+}
 
-	/* Flush any pending output */
-	handle_stuff(player);
+/**
+ * Find where a projection starts, dealing with PROJECT_JUMP
+ */
+static struct loc project_start(struct source origin, struct loc finish,
+								int *flg)
+{
+	struct loc start;
 
 	/* No projection path - jump to target */
-	if (flg & PROJECT_JUMP) {
+	if (*flg & PROJECT_JUMP) {
 		start = finish;
 
 		/* Clear the flag */
-		flg &= ~(PROJECT_JUMP);
+		*flg &= ~(PROJECT_JUMP);
 	} else {
 		start = origin_get_loc(origin);
 
@@ -612,21 +784,31 @@ bool project(struct source origin, int rad, struct loc finish,
 		}
 	}
 
-	/* Default center of explosion (if any) */
-	centre = start;
+	return start;
+}
 
-	/*
-	 * An arc spell with no width and a non-zero radius is actually a
-	 * beam of defined length.  Mark it as such.
-	 */
-	if ((flg & (PROJECT_ARC)) && (degrees_of_arc == 0) && (rad != 0)) {
-		/* No longer an arc */
-		flg &= ~(PROJECT_ARC);
+/**
+ * Follow the path of a projection from start towards finish, collecting the
+ * grids it affects on the way (all of them for beams, the last one for
+ * anything else) and showing the bolt.  Arcs only work out their path.  The
+ * centre of the area is left at the end of the path (or the start, for arcs).
+ *
+ * \return the number of grids in the path
+ */
+static int project_trace(struct loc start, struct loc finish, int rad,
+						 int typ, int flg, struct loc *path_grid,
+						 struct project_area *area)
+{
+	/* Is the player blind? */
+	bool blind = (player->timed[TMD_BLIND] ? true : false);
 
-		/* Now considered a beam */
-		flg |= (PROJECT_BEAM);
-		flg |= (PROJECT_THRU);
-	}
+	/* Notify the UI if it can draw this projection */
+	bool drawing = false;
+
+	/* Start from caster */
+	int y = start.y;
+	int x = start.x;
+	int i, num_path_grids;
 
 	/*
 	 * If a single grid is both start and finish (for example
@@ -634,243 +816,233 @@ bool project(struct source origin, int rad, struct loc finish,
 	 * projection path.
 	 */
 	if (loc_eq(start, finish)) {
-		blast_grid[num_grids] =  finish;
-		centre = finish;
-		distance_to_grid[num_grids] = 0;
-		sqinfo_on(square(cave, finish).info, SQUARE_PROJECT);
-		num_grids++;
-	} else {
-		/* Start from caster */
-		int y = start.y;
-		int x = start.x;
-
-		/* Calculate the projection path */
-		num_path_grids = project_path(path_grid, z_info->max_range, start,
-									  finish, flg);
-
-		/* Some beams have limited length. */
-		if (flg & (PROJECT_BEAM)) {
-			/* Use length limit, if any is given. */
-			if ((rad > 0) && (rad < num_path_grids)) {
-				num_path_grids = rad;
-			}
-		}
-
-
-		/* Project along the path (except for arcs) */
-		if (!(flg & (PROJECT_ARC))) {
-			for (i = 0; i < num_path_grids; ++i) {
-				int oy = y;
-				int ox = x;
-
-				int ny = path_grid[i].y;
-				int nx = path_grid[i].x;
-
-				/* Hack -- Balls explode before reaching walls. */
-				if (!square_ispassable(cave, path_grid[i]) && (rad > 0))
-					break;
-
-				/* Advance */
-				y = ny;
-				x = nx;
-
-				/* Beams collect all grids in the path, all other methods
-				 * collect only the final grid in the path. */
-				if (flg & (PROJECT_BEAM)) {
-					blast_grid[num_grids].y = y;
-					blast_grid[num_grids].x = x;
-					distance_to_grid[num_grids] = 0;
-					sqinfo_on(square(cave, loc(x, y)).info, SQUARE_PROJECT);
-					num_grids++;
-				} else if (i == num_path_grids - 1) {
-					blast_grid[num_grids].y = y;
-					blast_grid[num_grids].x = x;
-					distance_to_grid[num_grids] = 0;
-					sqinfo_on(square(cave, loc(x, y)).info, SQUARE_PROJECT);
-					num_grids++;
-				}
+		project_area_add(area, finish, 0);
+		area->centre = finish;
+		return 0;
+	}
 
-				/* Only do visuals if requested and within range limit. */
-				if (!blind && !(flg & (PROJECT_HIDE))) {
-					bool seen = square_isview(cave, loc(x, y));
-					bool beam = flg & (PROJECT_BEAM);
+	/* Calculate the projection path */
+	num_path_grids = project_path(path_grid, z_info->max_range, start, finish,
+								  flg);
 
-					/* Tell the UI to display the bolt */
-					event_signal_bolt(EVENT_BOLT, typ, drawing, seen, beam, oy,
-									  ox, y, x);
-				}
-			}
+	/* Some beams have limited length. */
+	if (flg & (PROJECT_BEAM)) {
+		/* Use length limit, if any is given. */
+		if ((rad > 0) && (rad < num_path_grids)) {
+			num_path_grids = rad;
 		}
-
-		/* Save the "blast epicenter" */
-		centre.y = y;
-		centre.x = x;
 	}
 
-	/* Now check for explosions.  Beams have already stored all the grids they
-	 * will affect; all non-beam projections with positive radius explode in
-	 * some way */
-	if ((rad > 0) && (!(flg & (PROJECT_BEAM)))) {
-		int y, x;
-
-		/* Pre-calculate some things for arcs. */
-		if ((flg & (PROJECT_ARC)) && (num_path_grids != 0)) {
-			/* Explosion centers on the caster. */
-			centre = start;
-
-			/* The radius of arcs cannot be more than 20 */
-			if (rad > 20)
-				rad = 20;
+	/* Project along the path (except for arcs) */
+	if (!(flg & (PROJECT_ARC))) {
+		for (i = 0; i < num_path_grids; ++i) {
+			int oy = y;
+			int ox = x;
 
-			/* Ensure legal access into get_angle_to_grid table */
-			if (num_path_grids < 21)
-				i = num_path_grids - 1;
-			else
-				i = 20;
-
-			/* Reorient the grid forming the end of the arc's centerline. */
-			n1y = path_grid[i].y - centre.y + 20;
-			n1x = path_grid[i].x - centre.x + 20;
-		}
+			/* Hack -- Balls explode before reaching walls. */
+			if (!square_ispassable(cave, path_grid[i]) && (rad > 0))
+				break;
 
-		/* If the explosion centre hasn't been saved already, save it now. */
-		if (num_grids == 0) {
-			blast_grid[num_grids] = centre;
-			distance_to_grid[num_grids] = 0;
-			sqinfo_on(square(cave, centre).info, SQUARE_PROJECT);
-			num_grids++;
+			/* Advance */
+			y = path_grid[i].y;
+			x = path_grid[i].x;
+
+			/* Beams collect all grids in the path, all other methods
+			 * collect only the final grid in the path. */
+			if ((flg & (PROJECT_BEAM)) || i == num_path_grids - 1)
+				project_area_add(area, loc(x, y), 0);
+
+			/* Only do visuals if requested and within range limit. */
+			if (!blind && !(flg & (PROJECT_HIDE))) {
+				bool seen = square_isview(cave, loc(x, y));
+				bool beam = flg & (PROJECT_BEAM);
+
+				/* Tell the UI to display the bolt */
+				event_signal_bolt(EVENT_BOLT, typ, drawing, seen, beam, oy,
+								  ox, y, x);
+			}
 		}
+	}
 
-		/* Scan every grid that might possibly be in the blast radius. */
-		for (y = centre.y - rad; y <= centre.y + rad; y++) {
-			for (x = centre.x - rad; x <= centre.x + rad; x++) {
-				struct loc grid = loc(x, y);
-
-				/* Center grid has already been stored. */
-				if (loc_eq(grid, centre))
-					continue;
-
-				/* Precaution: Stay within area limit. */
-				if (num_grids >= 255)
-					break;
-
-				/* Ignore "illegal" locations */
-				if (!square_in_bounds(cave, grid))
-					continue;
-
-				/* Most explosions are immediately stopped by walls. If
-				 * PROJECT_THRU is set, walls can be affected if adjacent to
-				 * a grid visible from the explosion centre - note that as of
-				 * Angband 3.5.0 there are no such explosions - NRM.
-				 * All explosions can affect one layer of terrain which is
-				 * passable but not projectable */
-				if ((flg & (PROJECT_THRU)) || square_ispassable(cave, grid)) {
-					/* If this is a wall grid, ... */
-					if (!square_isprojectable(cave, grid)) {
-						bool can_see_one = false;
-						/* Check neighbors */
-						for (i = 0; i < 8; i++) {
-							struct loc adj_grid = loc_sum(grid, ddgrid_ddd[i]);
-							if (los(cave, centre, adj_grid)) {
-								can_see_one = true;
-								break;
-							}
-						}
-
-						/* Require at least one adjacent grid in LOS. */
-						if (!can_see_one)
-							continue;
-					}
-				} else if (!square_isprojectable(cave, grid))
-					continue;
-
-				/* Must be within maximum distance. */
-				dist_from_centre  = (distance(centre, grid));
-				if (dist_from_centre > rad)
-					continue;
-
+	/* Save the "blast epicenter" */
+	area->centre = loc(x, y);
+	return num_path_grids;
+}
 
-				/* Do we need to consider a restricted angle? */
-				if (flg & (PROJECT_ARC)) {
-					/* Use angle comparison to delineate an arc. */
-					int n2y, n2x, tmp, rotate, diff;
-
-					/* Reorient current grid for table access. */
-					n2y = y - start.y + 20;
-					n2x = x - start.x + 20;
-
-					/* Find the angular difference (/2) between the lines to
-					 * the end of the arc's center-line and to the current grid.
-					 */
-					rotate = 90 - get_angle_to_grid[n1y][n1x];
-					tmp = ABS(get_angle_to_grid[n2y][n2x] + rotate) % 180;
-					diff = ABS(90 - tmp);
-
-					/* If difference is greater then that allowed, skip it */
-					if (diff >= (degrees_of_arc + 6) / 4) {
-						/* ...unless it's on the target path */
-						for (i = 0; i < num_path_grids; i++) {
-							if (loc_eq(grid, path_grid[i])) break;
-						}
-						if (i == num_path_grids) continue;
+/**
+ * Collect the grids an explosion (a ball or an arc) affects around the
+ * centre of a projection.  Arcs explode from the start of the projection,
+ * and have their radius limited to 20.
+ */
+static void project_explode(struct loc start, int *rad, int flg,
+							int degrees_of_arc, const struct loc *path_grid,
+							int num_path_grids, struct project_area *area)
+{
+	const struct blast_template *blast;
+	struct loc centre;
+	int n1y = 0;
+	int n1x = 0;
+	int i, n;
+
+	/* Pre-calculate some things for arcs. */
+	if ((flg & (PROJECT_ARC)) && (num_path_grids != 0)) {
+		/* Explosion centers on the caster. */
+		area->centre = start;
+
+		/* The radius of arcs cannot be more than 20 */
+		if (*rad > 20)
+			*rad = 20;
+
+		/* Ensure legal access into get_angle_to_grid table */
+		if (num_path_grids < 21)
+			i = num_path_grids - 1;
+		else
+			i = 20;
+
+		/* Reorient the grid forming the end of the arc's centerline. */
+		n1y = path_grid[i].y - area->centre.y + 20;
+		n1x = path_grid[i].x - area->centre.x + 20;
+	}
+	centre = area->centre;
+
+	/* If the explosion centre hasn't been saved already, save it now. */
+	if (area->num == 0)
+		project_area_add(area, centre, 0);
+
+	/* Scan every grid in the blast radius; the centre is already stored */
+	blast = blast_template(*rad);
+	for (n = 0; n < blast->num; n++) {
+		struct loc grid = loc_sum(centre, blast->offset[n]);
+
+		/* Precaution: Stay within area limit. */
+		if (area->num >= 255)
+			break;
+
+		/* Ignore "illegal" locations */
+		if (!square_in_bounds(cave, grid))
+			continue;
+
+		/* Most explosions are immediately stopped by walls. If
+		 * PROJECT_THRU is set, walls can be affected if adjacent to
+		 * a grid visible from the explosion centre - note that as of
+		 * Angband 3.5.0 there are no such explosions - NRM.
+		 * All explosions can affect one layer of terrain which is
+		 * passable but not projectable */
+		if ((flg & (PROJECT_THRU)) || square_ispassable(cave, grid)) {
+			/* If this is a wall grid, ... */
+			if (!square_isprojectable(cave, grid)) {
+				bool can_see_one = false;
+				/* Check neighbors */
+				for (i = 0; i < 8; i++) {
+					struct loc adj_grid = loc_sum(grid, ddgrid_ddd[i]);
+					if (los(cave, centre, adj_grid)) {
+						can_see_one = true;
+						break;
 					}
 				}
 
-				/* Accept remaining grids if in LOS */
-				if (los(cave, centre, grid)) {
-					blast_grid[num_grids].y = y;
-					blast_grid[num_grids].x = x;
-					distance_to_grid[num_grids] = dist_from_centre;
-					sqinfo_on(square(cave, grid).info, SQUARE_PROJECT);
-					num_grids++;
-				}
+				/* Require at least one adjacent grid in LOS. */
+				if (!can_see_one)
+					continue;
 			}
-		}
-	}
-
-	/* Calculate and store the actual damage at each distance. */
-	for (i = 0; i <= z_info->max_range; i++) {
-		if (i > rad) {
-			/* No damage outside the radius. */
-			dam_temp = 0;
-		} else if ((!diameter_of_source) || (i == 0)) {
-			/* Standard damage calc. for 10' source diameters, or at origin. */
-			dam_temp = (dam + i) / (i + 1);
-		} else {
-			/* If a particular diameter for the source of the explosion's
-			 * energy is given, it is full strength to that diameter and
-			 * then reduces */
-			dam_temp = (diameter_of_source * dam) / ((i + 1) * 10);
-			if (dam_temp > (u32b) dam) {
-				dam_temp = dam;
+		} else if (!square_isprojectable(cave, grid))
+			continue;
+
+		/* Do we need to consider a restricted angle? */
+		if (flg & (PROJECT_ARC)) {
+			/* Use angle comparison to delineate an arc. */
+			int n2y, n2x, tmp, rotate, diff;
+
+			/* Reorient current grid for table access. */
+			n2y = grid.y - start.y + 20;
+			n2x = grid.x - start.x + 20;
+
+			/* Find the angular difference (/2) between the lines to
+			 * the end of the arc's center-line and to the current grid.
+			 */
+			rotate = 90 - get_angle_to_grid[n1y][n1x];
+			tmp = ABS(get_angle_to_grid[n2y][n2x] + rotate) % 180;
+			diff = ABS(90 - tmp);
+
+			/* If difference is greater then that allowed, skip it */
+			if (diff >= (degrees_of_arc + 6) / 4) {
+				/* ...unless it's on the target path */
+				for (i = 0; i < num_path_grids; i++) {
+					if (loc_eq(grid, path_grid[i])) break;
+				}
+				if (i == num_path_grids) continue;
 			}
 		}
 
-		/* Store it. */
-		dam_at_dist[i] = dam_temp;
+		/* Accept remaining grids if in LOS */
+		if (los(cave, centre, grid))
+			project_area_add(area, grid, blast->dist[n]);
 	}
+}
 
+/**
+ * Sort the grids of an explosion by distance from the centre.
+ */
+static void project_sort(struct project_area *area, int rad)
+{
+	int i, j, k;
 
-	/* Sort the blast grids by distance from the centre. */
 	for (i = 0, k = 0; i <= rad; i++) {
 		/* Collect all the grids of a given distance together. */
-		for (j = k; j < num_grids; j++) {
-			if (distance_to_grid[j] == i) {
-				struct loc tmp;
-				int tmp_d = distance_to_grid[k];
-				tmp = blast_grid[k];
+		for (j = k; j < area->num; j++) {
+			if (area->dist[j] == i) {
+				struct loc tmp = area->grid[k];
+				int tmp_d = area->dist[k];
 
-				blast_grid[k] = blast_grid[j];
-				distance_to_grid[k] = distance_to_grid[j];
+				area->grid[k] = area->grid[j];
+				area->dist[k] = area->dist[j];
 
-				blast_grid[j] = tmp;
-				distance_to_grid[j] = tmp_d;
+				area->grid[j] = tmp;
+				area->dist[j] = tmp_d;
 
 				/* Write to next slot */
 				k++;
 			}
 		}
 	}
+}
+
+/**
+ * Show the blast of a projection, then affect the objects, monsters, player
+ * and terrain in its area (in that order), and tidy up afterwards.
+ *
+ * \param trace_start is when the projection started, for the game trace
+ * \return whether the player noticed anything
+ */
+static bool project_affect(struct source origin, struct project_area *area,
+						   int rad, int dam,
+						   int typ, int flg, byte diameter_of_source,
+						   const struct object *obj, u64b trace_start)
+{
+	/* Assume the player sees nothing */
+	bool notice = false;
+
+	/* Notify the UI if it can draw this projection */
+	bool drawing = false;
+
+	/* Is the player blind? */
+	bool blind = (player->timed[TMD_BLIND] ? true : false);
+
+	int num_grids = area->num;
+	struct loc *blast_grid = area->grid;
+	int *distance_to_grid = area->dist;
+	int i;
+
+	/* Player visibility of each of the affected grids. */
+	bool player_sees_grid[256];
+
+	/* Damage at each of the affected grids. */
+	int dam_at_grid[256];
+
+	/* Calculate the damage at each grid */
+	for (i = 0; i < num_grids; i++)
+		dam_at_grid[i] = project_dam_at_dist(dam, rad, diameter_of_source,
+											 distance_to_grid[i]);
 
 	/* Establish which grids are visible - no blast visuals with PROJECT_HIDE */
 	for (i = 0; i < num_grids; i++) {
@@ -885,13 +1057,16 @@ bool project(struct source origin, int rad, struct loc finish,
 
 	/* Tell the UI to display the blast */
 	event_signal_blast(EVENT_EXPLOSION, typ, num_grids, distance_to_grid,
-					   drawing, player_sees_grid, blast_grid, centre);
+					   drawing, player_sees_grid, blast_grid, area->centre);
+
+	/* Only tidy up the player once everything in the blast has been hit */
+	hold_stuff(player);
 
 	/* Affect objects on every relevant grid */
 	if (flg & (PROJECT_ITEM)) {
 		for (i = 0; i < num_grids; i++) {
 			if (project_o(origin, distance_to_grid[i], blast_grid[i],
-						  dam_at_dist[distance_to_grid[i]], typ, obj)) {
+						  dam_at_grid[i], typ, obj)) {
 				notice = true;
 			}
 		}
@@ -919,7 +1094,7 @@ bool project(struct source origin, int rad, struct loc finish,
 
 			/* Affect the monster in the grid */
 			project_m(origin, distance_to_grid[i], blast_grid[i],
-			          dam_at_dist[distance_to_grid[i]], typ, flg,
+			          dam_at_grid[i], typ, flg,
 			          &did_hit, &was_obvious);
 			if (was_obvious) {
 				notice = true;
@@ -967,10 +1142,13 @@ bool project(struct source origin, int rad, struct loc finish,
 		}
 		for (i = 0; i < num_grids; i++) {
 			if (project_p(origin, distance_to_grid[i], blast_grid[i],
-						  dam_at_dist[distance_to_grid[i]], typ, power)) {
+						  dam_at_grid[i], typ, power)) {
 				notice = true;
-				if (player->is_dead)
+				if (player->is_dead) {
+					release_stuff(player);
+					trace_end(TRACE_PROJECT, typ, trace_start);
 					return notice;
+				}
 				break;
 			}
 		}
@@ -980,7 +1158,7 @@ bool project(struct source origin, int rad, struct loc finish,
 	if (flg & (PROJECT_GRID)) {
 		for (i = 0; i < num_grids; i++) {
 			if (project_f(origin, distance_to_grid[i], blast_grid[i],
-						  dam_at_dist[distance_to_grid[i]], typ)) {
+						  dam_at_grid[i], typ)) {
 				notice = true;
 			}
 		}
@@ -992,11 +1170,163 @@ bool project(struct source origin, int rad, struct loc finish,
 		sqinfo_off(square(cave, blast_grid[i]).info, SQUARE_PROJECT);
 	}
 
-	/* Update stuff if needed */
-	if (player->upkeep->update) update_stuff(player);
+	/* Handle anything put off during the blast, then update stuff if needed
+	 * (or leave that to whoever is still holding it) */
+	release_stuff(player);
+	if (player->upkeep->update) {
+		if (player->upkeep->hold_stuff)
+			player->upkeep->stuff_held = true;
+		else
+			update_stuff(player);
+	}
 
-	free(dam_at_dist);
+	trace_end(TRACE_PROJECT, typ, trace_start);
 
 	/* Return "something was noticed" */
 	return (notice);
 }
+
+/**
+ * ------------------------------------------------------------------------
+ * Projections
+ * ------------------------------------------------------------------------ */
+/**
+ * Project a bolt, which affects only the last grid of its path.  There is no
+ * explosion, and all of the damage lands on the one grid.
+ */
+bool project_bolt(struct source origin, struct loc finish, int dam, int typ,
+				  int flg, const struct object *obj)
+{
+	u64b trace_start = trace_begin();
+	struct loc path_grid[512];
+	struct project_area area;
+	struct loc start;
+
+	/* Flush any pending output */
+	handle_stuff(player);
+
+	area.num = 0;
+	flg &= ~(PROJECT_BEAM | PROJECT_ARC);
+	start = project_start(origin, finish, &flg);
+	project_trace(start, finish, 0, typ, flg, path_grid, &area);
+
+	return project_affect(origin, &area, 0, dam, typ, flg, 0, obj,
+						  trace_start);
+}
+
+/**
+ * Project a beam, which affects every grid of its path up to len grids long
+ * (or the full range, if len is 0).  Beams never explode, so every grid is
+ * at the centre and takes full damage.
+ */
+bool project_beam(struct source origin, int len, struct loc finish, int dam,
+				  int typ, int flg, const struct object *obj)
+{
+	u64b trace_start = trace_begin();
+	struct loc path_grid[512];
+	struct project_area area;
+	struct loc start;
+
+	/* Flush any pending output */
+	handle_stuff(player);
+
+	area.num = 0;
+	flg &= ~(PROJECT_ARC);
+	flg |= PROJECT_BEAM;
+	start = project_start(origin, finish, &flg);
+	project_trace(start, finish, len, typ, flg, path_grid, &area);
+
+	return project_affect(origin, &area, len, dam, typ, flg, 0, obj,
+						  trace_start);
+}
+
+/**
+ * Project a ball, which travels to the end of its path (stopping short of
+ * walls) and explodes there with radius rad.
+ */
+bool project_ball(struct source origin, int rad, struct loc finish, int dam,
+				  int typ, int flg, byte diameter_of_source,
+				  const struct object *obj)
+{
+	u64b trace_start = trace_begin();
+	struct loc path_grid[512];
+	struct project_area area;
+	struct loc start;
+	int num_path_grids;
+
+	/* Flush any pending output */
+	handle_stuff(player);
+
+	area.num = 0;
+	flg &= ~(PROJECT_BEAM | PROJECT_ARC);
+	start = project_start(origin, finish, &flg);
+	num_path_grids = project_trace(start, finish, rad, typ, flg, path_grid,
+								   &area);
+	if (rad > 0) {
+		project_explode(start, &rad, flg, 0, path_grid, num_path_grids,
+						&area);
+		project_sort(&area, rad);
+	}
+
+	return project_affect(origin, &area, rad, dam, typ, flg,
+						  diameter_of_source, obj, trace_start);
+}
+
+/**
+ * Project an arc, which explodes from the caster within degrees_of_arc of
+ * the line towards finish.  An arc with no width is a beam of length rad.
+ */
+bool project_arc(struct source origin, int rad, struct loc finish, int dam,
+				 int typ, int flg, int degrees_of_arc,
+				 byte diameter_of_source, const struct object *obj)
+{
+	u64b trace_start;
+	struct loc path_grid[512];
+	struct project_area area;
+	struct loc start;
+	int num_path_grids;
+
+	if (degrees_of_arc == 0 && rad != 0)
+		return project_beam(origin, rad, finish, dam, typ, flg | PROJECT_THRU,
+							obj);
+
+	trace_start = trace_begin();
+
+	/* Flush any pending output */
+	handle_stuff(player);
+
+	area.num = 0;
+	flg &= ~(PROJECT_BEAM);
+	flg |= PROJECT_ARC;
+	start = project_start(origin, finish, &flg);
+	num_path_grids = project_trace(start, finish, rad, typ, flg, path_grid,
+								   &area);
+	if (rad > 0) {
+		project_explode(start, &rad, flg, degrees_of_arc, path_grid,
+						num_path_grids, &area);
+		project_sort(&area, rad);
+	}
+
+	return project_affect(origin, &area, rad, dam, typ, flg,
+						  diameter_of_source, obj, trace_start);
+}
+
+/**
+ * Make a projection, as described above, handing it on to the projection
+ * of its shape
+ */
+bool project(struct source origin, int rad, struct loc finish,
+			 int dam, int typ, int flg,
+			 int degrees_of_arc, byte diameter_of_source,
+			 const struct object *obj)
+{
+	if (flg & PROJECT_ARC)
+		return project_arc(origin, rad, finish, dam, typ, flg, degrees_of_arc,
+						   diameter_of_source, obj);
+	if (flg & PROJECT_BEAM)
+		return project_beam(origin, rad, finish, dam, typ, flg, obj);
+	if (rad > 0)
+		return project_ball(origin, rad, finish, dam, typ, flg,
+							diameter_of_source, obj);
+	return project_bolt(origin, finish, dam, typ, flg, obj);
+}
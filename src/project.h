@@ -113,6 +113,7 @@ bool project_p(struct source, int r, struct loc grid, int dam, int typ,
 int project_path(struct loc *gp, int range, struct loc grid1, struct loc grid2,
 				 int flg);
 bool projectable(struct chunk *c, struct loc grid1, struct loc grid2, int flg);
+bool projectable_to_player(struct chunk *c, struct loc grid);
 int proj_name_to_idx(const char *name);
 const char *proj_idx_to_name(int type);
 
@@ -121,5 +122,15 @@ struct loc origin_get_loc(struct source origin);
 bool project(struct source origin, int rad, struct loc finish, int dam, int typ,
 			 int flg, int degrees_of_arc, byte diameter_of_source,
 			 const struct object *obj);
+bool project_bolt(struct source origin, struct loc finish, int dam, int typ,
+				  int flg, const struct object *obj);
+bool project_beam(struct source origin, int len, struct loc finish, int dam,
+				  int typ, int flg, const struct object *obj);
+bool project_ball(struct source origin, int rad, struct loc finish, int dam,
+				  int typ, int flg, byte diameter_of_source,
+				  const struct object *obj);
+bool project_arc(struct source origin, int rad, struct loc finish, int dam,
+				 int typ, int flg, int degrees_of_arc,
+				 byte diameter_of_source, const struct object *obj);
 
 #endif /* !PROJECT_H */
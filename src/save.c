@@ -23,8 +23,10 @@
 #include "mon-group.h"
 #include "mon-lore.h"
 #include "mon-make.h"
+#include "mon-move.h"
 #include "monster.h"
 #include "object.h"
+#include "obj-curse.h"
 #include "obj-desc.h"
 #include "obj-knowledge.h"
 #include "obj-pile.h"
@@ -132,8 +134,7 @@ static void wr_item(const struct object *obj)
 	}
 	wr_byte(obj->notice);
 
-	for (i = 0; i < OF_SIZE; i++)
-		wr_byte(obj->flags[i]);
+	wr_bytes(obj->flags, OF_SIZE);
 
 	for (i = 0; i < OBJ_MOD_MAX; i++) {
 		wr_s16b(obj->modifiers[i]);
@@ -161,10 +162,17 @@ static void wr_item(const struct object *obj)
 
 	/* Write curses if any */
 	if (obj->curses) {
+		const struct curse_data *c = obj->curses;
 		wr_byte(1);
 		for (i = 0; i < z_info->curse_max; i++) {
-			wr_byte(obj->curses[i].power);
-			wr_u16b(obj->curses[i].timeout);
+			if (c < obj->curses + obj->num_curses && c->index == (int) i) {
+				wr_byte(c->power);
+				wr_u16b(c->timeout);
+				c++;
+			} else {
+				wr_byte(0);
+				wr_u16b(0);
+			}
 		}
 	} else {
 		wr_byte(0);
@@ -224,11 +232,8 @@ static void wr_monster(const struct monster *mon)
 	for (j = 0; j < MON_TMD_MAX; j++)
 		wr_s16b(mon->m_timed[j]);
 
-	for (j = 0; j < MFLAG_SIZE; j++)
-		wr_byte(mon->mflag[j]);
-
-	for (j = 0; j < OF_SIZE; j++)
-		wr_byte(mon->known_pstate.flags[j]);
+	wr_bytes(mon->mflag, MFLAG_SIZE);
+	wr_bytes(mon->known_pstate.flags, OF_SIZE);
 
 	for (j = 0; j < ELEM_MAX; j++)
 		wr_s16b(mon->known_pstate.el_info[j].res_level);
@@ -259,8 +264,6 @@ static void wr_monster(const struct monster *mon)
  */
 static void wr_trap(struct trap *trap)
 {
-	size_t i;
-
 	if (trap->t_idx) {
 		wr_string(trap_info[trap->t_idx].desc);
 	} else {
@@ -271,8 +274,7 @@ static void wr_trap(struct trap *trap)
 	wr_byte(trap->power);
 	wr_byte(trap->timeout);
 
-	for (i = 0; i < TRF_SIZE; i++)
-		wr_byte(trap->flags[i]);
+	wr_bytes(trap->flags, TRF_SIZE);
 }
 
 /**
@@ -290,16 +292,16 @@ void wr_randomizer(void)
 	wr_u32b(Rand_value);
 
 	/* state index */
-	wr_u32b(state_i);
+	wr_u32b(Rand_default.state_i);
 
-	/* RNG variables */
-	wr_u32b(z0);
-	wr_u32b(z1);
-	wr_u32b(z2);
+	/* RNG variables, no longer kept */
+	wr_u32b(0);
+	wr_u32b(0);
+	wr_u32b(0);
 
 	/* RNG state */
 	for (i = 0; i < RAND_DEG; i++)
-		wr_u32b(STATE[i]);
+		wr_u32b(Rand_default.state[i]);
 
 	/* NULL padding */
 	for (i = 0; i < 59 - RAND_DEG; i++)
@@ -623,8 +625,7 @@ void wr_misc(void)
 	//	return;
 
 	/* Flags */
-	for (i = 0; i < OF_SIZE; i++)
-		wr_byte(player->obj_k->flags[i]);
+	wr_bytes(player->obj_k->flags, OF_SIZE);
 
 	/* Modifiers */
 	for (i = 0; i < OBJ_MOD_MAX; i++) {
@@ -649,7 +650,7 @@ void wr_misc(void)
 
 	/* Curses */
 	for (i = 0; i < z_info->curse_max; i++) {
-		wr_byte(player->obj_k->curses[i].power ? 1 : 0);
+		wr_byte(object_curse_power(player->obj_k, i) ? 1 : 0);
 	}
 
 	/* Combat data */
@@ -744,6 +745,9 @@ void wr_stores(void)
 		/* Save the current owner */
 		wr_byte(store->owner->oidx);
 
+		/* Save the owed maintenance */
+		wr_u16b(store->maint_days);
+
 		/* Save the stock size */
 		wr_byte(store->stock_num);
 
@@ -760,7 +764,7 @@ void wr_stores(void)
 /**
  * Write the current dungeon terrain features and info flags
  *
- * Note that the cost and when fields of c->squares[y][x] are not saved
+ * Note that the cost and when fields of the chunk grid arrays are not saved
  */
 static void wr_dungeon_aux(struct chunk *c)
 {
@@ -777,7 +781,7 @@ static void wr_dungeon_aux(struct chunk *c)
 	wr_u16b(c->height);
 	wr_u16b(c->width);
 
-	/* Run length encoding of c->squares[y][x].info */
+	/* Run length encoding of c->info */
 	for (i = 0; i < SQUARE_SIZE; i++) {
 		count = 0;
 		prev_char = 0;
@@ -785,7 +789,7 @@ static void wr_dungeon_aux(struct chunk *c)
 		/* Dump for each grid */
 		for (y = 0; y < c->height; y++) {
 			for (x = 0; x < c->width; x++) {
-				/* Extract the important c->squares[y][x].info flags */
+				/* Extract the important c->info flags */
 				tmp8u = square(c, loc(x, y)).info[i];
 
 				/* If the run is broken, or too full, flush it */
@@ -910,6 +914,10 @@ static void wr_monsters_aux(struct chunk *c)
 	if (player->is_dead)
 		return;
 
+	/* Bring stored energy up to date */
+	if (c == cave)
+		monster_schedule_reset(c);
+
 	/* Total monsters */
 	wr_u16b(cave_monster_max(c));
 
@@ -986,8 +994,65 @@ void wr_traps(void)
 	wr_traps_aux(player->cave);
 }
 
+/**
+ * Write one chunk from the chunk list, and keep what was written
+ */
+static void wr_chunk_aux(struct chunk *c)
+{
+	u32b mark = wr_mark();
+	u16b *counts = mem_zalloc(z_info->r_max * sizeof(u16b));
+	int i, num = 0;
+
+	/* Write how many of each race there are first, so they can be counted
+	 * without reading the rest */
+	for (i = 1; i < cave_monster_max(c); i++) {
+		struct monster *mon = cave_monster(c, i);
+		if (mon->race && !counts[mon->race->ridx]++) num++;
+	}
+	wr_u16b(num);
+	for (i = 0; i < z_info->r_max; i++) {
+		if (!counts[i]) continue;
+		wr_u16b(i);
+		wr_u16b(counts[i]);
+	}
+	mem_free(counts);
+
+	/* Write the terrain and info */
+	cave_unpack(c);
+	wr_dungeon_aux(c);
+
+	/* Write the objects */
+	wr_objects_aux(c);
+
+	/* Write the monsters */
+	wr_monsters_aux(c);
+
+	/* Write the traps */
+	wr_traps_aux(c);
+
+	/* Write other chunk info */
+	if (OPT(player, birth_levels_persist)) {
+		wr_string(c->name);
+		wr_s32b(c->turn);
+		wr_u16b(c->depth);
+		wr_byte(c->feeling);
+		wr_u32b(c->obj_rating);
+		wr_u32b(c->mon_rating);
+		wr_byte(c->good_item ? 1 : 0);
+		wr_u16b(c->height);
+		wr_u16b(c->width);
+		wr_u16b(c->feeling_squares);
+		for (i = 0; i < z_info->f_max + 1; i++) {
+			wr_u16b(c->feat_count[i]);
+		}
+	}
+	cave_pack(c);
+	c->saved = wr_take_from(mark, &c->saved_size);
+}
+
 /*
- * Write the chunk list
+ * Write the chunk list.  Each chunk starts with its name, depth and size,
+ * so that loading can leave it unread until it is wanted.
  */
 void wr_chunks(void)
 {
@@ -1002,36 +1067,15 @@ void wr_chunks(void)
 	for (j = 0; j < chunk_list_max; j++) {
 		struct chunk *c = chunk_list[j];
 
-		/* Write the terrain and info */
-		wr_dungeon_aux(c);
-
-		/* Write the objects */
-		wr_objects_aux(c);
-
-		/* Write the monsters */
-		wr_monsters_aux(c);
-
-		/* Write the traps */
-		wr_traps_aux(c);
-
-		/* Write other chunk info */
-		if (OPT(player, birth_levels_persist)) {
-			int i;
-
-			wr_string(c->name);
-			wr_s32b(c->turn);
-			wr_u16b(c->depth);
-			wr_byte(c->feeling);
-			wr_u32b(c->obj_rating);
-			wr_u32b(c->mon_rating);
-			wr_byte(c->good_item ? 1 : 0);
-			wr_u16b(c->height);
-			wr_u16b(c->width);
-			wr_u16b(c->feeling_squares);
-			for (i = 0; i < z_info->f_max + 1; i++) {
-				wr_u16b(c->feat_count[i]);
-			}
-		}
+		/* Chunks which have stayed on the list since they were last
+		 * written can't have changed */
+		if (!c->saved)
+			wr_chunk_aux(c);
+
+		wr_string(c->name);
+		wr_u16b(c->depth);
+		wr_u32b(c->saved_size);
+		wr_bytes(c->saved, c->saved_size);
 	}
 }
 
@@ -21,6 +21,14 @@
 #include "init.h"
 #include "savefile.h"
 
+/* Autosaves are written out by a second thread where there are threads;
+ * SETGID builds write on the game thread, as the file permissions are
+ * switched for the whole process */
+#if defined(HAVE_PTHREAD_H) && !defined(SETGID)
+# include <pthread.h>
+# define SAVE_IN_BACKGROUND
+#endif
+
 /**
  * The savefile code.
  *
@@ -30,10 +38,10 @@
  *
  * After that, each block has the format:
  * - 16-byte string giving the type of block
- * - 4-byte block version
+ * - 4-byte block version, the top byte saying how the block is packed
  * - 4-byte block size
  * - 4-byte block checksum
- * ... data ...
+ * ... data, packed or not ...
  * padding so that block is a multiple of 4 bytes
  *
  * The savefile deosn't contain the version number of that game that saved it;
@@ -85,9 +93,24 @@ typedef int (*loader_t)(void);
 struct blockheader {
 	char name[16];
 	u32b version;
+	u32b codec;
 	u32b size;
+	u32b check;
 };
 
+/**
+ * The top byte of a block's version says how the block is packed, which
+ * is always 0 in savefiles from before blocks were packed.  A packed block
+ * starts with its unpacked and packed sizes.
+ */
+#define BLOCK_CODEC_SHIFT	24
+#define BLOCK_CODEC_NONE	0
+#define BLOCK_CODEC_LZ		1
+#define BLOCK_PACKED_HEAD	8
+
+/* Blocks smaller than this aren't worth packing */
+#define BLOCK_PACK_MIN		64
+
 struct blockinfo {
 	char name[16];
 	loader_t loader;
@@ -102,6 +125,8 @@ static const struct {
 	void (*save)(void);
 	u32b version;	
 } savers[] = {
+	/* Always first and never packed, so savefile_get_description() finds it
+	 * straight after the file header */
 	{ "description", wr_description, 1 },
 	{ "rng", wr_randomizer, 1 },
 	{ "options", wr_options, 1 },
@@ -116,12 +141,12 @@ static const struct {
 	{ "player hp", wr_player_hp, 1 },
 	{ "player spells", wr_player_spells, 1 },
 	{ "gear", wr_gear, 1 },
-	{ "stores", wr_stores, 1 },
+	{ "stores", wr_stores, 2 },
 	{ "dungeon", wr_dungeon, 1 },
 	{ "objects", wr_objects, 1 },
 	{ "monsters", wr_monsters, 1 },
 	{ "traps", wr_traps, 1 },
-	{ "chunks", wr_chunks, 1 },
+	{ "chunks", wr_chunks, 2 },
 	{ "history", wr_history, 1 },
 };
 
@@ -143,12 +168,14 @@ static const struct blockinfo loaders[] = {
 	{ "player hp", rd_player_hp, 1 },
 	{ "player spells", rd_player_spells, 1 },
 	{ "gear", rd_gear, 1 },	
-	{ "stores", rd_stores, 1 },	
+	{ "stores", rd_stores_1, 1 },
+	{ "stores", rd_stores, 2 },
 	{ "dungeon", rd_dungeon, 1 },
 	{ "objects", rd_objects, 1 },	
 	{ "monsters", rd_monsters, 1 },
 	{ "traps", rd_traps, 1 },
-	{ "chunks", rd_chunks, 1 },
+	{ "chunks", rd_chunks_1, 1 },
+	{ "chunks", rd_chunks, 2 },
 	{ "history", rd_history, 1 },
 };
 
@@ -160,10 +187,19 @@ static u32b buffer_pos;
 static u32b buffer_check;
 
 #define BUFFER_INITIAL_SIZE		1024
-#define BUFFER_BLOCK_INCREMENT	1024
 
 #define SAVEFILE_HEAD_SIZE		28
 
+#define PUT_U32B(p, v) \
+	(p)[0] = ((v) & 0xFF); \
+	(p)[1] = (((v) >> 8) & 0xFF); \
+	(p)[2] = (((v) >> 16) & 0xFF); \
+	(p)[3] = (((v) >> 24) & 0xFF)
+
+#define GET_U32B(p) \
+	(((u32b) (p)[0]) | ((u32b) (p)[1] << 8) | ((u32b) (p)[2] << 16) | \
+	 ((u32b) (p)[3] << 24))
+
 
 /**
  * ------------------------------------------------------------------------
@@ -185,31 +221,70 @@ void note(const char *message)
  * Base put/get
  * ------------------------------------------------------------------------ */
 
-static void sf_put(byte v)
+/**
+ * Add up some bytes for the block checksum; four sums are kept so the loop
+ * can be vectorised
+ */
+static u32b sf_checksum(const byte *data, size_t n)
+{
+	u32b sum[4] = { 0, 0, 0, 0 };
+	size_t i;
+
+	for (i = 0; i + 4 <= n; i += 4) {
+		sum[0] += data[i];
+		sum[1] += data[i + 1];
+		sum[2] += data[i + 2];
+		sum[3] += data[i + 3];
+	}
+	for (; i < n; i++)
+		sum[0] += data[i];
+
+	return sum[0] + sum[1] + sum[2] + sum[3];
+}
+
+/**
+ * Make room for n more bytes in the buffer, doubling it as often as needed
+ */
+static byte *sf_reserve(size_t n)
 {
 	assert(buffer != NULL);
 	assert(buffer_size > 0);
 
-	if (buffer_size == buffer_pos)
-	{
-		buffer_size += BUFFER_BLOCK_INCREMENT;
+	if (buffer_pos + n > buffer_size) {
+		while (buffer_pos + n > buffer_size)
+			buffer_size *= 2;
 		buffer = mem_realloc(buffer, buffer_size);
 	}
 
-	assert(buffer_pos < buffer_size);
+	return buffer + buffer_pos;
+}
+
+/**
+ * Check there are n more bytes to read in the buffer
+ */
+static const byte *sf_take(size_t n)
+{
+	if ((buffer == NULL) || (buffer_size <= 0) || (buffer_pos > buffer_size) ||
+		(n > buffer_size - buffer_pos))
+		quit("Broken savefile - probably from a development version");
 
-	buffer[buffer_pos++] = v;
+	return buffer + buffer_pos;
+}
+
+static void sf_put(byte v)
+{
+	*sf_reserve(1) = v;
+	buffer_pos++;
 	buffer_check += v;
 }
 
 static byte sf_get(void)
 {
-	if ((buffer == NULL) || (buffer_size <= 0) || (buffer_pos >= buffer_size))
-		quit("Broken savefile - probably from a development version");
+	byte v = *sf_take(1);
 
-	buffer_check += buffer[buffer_pos];
-
-	return buffer[buffer_pos++];
+	buffer_pos++;
+	buffer_check += v;
+	return v;
 }
 
 
@@ -225,8 +300,12 @@ void wr_byte(byte v)
 
 void wr_u16b(u16b v)
 {
-	sf_put((byte)(v & 0xFF));
-	sf_put((byte)((v >> 8) & 0xFF));
+	byte *p = sf_reserve(2);
+
+	p[0] = (byte)(v & 0xFF);
+	p[1] = (byte)((v >> 8) & 0xFF);
+	buffer_pos += 2;
+	buffer_check += p[0] + p[1];
 }
 
 void wr_s16b(s16b v)
@@ -236,10 +315,14 @@ void wr_s16b(s16b v)
 
 void wr_u32b(u32b v)
 {
-	sf_put((byte)(v & 0xFF));
-	sf_put((byte)((v >> 8) & 0xFF));
-	sf_put((byte)((v >> 16) & 0xFF));
-	sf_put((byte)((v >> 24) & 0xFF));
+	byte *p = sf_reserve(4);
+
+	p[0] = (byte)(v & 0xFF);
+	p[1] = (byte)((v >> 8) & 0xFF);
+	p[2] = (byte)((v >> 16) & 0xFF);
+	p[3] = (byte)((v >> 24) & 0xFF);
+	buffer_pos += 4;
+	buffer_check += p[0] + p[1] + p[2] + p[3];
 }
 
 void wr_s32b(s32b v)
@@ -249,12 +332,40 @@ void wr_s32b(s32b v)
 
 void wr_string(const char *str)
 {
-	while (*str)
-	{
-		wr_byte(*str);
-		str++;
-	}
-	wr_byte(*str);
+	wr_bytes((const byte *)str, strlen(str) + 1);
+}
+
+void wr_bytes(const byte *data, size_t n)
+{
+	if (!n) return;
+	memcpy(sf_reserve(n), data, n);
+	buffer_pos += n;
+	buffer_check += sf_checksum(data, n);
+}
+
+/**
+ * How far the block being written has got, for wr_take_from()
+ */
+u32b wr_mark(void)
+{
+	return buffer_pos;
+}
+
+/**
+ * Take back what has been written to the block since wr_mark() gave mark,
+ * returning a copy of it to be written later with wr_bytes()
+ */
+byte *wr_take_from(u32b mark, u32b *size)
+{
+	byte *copy;
+
+	assert(mark <= buffer_pos);
+	*size = buffer_pos - mark;
+	copy = mem_alloc(MAX(*size, 1));
+	memcpy(copy, buffer + mark, *size);
+	buffer_pos = mark;
+	buffer_check -= sf_checksum(copy, *size);
+	return copy;
 }
 
 
@@ -265,8 +376,12 @@ void rd_byte(byte *ip)
 
 void rd_u16b(u16b *ip)
 {
-	(*ip) = sf_get();
-	(*ip) |= ((u16b)(sf_get()) << 8);
+	const byte *p = sf_take(2);
+
+	(*ip) = p[0];
+	(*ip) |= ((u16b)(p[1]) << 8);
+	buffer_pos += 2;
+	buffer_check += p[0] + p[1];
 }
 
 void rd_s16b(s16b *ip)
@@ -276,10 +391,14 @@ void rd_s16b(s16b *ip)
 
 void rd_u32b(u32b *ip)
 {
-	(*ip) = sf_get();
-	(*ip) |= ((u32b)(sf_get()) << 8);
-	(*ip) |= ((u32b)(sf_get()) << 16);
-	(*ip) |= ((u32b)(sf_get()) << 24);
+	const byte *p = sf_take(4);
+
+	(*ip) = p[0];
+	(*ip) |= ((u32b)(p[1]) << 8);
+	(*ip) |= ((u32b)(p[2]) << 16);
+	(*ip) |= ((u32b)(p[3]) << 24);
+	buffer_pos += 4;
+	buffer_check += p[0] + p[1] + p[2] + p[3];
 }
 
 void rd_s32b(s32b *ip)
@@ -289,30 +408,221 @@ void rd_s32b(s32b *ip)
 
 void rd_string(char *str, int max)
 {
-	byte tmp8u;
-	int i = 0;
-
-	do {
-		rd_byte(&tmp8u);
+	const byte *p = sf_take(0);
+	const byte *end = memchr(p, 0, buffer_size - buffer_pos);
+	size_t len;
 
-		if (i < max) str[i] = tmp8u;
-		if (!tmp8u) break;
-	} while (++i);
+	if (!end)
+		quit("Broken savefile - probably from a development version");
+	len = end - p + 1;
 
+	memcpy(str, p, MIN(len, (size_t) max));
 	str[max - 1] = '\0';
+	buffer_pos += len;
+	buffer_check += sf_checksum(p, len);
+}
+
+void rd_bytes(byte *data, size_t n)
+{
+	const byte *p = sf_take(n);
+
+	if (!n) return;
+	memcpy(data, p, n);
+	buffer_pos += n;
+	buffer_check += sf_checksum(p, n);
+}
+
+/**
+ * Run a reader over some bytes kept from a savefile, instead of the block
+ * being loaded; the block being loaded, if there is one, carries on after
+ */
+int rd_saved(const byte *data, u32b size, int (*reader)(void))
+{
+	byte *old_buffer = buffer;
+	u32b old_size = buffer_size, old_pos = buffer_pos, old_check = buffer_check;
+	int result;
+
+	buffer = (byte *) data;
+	buffer_size = size;
+	buffer_pos = 0;
+	buffer_check = 0;
+	result = reader();
+
+	buffer = old_buffer;
+	buffer_size = old_size;
+	buffer_pos = old_pos;
+	buffer_check = old_check;
+	return result;
 }
 
 void strip_bytes(int n)
 {
-	byte tmp8u;
-	while (n--) rd_byte(&tmp8u);
+	const byte *p = sf_take(n);
+
+	buffer_pos += n;
+	buffer_check += sf_checksum(p, n);
 }
 
 void pad_bytes(int n)
 {
-	while (n--) wr_byte(0);
+	memset(sf_reserve(n), 0, n);
+	buffer_pos += n;
+}
+
+
+/**
+ * ------------------------------------------------------------------------
+ * Block packing
+ * ------------------------------------------------------------------------ */
+
+/**
+ * Blocks are packed with a small LZ77 scheme laid out like LZ4: each
+ * sequence is a token byte, holding the literal count in the high nibble
+ * and the match length less LZ_MIN_MATCH in the low one, then any more of
+ * the literal count, the literals, a two-byte offset back to the match and
+ * any more of the match length.  Counts of 15 or more carry on in bytes of
+ * 255, ending with one less.  The last sequence is literals only.
+ */
+#define LZ_HASH_BITS	12
+#define LZ_MIN_MATCH	4
+#define LZ_MAX_OFFSET	65535
+
+static u32b lz_hash(const byte *p)
+{
+	u32b v = p[0] | (p[1] << 8) | (p[2] << 16) | ((u32b)p[3] << 24);
+	return (v * 2654435761u) >> (32 - LZ_HASH_BITS);
+}
+
+static bool lz_put_count(byte **op, const byte *op_end, u32b count)
+{
+	while (count >= 255) {
+		if (*op >= op_end) return false;
+		*(*op)++ = 255;
+		count -= 255;
+	}
+	if (*op >= op_end) return false;
+	*(*op)++ = (byte) count;
+	return true;
+}
+
+static bool lz_get_count(const byte **ip, const byte *ip_end, u32b *count)
+{
+	byte b;
+
+	do {
+		if (*ip >= ip_end) return false;
+		b = *(*ip)++;
+		*count += b;
+	} while (b == 255);
+	return true;
+}
+
+/**
+ * Put one sequence out; a match length of 0 makes it the last one
+ */
+static bool lz_put_sequence(byte **op, const byte *op_end, const byte *lits,
+							u32b num_lits, u32b len, u32b offset)
+{
+	u32b extra = len ? len - LZ_MIN_MATCH : 0;
+
+	if (*op >= op_end) return false;
+	*(*op)++ = (MIN(num_lits, 15) << 4) | MIN(extra, 15);
+	if (num_lits >= 15 && !lz_put_count(op, op_end, num_lits - 15))
+		return false;
+	if (num_lits > (u32b)(op_end - *op)) return false;
+	memcpy(*op, lits, num_lits);
+	*op += num_lits;
+
+	if (!len) return true;
+	if (op_end - *op < 2) return false;
+	*(*op)++ = offset & 0xFF;
+	*(*op)++ = (offset >> 8) & 0xFF;
+	if (extra >= 15 && !lz_put_count(op, op_end, extra - 15))
+		return false;
+	return true;
 }
 
+/**
+ * Pack n bytes into at most cap bytes; returns the packed length, or 0 if
+ * it didn't fit
+ */
+static u32b lz_pack(const byte *src, u32b n, byte *dst, u32b cap)
+{
+	u32b *table = mem_zalloc((1 << LZ_HASH_BITS) * sizeof(u32b));
+	const byte *ip = src, *anchor = src, *end = src + n;
+	byte *op = dst, *op_end = dst + cap;
+	bool fits = true;
+
+	while (fits && ip + LZ_MIN_MATCH <= end) {
+		u32b h = lz_hash(ip);
+		u32b here = ip - src + 1, cand = table[h];
+
+		/* Positions in the table are one on, so 0 is empty */
+		table[h] = here;
+		if (cand && here - cand <= LZ_MAX_OFFSET &&
+			!memcmp(src + cand - 1, ip, LZ_MIN_MATCH)) {
+			const byte *match = src + cand - 1;
+			u32b len = LZ_MIN_MATCH;
+
+			while (ip + len < end && match[len] == ip[len])
+				len++;
+			fits = lz_put_sequence(&op, op_end, anchor, ip - anchor, len,
+								   ip - match);
+			ip += len;
+			anchor = ip;
+		} else {
+			ip++;
+		}
+	}
+	if (fits)
+		fits = lz_put_sequence(&op, op_end, anchor, end - anchor, 0, 0);
+
+	mem_free(table);
+	return fits ? (u32b)(op - dst) : 0;
+}
+
+/**
+ * Unpack n bytes into exactly raw bytes; false if the data is broken
+ */
+static bool lz_unpack(const byte *src, u32b n, byte *dst, u32b raw)
+{
+	const byte *ip = src, *end = src + n;
+	byte *op = dst, *op_end = dst + raw;
+
+	while (ip < end) {
+		byte token = *ip++;
+		u32b num_lits = token >> 4, len = (token & 15) + LZ_MIN_MATCH;
+		u32b offset, i;
+		const byte *from;
+
+		if (num_lits == 15 && !lz_get_count(&ip, end, &num_lits))
+			return false;
+		if (num_lits > (u32b)(end - ip) || num_lits > (u32b)(op_end - op))
+			return false;
+		memcpy(op, ip, num_lits);
+		ip += num_lits;
+		op += num_lits;
+
+		/* The last sequence has no match */
+		if (ip == end) break;
+
+		if (end - ip < 2) return false;
+		offset = ip[0] | (ip[1] << 8);
+		ip += 2;
+		if ((token & 15) == 15 && !lz_get_count(&ip, end, &len))
+			return false;
+		if (!offset || offset > (u32b)(op - dst) || len > (u32b)(op_end - op))
+			return false;
+
+		/* Byte by byte, as the match may run into what it is making */
+		from = op - offset;
+		for (i = 0; i < len; i++)
+			op[i] = from[i];
+		op += len;
+	}
+
+	return op == op_end;
+}
 
 /**
  * ------------------------------------------------------------------------
@@ -320,20 +630,85 @@ void pad_bytes(int n)
  * ------------------------------------------------------------------------ */
 
 
-static bool try_save(ang_file *file)
+/**
+ * A save in progress: the whole savefile put together in memory, and the
+ * temporary file it is going to before it replaces the real one
+ */
+struct save_job {
+	byte *image;
+	u32b image_size;
+	ang_file *file;
+	char path[1024];
+	char new_savefile[1024];
+	char old_savefile[1024];
+	bool ok;
+};
+
+/**
+ * Add some bytes to the end of a savefile image, doubling it as needed
+ */
+static void image_append(struct save_job *job, u32b *alloc, const void *data,
+						 u32b n)
+{
+	if (job->image_size + n > *alloc) {
+		while (job->image_size + n > *alloc)
+			*alloc *= 2;
+		job->image = mem_realloc(job->image, *alloc);
+	}
+	memcpy(job->image + job->image_size, data, n);
+	job->image_size += n;
+}
+
+/**
+ * Run each of the savers, and put its block and the block header into the
+ * image of the savefile
+ */
+static void save_image(struct save_job *job)
 {
 	byte savefile_head[SAVEFILE_HEAD_SIZE];
+	u32b alloc = BUFFER_INITIAL_SIZE;
 	size_t i, pos;
+	byte *packed = NULL;
+	u32b packed_alloc = 0;
+
+	job->image = mem_alloc(alloc);
+	job->image_size = 0;
+	image_append(job, &alloc, savefile_magic, 4);
+	image_append(job, &alloc, savefile_name, 4);
 
 	/* Start off the buffer */
 	buffer = mem_alloc(BUFFER_INITIAL_SIZE);
 	buffer_size = BUFFER_INITIAL_SIZE;
 
 	for (i = 0; i < N_ELEMENTS(savers); i++) {
+		const byte *data;
+		u32b size, version = savers[i].version;
+
 		buffer_pos = 0;
 		buffer_check = 0;
 
 		savers[i].save();
+		data = buffer;
+		size = buffer_pos;
+
+		/* Pack the block if that makes it smaller */
+		if (i > 0 && buffer_pos >= BLOCK_PACK_MIN) {
+			u32b len;
+
+			if (packed_alloc < buffer_pos) {
+				packed_alloc = buffer_pos;
+				packed = mem_realloc(packed, packed_alloc);
+			}
+			len = lz_pack(buffer, buffer_pos, packed + BLOCK_PACKED_HEAD,
+						  buffer_pos - BLOCK_PACKED_HEAD);
+			if (len) {
+				PUT_U32B(packed, buffer_pos);
+				PUT_U32B(packed + 4, len);
+				data = packed;
+				size = len + BLOCK_PACKED_HEAD;
+				version |= BLOCK_CODEC_LZ << BLOCK_CODEC_SHIFT;
+			}
+		}
 
 		/* 16-byte block name */
 		pos = my_strcpy((char *)savefile_head,
@@ -348,148 +723,208 @@ static bool try_save(ang_file *file)
 		savefile_head[pos++] = ((v >> 16) & 0xFF); \
 		savefile_head[pos++] = ((v >> 24) & 0xFF);
 
-		SAVE_U32B(savers[i].version);
-		SAVE_U32B(buffer_pos);
+		SAVE_U32B(version);
+		SAVE_U32B(size);
 		SAVE_U32B(buffer_check);
 
 		assert(pos == SAVEFILE_HEAD_SIZE);
 
-		file_write(file, (char *)savefile_head, SAVEFILE_HEAD_SIZE);
-		file_write(file, (char *)buffer, buffer_pos);
+		image_append(job, &alloc, savefile_head, SAVEFILE_HEAD_SIZE);
+		image_append(job, &alloc, data, size);
 
 		/* pad to 4 byte multiples */
-		if (buffer_pos % 4)
-			file_write(file, "xxx", 4 - (buffer_pos % 4));
+		if (size % 4)
+			image_append(job, &alloc, "xxx", 4 - (size % 4));
 	}
 
+	mem_free(packed);
 	mem_free(buffer);
-
-	return true;
+	buffer = NULL;
 }
 
 /**
- * Attempt to save the player in a savefile
+ * Take everything that goes in the savefile, and open the temporary file
+ * it will be written to.  This is the part of saving which has to be done
+ * on the game thread.
  */
-bool savefile_save(const char *path)
+static bool save_job_start(struct save_job *job, const char *path)
 {
-	ang_file *file;
 	int count = 0;
-	char new_savefile[1024];
-	char old_savefile[1024];
+
+	memset(job, 0, sizeof(*job));
+	my_strcpy(job->path, path, sizeof(job->path));
 
 	/* New savefile */
-	strnfmt(old_savefile, sizeof(old_savefile), "%s%u.old", path,
+	strnfmt(job->old_savefile, sizeof(job->old_savefile), "%s%u.old", path,
 			Rand_simple(1000000));
-	while (file_exists(old_savefile) && (count++ < 100))
-		strnfmt(old_savefile, sizeof(old_savefile), "%s%u%u.old", path,
-				Rand_simple(1000000),count);
+	while (file_exists(job->old_savefile) && (count++ < 100))
+		strnfmt(job->old_savefile, sizeof(job->old_savefile), "%s%u%u.old",
+				path, Rand_simple(1000000), count);
 
 	count = 0;
 
 	/* Open the savefile */
 	safe_setuid_grab();
-	strnfmt(new_savefile, sizeof(new_savefile), "%s%u.new", path,
+	strnfmt(job->new_savefile, sizeof(job->new_savefile), "%s%u.new", path,
 			Rand_simple(1000000));
-	while (file_exists(new_savefile) && (count++ < 100))
-		strnfmt(new_savefile, sizeof(new_savefile), "%s%u%u.new", path,
-				Rand_simple(1000000),count);
+	while (file_exists(job->new_savefile) && (count++ < 100))
+		strnfmt(job->new_savefile, sizeof(job->new_savefile), "%s%u%u.new",
+				path, Rand_simple(1000000), count);
 
-	file = file_open(new_savefile, MODE_WRITE, FTYPE_SAVE);
+	job->file = file_open(job->new_savefile, MODE_WRITE, FTYPE_SAVE);
 	safe_setuid_drop();
+	if (!job->file) return false;
 
-	if (file) {
-		file_write(file, (char *) &savefile_magic, 4);
-		file_write(file, (char *) &savefile_name, 4);
+	save_image(job);
+	return true;
+}
 
-		character_saved = try_save(file);
-		file_close(file);
+/**
+ * Write the savefile out and move it into place.  This allocates nothing,
+ * so it can be done away from the game thread.
+ */
+static void save_job_write(struct save_job *job)
+{
+	bool err = false;
+
+	if (!file_write(job->file, (char *)job->image, job->image_size) ||
+		!file_flush(job->file)) {
+		job->ok = false;
+		return;
 	}
 
-	if (character_saved) {
-		bool err = false;
+	safe_setuid_grab();
 
-		safe_setuid_grab();
+	if (file_exists(job->path) && !file_move(job->path, job->old_savefile))
+		err = true;
 
-		if (file_exists(path) && !file_move(path, old_savefile))
+	if (!err) {
+		if (!file_move(job->new_savefile, job->path))
 			err = true;
 
-		if (!err) {
-			if (!file_move(new_savefile, path))
-				err = true;
+		if (err)
+			file_move(job->old_savefile, job->path);
+		else
+			file_delete(job->old_savefile);
+	}
 
-			if (err)
-				file_move(old_savefile, path);
-			else
-				file_delete(old_savefile);
-		} 
+	safe_setuid_drop();
 
-		safe_setuid_drop();
+	job->ok = !err;
+}
 
-		return err ? false : true;
-	}
+/**
+ * Tidy up after a save, on the game thread
+ */
+static bool save_job_finish(struct save_job *job)
+{
+	file_close(job->file);
 
 	/* Delete temp file if the save failed */
-	if (file) {
-		/* File is no longer valid, but it still points to a non zero
-		 * value if the file was created above */
+	if (!job->ok) {
 		safe_setuid_grab();
-		file_delete(new_savefile);
+		file_delete(job->new_savefile);
 		safe_setuid_drop();
 	}
-	return false;
+
+	mem_free(job->image);
+	job->image = NULL;
+	character_saved = job->ok;
+	return job->ok;
 }
 
+#ifdef SAVE_IN_BACKGROUND
+static struct save_job background_job;
+static pthread_t background_thread;
+static bool background_running;
 
+static void *save_job_run(void *arg)
+{
+	save_job_write(arg);
+	return NULL;
+}
+#endif
 
 /**
- * ------------------------------------------------------------------------
- * Savefile loading functions
- * ------------------------------------------------------------------------ */
+ * Wait for any save still being written in the background.  Returns false
+ * if that save failed, true otherwise.
+ */
+bool savefile_finish(void)
+{
+#ifdef SAVE_IN_BACKGROUND
+	if (background_running) {
+		pthread_join(background_thread, NULL);
+		background_running = false;
+		return save_job_finish(&background_job);
+	}
+#endif
+	return true;
+}
 
 /**
- * Check the savefile header file clearly inicates that it's a savefile
+ * Save the game to the given location, waiting until it is on disk
  */
-static bool check_header(ang_file *f) {
-	byte head[8];
-
-	if (file_read(f, (char *) &head, 8) == 8 &&
-			memcmp(&head[0], savefile_magic, 4) == 0 &&
-			memcmp(&head[4], savefile_name, 4) == 0)
-		return true;
+bool savefile_save(const char *path)
+{
+	struct save_job job;
 
-	return false;
+	savefile_finish();
+	if (!save_job_start(&job, path)) return false;
+	save_job_write(&job);
+	return save_job_finish(&job);
 }
 
 /**
- * Get the next block header from the savefile
+ * Save the game to the given location, leaving the writing to be done in
+ * the background where threads are available
  */
-static errr next_blockheader(ang_file *f, struct blockheader *b) {
-	byte savefile_head[SAVEFILE_HEAD_SIZE];
-	size_t len;
+bool savefile_save_background(const char *path)
+{
+#ifdef SAVE_IN_BACKGROUND
+	savefile_finish();
+	if (!save_job_start(&background_job, path)) return false;
+	if (!pthread_create(&background_thread, NULL, save_job_run,
+						&background_job)) {
+		background_running = true;
+		return true;
+	}
 
-	len = file_read(f, (char *)savefile_head, SAVEFILE_HEAD_SIZE);
-	if (len == 0) /* no more blocks */
-		return 1;
+	/* No thread, so write it now */
+	save_job_write(&background_job);
+	return save_job_finish(&background_job);
+#else
+	return savefile_save(path);
+#endif
+}
 
-	if (len != SAVEFILE_HEAD_SIZE || savefile_head[15] != 0) {
-		return -1;
-	}
 
-#define RECONSTRUCT_U32B(from) \
-	((u32b) savefile_head[from]) | \
-	((u32b) savefile_head[from+1] << 8) | \
-	((u32b) savefile_head[from+2] << 16) | \
-	((u32b) savefile_head[from+3] << 24);
 
-	my_strcpy(b->name, (char *)&savefile_head, sizeof b->name);
-	b->version = RECONSTRUCT_U32B(16);
-	b->size = RECONSTRUCT_U32B(20);
+/**
+ * ------------------------------------------------------------------------
+ * Savefile loading functions
+ * ------------------------------------------------------------------------ */
 
-	/* Pad to 4 bytes */
-	if (b->size % 4)
-		b->size += 4 - (b->size % 4);
+/**
+ * Check the savefile header file clearly inicates that it's a savefile
+ */
+static bool check_header(const byte *head) {
+	return memcmp(&head[0], savefile_magic, 4) == 0 &&
+		memcmp(&head[4], savefile_name, 4) == 0;
+}
 
-	return 0;
+/**
+ * Read a block header; the size is what the block takes, without padding
+ */
+static bool read_blockheader(const byte *head, struct blockheader *b) {
+	if (head[15] != 0) return false;
+
+	my_strcpy(b->name, (const char *) head, sizeof b->name);
+	b->version = GET_U32B(head + 16);
+	b->codec = b->version >> BLOCK_CODEC_SHIFT;
+	b->version &= (1 << BLOCK_CODEC_SHIFT) - 1;
+	b->size = GET_U32B(head + 20);
+	b->check = GET_U32B(head + 24);
+	return true;
 }
 
 /**
@@ -512,65 +947,127 @@ static loader_t find_loader(struct blockheader *b,
 }
 
 /**
- * Load a given block with the given loader
+ * Unpack a block into a new allocation, if it was packed
  */
-static bool load_block(ang_file *f, struct blockheader *b, loader_t loader)
+static bool unpack_block(struct blockheader *b, const byte *data,
+						 byte **raw, u32b *raw_size)
 {
-	/* Allocate space for the buffer */
-	buffer = mem_alloc(b->size);
-	buffer_pos = 0;
-	buffer_check = 0;
+	u32b len;
 
-	buffer_size = file_read(f, (char *) buffer, b->size);
-	if (buffer_size != b->size ||
-			loader() != 0) {
-		mem_free(buffer);
+	*raw = NULL;
+	if (b->codec == BLOCK_CODEC_NONE) return true;
+	if (b->codec != BLOCK_CODEC_LZ || b->size < BLOCK_PACKED_HEAD)
 		return false;
-	}
 
-	mem_free(buffer);
+	*raw_size = GET_U32B(data);
+	len = GET_U32B(data + 4);
+	if (len > b->size - BLOCK_PACKED_HEAD || !*raw_size) return false;
+
+	/* No sequence makes more than 255 bytes for each one it takes */
+	if (*raw_size / 255 > len) return false;
+
+	*raw = mem_alloc(*raw_size);
+	if (!lz_unpack(data + BLOCK_PACKED_HEAD, len, *raw, *raw_size)) {
+		mem_free(*raw);
+		*raw = NULL;
+		return false;
+	}
 	return true;
 }
 
 /**
- * Skip a block
+ * Load a given block, whose data is where it lies in the savefile, with the
+ * given loader; only packed blocks need copying, to unpack them
+ */
+static bool load_block(struct blockheader *b, const byte *data,
+					   loader_t loader)
+{
+	byte *raw;
+	u32b raw_size;
+	bool ok;
+
+	if (!unpack_block(b, data, &raw, &raw_size)) return false;
+
+	buffer = raw ? raw : (byte *) data;
+	buffer_size = raw ? raw_size : b->size;
+	buffer_pos = 0;
+	buffer_check = 0;
+
+	/* The checksum is of the unpacked data, checked before it is used */
+	ok = sf_checksum(buffer, buffer_size) == b->check && loader() == 0;
+
+	mem_free(raw);
+	buffer = NULL;
+	return ok;
+}
+
+/**
+ * Read the whole of a savefile into memory
  */
-static void skip_block(ang_file *f, struct blockheader *b)
+static byte *read_image(ang_file *f, u32b *size)
 {
-	file_skip(f, b->size);
+	u32b alloc = BUFFER_INITIAL_SIZE;
+	byte *image = mem_alloc(alloc);
+	int len;
+
+	*size = 0;
+	while ((len = file_read(f, (char *) image + *size, alloc - *size)) > 0) {
+		*size += len;
+		if (*size == alloc) {
+			alloc *= 2;
+			image = mem_realloc(image, alloc);
+		}
+	}
+
+	if (len < 0) {
+		mem_free(image);
+		return NULL;
+	}
+	return image;
 }
 
 /**
- * Try to load a savefile
+ * Try to load a savefile image, each block being read where it lies
  */
-static bool try_load(ang_file *f, const struct blockinfo *local_loaders)
+static bool try_load(const byte *image, u32b size,
+					 const struct blockinfo *local_loaders)
 {
 	struct blockheader b;
-	errr err;
+	u32b pos = 8;
 
-	if (!check_header(f)) {
+	if (size < 8 || !check_header(image)) {
 		note("Savefile is corrupted -- incorrect file header.");
 		return false;
 	}
 
 	/* Get the next block header */
-	while ((err = next_blockheader(f, &b)) == 0) {
-		loader_t loader = find_loader(&b, local_loaders);
+	while (pos < size) {
+		loader_t loader;
+
+		if (size - pos < SAVEFILE_HEAD_SIZE ||
+			!read_blockheader(image + pos, &b) ||
+			b.size > size - pos - SAVEFILE_HEAD_SIZE) {
+			note("Savefile is corrupted -- block header mangled.");
+			return false;
+		}
+		pos += SAVEFILE_HEAD_SIZE;
+
+		loader = find_loader(&b, local_loaders);
 		if (!loader) {
 			note("Savefile block can't be read.");
 			note("Maybe try and load the savefile in an earlier version of Angband.");
 			return false;
 		}
 
-		if (!load_block(f, &b, loader)) {
+		if (!load_block(&b, image + pos, loader)) {
 			note(format("Savefile corrupted - Couldn't load block %s", b.name));
 			return false;
 		}
-	}
 
-	if (err == -1) {
-		note("Savefile is corrupted -- block header mangled.");
-		return false;
+		/* Blocks are padded to 4 bytes */
+		pos += b.size;
+		if (b.size % 4)
+			pos += MIN(4 - (b.size % 4), size - pos);
 	}
 
 	return true;
@@ -586,9 +1083,15 @@ static int get_desc(void) {
 
 /**
  * Try to get the 'description' block from a savefile.  Fail gracefully.
+ *
+ * The description is the first block of every savefile, so only the file
+ * header and that block are read, however big the rest of the file is.
  */
 const char *savefile_get_description(const char *path) {
+	byte head[8 + SAVEFILE_HEAD_SIZE];
 	struct blockheader b;
+	byte *data;
+	bool ok = false;
 
 	ang_file *f = file_open(path, MODE_READ, FTYPE_TEXT);
 	if (!f) return NULL;
@@ -596,18 +1099,16 @@ const char *savefile_get_description(const char *path) {
 	/* Blank the description */
 	savefile_desc[0] = 0;
 
-	if (!check_header(f)) {
-		my_strcpy(savefile_desc, "Invalid savefile", sizeof savefile_desc);
-	} else {
-		while (!next_blockheader(f, &b)) {
-			if (!streq(b.name, "description")) {
-				skip_block(f, &b);
-				continue;
-			}
-			load_block(f, &b, get_desc);
-			break;
-		}
+	if (file_read(f, (char *) head, sizeof head) == sizeof head &&
+		check_header(head) && read_blockheader(head + 8, &b) &&
+		streq(b.name, "description")) {
+		data = mem_alloc(MAX(b.size, 1));
+		ok = file_read(f, (char *) data, b.size) == (int) b.size &&
+			load_block(&b, data, get_desc);
+		mem_free(data);
 	}
+	if (!ok)
+		my_strcpy(savefile_desc, "Invalid savefile", sizeof savefile_desc);
 
 	file_close(f);
 	return savefile_desc;
@@ -620,14 +1121,26 @@ const char *savefile_get_description(const char *path) {
 bool savefile_load(const char *path, bool cheat_death)
 {
 	bool ok;
-	ang_file *f = file_open(path, MODE_READ, FTYPE_TEXT);
+	ang_file *f;
+	byte *image;
+	u32b size;
+
+	savefile_finish();
+	f = file_open(path, MODE_READ, FTYPE_TEXT);
 	if (!f) {
 		note("Couldn't open savefile.");
 		return false;
 	}
 
-	ok = try_load(f, loaders);
+	image = read_image(f, &size);
 	file_close(f);
+	if (!image) {
+		note("Couldn't read savefile.");
+		return false;
+	}
+
+	ok = try_load(image, size, loaders);
+	mem_free(image);
 
 	if (player->chp < 0) {
 		player->is_dead = true;
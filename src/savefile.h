@@ -37,6 +37,17 @@ extern bool character_saved;
  */
 bool savefile_save(const char *path);
 
+/**
+ * Save to the given location, writing the file out in the background where
+ * that is possible.  Returns false if the save could not be started.
+ */
+bool savefile_save_background(const char *path);
+
+/**
+ * Wait for a background save to be written.  Returns false if it failed.
+ */
+bool savefile_finish(void);
+
 /**
  * Load the savefile given.  Returns true on succcess, false otherwise.
  */
@@ -64,6 +75,9 @@ void wr_s16b(s16b v);
 void wr_u32b(u32b v);
 void wr_s32b(s32b v);
 void wr_string(const char *str);
+void wr_bytes(const byte *data, size_t n);
+u32b wr_mark(void);
+byte *wr_take_from(u32b mark, u32b *size);
 void pad_bytes(int n);
 
 /* Reading bits */
@@ -73,6 +87,8 @@ void rd_s16b(s16b *ip);
 void rd_u32b(u32b *ip);
 void rd_s32b(s32b *ip);
 void rd_string(char *str, int max);
+void rd_bytes(byte *data, size_t n);
+int rd_saved(const byte *data, u32b size, int (*reader)(void));
 void strip_bytes(int n);
 
 
@@ -91,9 +107,12 @@ int rd_misc(void);
 int rd_player_hp(void);
 int rd_player_spells(void);
 int rd_gear(void);
+int rd_stores_1(void);
 int rd_stores(void);
 int rd_dungeon(void);
+int rd_chunks_1(void);
 int rd_chunks(void);
+struct chunk *rd_stored_chunk(struct chunk *c);
 int rd_objects(void);
 int rd_monsters(void);
 int rd_monster_groups(void);
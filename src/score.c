@@ -61,26 +61,29 @@ size_t highscore_read(high_score scores[], size_t sz)
 /**
  * Just determine where a new score *would* be placed
  * Return the location (0 is best) or -1 on failure
+ *
+ * The table is kept best first with the unused entries at the end, so the
+ * place is found by a binary search for the first entry the new score ties
+ * or beats.
  */
 size_t highscore_where(const high_score *entry, const high_score scores[],
 					   size_t sz)
 {
-	size_t i;
+	long entry_pts = strtoul(entry->pts, NULL, 0);
+	size_t lo = 0, hi = sz;
 
-	/* Read until we get to a higher score */
-	for (i = 0; i < sz; i++) {
-		long entry_pts = strtoul(entry->pts, NULL, 0);
-		long score_pts = strtoul(scores[i].pts, NULL, 0);
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
 
-		if (entry_pts >= score_pts)
-			return i;
-
-		if (scores[i].what[0] == '\0')
-			return i;
+		if (scores[mid].what[0] == '\0' ||
+			entry_pts >= (long) strtoul(scores[mid].pts, NULL, 0))
+			hi = mid;
+		else
+			lo = mid + 1;
 	}
 
 	/* The last entry is always usable */
-	return sz - 1;
+	return MIN(lo, sz - 1);
 }
 
 size_t highscore_add(const high_score *entry, high_score scores[], size_t sz)
@@ -106,48 +109,71 @@ static size_t highscore_count(const high_score scores[], size_t sz)
 
 
 /**
- * Actually place an entry into the high score file
- * Return the location (0 is best) or -1 on "failure"
+ * Lock the high score file against other players, returning the lock or
+ * NULL if it couldn't be had.
+ */
+static ang_file *highscore_lock(void)
+{
+	char lok_name[1024];
+	ang_file *lok;
+
+	path_build(lok_name, sizeof(lok_name), ANGBAND_DIR_SCORES, "scores.lok");
+
+	if (file_exists(lok_name)) {
+		msg("Lock file in place for scorefile; not writing.");
+		return NULL;
+	}
+
+	safe_setuid_grab();
+	lok = file_open(lok_name, MODE_WRITE, FTYPE_RAW);
+	if (lok)
+		file_lock(lok);
+	safe_setuid_drop();
+
+	if (!lok)
+		msg("Failed to create lock for scorefile; not writing.");
+
+	return lok;
+}
+
+/**
+ * Release a lock taken by highscore_lock().
+ */
+static void highscore_unlock(ang_file *lok)
+{
+	char lok_name[1024];
+
+	path_build(lok_name, sizeof(lok_name), ANGBAND_DIR_SCORES, "scores.lok");
+
+	safe_setuid_grab();
+	file_close(lok);
+	file_delete(lok_name);
+	safe_setuid_drop();
+}
+
+/**
+ * Actually place an entry into the high score file; the caller must hold
+ * the lock from highscore_lock()
  */
 static void highscore_write(const high_score scores[], size_t sz)
 {
 	size_t n;
 
-	ang_file *lok;
 	ang_file *scorefile;
 
 	char old_name[1024];
 	char cur_name[1024];
 	char new_name[1024];
-	char lok_name[1024];
 
 	path_build(old_name, sizeof(old_name), ANGBAND_DIR_SCORES, "scores.old");
 	path_build(cur_name, sizeof(cur_name), ANGBAND_DIR_SCORES, "scores.raw");
 	path_build(new_name, sizeof(new_name), ANGBAND_DIR_SCORES, "scores.new");
-	path_build(lok_name, sizeof(lok_name), ANGBAND_DIR_SCORES, "scores.lok");
 
 
 	/* Read in and add new score */
 	n = highscore_count(scores, sz);
 
 
-	/* Lock scores */
-	if (file_exists(lok_name)) {
-		msg("Lock file in place for scorefile; not writing.");
-		return;
-	}
-
-	safe_setuid_grab();
-	lok = file_open(lok_name, MODE_WRITE, FTYPE_RAW);
-	file_lock(lok);
-	safe_setuid_drop();
-
-	if (!lok) {
-		msg("Failed to create lock for scorefile; not writing.");
-		return;
-	}
-
-
 	/* Open the new file for writing */
 	safe_setuid_grab();
 	scorefile = file_open(new_name, MODE_WRITE, FTYPE_RAW);
@@ -155,9 +181,6 @@ static void highscore_write(const high_score scores[], size_t sz)
 
 	if (!scorefile) {
 		msg("Failed to open new scorefile for writing.");
-
-		file_close(lok);
-		file_delete(lok_name);
 		return;
 	}
 
@@ -176,10 +199,6 @@ static void highscore_write(const high_score scores[], size_t sz)
 	if (!file_move(new_name, cur_name))
 		msg("Couldn't rename new scorefile to scores.raw");
 
-	/* Remove the lock */
-	file_close(lok);
-	file_delete(lok_name);
-
 	safe_setuid_drop();
 }
 
@@ -263,12 +282,19 @@ void enter_score(time_t *death_time)
 	} else {
 		high_score entry;
 		high_score scores[MAX_HISCORES];
+		ang_file *lok;
 
 		build_score(&entry, player->died_from, death_time);
 
-		highscore_read(scores, N_ELEMENTS(scores));
-		highscore_add(&entry, scores, N_ELEMENTS(scores));
-		highscore_write(scores, N_ELEMENTS(scores));
+		/* Hold the lock from reading the scores to writing them, so that
+		 * another player's death in between isn't lost */
+		lok = highscore_lock();
+		if (lok) {
+			highscore_read(scores, N_ELEMENTS(scores));
+			highscore_add(&entry, scores, N_ELEMENTS(scores));
+			highscore_write(scores, N_ELEMENTS(scores));
+			highscore_unlock(lok);
+		}
 	}
 
 	/* Success */
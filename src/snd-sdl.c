@@ -119,21 +119,28 @@ static bool load_sample_sdl(const char *filename, int file_type, sdl_sample *sam
 /**
  * Load a sound and return a pointer to the associated SDL Sound data
  * structure back to the core sound module.
+ *
+ * This is called from the sound loader thread, so the sample is allocated
+ * with calloc() rather than through z-virt.
  */
 static bool load_sound_sdl(const char *filename, int file_type, struct sound_data *data)
 {
 	sdl_sample *sample = (sdl_sample *)(data->plat_data);
 
 	if (!sample)
-		sample = mem_zalloc(sizeof(*sample));
+		sample = calloc(1, sizeof(*sample));
+	if (!sample)
+		return false;
 
 	/* Try and load the sample file */
 	data->loaded = load_sample_sdl(filename, file_type, sample);
 
 	if (data->loaded) {
 		sample->sample_type = file_type;
+		data->size = (file_type == SDL_CHUNK) ?
+			sample->sample_data.chunk->alen : 0;
 	} else {
-		mem_free(sample);
+		free(sample);
 		sample = NULL;
 	}
 
@@ -194,7 +201,7 @@ static bool unload_sound_sdl(struct sound_data *data)
 				break;
 		}
 
-		mem_free(sample);
+		free(sample);
 		data->plat_data = NULL;
 		data->loaded = false;
 	}
@@ -237,6 +244,7 @@ errr init_sound_sdl(struct sound_hooks *hooks, int argc, char **argv)
 	hooks->load_sound_hook = load_sound_sdl;
 	hooks->unload_sound_hook = unload_sound_sdl;
 	hooks->play_sound_hook = play_sound_sdl;
+	hooks->load_in_background = true;
 
 	/* Success */
 	return (0);
@@ -28,6 +28,13 @@
 #include "snd-win.h"
 #endif
 
+/* Sounds are loaded by a second thread where there are threads and the
+ * platform's sound module can load off the game thread */
+#ifdef HAVE_PTHREAD_H
+# include <pthread.h>
+# define LOAD_IN_BACKGROUND
+#endif
+
 #define MAX_SOUNDS_PER_MESSAGE	16
 
 struct sound_module
@@ -84,6 +91,43 @@ static struct sound_hooks hooks;
  */
 static bool preload_sounds = false;
 
+/*
+ * Once loaded sounds hold more than this many bytes, the least recently
+ * played ones are unloaded again
+ */
+#define SOUND_CACHE_MAX	(32L * 1024L * 1024L)
+
+/* Sounds waiting for the loader thread */
+#define SOUND_QUEUE_MAX	256
+
+/* Values of sound_data.status */
+enum {
+	SOUND_IDLE = 0,
+	SOUND_QUEUED,
+	SOUND_UNREPORTED,	/* Failed to load, not yet logged */
+	SOUND_FAILED
+};
+
+static size_t sound_cache_used;
+static u32b sound_clock;
+static int sound_unreported;
+
+#ifdef LOAD_IN_BACKGROUND
+static pthread_mutex_t sound_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t sound_wake = PTHREAD_COND_INITIALIZER;
+static pthread_t sound_thread;
+static bool sound_thread_running;
+static bool sound_thread_stop;
+static u16b sound_queue[SOUND_QUEUE_MAX];
+static int sound_queue_head;
+static int sound_queue_len;
+# define sounds_lock()		pthread_mutex_lock(&sound_lock)
+# define sounds_unlock()	pthread_mutex_unlock(&sound_lock)
+#else
+# define sounds_lock()
+# define sounds_unlock()
+#endif
+
 static struct sound_data *grow_sound_list(void)
 {
 	int new_size;
@@ -113,15 +157,18 @@ static struct sound_data *grow_sound_list(void)
  * NOTE: The platform's sound module does not have to load the sound into
  * memory, it merely has to let us know that it can play the sound when
  * asked to.
+ *
+ * This may run on the loader thread, so it must not allocate through
+ * z-virt, which is only safe to use from the game thread.
  */
-static void load_sound(struct sound_data *sound_data)
+static bool load_sound_file(struct sound_data *sound_data)
 {
+	bool load_success = false;
+
 	if ((hooks.load_sound_hook) && (hooks.supported_files_hook)) {
 		char path[2048];
-		char *filename_buf;
-		size_t filename_buf_size;
+		char filename_buf[2048];
 		int i = 0;
-		bool load_success = false;
 
 		const struct sound_file_type *supported_sound_files = hooks.supported_files_hook();
 
@@ -133,26 +180,182 @@ static void load_sound(struct sound_data *sound_data)
 		 * platform's sound module.
 		 */
 		while ((0 != supported_sound_files[i].type) && (!load_success)) {
-			/*
-			 * Create a buffer to store the filename plus extension
-			 */
-			filename_buf_size = strlen(path) + strlen(supported_sound_files[i].extension) + 1;
-			filename_buf = mem_zalloc(filename_buf_size);
-			my_strcpy(filename_buf, path, filename_buf_size);
-			filename_buf = string_append(filename_buf, supported_sound_files[i].extension);
+			/* The filename plus extension */
+			my_strcpy(filename_buf, path, sizeof(filename_buf));
+			my_strcat(filename_buf, supported_sound_files[i].extension,
+					  sizeof(filename_buf));
 
 			if (file_exists(filename_buf))
 				load_success = hooks.load_sound_hook(filename_buf, supported_sound_files[i].type, sound_data);
 
-			mem_free(filename_buf);
 			i++;
 		}
+	}
+
+	return load_success;
+}
+
+/**
+ * Load a sound on the game thread, noting sounds that cannot be loaded so
+ * that they are not tried again every time they are played.  Must be called
+ * with the sounds locked.
+ */
+static void load_sound(struct sound_data *sound_data)
+{
+	if (load_sound_file(sound_data)) {
+		sound_cache_used += sound_data->size;
+	} else {
+		sound_data->status = SOUND_UNREPORTED;
+		sound_unreported++;
+	}
+}
+
+/**
+ * Log the sounds which have failed to load since this was last called, on
+ * the game thread and without the sounds locked, so that logging can't
+ * wait on the lock or come from the loader thread
+ */
+static void report_sound_failures(void)
+{
+	int i;
+
+	for (i = 0; i < next_sound_id; i++) {
+		bool failed;
+
+		sounds_lock();
+		if (!sound_unreported) {
+			sounds_unlock();
+			break;
+		}
+		failed = (sounds[i].status == SOUND_UNREPORTED);
+		if (failed) {
+			sounds[i].status = SOUND_FAILED;
+			sound_unreported--;
+		}
+		sounds_unlock();
+
+		if (failed)
+			plog_fmt("Failed to load sound '%s'", sounds[i].name);
+	}
+}
+
+/**
+ * Unload a sound, leaving it to be loaded again when next played
+ */
+static void unload_sound(struct sound_data *sound_data)
+{
+	sound_cache_used -= sound_data->size;
+	sound_data->size = 0;
+	if (hooks.unload_sound_hook)
+		hooks.unload_sound_hook(sound_data);
+}
+
+/**
+ * Unload the least recently played sounds, other than 'keep', until the
+ * loaded ones fit in SOUND_CACHE_MAX
+ */
+static void trim_sound_cache(int keep)
+{
+	while (sound_cache_used > SOUND_CACHE_MAX) {
+		int i, oldest = -1;
+
+		for (i = 0; i < next_sound_id; i++) {
+			if ((i == keep) || !sounds[i].loaded || !sounds[i].size)
+				continue;
+			if ((oldest < 0) || (sounds[i].last_used < sounds[oldest].last_used))
+				oldest = i;
+		}
+
+		if (oldest < 0)
+			break;
 
-		if (!load_success)
-			plog_fmt("Failed to load sound '%s'", sound_data->name);
+		unload_sound(&sounds[oldest]);
 	}
 }
 
+#ifdef LOAD_IN_BACKGROUND
+/**
+ * Load queued sounds until told to stop.  Each sound is loaded into a copy
+ * so that the lock is not held while the disk is read.
+ */
+static void *sound_thread_run(void *arg)
+{
+	struct sound_data sound_data;
+	u16b sound_id;
+	bool loaded;
+
+	sounds_lock();
+	while (!sound_thread_stop) {
+		if (!sound_queue_len) {
+			pthread_cond_wait(&sound_wake, &sound_lock);
+			continue;
+		}
+
+		sound_id = sound_queue[sound_queue_head];
+		sound_queue_head = (sound_queue_head + 1) % SOUND_QUEUE_MAX;
+		sound_queue_len--;
+		sound_data = sounds[sound_id];
+		sounds_unlock();
+
+		loaded = load_sound_file(&sound_data);
+
+		sounds_lock();
+		sounds[sound_id].loaded = sound_data.loaded;
+		sounds[sound_id].plat_data = sound_data.plat_data;
+		sounds[sound_id].size = sound_data.size;
+		sounds[sound_id].status = loaded ? SOUND_IDLE : SOUND_UNREPORTED;
+		if (loaded)
+			sound_cache_used += sound_data.size;
+		else
+			sound_unreported++;
+	}
+	sounds_unlock();
+
+	return NULL;
+}
+#endif
+
+/**
+ * Hand a sound to the loader thread, at the front of the queue if it is
+ * waiting to be played and at the back if it is only being prefetched.
+ * Returns false if the sound has to be loaded on the game thread instead.
+ * Must be called with the sounds locked.
+ */
+static bool queue_sound(u16b sound_id, bool play)
+{
+#ifdef LOAD_IN_BACKGROUND
+	if (!hooks.load_in_background)
+		return false;
+
+	/* Already on its way, or asked for again when next played */
+	if ((sounds[sound_id].status == SOUND_QUEUED) ||
+		(sound_queue_len == SOUND_QUEUE_MAX))
+		return true;
+
+	if (!sound_thread_running) {
+		if (pthread_create(&sound_thread, NULL, sound_thread_run, NULL))
+			return false;
+		sound_thread_running = true;
+	}
+
+	if (play) {
+		sound_queue_head = (sound_queue_head + SOUND_QUEUE_MAX - 1) %
+			SOUND_QUEUE_MAX;
+		sound_queue[sound_queue_head] = sound_id;
+	} else {
+		sound_queue[(sound_queue_head + sound_queue_len) % SOUND_QUEUE_MAX] =
+			sound_id;
+	}
+	sound_queue_len++;
+	sounds[sound_id].status = SOUND_QUEUED;
+	pthread_cond_signal(&sound_wake);
+
+	return true;
+#else
+	return false;
+#endif
+}
+
 /**
  * Parse a string of sound names provided by the preferences parser and:
  *  - Allocate a unique 'sound id' to any new sounds and add them to the
@@ -211,16 +414,22 @@ void message_sound_define(u16b message_id, const char *sounds_str)
 		if (!found) {
 			sound_id = next_sound_id;
 
-			/* Add the new sound to the sound list and load it */
+			/* Add the new sound to the sound list and load it, or start
+			 * loading it in the background while there is room */
+			sounds_lock();
 			if (grow_sound_list()) {
 				sounds[sound_id].name = string_make(cur_token);
 				sounds[sound_id].hash = hash;
 
 				if (preload_sounds)
 					load_sound(&sounds[sound_id]);
+				else if (sound_cache_used < SOUND_CACHE_MAX)
+					queue_sound(sound_id, false);
 			}
 
 			next_sound_id++;
+			sounds_unlock();
+			report_sound_failures();
 		}
 
 		/* Add this sound (by id) to the message->sounds map */
@@ -302,13 +511,23 @@ static void play_sound(game_event_type type, game_event_data *data, void *user)
 
 		assert((sound_id >= 0) && (sound_id < next_sound_id));
 
-		/* Ensure the sound is loaded before we play it */
-		if (!sounds[sound_id].loaded)
+		/* Ensure the sound is loaded before we play it, without waiting
+		 * on the disk if it can be loaded in the background instead */
+		sounds_lock();
+		if (!sounds[sound_id].loaded &&
+			(sounds[sound_id].status == SOUND_IDLE) &&
+			!queue_sound(sound_id, true))
 			load_sound(&sounds[sound_id]);
 
 		/* Only bother playing it if the platform can */
-		if (sounds[sound_id].loaded)
+		if (sounds[sound_id].loaded) {
+			sounds[sound_id].last_used = ++sound_clock;
 			hooks.play_sound_hook(&sounds[sound_id]);
+			trim_sound_cache(sound_id);
+		}
+		sounds_unlock();
+
+		report_sound_failures();
 	}
 }
 
@@ -322,6 +541,18 @@ static void close_audio(void)
 	if (0 == next_sound_id)
 		return;	/* Never opened */
 
+#ifdef LOAD_IN_BACKGROUND
+	/* Let the loader finish the sound it is on */
+	if (sound_thread_running) {
+		sounds_lock();
+		sound_thread_stop = true;
+		pthread_cond_signal(&sound_wake);
+		sounds_unlock();
+		pthread_join(sound_thread, NULL);
+		sound_thread_running = false;
+	}
+#endif
+
 	/*
 	 * Ask the platforms sound module to free resources for each
 	 * sound
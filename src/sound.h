@@ -35,6 +35,15 @@
  *  plat_data : Platform specific structure used to store any additional
  *              data the platform's sound module needs in order to play the
  *              sound (and release resources when shut down)
+ *
+ *  size :      Bytes of memory the loaded sound holds, set by the platform's
+ *              sound module (0 if it is streamed or not known)
+ *
+ *  status :    Whether the core sound module has queued, loaded or given up
+ *              on the sound
+ *
+ *  last_used : When the sound was last played, for unloading the least
+ *              recently used sounds first
  */
 
 #define SOUND_PRF_FORMAT	"sound sym type str sounds"
@@ -44,6 +53,9 @@ struct sound_data {
 	u32b hash;
 	bool loaded;
 	void *plat_data;
+	size_t size;
+	int status;
+	u32b last_used;
 };
 
 struct sound_file_type {
@@ -59,6 +71,10 @@ struct sound_hooks
 	bool (*unload_sound_hook)(struct sound_data *data);
 	bool (*play_sound_hook)(struct sound_data *data);
 	const struct sound_file_type *(*supported_files_hook)(void);
+
+	/* The load hook may be called from a second thread, so it must not
+	 * allocate through z-virt (mem_*() or string_*()) */
+	bool load_in_background;
 };
 
 errr init_sound(const char *soundstr, int argc, char **argv);
@@ -32,6 +32,16 @@ static sqlite3 *db;
 static char *ANGBAND_DIR_STATS;
 static char *db_filename;
 
+/**
+ * Statements prepared by stats_db_stmt_cached(), kept until the database
+ * is closed
+ */
+static struct stats_db_cached {
+	char *sql;
+	sqlite3_stmt *stmt;
+	struct stats_db_cached *next;
+} *stmt_cache;
+
 /**
  * Utility functions
  */
@@ -92,6 +102,13 @@ bool stats_db_open(void) {
  * module variables.
  */
 bool stats_db_close(void) {
+	while (stmt_cache) {
+		struct stats_db_cached *next = stmt_cache->next;
+		sqlite3_finalize(stmt_cache->stmt);
+		string_free(stmt_cache->sql);
+		mem_free(stmt_cache);
+		stmt_cache = next;
+	}
 	sqlite3_close(db);
 	mem_free(ANGBAND_DIR_STATS);
 	mem_free(db_filename);
@@ -128,6 +145,40 @@ int stats_db_stmt_prep(sqlite3_stmt **sql_stmt, char *sql_str) {
 		sql_stmt, NULL);
 }
 
+/**
+ * Like stats_db_stmt_prep(), but the statement is kept and handed back
+ * again, ready to use, to later callers with the same SQL; the caller must
+ * not finalize it.
+ */
+int stats_db_stmt_cached(sqlite3_stmt **sql_stmt, char *sql_str) {
+	struct stats_db_cached *cached;
+	int err;
+
+	for (cached = stmt_cache; cached; cached = cached->next) {
+		if (streq(cached->sql, sql_str)) {
+			*sql_stmt = cached->stmt;
+			return sqlite3_reset(cached->stmt);
+		}
+	}
+
+	err = stats_db_stmt_prep(sql_stmt, sql_str);
+	if (err) return err;
+
+	cached = mem_zalloc(sizeof(*cached));
+	cached->sql = string_make(sql_str);
+	cached->stmt = *sql_stmt;
+	cached->next = stmt_cache;
+	stmt_cache = cached;
+	return SQLITE_OK;
+}
+
+/**
+ * The name of the open database file
+ */
+const char *stats_db_filename(void) {
+	return db_filename;
+}
+
 /**
  * Utility function for binding many ints at once. The offset argument 
  * should be the number of columns to skip before starting to bind. 
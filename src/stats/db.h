@@ -45,6 +45,8 @@ extern bool stats_db_open(void);
 extern bool stats_db_close(void);
 extern int stats_db_exec(char *sql_str);
 extern int stats_db_stmt_prep(sqlite3_stmt **sql_stmt, char *sql_str);
+extern int stats_db_stmt_cached(sqlite3_stmt **sql_stmt, char *sql_str);
+extern const char *stats_db_filename(void);
 extern int stats_db_bind_ints(sqlite3_stmt *sql_stmt, int num_cols, 
 							  int offset, ...);
 extern int stats_db_bind_rv(sqlite3_stmt *sql_stmt, int col,
@@ -113,6 +113,7 @@ void cleanup_stores(void)
 		/* Free the store inventory */
 		object_pile_free(store->stock_k);
 		object_pile_free(store->stock);
+		mem_free(store->prices);
 		mem_free(store->always_table);
 		mem_free(store->normal_table);
 
@@ -371,12 +372,14 @@ void store_reset(void) {
 	for (i = 0; i < MAX_STORES; i++) {
 		s = &stores[i];
 		s->stock_num = 0;
+		s->maint_days = 0;
+		s->prices_version = 0;
 		store_shuffle(s);
 		object_pile_free(s->stock);
 		s->stock = NULL;
 		if (i == STORE_HOME)
 			continue;
-		for (j = 0; j < 10; j++)
+		for (j = 0; j < STORE_MAINT_DAYS_MAX; j++)
 			store_maint(s);
 	}
 }
@@ -590,17 +593,13 @@ static bool store_will_buy(struct store *store, const struct object *obj)
  *
  * Hack -- the black market always charges twice as much as it should.
  */
-int price_item(struct store *store, const struct object *obj,
+static int price_item_aux(struct store *store, const struct object *obj,
 			   bool store_buying, int qty)
 {
 	int adjust = 100;
 	int price;
 	struct owner *proprietor;
 
-	if (!store) {
-		return 0;
-	}
-
 	proprietor = store->owner;
 
 	/* Get the value of the stack of wands, or a single item */
@@ -675,20 +674,91 @@ int price_item(struct store *store, const struct object *obj,
 	return price;
 }
 
+/**
+ * Find the slot for a stock item's remembered price, emptying the table if
+ * it is out of date
+ */
+static struct store_price *store_price_slot(struct store *store,
+		const struct object *obj, int qty)
+{
+	size_t hash = ((size_t) obj >> 4) + (size_t) qty * 31;
+	u32b version = object_knowledge_version();
+
+	if (!store->prices)
+		store->prices = mem_zalloc(STORE_PRICE_SLOTS * sizeof(*store->prices));
+
+	if (store->prices_version != version) {
+		memset(store->prices, 0, STORE_PRICE_SLOTS * sizeof(*store->prices));
+		store->prices_version = version;
+	}
+
+	return &store->prices[hash % STORE_PRICE_SLOTS];
+}
+
+/**
+ * Forget a store's remembered prices, when its stock changes
+ */
+static void store_prices_forget(struct store *store)
+{
+	store->prices_version = 0;
+}
+
+/**
+ * Check whether an object is part of a store's stock
+ */
+static bool store_has_object(const struct store *store,
+		const struct object *obj)
+{
+	const struct object *stock_obj;
+
+	for (stock_obj = store->stock; stock_obj; stock_obj = stock_obj->next)
+		if (stock_obj == obj) return true;
+
+	return false;
+}
+
+/**
+ * Determine the price of an object in a store (see price_item_aux()).
+ *
+ * Prices of the store's own stock are remembered, since the store menus
+ * ask for them on every refresh and valuing an object means working out
+ * its power.  The table is emptied whenever the stock or any knowledge
+ * changes.
+ */
+int price_item(struct store *store, const struct object *obj,
+			   bool store_buying, int qty)
+{
+	struct store_price *slot;
+
+	if (!store) {
+		return 0;
+	}
+
+	/* Only the stock is remembered; the player's items change freely */
+	if (store_buying || store->sidx == STORE_HOME || !store_has_object(store, obj))
+		return price_item_aux(store, obj, store_buying, qty);
+
+	slot = store_price_slot(store, obj, qty);
+	if (slot->obj != obj || slot->qty != qty) {
+		slot->obj = obj;
+		slot->qty = qty;
+		slot->price = price_item_aux(store, obj, false, qty);
+	}
+
+	return slot->price;
+}
+
+
 
 /**
  * Special "mass production" computation.
  */
 static int mass_roll(int times, int max)
 {
-	int i, t = 0;
-
 	assert(max > 1);
 
-	for (i = 0; i < times; i++)
-		t += randint0(max);
-
-	return (t);
+	/* The same draws as summing randint0(max) `times` times */
+	return damroll(times, max) - times;
 }
 
 
@@ -920,6 +990,8 @@ struct object *store_carry(struct store *store, struct object *obj)
 
 	struct object_kind *kind = obj->kind;
 
+	store_prices_forget(store);
+
 	/* Evaluate the object */
 	if (object_is_carried(player, obj))
 		value = object_value(obj, 1);
@@ -992,6 +1064,8 @@ void store_delete(struct store *s, struct object *obj, int amt)
 {
 	struct object *known_obj = obj->known;
 
+	store_prices_forget(s);
+
 	if (obj->number > amt) {
 		obj->number -= amt;
 		known_obj->number -= amt;
@@ -1397,22 +1471,28 @@ static void store_maint(struct store *s)
 
 /**
  * Update the stores on the return to town.
+ *
+ * The shopkeepers are shuffled straight away, but stock maintenance is only
+ * recorded here; each store works through the days it is owed when it is
+ * next visited (see store_catch_up()).
  */
 void store_update(void)
 {
+	int n;
+
 	if (OPT(player, cheat_xtra)) msg("Updating Shops...");
-	while (daycount--) {
-		int n;
 
-		/* Maintain each shop (except home) */
-		for (n = 0; n < MAX_STORES; n++) {
-			/* Skip the home */
-			if (n == STORE_HOME) continue;
+	/* Record the owed maintenance for each shop (except home) */
+	for (n = 0; n < MAX_STORES; n++) {
+		struct store *s = &stores[n];
 
-			/* Maintain */
-			store_maint(&stores[n]);
-		}
+		/* Skip the home */
+		if (n == STORE_HOME) continue;
+
+		s->maint_days = MIN(s->maint_days + daycount, STORE_MAINT_DAYS_MAX);
+	}
 
+	while (daycount--) {
 		/* Sometimes, shuffle the shop-keepers */
 		if (one_in_(z_info->store_shuffle)) {
 			/* Message */
@@ -1432,6 +1512,22 @@ void store_update(void)
 	if (OPT(player, cheat_xtra)) msg("Done.");
 }
 
+/**
+ * Bring a store's stock up to date before it is looked at.
+ *
+ * Owed days are capped at STORE_MAINT_DAYS_MAX when they are recorded:
+ * that many passes is what store_reset() uses to stock an empty store, and
+ * by then the old stock has been turned over, so further passes would
+ * only draw from the same distribution again.
+ */
+void store_catch_up(struct store *store)
+{
+	while (store->maint_days) {
+		store_maint(store);
+		store->maint_days--;
+	}
+}
+
 /** Owner stuff **/
 
 struct owner *store_ownerbyidx(struct store *s, unsigned int idx) {
@@ -1734,7 +1830,7 @@ void do_cmd_buy(struct command *cmd)
 				msg("The shopkeeper brings out some new stock.");
 
 			/* New inventory */
-			for (i = 0; i < 10; ++i)
+			for (i = 0; i < STORE_MAINT_DAYS_MAX; ++i)
 				store_maint(store);
 		}
 	}
@@ -41,12 +41,28 @@ enum {
 	MAX_STORES	= 8
 };
 
+/**
+ * Maintenance passes needed to fully restock a store
+ */
+#define STORE_MAINT_DAYS_MAX	10
+
 struct object_buy {
 	struct object_buy *next;
 	size_t tval;
 	size_t flag;
 };
 
+/**
+ * A remembered price for an item in a store's stock (see price_item())
+ */
+struct store_price {
+	const struct object *obj;
+	int qty;
+	int price;
+};
+
+#define STORE_PRICE_SLOTS	64
+
 struct owner {
 	unsigned int oidx;
 	struct owner *next;
@@ -82,6 +98,12 @@ struct store {
 	int turnover;
 	int normal_stock_min;
 	int normal_stock_max;
+
+	u16b maint_days;			/* Days of maintenance owed since last visit */
+
+	/* Prices of stock items, valid for one knowledge version */
+	struct store_price *prices;
+	u32b prices_version;
 };
 
 extern struct store *stores;
@@ -95,6 +117,7 @@ struct object *store_carry(struct store *store, struct object *obj);
 void store_reset(void);
 void store_shuffle(struct store *store);
 void store_update(void);
+void store_catch_up(struct store *store);
 int price_item(struct store *store, const struct object *obj,
 			   bool store_buying, int qty);
 
@@ -424,41 +424,93 @@ bool target_sighted(void)
  */
 struct point_set *target_get_monsters(int mode, monster_predicate pred)
 {
-	int y, x;
+	int y;
 	int min_y, min_x, max_y, max_x;
 	struct point_set *targets = point_set_new(TS_INITIAL_SIZE);
 
 	/* Get the current panel */
 	get_panel(&min_y, &min_x, &max_y, &max_x);
 
-	/* Scan for targets */
-	for (y = min_y; y < max_y; y++) {
-		for (x = min_x; x < max_x; x++) {
-			struct loc grid = loc(x, y);
+	/* Special mode -- only grids with monsters need be looked at */
+	if (mode & (TARGET_KILL)) {
+		struct loc tl = loc(min_x, min_y), br = loc(max_x - 1, max_y - 1);
+		struct loc grid = loc(tl.x - 1, tl.y);
+
+		while (cave_next_monster_grid(cave, tl, br, &grid)) {
+			struct monster *mon = square_monster(cave, grid);
 
 			/* Check bounds */
 			if (!square_in_bounds_fully(cave, grid)) continue;
 
 			/* Require "interesting" contents */
-			if (!target_accept(y, x)) continue;
-
-			/* Special mode */
-			if (mode & (TARGET_KILL)) {
-				struct monster *mon = square_monster(cave, grid);
+			if (!target_accept(grid.y, grid.x)) continue;
 
-				/* Must contain a monster */
-				if (mon == NULL) continue;
+			/* Must be a targettable monster */
+			if (!target_able(mon)) continue;
 
-				/* Must be a targettable monster */
-				if (!target_able(mon)) continue;
+			/* Must be the right sort of monster */
+			if (pred && !pred(mon)) continue;
 
-				/* Must be the right sort of monster */
-				if (pred && !pred(mon)) continue;
+			/* Save the location */
+			add_to_point_set(targets, grid);
+		}
+	} else {
+		struct loc tl = loc(MAX(min_x, 0), MAX(min_y, 0));
+		struct loc br = loc(MIN(max_x, cave->width) - 1,
+							MIN(max_y, cave->height) - 1);
+		int w = br.x - tl.x + 1, h = br.y - tl.y + 1;
+		bitflag *marks;
+		struct loc grid;
+		int i;
+
+		if (w <= 0 || h <= 0) return targets;
+
+		/* Only the player, monsters, remembered objects, visible traps and
+		 * interesting terrain can be interesting, and each of those is
+		 * kept where it can be found without a look at every grid; mark
+		 * them on a plane covering the panel */
+		marks = mem_zalloc(GRID_PLANE_SIZE(w * h) * sizeof(bitflag));
+		if (player->grid.x >= tl.x && player->grid.x <= br.x &&
+			player->grid.y >= tl.y && player->grid.y <= br.y)
+			grid_plane_on(marks, (player->grid.y - tl.y) * w +
+						  player->grid.x - tl.x);
+		grid = loc(tl.x - 1, tl.y);
+		while (cave_next_monster_grid(cave, tl, br, &grid))
+			grid_plane_on(marks, (grid.y - tl.y) * w + grid.x - tl.x);
+		grid = loc(tl.x - 1, tl.y);
+		while (cave_next_object_grid(player->cave, tl, br, &grid))
+			grid_plane_on(marks, (grid.y - tl.y) * w + grid.x - tl.x);
+		for (y = tl.y; y <= br.y; y++) {
+			int row = grid_to_i(loc(0, y), cave->width);
+			const bitflag *planes[2];
+			int k;
+
+			planes[0] = cave->trap_seen;
+			planes[1] = cave->classes[GRID_CLASS_INTERESTING];
+			for (k = 0; k < 2; k++) {
+				for (i = grid_plane_next(planes[k], row + tl.x, row + br.x + 1);
+					 i <= row + br.x;
+					 i = grid_plane_next(planes[k], i + 1, row + br.x + 1))
+					grid_plane_on(marks, (y - tl.y) * w + i - row - tl.x);
 			}
+		}
+
+		/* Scan the marked grids for targets, in the order of a scan of
+		 * the whole panel */
+		for (i = grid_plane_next(marks, 0, w * h); i < w * h;
+			 i = grid_plane_next(marks, i + 1, w * h)) {
+			grid = loc(tl.x + i % w, tl.y + i / w);
+
+			/* Check bounds */
+			if (!square_in_bounds_fully(cave, grid)) continue;
+
+			/* Require "interesting" contents */
+			if (!target_accept(grid.y, grid.x)) continue;
 
 			/* Save the location */
 			add_to_point_set(targets, grid);
 		}
+		mem_free(marks);
 	}
 
 	sort(targets->pts, point_set_size(targets), sizeof(*(targets->pts)),
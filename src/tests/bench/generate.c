@@ -0,0 +1,321 @@
+/* bench/generate
+ *
+ * Headless benchmark: builds many dungeon levels at one depth, optionally
+ * with one cave profile and split between several worker processes, and
+ * reports levels per second, how often each profile had to be retried, how
+ * long each part of generation took and how many levels were left with
+ * parts the player cannot reach.
+ *
+ * Usage: generate [-n levels] [-d depth] [-p profile] [-j workers] [-s seed]
+ */
+
+#include <stdio.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "cave.h"
+#include "game-profile.h"
+#include "game-world.h"
+#include "generate.h"
+#include "init.h"
+#include "player.h"
+#include "player-util.h"
+#include "test-utils.h"
+#include "z-util.h"
+
+struct bench_options {
+	int levels;
+	int depth;
+	const char *profile;
+	int workers;
+	u32b seed;
+};
+
+/**
+ * What one worker found; the per-profile counts follow it down the pipe
+ */
+struct gen_report {
+	u32b levels;
+	u32b disconnected;	/* Levels with floor the player cannot walk to */
+	u32b no_stairs;		/* Levels where the player cannot walk to a down stair */
+	u64b phase_total[PROFILE_MAX];
+	u32b phase_count[PROFILE_MAX];
+	struct tunnel_stats tunnels;
+};
+
+/**
+ * Whether the player can get through a grid; unlike disconnect_stats(), this
+ * counts doors and rubble as no barrier
+ */
+static bool walkable(struct chunk *c, struct loc grid) {
+	return square_ispassable(c, grid) || square_isdoor(c, grid) ||
+		square_isrubble(c, grid);
+}
+
+/**
+ * Walk out from the player, noting whether any floor outside vaults, or
+ * every down staircase, was out of reach
+ */
+static void check_level(struct chunk *c, struct gen_report *report) {
+	int size = c->height * c->width;
+	int *todo = mem_zalloc(size * sizeof(int));
+	bool *seen = mem_zalloc(size * sizeof(bool));
+	bool stairs = false, cut_off = false;
+	int n = 0, num = 0, i;
+
+	todo[num++] = grid_to_i(player->grid, c->width);
+	seen[todo[0]] = true;
+	while (n < num) {
+		struct loc grid;
+		int d;
+
+		i_to_grid(todo[n++], c->width, &grid);
+		if (square_isdownstairs(c, grid)) stairs = true;
+		for (d = 0; d < 8; d++) {
+			struct loc adj = loc_sum(grid, ddgrid_ddd[d]);
+
+			if (!square_in_bounds_fully(c, adj)) continue;
+			i = grid_to_i(adj, c->width);
+			if (seen[i] || !walkable(c, adj)) continue;
+			seen[i] = true;
+			todo[num++] = i;
+		}
+	}
+
+	for (i = 0; i < size && !cut_off; i++) {
+		struct loc grid;
+
+		i_to_grid(i, c->width, &grid);
+		if (seen[i] || !square_in_bounds_fully(c, grid)) continue;
+		if (!square_isfloor(c, grid) || square_isvault(c, grid)) continue;
+		cut_off = true;
+	}
+
+	if (cut_off) report->disconnected++;
+	if (!stairs) report->no_stairs++;
+	mem_free(todo);
+	mem_free(seen);
+}
+
+static void run_levels(int levels, const struct bench_options *opts,
+					   struct gen_report *report) {
+	int i;
+
+	gen_attempts_reset();
+	memset(&tunnel_stats, 0, sizeof(tunnel_stats));
+	profile_reset();
+	profile_enabled = true;
+	for (i = 0; i < levels; i++) {
+		dungeon_change_level(player, opts->depth);
+		prepare_next_level(&cave, player);
+		check_level(cave, report);
+		report->levels++;
+	}
+	profile_enabled = false;
+
+	for (i = 0; i < PROFILE_MAX; i++) {
+		report->phase_total[i] = profile_total(i);
+		report->phase_count[i] = profile_count(i);
+	}
+	report->tunnels = tunnel_stats;
+}
+
+static void get_attempts(struct gen_attempts *attempts) {
+	const char *name;
+	int i;
+
+	for (i = 0; gen_attempts_get(i, &name, &attempts[i]); i++)
+		;
+}
+
+static void add_report(struct gen_report *total, const struct gen_report *r,
+					   struct gen_attempts *total_attempts,
+					   const struct gen_attempts *attempts) {
+	int i;
+
+	total->levels += r->levels;
+	total->disconnected += r->disconnected;
+	total->no_stairs += r->no_stairs;
+	for (i = 0; i < PROFILE_MAX; i++) {
+		total->phase_total[i] += r->phase_total[i];
+		total->phase_count[i] += r->phase_count[i];
+	}
+	total->tunnels.tunnels += r->tunnels.tunnels;
+	total->tunnels.arrived += r->tunnels.arrived;
+	total->tunnels.stopped += r->tunnels.stopped;
+	total->tunnels.boxed_in += r->tunnels.boxed_in;
+	total->tunnels.timed_out += r->tunnels.timed_out;
+	total->tunnels.steps += r->tunnels.steps;
+	total->tunnels.dug += r->tunnels.dug;
+	total->tunnels.pierced += r->tunnels.pierced;
+	total->tunnels.doors += r->tunnels.doors;
+	for (i = 0; i < z_info->profile_max; i++) {
+		total_attempts[i].tries += attempts[i].tries;
+		total_attempts[i].failures += attempts[i].failures;
+	}
+}
+
+/**
+ * Split the levels between the workers, each with its own random stream split
+ * off from the main one, and add up what they send back
+ */
+static bool run_workers(const struct bench_options *opts,
+						struct gen_report *total,
+						struct gen_attempts *total_attempts) {
+	size_t attempts_size = z_info->profile_max * sizeof(struct gen_attempts);
+	struct gen_attempts *attempts = mem_zalloc(attempts_size);
+	pid_t *pids = mem_zalloc(opts->workers * sizeof(pid_t));
+	FILE **pipes = mem_zalloc(opts->workers * sizeof(FILE *));
+	bool ok = true;
+	int w;
+
+	fflush(stdout);
+	for (w = 0; w < opts->workers; w++) {
+		int share = opts->levels / opts->workers +
+			(w < opts->levels % opts->workers);
+		int fd[2];
+
+		if (pipe(fd)) quit("Couldn't create a pipe for a worker!");
+		pids[w] = fork();
+		if (pids[w] < 0) quit("Couldn't start a worker!");
+
+		if (pids[w] == 0) {
+			/* Worker: build the levels and send back what was found */
+			struct gen_report report;
+			struct rng_state parent = Rand_default;
+			FILE *fp;
+
+			close(fd[0]);
+			memset(&report, 0, sizeof(report));
+			Rand_split(&parent, w, &Rand_default);
+			run_levels(share, opts, &report);
+			get_attempts(attempts);
+
+			fp = fdopen(fd[1], "wb");
+			if (!fp) _exit(1);
+			if (fwrite(&report, sizeof(report), 1, fp) != 1) _exit(1);
+			if (fwrite(attempts, attempts_size, 1, fp) != 1) _exit(1);
+			_exit(fclose(fp) ? 1 : 0);
+		}
+
+		close(fd[1]);
+		pipes[w] = fdopen(fd[0], "rb");
+		if (!pipes[w]) quit("Couldn't read from a worker!");
+	}
+
+	/* Collect the results */
+	for (w = 0; w < opts->workers; w++) {
+		struct gen_report report;
+		int status;
+
+		if (fread(&report, sizeof(report), 1, pipes[w]) != 1 ||
+			fread(attempts, attempts_size, 1, pipes[w]) != 1) {
+			printf("bench/generate: worker %d sent nothing back\n", w + 1);
+			ok = false;
+		} else {
+			add_report(total, &report, total_attempts, attempts);
+		}
+		fclose(pipes[w]);
+
+		if (waitpid(pids[w], &status, 0) != pids[w] || !WIFEXITED(status) ||
+			WEXITSTATUS(status)) {
+			printf("bench/generate: worker %d failed\n", w + 1);
+			ok = false;
+		}
+	}
+
+	mem_free(pipes);
+	mem_free(pids);
+	mem_free(attempts);
+	return ok;
+}
+
+static bool read_options(int argc, char *argv[], struct bench_options *opts) {
+	int opt;
+
+	while ((opt = getopt(argc, argv, "n:d:p:j:s:")) != -1) {
+		switch (opt) {
+			case 'n': opts->levels = atoi(optarg); break;
+			case 'd': opts->depth = atoi(optarg); break;
+			case 'p': opts->profile = optarg; break;
+			case 'j': opts->workers = atoi(optarg); break;
+			case 's': opts->seed = strtoul(optarg, NULL, 10); break;
+			default: return false;
+		}
+	}
+	return opts->levels > 0 && opts->workers > 0 && opts->depth > 0 &&
+		opts->depth < z_info->max_depth;
+}
+
+int main(int argc, char *argv[]) {
+	struct bench_options opts = { 100, 20, NULL, 1, 20260101 };
+	struct gen_report total;
+	struct gen_attempts *attempts, mine;
+	u64b start, elapsed;
+	const char *name;
+	int i;
+
+	test_init_angband();
+
+	if (!read_options(argc, argv, &opts)) {
+		printf("Usage: %s [-n levels] [-d depth] [-p profile] [-j workers] "
+			   "[-s seed]\n", argv[0]);
+		return 1;
+	}
+	if (opts.profile) {
+		gen_forced_profile = find_cave_profile((char *) opts.profile);
+		if (!gen_forced_profile) {
+			printf("bench/generate: no cave profile '%s'\n", opts.profile);
+			return 1;
+		}
+	}
+
+	Rand_quick = false;
+	Rand_state_init(opts.seed);
+	if (!test_birth_character("Bench")) return 1;
+
+	memset(&total, 0, sizeof(total));
+	attempts = mem_zalloc(z_info->profile_max * sizeof(*attempts));
+	start = profile_clock();
+	if (opts.workers == 1) {
+		run_levels(opts.levels, &opts, &total);
+		get_attempts(attempts);
+	} else if (!run_workers(&opts, &total, attempts)) {
+		return 1;
+	}
+	elapsed = profile_clock() - start;
+
+	printf("bench/generate: %lu levels at depth %d in %.3fs (%.1f levels/s, "
+		   "%d worker%s)\n", (unsigned long) total.levels, opts.depth,
+		   elapsed / 1e9, elapsed ? total.levels / (elapsed / 1e9) : 0.0,
+		   opts.workers, opts.workers == 1 ? "" : "s");
+	for (i = 0; gen_attempts_get(i, &name, &mine); i++) {
+		if (!attempts[i].tries) continue;
+		printf("  %-18s %8lu tries %8lu failed (%.1f%%)\n", name,
+			   (unsigned long) attempts[i].tries,
+			   (unsigned long) attempts[i].failures,
+			   100.0 * attempts[i].failures / attempts[i].tries);
+	}
+	for (i = PROFILE_GENERATE; i < PROFILE_MAX; i++)
+		printf("  %-18s %10.3f ms %10lu calls\n", profile_phase_name(i),
+			   total.phase_total[i] / 1e6,
+			   (unsigned long) total.phase_count[i]);
+	printf("  %lu tunnels: %lu arrived, %lu met a corridor, %lu boxed in, "
+		   "%lu ran out of steps\n", (unsigned long) total.tunnels.tunnels,
+		   (unsigned long) total.tunnels.arrived,
+		   (unsigned long) total.tunnels.stopped,
+		   (unsigned long) total.tunnels.boxed_in,
+		   (unsigned long) total.tunnels.timed_out);
+	printf("  %lu tunnel steps, %lu grids dug, %lu walls pierced, %lu door "
+		   "places\n", (unsigned long) total.tunnels.steps,
+		   (unsigned long) total.tunnels.dug,
+		   (unsigned long) total.tunnels.pierced,
+		   (unsigned long) total.tunnels.doors);
+	printf("  %lu levels with unreachable floor, %lu with no reachable "
+		   "down staircase\n", (unsigned long) total.disconnected,
+		   (unsigned long) total.no_stairs);
+
+	mem_free(attempts);
+	cleanup_angband();
+	return 0;
+}
@@ -0,0 +1,356 @@
+/* bench/micro
+ *
+ * Headless benchmark: times single calls into the parts of the game that
+ * are called most often - line of sight, projection paths, the view, the
+ * noise flow, monster and object choice, object names, player bonuses,
+ * quarks, the data file parser and level generation with each cave profile.
+ *
+ * Every benchmark starts from the same random seed and the same level, and
+ * is repeated several times; the fastest and the median repeat are given.
+ * Results are printed one to a line, tab-separated, after a header line
+ * starting with '#', so runs from different commits can be compared with
+ * standard tools.
+ *
+ * Usage: micro [-n scale] [-r repeats] [-s seed] [-b benchmark]
+ */
+
+#include <stdio.h>
+#include <unistd.h>
+#include "buildid.h"
+#include "cave.h"
+#include "game-profile.h"
+#include "game-world.h"
+#include "generate.h"
+#include "init.h"
+#include "mon-make.h"
+#include "obj-desc.h"
+#include "obj-knowledge.h"
+#include "obj-make.h"
+#include "obj-pile.h"
+#include "parser.h"
+#include "player-calcs.h"
+#include "player-util.h"
+#include "project.h"
+#include "test-utils.h"
+#include "z-quark.h"
+#include "z-util.h"
+
+#define MICRO_PAIRS 256
+#define MICRO_OBJECTS 64
+#define MICRO_QUARKS 256
+#define MICRO_DEPTH 20
+#define MICRO_REPEATS_MAX 31
+
+/**
+ * One benchmark; run() does `iters` calls of whatever is being timed
+ */
+struct micro_bench {
+	const char *name;
+	int iters;
+	void (*run)(int iters);
+};
+
+static u32b seed = 20260101;
+static volatile int sink;
+
+static struct loc pairs[MICRO_PAIRS][2];
+static struct object *objects[MICRO_OBJECTS];
+static char quarks[MICRO_QUARKS][16];
+static char **lines;
+static int num_lines;
+
+/**
+ * Build the level everything but level generation is timed on, and the
+ * things the benchmarks work through
+ */
+static void prepare(void) {
+	int i;
+
+	Rand_state_init(seed);
+	dungeon_change_level(player, MICRO_DEPTH);
+	prepare_next_level(&cave, player);
+	update_stuff(player);
+
+	/* Pairs of grids within sight of each other, if nothing were in the way */
+	for (i = 0; i < MICRO_PAIRS; i++) {
+		struct loc from = loc(randint1(cave->width - 2),
+							  randint1(cave->height - 2));
+		struct loc to = loc(from.x + rand_range(-z_info->max_sight,
+												z_info->max_sight),
+							from.y + rand_range(-z_info->max_sight,
+												z_info->max_sight));
+
+		pairs[i][0] = from;
+		pairs[i][1] = loc(MAX(1, MIN(to.x, cave->width - 2)),
+						  MAX(1, MIN(to.y, cave->height - 2)));
+	}
+
+	for (i = 0; i < MICRO_OBJECTS; i++) {
+		struct object *obj = NULL;
+
+		while (!obj)
+			obj = make_object(cave, MICRO_DEPTH, false, false, false, NULL,
+							  0);
+		obj->known = object_new();
+		object_set_base_known(obj);
+		object_touch(player, obj);
+		objects[i] = obj;
+	}
+
+	/* Inscriptions; half of them are the same, as they tend to be */
+	for (i = 0; i < MICRO_QUARKS; i++)
+		strnfmt(quarks[i], sizeof(quarks[i]), "@r%d=g", i % 2 ? i : 1);
+}
+
+/**
+ * Read the monster list in as parser input
+ */
+static bool read_lines(void) {
+	char path[1024], buf[1024];
+	ang_file *fh;
+	int size = 0;
+
+	path_build(path, sizeof(path), ANGBAND_DIR_GAMEDATA, "monster.txt");
+	fh = file_open(path, MODE_READ, FTYPE_TEXT);
+	if (!fh) return false;
+	while (file_getl(fh, buf, sizeof(buf))) {
+		if (num_lines == size) {
+			size = size ? size * 2 : 1024;
+			lines = mem_realloc(lines, size * sizeof(*lines));
+		}
+		lines[num_lines++] = string_make(buf);
+	}
+	file_close(fh);
+	return num_lines > 0;
+}
+
+static void run_los(int iters) {
+	int i;
+
+	for (i = 0; i < iters; i++)
+		sink += los(cave, pairs[i % MICRO_PAIRS][0], pairs[i % MICRO_PAIRS][1]);
+}
+
+static void run_project_path(int iters) {
+	struct loc path[512];
+	int i;
+
+	for (i = 0; i < iters; i++)
+		sink += project_path(path, z_info->max_range,
+							 pairs[i % MICRO_PAIRS][0],
+							 pairs[i % MICRO_PAIRS][1], 0);
+}
+
+static void run_update_view(int iters) {
+	int i;
+
+	for (i = 0; i < iters; i++)
+		update_view(cave, player);
+}
+
+static void run_make_noise(int iters) {
+	int i;
+
+	/* Each call works the flow out afresh, as after the player moves */
+	for (i = 0; i < iters; i++) {
+		cave->flows[FLOW_NOISE].stale = true;
+		make_noise(player);
+	}
+}
+
+static void run_get_mon_num(int iters) {
+	int i;
+
+	for (i = 0; i < iters; i++)
+		sink += get_mon_num(1 + i % MICRO_DEPTH) != NULL;
+}
+
+static void run_get_obj_num(int iters) {
+	int i;
+
+	for (i = 0; i < iters; i++)
+		sink += get_obj_num(1 + i % MICRO_DEPTH, false, 0) != NULL;
+}
+
+static void run_object_desc(int iters) {
+	char buf[80];
+	int i;
+
+	for (i = 0; i < iters; i++)
+		sink += object_desc(buf, sizeof(buf), objects[i % MICRO_OBJECTS],
+							ODESC_PREFIX | ODESC_FULL);
+}
+
+static void run_calc_bonuses(int iters) {
+	struct player_state state;
+	int i;
+
+	for (i = 0; i < iters; i++)
+		calc_bonuses(player, &state, false, false);
+}
+
+static void run_quark_add(int iters) {
+	int i;
+
+	for (i = 0; i < iters; i++)
+		sink += quark_add(quarks[i % MICRO_QUARKS]);
+}
+
+static void run_parser_parse(int iters) {
+	struct parser *p = parser_new();
+	int i;
+
+	/* The same directives as the monster parser, doing nothing with them */
+	parser_reg(p, "name str name", ignored);
+	parser_reg(p, "plural ?str plural", ignored);
+	parser_reg(p, "base sym base", ignored);
+	parser_reg(p, "glyph char glyph", ignored);
+	parser_reg(p, "color sym color", ignored);
+	parser_reg(p, "speed int speed", ignored);
+	parser_reg(p, "hit-points int hp", ignored);
+	parser_reg(p, "light int light", ignored);
+	parser_reg(p, "hearing int hearing", ignored);
+	parser_reg(p, "smell int smell", ignored);
+	parser_reg(p, "armor-class int ac", ignored);
+	parser_reg(p, "sleepiness int sleep", ignored);
+	parser_reg(p, "depth int level", ignored);
+	parser_reg(p, "rarity int rarity", ignored);
+	parser_reg(p, "experience int mexp", ignored);
+	parser_reg(p, "blow sym method ?sym effect ?rand damage", ignored);
+	parser_reg(p, "flags ?str flags", ignored);
+	parser_reg(p, "flags-off ?str flags", ignored);
+	parser_reg(p, "desc str desc", ignored);
+	parser_reg(p, "innate-freq int freq", ignored);
+	parser_reg(p, "spell-freq int freq", ignored);
+	parser_reg(p, "spell-power uint power", ignored);
+	parser_reg(p, "spells str spells", ignored);
+	parser_reg(p, "drop sym tval sym sval uint chance uint min uint max",
+			   ignored);
+	parser_reg(p, "drop-base sym tval uint chance uint min uint max", ignored);
+	parser_reg(p, "drop-artifact str name", ignored);
+	parser_reg(p, "friends uint chance rand number sym name ?sym role",
+			   ignored);
+	parser_reg(p, "friends-base uint chance rand number sym name ?sym role",
+			   ignored);
+	parser_reg(p, "mimic sym tval sym sval", ignored);
+	parser_reg(p, "shape str name", ignored);
+
+	for (i = 0; i < iters; i++)
+		sink += parser_parse(p, lines[i % num_lines]);
+	parser_destroy(p);
+}
+
+static const char *gen_profile;
+
+static void run_cave_generate(int iters) {
+	int i;
+
+	gen_forced_profile = find_cave_profile((char *) gen_profile);
+	for (i = 0; i < iters; i++) {
+		dungeon_change_level(player, MICRO_DEPTH);
+		prepare_next_level(&cave, player);
+	}
+	gen_forced_profile = NULL;
+}
+
+static struct micro_bench benches[] = {
+	{ "los", 200000, run_los },
+	{ "project_path", 100000, run_project_path },
+	{ "update_view", 500, run_update_view },
+	{ "make_noise", 500, run_make_noise },
+	{ "get_mon_num", 100000, run_get_mon_num },
+	{ "get_obj_num", 100000, run_get_obj_num },
+	{ "object_desc", 50000, run_object_desc },
+	{ "calc_bonuses", 20000, run_calc_bonuses },
+	{ "quark_add", 200000, run_quark_add },
+	{ "parser_parse", 200000, run_parser_parse },
+};
+
+static int compare_u64b(const void *a, const void *b) {
+	u64b x = *(const u64b *) a, y = *(const u64b *) b;
+
+	return x < y ? -1 : x > y;
+}
+
+/**
+ * Time `repeats` runs of `iters` calls to `run`, each from the same seed,
+ * and print the fastest and median time for one call
+ */
+static void time_bench(const char *name, void (*run)(int iters), int iters,
+					   int repeats) {
+	u64b times[MICRO_REPEATS_MAX];
+	int i;
+
+	for (i = 0; i < repeats; i++) {
+		u64b start;
+
+		Rand_state_init(seed);
+		start = profile_clock();
+		run(iters);
+		times[i] = profile_clock() - start;
+	}
+	qsort(times, repeats, sizeof(times[0]), compare_u64b);
+	printf("%s\t%d\t%.1f\t%.1f\n", name, iters, (double) times[0] / iters,
+		   (double) times[repeats / 2] / iters);
+	fflush(stdout);
+}
+
+int main(int argc, char *argv[]) {
+	const char *only = NULL;
+	int scale = 1, repeats = 5, opt, i;
+	struct gen_attempts attempts;
+	const char *name;
+
+	while ((opt = getopt(argc, argv, "n:r:s:b:")) != -1) {
+		switch (opt) {
+			case 'n': scale = atoi(optarg); break;
+			case 'r': repeats = atoi(optarg); break;
+			case 's': seed = strtoul(optarg, NULL, 10); break;
+			case 'b': only = optarg; break;
+			default:
+				printf("Usage: %s [-n scale] [-r repeats] [-s seed] "
+					   "[-b benchmark]\n", argv[0]);
+				return 1;
+		}
+	}
+	if (scale <= 0) scale = 1;
+	repeats = MAX(1, MIN(repeats, MICRO_REPEATS_MAX));
+
+	test_init_angband();
+
+	Rand_quick = false;
+	Rand_state_init(seed);
+	if (!test_birth_character("Bench")) return 1;
+	if (!read_lines()) {
+		printf("bench/micro: couldn't read monster.txt\n");
+		return 1;
+	}
+	prepare();
+
+	printf("# bench/micro %s seed %lu repeats %d\n", buildid,
+		   (unsigned long) seed, repeats);
+	printf("# benchmark\tcalls\tbest ns/call\tmedian ns/call\n");
+	for (i = 0; i < (int) N_ELEMENTS(benches); i++) {
+		if (only && !prefix(benches[i].name, only)) continue;
+		time_bench(benches[i].name, benches[i].run, benches[i].iters * scale,
+				   repeats);
+	}
+
+	/* Level generation, once for each cave profile */
+	for (i = 0; gen_attempts_get(i, &name, &attempts); i++) {
+		char label[80];
+
+		strnfmt(label, sizeof(label), "cave_generate/%s", name);
+		if (only && !prefix(label, only)) continue;
+		gen_profile = name;
+		time_bench(label, run_cave_generate, 5 * scale, repeats);
+	}
+
+	for (i = 0; i < MICRO_OBJECTS; i++)
+		object_delete(&objects[i]);
+	for (i = 0; i < num_lines; i++)
+		string_free(lines[i]);
+	mem_free(lines);
+	cleanup_angband();
+	return 0;
+}
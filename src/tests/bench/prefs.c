@@ -0,0 +1,74 @@
+/* bench/prefs
+ *
+ * Headless benchmark: loads the visual pref files for plain text and for
+ * each tile set over and over, as switching graphics modes in the game
+ * does, and reports how long a load takes.
+ *
+ * Usage: prefs [-n loads]
+ */
+
+#include <stdio.h>
+#include <unistd.h>
+#include "game-profile.h"
+#include "grafmode.h"
+#include "init.h"
+#include "player.h"
+#include "test-utils.h"
+#include "ui-prefs.h"
+#include "z-util.h"
+
+/**
+ * The pref files test the player's race and class, so there has to be one
+ */
+/**
+ * Load the visuals for graphics mode `id` `loads` times, returning how long
+ * that took in nanoseconds
+ */
+static u64b time_mode(int id, int loads) {
+	u64b start;
+	int i;
+
+	use_graphics = id;
+	current_graphics_mode = get_graphics_mode(id);
+	start = profile_clock();
+	for (i = 0; i < loads; i++)
+		reset_visuals(true);
+	return profile_clock() - start;
+}
+
+int main(int argc, char *argv[]) {
+	int loads = 20, opt;
+	graphics_mode *mode;
+
+	while ((opt = getopt(argc, argv, "n:")) != -1) {
+		if (opt == 'n') {
+			loads = atoi(optarg);
+		} else {
+			printf("Usage: %s [-n loads]\n", argv[0]);
+			return 1;
+		}
+	}
+	if (loads <= 0) loads = 1;
+
+	test_init_angband();
+	if (!init_graphics_modes()) {
+		printf("bench/prefs: couldn't read the graphics modes\n");
+		return 1;
+	}
+	if (!test_birth_character("Bench")) return 1;
+	textui_prefs_init();
+
+	for (mode = graphics_modes; mode; mode = mode->pNext) {
+		u64b elapsed = time_mode(mode->grafID, loads);
+
+		printf("bench/prefs: %-20s %8.3f ms a load\n", mode->menuname,
+			   elapsed / 1e6 / loads);
+	}
+
+	use_graphics = GRAPHICS_NONE;
+	current_graphics_mode = NULL;
+	textui_prefs_free();
+	close_graphics_modes();
+	cleanup_angband();
+	return 0;
+}
@@ -0,0 +1,278 @@
+/* bench/replay
+ *
+ * Headless benchmark: plays a fixed character through a fixed command
+ * stream and reports game turns per second, and how long each part of the
+ * game loop took.
+ *
+ * With -d it also writes the digests of the game state at the end of every
+ * game turn to a log, and with -c checks them against a log written by an
+ * earlier run, such as one of a build known to play correctly; the first
+ * turn where they differ is reported, and the run fails.
+ *
+ * Usage: replay [-d digest log] [-c reference log] [script]
+ */
+
+#include <stdio.h>
+#include <unistd.h>
+#include "cmd-core.h"
+#include "game-digest.h"
+#include "game-profile.h"
+#include "game-world.h"
+#include "init.h"
+#include "parser.h"
+#include "player.h"
+#include "player-calcs.h"
+#include "player-util.h"
+#include "test-utils.h"
+#include "z-util.h"
+
+enum bench_type {
+	BENCH_DEPTH,
+	BENCH_WALK,
+	BENCH_HOLD,
+	BENCH_REST
+};
+
+struct bench_cmd {
+	enum bench_type type;
+	int arg;
+};
+
+struct bench_script {
+	u32b seed;
+	char *race;
+	char *class;
+	int repeat;
+	struct bench_cmd *cmds;
+	int num;
+	int alloc;
+};
+
+static void add_cmd(struct bench_script *s, enum bench_type type, int arg) {
+	if (s->num == s->alloc) {
+		s->alloc = s->alloc ? s->alloc * 2 : 32;
+		s->cmds = mem_realloc(s->cmds, s->alloc * sizeof(*s->cmds));
+	}
+	s->cmds[s->num].type = type;
+	s->cmds[s->num].arg = arg;
+	s->num++;
+}
+
+static enum parser_error parse_seed(struct parser *p) {
+	struct bench_script *s = parser_priv(p);
+	s->seed = parser_getuint(p, "seed");
+	return PARSE_ERROR_NONE;
+}
+
+static enum parser_error parse_birth(struct parser *p) {
+	struct bench_script *s = parser_priv(p);
+	string_free(s->race);
+	string_free(s->class);
+	s->race = string_make(parser_getsym(p, "race"));
+	s->class = string_make(parser_getsym(p, "class"));
+	return PARSE_ERROR_NONE;
+}
+
+static enum parser_error parse_repeat(struct parser *p) {
+	struct bench_script *s = parser_priv(p);
+	s->repeat = parser_getuint(p, "times");
+	return PARSE_ERROR_NONE;
+}
+
+static enum parser_error parse_depth(struct parser *p) {
+	add_cmd(parser_priv(p), BENCH_DEPTH, parser_getuint(p, "depth"));
+	return PARSE_ERROR_NONE;
+}
+
+static enum parser_error parse_walk(struct parser *p) {
+	add_cmd(parser_priv(p), BENCH_WALK, parser_getuint(p, "dir"));
+	return PARSE_ERROR_NONE;
+}
+
+static enum parser_error parse_hold(struct parser *p) {
+	add_cmd(parser_priv(p), BENCH_HOLD, 0);
+	return PARSE_ERROR_NONE;
+}
+
+static enum parser_error parse_rest(struct parser *p) {
+	add_cmd(parser_priv(p), BENCH_REST, parser_getuint(p, "turns"));
+	return PARSE_ERROR_NONE;
+}
+
+static bool read_script(const char *path, struct bench_script *s) {
+	struct parser *p = parser_new();
+	ang_file *f = file_open(path, MODE_READ, FTYPE_TEXT);
+	char buf[1024];
+	int line = 0;
+	bool ok = true;
+
+	if (!f) {
+		printf("bench/replay: can't open %s\n", path);
+		parser_destroy(p);
+		return false;
+	}
+
+	parser_setpriv(p, s);
+	parser_reg(p, "seed uint seed", parse_seed);
+	parser_reg(p, "birth sym race sym class", parse_birth);
+	parser_reg(p, "repeat uint times", parse_repeat);
+	parser_reg(p, "depth uint depth", parse_depth);
+	parser_reg(p, "walk uint dir", parse_walk);
+	parser_reg(p, "hold", parse_hold);
+	parser_reg(p, "rest uint turns", parse_rest);
+
+	while (ok && file_getl(f, buf, sizeof(buf))) {
+		line++;
+		if (parser_parse(p, buf) != PARSE_ERROR_NONE) {
+			printf("bench/replay: %s:%d: can't parse '%s'\n", path, line,
+				   buf);
+			ok = false;
+		}
+	}
+
+	file_close(f);
+	parser_destroy(p);
+	return ok;
+}
+
+static bool birth_character(struct bench_script *s) {
+	struct player_race *r;
+	struct player_class *c;
+
+	for (r = races; r; r = r->next)
+		if (s->race && streq(r->name, s->race)) break;
+	for (c = classes; c; c = c->next)
+		if (s->class && streq(c->name, s->class)) break;
+	if (!r || !c) {
+		printf("bench/replay: unknown race or class\n");
+		return false;
+	}
+
+	if (!test_birth_race_class("Bench", r->ridx, c->cidx)) return false;
+	test_enter_level();
+	return !player->is_dead;
+}
+
+static void play_cmd(const struct bench_cmd *cmd) {
+	switch (cmd->type) {
+		case BENCH_DEPTH:
+			dungeon_change_level(player, cmd->arg);
+			break;
+		case BENCH_WALK:
+			cmdq_push(CMD_WALK);
+			cmd_set_arg_direction(cmdq_peek(), "direction", cmd->arg);
+			break;
+		case BENCH_HOLD:
+			cmdq_push(CMD_HOLD);
+			break;
+		case BENCH_REST:
+			cmdq_push(CMD_REST);
+			cmd_set_arg_choice(cmdq_peek(), "choice", cmd->arg);
+			break;
+	}
+	run_game_loop();
+}
+
+/**
+ * Report the first turn where the digests didn't match the reference
+ */
+static bool report_digests(void) {
+	struct game_digest expected, found;
+	s32b bad = digest_first_mismatch(&expected, &found);
+
+	if (bad < 0) {
+		printf("bench/replay: digests match the reference\n");
+		return true;
+	}
+
+	printf("bench/replay: digests differ from the reference at turn %ld:\n",
+		   (long) bad);
+	printf("  %-10s %08lx %08lx\n", "rng", (unsigned long) expected.rng,
+		   (unsigned long) found.rng);
+	printf("  %-10s %08lx %08lx\n", "player", (unsigned long) expected.player,
+		   (unsigned long) found.player);
+	printf("  %-10s %08lx %08lx\n", "monsters",
+		   (unsigned long) expected.monsters, (unsigned long) found.monsters);
+	printf("  %-10s %08lx %08lx\n", "objects",
+		   (unsigned long) expected.objects, (unsigned long) found.objects);
+	printf("  %-10s %08lx %08lx\n", "feats", (unsigned long) expected.feats,
+		   (unsigned long) found.feats);
+	return false;
+}
+
+int main(int argc, char *argv[]) {
+	struct bench_script script = { 20260101, NULL, NULL, 1, NULL, 0, 0 };
+	const char *path = "bench/replay.txt";
+	const char *log_path = NULL, *ref_path = NULL;
+	s32b start_turn;
+	u64b start, elapsed;
+	bool ok = true;
+	int i, j, opt;
+
+	while ((opt = getopt(argc, argv, "d:c:")) != -1) {
+		switch (opt) {
+			case 'd': log_path = optarg; break;
+			case 'c': ref_path = optarg; break;
+			default:
+				printf("Usage: %s [-d digest log] [-c reference log] "
+					   "[script]\n", argv[0]);
+				return 1;
+		}
+	}
+	if (optind < argc) path = argv[optind];
+
+	if (!read_script(path, &script)) return 1;
+
+	test_init_angband();
+
+	Rand_quick = false;
+	Rand_state_init(script.seed);
+	if (!birth_character(&script)) return 1;
+
+	if (log_path && !(digest_log = file_open(log_path, MODE_WRITE,
+											  FTYPE_TEXT))) {
+		printf("bench/replay: can't write %s\n", log_path);
+		return 1;
+	}
+	if (ref_path && !(digest_reference = file_open(ref_path, MODE_READ,
+													FTYPE_TEXT))) {
+		printf("bench/replay: can't open %s\n", ref_path);
+		return 1;
+	}
+
+	profile_reset();
+	profile_enabled = true;
+	start_turn = turn;
+	start = profile_clock();
+	for (i = 0; i < script.repeat && !player->is_dead; i++)
+		for (j = 0; j < script.num && !player->is_dead; j++)
+			play_cmd(&script.cmds[j]);
+	elapsed = profile_clock() - start;
+	profile_enabled = false;
+
+	printf("bench/replay: %ld game turns in %.3fs (%.0f turns/s)\n",
+		   (long) (turn - start_turn), elapsed / 1e9,
+		   elapsed ? (turn - start_turn) / (elapsed / 1e9) : 0.0);
+	for (i = 0; i < PROFILE_MAX; i++)
+		printf("  %-18s %10.3f ms %10lu calls\n", profile_phase_name(i),
+			   profile_total(i) / 1e6, (unsigned long) profile_count(i));
+	printf("  end state: depth %d, grid (%d, %d), hp %d/%d%s\n",
+		   player->depth, player->grid.x, player->grid.y, player->chp,
+		   player->mhp, player->is_dead ? ", dead" : "");
+
+	if (digest_log) {
+		file_close(digest_log);
+		digest_log = NULL;
+	}
+	if (digest_reference) {
+		ok = report_digests();
+		file_close(digest_reference);
+		digest_reference = NULL;
+	}
+
+	string_free(script.race);
+	string_free(script.class);
+	mem_free(script.cmds);
+	cleanup_angband();
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,204 @@
+/* bench/soak
+ *
+ * Headless soak test: takes one character between a few depths for many
+ * iterations, each one a level made by prepare_next_level() (or, with -p,
+ * brought back from the stored levels) and played for some turns, and the
+ * last one freed or stored.  Every so many iterations it reports resident
+ * memory, what z-virt has accounted to each part of the game and how long
+ * an iteration took.  Memory or time which keeps climbing over a long
+ * session shows up as columns which keep climbing here.
+ *
+ * Lines are tab-separated after a header line starting with '#'; the last
+ * lines compare the end of the run with the first report after warming up.
+ *
+ * Usage: soak [-n iterations] [-t turns] [-d depth] [-l levels]
+ *             [-r report every] [-p] [-s seed]
+ */
+
+#include <stdio.h>
+#include <unistd.h>
+#include "cave.h"
+#include "cmd-core.h"
+#include "game-profile.h"
+#include "game-world.h"
+#include "generate.h"
+#include "init.h"
+#include "player.h"
+#include "player-timed.h"
+#include "player-util.h"
+#include "test-utils.h"
+#include "z-util.h"
+
+struct bench_options {
+	int iterations;
+	int turns;
+	int depth;
+	int levels;
+	int report;
+	bool persist;
+	u32b seed;
+};
+
+/**
+ * What the game looked like after some iterations
+ */
+struct soak_sample {
+	int iteration;
+	double ms;			/* Mean time per iteration since the last sample */
+	long resident;		/* KB, or -1 if it can't be found */
+	size_t bytes[MEM_TAG_MAX];
+	long live;			/* Blocks allocated and not yet freed */
+};
+
+/**
+ * Get the resident size of the process in KB from /proc, where there is one
+ */
+static long resident_kb(void) {
+	FILE *f = fopen("/proc/self/statm", "r");
+	long size, resident = -1;
+
+	if (!f) return -1;
+	if (fscanf(f, "%ld %ld", &size, &resident) != 2) resident = -1;
+	fclose(f);
+	return resident < 0 ? -1 : resident * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+static void take_sample(struct soak_sample *s, int iteration, u64b elapsed,
+						int iterations) {
+	int i;
+
+	s->iteration = iteration;
+	s->ms = iterations ? elapsed / 1e6 / iterations : 0.0;
+	s->resident = resident_kb();
+	s->live = 0;
+	for (i = 0; i < MEM_TAG_MAX; i++) {
+		struct mem_tag_stats stats;
+
+		mem_tag_get_stats(i, &stats);
+		s->bytes[i] = stats.bytes;
+		s->live += (long) stats.allocs - (long) stats.frees;
+	}
+}
+
+static void print_header(void) {
+	int i;
+
+	printf("#iteration\tms/iter\tresident KB\tlive blocks");
+	for (i = 0; i < MEM_TAG_MAX; i++)
+		printf("\t%s KB", mem_tag_name(i));
+	printf("\n");
+}
+
+static void print_sample(const struct soak_sample *s) {
+	int i;
+
+	printf("%d\t%.3f\t%ld\t%ld", s->iteration, s->ms, s->resident, s->live);
+	for (i = 0; i < MEM_TAG_MAX; i++)
+		printf("\t%.1f", s->bytes[i] / 1024.0);
+	printf("\n");
+	fflush(stdout);
+}
+
+/**
+ * Go to the next depth, which makes or brings back a level and frees or
+ * stores the last one, and play some turns there
+ */
+static void soak_iteration(const struct bench_options *opts, int i) {
+	int turn;
+
+	dungeon_change_level(player, opts->depth + i % opts->levels);
+	run_game_loop();
+
+	for (turn = 0; turn < opts->turns && !player->is_dead; turn++) {
+		/* Keep the character going, whatever is on the level */
+		player->chp = player->mhp;
+		player->timed[TMD_FOOD] = PY_FOOD_FULL - 1;
+
+		cmdq_push(CMD_HOLD);
+		run_game_loop();
+	}
+}
+
+static bool read_options(int argc, char *argv[], struct bench_options *opts) {
+	int opt;
+
+	while ((opt = getopt(argc, argv, "n:t:d:l:r:ps:")) != -1) {
+		switch (opt) {
+			case 'n': opts->iterations = atoi(optarg); break;
+			case 't': opts->turns = atoi(optarg); break;
+			case 'd': opts->depth = atoi(optarg); break;
+			case 'l': opts->levels = atoi(optarg); break;
+			case 'r': opts->report = atoi(optarg); break;
+			case 'p': opts->persist = true; break;
+			case 's': opts->seed = strtoul(optarg, NULL, 10); break;
+			default: return false;
+		}
+	}
+	return opts->iterations > 0 && opts->turns >= 0 && opts->depth > 0 &&
+		opts->levels > 0 && opts->report > 0 &&
+		opts->depth + opts->levels <= z_info->max_depth;
+}
+
+int main(int argc, char *argv[]) {
+	struct bench_options opts = { 1000, 20, 5, 2, 100, false, 20260101 };
+	struct soak_sample first, last;
+	u64b start, window_start;
+	int i;
+
+	/* Account for everything, so that leaks show in the live blocks */
+	mem_flags |= MEM_ACCOUNT;
+
+	test_init_angband();
+
+	if (!read_options(argc, argv, &opts)) {
+		printf("Usage: %s [-n iterations] [-t turns] [-d depth] [-l levels] "
+			   "[-r report every] [-p] [-s seed]\n", argv[0]);
+		return 1;
+	}
+
+	Rand_quick = false;
+	Rand_state_init(opts.seed);
+	if (!test_birth_character("Soak")) return 1;
+	test_enter_level();
+	OPT(player, birth_levels_persist) = opts.persist;
+
+	print_header();
+	memset(&first, 0, sizeof(first));
+	memset(&last, 0, sizeof(last));
+	start = window_start = profile_clock();
+	for (i = 1; i <= opts.iterations && !player->is_dead; i++) {
+		soak_iteration(&opts, i);
+
+		if (i % opts.report == 0 || i == opts.iterations) {
+			u64b now = profile_clock();
+			int window = i % opts.report ? i % opts.report : opts.report;
+
+			take_sample(&last, i, now - window_start, window);
+			print_sample(&last);
+			if (!first.iteration) first = last;
+			window_start = now;
+		}
+	}
+
+	printf("# bench/soak: %d iterations of %d turns in %.3fs%s\n", i - 1,
+		   opts.turns, (profile_clock() - start) / 1e9,
+		   player->is_dead ? ", stopped by the character dying" : "");
+	if (last.iteration > first.iteration) {
+		double per = 1000.0 / (last.iteration - first.iteration);
+		size_t first_bytes = 0, last_bytes = 0;
+
+		for (i = 0; i < MEM_TAG_MAX; i++) {
+			first_bytes += first.bytes[i];
+			last_bytes += last.bytes[i];
+		}
+		printf("# from iteration %d to %d: %.3f to %.3f ms/iter, per 1000 "
+			   "iterations resident %+.0f KB, accounted %+.1f KB, live "
+			   "blocks %+.0f\n", first.iteration, last.iteration, first.ms,
+			   last.ms, (last.resident - first.resident) * per,
+			   ((double) last_bytes - (double) first_bytes) / 1024.0 * per,
+			   (last.live - first.live) * per);
+	}
+
+	cleanup_angband();
+	return 0;
+}
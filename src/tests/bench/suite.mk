@@ -0,0 +1,5 @@
+BENCHPROGS += bench/generate \
+	bench/micro \
+	bench/prefs \
+	bench/replay \
+	bench/soak
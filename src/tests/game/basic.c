@@ -10,8 +10,11 @@
 #include "game-event.h"
 #include "game-world.h"
 #include "init.h"
+#include "mon-util.h"
+#include "obj-util.h"
 #include "savefile.h"
 #include "player.h"
+#include "player-history.h"
 #include "player-timed.h"
 #include "z-util.h"
 
@@ -75,6 +78,7 @@ int test_newgame(void *state) {
 
 	/* Make sure it saved properly */
 	eq(file_exists("Test1"), true);
+	require(strstr(savefile_get_description("Test1"), "Tester, L1"));
 
 	ok;
 }
@@ -92,6 +96,46 @@ int test_loadgame(void *state) {
 	ok;
 }
 
+int test_checksum(void *state) {
+	char image[64];
+	ang_file *f = file_open("Test1", MODE_READ, FTYPE_TEXT);
+	int len;
+
+	notnull(f);
+	len = file_read(f, image, sizeof image);
+	file_close(f);
+	eq(len, (int) sizeof image);
+
+	/* Change a byte of the description, which comes first */
+	image[40] ^= 1;
+	f = file_open("Test1.bad", MODE_WRITE, FTYPE_SAVE);
+	notnull(f);
+	require(file_write(f, image, sizeof image));
+	file_close(f);
+
+	require(streq(savefile_get_description("Test1.bad"), "Invalid savefile"));
+	eq(savefile_load("Test1.bad", false), false);
+	file_delete("Test1.bad");
+	ok;
+}
+
+int test_autosave(void *state) {
+	s16b food = player->timed[TMD_FOOD];
+
+	/* Save in the background, then change things before it is needed */
+	eq(savefile_save_background("Test1"), true);
+	player->timed[TMD_FOOD] = food / 2;
+	eq(savefile_finish(), true);
+	eq(savefile_finish(), true);
+
+	/* What was saved is what there was when the save started */
+	eq(savefile_load("Test1", false), true);
+	eq(player->is_dead, false);
+	eq(player->timed[TMD_FOOD], food);
+
+	ok;
+}
+
 int test_stairs1(void *state) {
 
 	/* Load the saved game */
@@ -173,13 +217,68 @@ int test_drop_eat(void *state) {
 	ok;
 }
 
+int test_lazy_text(void *state) {
+	struct monster_race *race = lookup_monster("Grip, Farmer Maggot's Dog");
+	struct object_kind *kind = lookup_kind(TV_FOOD,
+		lookup_sval(TV_FOOD, "Ration of Food"));
+	struct artifact *art = lookup_artifact_name("of Galadriel");
+
+	/* Descriptions are read from the data files when first asked for */
+	notnull(race);
+	null(race->text);
+	require(streq(monster_race_text(race), "A rather vicious dog belonging "
+		"to Farmer Maggot.  It thinks you are stealing mushrooms."));
+	notnull(race->text);
+
+	notnull(kind);
+	require(prefix(object_kind_text(kind), "This nutritious but fairly "));
+	require(suffix(object_kind_text(kind), "as a chewing exercise."));
+
+	notnull(art);
+	require(streq(artifact_text(art), "A small crystal phial containing the "
+		"light of E\xc3\xa4rendil's Star.  Its light is imperishable, and "
+		"near it darkness cannot endure."));
+
+	ok;
+}
+
+int test_artifact_history(void *state) {
+	const struct artifact *a1 = &a_info[1], *a2 = &a_info[2];
+	struct history_info *list;
+	size_t n = history_get_list(player, &list);
+
+	require(!history_is_artifact_known(player, a1));
+
+	/* A missed artifact isn't known until it is found */
+	history_lose_artifact(player, a1);
+	eq(history_get_list(player, &list), n + 1);
+	require(!history_is_artifact_known(player, a1));
+	history_find_artifact(player, a1);
+	eq(history_get_list(player, &list), n + 1);
+	require(history_is_artifact_known(player, a1));
+	require(hist_has(list[n].type, HIST_ARTIFACT_KNOWN));
+	require(hist_has(list[n].type, HIST_ARTIFACT_LOST));
+
+	/* Finding another adds its own entry */
+	require(!history_is_artifact_known(player, a2));
+	history_find_artifact(player, a2);
+	eq(history_get_list(player, &list), n + 2);
+	eq(list[n + 1].a_idx, a2->aidx);
+	require(history_is_artifact_known(player, a2));
+	ok;
+}
+
 const char *suite_name = "game/basic";
 struct test tests[] = {
 	{ "newgame", test_newgame },
 	{ "loadgame", test_loadgame },
+	{ "checksum", test_checksum },
+	{ "lazy_text", test_lazy_text },
+	{ "autosave", test_autosave },
 	{ "stairs1", test_stairs1 },
 	{ "stairs2", test_stairs2 },
 	{ "droppickup", test_drop_pickup },
 	{ "dropeat", test_drop_eat },
+	{ "artifact_history", test_artifact_history },
 	{ NULL, NULL }
 };
@@ -0,0 +1,133 @@
+/* game/bonuses.c */
+
+#include "unit-test.h"
+#include "test-utils.h"
+
+#include <stdio.h>
+#include "cave.h"
+#include "game-profile.h"
+#include "game-world.h"
+#include "init.h"
+#include "obj-knowledge.h"
+#include "obj-gear.h"
+#include "player.h"
+#include "player-calcs.h"
+#include "player-timed.h"
+#include "z-util.h"
+
+int setup_tests(void **state) {
+	test_init_angband();
+	test_birth_character("Tester");
+	test_enter_level();
+
+	/* Make equipment modifiers count */
+	player_learn_all_runes(player);
+	update_stuff(player);
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	cleanup_angband();
+	return 0;
+}
+
+/* A timed effect alone reuses the equipment layer, and gets the same
+ * answer as working everything out again */
+static bool timed_matches_full(void) {
+	struct player_state timed, known_timed;
+
+	update_stuff(player);
+	timed = player->state;
+	known_timed = player->known_state;
+
+	player->upkeep->update |= (PU_BONUS);
+	update_stuff(player);
+	return !memcmp(&timed, &player->state, sizeof(timed)) &&
+		!memcmp(&known_timed, &player->known_state, sizeof(known_timed));
+}
+
+int test_timed(void *state) {
+	int speed = player->state.speed;
+
+	require(player->upkeep->bonus_layer[0].valid);
+	require(player->upkeep->bonus_layer[1].valid);
+
+	require(player_inc_timed(player, TMD_FAST, 10, true, false));
+	require(player->upkeep->bonus_layer[0].valid);
+	require(timed_matches_full());
+	eq(player->state.speed, speed + 10);
+
+	require(player_inc_timed(player, TMD_STUN, 10, true, false));
+	require(player_inc_timed(player, TMD_OPP_FIRE, 10, true, false));
+	require(timed_matches_full());
+
+	require(player_clear_timed(player, TMD_FAST, true));
+	require(player_clear_timed(player, TMD_STUN, true));
+	require(player_clear_timed(player, TMD_OPP_FIRE, true));
+	require(timed_matches_full());
+	eq(player->state.speed, speed);
+	ok;
+}
+
+int test_equipment(void *state) {
+	struct player_state before = player->state;
+	struct object *weapon = equipped_item_by_slot_name(player, "weapon");
+
+	notnull(weapon);
+
+	/* Changing equipment must be noticed with PU_BONUS */
+	weapon->modifiers[OBJ_MOD_SPEED] += 3;
+	player->upkeep->update |= (PU_BONUS);
+	update_stuff(player);
+	eq(player->state.speed, before.speed + 3);
+
+	/* Timed effects alone leave the equipment part alone */
+	weapon->modifiers[OBJ_MOD_SPEED] -= 3;
+	require(player_inc_timed(player, TMD_SLOW, 10, true, false));
+	eq(player->state.speed, before.speed - 7);
+	require(player_clear_timed(player, TMD_SLOW, true));
+	eq(player->state.speed, before.speed + 3);
+
+	player->upkeep->update |= (PU_BONUS);
+	update_stuff(player);
+	eq(player->state.speed, before.speed);
+	ok;
+}
+
+/* Inside a frame the updates are made at once, but drawing waits */
+int test_frames(void *state) {
+	profile_enabled = true;
+	profile_reset();
+
+	frame_begin(player);
+	player->upkeep->update |= (PU_BONUS);
+	player->upkeep->redraw |= (PR_SPEED);
+	handle_stuff(player);
+	eq(player->upkeep->update, 0);
+	require(player->upkeep->redraw & PR_SPEED);
+	eq(profile_flush_count(PROFILE_FLUSH_PUT_OFF), 1);
+
+	/* Waiting for input has to show what is pending */
+	flush_stuff(player, "test");
+	eq(player->upkeep->redraw, 0);
+	eq(player->upkeep->frame, 1);
+	eq(profile_flush_count(PROFILE_FLUSH_FORCED), 1);
+
+	player->upkeep->redraw |= (PR_SPEED);
+	handle_stuff(player);
+	frame_end(player);
+	handle_stuff(player);
+	eq(player->upkeep->redraw, 0);
+	eq(profile_flush_count(PROFILE_FLUSH_DONE), 2);
+
+	profile_enabled = false;
+	ok;
+}
+
+const char *suite_name = "game/bonuses";
+struct test tests[] = {
+	{ "timed", test_timed },
+	{ "equipment", test_equipment },
+	{ "frames", test_frames },
+	{ NULL, NULL }
+};
@@ -0,0 +1,78 @@
+/* game/event */
+
+#include "unit-test.h"
+#include "game-event.h"
+
+NOSETUP
+
+int teardown_tests(void *state) {
+	event_remove_all_handlers();
+	return 0;
+}
+
+static int calls[3];
+static int order[8];
+static int n_order;
+
+static void handler(game_event_type type, game_event_data *data, void *user)
+{
+	int which = *(int *)user;
+
+	calls[which]++;
+	if (n_order < (int)N_ELEMENTS(order)) order[n_order++] = which;
+}
+
+static int ids[3] = { 0, 1, 2 };
+
+/* Removes handler 0, which has not been called yet, then itself */
+static void remover(game_event_type type, game_event_data *data, void *user)
+{
+	calls[2]++;
+	event_remove_handler(type, handler, &ids[0]);
+	event_remove_handler(type, remover, &ids[2]);
+}
+
+int test_order(void *state) {
+	event_add_handler(EVENT_GOLD, handler, &ids[0]);
+	event_add_handler(EVENT_GOLD, handler, &ids[1]);
+	n_order = 0;
+	event_signal(EVENT_GOLD);
+
+	/* The last handler added is called first */
+	eq(n_order, 2);
+	eq(order[0], 1);
+	eq(order[1], 0);
+
+	event_remove_handler(EVENT_GOLD, handler, &ids[1]);
+	event_signal(EVENT_GOLD);
+	eq(calls[0], 2);
+	eq(calls[1], 1);
+	event_remove_handler_type(EVENT_GOLD);
+	ok;
+}
+
+int test_remove_in_dispatch(void *state) {
+	memset(calls, 0, sizeof(calls));
+	event_add_handler(EVENT_HP, handler, &ids[0]);
+	event_add_handler(EVENT_HP, handler, &ids[1]);
+	event_add_handler(EVENT_HP, remover, &ids[2]);
+	event_signal(EVENT_HP);
+
+	/* Every handler left is called once, and the removed one not at all */
+	eq(calls[2], 1);
+	eq(calls[1], 1);
+	eq(calls[0], 0);
+
+	event_signal(EVENT_HP);
+	eq(calls[2], 1);
+	eq(calls[1], 2);
+	eq(calls[0], 0);
+	ok;
+}
+
+const char *suite_name = "game/event";
+struct test tests[] = {
+	{ "order", test_order },
+	{ "remove-in-dispatch", test_remove_in_dispatch },
+	{ NULL, NULL }
+};
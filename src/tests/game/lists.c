@@ -0,0 +1,209 @@
+/* game/lists.c */
+
+#include "unit-test.h"
+#include "test-utils.h"
+
+#include <stdio.h>
+#include "cave.h"
+#include "generate.h"
+#include "init.h"
+#include "mon-group.h"
+#include "mon-make.h"
+#include "monster.h"
+#include "obj-pile.h"
+#include "z-util.h"
+
+static void println(const char *str) {
+	printf("%s\n", str);
+}
+
+int setup_tests(void **state) {
+	plog_aux = println;
+	set_file_paths();
+	init_angband();
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	cleanup_angband();
+	return 0;
+}
+
+#define NUM_OBJECTS (OBJECT_LIST_SIZE * 3)
+
+int test_objects(void *state) {
+	struct chunk *c = cave_new(10, 10);
+	struct object *objs[NUM_OBJECTS];
+	struct object *extra = object_new();
+	int i, max;
+
+	for (i = 0; i < NUM_OBJECTS; i++) {
+		objs[i] = object_new();
+		list_object(c, objs[i]);
+		require(objs[i]->oidx > 0 && objs[i]->oidx < c->obj_max);
+		require(c->objects[objs[i]->oidx] == objs[i]);
+	}
+	for (i = 1; i < NUM_OBJECTS; i++)
+		require(objs[i]->oidx > objs[i - 1]->oidx);
+
+	/* Listing again changes nothing */
+	max = c->obj_max;
+	list_object(c, objs[10]);
+	eq(c->obj_max, max);
+	eq(objs[10]->oidx, 11);
+
+	/* Holes are reused, the most recently freed first */
+	delist_object(c, objs[20]);
+	delist_object(c, objs[5]);
+	eq(objs[5]->oidx, 0);
+	null(c->objects[6]);
+	list_object(c, extra);
+	eq(extra->oidx, 6);
+	list_object(c, objs[5]);
+	eq(objs[5]->oidx, 21);
+	eq(c->obj_max, max);
+
+	for (i = 0; i < NUM_OBJECTS; i++) {
+		delist_object(c, objs[i]);
+		object_free(objs[i]);
+	}
+	delist_object(c, extra);
+	object_free(extra);
+	cave_free(c);
+	ok;
+}
+
+int test_monsters(void *state) {
+	struct chunk *c = cave_new(10, 10);
+	int i;
+
+	/* Fill the table */
+	while (cave_monster_max(c) < z_info->level_monster_max)
+		require(mon_pop(c));
+	for (i = 1; i < cave_monster_max(c); i++)
+		cave_monster(c, i)->race = &r_info[1];
+
+	/* Dead monsters are found, then used up */
+	cave_monster(c, 7)->race = NULL;
+	cave_monster(c, 3)->race = NULL;
+	eq(mon_pop(c), 3);
+	cave_monster(c, 3)->race = &r_info[1];
+	eq(mon_pop(c), 7);
+	cave_monster(c, 7)->race = &r_info[1];
+	eq(mon_pop(c), 0);
+
+	for (i = 1; i < cave_monster_max(c); i++)
+		cave_monster(c, i)->race = NULL;
+	cave_free(c);
+	ok;
+}
+
+int test_groups(void *state) {
+	struct chunk *c = cave_new(10, 10);
+	struct monster *mons[4];
+	struct monster_group *group;
+	int i;
+
+	for (i = 0; i < 4; i++) {
+		mons[i] = cave_monster(c, mon_pop(c));
+		mons[i]->midx = i + 1;
+		mons[i]->race = &r_info[1];
+	}
+
+	/* Indices are handed out lowest first, but only taken by a group */
+	eq(monster_group_index_new(c), 1);
+	eq(monster_group_index_new(c), 1);
+	monster_group_start(c, mons[0], PRIMARY_GROUP);
+	eq(mons[0]->group_info[PRIMARY_GROUP].index, 1);
+	eq(monster_group_index_new(c), 2);
+	group = monster_group_by_index(c, 1);
+	for (i = 1; i < 3; i++) {
+		mons[i]->group_info[PRIMARY_GROUP].index = 1;
+		mons[i]->group_info[PRIMARY_GROUP].role = MON_GROUP_MEMBER;
+		monster_add_to_group(c, mons[i], group);
+	}
+	monster_group_start(c, mons[3], PRIMARY_GROUP);
+	eq(mons[3]->group_info[PRIMARY_GROUP].index, 2);
+	eq(monster_primary_group_size(c, mons[1]), 3);
+
+	/* A member of the same race takes over from a dead leader */
+	monster_remove_from_groups(c, mons[0]);
+	eq(monster_primary_group_size(c, mons[1]), 2);
+	i = monster_group_leader_idx(group);
+	require(i == 2 || i == 3);
+	eq(mons[i - 1]->group_info[PRIMARY_GROUP].role, MON_GROUP_LEADER);
+
+	/* Compaction moves members */
+	require(monster_group_change_index(c, 1, 3));
+	mons[0]->group_info[PRIMARY_GROUP] = mons[2]->group_info[PRIMARY_GROUP];
+	eq(monster_primary_group_size(c, mons[0]), 2);
+
+	/* Freed indices are reused */
+	monster_remove_from_groups(c, mons[1]);
+	monster_remove_from_groups(c, mons[0]);
+	null(monster_group_by_index(c, 1));
+	eq(monster_group_index_new(c), 1);
+	monster_remove_from_groups(c, mons[3]);
+	eq(monster_group_index_new(c), 2);
+
+	for (i = 0; i < 4; i++)
+		mons[i]->race = NULL;
+	cave_free(c);
+	ok;
+}
+
+int test_chunks(void *state) {
+	struct chunk *chunk;
+	char name[20];
+	int i, num_read = 0;
+
+	/* Store some levels, all of them unchanged since they were saved */
+	for (i = 0; i < 20; i++) {
+		struct chunk *c = cave_new(5, 5);
+
+		strnfmt(name, sizeof(name), "%d", i + 1);
+		c->name = string_make(name);
+		c->depth = i + 1;
+		c->turn = 100 + i;
+		c->saved = mem_zalloc(4);
+		c->saved_size = 4;
+		chunk_list_add(c);
+	}
+	eq(chunk_list_max, 20);
+
+	/* The oldest are kept only as they were saved */
+	for (i = 0; i < chunk_list_max; i++) {
+		if (!chunk_list[i]->unread) num_read++;
+		eq(chunk_list[i]->unread, (i < 4));
+		eq(chunk_list[i]->depth, i + 1);
+	}
+	eq(num_read, 16);
+
+	/* A level that has changed since the save stays read */
+	chunk_list[4]->saved_size = 0;
+	mem_free(chunk_list[4]->saved);
+	chunk_list[4]->saved = NULL;
+	chunk = cave_new(5, 5);
+	chunk->name = string_make("21");
+	chunk->turn = 120;
+	chunk_list_add(chunk);
+	require(!chunk_list[4]->unread);
+	require(chunk_list[5]->unread);
+
+	/* Lookup by name */
+	require(chunk_find_name("7") == chunk_list[6]);
+	require(chunk_list_remove("3"));
+	require(!chunk_list_remove("3"));
+	null(chunk_find_name("3"));
+	eq(chunk_list_max, 20);
+	ok;
+}
+
+const char *suite_name = "game/lists";
+struct test tests[] = {
+	{ "objects", test_objects },
+	{ "monsters", test_monsters },
+	{ "groups", test_groups },
+	{ "chunks", test_chunks },
+	{ NULL, NULL }
+};
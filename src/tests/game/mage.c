@@ -13,6 +13,8 @@
 #include "mon-make.h"
 #include "savefile.h"
 #include "player.h"
+#include "player-calcs.h"
+#include "player-spell.h"
 #include "player-timed.h"
 #include "z-util.h"
 
@@ -83,8 +85,38 @@ int test_magic_missile(void *state) {
 	ok;
 }
 
+int test_spell_memo(void *state) {
+	const char *info, *again;
+	char buf[30];
+	int csp = player->csp;
+
+	/* What is remembered is what would be worked out */
+	eq(spell_chance_info(0, &info), spell_chance(0));
+	get_spell_info(0, buf, sizeof(buf));
+	require(streq(info, buf));
+	eq(spell_chance_info(0, &again), spell_chance(0));
+	ptreq(again, info);
+
+	/* Mana and stun change it straight away */
+	player->csp = 0;
+	eq(spell_chance_info(0, NULL), spell_chance(0));
+	player->timed[TMD_STUN] = 60;
+	eq(spell_chance_info(0, NULL), spell_chance(0));
+	player->timed[TMD_STUN] = 0;
+	player->csp = csp;
+	eq(spell_chance_info(0, NULL), spell_chance(0));
+
+	/* So do redone bonuses */
+	player->upkeep->update |= PU_BONUS;
+	update_stuff(player);
+	eq(spell_chance_info(0, NULL), spell_chance(0));
+
+	ok;
+}
+
 const char *suite_name = "game/mage";
 struct test tests[] = {
 	{ "magic_missile", test_magic_missile },
+	{ "spell_memo", test_spell_memo },
 	{ NULL, NULL }
 };
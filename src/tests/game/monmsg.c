@@ -0,0 +1,79 @@
+/* game/monmsg.c */
+
+#include "unit-test.h"
+#include "test-utils.h"
+
+#include <stdio.h>
+#include "game-event.h"
+#include "init.h"
+#include "mon-msg.h"
+#include "mon-util.h"
+#include "monster.h"
+#include "player.h"
+#include "z-util.h"
+
+static char last_msg[80];
+static int num_msgs;
+
+static void println(const char *str) {
+	printf("%s\n", str);
+}
+
+static void record_message(game_event_type type, game_event_data *data,
+		void *user) {
+	my_strcpy(last_msg, data->message.msg, sizeof(last_msg));
+	num_msgs++;
+}
+
+int setup_tests(void **state) {
+	plog_aux = println;
+	set_file_paths();
+	init_angband();
+	event_add_handler(EVENT_MESSAGE, record_message, NULL);
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	event_remove_handler(EVENT_MESSAGE, record_message, NULL);
+	cleanup_angband();
+	return 0;
+}
+
+#define NUM_MONSTERS 40
+
+int test_stack(void *state) {
+	struct monster mons[NUM_MONSTERS];
+	struct monster_race *race = lookup_monster("cave spider");
+	int i;
+
+	notnull(race);
+	memset(mons, 0, sizeof(mons));
+	for (i = 0; i < NUM_MONSTERS; i++) {
+		mons[i].race = race;
+		mons[i].midx = i + 1;
+		mflag_on(mons[i].mflag, MFLAG_VISIBLE);
+		add_monster_message(&mons[i], MON_MSG_FLEE_IN_TERROR, false);
+	}
+
+	/* The same monster never repeats a message */
+	add_monster_message(&mons[3], MON_MSG_FLEE_IN_TERROR, false);
+
+	num_msgs = 0;
+	show_monster_messages();
+	eq(num_msgs, 1);
+	require(strstr(last_msg, "40 ") == last_msg);
+	require(strstr(last_msg, "in terror") != NULL);
+
+	/* Everything was forgotten */
+	require(add_monster_message(&mons[3], MON_MSG_FLEE_IN_TERROR, false));
+	num_msgs = 0;
+	show_monster_messages();
+	eq(num_msgs, 1);
+	ok;
+}
+
+const char *suite_name = "game/monmsg";
+struct test tests[] = {
+	{ "stack", test_stack },
+	{ NULL, NULL }
+};
@@ -0,0 +1,67 @@
+/* game/profile.c */
+
+#include "unit-test.h"
+#include "game-profile.h"
+
+int setup_tests(void **state) {
+	profile_enabled = true;
+	profile_reset();
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	profile_enabled = false;
+	return 0;
+}
+
+int test_bins(void *state) {
+	struct profile_stats stats;
+
+	/* Longer than 4ms, however long it takes to get here */
+	profile_end(PROFILE_WORLD, profile_clock() - 10000000);
+	profile_get_stats(PROFILE_WORLD, false, &stats);
+	eq(stats.count, 1);
+	eq(stats.bins[PROFILE_BINS - 1], 1);
+	require(stats.total >= 10000000);
+	eq(stats.longest, stats.total);
+	eq(profile_count(PROFILE_WORLD), 1);
+	eq(profile_count(PROFILE_PLAYER), 0);
+	ok;
+}
+
+int test_window(void *state) {
+	struct profile_stats stats;
+	int i;
+
+	profile_get_stats(PROFILE_WORLD, true, &stats);
+	eq(stats.count, 1);
+
+	/* Once the window has moved on, only the cumulative count is left */
+	for (i = 0; i < PROFILE_WINDOW * PROFILE_SLOT_TURNS; i++)
+		profile_tick();
+	profile_get_stats(PROFILE_WORLD, true, &stats);
+	eq(stats.count, 0);
+	eq(stats.total, 0);
+	profile_get_stats(PROFILE_WORLD, false, &stats);
+	eq(stats.count, 1);
+	ok;
+}
+
+int test_disabled(void *state) {
+	profile_enabled = false;
+	eq(profile_begin(), 0);
+	profile_end(PROFILE_WORLD, profile_clock() - 5000);
+	eq(profile_count(PROFILE_WORLD), 1);
+	profile_enabled = true;
+	profile_reset();
+	eq(profile_count(PROFILE_WORLD), 0);
+	ok;
+}
+
+const char *suite_name = "game/profile";
+struct test tests[] = {
+	{ "bins", test_bins },
+	{ "window", test_window },
+	{ "disabled", test_disabled },
+	{ NULL, NULL }
+};
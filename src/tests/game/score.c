@@ -0,0 +1,68 @@
+/* game/score */
+
+#include "unit-test.h"
+#include "score.h"
+#include "z-form.h"
+
+NOSETUP
+NOTEARDOWN
+
+static void make_score(high_score *entry, long pts) {
+	memset(entry, 0, sizeof(*entry));
+	my_strcpy(entry->what, "test", sizeof(entry->what));
+	strnfmt(entry->pts, sizeof(entry->pts), "%9lu", pts);
+}
+
+int test_where(void *state) {
+	high_score scores[8], entry;
+	long pts[] = { 900, 700, 700, 500, 100 };
+	size_t i;
+
+	memset(scores, 0, sizeof(scores));
+	for (i = 0; i < N_ELEMENTS(pts); i++)
+		make_score(&scores[i], pts[i]);
+
+	make_score(&entry, 1000);
+	eq(highscore_where(&entry, scores, N_ELEMENTS(scores)), 0);
+
+	/* Ties go ahead of the scores they match */
+	make_score(&entry, 700);
+	eq(highscore_where(&entry, scores, N_ELEMENTS(scores)), 1);
+	make_score(&entry, 600);
+	eq(highscore_where(&entry, scores, N_ELEMENTS(scores)), 3);
+
+	/* Below every score, the first free entry */
+	make_score(&entry, 50);
+	eq(highscore_where(&entry, scores, N_ELEMENTS(scores)), 5);
+
+	/* A full table still offers its last entry */
+	for (i = N_ELEMENTS(pts); i < N_ELEMENTS(scores); i++)
+		make_score(&scores[i], 80);
+	eq(highscore_where(&entry, scores, N_ELEMENTS(scores)), 7);
+	ok;
+}
+
+int test_add(void *state) {
+	high_score scores[4], entry;
+	size_t i;
+
+	memset(scores, 0, sizeof(scores));
+	for (i = 0; i < 6; i++) {
+		make_score(&entry, (i % 2) ? 100 * i : 1000 - 100 * i);
+		highscore_add(&entry, scores, N_ELEMENTS(scores));
+	}
+
+	/* 1000, 800, 600, 500 kept best first, with 300 and 100 pushed out */
+	eq(strtoul(scores[0].pts, NULL, 0), 1000);
+	eq(strtoul(scores[1].pts, NULL, 0), 800);
+	eq(strtoul(scores[2].pts, NULL, 0), 600);
+	eq(strtoul(scores[3].pts, NULL, 0), 500);
+	ok;
+}
+
+const char *suite_name = "game/score";
+struct test tests[] = {
+	{ "where", test_where },
+	{ "add", test_add },
+	{ NULL, NULL }
+};
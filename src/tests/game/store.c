@@ -0,0 +1,105 @@
+/* game/store.c */
+
+#include "unit-test.h"
+#include "unit-test-data.h"
+#include "test-utils.h"
+
+#include <stdio.h>
+#include "cave.h"
+#include "game-world.h"
+#include "init.h"
+#include "obj-knowledge.h"
+#include "obj-tval.h"
+#include "player.h"
+#include "savefile.h"
+#include "store.h"
+#include "z-util.h"
+
+int setup_tests(void **state) {
+	test_init_angband();
+	test_birth_character("Tester");
+	test_enter_level();
+	return 0;
+}
+
+int teardown_tests(void **state) {
+	file_delete("Store1");
+	cleanup_angband();
+	return 0;
+}
+
+int test_deferred(void *state) {
+	struct store *s = &stores[STORE_GENERAL];
+	struct object *stock = s->stock;
+
+	/* Returning to town only records the days owed */
+	eq(s->maint_days, 0);
+	daycount = 3;
+	store_update();
+	eq(daycount, 0);
+	eq(s->maint_days, 3);
+	eq(stores[STORE_HOME].maint_days, 0);
+	ptreq(s->stock, stock);
+
+	/* Long absences are capped */
+	daycount = 50;
+	store_update();
+	eq(s->maint_days, STORE_MAINT_DAYS_MAX);
+
+	ok;
+}
+
+int test_saved(void *state) {
+	/* Owed days survive a save and load */
+	stores[STORE_ARMOR].maint_days = 4;
+	eq(savefile_save("Store1"), true);
+	stores[STORE_ARMOR].maint_days = 0;
+	eq(savefile_load("Store1", false), true);
+	eq(stores[STORE_ARMOR].maint_days, 4);
+	ok;
+}
+
+int test_catch_up(void *state) {
+	struct store *s = &stores[STORE_ALCHEMY];
+
+	/* Entering pays off the owed days and leaves a stocked store */
+	s->maint_days = 5;
+	store_catch_up(s);
+	eq(s->maint_days, 0);
+	require(s->stock_num > 0);
+	ok;
+}
+
+int test_prices(void *state) {
+	struct store *s = &stores[STORE_WEAPON];
+	struct object *obj;
+	int price;
+
+	store_catch_up(s);
+	obj = s->stock;
+	notnull(obj);
+
+	/* Remembered prices match and follow the quantity asked for */
+	price = price_item(s, obj, false, 1);
+	require(price > 0);
+	eq(price_item(s, obj, false, 1), price);
+	if (!tval_can_have_charges(obj))
+		eq(price_item(s, obj, false, 2), price * 2);
+
+	/* A changed object is priced afresh once knowledge changes */
+	obj->to_h += 5;
+	obj->known->to_h += 5;
+	eq(price_item(s, obj, false, 1), price);
+	update_player_object_knowledge(player);
+	require(price_item(s, obj, false, 1) > price);
+	ok;
+}
+
+const char *suite_name = "game/store";
+struct test tests[] = {
+	{ "deferred", test_deferred },
+	{ "saved", test_saved },
+	{ "catch_up", test_catch_up },
+	{ "prices", test_prices },
+	{ NULL, NULL }
+};
@@ -0,0 +1,150 @@
+/* game/stream.c */
+
+#include "unit-test.h"
+#include "unit-test-data.h"
+#include "test-utils.h"
+
+#include <stdio.h>
+#include "cave.h"
+#include "cmd-core.h"
+#include "cmd-stream.h"
+#include "game-event.h"
+#include "game-world.h"
+#include "init.h"
+#include "player.h"
+#include "player-timed.h"
+#include "z-util.h"
+
+static void write_stream(const char *text) {
+	ang_file *f = file_open("Stream1", MODE_WRITE, FTYPE_TEXT);
+	file_put(f, text);
+	file_close(f);
+}
+
+int setup_tests(void **state) {
+	test_init_angband();
+	test_birth_character("Tester");
+	test_enter_level();
+	return 0;
+}
+
+int teardown_tests(void **state) {
+	char path[32];
+	int i;
+
+	file_delete("Stream1");
+	file_delete("Stream2");
+	for (i = 0; i < 32; i++) {
+		strnfmt(path, sizeof(path), "Stream2.%d", i);
+		if (file_exists(path)) file_delete(path);
+	}
+	cleanup_angband();
+	return 0;
+}
+
+int test_missing(void *state) {
+	null(cmd_stream_open("NoSuchStream"));
+	ok;
+}
+
+int test_bad_line(void *state) {
+	struct cmd_stream *s;
+
+	/* An argument with no command, then a command that doesn't exist */
+	write_stream("direction:direction:2\n");
+	s = cmd_stream_open("Stream1");
+	notnull(s);
+	eq(cmd_stream_play(s), 0);
+	eq(cmd_stream_failed(s), true);
+	cmd_stream_close(s);
+
+	write_stream("cmd:FLY\n");
+	s = cmd_stream_open("Stream1");
+	eq(cmd_stream_play(s), 0);
+	eq(cmd_stream_failed(s), true);
+	cmd_stream_close(s);
+	ok;
+}
+
+int test_play(void *state) {
+	struct cmd_stream *s;
+	u32b turns = player->total_energy;
+
+	write_stream("# Walk out and back, then go down\n"
+				 "cmd:WALK\n"
+				 "direction:direction:2\n"
+				 "cmd:WALK\n"
+				 "direction:direction:8\n"
+				 "cmd:HOLD\n"
+				 "cmd:GO_DOWN\n");
+	s = cmd_stream_open("Stream1");
+	notnull(s);
+	eq(cmd_stream_play(s), 4);
+	eq(cmd_stream_failed(s), false);
+	cmd_stream_close(s);
+	noteq(player->total_energy, turns);
+	eq(player->depth, 1);
+	ok;
+}
+
+static void play_stream(const char *text) {
+	struct cmd_stream *s;
+
+	write_stream(text);
+	s = cmd_stream_open("Stream1");
+	cmd_stream_play(s);
+	cmd_stream_close(s);
+}
+
+int test_record(void *state) {
+	struct cmd_stream *s;
+	struct loc mid_grid, end_grid;
+	s32b mid, end;
+	u32b end_energy;
+
+	/* Record some play, with keyframes every couple of player turns */
+	eq(cmd_record_start("Stream2", 20), true);
+	play_stream("cmd:WALK\n"
+				"direction:direction:4\n"
+				"cmd:HOLD\n"
+				"cmd:WALK\n"
+				"direction:direction:6\n");
+	mid = turn;
+	mid_grid = player->grid;
+	play_stream("cmd:HOLD\n"
+				"cmd:WALK\n"
+				"direction:direction:2\n"
+				"cmd:HOLD\n"
+				"cmd:HOLD\n");
+	end = turn;
+	end_grid = player->grid;
+	end_energy = player->total_energy;
+	cmd_record_stop();
+	eq(file_exists("Stream2.0"), true);
+	eq(file_exists("Stream2.1"), true);
+
+	/* Jumping to a turn gives the game as it was then */
+	s = cmd_stream_open("Stream2");
+	notnull(s);
+	eq(cmd_stream_seek(s, mid), true);
+	eq(turn, mid);
+	require(loc_eq(player->grid, mid_grid));
+	eq(cmd_stream_seek(s, end), true);
+	eq(turn, end);
+	require(loc_eq(player->grid, end_grid));
+	eq(player->total_energy, end_energy);
+
+	/* There is nothing before the first keyframe */
+	eq(cmd_stream_seek(s, 0), false);
+	cmd_stream_close(s);
+	ok;
+}
+
+const char *suite_name = "game/stream";
+struct test tests[] = {
+	{ "missing", test_missing },
+	{ "bad_line", test_bad_line },
+	{ "play", test_play },
+	{ "record", test_record },
+	{ NULL, NULL }
+};
@@ -1,2 +1,11 @@
 TESTPROGS += game/basic \
-	game/mage
+	game/bonuses \
+	game/event \
+	game/lists \
+	game/mage \
+	game/monmsg \
+	game/profile \
+	game/score \
+	game/stream \
+	game/store \
+	game/terrain
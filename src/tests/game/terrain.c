@@ -0,0 +1,653 @@
+/* game/terrain.c */
+
+#include "unit-test.h"
+#include "test-utils.h"
+
+#include <stdio.h>
+#include "cave.h"
+#include "effects.h"
+#include "game-world.h"
+#include "generate.h"
+#include "init.h"
+#include "monster.h"
+#include "obj-pile.h"
+#include "player.h"
+#include "player-util.h"
+#include "project.h"
+#include "game-digest.h"
+#include "game-input.h"
+#include "savefile.h"
+#include "target.h"
+#include "trap.h"
+#include "z-util.h"
+
+int setup_tests(void **state) {
+	test_init_angband();
+	test_birth_character("Tester");
+	test_enter_level();
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	cleanup_angband();
+	return 0;
+}
+
+/* Whether the bitplanes of a chunk agree with its terrain everywhere */
+static bool planes_match(struct chunk *c) {
+	int y, x;
+
+	for (y = 0; y < c->height; y++) {
+		for (x = 0; x < c->width; x++) {
+			struct loc grid = loc(x, y);
+			int i = grid_to_i(grid, c->width);
+			int feat = c->feat[i];
+			bitflag *flags = f_info[feat].flags;
+
+			if (square_ispassable(c, grid) != tf_has(flags, TF_PASSABLE))
+				return false;
+			if (square_isprojectable(c, grid) != tf_has(flags, TF_PROJECT))
+				return false;
+			if (grid_plane_has(c->classes[GRID_CLASS_DOOR], i) !=
+				tf_has(flags, TF_DOOR_ANY))
+				return false;
+			if (grid_plane_has(c->classes[GRID_CLASS_OPEN], i) ==
+				tf_has(flags, TF_ROCK))
+				return false;
+			if (grid_plane_has(c->classes[GRID_CLASS_INTERESTING], i) !=
+				tf_has(flags, TF_INTERESTING))
+				return false;
+		}
+	}
+	return true;
+}
+
+int test_props(void *state) {
+	int i;
+
+	for (i = 0; i < z_info->f_max; i++) {
+		bitflag *flags = f_info[i].flags;
+
+		eq(feat_is_passable(i), tf_has(flags, TF_PASSABLE));
+		eq(feat_is_projectable(i), tf_has(flags, TF_PROJECT));
+		eq(feat_is_floor(i), tf_has(flags, TF_FLOOR));
+		eq(feat_is_wall(i), tf_has(flags, TF_WALL));
+	}
+	ok;
+}
+
+int test_planes(void *state) {
+	struct loc grid = loc(1, 1);
+	int feat = square(cave, grid).feat;
+
+	require(planes_match(cave));
+	require(planes_match(player->cave));
+
+	/* Changing the terrain keeps the planes current */
+	square_set_feat(cave, grid, FEAT_FLOOR);
+	require(square_ispassable(cave, grid));
+	require(square_isprojectable(cave, grid));
+	square_set_feat(cave, grid, FEAT_GRANITE);
+	require(!square_ispassable(cave, grid));
+	require(!square_isprojectable(cave, grid));
+	square_set_feat(cave, grid, FEAT_CLOSED);
+	require(grid_plane_has(cave->classes[GRID_CLASS_DOOR],
+		grid_to_i(grid, cave->width)));
+	require(grid_plane_has(cave->classes[GRID_CLASS_OPEN],
+		grid_to_i(grid, cave->width)));
+	square_set_feat(cave, grid, feat);
+	require(planes_match(cave));
+	ok;
+}
+
+int test_trap_planes(void *state) {
+	struct loc grid = loc(1, 1);
+	int i = grid_to_i(grid, cave->width);
+	int feat = square(cave, grid).feat;
+	struct trap_kind *kind = lookup_trap("trap door");
+
+	notnull(kind);
+	square_set_feat(cave, grid, FEAT_FLOOR);
+	require(!grid_plane_has(cave->trapped, i));
+
+	/* A new trap is hidden until it is revealed */
+	place_trap(cave, grid, kind->tidx, 1);
+	require(grid_plane_has(cave->trapped, i));
+	require(!grid_plane_has(cave->trap_seen, i));
+	require(!square_isvisibletrap(cave, grid));
+	eq(grid_plane_next(cave->trapped, 0, cave->height * cave->width), i);
+	require(square_reveal_trap(cave, grid, true, false));
+	require(grid_plane_has(cave->trap_seen, i));
+	require(square_isvisibletrap(cave, grid));
+
+	/* Removing it clears both planes */
+	require(square_remove_all_traps(cave, grid));
+	require(!grid_plane_has(cave->trapped, i));
+	require(!grid_plane_has(cave->trap_seen, i));
+	square_set_feat(cave, grid, feat);
+	ok;
+}
+
+/* Whether every grid in or next to an open grid has SQUARE_GLOW as given */
+static bool glow_near_open(struct chunk *c, bool glow) {
+	int y, x, d;
+
+	for (y = 1; y < c->height - 1; y++) {
+		for (x = 1; x < c->width - 1; x++) {
+			struct loc grid = loc(x, y);
+
+			if (square_seemslikewall(c, grid)) continue;
+			for (d = 0; d < 9; d++) {
+				struct loc adj = loc_sum(grid, ddgrid_ddd[d]);
+
+				if (square_isglow(c, adj) != glow)
+					return false;
+				if (!square_isfloor(c, adj) && square_isnotknown(c, adj))
+					return false;
+			}
+		}
+	}
+	return true;
+}
+
+int test_wiz_light(void *state) {
+	wiz_light(cave, player, false);
+	require(glow_near_open(cave, true));
+	wiz_dark(cave, player, false);
+	require(glow_near_open(cave, false));
+
+	/* Put the town's light back */
+	cave_illuminate(cave, true);
+	require(square_isglow(cave, player->grid));
+	cave_illuminate(cave, is_daytime());
+	ok;
+}
+
+int test_los(void *state) {
+	struct loc from = loc(2, 3), to = loc(14, 3), slant = loc(14, 5);
+	int old[3][13];
+	int y, x;
+
+	for (y = 0; y < 3; y++) {
+		for (x = 0; x < 13; x++) {
+			struct loc grid = loc(from.x + x, from.y + y);
+
+			old[y][x] = square(cave, grid).feat;
+			square_set_feat(cave, grid, FEAT_FLOOR);
+		}
+	}
+	require(los(cave, from, to));
+	require(los(cave, to, from));
+	require(los(cave, from, slant));
+
+	/* A new wall is seen by the remembered answers */
+	square_set_feat(cave, loc(8, 3), FEAT_GRANITE);
+	require(!los(cave, from, to));
+	require(!los(cave, to, from));
+	square_set_feat(cave, loc(8, 4), FEAT_GRANITE);
+	require(!los(cave, from, slant));
+
+	/* As is its removal */
+	square_set_feat(cave, loc(8, 3), FEAT_FLOOR);
+	square_set_feat(cave, loc(8, 4), FEAT_FLOOR);
+	require(los(cave, from, to));
+	require(los(cave, from, slant));
+
+	for (y = 0; y < 3; y++)
+		for (x = 0; x < 13; x++)
+			square_set_feat(cave, loc(from.x + x, from.y + y), old[y][x]);
+	require(planes_match(cave));
+	ok;
+}
+
+/* Whether the answers kept for the player's grid agree with the full tests */
+static bool to_player_match(struct chunk *c) {
+	int y, x;
+
+	for (y = 0; y < c->height; y++) {
+		for (x = 0; x < c->width; x++) {
+			struct loc grid = loc(x, y);
+
+			if (los_to_player(c, grid) != los(c, grid, player->grid))
+				return false;
+			if (projectable_to_player(c, grid) !=
+				projectable(c, grid, player->grid, PROJECT_NONE))
+				return false;
+		}
+	}
+	return true;
+}
+
+int test_to_player(void *state) {
+	struct loc wall = loc(player->grid.x + 3, player->grid.y);
+	int old = square(cave, wall).feat;
+
+	update_view(cave, player);
+	require(to_player_match(cave));
+
+	/* The view is out of date once the terrain changes */
+	square_set_feat(cave, wall, FEAT_GRANITE);
+	require(to_player_match(cave));
+	update_view(cave, player);
+	require(to_player_match(cave));
+
+	square_set_feat(cave, wall, old);
+	update_view(cave, player);
+	require(to_player_match(cave));
+	require(planes_match(cave));
+	ok;
+}
+
+int test_flows(void *state) {
+	struct loc step = loc(player->grid.x + 1, player->grid.y);
+	struct loc wall = loc(player->grid.x + 2, player->grid.y);
+	int old_step = square(cave, step).feat, old_wall = square(cave, wall).feat;
+
+	square_set_feat(cave, step, FEAT_FLOOR);
+	square_set_feat(cave, wall, FEAT_GRANITE);
+
+	/* Rock only stops noise */
+	make_noise(player);
+	update_flow(cave, FLOW_ROCK, player->grid, 0, player);
+	eq(square_noise(cave, step), 1);
+	eq(square_noise(cave, wall), 0);
+	eq(square_flow(cave, FLOW_ROCK, step), 1);
+	eq(square_flow(cave, FLOW_ROCK, wall), 2);
+
+	/* A limited flow stops there, and noise goes past the keenest hearing */
+	update_flow(cave, FLOW_ROCK, player->grid, 1, player);
+	eq(square_flow(cave, FLOW_ROCK, step), 1);
+	eq(square_flow(cave, FLOW_ROCK, wall), 0);
+	update_flow(cave, FLOW_ROCK, player->grid, 0, player);
+	eq(square_flow(cave, FLOW_ROCK, wall), 2);
+	require(cave->flows[FLOW_NOISE].limit >=
+			cave_monster_hearing(cave) + NOISE_MARGIN);
+
+	/* Permanent rock stops both, and is seen by the kept flow */
+	square_set_feat(cave, wall, FEAT_PERM);
+	require(cave->flows[FLOW_ROCK].stale);
+	update_flow(cave, FLOW_ROCK, player->grid, 0, player);
+	eq(square_flow(cave, FLOW_ROCK, wall), 0);
+
+	/* Other changes to rock leave it alone */
+	square_set_feat(cave, step, FEAT_MAGMA);
+	require(!cave->flows[FLOW_ROCK].stale);
+	require(cave->flows[FLOW_NOISE].stale);
+
+	square_set_feat(cave, wall, old_wall);
+	square_set_feat(cave, step, old_step);
+	require(planes_match(cave));
+	ok;
+}
+
+int test_digest(void *state) {
+	struct loc grid = loc(player->grid.x + 1, player->grid.y);
+	int old = square(cave, grid).feat;
+	struct game_digest d1, d2;
+	u32b feats;
+
+	game_digest(cave, player, &d1);
+	game_digest(cave, player, &d2);
+	require(!memcmp(&d1, &d2, sizeof(d1)));
+
+	/* The features digest is kept up to date as grids change */
+	square_set_feat(cave, grid, FEAT_RUBBLE);
+	game_digest(cave, player, &d2);
+	require(d2.feats != d1.feats);
+	eq(d2.rng, d1.rng);
+	feats = d2.feats;
+	cave->feat_digest_known = false;
+	eq(cave_feat_digest(cave), feats);
+
+	square_set_feat(cave, grid, old);
+	game_digest(cave, player, &d2);
+	eq(d2.feats, d1.feats);
+
+	/* Drawing a random number changes only that digest */
+	randint0(100);
+	game_digest(cave, player, &d2);
+	require(d2.rng != d1.rng);
+	eq(d2.player, d1.player);
+	eq(d2.monsters, d1.monsters);
+	eq(d2.objects, d1.objects);
+	require(planes_match(cave));
+	ok;
+}
+
+/* A panel showing the whole level */
+static void whole_panel(int *min_y, int *min_x, int *max_y, int *max_x) {
+	*min_y = 0;
+	*min_x = 0;
+	*max_y = cave->height;
+	*max_x = cave->width;
+}
+
+int test_targets(void *state) {
+	struct loc stair = loc(player->grid.x + 2, player->grid.y);
+	int old = square(cave, stair).feat;
+	struct point_set *targets;
+	int y, x, n = 0;
+
+	square_set_feat(cave, stair, FEAT_MORE);
+	square_memorize(cave, stair);
+	get_panel_hook = whole_panel;
+	targets = target_get_monsters(TARGET_LOOK, NULL);
+
+	/* The same grids as a look at every one would find, nearest first */
+	for (y = 0; y < cave->height; y++) {
+		for (x = 0; x < cave->width; x++) {
+			struct loc grid = loc(x, y);
+
+			if (!square_in_bounds_fully(cave, grid)) continue;
+			if (!target_accept(y, x)) continue;
+			require(point_set_contains(targets, grid));
+			n++;
+		}
+	}
+	eq(point_set_size(targets), n);
+	require(loc_eq(targets->pts[0], player->grid));
+	require(point_set_contains(targets, stair));
+
+	point_set_dispose(targets);
+	get_panel_hook = NULL;
+	square_set_feat(cave, stair, old);
+	require(planes_match(cave));
+	ok;
+}
+
+int test_paths(void *state) {
+	struct loc from = loc(2, 3), to = loc(14, 3);
+	struct loc path1[32], path2[32];
+	int old[13];
+	int x, n1, n2;
+
+	for (x = 0; x < 13; x++) {
+		old[x] = square(cave, loc(from.x + x, from.y)).feat;
+		square_set_feat(cave, loc(from.x + x, from.y), FEAT_FLOOR);
+	}
+	n1 = project_path(path1, z_info->max_range, from, to, PROJECT_NONE);
+	n2 = project_path(path2, z_info->max_range, from, to, PROJECT_NONE);
+	eq(n1, 12);
+	eq(n2, n1);
+	require(!memcmp(path1, path2, n1 * sizeof(struct loc)));
+	require(loc_eq(path2[n2 - 1], to));
+
+	/* The remembered path is dropped when the terrain changes */
+	square_set_feat(cave, loc(8, 3), FEAT_GRANITE);
+	n2 = project_path(path2, z_info->max_range, from, to, PROJECT_NONE);
+	eq(n2, 6);
+	require(loc_eq(path2[n2 - 1], loc(8, 3)));
+	require(!projectable(cave, from, to, PROJECT_NONE));
+
+	for (x = 0; x < 13; x++)
+		square_set_feat(cave, loc(from.x + x, from.y), old[x]);
+	ok;
+}
+
+/* Whether a cell search of a rectangle finds what a scan of every grid does */
+static bool cells_match(struct chunk *c, struct loc tl, struct loc br) {
+	struct loc mon = loc(tl.x - 1, tl.y), obj = mon;
+	int y, x;
+
+	for (y = MAX(tl.y, 0); y <= MIN(br.y, c->height - 1); y++) {
+		for (x = MAX(tl.x, 0); x <= MIN(br.x, c->width - 1); x++) {
+			struct loc grid = loc(x, y);
+
+			if (square(c, grid).mon > 0) {
+				if (!cave_next_monster_grid(c, tl, br, &mon)) return false;
+				if (!loc_eq(mon, grid)) return false;
+			}
+			if (square_object(c, grid)) {
+				if (!cave_next_object_grid(c, tl, br, &obj)) return false;
+				if (!loc_eq(obj, grid)) return false;
+			}
+		}
+	}
+	return !cave_next_monster_grid(c, tl, br, &mon) &&
+		!cave_next_object_grid(c, tl, br, &obj);
+}
+
+int test_cells(void *state) {
+	struct loc grid = loc(5, 6);
+	struct object *obj = object_new();
+	struct loc all_tl = loc(-3, -3);
+	struct loc all_br = loc(cave->width + 3, cave->height + 3);
+
+	require(cells_match(cave, all_tl, all_br));
+	require(cells_match(cave, loc(3, 2), loc(20, 9)));
+
+	/* A pile coming and going is counted */
+	require(!square_object(cave, grid));
+	square_insert_object(cave, grid, obj);
+	require(cells_match(cave, all_tl, all_br));
+	require(cells_match(cave, grid, grid));
+	square_excise_object(cave, grid, obj);
+	require(cells_match(cave, all_tl, all_br));
+	object_delete(&obj);
+
+	/* As is a monster */
+	square_set_mon(cave, grid, 1);
+	require(cells_match(cave, all_tl, all_br));
+	square_set_mon(cave, grid, 0);
+	require(cells_match(cave, all_tl, all_br));
+	ok;
+}
+
+int test_teleport(void *state) {
+	const char *dists[] = { "3", "10", "40", "200" };
+	size_t i;
+
+	for (i = 0; i < N_ELEMENTS(dists); i++) {
+		struct loc from = player->grid;
+		u32b stamp = cave->feat_stamp;
+
+		effect_simple(EF_TELEPORT, source_player(), dists[i], 0, 0, 0, 0, 0,
+					  NULL);
+		require(!loc_eq(player->grid, from));
+		require(square_isfloor(cave, player->grid));
+		eq(cave->floors.stamp, stamp);
+
+		/* Terrain changes make the next teleport rebuild the index */
+		square_set_feat(cave, from, square(cave, from).feat);
+		require(cave->floors.stamp != cave->feat_stamp);
+	}
+	ok;
+}
+
+/* Number of passable grids reachable from a grid, moving in all directions */
+static int count_reachable(struct chunk *c, struct loc start) {
+	struct loc *todo = mem_zalloc(c->height * c->width * sizeof(*todo));
+	bool *seen = mem_zalloc(c->height * c->width * sizeof(bool));
+	int n = 0, num = 0;
+
+	todo[num++] = start;
+	seen[grid_to_i(start, c->width)] = true;
+	while (n < num) {
+		struct loc grid = todo[n++];
+		int d;
+
+		for (d = 0; d < 8; d++) {
+			struct loc adj = loc_sum(grid, ddgrid_ddd[d]);
+			int i = grid_to_i(adj, c->width);
+
+			if (!square_in_bounds(c, adj) || seen[i]) continue;
+			if (!square_ispassable(c, adj)) continue;
+			seen[i] = true;
+			todo[num++] = adj;
+		}
+	}
+	mem_free(todo);
+	mem_free(seen);
+	return num;
+}
+
+int test_connect(void *state) {
+	struct chunk *c = cave_new(12, 40);
+	int rooms[4][2] = { { 2, 2 }, { 14, 3 }, { 26, 6 }, { 33, 2 } };
+	int y, x, i, floors = 0;
+
+	/* Four separate rooms in solid rock */
+	character_dungeon = false;
+	for (y = 0; y < c->height; y++)
+		for (x = 0; x < c->width; x++)
+			square_set_feat(c, loc(x, y), FEAT_GRANITE);
+	for (i = 0; i < 4; i++)
+		for (y = 0; y < 3; y++)
+			for (x = 0; x < 4; x++)
+				square_set_feat(c, loc(rooms[i][0] + x, rooms[i][1] + y),
+								FEAT_FLOOR);
+	eq(count_reachable(c, loc(2, 2)), 12);
+
+	ensure_connectedness(c);
+	character_dungeon = true;
+	for (y = 0; y < c->height; y++)
+		for (x = 0; x < c->width; x++)
+			if (square_ispassable(c, loc(x, y))) floors++;
+	require(floors > 48);
+	eq(count_reachable(c, loc(2, 2)), floors);
+	cave_free(c);
+	ok;
+}
+
+int test_pack(void *state) {
+	struct chunk *c = cave;
+	int size = c->height * c->width;
+	byte *feat = mem_alloc(size * sizeof(byte));
+	bitflag *info = mem_alloc(size * SQUARE_SIZE * sizeof(bitflag));
+	s16b *mon = mem_alloc(size * sizeof(s16b));
+	struct object **obj = mem_alloc(size * sizeof(struct object *));
+	struct trap **trap = mem_alloc(size * sizeof(struct trap *));
+	int i;
+
+	memcpy(feat, c->feat, size * sizeof(byte));
+	memcpy(info, c->info, size * SQUARE_SIZE * sizeof(bitflag));
+	memcpy(mon, c->mon, size * sizeof(s16b));
+	memcpy(obj, c->obj, size * sizeof(struct object *));
+	memcpy(trap, c->trap, size * sizeof(struct trap *));
+
+	cave_pack(c);
+	require(c->packed);
+	require(!c->feat && !c->info && !c->passable && !c->flows[FLOW_NOISE].grids);
+	require(c->packed->num_runs < size);
+	cave_unpack(c);
+	require(!c->packed);
+
+	for (i = 0; i < size; i++) {
+		eq(c->feat[i], feat[i]);
+		require(sqinfo_is_equal(&c->info[i * SQUARE_SIZE],
+								&info[i * SQUARE_SIZE]));
+		eq(c->mon[i], mon[i]);
+		ptreq(c->obj[i], obj[i]);
+		ptreq(c->trap[i], trap[i]);
+	}
+	require(planes_match(c));
+
+	mem_free(feat);
+	mem_free(info);
+	mem_free(mon);
+	mem_free(obj);
+	mem_free(trap);
+	ok;
+}
+
+int test_persist(void *state) {
+	struct chunk *first;
+
+	OPT(player, birth_levels_persist) = true;
+	dungeon_change_level(player, 1);
+	prepare_next_level(&cave, player);
+	on_new_level();
+	first = cave;
+
+	/* Going down stores the first level packed */
+	dungeon_change_level(player, 2);
+	prepare_next_level(&cave, player);
+	on_new_level();
+	require(first->packed && !first->feat);
+
+	/* Coming back brings it back as it was */
+	dungeon_change_level(player, 1);
+	prepare_next_level(&cave, player);
+	on_new_level();
+	ptreq(cave, first);
+	require(!cave->packed && cave->feat);
+	require(planes_match(cave));
+	require(!player->cave->packed);
+	require(square_in_bounds_fully(cave, player->grid));
+	eq(square(cave, player->grid).mon, -1);
+	ok;
+}
+
+/* How many monsters there are of all races together */
+static int race_total(void) {
+	int i, total = 0;
+
+	for (i = 0; i < z_info->r_max; i++)
+		total += r_info[i].cur_num;
+	return total;
+}
+
+int test_save_chunks(void *state) {
+	char *name = level_by_depth(2)->name;
+	struct chunk *stored = chunk_find_name(name);
+	int num = chunk_list_max, height, width, i, races;
+	byte *saved;
+	u32b size;
+
+	/* Level 2 is written once, and then what was written is reused */
+	require(stored && !stored->saved);
+	eq(savefile_save("Test1"), true);
+	require(stored->saved && stored->packed);
+	saved = stored->saved;
+	size = stored->saved_size;
+	height = stored->height;
+	width = stored->width;
+	eq(savefile_save("Test1"), true);
+	ptreq(stored->saved, saved);
+	eq(stored->saved_size, size);
+
+	/* And it comes back the same, once the old list is out of the way */
+	for (i = 0; i < chunk_list_max; i++)
+		cave_free(chunk_list[i]);
+	chunk_list_max = 0;
+	eq(savefile_load("Test1", false), true);
+	file_delete("Test1");
+	eq(chunk_list_max, num);
+
+	/* Stored levels are only read when they are wanted, and reading one
+	 * doesn't count its monsters twice */
+	for (i = 0; i < chunk_list_max; i++) {
+		require(chunk_list[i]->unread);
+		require(!chunk_list[i]->feat && !chunk_list[i]->packed);
+	}
+	races = race_total();
+	stored = chunk_find_name(name);
+	require(stored && !stored->unread && stored->packed);
+	eq(race_total(), races);
+	eq(stored->height, height);
+	eq(stored->width, width);
+	eq(stored->saved_size, size);
+	OPT(player, birth_levels_persist) = false;
+	ok;
+}
+
+const char *suite_name = "game/terrain";
+struct test tests[] = {
+	{ "props", test_props },
+	{ "planes", test_planes },
+	{ "trap_planes", test_trap_planes },
+	{ "wiz_light", test_wiz_light },
+	{ "los", test_los },
+	{ "to_player", test_to_player },
+	{ "flows", test_flows },
+	{ "digest", test_digest },
+	{ "targets", test_targets },
+	{ "paths", test_paths },
+	{ "cells", test_cells },
+	{ "teleport", test_teleport },
+	{ "connect", test_connect },
+	{ "pack", test_pack },
+	{ "persist", test_persist },
+	{ "save_chunks", test_save_chunks },
+	{ NULL, NULL }
+};
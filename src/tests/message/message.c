@@ -0,0 +1,99 @@
+/* message/message */
+
+#include "unit-test.h"
+#include "message.h"
+#include "z-form.h"
+
+int setup_tests(void **state) {
+	messages_init();
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	messages_free();
+	return 0;
+}
+
+int test_empty(void *state) {
+	eq(messages_num(), 0);
+	require(streq(message_str(0), ""));
+	eq(message_count(0), 0);
+	ok;
+}
+
+int test_add(void *state) {
+	message_add("one", MSG_GENERIC);
+	message_add("two", MSG_BELL);
+	eq(messages_num(), 2);
+	require(streq(message_str(0), "two"));
+	require(streq(message_str(1), "one"));
+	eq(message_type(0), MSG_BELL);
+	eq(message_type(1), MSG_GENERIC);
+	require(streq(message_str(2), ""));
+	ok;
+}
+
+int test_dedup(void *state) {
+	message_add("three", MSG_GENERIC);
+	message_add("three", MSG_GENERIC);
+	message_add("three", MSG_BELL);
+	eq(messages_num(), 4);
+	eq(message_count(0), 1);
+	eq(message_count(1), 2);
+	require(streq(message_str(1), "three"));
+	ok;
+}
+
+int test_wrap(void *state) {
+	char buf[200];
+	int i, j;
+
+	/* Enough long messages to wrap round the text more than once */
+	for (i = 0; i < 10000; i++) {
+		strnfmt(buf, sizeof(buf), "%d %0*d", i, (i * 7) % 150, 0);
+		message_add(buf, MSG_GENERIC);
+	}
+
+	require(messages_num() > 0);
+	require(messages_num() <= 2048);
+
+	/* Everything still stored is intact */
+	for (j = 0; j < messages_num(); j++) {
+		i = 9999 - j;
+		strnfmt(buf, sizeof(buf), "%d %0*d", i, (i * 7) % 150, 0);
+		require(streq(message_str(j), buf));
+	}
+	ok;
+}
+
+int test_format(void *state) {
+	char buf[400];
+	int i, j;
+
+	/* Formatted straight into the log, repeats counted as for adds */
+	msg("%s %d", "four", 4);
+	msg("%s %d", "four", 4);
+	require(streq(message_str(0), "four 4"));
+	eq(message_count(0), 2);
+
+	/* Wrapping as adds do, intact */
+	for (i = 0; i < 10000; i++)
+		msg("%d %0*d", i, (i * 11) % 300, 0);
+	require(messages_num() <= 2048);
+	for (j = 0; j < messages_num(); j++) {
+		i = 9999 - j;
+		strnfmt(buf, sizeof(buf), "%d %0*d", i, (i * 11) % 300, 0);
+		require(streq(message_str(j), buf));
+	}
+	ok;
+}
+
+const char *suite_name = "message/message";
+struct test tests[] = {
+	{ "empty", test_empty },
+	{ "add", test_add },
+	{ "dedup", test_dedup },
+	{ "wrap", test_wrap },
+	{ "format", test_format },
+	{ NULL, NULL }
+};
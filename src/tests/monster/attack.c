@@ -5,6 +5,7 @@
 
 #include "mon-attack.h"
 #include "mon-lore.h"
+#include "mon-spell.h"
 #include "monster.h"
 #include "option.h"
 #include "player-timed.h"
@@ -98,9 +99,36 @@ static int test_effects(void *state) {
 	ok;
 }
 
+int test_choose_spell(void *state) {
+	bitflag f[RSF_SIZE];
+
+	rsf_wipe(f);
+	rsf_on(f, RSF_SHRIEK);
+	rsf_on(f, RSF_BR_FIRE);
+	rsf_on(f, RSF_BLINK);
+	rsf_on(f, RSF_TPORT);
+
+	/* The first and last of the spells allowed */
+	rand_fix(0);
+	eq(choose_attack_spell(f, true, false), RSF_SHRIEK);
+	eq(choose_attack_spell(f, false, true), RSF_BLINK);
+	eq(choose_attack_spell(f, true, true), RSF_SHRIEK);
+	rand_fix(100);
+	eq(choose_attack_spell(f, true, false), RSF_BR_FIRE);
+	eq(choose_attack_spell(f, false, true), RSF_TPORT);
+	eq(choose_attack_spell(f, true, true), RSF_TPORT);
+
+	/* None allowed */
+	rsf_off(f, RSF_SHRIEK);
+	rsf_off(f, RSF_BR_FIRE);
+	eq(choose_attack_spell(f, true, false), 0);
+	ok;
+}
+
 const char *suite_name = "monster/attack";
 const struct test tests[] = {
 	{ "blows", test_blows },
 	{ "effects", test_effects },
+	{ "choose-spell", test_choose_spell },
 	{ NULL, NULL },
 };
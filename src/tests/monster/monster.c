@@ -9,6 +9,8 @@
 #include "unit-test.h"
 #include "unit-test-data.h"
 #include "test-utils.h"
+#include "mon-desc.h"
+#include "mon-lore.h"
 #include "mon-util.h"
 
 int setup_tests(void **state) {
@@ -43,8 +45,93 @@ int test_match_monster_bases(void *state) {
 	ok;
 }
 
+int test_monster_desc(void *state) {
+	struct monster mon;
+	char buf[80];
+
+	memset(&mon, 0, sizeof(mon));
+	mon.race = lookup_monster("Grip, Farmer Maggot's Dog");
+	monster_desc(buf, sizeof(buf), &mon, MDESC_SHOW);
+	require(streq(buf, "Grip, Farmer Maggot's Dog"));
+	monster_desc(buf, sizeof(buf), &mon, MDESC_HIDE | MDESC_POSS);
+	require(streq(buf, "its"));
+	monster_desc(buf, sizeof(buf), &mon, MDESC_HIDE | MDESC_IND_HID |
+		MDESC_CAPITAL);
+	require(streq(buf, "Something"));
+
+	mon.race = lookup_monster("Morgoth, Lord of Darkness");
+	monster_desc(buf, sizeof(buf), &mon, MDESC_SHOW | MDESC_PRO_VIS |
+		MDESC_POSS);
+	require(streq(buf, "his"));
+	monster_desc(buf, sizeof(buf), &mon, MDESC_HIDE | MDESC_PRO_HID |
+		MDESC_IND_HID | MDESC_POSS);
+	require(streq(buf, "someone's"));
+	monster_desc(buf, sizeof(buf), &mon, MDESC_SHOW | MDESC_OBJE |
+		MDESC_POSS);
+	require(streq(buf, "himself"));
+
+	mon.race = lookup_monster("cave spider");
+	monster_desc(buf, sizeof(buf), &mon, MDESC_SHOW | MDESC_IND_VIS);
+	require(streq(buf, "a cave spider"));
+	ok;
+}
+
+/**
+ * Write the lore file and find the counts line written for `name`
+ */
+static bool lore_counts(const char *name, char *counts, size_t len) {
+	ang_file *f = file_open("Lore1", MODE_WRITE, FTYPE_TEXT);
+	char buf[1024], want[120];
+	bool found = false;
+
+	write_lore_entries(f);
+	file_close(f);
+
+	strnfmt(want, sizeof(want), "name:%s", name);
+	f = file_open("Lore1", MODE_READ, FTYPE_TEXT);
+	while (file_getl(f, buf, sizeof(buf))) {
+		if (streq(buf, want)) {
+			found = file_getl(f, buf, sizeof(buf));
+			my_strcpy(counts, buf, len);
+			break;
+		}
+	}
+	file_close(f);
+	file_delete("Lore1");
+	return found;
+}
+
+int test_lore_entries(void *state) {
+	struct monster_race *dog = lookup_monster("Grip, Farmer Maggot's Dog");
+	struct monster_race *spider = lookup_monster("cave spider");
+	struct monster_lore *lore = get_lore(dog);
+	char counts[120];
+
+	get_lore(spider)->sights = 1;
+	lore->sights = 1;
+	require(lore_counts(dog->name, counts, sizeof(counts)));
+	require(streq(counts, "counts:1:0:0:0:0:0:0"));
+
+	/* A change to one race's lore shows in its entry */
+	lore->sights = 2;
+	lore->tkills = 3;
+	require(lore_counts(dog->name, counts, sizeof(counts)));
+	require(streq(counts, "counts:2:0:3:0:0:0:0"));
+	require(lore_counts(spider->name, counts, sizeof(counts)));
+	require(streq(counts, "counts:1:0:0:0:0:0:0"));
+
+	/* Unseen races are left out */
+	lore->sights = 0;
+	lore->tkills = 0;
+	require(!lore_counts(dog->name, counts, sizeof(counts)));
+	get_lore(spider)->sights = 0;
+	ok;
+}
+
 const char *suite_name = "monster/monster";
 struct test tests[] = {
 	{ "match_monster_bases", test_match_monster_bases },
+	{ "monster_desc", test_monster_desc },
+	{ "lore_entries", test_lore_entries },
 	{ NULL, NULL }
 };
@@ -0,0 +1,537 @@
+/* monster/schedule */
+
+#include "unit-test.h"
+#include "test-utils.h"
+
+#include <stdio.h>
+#include "cave.h"
+#include "effects.h"
+#include "game-world.h"
+#include "init.h"
+#include "mon-make.h"
+#include "mon-move.h"
+#include "mon-timed.h"
+#include "mon-util.h"
+#include "monster.h"
+#include "player.h"
+#include "source.h"
+#include "trap.h"
+#include "z-util.h"
+
+int setup_tests(void **state) {
+	test_init_angband();
+	test_birth_character("Tester");
+	test_enter_level();
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	cleanup_angband();
+	return 0;
+}
+
+/*
+ * Monsters are put in a corridor running the width of the level, far enough
+ * from the player at its west end that they can neither see nor hear them.
+ * Each is known by a number kept in its maximum hitpoints, which is the
+ * same wherever it is in the monster list.
+ *
+ * Alongside the game's schedule runs the old way of doing things: every
+ * monster not yet handled this turn is given its energy on every pass, in
+ * descending index order, and moves if it had enough before the gain.
+ */
+#define NUM_IDS 16
+#define ID_BASE 1000
+
+static int ref_energy[NUM_IDS];
+static bool ref_handled[NUM_IDS];
+static int num_ids;
+
+/* Monsters who moved this turn, in order, as the game and the model saw it */
+static int moved[NUM_IDS * 2], moved_num;
+static int ref_moved[NUM_IDS * 2], ref_moved_num;
+
+static int arena_y(void) {
+	return cave->height / 2;
+}
+
+static int mon_id(const struct monster *mon) {
+	return mon->maxhp - ID_BASE;
+}
+
+/* Clear the level, leaving the corridor with the player at one end */
+static void arena_new(void) {
+	struct loc grid;
+
+	wipe_mon_list(cave, player);
+	character_dungeon = false;
+	for (grid.y = 0; grid.y < cave->height; grid.y++) {
+		for (grid.x = 0; grid.x < cave->width; grid.x++) {
+			int feat = FEAT_GRANITE;
+			if (!square_in_bounds_fully(cave, grid))
+				feat = FEAT_PERM;
+			else if (grid.y == arena_y())
+				feat = FEAT_FLOOR;
+			square_set_feat(cave, grid, feat);
+		}
+	}
+	character_dungeon = true;
+	monster_swap(player->grid, loc(1, arena_y()));
+	update_view(cave, player);
+	make_noise(player);
+	monster_schedule_reset(cave);
+	num_ids = 0;
+}
+
+/* Put a dog `x` grids along the corridor */
+static struct monster *arena_monster(int x, int speed, int energy,
+									 bool held) {
+	struct monster_group_info info = { 0, 0 };
+	struct loc grid = loc(x, arena_y());
+	struct monster *mon;
+	int id = num_ids++;
+
+	if (!place_new_monster(cave, grid, lookup_monster("scruffy little dog"),
+						   false, false, info, ORIGIN_DROP))
+		return NULL;
+	mon = square_monster(cave, grid);
+	mon->mspeed = speed;
+	mon->maxhp = mon->hp = ID_BASE + id;
+
+	/* A held monster that can't see the player is never woken to use it up,
+	 * and isn't left dormant */
+	if (held)
+		mon->m_timed[MON_TMD_HOLD] = 50;
+	monster_set_energy(cave, mon, energy);
+	ref_energy[id] = energy;
+	ref_handled[id] = false;
+	return mon;
+}
+
+/* Find a monster by its number */
+static struct monster *arena_find(int id) {
+	int i;
+
+	for (i = 1; i < cave_monster_max(cave); i++) {
+		struct monster *mon = cave_monster(cave, i);
+		if (mon->race && mon_id(mon) == id) return mon;
+	}
+	return NULL;
+}
+
+/* A monster pass, as process_monsters() does it and as the model does */
+static void arena_pass(int minimum_energy) {
+	int i;
+
+	/* Only moves should be noted */
+	update_changed_monsters();
+	process_monsters(cave, minimum_energy);
+	for (i = 0; i < cave->mon_changed_num; i++)
+		moved[moved_num++] = mon_id(cave_monster(cave, cave->mon_changed[i]));
+	update_changed_monsters();
+
+	for (i = cave_monster_max(cave) - 1; i >= 1; i--) {
+		struct monster *mon = cave_monster(cave, i);
+		int id;
+		bool moving;
+
+		if (!mon->race) continue;
+		id = mon_id(mon);
+		if (ref_handled[id] || ref_energy[id] < minimum_energy) continue;
+		ref_handled[id] = true;
+		moving = ref_energy[id] >= z_info->move_energy;
+		ref_energy[id] += monster_turn_energy(mon);
+		if (moving) {
+			ref_energy[id] -= z_info->move_energy;
+			ref_moved[ref_moved_num++] = id;
+		}
+	}
+}
+
+/* Start a game turn */
+static void arena_turn(void) {
+	moved_num = ref_moved_num = 0;
+}
+
+/* Finish a game turn; check the order of moves if asked */
+static bool arena_end_turn(bool check_order) {
+	int i;
+	bool agree = true;
+
+	reset_monsters();
+	turn++;
+	for (i = 0; i < NUM_IDS; i++)
+		ref_handled[i] = false;
+
+	if (!check_order) return true;
+	if (moved_num != ref_moved_num) agree = false;
+	for (i = 0; agree && i < moved_num; i++)
+		if (moved[i] != ref_moved[i]) agree = false;
+	if (!agree)
+		printf("turn %d: %d moved, expected %d\n", turn - 1, moved_num,
+			   ref_moved_num);
+	return agree;
+}
+
+/* Check the energy of every monster which isn't dormant */
+static bool arena_energy_agrees(void) {
+	int i;
+
+	for (i = 1; i < cave_monster_max(cave); i++) {
+		struct monster *mon = cave_monster(cave, i);
+		int energy;
+
+		if (!mon->race || mflag_has(mon->mflag, MFLAG_DORMANT)) continue;
+		energy = monster_energy(cave, mon);
+		if (energy != ref_energy[mon_id(mon)]) {
+			printf("turn %d: monster %d energy %d, expected %d\n", turn,
+				   mon_id(mon), energy, ref_energy[mon_id(mon)]);
+			return false;
+		}
+	}
+	return true;
+}
+
+/* The energy for an extra pass before the final one in turn `k`, if any */
+static int arena_first_pass(int k) {
+	return (k % 3) ? 0 : z_info->move_energy + 1 + (k * 7) % 30;
+}
+
+/* Set up monsters of assorted speeds which don't act */
+static bool arena_held(int num) {
+	static const int speeds[] = { 110, 120, 100, 130, 115, 105, 125, 90 };
+	static const int energies[] = { 0, 40, 99, 10, 70, 100, 25, 130 };
+	int i;
+
+	arena_new();
+	for (i = 0; i < num; i++)
+		if (!arena_monster(36 + 2 * i, speeds[i % 8], energies[i % 8], true))
+			return false;
+	return true;
+}
+
+int test_order(void *state) {
+	int k;
+
+	require(arena_held(8));
+	for (k = 0; k < 250; k++) {
+		int first = arena_first_pass(k);
+
+		arena_turn();
+		if (first) arena_pass(first);
+		arena_pass(0);
+		require(arena_end_turn(true));
+		if (k % 10 == 0) require(arena_energy_agrees());
+	}
+	require(arena_energy_agrees());
+	ok;
+}
+
+/* Change the speeds of all the monsters in various ways */
+static void arena_change_speeds(int k) {
+	int i;
+
+	for (i = 0; i < num_ids; i++) {
+		struct monster *mon = arena_find(i);
+
+		switch ((i + k) % 4) {
+			case 0: {
+				mon_inc_timed(mon, MON_TMD_FAST, 50, MON_TMD_FLG_NOMESSAGE);
+				break;
+			}
+			case 1: {
+				mon_clear_timed(mon, MON_TMD_FAST, MON_TMD_FLG_NOMESSAGE);
+				break;
+			}
+			case 2: {
+				mon_inc_timed(mon, MON_TMD_SLOW, 10, MON_TMD_FLG_NOMESSAGE);
+				break;
+			}
+			default: {
+				int old_gain = monster_turn_energy(mon);
+				mon->mspeed += (k % 2) ? 7 : -7;
+				monster_speed_changed(cave, mon, old_gain);
+				break;
+			}
+		}
+	}
+}
+
+/* Set the energy of some of the monsters, so some are due straight away */
+static void arena_set_energies(int k) {
+	static const int energies[] = { 0, 99, 100, 150, 37, 120 };
+	int i;
+
+	for (i = 0; i < num_ids; i += 3) {
+		int id = (i + k) % num_ids;
+		int energy = energies[(i + k) % 6];
+
+		monster_set_energy(cave, arena_find(id), energy);
+		ref_energy[id] = energy;
+	}
+}
+
+/* Changes are made at the start of a turn, between passes when some monsters
+ * have had their energy for the turn, and after the final pass when they all
+ * have, as process_world() does */
+int test_speed_change(void *state) {
+	int k;
+
+	require(arena_held(8));
+	for (k = 0; k < 250; k++) {
+		int first = arena_first_pass(k);
+
+		arena_turn();
+		if (k % 25 == 0) arena_change_speeds(k);
+		if (first) arena_pass(first);
+		if (first && k % 25 == 12) arena_change_speeds(k);
+		arena_pass(0);
+		if (k % 25 == 18) arena_change_speeds(k);
+		require(arena_end_turn(true));
+		if (k % 10 == 0) require(arena_energy_agrees());
+	}
+	require(arena_energy_agrees());
+	ok;
+}
+
+int test_set_energy(void *state) {
+	int k;
+
+	require(arena_held(8));
+	for (k = 0; k < 250; k++) {
+		int first = arena_first_pass(k);
+
+		arena_turn();
+		if (k % 7 == 1) arena_set_energies(k);
+		if (first) arena_pass(first);
+		if (first && k % 7 == 3) arena_set_energies(k);
+		arena_pass(0);
+		if (k % 7 == 5) arena_set_energies(k);
+		require(arena_end_turn(true));
+		if (k % 10 == 0) require(arena_energy_agrees());
+	}
+	require(arena_energy_agrees());
+	ok;
+}
+
+/* Take monsters out of the middle of the list and compact it, moving
+ * monsters from the end into the holes */
+static void arena_compact(void) {
+	delete_monster_idx(cave_monster_max(cave) / 2);
+	delete_monster_idx(2);
+	compact_monsters(0);
+}
+
+int test_reindex(void *state) {
+	int k;
+
+	require(arena_held(12));
+	for (k = 0; k < 250; k++) {
+		int first = arena_first_pass(k);
+
+		arena_turn();
+		if (k == 30) arena_compact();
+		if (first) arena_pass(first);
+		if (first && k == 201) arena_compact();
+
+		/* Add another, which may reuse an index */
+		if (k == 60 || k == 150) {
+			notnull(arena_monster(30 + k / 30, 115, 60, true));
+		}
+		arena_pass(0);
+		if (k == 120) arena_compact();
+		require(arena_end_turn(true));
+		if (k % 10 == 0) require(arena_energy_agrees());
+	}
+	require(arena_energy_agrees());
+	ok;
+}
+
+/*
+ * A monster out of the player's reach is left dormant after its first move.
+ * Whatever brings it back must bring its energy up to where it would have
+ * been had it used its energy every turn, as the model does.
+ */
+static struct monster *arena_dormant(int x) {
+	struct monster *mon = arena_monster(x, 110, 30, false);
+	int k;
+
+	if (!mon) return NULL;
+	for (k = 0; k < 60; k++) {
+		arena_turn();
+		arena_pass(0);
+		arena_end_turn(false);
+	}
+	return mflag_has(mon->mflag, MFLAG_DORMANT) ? mon : NULL;
+}
+
+/* Run some turns, checking energy along the way */
+static bool arena_run(int num) {
+	int k;
+
+	for (k = 0; k < num; k++) {
+		int first = arena_first_pass(k);
+
+		arena_turn();
+		if (first) arena_pass(first);
+		arena_pass(0);
+		arena_end_turn(false);
+		if (!arena_energy_agrees()) return false;
+	}
+	return true;
+}
+
+/* Whether a monster is back in the schedule with the right energy */
+static bool arena_rejoined(const struct monster *mon) {
+	return !mflag_has(mon->mflag, MFLAG_DORMANT) && arena_energy_agrees();
+}
+
+int test_dormant_approach(void *state) {
+	struct monster *mon;
+	int k;
+
+	arena_new();
+	mon = arena_dormant(40);
+	notnull(mon);
+
+	/* Walk up to it; it mustn't be dormant by the time it can see the
+	 * player or hear them */
+	for (k = 0; k < 30; k++) {
+		struct loc next = loc_sum(player->grid, loc(1, 0));
+
+		if (!square_isempty(cave, next)) break;
+		monster_swap(player->grid, next);
+		update_view(cave, player);
+		make_noise(player);
+
+		arena_turn();
+		arena_pass(0);
+		arena_end_turn(false);
+		if (distance(player->grid, mon->grid) <= z_info->max_sight)
+			require(arena_rejoined(mon));
+	}
+	require(distance(player->grid, mon->grid) <= z_info->max_sight);
+	require(arena_run(20));
+	ok;
+}
+
+int test_dormant_noise(void *state) {
+	struct monster *mon;
+	struct loc decoy;
+
+	arena_new();
+	mon = arena_dormant(40);
+	notnull(mon);
+
+	/* Noise coming from near it wakes it up */
+	decoy = loc_sum(mon->grid, loc(-5, 0));
+	square_add_glyph(cave, decoy, GLYPH_DECOY);
+	make_noise(player);
+	require(arena_run(1));
+	require(arena_rejoined(mon));
+	require(arena_run(20));
+	square_destroy_decoy(cave, decoy);
+	make_noise(player);
+	ok;
+}
+
+int test_dormant_damage(void *state) {
+	struct monster *mon;
+	bool fear = false;
+
+	arena_new();
+	mon = arena_dormant(40);
+	notnull(mon);
+	require(!mon_take_hit(mon, 1, &fear, NULL));
+	require(arena_rejoined(mon));
+	require(arena_run(20));
+	require(arena_rejoined(mon));
+	ok;
+}
+
+int test_dormant_timed(void *state) {
+	struct monster *fast, *conf;
+
+	arena_new();
+	fast = arena_dormant(40);
+	notnull(fast);
+	conf = arena_dormant(44);
+	notnull(conf);
+
+	/* One changes speed as it comes back, the other doesn't */
+	require(mon_inc_timed(fast, MON_TMD_FAST, 20, MON_TMD_FLG_NOMESSAGE));
+	require(arena_rejoined(fast));
+	require(mflag_has(conf->mflag, MFLAG_DORMANT));
+	require(mon_inc_timed(conf, MON_TMD_CONF, 20, MON_TMD_FLG_NOMESSAGE));
+	require(arena_rejoined(conf));
+	require(arena_run(20));
+	require(arena_rejoined(fast));
+	require(arena_rejoined(conf));
+	ok;
+}
+
+int test_dormant_moved(void *state) {
+	struct monster *mon;
+
+	arena_new();
+	mon = arena_dormant(40);
+	notnull(mon);
+
+	/* Swapped into the next grid, and back again from the other side; it's
+	 * still far away, so it goes dormant again each time */
+	monster_swap(mon->grid, loc_sum(mon->grid, loc(1, 0)));
+	require(arena_rejoined(mon));
+	require(arena_run(30));
+	require(mflag_has(mon->mflag, MFLAG_DORMANT));
+	monster_swap(loc_sum(mon->grid, loc(-1, 0)), mon->grid);
+	require(arena_rejoined(mon));
+	require(arena_run(30));
+	require(mflag_has(mon->mflag, MFLAG_DORMANT));
+
+	/* Teleported */
+	effect_simple(EF_TELEPORT, source_monster(mon->midx), "3", 0, 0, 0, 0, 0,
+				  NULL);
+	require(arena_rejoined(mon));
+	require(arena_run(20));
+	ok;
+}
+
+int test_dormant_terrain(void *state) {
+	struct monster *rubble, *lava;
+
+	arena_new();
+	rubble = arena_dormant(40);
+	notnull(rubble);
+	lava = arena_dormant(44);
+	notnull(lava);
+
+	/* Terrain it can stand on, which doesn't hurt it */
+	square_set_feat(cave, rubble->grid, FEAT_PASS_RUBBLE);
+	require(arena_rejoined(rubble));
+
+	/* Terrain which hurts it */
+	require(mflag_has(lava->mflag, MFLAG_DORMANT));
+	square_set_feat(cave, lava->grid, FEAT_LAVA);
+	require(arena_rejoined(lava));
+	require(arena_run(20));
+	require(arena_rejoined(lava));
+
+	square_set_feat(cave, rubble->grid, FEAT_FLOOR);
+	square_set_feat(cave, lava->grid, FEAT_FLOOR);
+	ok;
+}
+
+const char *suite_name = "monster/schedule";
+struct test tests[] = {
+	{ "order", test_order },
+	{ "speed-change", test_speed_change },
+	{ "set-energy", test_set_energy },
+	{ "reindex", test_reindex },
+	{ "dormant-approach", test_dormant_approach },
+	{ "dormant-noise", test_dormant_noise },
+	{ "dormant-damage", test_dormant_damage },
+	{ "dormant-timed", test_dormant_timed },
+	{ "dormant-moved", test_dormant_moved },
+	{ "dormant-terrain", test_dormant_terrain },
+	{ NULL, NULL }
+};
@@ -0,0 +1,69 @@
+/* monster/summon */
+
+#include "unit-test.h"
+#include "test-utils.h"
+
+#include <stdio.h>
+#include "cave.h"
+#include "game-world.h"
+#include "init.h"
+#include "mon-summon.h"
+#include "monster.h"
+#include "player.h"
+#include "z-util.h"
+
+int setup_tests(void **state) {
+	test_init_angband();
+	test_birth_character("Tester");
+	test_enter_level();
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	cleanup_angband();
+	return 0;
+}
+
+/* Count the empty grids next to the player */
+static int empty_neighbours(void) {
+	int n = 0;
+	struct loc grid;
+
+	for (grid.y = player->grid.y - 1; grid.y <= player->grid.y + 1; grid.y++)
+		for (grid.x = player->grid.x - 1; grid.x <= player->grid.x + 1;
+			 grid.x++)
+			if (square_isempty(cave, grid)) n++;
+	return n;
+}
+
+int test_nearest(void *state) {
+	int type = summon_name_to_idx("ANIMAL");
+	int i, n, before = cave_monster_count(cave);
+	int first = cave_monster_max(cave);
+
+	require(type > 0);
+
+	/* Summons fill the grids next to the summoner first */
+	n = empty_neighbours();
+	require(n > 0);
+	for (i = 0; i < n; i++) {
+		require(summon_specific(player->grid, 10, type, false, false) > 0);
+		eq(empty_neighbours(), n - i - 1);
+	}
+	eq(cave_monster_count(cave), before + n);
+
+	/* Then spread further out */
+	require(summon_specific(player->grid, 10, type, false, false) > 0);
+	eq(cave_monster_count(cave), before + n + 1);
+	for (i = first; i < cave_monster_max(cave); i++) {
+		struct monster *mon = cave_monster(cave, i);
+		if (mon->race) require(distance(mon->grid, player->grid) <= 4);
+	}
+	ok;
+}
+
+const char *suite_name = "monster/summon";
+struct test tests[] = {
+	{ "nearest", test_nearest },
+	{ NULL, NULL }
+};
@@ -0,0 +1,97 @@
+/* object/knowledge */
+
+#include "unit-test.h"
+#include "unit-test-data.h"
+
+#include "object.h"
+#include "obj-desc.h"
+#include "obj-knowledge.h"
+#include "obj-make.h"
+#include "obj-util.h"
+
+static struct object obj, known;
+
+int setup_tests(void **state) {
+	player = &test_player;
+	z_info = mem_zalloc(sizeof(struct angband_constants));
+	object_prep(&obj, &test_torch, 1, AVERAGE);
+	object_prep(&known, &test_torch, 1, AVERAGE);
+	obj.known = &known;
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	mem_free(z_info);
+	return 0;
+}
+
+int test_uncached(void *state) {
+	obj.to_h = 3;
+	known.to_h = 0;
+	eq(object_runes_known(&obj), false);
+	known.to_h = 3;
+	eq(object_runes_known(&obj), true);
+	null(object_knowledge_cache(&obj));
+	ok;
+}
+
+int test_pass(void *state) {
+	bitflag flags[OF_SIZE];
+
+	known.to_h = 0;
+	of_wipe(obj.flags);
+	of_wipe(known.flags);
+	of_on(obj.flags, OF_SEE_INVIS);
+
+	object_knowledge_cache_begin();
+	eq(object_runes_known(&obj), false);
+	eq(object_fully_known(&obj), false);
+	object_flags_known(&obj, flags);
+	eq(of_has(flags, OF_SEE_INVIS), false);
+
+	/* Answers are remembered for the rest of the pass, nested or not */
+	known.to_h = 3;
+	of_on(known.flags, OF_SEE_INVIS);
+	object_knowledge_cache_begin();
+	eq(object_runes_known(&obj), false);
+	object_knowledge_cache_end();
+	object_flags_known(&obj, flags);
+	eq(of_has(flags, OF_SEE_INVIS), false);
+	object_knowledge_cache_end();
+
+	/* A new pass starts afresh */
+	object_knowledge_cache_begin();
+	eq(object_runes_known(&obj), true);
+	object_flags_known(&obj, flags);
+	eq(of_has(flags, OF_SEE_INVIS), true);
+	object_knowledge_cache_end();
+	ok;
+}
+
+int test_desc(void *state) {
+	char buf[80];
+
+	known.kind = obj.kind;
+	known.number = obj.number = 1;
+	object_knowledge_cache_begin();
+	object_desc(buf, sizeof(buf), &obj, ODESC_PREFIX | ODESC_BASE);
+	require(streq(buf, "Test Torch"));
+
+	/* Remembered descriptions still follow the number in the stack */
+	obj.number = 2;
+	object_desc(buf, sizeof(buf), &obj, ODESC_PREFIX | ODESC_BASE);
+	require(streq(buf, "2 Test Torch"));
+	object_desc(buf, sizeof(buf), &obj, ODESC_BASE);
+	require(streq(buf, "Test Torch"));
+	object_knowledge_cache_end();
+	obj.number = 1;
+	ok;
+}
+
+const char *suite_name = "object/knowledge";
+struct test tests[] = {
+	{ "uncached", test_uncached },
+	{ "pass", test_pass },
+	{ "desc", test_desc },
+	{ NULL, NULL }
+};
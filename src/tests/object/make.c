@@ -0,0 +1,86 @@
+/* object/make */
+
+#include "unit-test.h"
+#include "test-utils.h"
+
+#include "init.h"
+#include "obj-make.h"
+#include "obj-tval.h"
+#include "obj-util.h"
+#include "z-util.h"
+
+static void println(const char *str) {
+	printf("%s\n", str);
+}
+
+int setup_tests(void **state) {
+	plog_aux = println;
+	set_file_paths();
+	init_angband();
+	Rand_init();
+	return 0;
+}
+
+int teardown_tests(void **state) {
+	cleanup_angband();
+	return 0;
+}
+
+/* Whether a kind can be generated at a clamped level */
+static bool kind_allowed(const struct object_kind *kind, int level) {
+	if (!kind->alloc_prob) return false;
+	return level >= kind->alloc_min && level <= kind->alloc_max;
+}
+
+int test_any_tval(void *state) {
+	int level, n;
+
+	for (level = 0; level <= z_info->max_obj_depth; level += 5) {
+		for (n = 0; n < 200; n++) {
+			/* Without the level boost */
+			struct object_kind *kind = get_obj_num_at(level, false, 0);
+
+			notnull(kind);
+			require(kind_allowed(kind, level));
+		}
+	}
+	ok;
+}
+
+int test_good(void *state) {
+	int n;
+
+	for (n = 0; n < 500; n++) {
+		struct object_kind *kind = get_obj_num(30, true, 0);
+		notnull(kind);
+		require(kind->alloc_prob > 0);
+		require(kind_is_good(kind));
+	}
+	ok;
+}
+
+int test_by_tval(void *state) {
+	int tval = tval_find_idx("sword");
+	int level, n;
+
+	for (level = 0; level <= z_info->max_obj_depth; level += 10) {
+		for (n = 0; n < 100; n++) {
+			struct object_kind *kind = get_obj_num(level, false, tval);
+			notnull(kind);
+			eq(kind->tval, tval);
+			require(kind->alloc_prob > 0);
+		}
+	}
+
+	/* Chests never appear in town */
+	null(get_obj_num(0, false, tval_find_idx("chest")));
+	ok;
+}
+
+const char *suite_name = "object/make";
+struct test tests[] = {
+	{ "any-tval", test_any_tval },
+	{ "good", test_good },
+	{ "by-tval", test_by_tval },
+	{ NULL, NULL }
+};
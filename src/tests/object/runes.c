@@ -0,0 +1,81 @@
+/* object/runes */
+
+#include "unit-test.h"
+#include "test-utils.h"
+
+#include <stdio.h>
+#include "cave.h"
+#include "game-world.h"
+#include "init.h"
+#include "obj-gear.h"
+#include "obj-knowledge.h"
+#include "obj-make.h"
+#include "obj-pile.h"
+#include "obj-tval.h"
+#include "obj-util.h"
+#include "player.h"
+#include "z-util.h"
+
+int setup_tests(void **state) {
+	test_init_angband();
+	test_birth_character("Tester");
+	test_enter_level();
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	cleanup_angband();
+	return 0;
+}
+
+/* Give the player an assessed pack object, with flag unless it's FLAG_END */
+static struct object *carry(int flag) {
+	struct object_kind *kind =
+		lookup_kind(TV_FOOD, lookup_sval(TV_FOOD, "Ration of Food"));
+	struct object *obj = object_new();
+
+	object_prep(obj, kind, 0, AVERAGE);
+	if (flag != FLAG_END)
+		of_on(obj->flags, flag);
+	obj->known = object_new();
+	object_set_base_known(obj);
+	object_touch(player, obj);
+	inven_carry(player, obj, false, false);
+	return obj;
+}
+
+int test_flag(void *state) {
+	struct object *with = carry(OF_FREE_ACT);
+	struct object *without = carry(FLAG_END);
+
+	require(!of_has(player->obj_k->flags, OF_FREE_ACT));
+	eq(of_has(with->known->flags, OF_FREE_ACT), false);
+
+	/* Objects with the rune learn it */
+	player_learn_flag(player, OF_FREE_ACT);
+	eq(of_has(with->known->flags, OF_FREE_ACT), true);
+	eq(of_has(without->known->flags, OF_FREE_ACT), false);
+
+	/* Learning a known rune again passes it on to newly flagged objects */
+	of_on(without->flags, OF_FREE_ACT);
+	player_learn_flag(player, OF_FREE_ACT);
+	eq(of_has(without->known->flags, OF_FREE_ACT), true);
+	ok;
+}
+
+int test_all(void *state) {
+	struct object *obj = carry(OF_TELEPATHY);
+
+	require(!of_has(player->obj_k->flags, OF_TELEPATHY));
+	eq(of_has(obj->known->flags, OF_TELEPATHY), false);
+	player_learn_all_runes(player);
+	eq(of_has(obj->known->flags, OF_TELEPATHY), true);
+	ok;
+}
+
+const char *suite_name = "object/runes";
+struct test tests[] = {
+	{ "flag", test_flag },
+	{ "all", test_all },
+	{ NULL, NULL }
+};
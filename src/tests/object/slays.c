@@ -0,0 +1,138 @@
+/* object/slays */
+
+#include "unit-test.h"
+#include "test-utils.h"
+
+#include <stdio.h>
+#include "init.h"
+#include "mon-util.h"
+#include "monster.h"
+#include "obj-info.h"
+#include "obj-make.h"
+#include "obj-slays.h"
+#include "obj-util.h"
+#include "object.h"
+#include "player.h"
+#include "z-util.h"
+
+int setup_tests(void **state) {
+	test_init_angband();
+	test_birth_character("Tester");
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	cleanup_angband();
+	return 0;
+}
+
+static int brand_by_code(const char *code) {
+	int i;
+	for (i = 1; i < z_info->brand_max; i++)
+		if (streq(brands[i].code, code))
+			return i;
+	return 0;
+}
+
+static int slay_by_code(const char *code) {
+	int i;
+	for (i = 1; i < z_info->slay_max; i++)
+		if (streq(slays[i].code, code))
+			return i;
+	return 0;
+}
+
+int test_best(void *state) {
+	struct object obj;
+	struct monster mon;
+	bool obj_brands[64] = { false }, obj_slays[64] = { false };
+	int fire2 = brand_by_code("FIRE_2"), fire3 = brand_by_code("FIRE_3");
+	int orc3 = slay_by_code("ORC_3"), evil2 = slay_by_code("EVIL_2");
+	int pass, b, s;
+	char verb[20];
+
+	require(fire2 && fire3 && orc3 && evil2);
+	require(z_info->brand_max <= 64 && z_info->slay_max <= 64);
+	memset(&obj, 0, sizeof(obj));
+	memset(&mon, 0, sizeof(mon));
+	mon.race = lookup_monster("Snaga");
+	require(mon.race);
+	obj_brands[fire2] = true;
+	obj_slays[orc3] = true;
+	obj_slays[evil2] = true;
+	obj.brands = obj_brands;
+	obj.slays = obj_slays;
+
+	/* The same answers with or without the cache, and from it */
+	for (pass = 0; pass < 3; pass++) {
+		if (pass == 1) slay_cache_begin();
+
+		/* The best multiplier wins */
+		b = 0;
+		s = 0;
+		my_strcpy(verb, "hit", sizeof(verb));
+		improve_attack_modifier(&obj, &mon, &b, &s, verb, false);
+		eq(b, 0);
+		eq(s, orc3);
+		require(streq(verb, slays[orc3].melee_verb));
+
+		/* Nothing changes unless the multiplier is beaten */
+		b = fire3;
+		s = 0;
+		my_strcpy(verb, "hit", sizeof(verb));
+		improve_attack_modifier(&obj, &mon, &b, &s, verb, true);
+		eq(b, fire3);
+		eq(s, 0);
+		require(streq(verb, "hit"));
+	}
+	slay_cache_end();
+	ok;
+}
+
+int test_damage_races(void *state) {
+	struct object plain, plain_known, orcish, orcish_known;
+	const struct object *objs[2] = { &plain, &orcish };
+	struct object_kind *kind = lookup_kind(TV_SWORD,
+										   lookup_sval(TV_SWORD, "Dagger"));
+	struct monster_race *orc = lookup_monster("Snaga");
+	struct monster_race *dog = lookup_monster("Grip, Farmer Maggot's Dog");
+	bool orcish_slays[64] = { false };
+	int orc3 = slay_by_code("ORC_3");
+	int *damage = mem_zalloc(2 * z_info->r_max * sizeof(int));
+	int r, normal = -1;
+
+	require(kind && orc && dog && orc3);
+	require(z_info->slay_max <= 64);
+	object_prep(&plain, kind, 0, AVERAGE);
+	plain_known = plain;
+	plain.known = &plain_known;
+	object_prep(&orcish, kind, 0, AVERAGE);
+	orcish_slays[orc3] = true;
+	orcish.slays = orcish_slays;
+	orcish_known = orcish;
+	orcish.known = &orcish_known;
+
+	obj_known_damage_races(objs, 2, false, damage);
+
+	/* No slays, so the same against every race */
+	for (r = 0; r < z_info->r_max; r++) {
+		if (!r_info[r].name) continue;
+		if (normal < 0) normal = damage[r];
+		eq(damage[r], normal);
+	}
+	require(normal > 0);
+
+	/* The slay only works on orcs */
+	require(damage[z_info->r_max + orc->ridx] > normal);
+	eq(damage[z_info->r_max + dog->ridx], normal);
+
+	mem_free(damage);
+	ok;
+}
+
+const char *suite_name = "object/slays";
+struct test tests[] = {
+	{ "best", test_best },
+	{ "damage-races", test_damage_races },
+	{ NULL, NULL }
+};
@@ -1 +1,2 @@
-TESTPROGS += object/attack object/util object/pile
+TESTPROGS += object/attack object/util object/pile object/make object/knowledge \
+	object/runes object/slays
@@ -4,6 +4,7 @@
 #include "unit-test-data.h"
 
 #include "object.h"
+#include "obj-curse.h"
 #include "obj-make.h"
 #include "obj-pile.h"
 #include "obj-util.h"
@@ -60,8 +61,38 @@ int test_obj_can_refill(void *state) {
     ok;
 }
 
+/* Curses are kept in order of index, with no room for ones not there */
+int test_curse_list(void *state) {
+	struct object obj = OBJECT_NULL, copy = OBJECT_NULL;
+
+	object_curse_add(&obj, 5)->power = 20;
+	object_curse_add(&obj, 2)->power = 100;
+	object_curse_add(&obj, 9)->power = 40;
+	object_curse_add(&obj, 5)->power = 30;
+	eq(obj.num_curses, 3);
+	eq(obj.curses[0].index, 2);
+	eq(obj.curses[1].index, 5);
+	eq(obj.curses[2].index, 9);
+	eq(object_curse_power(&obj, 5), 30);
+	eq(object_curse_power(&obj, 3), 0);
+
+	object_curses_copy(&copy, &obj);
+	require(curses_are_equal(&obj, &copy));
+	object_curse_remove(&copy, 5);
+	require(!curses_are_equal(&obj, &copy));
+	eq(copy.curses[1].index, 9);
+
+	object_curse_remove(&copy, 2);
+	object_curse_remove(&copy, 9);
+	eq(copy.num_curses, 0);
+	null(copy.curses);
+	mem_free(obj.curses);
+	ok;
+}
+
 const char *suite_name = "object/util";
 struct test tests[] = {
     { "obj_can_refill", test_obj_can_refill },
+	{ "curse_list", test_curse_list },
     { NULL, NULL }
 };
@@ -119,6 +119,19 @@ int test_sym0(void *state) {
 	ok;
 }
 
+int test_supersede(void *state) {
+	int wasok = 0;
+	errr r = parser_reg(state, "test-supersede int foo", ignored);
+	eq(r, 0);
+	r = parser_reg(state, "test-supersede sym foo", helper_sym0);
+	eq(r, 0);
+	parser_setpriv(state, &wasok);
+	r = parser_parse(state, "test-supersede:bar");
+	eq(r, PARSE_ERROR_NONE);
+	eq(wasok, 1);
+	ok;
+}
+
 static enum parser_error helper_sym1(struct parser *p) {
 	const char *s = parser_getsym(p, "foo");
 	const char *t = parser_getsym(p, "baz");
@@ -140,6 +153,29 @@ int test_sym1(void *state) {
 	ok;
 }
 
+static enum parser_error helper_sym2(struct parser *p) {
+	const char *t = parser_getsym(p, "baz");
+	const char *s = parser_getsym(p, "foo");
+	const char *u = parser_getsym(p, "baz");
+	int *wasok = parser_priv(p);
+	if (!s || !t || !u || strcmp(s, "bar") || strcmp(t, "quxx") ||
+		strcmp(u, "quxx"))
+		return PARSE_ERROR_GENERIC;
+	*wasok = 1;
+	return PARSE_ERROR_NONE;
+}
+
+int test_sym2(void *state) {
+	int wasok = 0;
+	errr r = parser_reg(state, "test-sym2 sym foo sym baz", helper_sym2);
+	eq(r, 0);
+	parser_setpriv(state, &wasok);
+	r = parser_parse(state, "test-sym2:bar:quxx");
+	eq(r, PARSE_ERROR_NONE);
+	eq(wasok, 1);
+	ok;
+}
+
 static enum parser_error helper_int0(struct parser *p) {
 	int s = parser_getint(p, "i0");
 	int t = parser_getint(p, "i1");
@@ -417,7 +453,9 @@ struct test tests[] = {
 	{ "syntax2", test_syntax2 },
 
 	{ "sym0", test_sym0 },
+	{ "supersede", test_supersede },
 	{ "sym1", test_sym1 },
+	{ "sym2", test_sym2 },
 
 	{ "int0", test_int0 },
 	{ "int1", test_int1 },
@@ -0,0 +1,58 @@
+/* player/effects */
+
+#include "unit-test.h"
+#include "test-utils.h"
+
+#include <stdio.h>
+#include "cave.h"
+#include "effects.h"
+#include "game-world.h"
+#include "init.h"
+#include "player.h"
+#include "player-timed.h"
+#include "source.h"
+#include "z-util.h"
+
+int setup_tests(void **state) {
+	test_init_angband();
+	test_birth_character("Tester");
+	test_enter_level();
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	cleanup_angband();
+	return 0;
+}
+
+static void haste(const char *dice) {
+	effect_simple(EF_TIMED_INC, source_player(), dice, TMD_FAST, 0, 0, 0, 0,
+				  NULL);
+}
+
+int test_simple(void *state) {
+	player_clear_timed(player, TMD_FAST, false);
+
+	/* The same dice string gives the same result each time */
+	haste("10");
+	eq(player->timed[TMD_FAST], 10);
+	haste("10");
+	eq(player->timed[TMD_FAST], 20);
+
+	/* Different strings are told apart */
+	haste("7");
+	eq(player->timed[TMD_FAST], 27);
+	haste("10");
+	eq(player->timed[TMD_FAST], 37);
+	haste("3+0d4");
+	eq(player->timed[TMD_FAST], 40);
+
+	player_clear_timed(player, TMD_FAST, false);
+	ok;
+}
+
+const char *suite_name = "player/effects";
+struct test tests[] = {
+	{ "simple", test_simple },
+	{ NULL, NULL }
+};
@@ -0,0 +1,74 @@
+/* player/inventory */
+
+#include "unit-test.h"
+#include "test-utils.h"
+
+#include <stdio.h>
+#include "cave.h"
+#include "game-world.h"
+#include "init.h"
+#include "obj-gear.h"
+#include "obj-knowledge.h"
+#include "obj-pile.h"
+#include "obj-make.h"
+#include "obj-tval.h"
+#include "obj-util.h"
+#include "player.h"
+#include "player-calcs.h"
+#include "z-util.h"
+
+int setup_tests(void **state) {
+	test_init_angband();
+	test_birth_character("Tester");
+	test_enter_level();
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	cleanup_angband();
+	return 0;
+}
+
+/* Give the player one of a kind, made without magic */
+static void carry(int tval, const char *name, int number) {
+	struct object *obj = object_new();
+
+	object_prep(obj, lookup_kind(tval, lookup_sval(tval, name)), 0, AVERAGE);
+	obj->number = number;
+	obj->known = object_new();
+	object_set_base_known(obj);
+	object_touch(player, obj);
+	inven_carry(player, obj, false, false);
+}
+
+int test_order(void *state) {
+	int i, j;
+
+	carry(TV_ARROW, "Arrow", 20);
+	carry(TV_SHOT, "Iron Shot", 20);
+	carry(TV_FLASK, "Flask of Oil", 3);
+	carry(TV_FOOD, "Ration of Food", 2);
+	carry(TV_ARROW, "Seeker Arrow", 5);
+	calc_inventory(player->upkeep, player->gear, player->body);
+
+	/* Nothing in the pack or quiver comes after something it should precede */
+	for (i = 0; i < player->upkeep->inven_cnt; i++)
+		for (j = i + 1; j < player->upkeep->inven_cnt; j++)
+			eq(earlier_object(player->upkeep->inven[i],
+							  player->upkeep->inven[j], false), false);
+	null(player->upkeep->inven[player->upkeep->inven_cnt]);
+	for (i = 0; player->upkeep->quiver[i]; i++) {
+		require(tval_is_ammo(player->upkeep->quiver[i]));
+		for (j = i + 1; player->upkeep->quiver[j]; j++)
+			eq(earlier_object(player->upkeep->quiver[i],
+							  player->upkeep->quiver[j], false), false);
+	}
+	require(i >= 3);
+	ok;
+}
+
+const char *suite_name = "player/inventory";
+struct test tests[] = {
+	{ "order", test_order },
+	{ NULL, NULL }
+};
@@ -1,4 +1,6 @@
 TESTPROGS += player/birth \
+             player/effects \
              player/history \
+             player/inventory \
              player/pathfind \
              player/playerstat
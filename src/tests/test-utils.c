@@ -7,8 +7,13 @@
  */
 
 #include "h-basic.h"
+#include "cave.h"
+#include "cmd-core.h"
 #include "config.h"
+#include "game-world.h"
 #include "init.h"
+#include "player.h"
+#include "test-utils.h"
 #include "z-util.h"
 
 #ifdef SOUND_SDL
@@ -53,3 +58,49 @@ void read_edit_files(void) {
 	init_game_constants();
 	init_arrays();
 }
+
+static void println(const char *str) {
+	printf("%s\n", str);
+}
+
+/*
+ * Call this to initialise the game, printing any errors
+ */
+void test_init_angband(void) {
+	plog_aux = println;
+	set_file_paths();
+	init_angband();
+}
+
+/*
+ * Make a character with the first race and class; returns whether it lived
+ */
+bool test_birth_character(const char *name) {
+	return test_birth_race_class(name, 0, 0);
+}
+
+/*
+ * Make a character with the given race and class indices
+ */
+bool test_birth_race_class(const char *name, int race, int pclass) {
+	cmdq_push(CMD_BIRTH_INIT);
+	cmdq_push(CMD_BIRTH_RESET);
+	cmdq_push(CMD_CHOOSE_RACE);
+	cmd_set_arg_choice(cmdq_peek(), "choice", race);
+	cmdq_push(CMD_CHOOSE_CLASS);
+	cmd_set_arg_choice(cmdq_peek(), "choice", pclass);
+	cmdq_push(CMD_ROLL_STATS);
+	cmdq_push(CMD_NAME_CHOICE);
+	cmd_set_arg_string(cmdq_peek(), "name", name);
+	cmdq_push(CMD_ACCEPT_CHARACTER);
+	cmdq_execute(CTX_BIRTH);
+	return !player->is_dead;
+}
+
+/*
+ * Build the level the character is on, as happens when a game starts
+ */
+void test_enter_level(void) {
+	prepare_next_level(&cave, player);
+	on_new_level();
+}
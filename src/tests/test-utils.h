@@ -9,7 +9,13 @@
 #ifndef TEST_UTILS_H
 #define TEST_UTILS_H
 
+#include "h-basic.h"
+
 void set_file_paths(void);
 void read_edit_files(void);
+void test_init_angband(void);
+bool test_birth_character(const char *name);
+bool test_birth_race_class(const char *name, int race, int pclass);
+void test_enter_level(void);
 
 #endif /* TEST_UTIL_H */
@@ -0,0 +1,68 @@
+/* ui-keymap/keymap */
+
+#include "unit-test.h"
+#include "ui-event.h"
+#include "ui-keymap.h"
+
+NOSETUP
+
+int teardown_tests(void *state) {
+	keymap_free();
+	return 0;
+}
+
+static struct keypress key(keycode_t code, byte mods)
+{
+	struct keypress k = { EVT_KBRD, code, mods };
+	return k;
+}
+
+int test_find(void *state) {
+	struct keypress act[2] = { { EVT_KBRD, 'a', 0 }, KEYPRESS_NULL };
+	const struct keypress *found;
+	int i;
+
+	/* Enough keymaps that plenty share buckets */
+	for (i = 0; i < 1000; i++) {
+		act[0].code = i;
+		keymap_add(KEYMAP_MODE_ORIG, key(i, i % 3), act, true);
+	}
+	for (i = 0; i < 1000; i++) {
+		keycode_t want = i;
+
+		found = keymap_find(KEYMAP_MODE_ORIG, key(i, i % 3));
+		require(found != NULL);
+		eq(found[0].code, want);
+		null(keymap_find(KEYMAP_MODE_ORIG, key(i, i % 3 + 1)));
+	}
+	null(keymap_find(KEYMAP_MODE_ROGUE, key(1, 1)));
+	ok;
+}
+
+int test_replace_remove(void *state) {
+	struct keypress act[2] = { { EVT_KBRD, 'b', 0 }, KEYPRESS_NULL };
+	const struct keypress *found;
+	keycode_t want = 'b';
+
+	/* Adding again replaces the old action */
+	keymap_add(KEYMAP_MODE_ORIG, key(5, 2), act, true);
+	found = keymap_find(KEYMAP_MODE_ORIG, key(5, 2));
+	require(found != NULL);
+	eq(found[0].code, want);
+
+	eq(keymap_remove(KEYMAP_MODE_ORIG, key(5, 2)), true);
+	null(keymap_find(KEYMAP_MODE_ORIG, key(5, 2)));
+	eq(keymap_remove(KEYMAP_MODE_ORIG, key(5, 2)), false);
+	require(keymap_find(KEYMAP_MODE_ORIG, key(6, 0)) != NULL);
+
+	keymap_free();
+	null(keymap_find(KEYMAP_MODE_ORIG, key(6, 0)));
+	ok;
+}
+
+const char *suite_name = "ui-keymap/keymap";
+struct test tests[] = {
+	{ "find", test_find },
+	{ "replace-remove", test_replace_remove },
+	{ NULL, NULL }
+};
@@ -0,0 +1 @@
+TESTPROGS += ui-keymap/keymap
@@ -0,0 +1,208 @@
+/* ui-map/cache */
+
+#include "unit-test.h"
+#include "test-utils.h"
+
+#include <stdio.h>
+#include "cave.h"
+#include "game-world.h"
+#include "init.h"
+#include "obj-ignore.h"
+#include "obj-make.h"
+#include "obj-pile.h"
+#include "obj-tval.h"
+#include "obj-util.h"
+#include "player.h"
+#include "player-calcs.h"
+#include "ui-map.h"
+#include "ui-prefs.h"
+#include "ui-term.h"
+#include "z-util.h"
+
+static term test_term;
+
+int setup_tests(void **state) {
+	test_init_angband();
+	test_birth_character("Tester");
+	test_enter_level();
+
+	textui_prefs_init();
+	reset_visuals(false);
+	term_init(&test_term, 80, 24, 16);
+	Term_activate(&test_term);
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	term_nuke(&test_term);
+	map_cache_free();
+	textui_prefs_free();
+	cleanup_angband();
+	return 0;
+}
+
+/* The screen grid a map grid is shown in by prt_map() */
+static int *screen_attr(struct loc grid) {
+	int vy = grid.y - Term->offset_y + ROW_MAP;
+	int vx = grid.x - Term->offset_x + COL_MAP;
+
+	return &Term->scr->a[vy][vx];
+}
+
+static wchar_t screen_char(struct loc grid) {
+	int vy = grid.y - Term->offset_y + ROW_MAP;
+	int vx = grid.x - Term->offset_x + COL_MAP;
+
+	return Term->scr->c[vy][vx];
+}
+
+/* Whether the screen shows what map_info() says is in the grid */
+static bool shows_map_info(struct loc grid) {
+	struct grid_data g;
+	int a, ta;
+	wchar_t c, tc;
+
+	map_info(grid, &g);
+	grid_data_as_text(&g, &a, &c, &ta, &tc);
+	return (*screen_attr(grid) == a) && (screen_char(grid) == c);
+}
+
+/* A grid on the screen, away from the player */
+static struct loc some_grid(void) {
+	struct loc grid = loc(Term->offset_x + 1, Term->offset_y + 1);
+
+	if (loc_eq(grid, player->grid)) grid.x++;
+	return grid;
+}
+
+int test_prt_map(void *state) {
+	struct loc grid = some_grid();
+	int known = square(player->cave, grid).feat;
+	int other = (known == FEAT_FLOOR) ? FEAT_LESS : FEAT_FLOOR;
+
+	map_cache_forget_all();
+	prt_map();
+	require(shows_map_info(grid));
+	require(shows_map_info(player->grid));
+
+	/* A change nobody was told about is not seen... */
+	player->cave->feat[grid_to_i(grid, player->cave->width)] = other;
+	prt_map();
+	require(!shows_map_info(grid));
+
+	/* ...until the grid is forgotten */
+	map_cache_forget(grid);
+	prt_map();
+	require(shows_map_info(grid));
+
+	player->cave->feat[grid_to_i(grid, player->cave->width)] = known;
+	map_cache_forget(grid);
+	prt_map();
+	require(shows_map_info(grid));
+	ok;
+}
+
+/* Copy out the whole screen */
+static void save_screen(int *a, wchar_t *c) {
+	int y;
+
+	for (y = 0; y < Term->hgt; y++) {
+		memcpy(&a[y * Term->wid], Term->scr->a[y], Term->wid * sizeof(*a));
+		memcpy(&c[y * Term->wid], Term->scr->c[y], Term->wid * sizeof(*c));
+	}
+}
+
+int test_display_map(void *state) {
+	int n = Term->wid * Term->hgt;
+	int *a1 = mem_zalloc(n * sizeof(*a1)), *a2 = mem_zalloc(n * sizeof(*a2));
+	wchar_t *c1 = mem_zalloc(n * sizeof(*c1));
+	wchar_t *c2 = mem_zalloc(n * sizeof(*c2));
+	struct loc grid = loc(cave->width / 2, cave->height / 2);
+	int known = square(player->cave, grid).feat;
+	bool same;
+
+	Term_clear();
+	display_map(NULL, NULL);
+
+	/* Only the changed part of the overview is worked out again... */
+	player->cave->feat[grid_to_i(grid, player->cave->width)] = FEAT_LESS;
+	map_cache_forget(grid);
+	Term_clear();
+	display_map(NULL, NULL);
+	save_screen(a1, c1);
+
+	/* ...and looks the same as working out all of it */
+	map_cache_forget_all();
+	Term_clear();
+	display_map(NULL, NULL);
+	save_screen(a2, c2);
+	same = !memcmp(a1, a2, n * sizeof(*a1)) && !memcmp(c1, c2, n * sizeof(*c1));
+
+	player->cave->feat[grid_to_i(grid, player->cave->width)] = known;
+	map_cache_forget(grid);
+	mem_free(a1);
+	mem_free(a2);
+	mem_free(c1);
+	mem_free(c2);
+	require(same);
+	ok;
+}
+
+/* Put a new object of the given kind on the floor and let the player see it */
+static bool drop_kind(struct loc grid, struct object_kind *kind) {
+	struct object *obj = object_new();
+	bool note;
+
+	object_prep(obj, kind, 0, RANDOMISE);
+	if (!floor_carry(cave, grid, obj, &note)) return false;
+	square_know_pile(cave, grid);
+	return true;
+}
+
+int test_piles(void *state) {
+	struct loc grid = loc(1, 1);
+	struct object_kind *food = lookup_kind(TV_FOOD,
+		lookup_sval(TV_FOOD, "Ration of Food"));
+	struct object_kind *flask = lookup_kind(TV_FLASK,
+		lookup_sval(TV_FLASK, "Flask of Oil"));
+	struct grid_data g;
+
+	while (!square_isempty(cave, grid) || square_object(cave, grid)) {
+		if (++grid.x == cave->width - 1) {
+			grid.x = 1;
+			grid.y++;
+		}
+	}
+
+	/* What map_info() reports follows the pile as it changes... */
+	require(drop_kind(grid, food));
+	map_info(grid, &g);
+	ptreq(g.first_kind, food);
+	eq(g.multiple_objects, false);
+	require(drop_kind(grid, flask));
+	map_info(grid, &g);
+	notnull(g.first_kind);
+	eq(g.multiple_objects, true);
+
+	/* ...and the ignore settings */
+	kind_ignore_when_aware(food);
+	map_info(grid, &g);
+	ptreq(g.first_kind, flask);
+	eq(g.multiple_objects, false);
+	kind_ignore_clear(food);
+	map_info(grid, &g);
+	eq(g.multiple_objects, true);
+
+	square_excise_pile(player->cave, grid);
+	map_info(grid, &g);
+	null(g.first_kind);
+	ok;
+}
+
+const char *suite_name = "ui-map/cache";
+struct test tests[] = {
+	{ "prt_map", test_prt_map },
+	{ "display_map", test_display_map },
+	{ "piles", test_piles },
+	{ NULL, NULL }
+};
@@ -0,0 +1 @@
+TESTPROGS += ui-map/cache
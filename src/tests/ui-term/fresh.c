@@ -0,0 +1,316 @@
+/* ui-term/fresh */
+
+#include "unit-test.h"
+#include "ui-term.h"
+#include "z-color.h"
+
+static term test_term;
+
+/* What the last refresh asked the frontend to draw */
+static int calls, first_x, first_n, last_x, last_n;
+
+static void note_call(int x, int n) {
+	if (!calls++) {
+		first_x = x;
+		first_n = n;
+	}
+	last_x = x;
+	last_n = n;
+}
+
+static errr test_wipe(int x, int y, int n) {
+	note_call(x, n);
+	return 0;
+}
+
+static errr test_text(int x, int y, int n, int a, const wchar_t *s) {
+	note_call(x, n);
+	return 0;
+}
+
+static errr test_pict(int x, int y, int n, const int *ap, const wchar_t *cp,
+					  const int *tap, const wchar_t *tcp) {
+	note_call(x, n);
+	return 0;
+}
+
+static int batch_n;
+static struct term_glyph batch_last;
+
+static errr test_batch(const struct term_glyph *glyphs, int n) {
+	note_call(glyphs[0].x, n);
+	batch_n += n;
+	batch_last = glyphs[n - 1];
+	return 0;
+}
+
+static void fresh(void) {
+	calls = 0;
+	Term_fresh();
+}
+
+/* Mark the whole of row y as needing to be looked at */
+static void mark_row(int y) {
+	Term->x1[y] = 0;
+	Term->x2[y] = Term->wid - 1;
+	if (y < Term->y1) Term->y1 = y;
+	if (y > Term->y2) Term->y2 = y;
+}
+
+int setup_tests(void **state) {
+	term_init(&test_term, 80, 24, 16);
+	test_term.wipe_hook = test_wipe;
+	test_term.text_hook = test_text;
+	test_term.pict_hook = test_pict;
+	test_term.mapped_flag = true;
+	Term_activate(&test_term);
+	fresh();
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	term_nuke(&test_term);
+	return 0;
+}
+
+int test_text_runs(void *state) {
+	Term_putstr(10, 5, -1, COLOUR_WHITE, "hello");
+	fresh();
+	eq(calls, 1);
+	eq(first_x, 10);
+	eq(first_n, 5);
+
+	/* Nothing changed, however much is marked */
+	mark_row(5);
+	fresh();
+	eq(calls, 0);
+
+	/* Widely separated changes are drawn on their own */
+	Term_putstr(2, 5, -1, COLOUR_WHITE, "a");
+	Term_putstr(70, 5, -1, COLOUR_WHITE, "b");
+	fresh();
+	eq(calls, 2);
+	eq(first_x, 2);
+	eq(first_n, 1);
+	eq(last_x, 70);
+	eq(last_n, 1);
+
+	/* Changing the end of a word only draws the changed letters */
+	Term_putstr(10, 5, -1, COLOUR_WHITE, "help!");
+	mark_row(5);
+	fresh();
+	eq(calls, 1);
+	eq(first_x, 13);
+	eq(first_n, 2);
+	ok;
+}
+
+int test_pict_terrain(void *state) {
+	test_term.always_pict = true;
+
+	/* Bring the row's terrain up to date */
+	Term_queue_char(Term, 40, 7, COLOUR_WHITE, L'@', 0x81, L'.');
+	mark_row(7);
+	fresh();
+	mark_row(7);
+	fresh();
+	eq(calls, 0);
+
+	/* Only the terrain changes */
+	Term_queue_char(Term, 40, 7, COLOUR_WHITE, L'@', 0x82, L'#');
+	mark_row(7);
+	fresh();
+	eq(calls, 1);
+	eq(first_x, 40);
+	eq(first_n, 1);
+
+	test_term.always_pict = false;
+	ok;
+}
+
+int test_batch_frame(void *state) {
+	test_term.batch_hook = test_batch;
+	batch_n = 0;
+
+	/* All the changes in a frame come in one call, a grid at a time */
+	Term_putstr(0, 1, -1, COLOUR_RED, "ab");
+	Term_putstr(5, 1, -1, COLOUR_BLUE, "c");
+	Term_putstr(78, 20, -1, COLOUR_GREEN, "de");
+	fresh();
+	eq(calls, 1);
+	eq(batch_n, 5);
+	eq(first_x, 0);
+	eq(batch_last.x, 79);
+	eq(batch_last.y, 20);
+	eq(batch_last.a, COLOUR_GREEN);
+	require(batch_last.c == L'e');
+
+	/* No changes, no call */
+	mark_row(1);
+	fresh();
+	eq(calls, 0);
+
+	test_term.batch_hook = NULL;
+	ok;
+}
+
+int test_save_load(void *state) {
+	int a;
+	wchar_t c;
+
+	Term_putstr(0, 3, -1, COLOUR_WHITE, "under");
+	Term_putstr(0, 4, -1, COLOUR_WHITE, "below");
+	fresh();
+
+	/* A saved screen only holds the rows drawn over */
+	Term_save();
+	Term_putstr(2, 3, -1, COLOUR_RED, "XY");
+	require(Term->mem->held[3]);
+	require(!Term->mem->held[4]);
+
+	/* Nested saves keep the row as the first overlay left it */
+	Term_save();
+	Term_putstr(2, 3, -1, COLOUR_RED, "ZZ");
+	Term_load();
+	Term_what(2, 3, &a, &c);
+	eq(c, L'X');
+	fresh();
+
+	/* Loading marks only the span of the row that differs */
+	Term_load();
+	eq(Term->y1, 3);
+	eq(Term->y2, 3);
+	eq(Term->x1[3], 2);
+	eq(Term->x2[3], 3);
+	Term_what(2, 3, &a, &c);
+	eq(c, L'd');
+	eq(a, COLOUR_WHITE);
+	fresh();
+	eq(calls, 1);
+	eq(first_x, 2);
+	eq(first_n, 2);
+	ok;
+}
+
+static int idle_calls, wait_calls, wait_ms;
+
+static int test_idle(void) {
+	idle_calls++;
+	return 50;
+}
+
+static errr test_wait_hook(int ms) {
+	wait_ms = ms;
+	if (++wait_calls == 2) Term_keypress('k', 0);
+	return 0;
+}
+
+int test_wait(void *state) {
+	ui_event ke;
+
+	/* Waiting sleeps in the hook, doing the idle work once per period */
+	test_term.wait_hook = test_wait_hook;
+	Term_idle_hook = test_idle;
+	eq(Term_inkey(&ke, true, true), 0);
+	eq(ke.key.code, 'k');
+	eq(wait_calls, 2);
+	eq(idle_calls, 1);
+	require(wait_ms > 0 && wait_ms <= 50);
+
+	Term_idle_hook = NULL;
+	test_term.wait_hook = NULL;
+	ok;
+}
+
+static int test_frame_cap(void *state) {
+	Term_frame_ms = 1000000;
+	test_term.frame_at = 0;
+
+	/* The first frame goes out */
+	Term_putstr(0, 2, -1, COLOUR_WHITE, "one");
+	fresh();
+	eq(calls, 1);
+	eq(test_term.frame_held, false);
+
+	/* The next, too soon after, is held back */
+	Term_putstr(0, 3, -1, COLOUR_WHITE, "two");
+	fresh();
+	eq(calls, 0);
+	eq(test_term.frame_held, true);
+
+	/* Until the game pauses */
+	calls = 0;
+	Term_xtra(TERM_XTRA_DELAY, 0);
+	eq(calls, 1);
+	eq(first_x, 0);
+	eq(first_n, 3);
+	eq(test_term.frame_held, false);
+	Term_frame_ms = 0;
+
+	/* A term's own interval counts without the global one */
+	eq(term_frame_due(&test_term), true);
+	test_term.frame_ms = 1000000;
+	eq(term_frame_due(&test_term), false);
+	Term_putstr(0, 4, -1, COLOUR_WHITE, "three");
+	fresh();
+	eq(calls, 0);
+
+	test_term.frame_ms = 0;
+	fresh();
+	eq(calls, 1);
+	ok;
+}
+
+static byte observed[65536];
+static size_t observed_len;
+
+static void test_observe_hook(const byte *buf, size_t len) {
+	memcpy(observed, buf, MIN(len, sizeof(observed)));
+	observed_len = len;
+}
+
+static int test_observe(void *state) {
+	Term_observe_hook = test_observe_hook;
+
+	/* The first frame holds the whole term */
+	test_term.observe_frames = 0;
+	Term_putstr(0, 6, -1, COLOUR_WHITE, "x");
+	fresh();
+	eq(observed[0], 'F');
+	eq(observed[1], 255);
+	eq(observed[2] & 0x01, 0x01);
+	eq(observed[3] | (observed[4] << 8), 80);
+	eq(observed[5] | (observed[6] << 8), 24);
+	eq(observed[11] | (observed[12] << 8), 24);
+
+	/* Later ones only what changed */
+	Term_putstr(5, 20, -1, COLOUR_L_BLUE, "ab");
+	Term_putch(7, 20, COLOUR_L_BLUE, 0xe9);
+	fresh();
+	eq(observed[2] & 0x01, 0);
+	eq(observed[11] | (observed[12] << 8), 1);
+	eq(observed[13] | (observed[14] << 8), 20);
+	eq(observed[15] | (observed[16] << 8), 5);
+	eq(observed[17] | (observed[18] << 8), 3);
+	eq(observed[19] | (observed[20] << 8), COLOUR_L_BLUE);
+	eq(observed[21], 'a');
+	eq(observed[27], 'b');
+	eq(observed[33], 0xc3);
+	eq(observed[34], 0xa9);
+	eq(observed_len, 13 + 6 + 3 * 6 + 1);
+
+	Term_observe_hook = NULL;
+	ok;
+}
+
+const char *suite_name = "ui-term/fresh";
+struct test tests[] = {
+	{ "text-runs", test_text_runs },
+	{ "pict-terrain", test_pict_terrain },
+	{ "batch-frame", test_batch_frame },
+	{ "save-load", test_save_load },
+	{ "wait", test_wait },
+	{ "frame-cap", test_frame_cap },
+	{ "observe", test_observe },
+	{ NULL, NULL }
+};
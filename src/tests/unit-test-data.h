@@ -1153,7 +1153,12 @@ static struct chunk TEST_DATA test_cave = {
 	.feeling_squares = 0,
 	.feat_count = NULL,
 
-	.squares = NULL,
+	.feat = NULL,
+	.info = NULL,
+	.light = NULL,
+	.mon = NULL,
+	.obj = NULL,
+	.trap = NULL,
 
 	.monsters = NULL,
 	.mon_max = 1,
@@ -150,11 +150,27 @@ int test_evaluate(void *state)
 	ok;
 }
 
+int test_evaluate_order(void *state)
+{
+	expression_t *new = expression_new();
+
+	/* Division truncates at its place in the sequence */
+	expression_set_base_value(new, base_value_2);
+	expression_add_operations_string(new, "+ 7 / 3 * 3 + 1");
+	require(expression_evaluate(new) == 16);
+	expression_add_operations_string(new, "n + 1 / 4");
+	require(expression_evaluate(new) == -3);
+
+	expression_free(new);
+	ok;
+}
+
 const char *suite_name = "z-expression/expression";
 struct test tests[] = {
 	{ "alloc", test_alloc },
 	{ "parse-success", test_parse_success },
 	{ "parse-failure", test_parse_failure },
 	{ "evaluate", test_evaluate },
+	{ "evaluate-order", test_evaluate_order },
 	{ NULL, NULL },
 };
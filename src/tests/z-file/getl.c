@@ -0,0 +1,116 @@
+/* z-file/getl.c */
+
+#include "unit-test.h"
+#include "z-file.h"
+#include "z-form.h"
+#include "z-virt.h"
+
+#define TEST_FILE "z-file-getl.txt"
+
+static void write_test_file(const char *text, size_t len) {
+	ang_file *f = file_open(TEST_FILE, MODE_WRITE, FTYPE_TEXT);
+
+	file_write(f, text, len);
+	file_close(f);
+}
+
+int setup_tests(void **state) {
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	file_delete(TEST_FILE);
+	return 0;
+}
+
+int test_endings(void *state) {
+	const char text[] = "one\ntwo\r\nthree\rfour\r\rfive";
+	char buf[64];
+	ang_file *f;
+
+	write_test_file(text, sizeof(text) - 1);
+	f = file_open(TEST_FILE, MODE_READ, FTYPE_TEXT);
+	require(f);
+	require(file_getl(f, buf, sizeof(buf)) && streq(buf, "one"));
+	require(file_getl(f, buf, sizeof(buf)) && streq(buf, "two"));
+	require(file_getl(f, buf, sizeof(buf)) && streq(buf, "three"));
+	require(file_getl(f, buf, sizeof(buf)) && streq(buf, "four"));
+	require(file_getl(f, buf, sizeof(buf)) && streq(buf, "five"));
+	require(!file_getl(f, buf, sizeof(buf)));
+	file_close(f);
+	ok;
+}
+
+int test_tabs(void *state) {
+	const char text[] = "a\tb\n\tabcdefgh\n";
+	char buf[8];
+	ang_file *f;
+
+	write_test_file(text, sizeof(text) - 1);
+	f = file_open(TEST_FILE, MODE_READ, FTYPE_TEXT);
+	require(f);
+	require(file_getl(f, buf, sizeof(buf)) && streq(buf, "a   b"));
+
+	/* Long lines are split at the buffer size */
+	require(file_getl(f, buf, sizeof(buf)) && streq(buf, "    abc"));
+	require(file_getl(f, buf, sizeof(buf)) && streq(buf, "defgh"));
+	require(!file_getl(f, buf, sizeof(buf)));
+	file_close(f);
+	ok;
+}
+
+int test_long(void *state) {
+	/* Enough lines that reading them needs several refills */
+	size_t len = 0, size = 200000;
+	char *text = mem_alloc(size);
+	char buf[64], want[64];
+	ang_file *f;
+	int i, j;
+
+	for (i = 0; len + 32 < size; i++)
+		len += strnfmt(text + len, size - len, "line %d%s", i,
+			i % 3 ? "\n" : "\r\n");
+	write_test_file(text, len);
+	mem_free(text);
+
+	f = file_open(TEST_FILE, MODE_READ, FTYPE_TEXT);
+	require(f);
+	for (j = 0; j < i; j++) {
+		strnfmt(want, sizeof(want), "line %d", j);
+		require(file_getl(f, buf, sizeof(buf)) && streq(buf, want));
+	}
+	require(!file_getl(f, buf, sizeof(buf)));
+	file_close(f);
+	ok;
+}
+
+int test_mixed(void *state) {
+	const char text[] = "head\n0123456789tail\n";
+	char buf[64];
+	byte b;
+	ang_file *f;
+
+	write_test_file(text, sizeof(text) - 1);
+	f = file_open(TEST_FILE, MODE_READ, FTYPE_TEXT);
+	require(f);
+	require(file_getl(f, buf, sizeof(buf)) && streq(buf, "head"));
+
+	/* Byte reads and skips carry on from where the line left off */
+	require(file_readc(f, &b) && b == '0');
+	require(file_skip(f, 2));
+	require(file_read(f, buf, 3) == 3 && !memcmp(buf, "345", 3));
+	require(file_skip(f, 4));
+	require(file_getl(f, buf, sizeof(buf)) && streq(buf, "tail"));
+	require(!file_readc(f, &b));
+	file_close(f);
+	ok;
+}
+
+const char *suite_name = "z-file/getl";
+struct test tests[] = {
+	{ "endings", test_endings },
+	{ "tabs", test_tabs },
+	{ "long", test_long },
+	{ "mixed", test_mixed },
+	{ NULL, NULL }
+};
@@ -0,0 +1 @@
+TESTPROGS += z-file/getl
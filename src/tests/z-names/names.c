@@ -0,0 +1,52 @@
+/* z-names/names */
+
+#include "unit-test.h"
+#include "z-names.h"
+#include "z-form.h"
+
+NOSETUP
+NOTEARDOWN
+
+int test_find(void *state) {
+	struct name_table *t = name_table_new(2, true);
+	char name[20];
+	int i;
+
+	name_table_add(t, "Ration of Food", 1, 7);
+	name_table_add(t, "Ration of Food", 2, 8);
+	name_table_add(t, "ration of food", 1, 9);
+	eq(name_table_find(t, "RATION OF FOOD", 1), 7);
+	eq(name_table_find(t, "Ration of Food", 2), 8);
+	eq(name_table_find(t, "Ration of Food", 3), -1);
+	eq(name_table_find(t, "Ration", 1), -1);
+
+	/* Growing keeps everything */
+	for (i = 0; i < 100; i++) {
+		strnfmt(name, sizeof(name), "name %d", i);
+		name_table_add(t, name, 0, i);
+	}
+	for (i = 0; i < 100; i++) {
+		strnfmt(name, sizeof(name), "Name %d", i);
+		eq(name_table_find(t, name, 0), i);
+	}
+	eq(name_table_find(t, "ration of food", 1), 7);
+	name_table_free(t);
+	ok;
+}
+
+int test_case(void *state) {
+	struct name_table *t = name_table_new(4, false);
+
+	name_table_add(t, "granite wall", 0, 1);
+	eq(name_table_find(t, "granite wall", 0), 1);
+	eq(name_table_find(t, "Granite wall", 0), -1);
+	name_table_free(t);
+	ok;
+}
+
+const char *suite_name = "z-names/names";
+struct test tests[] = {
+	{ "find", test_find },
+	{ "case", test_case },
+	{ NULL, NULL }
+};
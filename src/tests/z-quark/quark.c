@@ -1,6 +1,7 @@
 /* z-quark/quark.c */
 
 #include "unit-test.h"
+#include "z-form.h"
 #include "z-quark.h"
 
 int setup_tests(void **state) {
@@ -46,9 +47,44 @@ int test_dedup(void *state) {
 	ok;
 }
 
+int test_grow(void *state) {
+	char buf[16];
+	quark_t qs[200];
+	int i;
+
+	for (i = 0; i < 200; i++) {
+		strnfmt(buf, sizeof(buf), "2-%d", i);
+		qs[i] = quark_add(buf);
+	}
+
+	/* Indices stay put as the table grows */
+	for (i = 0; i < 200; i++) {
+		strnfmt(buf, sizeof(buf), "2-%d", i);
+		require(quark_add(buf) == qs[i]);
+		require(!strcmp(quark_str(qs[i]), buf));
+	}
+
+	ok;
+}
+
+int test_many(void *state) {
+	const char *strs[] = { "3-foo", "3-bar", "3-foo", "0-foo" };
+	quark_t qs[4];
+
+	quark_add_many(strs, 4, qs);
+	require(!strcmp(quark_str(qs[0]), "3-foo"));
+	require(!strcmp(quark_str(qs[1]), "3-bar"));
+	require(qs[0] == qs[2]);
+	require(qs[3] == quark_add("0-foo"));
+
+	ok;
+}
+
 const char *suite_name = "z-quark/quark";
 struct test tests[] = {
 	{ "alloc", test_alloc },
 	{ "dedup", test_dedup },
+	{ "grow", test_grow },
+	{ "many", test_many },
 	{ NULL, NULL }
 };
@@ -0,0 +1,51 @@
+/* z-queue/queue */
+
+#include "unit-test.h"
+#include "z-queue.h"
+
+NOSETUP
+NOTEARDOWN
+
+int test_grow(void *state) {
+	struct queue *q = q_new(4);
+	int i, n;
+
+	/* Wrap the ring before it fills, so growing has to unwrap it */
+	for (i = 0; i < 3; i++) q_push_int(q, i);
+	n = q_pop_int(q);
+	eq(n, 0);
+	for (i = 3; i < 40; i++) q_push_int(q, i);
+	n = q_len(q);
+	eq(n, 39);
+	for (i = 1; i < 40; i++) {
+		n = q_pop_int(q);
+		eq(n, i);
+	}
+	n = q_len(q);
+	eq(n, 0);
+	q_free(q);
+	ok;
+}
+
+int test_reset(void *state) {
+	struct queue *q = q_new(2);
+	int n;
+
+	q_push_int(q, 7);
+	q_push_int(q, 8);
+	q_reset(q);
+	n = q_len(q);
+	eq(n, 0);
+	q_push_int(q, 9);
+	n = q_pop_int(q);
+	eq(n, 9);
+	q_free(q);
+	ok;
+}
+
+const char *suite_name = "z-queue/queue";
+struct test tests[] = {
+	{ "grow", test_grow },
+	{ "reset", test_reset },
+	{ NULL, NULL }
+};
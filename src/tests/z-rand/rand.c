@@ -0,0 +1,102 @@
+/* z-rand/rand */
+
+#include "unit-test.h"
+#include "z-rand.h"
+
+NOSETUP
+NOTEARDOWN
+
+/* The global functions and the _r ones on a copy draw the same numbers */
+int test_context(void *state) {
+	random_value v = { 2, 3, 6, 10 };
+	struct rng_state copy;
+	int i;
+
+	Rand_quick = false;
+	Rand_state_init(1234);
+	copy = Rand_default;
+	for (i = 0; i < 200; i++) {
+		eq(Rand_div(100), Rand_div_r(&copy, 100));
+		eq(Rand_normal(50, 10), Rand_normal_r(&copy, 50, 10));
+		eq(damroll(3, 8), damroll_r(&copy, 3, 8));
+		eq(randcalc(v, 40, RANDOMISE), randcalc_r(&copy, v, 40, RANDOMISE));
+	}
+
+	Rand_quick = true;
+	Rand_value = 42;
+	copy = Rand_default;
+	for (i = 0; i < 200; i++)
+		eq(randint0(1000), randint0_r(&copy, 1000));
+	Rand_quick = false;
+	ok;
+}
+
+/* Splitting is reproducible, leaves the parent alone and gives each stream
+ * different numbers */
+int test_split(void *state) {
+	struct rng_state parent, first, again, second, before;
+	int i, same = 0;
+
+	memset(&parent, 0, sizeof(parent));
+	Rand_state_init_r(&parent, 99);
+	before = parent;
+	Rand_split(&parent, 0, &first);
+	Rand_split(&parent, 0, &again);
+	Rand_split(&parent, 1, &second);
+	require(!memcmp(&parent, &before, sizeof(parent)));
+	require(!first.quick);
+
+	for (i = 0; i < 1000; i++) {
+		u32b a = Rand_div_r(&first, 0x10000000);
+
+		eq(a, Rand_div_r(&again, 0x10000000));
+		if (a == Rand_div_r(&second, 0x10000000)) same++;
+		if (a == Rand_div_r(&parent, 0x10000000)) same++;
+	}
+	require(same < 3);
+	ok;
+}
+
+/* The block functions draw the same stream as one value at a time */
+int test_fill(void *state) {
+	struct rng_state one;
+	u32b div[300];
+	s16b norm[50];
+	int dice[50];
+	int pass, i;
+
+	for (pass = 0; pass < 2; pass++) {
+		memset(&one, 0, sizeof(one));
+		if (pass) {
+			Rand_state_init_r(&one, 77);
+		} else {
+			one.quick = true;
+			one.value = 77;
+		}
+		Rand_default = one;
+
+		Rand_div_fill(37, div, 300);
+		Rand_normal_fill(100, 15, norm, 50);
+		damroll_fill(4, 6, dice, 50);
+		for (i = 0; i < 300; i++)
+			eq(div[i], Rand_div_r(&one, 37));
+		for (i = 0; i < 50; i++)
+			eq(norm[i], Rand_normal_r(&one, 100, 15));
+		for (i = 0; i < 50; i++) {
+			eq(dice[i], damroll_r(&one, 4, 6));
+			require(dice[i] >= 4 && dice[i] <= 24);
+		}
+		eq(Rand_default.value, one.value);
+		eq(Rand_default.state_i, one.state_i);
+	}
+	Rand_quick = false;
+	ok;
+}
+
+const char *suite_name = "z-rand/rand";
+struct test tests[] = {
+	{ "context", test_context },
+	{ "split", test_split },
+	{ "fill", test_fill },
+	{ NULL, NULL }
+};
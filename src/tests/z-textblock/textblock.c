@@ -3,6 +3,9 @@
 #include "unit-test.h"
 #include "z-color.h"
 #include "z-textblock.h"
+#include "z-virt.h"
+
+#include <sys/stat.h>
 
 int setup_tests(void **state) {
 	ok;
@@ -81,11 +84,88 @@ int test_length(void *state) {
 	ok;
 }
 
+int test_wrap(void *state) {
+	textblock *tb = textblock_new();
+	const size_t *starts, *lengths;
+	size_t *copy_starts = NULL, *copy_lengths = NULL;
+
+	textblock_append(tb, "one two three");
+	eq(textblock_wrap(tb, &starts, &lengths, 8), 2);
+	eq(starts[0], 0);
+	eq(lengths[0], 7);
+	eq(starts[1], 8);
+	eq(lengths[1], 5);
+
+	/* Wrapping again the same way gives back the same lines */
+	eq(textblock_wrap(tb, &starts, &lengths, 8), 2);
+	eq(lengths[1], 5);
+
+	/* Another width, or more text, wraps afresh */
+	eq(textblock_wrap(tb, &starts, &lengths, 80), 1);
+	eq(lengths[0], 13);
+	textblock_append(tb, " four");
+	eq(textblock_wrap(tb, &starts, &lengths, 80), 1);
+	eq(lengths[0], 18);
+
+	/* The copying version hands over arrays of its own */
+	eq(textblock_calculate_lines(tb, &copy_starts, &copy_lengths, 8), 3);
+	eq(copy_lengths[2], 4);
+	mem_free(copy_starts);
+	mem_free(copy_lengths);
+
+	textblock_free(tb);
+
+	/* A reused textblock starts empty */
+	tb = textblock_new();
+	require(!wcscmp(textblock_text(tb), L""));
+	eq(textblock_wrap(tb, &starts, &lengths, 8), 0);
+	textblock_free(tb);
+
+	ok;
+}
+
+static const char *lines_text = "first";
+
+static void write_lines(ang_file *f) {
+	file_putf(f, "%s\n", lines_text);
+}
+
+static ino_t lines_inode(void) {
+	struct stat st;
+
+	return stat("Lines1", &st) ? 0 : st.st_ino;
+}
+
+int test_lines_to_file(void *state) {
+	ino_t inode;
+
+	eq(text_lines_to_file("Lines1", write_lines), 0);
+	inode = lines_inode();
+	require(inode);
+
+	/* Writing the same again leaves the file alone */
+	eq(text_lines_to_file("Lines1", write_lines), 0);
+	eq(lines_inode(), inode);
+	eq(file_exists("Lines1.new"), false);
+
+	/* Something different replaces it */
+	lines_text = "second";
+	eq(text_lines_to_file("Lines1", write_lines), 0);
+	require(lines_inode() != inode);
+	eq(file_exists("Lines1.new"), false);
+	eq(file_exists("Lines1.old"), false);
+
+	file_delete("Lines1");
+	ok;
+}
+
 const char *suite_name = "z-textblock/textblock";
 struct test tests[] = {
 	{ "alloc", test_alloc },
 	{ "append", test_append },
 	{ "colour", test_colour },
 	{ "length", test_length },
+	{ "wrap", test_wrap },
+	{ "lines_to_file", test_lines_to_file },
 	{ NULL, NULL }
 };
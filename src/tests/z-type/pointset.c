@@ -0,0 +1,59 @@
+/* z-type/pointset.c */
+
+#include "unit-test.h"
+#include "z-type.h"
+#include "z-virt.h"
+
+NOSETUP
+NOTEARDOWN
+
+static int check_set(struct point_set *ps) {
+	int x, y;
+
+	/* Add every third grid of a 40x30 area, and one grid outside it */
+	for (y = 0; y < 30; y++)
+		for (x = 0; x < 40; x++)
+			if ((x + y) % 3 == 0)
+				add_to_point_set(ps, loc(x, y));
+	add_to_point_set(ps, loc(45, 2));
+
+	eq(point_set_size(ps), 401);
+	for (y = 0; y < 30; y++) {
+		for (x = 0; x < 40; x++) {
+			int want = ((x + y) % 3 == 0) ? 1 : 0;
+			eq(point_set_contains(ps, loc(x, y)), want);
+		}
+	}
+	eq(point_set_contains(ps, loc(45, 2)), 1);
+	eq(point_set_contains(ps, loc(-1, 2)), 0);
+	eq(point_set_contains(ps, loc(2, 30)), 0);
+
+	/* The points are still listed in the order they were added */
+	require(loc_eq(ps->pts[0], loc(0, 0)));
+	require(loc_eq(ps->pts[ps->n - 1], loc(45, 2)));
+
+	ok;
+}
+
+int test_plain(void *state) {
+	struct point_set *ps = point_set_new(8);
+	int result = check_set(ps);
+
+	point_set_dispose(ps);
+	return result;
+}
+
+int test_grid(void *state) {
+	struct point_set *ps = point_set_new_grid(8, 40, 30);
+	int result = check_set(ps);
+
+	point_set_dispose(ps);
+	return result;
+}
+
+const char *suite_name = "z-type/pointset";
+struct test tests[] = {
+	{ "plain", test_plain },
+	{ "grid", test_grid },
+	{ NULL, NULL }
+};
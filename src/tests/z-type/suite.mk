@@ -0,0 +1 @@
+TESTPROGS += z-type/pointset
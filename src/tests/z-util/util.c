@@ -41,8 +41,27 @@ int test_alloc(void *state) {
 	ok;
 }
 
+int test_mbstowcs(void *state) {
+	wchar_t buffer[16];
+
+	/* Plain ASCII, terminated */
+	eq(text_mbstowcs(buffer, "Angband", 16), 7);
+	require(buffer[0] == L'A' && buffer[6] == L'd' && buffer[7] == 0);
+
+	/* Stopping at the limit leaves it unterminated */
+	buffer[3] = L'x';
+	eq(text_mbstowcs(buffer, "Morgoth", 3), 3);
+	require(buffer[2] == L'r' && buffer[3] == L'x');
+
+	/* Just counting */
+	eq(text_mbstowcs(NULL, "Sauron", 0), 6);
+
+	ok;
+}
+
 const char *suite_name = "z-util/util";
 struct test tests[] = {
 	{ "utf8_clipto", test_alloc },
+	{ "text_mbstowcs", test_mbstowcs },
 	{ NULL, NULL }
 };
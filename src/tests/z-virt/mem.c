@@ -25,9 +25,84 @@ int test_realloc(void *state) {
 	return 0;
 }
 
+int test_realloc_classes(void *state) {
+	char *p = mem_alloc(10);
+	size_t i, len;
+
+	memcpy(p, "0123456789", 10);
+
+	/* Grow through several pool classes and out into malloc */
+	for (len = 20; len < 2000; len *= 2) {
+		p = mem_realloc(p, len);
+		require(!memcmp(p, "0123456789", 10));
+		memset(p + 10, 0x4, len - 10);
+	}
+
+	/* And back down again */
+	p = mem_realloc(p, 12);
+	require(!memcmp(p, "0123456789", 10));
+	for (i = 10; i < 12; i++)
+		require(p[i] == 0x4);
+	mem_free(p);
+	ok;
+}
+
+int test_reuse(void *state) {
+	void *p1 = mem_alloc(40);
+	void *p2;
+	mem_free(p1);
+	p2 = mem_alloc(48);
+	require(p1 == p2);
+	mem_free(p2);
+	ok;
+}
+
+int test_account(void *state) {
+	struct mem_tag_stats before, after;
+	enum mem_tag tag;
+	char *p1, *p2, *str;
+
+	mem_flags |= MEM_ACCOUNT;
+	mem_tag_get_stats(MEM_TAG_MONSTER, &before);
+
+	/* Blocks are counted against the tag current when they were made */
+	tag = mem_tag_set(MEM_TAG_MONSTER);
+	p1 = mem_alloc(100);
+	p2 = mem_alloc(1000);
+	str = string_make("not a monster");
+	eq(mem_tag_set(tag), MEM_TAG_MONSTER);
+	mem_tag_get_stats(MEM_TAG_MONSTER, &after);
+	eq(after.bytes, before.bytes + 1100);
+	eq(after.allocs, before.allocs + 2);
+	require(after.peak >= after.bytes);
+
+	/* ...and stay with it when they move or are freed */
+	p1 = mem_realloc(p1, 2000);
+	mem_free(p2);
+	mem_tag_get_stats(MEM_TAG_MONSTER, &after);
+	eq(after.bytes, before.bytes + 2000);
+	eq(after.frees, before.frees + 2);
+	mem_free(p1);
+	string_free(str);
+	mem_tag_get_stats(MEM_TAG_MONSTER, &after);
+	eq(after.bytes, before.bytes);
+
+	/* Resetting keeps what is in use */
+	mem_tag_reset();
+	mem_tag_get_stats(MEM_TAG_MONSTER, &after);
+	eq(after.peak, after.bytes);
+	eq(after.allocs, 0);
+
+	mem_flags &= ~MEM_ACCOUNT;
+	ok;
+}
+
 const char *suite_name = "z-virt/mem";
 struct test tests[] = {
 	{ "alloc", test_alloc },
 	{ "realloc", test_realloc },
+	{ "realloc-classes", test_realloc_classes },
+	{ "reuse", test_reuse },
+	{ "account", test_account },
 	{ NULL, NULL }
 };
@@ -59,6 +59,36 @@ int test_string_append_null2(void *state) {
 	ok;
 }
 
+int test_string_pool(void *state) {
+	char *s1 = string_pool_make("foo");
+	char *s2, *s3;
+
+	require(s1);
+	require(!strcmp(s1, "foo"));
+
+	/* The newest pooled string grows in place */
+	s2 = string_pool_append(s1, "bar");
+	require(s2 == s1);
+	require(!strcmp(s2, "foobar"));
+
+	/* An older one is copied */
+	s3 = string_pool_make("baz");
+	s1 = string_pool_append(s2, "qux");
+	require(s1 != s2);
+	require(!strcmp(s1, "foobarqux"));
+	require(!strcmp(s3, "baz"));
+
+	/* Freeing is a no-op, and appending with the heap copies out */
+	string_free(s3);
+	s2 = string_append(s1, "!");
+	require(s2 != s1);
+	require(!strcmp(s2, "foobarqux!"));
+	string_free(s2);
+
+	string_pool_free();
+	ok;
+}
+
 const char *suite_name = "z-virt/string";
 struct test tests[] = {
 	{ "make", test_string_make },
@@ -68,5 +98,6 @@ struct test tests[] = {
 	{ "append-null0", test_string_append_null0 },
 	{ "append-null1", test_string_append_null1 },
 	{ "append-null2", test_string_append_null2 },
+	{ "pool", test_string_pool },
 	{ NULL, NULL }
 };
@@ -275,6 +275,7 @@ void place_trap(struct chunk *c, struct loc grid, int t_idx, int trap_level)
 	new_trap->grid = grid;
 	new_trap->power = randcalc(new_trap->kind->power, trap_level, RANDOMISE);
 	trf_copy(new_trap->flags, trap_info[t_idx].flags);
+	square_note_traps(c, grid);
 
 	/* Toggle on the trap marker */
 	sqinfo_on(square(c, grid).info, SQUARE_TRAP);
@@ -339,6 +340,8 @@ bool square_reveal_trap(struct chunk *c, struct loc grid, bool always,
 
     /* We found at least one trap */
     if (found_trap) {
+		square_note_traps(c, grid);
+
 		/* We want to talk about it */
 		if (domsg) {
 			if (found_trap == 1)
@@ -380,13 +383,14 @@ void square_memorize_traps(struct chunk *c, struct loc grid)
 				current = next;
 			} else {
 				current = mem_zalloc(sizeof(*current));
-				player->cave->squares[grid.y][grid.x].trap = current;
+				square_set_trap(player->cave, grid, current);
 			}
 			memcpy(current, trap, sizeof(*trap));
 			current->next = NULL;
 		}
 		trap = trap->next;
 	}
+	square_note_traps(player->cave, grid);
 }
 
 /**
@@ -496,6 +500,7 @@ extern void hit_trap(struct loc grid, int delayed)
 
 		/* Trap becomes visible (always XXX) */
 		trf_on(trap->flags, TRF_VISIBLE);
+		square_note_traps(cave, grid);
 		square_memorize(cave, grid);
 	}
 
@@ -565,6 +570,7 @@ bool square_remove_trap(struct chunk *c, struct loc grid, int t_idx_remove)
 		prev_trap = trap;
 		trap = next_trap;
 	}
+	square_note_traps(c, grid);
 
 	/* Refresh grids that the character can see */
 	if (square_isseen(c, grid))
@@ -602,6 +608,7 @@ bool square_set_trap_timeout(struct chunk *c, struct loc grid, bool domsg,
 
 		/* Set the timer */
 		current_trap->timeout = time;
+		if (time) c->traps_timed = true;
 
 		/* Message if requested */
 		msg("You have disabled the %s.", current_trap->kind->name);
@@ -99,13 +99,13 @@ int curse_menu(struct object *obj, char *dice_string)
 	static region area = { 20, 1, -1, -2 };
 
 	/* Count and then list the curses */
-	for (i = 1; i < z_info->curse_max; i++) {
-		if ((obj->known->curses[i].power > 0) &&
-			(obj->known->curses[i].power < 100) &&
-			player_knows_curse(player, i)) {
-			available[count].index = i;
-			available[count].power = obj->curses[i].power;
-			length = MAX(length, strlen(curses[i].name) + 13);
+	for (i = 0; i < obj->known->num_curses; i++) {
+		struct curse_data *c = &obj->known->curses[i];
+		if ((c->power > 0) && (c->power < 100) &&
+			player_knows_curse(player, c->index)) {
+			available[count].index = c->index;
+			available[count].power = object_curse_power(obj, c->index);
+			length = MAX(length, strlen(curses[c->index].name) + 13);
 			count++;
 		}
 	}
@@ -531,6 +531,193 @@ static void prt_class(int row, int col) {
 }
 
 
+/**
+ * ------------------------------------------------------------------------
+ * Field memos
+ * ------------------------------------------------------------------------ */
+
+/**
+ * Most values a field is keyed on; the status line needs one per timed effect
+ */
+#define FIELD_KEY_MAX	(16 + TMD_MAX)
+
+/**
+ * Widest stretch of screen a field is checked over
+ */
+#define FIELD_WID_MAX	256
+
+/**
+ * What a sidebar or status field was last drawn from: the values that
+ * decide its text, where it went, and the cells it left behind.  A field
+ * whose values and place are unchanged, and whose cells are still on
+ * screen, is not formatted again; checking the cells rather than trusting
+ * the memo means clears, overlays and resizes need no bookkeeping here.
+ */
+struct field_memo {
+	term *t;
+	int row, col, wid;
+	int nkey;
+	s32b key[FIELD_KEY_MAX];
+	int a[FIELD_WID_MAX];
+	wchar_t c[FIELD_WID_MAX];
+};
+
+/**
+ * Fills key with the values a field is drawn from, returning how many
+ */
+typedef int field_key_f(s32b *key);
+
+/**
+ * True if the field would be drawn exactly as it already is
+ */
+static bool field_unchanged(const struct field_memo *m, const s32b *key,
+		int nkey, int row, int col, int wid)
+{
+	int i;
+
+	if (m->t != Term || m->row != row || m->col != col || m->wid != wid ||
+		m->nkey != nkey)
+		return false;
+	if (memcmp(m->key, key, nkey * sizeof(*key)))
+		return false;
+
+	for (i = 0; i < wid; i++) {
+		int a;
+		wchar_t c;
+
+		if (Term_what(col + i, row, &a, &c) || a != m->a[i] || c != m->c[i])
+			return false;
+	}
+
+	return true;
+}
+
+/**
+ * Note what a field was drawn from and what it left on screen
+ */
+static void field_remember(struct field_memo *m, const s32b *key, int nkey,
+		int row, int col, int wid)
+{
+	int i;
+
+	m->t = Term;
+	m->row = row;
+	m->col = col;
+	m->wid = wid;
+	m->nkey = nkey;
+	memcpy(m->key, key, nkey * sizeof(*key));
+
+	for (i = 0; i < wid; i++)
+		if (Term_what(col + i, row, &m->a[i], &m->c[i]))
+			m->t = NULL;
+}
+
+/**
+ * Key the sidebar fields on what they print
+ */
+static int key_race(s32b *key)
+{
+	key[0] = player_is_shapechanged(player);
+	key[1] = player->race->ridx;
+	return 2;
+}
+
+static int key_class(s32b *key)
+{
+	key[0] = player_is_shapechanged(player);
+	key[1] = player->class->cidx;
+	return 2;
+}
+
+static int key_level(s32b *key)
+{
+	key[0] = player->lev;
+	key[1] = player->max_lev;
+	return 2;
+}
+
+static int key_exp(s32b *key)
+{
+	key[0] = player->lev;
+	key[1] = player->exp;
+	key[2] = player->max_exp;
+	key[3] = player->expfact;
+	return 4;
+}
+
+static int key_gold(s32b *key)
+{
+	key[0] = player->au;
+	return 1;
+}
+
+static int key_stat(int stat, s32b *key)
+{
+	key[0] = player->stat_cur[stat] < player->stat_max[stat];
+	key[1] = player->state.stat_use[stat];
+	key[2] = player->stat_max[stat] == 18+100;
+	return 3;
+}
+
+static int key_str(s32b *key) { return key_stat(STAT_STR, key); }
+static int key_int(s32b *key) { return key_stat(STAT_INT, key); }
+static int key_wis(s32b *key) { return key_stat(STAT_WIS, key); }
+static int key_dex(s32b *key) { return key_stat(STAT_DEX, key); }
+static int key_con(s32b *key) { return key_stat(STAT_CON, key); }
+
+static int key_ac(s32b *key)
+{
+	key[0] = player->known_state.ac + player->known_state.to_a;
+	return 1;
+}
+
+static int key_hp(s32b *key)
+{
+	key[0] = player->chp;
+	key[1] = player->mhp;
+	key[2] = player_hp_attr(player);
+	return 3;
+}
+
+static int key_sp(s32b *key)
+{
+	key[0] = !player_has(player, PF_NO_MANA) &&
+		(player->lev >= player->class->magic.spell_first);
+	key[1] = player->csp;
+	key[2] = player->msp;
+	key[3] = player_sp_attr(player);
+	return 4;
+}
+
+static int key_health(s32b *key)
+{
+	struct monster *mon = player->upkeep->health_who;
+
+	key[0] = mon != NULL;
+	key[1] = monster_health_attr();
+	key[2] = 0;
+	if (mon && monster_is_visible(mon) && !player->timed[TMD_IMAGE] &&
+		(mon->hp >= 0)) {
+		int pct = 100L * mon->hp / mon->maxhp;
+		key[2] = (pct < 10) ? 1 : (pct < 90) ? (pct / 10 + 1) : 10;
+	}
+	return 3;
+}
+
+static int key_speed(s32b *key)
+{
+	key[0] = player->state.speed;
+	key[1] = OPT(player, effective_speed);
+	return 2;
+}
+
+static int key_depth(s32b *key)
+{
+	key[0] = player->depth;
+	return 1;
+}
+
+
 /**
  * Struct of sidebar handlers.
  */
@@ -539,32 +726,62 @@ static const struct side_handler_t
 	void (*hook)(int, int);	 /* int row, int col */
 	int priority;		 /* 1 is most important (always displayed) */
 	game_event_type type;	 /* PR_* flag this corresponds to */
+	field_key_f *key;	 /* What the field shows, or NULL to always draw */
 } side_handlers[] = {
-	{ prt_race,    19, EVENT_RACE_CLASS },
-	{ prt_title,   18, EVENT_PLAYERTITLE },
-	{ prt_class,   22, EVENT_RACE_CLASS },
-	{ prt_level,   10, EVENT_PLAYERLEVEL },
-	{ prt_exp,     16, EVENT_EXPERIENCE },
-	{ prt_gold,    11, EVENT_GOLD },
-	{ prt_equippy, 17, EVENT_EQUIPMENT },
-	{ prt_str,      6, EVENT_STATS },
-	{ prt_int,      5, EVENT_STATS },
-	{ prt_wis,      4, EVENT_STATS },
-	{ prt_dex,      3, EVENT_STATS },
-	{ prt_con,      2, EVENT_STATS },
-	{ NULL,        15, 0 },
-	{ prt_ac,       7, EVENT_AC },
-	{ prt_hp,       8, EVENT_HP },
-	{ prt_sp,       9, EVENT_MANA },
-	{ NULL,        21, 0 },
-	{ prt_health,  12, EVENT_MONSTERHEALTH },
-	{ NULL,        20, 0 },
-	{ NULL,        22, 0 },
-	{ prt_speed,   13, EVENT_PLAYERSPEED }, /* Slow (-NN) / Fast (+NN) */
-	{ prt_depth,   14, EVENT_DUNGEONLEVEL }, /* Lev NNN / NNNN ft */
+	{ prt_race,    19, EVENT_RACE_CLASS,     key_race },
+	{ prt_title,   18, EVENT_PLAYERTITLE,    NULL },
+	{ prt_class,   22, EVENT_RACE_CLASS,     key_class },
+	{ prt_level,   10, EVENT_PLAYERLEVEL,    key_level },
+	{ prt_exp,     16, EVENT_EXPERIENCE,     key_exp },
+	{ prt_gold,    11, EVENT_GOLD,           key_gold },
+	{ prt_equippy, 17, EVENT_EQUIPMENT,      NULL },
+	{ prt_str,      6, EVENT_STATS,          key_str },
+	{ prt_int,      5, EVENT_STATS,          key_int },
+	{ prt_wis,      4, EVENT_STATS,          key_wis },
+	{ prt_dex,      3, EVENT_STATS,          key_dex },
+	{ prt_con,      2, EVENT_STATS,          key_con },
+	{ NULL,        15, 0,                    NULL },
+	{ prt_ac,       7, EVENT_AC,             key_ac },
+	{ prt_hp,       8, EVENT_HP,             key_hp },
+	{ prt_sp,       9, EVENT_MANA,           key_sp },
+	{ NULL,        21, 0,                    NULL },
+	{ prt_health,  12, EVENT_MONSTERHEALTH,  key_health },
+	{ NULL,        20, 0,                    NULL },
+	{ NULL,        22, 0,                    NULL },
+	{ prt_speed,   13, EVENT_PLAYERSPEED,    key_speed }, /* Slow (-NN) / Fast (+NN) */
+	{ prt_depth,   14, EVENT_DUNGEONLEVEL,   key_depth }, /* Lev NNN / NNNN ft */
 };
 
 
+/**
+ * What each sidebar row last showed
+ */
+static struct field_memo side_memo[N_ELEMENTS(side_handlers)];
+
+
+/**
+ * Draw one sidebar field, unless it would come out as it already is
+ */
+static void side_field(size_t i, int row)
+{
+	const struct side_handler_t *hnd = &side_handlers[i];
+	struct field_memo *m = &side_memo[i];
+	s32b key[FIELD_KEY_MAX];
+	int nkey, wid = MIN(COL_MAP, Term->wid);
+
+	if (!hnd->key) {
+		hnd->hook(row, 0);
+		return;
+	}
+
+	nkey = hnd->key(key);
+	if (field_unchanged(m, key, nkey, row, 0, wid)) return;
+
+	hnd->hook(row, 0);
+	field_remember(m, key, nkey, row, 0, wid);
+}
+
+
 /**
  * This prints the sidebar, using a clever method which means that it will only
  * print as much as can be displayed on <24-line screens.
@@ -602,9 +819,9 @@ static void update_sidebar(game_event_type type, game_event_data *data,
 		if (priority <= max_priority) {
 			if (hnd->type == type && hnd->hook) {
 				if (from_bottom)
-					hnd->hook(Term->hgt - (N_ELEMENTS(side_handlers) - i), 0);
+					side_field(i, Term->hgt - (N_ELEMENTS(side_handlers) - i));
 				else
-				    hnd->hook(row, 0);
+					side_field(i, row);
 			}
 
 			/* Increment for next time */
@@ -959,6 +1176,51 @@ static status_f *status_handlers[] =
 { prt_level_feeling, prt_light, prt_unignore, prt_recall, prt_descent,
   prt_state, prt_study, prt_tmd, prt_dtrap };
 
+/**
+ * What the status line last showed
+ */
+static struct field_memo status_memo;
+
+
+/**
+ * Key the status line on everything its handlers print
+ */
+static int key_status(s32b *key)
+{
+	int i, n = 0;
+
+	key[n++] = OPT(player, birth_feelings) ? player->depth : -1;
+	key[n++] = cave->feeling;
+	key[n++] = cave->feeling_squares < z_info->feeling_need;
+	key[n++] = square_light(cave, player->grid);
+	key[n++] = player->unignoring;
+	key[n++] = player->word_recall != 0;
+	key[n++] = player->deep_descent != 0;
+	key[n++] = player_is_resting(player) ? player_resting_count(player) : 0;
+	key[n++] = player_is_resting(player) ? 0 : cmd_get_nrepeats();
+	key[n++] = player->upkeep->new_spells;
+	key[n++] = player->upkeep->new_spells ?
+		player_book_has_unlearned_spells(player) : 0;
+	key[n++] = square_isdtrap(cave, player->grid) ?
+		1 + square_dtrap_edge(cave, player->grid) : 0;
+
+	/* Timed effects show only their grade, bar the food meter */
+	for (i = 0; i < TMD_MAX; i++) {
+		struct timed_grade *grade = timed_effects[i].grade;
+
+		if (!player->timed[i]) {
+			key[n++] = 0;
+			continue;
+		}
+		while (player->timed[i] > grade->max)
+			grade = grade->next;
+		key[n++] = grade->max;
+	}
+	key[n++] = player->timed[TMD_FOOD] / 100;
+
+	return n;
+}
+
 
 /**
  * Print the status line.
@@ -967,14 +1229,22 @@ static void update_statusline(game_event_type type, game_event_data *data, void
 {
 	int row = Term->hgt - 1;
 	int col = 13;
+	int wid = MIN(MAX(Term->wid - col, 0), FIELD_WID_MAX);
+	s32b key[FIELD_KEY_MAX];
+	int nkey = key_status(key);
 	size_t i;
 
+	/* Nothing has changed */
+	if (field_unchanged(&status_memo, key, nkey, row, col, wid)) return;
+
 	/* Clear the remainder of the line */
 	prt("", row, col);
 
 	/* Display those which need redrawing */
 	for (i = 0; i < N_ELEMENTS(status_handlers); i++)
 		col += status_handlers[i](row, col);
+
+	field_remember(&status_memo, key, nkey, row, 13, wid);
 }
 
 
@@ -1001,19 +1271,25 @@ static void update_maps(game_event_type type, game_event_data *data, void *user)
 {
 	term *t = user;
 
-	/* This signals a whole-map redraw. */
-	if (data->point.x == -1 && data->point.y == -1)
+	/* This signals a whole-map redraw; only PR_MAP_VIEW keeps the map
+	 * the UI remembers */
+	if (data->point.x == -1 && data->point.y == -1) {
+		if (player->upkeep->redraw & PR_MAP)
+			map_cache_forget_all();
 		prt_map();
+	}
 
 	/* Single point to be redrawn */
 	else {
-		struct grid_data g;
 		int a, ta;
 		wchar_t c, tc;
 
 		int ky, kx;
 		int vy, vx;
 
+		/* Whatever was remembered about the grid is out of date */
+		map_cache_forget(data->point);
+
 		/* Location relative to panel */
 		ky = data->point.y - t->offset_y;
 		kx = data->point.x - t->offset_x;
@@ -1038,8 +1314,7 @@ static void update_maps(game_event_type type, game_event_data *data, void *user)
 
 
 		/* Redraw the grid spot */
-		map_info(data->point, &g);
-		grid_data_as_text(&g, &a, &c, &ta, &tc);
+		map_cache_glyph(data->point, &a, &c, &ta, &tc);
 		Term_queue_char(t, vx, vy, a, c, ta, tc);
 #ifdef MAP_DEBUG
 		/* Plot 'spot' updates in light green to make them visible */
@@ -1134,7 +1409,8 @@ static void do_animation(void)
 			continue;
 
 		mon->attr = attr;
-		player->upkeep->redraw |= (PR_MAP | PR_MONLIST);
+		map_cache_forget(mon->grid);
+		player->upkeep->redraw |= (PR_MAP_VIEW | PR_MONLIST);
 	}
 
 	flicker++;
@@ -1164,17 +1440,31 @@ static void animate(game_event_type type, game_event_data *data, void *user)
 	do_animation();
 }
 
+/**
+ * Milliseconds between frames of idle animation
+ */
+#define IDLE_UPDATE_MS 200
+
+/**
+ * Whether idle_update() has anything to do
+ */
+static bool idle_animates(void)
+{
+	if (!animations_allowed) return false;
+	if (msg_flag) return false;
+	if (!character_dungeon) return false;
+	if (!OPT(player, animate_flicker) || (use_graphics != GRAPHICS_NONE))
+		return false;
+	return true;
+}
+
 /**
  * This is used when the user is idle to allow for simple animations.
  * Currently the only thing it really does is animate shimmering monsters.
  */
 void idle_update(void)
 {
-	if (!animations_allowed) return;
-	if (msg_flag) return;
-	if (!character_dungeon) return;
-	if (!OPT(player, animate_flicker) || (use_graphics != GRAPHICS_NONE))
-		return;
+	if (!idle_animates()) return;
 
 	/* Animate and redraw if necessary */
 	do_animation();
@@ -1184,6 +1474,17 @@ void idle_update(void)
 	Term_fresh();
 }
 
+/**
+ * Animate while waiting for input, for frontends with a wait_hook; ask to be
+ * woken for the next frame only while there is something to animate
+ */
+static int idle_tick(void)
+{
+	if (!idle_animates()) return -1;
+	idle_update();
+	return IDLE_UPDATE_MS;
+}
+
 
 /**
  * Find the attr/char pair to use for a spell effect
@@ -1223,6 +1524,42 @@ static void bolt_pict(int y, int x, int ny, int nx, int typ, byte *a,
 	}
 }
 
+/**
+ * Pauses taken to show projections since the player last got a turn.  A
+ * turn full of breaths and bolts is shown at full speed once it has used up
+ * PROJECTION_DELAY_MAX pauses, as is anything after a keypress, so the
+ * player is never left waiting behind the animations.
+ */
+#define PROJECTION_DELAY_MAX 100
+static int projection_delays;
+
+/**
+ * Pause to show a step of a projection
+ */
+static void projection_delay(int msec)
+{
+	ui_event ke;
+
+	if (projection_delays >= PROJECTION_DELAY_MAX) return;
+
+	/* A waiting keypress skips the rest of the turn's pauses */
+	if (Term_inkey(&ke, false, false) == 0) {
+		projection_delays = PROJECTION_DELAY_MAX;
+		return;
+	}
+
+	projection_delays++;
+	Term_xtra(TERM_XTRA_DELAY, msec);
+}
+
+/**
+ * Allow a full set of pauses for the projections of a new player turn
+ */
+void reset_projection_delays(void)
+{
+	projection_delays = 0;
+}
+
 /**
  * Draw an explosion
  */
@@ -1279,7 +1616,7 @@ static void display_explosion(game_event_type type, game_event_data *data,
 
 			/* Delay to show this radius appearing */
 			if (drawn || drawing) {
-				Term_xtra(TERM_XTRA_DELAY, msec);
+				projection_delay(msec);
 			}
 
 			new_radius = false;
@@ -1339,7 +1676,7 @@ static void display_bolt(game_event_type type, game_event_data *data,
 		Term_fresh();
 		if (player->upkeep->redraw)
 			redraw_stuff(player);
-		Term_xtra(TERM_XTRA_DELAY, msec);
+		projection_delay(msec);
 		event_signal_point(EVENT_MAP, x, y);
 		Term_fresh();
 		if (player->upkeep->redraw)
@@ -1356,7 +1693,7 @@ static void display_bolt(game_event_type type, game_event_data *data,
 		}
 	} else if (drawing) {
 		/* Delay for consistency */
-		Term_xtra(TERM_XTRA_DELAY, msec);
+		projection_delay(msec);
 	}
 }
 
@@ -1380,7 +1717,7 @@ static void display_missile(game_event_type type, game_event_data *data,
 		Term_fresh();
 		if (player->upkeep->redraw) redraw_stuff(player);
 
-		Term_xtra(TERM_XTRA_DELAY, msec);
+		projection_delay(msec);
 		event_signal_point(EVENT_MAP, x, y);
 
 		Term_fresh();
@@ -1550,11 +1887,23 @@ static void update_object_subwindow(game_event_type type,
 }
 
 
+static struct messages_flags
+{
+	int win_idx;
+	bool stale;
+} messages_data[ANGBAND_TERM_MAX];
+
+/**
+ * Display the latest messages in a sub-window.  While "-more-" prompts are
+ * being skipped, a burst of messages only marks the window as stale, and it
+ * is drawn once when the game next refreshes the screen.
+ */
 static void update_messages_subwindow(game_event_type type,
 									  game_event_data *data, void *user)
 {
+	struct messages_flags *flags = user;
 	term *old = Term;
-	term *inv_term = user;
+	term *inv_term = angband_term[flags->win_idx];
 
 	int i;
 	int w, h;
@@ -1562,6 +1911,13 @@ static void update_messages_subwindow(game_event_type type,
 
 	const char *msg;
 
+	if (type == EVENT_MESSAGE && data && msg_auto_more()) {
+		flags->stale = true;
+		return;
+	}
+	if (type != EVENT_MESSAGE && !flags->stale) return;
+	flags->stale = false;
+
 	/* Activate */
 	Term_activate(inv_term);
 
@@ -1761,6 +2117,65 @@ static void flush_subwindow(game_event_type type, game_event_data *data,
 	Term_activate(old);
 }
 
+/**
+ * Subwindow contents waiting to be drawn.  The events behind a window only
+ * mark it; it is drawn once, when the redraw pass ends or the game waits for
+ * input, however many of its events came in between.  A window whose term
+ * has a frame interval that has not yet passed is left for a later pass,
+ * unless the game is waiting.
+ */
+static struct subwindow_draw
+{
+	game_event_handler *fn;
+	term *t;
+	bool pending;
+} subwindow_draws[ANGBAND_TERM_MAX][32];
+
+static bool subwindow_draws_pending;
+
+static void subwindow_mark(game_event_type type, game_event_data *data,
+						   void *user)
+{
+	struct subwindow_draw *draw = user;
+
+	draw->pending = true;
+	subwindow_draws_pending = true;
+}
+
+/**
+ * Draw the subwindows marked since they were last drawn; unless forced, not
+ * those whose term would hold the frame back
+ */
+void subwindows_flush(bool force)
+{
+	int i, j;
+
+	if (!subwindow_draws_pending) return;
+	subwindow_draws_pending = false;
+
+	for (i = 0; i < ANGBAND_TERM_MAX; i++) {
+		for (j = 0; j < 32; j++) {
+			struct subwindow_draw *draw = &subwindow_draws[i][j];
+
+			if (!draw->pending) continue;
+
+			if (!force && !term_frame_due(draw->t)) {
+				subwindow_draws_pending = true;
+				continue;
+			}
+
+			draw->pending = false;
+			draw->fn(EVENT_END, NULL, draw->t);
+		}
+	}
+}
+
+static void flush_subwindow_draws(game_event_type type, game_event_data *data,
+								  void *user)
+{
+	subwindows_flush(false);
+}
+
 /**
  * Certain "screens" always use the main screen, including News, Birth,
  * Dungeon, Tomb-stone, High-scores, Macros, Colors, Visuals, Options.
@@ -1811,6 +2226,14 @@ static void subwindow_flag_changed(int win_idx, u32b flag, bool new_state)
 								   void *user);
 	void (*set_register_or_deregister)(game_event_type *type, size_t n_events,
 									   game_event_handler *fn, void *user);
+	struct subwindow_draw *draw;
+	int flag_idx = 0;
+
+	/* Drawing deferred for this flag */
+	while (flag_idx < 31 && !(flag & (1L << flag_idx))) flag_idx++;
+	draw = &subwindow_draws[win_idx][flag_idx];
+	draw->t = angband_term[win_idx];
+	draw->pending = false;
 
 	/* Decide whether to register or deregister an evenrt handler */
 	if (new_state == false) {
@@ -1825,44 +2248,42 @@ static void subwindow_flag_changed(int win_idx, u32b flag, bool new_state)
 	{
 		case PW_INVEN:
 		{
-			register_or_deregister(EVENT_INVENTORY,
-					       update_inven_subwindow,
-					       angband_term[win_idx]);
+			draw->fn = update_inven_subwindow;
+			register_or_deregister(EVENT_INVENTORY, subwindow_mark, draw);
 			break;
 		}
 
 		case PW_EQUIP:
 		{
-			register_or_deregister(EVENT_EQUIPMENT,
-					       update_equip_subwindow,
-					       angband_term[win_idx]);
+			draw->fn = update_equip_subwindow;
+			register_or_deregister(EVENT_EQUIPMENT, subwindow_mark, draw);
 			break;
 		}
 
 		case PW_PLAYER_0:
 		{
+			draw->fn = update_player0_subwindow;
 			set_register_or_deregister(player_events, 
 						   N_ELEMENTS(player_events),
-						   update_player0_subwindow,
-						   angband_term[win_idx]);
+						   subwindow_mark, draw);
 			break;
 		}
 
 		case PW_PLAYER_1:
 		{
+			draw->fn = update_player1_subwindow;
 			set_register_or_deregister(player_events, 
 						   N_ELEMENTS(player_events),
-						   update_player1_subwindow,
-						   angband_term[win_idx]);
+						   subwindow_mark, draw);
 			break;
 		}
 
 		case PW_PLAYER_2:
 		{
+			draw->fn = update_player_compact_subwindow;
 			set_register_or_deregister(player_events, 
 						   N_ELEMENTS(player_events),
-						   update_player_compact_subwindow,
-						   angband_term[win_idx]);
+						   subwindow_mark, draw);
 			break;
 		}
 
@@ -1885,9 +2306,20 @@ static void subwindow_flag_changed(int win_idx, u32b flag, bool new_state)
 
 		case PW_MESSAGE:
 		{
+			messages_data[win_idx].win_idx = win_idx;
+			messages_data[win_idx].stale = false;
+
 			register_or_deregister(EVENT_MESSAGE,
 					       update_messages_subwindow,
-					       angband_term[win_idx]);
+					       &messages_data[win_idx]);
+
+			register_or_deregister(EVENT_MESSAGE_FLUSH,
+					       update_messages_subwindow,
+					       &messages_data[win_idx]);
+
+			register_or_deregister(EVENT_REFRESH,
+					       update_messages_subwindow,
+					       &messages_data[win_idx]);
 			break;
 		}
 
@@ -1905,33 +2337,29 @@ static void subwindow_flag_changed(int win_idx, u32b flag, bool new_state)
 
 		case PW_MONSTER:
 		{
-			register_or_deregister(EVENT_MONSTERTARGET,
-					       update_monster_subwindow,
-					       angband_term[win_idx]);
+			draw->fn = update_monster_subwindow;
+			register_or_deregister(EVENT_MONSTERTARGET, subwindow_mark, draw);
 			break;
 		}
 
 		case PW_OBJECT:
 		{
-			register_or_deregister(EVENT_OBJECTTARGET,
-						   update_object_subwindow,
-						   angband_term[win_idx]);
+			draw->fn = update_object_subwindow;
+			register_or_deregister(EVENT_OBJECTTARGET, subwindow_mark, draw);
 			break;
 		}
 
 		case PW_MONLIST:
 		{
-			register_or_deregister(EVENT_MONSTERLIST,
-					       update_monlist_subwindow,
-					       angband_term[win_idx]);
+			draw->fn = update_monlist_subwindow;
+			register_or_deregister(EVENT_MONSTERLIST, subwindow_mark, draw);
 			break;
 		}
 
 		case PW_ITEMLIST:
 		{
-			register_or_deregister(EVENT_ITEMLIST,
-						   update_itemlist_subwindow,
-						   angband_term[win_idx]);
+			draw->fn = update_itemlist_subwindow;
+			register_or_deregister(EVENT_ITEMLIST, subwindow_mark, draw);
 			break;
 		}
 	}
@@ -2122,7 +2550,7 @@ static void new_level_display_update(game_event_type type,
 
 	/* If autosave is pending, do it now. */
 	if (player->upkeep->autosave) {
-		save_game();
+		autosave_game();
 		player->upkeep->autosave = false;
 	}
 
@@ -2352,6 +2780,9 @@ static void ui_enter_world(game_event_type type, game_event_data *data,
 	event_add_handler(EVENT_MAP, trace_map_updates, angband_term[0]);
 #endif
 
+	/* Draw marked subwindows once the redraw pass is over */
+	event_add_handler(EVENT_END, flush_subwindow_draws, NULL);
+
 	/* Check if the panel should shift when the player's moved */
 	event_add_handler(EVENT_PLAYERMOVED, check_panel, NULL);
 
@@ -2417,6 +2848,9 @@ static void ui_leave_world(game_event_type type, game_event_data *data,
 	event_remove_handler(EVENT_MAP, trace_map_updates, angband_term[0]);
 #endif
 
+	/* Draw marked subwindows once the redraw pass is over */
+	event_remove_handler(EVENT_END, flush_subwindow_draws, NULL);
+
 	/* Check if the panel should shift when the player's moved */
 	event_remove_handler(EVENT_PLAYERMOVED, check_panel, NULL);
 
@@ -2492,8 +2926,16 @@ static void ui_leave_game(game_event_type type, game_event_data *data,
 	event_remove_handler(EVENT_MESSAGE_FLUSH, message_flush, NULL);
 }
 
+/**
+ * Set up the display handlers, unless the front end has asked for no display,
+ * in which case the game runs with nothing listening for what to show
+ */
 void init_display(void)
 {
+	if (display_null) return;
+
+	Term_idle_hook = idle_tick;
+
 	event_add_handler(EVENT_ENTER_INIT, ui_enter_init, NULL);
 	event_add_handler(EVENT_LEAVE_INIT, ui_leave_init, NULL);
 
@@ -31,9 +31,11 @@ byte monster_health_attr(void);
 void cnv_stat(int val, char *out_val, size_t out_len);
 void allow_animations(void);
 void disallow_animations(void);
+void reset_projection_delays(void);
 void idle_update(void);
 void toggle_inven_equip(void);
 void subwindows_set_flags(u32b *new_flags, size_t n_subwindows);
+void subwindows_flush(bool force);
 void init_display(void);
 
 #endif /* INCLUDED_UI_DISPLAY_H */
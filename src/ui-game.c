@@ -323,8 +323,12 @@ void textui_process_command(void)
 
 errr textui_get_cmd(cmd_context context)
 {
-	if (context == CTX_GAME)
+	if (context == CTX_GAME) {
+		enum mem_tag tag = mem_tag_set(MEM_TAG_UI);
+
 		textui_process_command();
+		mem_tag_set(tag);
+	}
 
 	/* If we've reached here, we haven't got a command. */
 	return 1;
@@ -365,7 +369,7 @@ void pre_turn_refresh(void)
 	int j;
 	if (character_dungeon) {
 		/* Redraw map */
-		player->upkeep->redraw |= (PR_MAP | PR_STATE);
+		player->upkeep->redraw |= (PR_MAP_VIEW | PR_STATE);
 		player->upkeep->redraw |= (PR_MONLIST | PR_ITEMLIST);
 		handle_stuff(player);
 
@@ -435,6 +439,7 @@ void play_game(bool new_game)
 	 * command queue is empty and a new player command is needed */
 	while (!player->is_dead && player->upkeep->playing) {
 		pre_turn_refresh();
+		reset_projection_delays();
 		cmd_get_hook(CTX_GAME);
 		run_game_loop();
 	}
@@ -482,12 +487,35 @@ void savefile_set_name(const char *fname, bool make_safe, bool strip_suffix)
 }
 
 /**
- * Save the game
+ * Save the window prefs and monster memory to the user directory
  */
-void save_game(void)
+static void save_user_files(void)
 {
 	char path[1024];
 
+	/* Save the window prefs */
+	path_build(path, sizeof(path), ANGBAND_DIR_USER, "window.prf");
+	if (!prefs_save(path, option_dump, "Dump window settings"))
+		prt("Failed to save subwindow preferences", 0, 0);
+
+	/* Refresh */
+	Term_fresh();
+
+	/* Save monster memory to user directory */
+	if (!lore_save("lore.txt")) {
+		msg("lore save failed!");
+		event_signal(EVENT_MESSAGE_FLUSH);
+	}
+
+	/* Refresh */
+	Term_fresh();
+}
+
+/**
+ * Save the game
+ */
+void save_game(void)
+{
 	/* Disturb the player */
 	disturb(player, 1);
 
@@ -521,22 +549,40 @@ void save_game(void)
 	/* Allow suspend again */
 	signals_handle_tstp();
 
-	/* Save the window prefs */
-	path_build(path, sizeof(path), ANGBAND_DIR_USER, "window.prf");
-	if (!prefs_save(path, option_dump, "Dump window settings"))
-		prt("Failed to save subwindow preferences", 0, 0);
+	/* Save the window prefs and monster memory */
+	save_user_files();
 
-	/* Refresh */
-	Term_fresh();
+	/* Note that the player is not dead */
+	my_strcpy(player->died_from, "(alive and well)", sizeof(player->died_from));
+}
 
-	/* Save monster memory to user directory */
-	if (!lore_save("lore.txt")) {
-		msg("lore save failed!");
+/**
+ * Save the game on arriving at a new level; only taking the snapshot holds
+ * up the game, and the savefile is written out in the background
+ */
+void autosave_game(void)
+{
+	/* Own up to a failed autosave */
+	if (!savefile_finish()) {
+		msg("Autosave failed!");
 		event_signal(EVENT_MESSAGE_FLUSH);
 	}
 
-	/* Refresh */
-	Term_fresh();
+	/* Disturb the player */
+	disturb(player, 1);
+
+	/* Handle stuff */
+	handle_stuff(player);
+
+	/* The player is not dead */
+	my_strcpy(player->died_from, "(saved)", sizeof(player->died_from));
+
+	/* Save the player */
+	if (!savefile_save_background(savefile))
+		prt("Saving game... failed!", 0, 0);
+
+	/* Save the window prefs and monster memory */
+	save_user_files();
 
 	/* Note that the player is not dead */
 	my_strcpy(player->died_from, "(alive and well)", sizeof(player->died_from));
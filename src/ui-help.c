@@ -39,9 +39,8 @@ static void string_lower(char *buf)
  *
  * Return false on "?", otherwise true.
  *
- * This function could be made much more efficient with the use of "seek"
- * functionality, especially when moving backwards through a file, or
- * forwards through a file by less than a page at a time.  XXX XXX XXX
+ * The file is read once, keeping the lines that are shown, so moving about
+ * in it and searching it never go back to the file.
  */
 bool show_file(const char *name, const char *what, int line, int mode)
 {
@@ -49,11 +48,11 @@ bool show_file(const char *name, const char *what, int line, int mode)
 
 	struct keypress ch;
 
-	/* Number of "real" lines passed by */
-	int next = 0;
+	/* The "real" lines of the file */
+	char **lines = NULL;
 
-	/* Number of "real" lines in the file */
-	int size;
+	/* Number of "real" lines in the file, and room for them */
+	int size = 0, alloc = 0;
 
 	/* Backup value for "line" */
 	int back = 0;
@@ -199,7 +198,7 @@ bool show_file(const char *name, const char *what, int line, int mode)
 					/* Compare with the requested tag */
 					if (streq(buf + strlen(".. _"), tag)) {
 						/* Remember the tagged line */
-						line = next;
+						line = size;
 					}
 				}
 			}
@@ -209,12 +208,16 @@ bool show_file(const char *name, const char *what, int line, int mode)
 			continue;
 		}
 
-		/* Count the "real" lines */
-		next++;
+		/* Keep the "real" lines */
+		if (size == alloc) {
+			alloc = alloc ? alloc * 2 : 256;
+			lines = mem_realloc(lines, alloc * sizeof(*lines));
+		}
+		lines[size++] = string_make(buf);
 	}
 
-	/* Save the number of "real" lines */
-	size = next;
+	/* The lines are all kept, so the file is done with */
+	file_close(fff);
 
 
 	/* Display the file */
@@ -227,111 +230,54 @@ bool show_file(const char *name, const char *what, int line, int mode)
 		if (line > (size - (hgt - 4))) line = size - (hgt - 4);
 		if (line < 0) line = 0;
 
-		skip_lines = false;
-
-		/* Re-open the file if needed */
-		if (next > line) {
-			/* Close it */
-			file_close(fff);
-
-			/* Hack -- Re-Open the file */
-			fff = file_open(path, MODE_READ, FTYPE_TEXT);
-			if (!fff) return (true);
-
-			/* File has been restarted */
-			next = 0;
-		}
-
-
-		/* Goto the selected line */
-		while (next < line) {
-			/* Get a line */
-			if (!file_getl(fff, buf, sizeof(buf))) break;
-
-			/* Skip lines if we are inside a RST directive*/
-			if (skip_lines) {
-				if (contains_only_spaces(buf))
-					skip_lines=false;
-				continue;
+		/* Look for the next line with the search string */
+		if (find) {
+			for (n = line; n < size; n++) {
+				my_strcpy(lc_buf, lines[n], sizeof(lc_buf));
+				if (!case_sensitive) string_lower(lc_buf);
+				if (strstr(lc_buf, find)) break;
 			}
+			find = NULL;
 
-			/* Skip RST directives */
-			if (prefix(buf, ".. ")) {
-				skip_lines=true;
+			/* Hack -- failed search */
+			if (n == size) {
+				bell("Search string not found!");
+				line = back;
 				continue;
 			}
 
-			/* Count the lines */
-			next++;
+			/* Show the found line first */
+			line = n;
 		}
 
 
 		/* Dump the next lines of the file */
-		for (i = 0; i < hgt - 4; ) {
-			/* Hack -- track the "first" line */
-			if (!i) line = next;
-
-			/* Get a line of the file or stop */
-			if (!file_getl(fff, buf, sizeof(buf))) break;
-
-			/* Skip lines if we are inside a RST directive */
-			if (skip_lines) {
-				if (contains_only_spaces(buf))
-					skip_lines = false;
-				continue;
-			}
-
-			/* Skip RST directives */
-			if (prefix(buf, ".. ")) {
-				skip_lines=true;
-				continue;
-			}
-
-			/* Count the "real" lines */
-			next++;
-
-			/* Make a copy of the current line for searching */
-			my_strcpy(lc_buf, buf, sizeof(lc_buf));
-
-			/* Make the line lower case */
-			if (!case_sensitive) string_lower(lc_buf);
-
-			/* Hack -- keep searching */
-			if (find && !i && !strstr(lc_buf, find)) continue;
-
-			/* Hack -- stop searching */
-			find = NULL;
+		for (i = 0; i < hgt - 4 && line + i < size; i++) {
+			const char *text = lines[line + i];
 
 			/* Dump the line */
-			Term_putstr(0, i+2, -1, COLOUR_WHITE, buf);
+			Term_putstr(0, i+2, -1, COLOUR_WHITE, text);
 
 			/* Highlight "shower" */
 			if (shower[0]) {
 				const char *str = lc_buf;
 
+				/* Make a lower case copy of the line for searching */
+				my_strcpy(lc_buf, text, sizeof(lc_buf));
+				if (!case_sensitive) string_lower(lc_buf);
+
 				/* Display matches */
 				while ((str = strstr(str, shower)) != NULL) {
 					int len = strlen(shower);
 
 					/* Display the match */
 					Term_putstr(str-lc_buf, i+2, len, COLOUR_YELLOW,
-								&buf[str-lc_buf]);
+								&text[str-lc_buf]);
 
 					/* Advance */
 					str += len;
 				}
 			}
-
-			/* Count the printed lines */
-			i++;
-		}
-
-		/* Hack -- failed search */
-		if (find) {
-			bell("Search string not found!");
-			line = back;
-			find = NULL;
-			continue;
 		}
 
 
@@ -455,8 +401,10 @@ bool show_file(const char *name, const char *what, int line, int mode)
 		if (ch.code == ESCAPE) break;
 	}
 
-	/* Close the file */
-	file_close(fff);
+	/* Free the lines */
+	for (i = 0; i < size; i++)
+		string_free(lines[i]);
+	mem_free(lines);
 
 	/* Done */
 	return (ch.code != '?');
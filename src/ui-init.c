@@ -24,14 +24,18 @@
 
 
 #include "angband.h"
+#include "cave.h"
 #include "game-input.h"
 #include "game-event.h"
 #include "init.h"
+#include "mon-lore.h"
 #include "ui-display.h"
 #include "ui-game.h"
 #include "ui-input.h"
 #include "ui-keymap.h"
 #include "ui-knowledge.h"
+#include "ui-map.h"
+#include "ui-mon-lore.h"
 #include "ui-options.h"
 #include "ui-output.h"
 #include "ui-prefs.h"
@@ -108,4 +112,6 @@ void textui_cleanup(void)
 
 	keymap_free();
 	textui_prefs_free();
+	map_cache_free();
+	lore_cache_free();
 }
@@ -230,6 +230,13 @@ ui_event inkey_ex(void)
 
 		/* Hack -- Flush output once when no key ready */
 		if (!done && (0 != Term_inkey(&kk, false, false))) {
+			/* Draw anything the game has put off */
+			if (player && player->upkeep)
+				flush_stuff(player, "inkey_ex");
+
+			/* Draw subwindows still waiting */
+			subwindows_flush(true);
+
 			/* Hack -- activate proper term */
 			Term_activate(old);
 
@@ -347,6 +354,16 @@ ui_event inkey_m(void)
 
 
 
+/**
+ * Are "-more-" prompts being skipped?  If so, nobody is waiting to read each
+ * message as it comes, and the screen need only be brought up to date once
+ * the turn is over.
+ */
+bool msg_auto_more(void)
+{
+	return OPT(player, auto_more) || keymap_auto_more;
+}
+
 /**
  * Hack -- flush
  */
@@ -355,10 +372,12 @@ static void msg_flush(int x)
 	byte a = COLOUR_L_BLUE;
 
 	/* Pause for response */
-	Term_putstr(x, 0, -1, a, "-more-");
-
-	if ((!OPT(player, auto_more)) && !keymap_auto_more)
+	if (!msg_auto_more()) {
+		if (player && player->upkeep)
+			flush_stuff(player, "msg_flush");
+		Term_putstr(x, 0, -1, a, "-more-");
 		anykey();
+	}
 
 	/* Clear the line */
 	Term_erase(0, 0, 255);
@@ -502,8 +521,9 @@ void display_message(game_event_type unused, game_event_data *data, void *user)
  */
 void bell_message(game_event_type unused, game_event_data *data, void *user)
 {
-	/* Flush the output */
-	Term_fresh();
+	/* Flush the output, unless nobody will see it */
+	if (!msg_auto_more())
+		Term_fresh();
 
 	display_message(unused, data, user);
 	player->upkeep->redraw |= PR_MESSAGE;
@@ -71,6 +71,7 @@ ui_event inkey_ex(void);
 void anykey(void);
 struct keypress inkey(void);
 ui_event inkey_m(void);
+bool msg_auto_more(void);
 void display_message(game_event_type unused, game_event_data *data, void *user);
 void bell_message(game_event_type unused, game_event_data *data, void *user);
 void message_flush(game_event_type unused, game_event_data *data, void *user);
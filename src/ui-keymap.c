@@ -44,7 +44,8 @@ struct keymap {
 
 	bool user;		/* User-defined keymap */
 
-	struct keymap *next;
+	struct keymap *next;		/* Next in the mode's list, newest first */
+	struct keymap *hash_next;	/* Next in the same hash bucket */
 };
 
 
@@ -53,6 +54,25 @@ struct keymap {
  */
 static struct keymap *keymaps[KEYMAP_MODE_MAX];
 
+/**
+ * Number of hash buckets per keymap mode; a power of two.
+ */
+#define KEYMAP_HASH_SIZE 256
+
+/**
+ * Keymaps hashed by trigger, so a keypress doesn't scan the whole list.
+ */
+static struct keymap *keymap_hash[KEYMAP_MODE_MAX][KEYMAP_HASH_SIZE];
+
+/**
+ * Hash bucket for a trigger.
+ */
+static size_t keymap_bucket(struct keypress key)
+{
+	return (key.code ^ (key.code >> 8) ^ ((u32b)key.mods << 5)) &
+		(KEYMAP_HASH_SIZE - 1);
+}
+
 
 /**
  * Find a keymap, given a keypress.
@@ -61,7 +81,7 @@ const struct keypress *keymap_find(int keymap, struct keypress kc)
 {
 	struct keymap *k;
 	assert(keymap >= 0 && keymap < KEYMAP_MODE_MAX);
-	for (k = keymaps[keymap]; k; k = k->next) {
+	for (k = keymap_hash[keymap][keymap_bucket(kc)]; k; k = k->hash_next) {
 		if (k->key.code == kc.code && k->key.mods == kc.mods)
 			return k->actions;
 	}
@@ -110,6 +130,9 @@ void keymap_add(int keymap, struct keypress trigger, struct keypress *actions, b
 	k->next = keymaps[keymap];
 	keymaps[keymap] = k;
 
+	k->hash_next = keymap_hash[keymap][keymap_bucket(trigger)];
+	keymap_hash[keymap][keymap_bucket(trigger)] = k;
+
 	return;
 }
 
@@ -119,25 +142,27 @@ void keymap_add(int keymap, struct keypress trigger, struct keypress *actions, b
  */
 bool keymap_remove(int keymap, struct keypress trigger)
 {
-	struct keymap *k;
-	struct keymap *prev = NULL;
+	struct keymap *k, **link;
 	assert(keymap >= 0 && keymap < KEYMAP_MODE_MAX);
 
-	for (k = keymaps[keymap]; k; k = k->next) {
-		if (k->key.code == trigger.code && k->key.mods == trigger.mods) {
-			mem_free(k->actions);
-			if (prev)
-				prev->next = k->next;
-			else
-				keymaps[keymap] = k->next;
-			mem_free(k);
-			return true;
-		}
-
-		prev = k;
+	/* Find it in its bucket */
+	for (link = &keymap_hash[keymap][keymap_bucket(trigger)]; *link;
+		 link = &(*link)->hash_next) {
+		if ((*link)->key.code == trigger.code &&
+			(*link)->key.mods == trigger.mods)
+			break;
 	}
+	if (!*link) return false;
+	k = *link;
+	*link = k->hash_next;
+
+	/* Then take it out of the list */
+	for (link = &keymaps[keymap]; *link != k; link = &(*link)->next) ;
+	*link = k->next;
 
-	return false;
+	mem_free(k->actions);
+	mem_free(k);
+	return true;
 }
 
 
@@ -156,7 +181,9 @@ void keymap_free(void)
 			mem_free(k);
 			k = next;
 		}
+		keymaps[i] = NULL;
 	}
+	memset(keymap_hash, 0, sizeof(keymap_hash));
 }
 
 
@@ -1297,28 +1297,49 @@ static int count_known_monsters(void)
 }
 
 /**
- * Display known monsters.
+ * The monster knowledge list, sorted, as it was last shown.  It depends only
+ * on which races are known, so it is kept until that changes.
  */
-static void do_cmd_knowledge_monsters(const char *name, int row)
-{
-	group_funcs r_funcs = {race_name, m_cmp_race, default_group_id, mon_summary,
-						   N_ELEMENTS(monster_group), false};
+static struct {
+	bool *listed;		/* Was each race known when the list was made? */
+	join_t *join;
+	int *monsters;
+	int count;
+} monster_knowledge;
 
-	member_funcs m_funcs = {display_monster, mon_lore, m_xchar, m_xattr,
-							recall_prompt, 0, 0};
+static bool monster_is_listed(int r_idx)
+{
+	if (!l_list[r_idx].all_known && !l_list[r_idx].sights)
+		return false;
+	return r_info[r_idx].name != NULL;
+}
 
-	int *monsters;
+/**
+ * Bring the monster knowledge list up to date, returning true if it had to
+ * be remade (and so needs sorting)
+ */
+static bool monster_knowledge_update(void)
+{
 	int m_count = 0;
 	int i;
 	size_t j;
 
+	if (monster_knowledge.listed) {
+		for (i = 0; i < z_info->r_max; i++)
+			if (monster_knowledge.listed[i] != monster_is_listed(i)) break;
+		if (i == z_info->r_max) return false;
+	} else {
+		monster_knowledge.listed = mem_zalloc(z_info->r_max * sizeof(bool));
+	}
+
+	mem_free(monster_knowledge.join);
+	mem_free(monster_knowledge.monsters);
+
 	for (i = 0; i < z_info->r_max; i++) {
 		struct monster_race *race = &r_info[i];
-		if (!l_list[i].all_known && !l_list[i].sights) {
-			continue;
-		}
 
-		if (!race->name) continue;
+		monster_knowledge.listed[i] = monster_is_listed(i);
+		if (!monster_knowledge.listed[i]) continue;
 
 		if (rf_has(race->flags, RF_UNIQUE)) m_count++;
 
@@ -1328,33 +1349,57 @@ static void do_cmd_knowledge_monsters(const char *name, int row)
 		}
 	}
 
-	default_join = mem_zalloc(m_count * sizeof(join_t));
-	monsters = mem_zalloc(m_count * sizeof(int));
+	monster_knowledge.join = mem_zalloc(m_count * sizeof(join_t));
+	monster_knowledge.monsters = mem_zalloc(m_count * sizeof(int));
 
 	m_count = 0;
 	for (i = 0; i < z_info->r_max; i++) {
 		struct monster_race *race = &r_info[i];
-		if (!l_list[i].all_known && !l_list[i].sights) {
-			continue;
-		}
-
-		if (!race->name) continue;
+		if (!monster_knowledge.listed[i]) continue;
 
 		for (j = 0; j < N_ELEMENTS(monster_group) - 1; j++) {
 			const wchar_t *pat = monster_group[j].chars;
 			if (j == 0 && !rf_has(race->flags, RF_UNIQUE)) continue;
 			if (j > 0 && !wcschr(pat, race->d_char)) continue;
 
-			monsters[m_count] = m_count;
-			default_join[m_count].oid = i;
-			default_join[m_count++].gid = j;
+			monster_knowledge.monsters[m_count] = m_count;
+			monster_knowledge.join[m_count].oid = i;
+			monster_knowledge.join[m_count++].gid = j;
 		}
 	}
+	monster_knowledge.count = m_count;
+
+	return true;
+}
+
+static void monster_knowledge_free(void)
+{
+	mem_free(monster_knowledge.listed);
+	mem_free(monster_knowledge.join);
+	mem_free(monster_knowledge.monsters);
+	memset(&monster_knowledge, 0, sizeof(monster_knowledge));
+}
+
+/**
+ * Display known monsters.
+ */
+static void do_cmd_knowledge_monsters(const char *name, int row)
+{
+	group_funcs r_funcs = {race_name, m_cmp_race, default_group_id, mon_summary,
+						   N_ELEMENTS(monster_group), false};
+
+	member_funcs m_funcs = {display_monster, mon_lore, m_xchar, m_xattr,
+							recall_prompt, 0, 0};
+
+	/* A list that hasn't changed is still in order */
+	if (!monster_knowledge_update())
+		r_funcs.gcomp = NULL;
 
-	display_knowledge("monsters", monsters, m_count, r_funcs, m_funcs,
+	default_join = monster_knowledge.join;
+	display_knowledge("monsters", monster_knowledge.monsters,
+			monster_knowledge.count, r_funcs, m_funcs,
 			"                   Sym  Kills");
-	mem_free(default_join);
-	mem_free(monsters);
+	default_join = NULL;
 }
 
 /**
@@ -2578,6 +2623,7 @@ static struct menu knowledge_menu;
  */
 static void cleanup_cmds(void) {
 	mem_free(obj_group_order);
+	monster_knowledge_free();
 }
 
 void textui_knowledge_init(void)
@@ -521,11 +521,156 @@ void print_rel(wchar_t c, byte a, int y, int x)
 }
 
 
+/**
+ * What the grids of the current level looked like when map_info() and
+ * grid_data_as_text() last worked them out, so that redrawing the whole
+ * map only has to work out again the grids that have changed since.
+ *
+ * Grids are forgotten when square_light_spot() signals a change to them,
+ * and the whole cache is forgotten when the game asks for the whole map
+ * to be redrawn (PR_MAP).  Redraws which only show the map again, such as
+ * when the panel moves (PR_MAP_VIEW), use what is remembered.
+ *
+ * The downsampled map from display_map() is remembered too, and only the
+ * parts containing forgotten grids are worked out again.
+ */
+struct map_glyph {
+	int a, ta;
+	wchar_t c, tc;
+};
+
+static struct {
+	struct chunk *c;
+	int height, width;
+	struct map_glyph *grids;
+	bool *valid;
+
+	/* The display_map() overview, and the layout it was made for */
+	int map_hgt, map_wid;
+	int tile_hgt, tile_wid;
+	struct map_glyph *cells;
+	byte *priority;
+	bool *dirty;
+} map_cache;
+
+static void map_cache_free_overview(void)
+{
+	mem_free(map_cache.cells);
+	mem_free(map_cache.priority);
+	mem_free(map_cache.dirty);
+	map_cache.cells = NULL;
+	map_cache.priority = NULL;
+	map_cache.dirty = NULL;
+	map_cache.map_hgt = map_cache.map_wid = 0;
+}
+
+/**
+ * Free the map cache
+ */
+void map_cache_free(void)
+{
+	map_cache_free_overview();
+	mem_free(map_cache.grids);
+	mem_free(map_cache.valid);
+	map_cache.grids = NULL;
+	map_cache.valid = NULL;
+	map_cache.c = NULL;
+	map_cache.height = map_cache.width = 0;
+}
+
+/**
+ * Make sure the map cache is for the current level, and say whether it
+ * can be used; hallucinations are different every time they are drawn
+ */
+static bool map_cache_ready(void)
+{
+	if ((map_cache.c != cave) || (map_cache.height != cave->height)
+		|| (map_cache.width != cave->width)) {
+		size_t n = cave->height * cave->width;
+
+		map_cache_free();
+		map_cache.c = cave;
+		map_cache.height = cave->height;
+		map_cache.width = cave->width;
+		map_cache.grids = mem_zalloc(n * sizeof(*map_cache.grids));
+		map_cache.valid = mem_zalloc(n * sizeof(*map_cache.valid));
+	}
+
+	return !player->timed[TMD_IMAGE];
+}
+
+/**
+ * Work out which cell of the display_map() overview a grid is shown in
+ */
+static int map_cache_cell(struct loc grid, int map_hgt, int map_wid)
+{
+	int row = (grid.y * map_hgt / cave->height);
+	int col = (grid.x * map_wid / cave->width);
+
+	if (tile_width > 1)
+		col = col - (col % tile_width);
+	if (tile_height > 1)
+		row = row - (row % tile_height);
+
+	return row * map_wid + col;
+}
+
+/**
+ * Forget what a grid looked like, because it has changed
+ */
+void map_cache_forget(struct loc grid)
+{
+	if ((map_cache.c != cave) || !square_in_bounds(cave, grid)) return;
+
+	map_cache.valid[grid_to_i(grid, map_cache.width)] = false;
+	if (map_cache.dirty)
+		map_cache.dirty[map_cache_cell(grid, map_cache.map_hgt,
+									   map_cache.map_wid)] = true;
+}
+
+/**
+ * Forget what the whole map looked like
+ */
+void map_cache_forget_all(void)
+{
+	if (map_cache.valid)
+		memset(map_cache.valid, 0,
+			   map_cache.height * map_cache.width * sizeof(*map_cache.valid));
+	if (map_cache.dirty)
+		memset(map_cache.dirty, 1,
+			   map_cache.map_hgt * map_cache.map_wid * sizeof(*map_cache.dirty));
+}
+
+/**
+ * Get the attr/char pairs for a grid, as from map_info() and
+ * grid_data_as_text(), using the remembered ones if they are still good
+ */
+void map_cache_glyph(struct loc grid, int *ap, wchar_t *cp, int *tap,
+					 wchar_t *tcp)
+{
+	/* The player's colour can follow their hitpoints, so is never kept */
+	bool cache = map_cache_ready() && !loc_eq(grid, player->grid);
+	struct map_glyph *glyph = &map_cache.grids[grid_to_i(grid, cave->width)];
+	bool *valid = &map_cache.valid[grid_to_i(grid, cave->width)];
+
+	if (!cache || !*valid) {
+		struct grid_data g;
+
+		map_info(grid, &g);
+		grid_data_as_text(&g, &glyph->a, &glyph->c, &glyph->ta, &glyph->tc);
+		*valid = cache;
+	}
+
+	*ap = glyph->a;
+	*cp = glyph->c;
+	*tap = glyph->ta;
+	*tcp = glyph->tc;
+}
+
 static void prt_map_aux(void)
 {
 	int a, ta;
 	wchar_t c, tc;
-	struct grid_data g;
 
 	int y, x;
 	int vy, vx;
@@ -556,8 +701,7 @@ static void prt_map_aux(void)
 				if (vx + tile_width - 1 >= t->wid) continue;
 
 				/* Determine what is there */
-				map_info(loc(x, y), &g);
-				grid_data_as_text(&g, &a, &c, &ta, &tc);
+				map_cache_glyph(loc(x, y), &a, &c, &ta, &tc);
 				Term_queue_char(t, vx, vy, a, c, ta, tc);
 
 				if ((tile_width > 1) || (tile_height > 1))
@@ -580,7 +724,6 @@ void prt_map(void)
 {
 	int a, ta;
 	wchar_t c, tc;
-	struct grid_data g;
 
 	int y, x;
 	int vy, vx;
@@ -600,8 +743,7 @@ void prt_map(void)
 			if (!square_in_bounds(cave, loc(x, y))) continue;
 
 			/* Determine what is there */
-			map_info(loc(x, y), &g);
-			grid_data_as_text(&g, &a, &c, &ta, &tc);
+			map_cache_glyph(loc(x, y), &a, &c, &ta, &tc);
 
 			/* Hack -- Queue it */
 			Term_queue_char(Term, vx, vy, a, c, ta, tc);
@@ -631,7 +773,7 @@ void display_map(int *cy, int *cx)
 	int map_hgt, map_wid;
 	int row, col;
 
-	int x, y;
+	int x, y, i;
 	struct grid_data g;
 
 	int a, ta;
@@ -641,11 +783,6 @@ void display_map(int *cy, int *cx)
 
 	struct monster_race *race = &r_info[0];
 
-	/* Priority array */
-	byte **mp = mem_zalloc(cave->height * sizeof(byte*));
-	for (y = 0; y < cave->height; y++)
-		mp[y] = mem_zalloc(cave->width * sizeof(byte));
-
 	/* Desired map height */
 	map_hgt = Term->hgt - 2;
 	map_wid = Term->wid - 2;
@@ -655,32 +792,44 @@ void display_map(int *cy, int *cx)
 	if (map_wid > cave->width) map_wid = cave->width;
 
 	/* Prevent accidents */
-	if ((map_wid < 1) || (map_hgt < 1)) {
-		for (y = 0; y < cave->height; y++)
-			mem_free(mp[y]);
-		mem_free(mp);
-		return;
+	if ((map_wid < 1) || (map_hgt < 1)) return;
+
+	/* Work everything out again for a new layout, or when hallucinating */
+	if (!map_cache_ready() || (map_cache.map_hgt != map_hgt)
+		|| (map_cache.map_wid != map_wid)
+		|| (map_cache.tile_hgt != tile_height)
+		|| (map_cache.tile_wid != tile_width)) {
+		if ((map_cache.map_hgt != map_hgt) || (map_cache.map_wid != map_wid)) {
+			map_cache_free_overview();
+			map_cache.map_hgt = map_hgt;
+			map_cache.map_wid = map_wid;
+			map_cache.cells = mem_zalloc(map_hgt * map_wid *
+										 sizeof(*map_cache.cells));
+			map_cache.priority = mem_zalloc(map_hgt * map_wid *
+											sizeof(*map_cache.priority));
+			map_cache.dirty = mem_zalloc(map_hgt * map_wid *
+										 sizeof(*map_cache.dirty));
+		}
+		map_cache.tile_hgt = tile_height;
+		map_cache.tile_wid = tile_width;
+		memset(map_cache.dirty, 1, map_hgt * map_wid * sizeof(*map_cache.dirty));
 	}
 
-	/* Nothing here */
-	a = COLOUR_WHITE;
-    c = L' ';
-	ta = COLOUR_WHITE;
-	tc = L' ';
-
 	/* Draw a box around the edge of the term */
 	window_make(0, 0, map_wid + 1, map_hgt + 1);
 
+	/* Start again on the parts of the map that have changed */
+	for (i = 0; i < map_hgt * map_wid; i++)
+		if (map_cache.dirty[i]) map_cache.priority[i] = 0;
+
 	/* Analyze the actual map */
 	for (y = 0; y < cave->height; y++)
 		for (x = 0; x < cave->width; x++) {
-			row = (y * map_hgt / cave->height);
-			col = (x * map_wid / cave->width);
+			struct map_glyph *cell;
 
-			if (tile_width > 1)
-				col = col - (col % tile_width);
-			if (tile_height > 1)
-				row = row - (row % tile_height);
+			i = map_cache_cell(loc(x, y), map_hgt, map_wid);
+			if (!map_cache.dirty[i]) continue;
+			cell = &map_cache.cells[i];
 
 			/* Get the attr/char at that map location */
 			map_info(loc(x, y), &g);
@@ -693,21 +842,32 @@ void display_map(int *cy, int *cx)
 			if ((a != ta) || (c != tc)) tp = 20;
 
 			/* Save "best" */
-			if (mp[row][col] < tp) {
+			if (map_cache.priority[i] < tp) {
 				/* Hack - make every grid on the map lit */
 				g.lighting = LIGHTING_LIT;
-				grid_data_as_text(&g, &a, &c, &ta, &tc);
-
-				Term_queue_char(Term, col + 1, row + 1, a, c, ta, tc);
-
-				if ((tile_width > 1) || (tile_height > 1))
-					Term_big_queue_char(Term, col + 1, row + 1, 255, -1, 0, 0);
+				grid_data_as_text(&g, &cell->a, &cell->c, &cell->ta, &cell->tc);
 
 				/* Save priority */
-				mp[row][col] = tp;
+				map_cache.priority[i] = tp;
 			}
 		}
 
+	/* Draw the map */
+	for (i = 0; i < map_hgt * map_wid; i++) {
+		struct map_glyph *cell = &map_cache.cells[i];
+
+		map_cache.dirty[i] = false;
+		if (!map_cache.priority[i]) continue;
+
+		row = i / map_wid;
+		col = i % map_wid;
+		Term_queue_char(Term, col + 1, row + 1, cell->a, cell->c, cell->ta,
+						cell->tc);
+
+		if ((tile_width > 1) || (tile_height > 1))
+			Term_big_queue_char(Term, col + 1, row + 1, 255, -1, 0, 0);
+	}
+
 	/*** Display the player ***/
 
 	/* Player location */
@@ -732,10 +892,6 @@ void display_map(int *cy, int *cx)
 	/* Return player location */
 	if (cy != NULL) (*cy) = row + 1;
 	if (cx != NULL) (*cx) = col + 1;
-
-	for (y = 0; y < cave->height; y++)
-		mem_free(mp[y]);
-	mem_free(mp);
 }
 
 
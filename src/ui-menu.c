@@ -171,6 +171,7 @@ static void display_scrolling(struct menu *menu, int cursor, int *top, region *l
 	int row = loc->row;
 	int rows_per_page = loc->page_rows;
 	int n = menu->filter_list ? menu->filter_count : menu->count;
+	int old_top = *top;
 	int i;
 
 	/* Keep a certain distance from the top when possible */
@@ -185,7 +186,17 @@ static void display_scrolling(struct menu *menu, int cursor, int *top, region *l
 	*top = MIN(*top, n - rows_per_page);
 	*top = MAX(*top, 0);
 
-	for (i = 0; i < rows_per_page; i++) {
+	/* Only the cursor has moved, so only its old and new rows change */
+	if (menu->cursor_moved && *top == old_top) {
+		int rows[2] = { menu->old_cursor - *top, cursor - *top };
+
+		for (i = 0; i < 2; i++) {
+			if (rows[i] < 0 || rows[i] >= rows_per_page) continue;
+			Term_erase(col, row + rows[i], loc->width);
+			display_menu_row(menu, rows[i] + *top, *top, i == 1,
+							 row + rows[i], col, loc->width);
+		}
+	} else for (i = 0; i < rows_per_page; i++) {
 		/* Blank all lines */
 		Term_erase(col, row + i, loc->width);
 		if (i < n) {
@@ -373,7 +384,17 @@ static void display_columns(struct menu *menu, int cursor, int *top, region *loc
 	if ((colw * cols) > (w - col))
 		colw = (w - col) / cols;
 
-	for (c = 0; c < cols; c++) {
+	/* Only the cursor has moved, so only its old and new places change */
+	if (menu->cursor_moved) {
+		int pos[2] = { menu->old_cursor, cursor };
+
+		for (c = 0; c < 2; c++) {
+			if (pos[c] < 0 || pos[c] >= n) continue;
+			display_menu_row(menu, pos[c], 0, c == 1,
+					row + pos[c] % rows_per_page,
+					col + (pos[c] / rows_per_page) * colw, colw);
+		}
+	} else for (c = 0; c < cols; c++) {
 		for (r = 0; r < rows_per_page; r++) {
 			int pos = c * rows_per_page + r;
 			bool is_cursor = (pos == cursor);
@@ -602,6 +623,7 @@ void menu_refresh(struct menu *menu, bool reset_screen)
 		menu->browse_hook(oid, menu->menu_data, loc);
 
 	menu->skin->display_list(menu, menu->cursor, &menu->top, loc);
+	menu->cursor_moved = false;
 }
 
 
@@ -748,6 +770,7 @@ ui_event menu_select(struct menu *menu, int notify, bool popup)
 {
 	ui_event in = EVENT_EMPTY;
 	bool no_act = (menu->flags & MN_NO_ACTION) ? true : false;
+	bool drawn = false;
 
 	assert(menu->active.width != 0 && menu->active.page_rows != 0);
 
@@ -759,8 +782,11 @@ ui_event menu_select(struct menu *menu, int notify, bool popup)
 	while (!(in.type & notify)) {
 		ui_event out = EVENT_EMPTY;
 		int cursor = menu->cursor;
+		int top = menu->top;
 
-		menu_refresh(menu, popup);
+		if (!drawn)
+			menu_refresh(menu, popup);
+		drawn = false;
 		in = inkey_ex();
 
 		/* Handle mouse & keyboard commands */
@@ -792,14 +818,24 @@ ui_event menu_select(struct menu *menu, int notify, bool popup)
 				menu->row_funcs->resize(menu);
 		}
 
-		/* Redraw menu here if cursor has moved */
+		/* Redraw menu here if cursor has moved; if nothing else has, and
+		 * nothing but the menu draws over the screen, only the rows it moved
+		 * between need drawing */
 		if (cursor != menu->cursor) {
+			if (!popup && !menu->browse_hook && top == menu->top
+				&& in.type != EVT_RESIZE) {
+				menu->cursor_moved = true;
+				menu->old_cursor = cursor;
+			}
 			menu_refresh(menu, popup);
+			drawn = true;
 		}
 
 		/* If we've selected an item, then send that event out */
-		if (out.type == EVT_SELECT && !no_act && menu_handle_action(menu, &out))
+		if (out.type == EVT_SELECT && !no_act && menu_handle_action(menu, &out)) {
+			drawn = false;
 			continue;
+		}
 
 		/* Notify about the outgoing type */
 		if (notify & out.type) {
@@ -250,6 +250,8 @@ struct menu
 	int top;                /* Position in list for partial display */
 	region active;          /* Subregion actually active for selection */
 	int cursor_x_offset;    /* Adjustment to the default position of the cursor on a line. */
+	bool cursor_moved;      /* Only the cursor has moved since the last redraw */
+	int old_cursor;         /* Row the cursor has moved from */
 };
 
 
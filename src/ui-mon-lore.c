@@ -19,6 +19,8 @@
 #include "angband.h"
 #include "init.h"
 #include "mon-lore.h"
+#include "obj-gear.h"
+#include "player-attack.h"
 #include "ui-mon-lore.h"
 #include "ui-output.h"
 #include "ui-prefs.h"
@@ -176,6 +178,101 @@ void lore_show_interactive(const struct monster_race *race,
 	textblock_free(tb);
 }
 
+/**
+ * The last recall shown in the subwindow, and everything about the race and
+ * the player that went into it.  The subwindow is redrawn every turn while a
+ * race is tracked, but usually nothing it shows has changed.
+ */
+static struct {
+	const struct monster_race *race;
+	struct monster_lore lore;
+	struct monster_blow *blows;
+	bool *blow_known;
+	struct player_state state;
+	struct player_state known_state;
+	struct player_options opts;
+	s16b lev;
+	s16b max_depth;
+	int melee_chance;
+	byte x_attr;
+	wchar_t x_char;
+	int tile_size;
+	textblock *tb;
+} recall_cache;
+
+/**
+ * Check whether the cached recall is for this race and lore as things are
+ * now, and if not make it so, returning false
+ */
+static bool recall_cache_check(const struct monster_race *race,
+							   const struct monster_lore *lore)
+{
+	size_t n_blows = z_info->mon_blows_max;
+	struct object *weapon = equipped_item_by_slot_name(player, "weapon");
+	int melee_chance = chance_of_melee_hit(player, weapon);
+	int tile_size = tile_width * 256 + tile_height;
+	bool same = recall_cache.tb && race == recall_cache.race;
+
+	if (!recall_cache.blows) {
+		recall_cache.blows = mem_zalloc(n_blows * sizeof(struct monster_blow));
+		recall_cache.blow_known = mem_zalloc(n_blows * sizeof(bool));
+	}
+
+	same = same &&
+		!memcmp(lore, &recall_cache.lore, sizeof(*lore)) &&
+		(!lore->blows || !memcmp(lore->blows, recall_cache.blows,
+								 n_blows * sizeof(*lore->blows))) &&
+		(!lore->blow_known || !memcmp(lore->blow_known,
+				recall_cache.blow_known, n_blows * sizeof(bool))) &&
+		!memcmp(&player->state, &recall_cache.state, sizeof(player->state)) &&
+		!memcmp(&player->known_state, &recall_cache.known_state,
+				sizeof(player->known_state)) &&
+		!memcmp(&player->opts, &recall_cache.opts, sizeof(player->opts)) &&
+		player->lev == recall_cache.lev &&
+		player->max_depth == recall_cache.max_depth &&
+		melee_chance == recall_cache.melee_chance &&
+		monster_x_attr[race->ridx] == recall_cache.x_attr &&
+		monster_x_char[race->ridx] == recall_cache.x_char &&
+		tile_size == recall_cache.tile_size;
+	if (same) return true;
+
+	recall_cache.race = race;
+	memcpy(&recall_cache.lore, lore, sizeof(*lore));
+	if (lore->blows)
+		memcpy(recall_cache.blows, lore->blows,
+			   n_blows * sizeof(*lore->blows));
+	if (lore->blow_known)
+		memcpy(recall_cache.blow_known, lore->blow_known,
+			   n_blows * sizeof(bool));
+	memcpy(&recall_cache.state, &player->state, sizeof(player->state));
+	memcpy(&recall_cache.known_state, &player->known_state,
+		   sizeof(player->known_state));
+	memcpy(&recall_cache.opts, &player->opts, sizeof(player->opts));
+	recall_cache.lev = player->lev;
+	recall_cache.max_depth = player->max_depth;
+	recall_cache.melee_chance = melee_chance;
+	recall_cache.x_attr = monster_x_attr[race->ridx];
+	recall_cache.x_char = monster_x_char[race->ridx];
+	recall_cache.tile_size = tile_size;
+
+	if (recall_cache.tb)
+		textblock_free(recall_cache.tb);
+	recall_cache.tb = textblock_new();
+	return false;
+}
+
+/**
+ * Forget the cached subwindow recall
+ */
+void lore_cache_free(void)
+{
+	if (recall_cache.tb)
+		textblock_free(recall_cache.tb);
+	mem_free(recall_cache.blows);
+	mem_free(recall_cache.blow_known);
+	memset(&recall_cache, 0, sizeof(recall_cache));
+}
+
 /**
  * Display monster recall statically.
  *
@@ -198,9 +295,10 @@ void lore_show_subwindow(const struct monster_race *race,
 	for (y = 0; y < Term->hgt; y++)
 		Term_erase(0, y, 255);
 
-	tb = textblock_new();
-	lore_description(tb, race, lore, false);
+	/* Only describe the monster again if something has changed */
+	if (!recall_cache_check(race, lore))
+		lore_description(recall_cache.tb, race, lore, false);
+	tb = recall_cache.tb;
 	textui_textblock_place(tb, SCREEN_REGION, NULL);
-	textblock_free(tb);
 }
 
@@ -19,6 +19,7 @@
 
 #include "angband.h"
 #include "init.h"
+#include "obj-knowledge.h"
 #include "obj-list.h"
 #include "obj-util.h"
 #include "ui-object.h"
@@ -344,6 +345,8 @@ void object_list_show_interactive(int height, int width)
 	tb = textblock_new();
 	list = object_list_new();
 
+	/* Every name is formatted twice, once to size the list */
+	object_knowledge_cache_begin();
 	object_list_collect(list);
 	object_list_sort(list, object_list_standard_compare);
 
@@ -373,6 +376,7 @@ void object_list_show_interactive(int height, int width)
 	 */
 	object_list_format_textblock(list, tb, (int)max_height, safe_width, NULL,
 								 NULL);
+	object_knowledge_cache_end();
 	region_erase_bordered(&r);
 	textui_textblock_show(tb, r, NULL);
 
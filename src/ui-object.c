@@ -586,7 +586,8 @@ void show_floor(struct object **floor_list, int floor_num, int mode,
  * Variables for object selection
  * ------------------------------------------------------------------------ */
 
-static item_tester tester_m;
+static struct object **item_index;
+static int item_index_num;
 static region area = { 20, 1, -1, -2 };
 static struct object *selection;
 static const char *prompt;
@@ -607,6 +608,23 @@ static bool allow_all = false;
  * Object selection utilities
  * ------------------------------------------------------------------------ */
 
+/**
+ * Check whether the running item prompt accepts an object.
+ *
+ * Every item the prompt could offer, from the pack, equipment, quiver and
+ * floor, is put through the tester once when the prompt starts; switching
+ * between the lists then only looks the answers up.
+ */
+static bool item_index_accepts(const struct object *obj)
+{
+	int i;
+
+	for (i = 0; i < item_index_num; i++)
+		if (item_index[i] == obj) return true;
+
+	return false;
+}
+
 /**
  * Prevent certain choices depending on the inscriptions on the item.
  *
@@ -1198,12 +1216,13 @@ bool textui_get_item(struct object **choice, const char *pmt, const char *str,
 
 	int floor_max = z_info->floor_size;
 	int floor_num;
+	int index_max = z_info->pack_size + player->body.count +
+		z_info->quiver_size + floor_max;
 
 	floor_list = mem_zalloc(floor_max * sizeof(*floor_list));
 	olist_mode = 0;
 	item_mode = mode;
 	item_cmd = cmd;
-	tester_m = tester;
 	prompt = pmt;
 	allow_all = str ? false : true;
 
@@ -1228,6 +1247,12 @@ bool textui_get_item(struct object **choice, const char *pmt, const char *str,
 	/* Paranoia XXX XXX XXX */
 	event_signal(EVENT_MESSAGE_FLUSH);
 
+	/* Test everything the prompt could offer */
+	item_index = mem_zalloc(index_max * sizeof(*item_index));
+	item_index_num = scan_items(item_index, index_max,
+								USE_INVEN | USE_EQUIP | USE_QUIVER | USE_FLOOR,
+								tester);
+
 	/* Full inventory */
 	i1 = 0;
 	i2 = z_info->pack_size - 1;
@@ -1236,9 +1261,9 @@ bool textui_get_item(struct object **choice, const char *pmt, const char *str,
 	if (!use_inven) i2 = -1;
 
 	/* Restrict inventory indexes */
-	while ((i1 <= i2) && (!object_test(tester, player->upkeep->inven[i1])))
+	while ((i1 <= i2) && (!item_index_accepts(player->upkeep->inven[i1])))
 		i1++;
-	while ((i1 <= i2) && (!object_test(tester, player->upkeep->inven[i2])))
+	while ((i1 <= i2) && (!item_index_accepts(player->upkeep->inven[i2])))
 		i2--;
 
 	/* Accept inventory */
@@ -1256,9 +1281,9 @@ bool textui_get_item(struct object **choice, const char *pmt, const char *str,
 
 	/* Restrict equipment indexes unless starting with no command */
 	if ((cmd != CMD_NULL) || (tester != NULL)) {
-		while ((e1 <= e2) && (!object_test(tester, slot_object(player, e1))))
+		while ((e1 <= e2) && (!item_index_accepts(slot_object(player, e1))))
 			e1++;
-		while ((e1 <= e2) && (!object_test(tester, slot_object(player, e2))))
+		while ((e1 <= e2) && (!item_index_accepts(slot_object(player, e2))))
 			e2--;
 	}
 
@@ -1276,9 +1301,9 @@ bool textui_get_item(struct object **choice, const char *pmt, const char *str,
 	if (!use_quiver) q2 = -1;
 
 	/* Restrict quiver indexes */
-	while ((q1 <= q2) && (!object_test(tester, player->upkeep->quiver[q1])))
+	while ((q1 <= q2) && (!item_index_accepts(player->upkeep->quiver[q1])))
 		q1++;
-	while ((q1 <= q2) && (!object_test(tester, player->upkeep->quiver[q2])))
+	while ((q1 <= q2) && (!item_index_accepts(player->upkeep->quiver[q2])))
 		q2--;
 
 	/* Accept quiver */
@@ -1299,8 +1324,8 @@ bool textui_get_item(struct object **choice, const char *pmt, const char *str,
 	if (!use_floor) f2 = -1;
 
 	/* Restrict floor indexes */
-	while ((f1 <= f2) && (!object_test(tester, floor_list[f1]))) f1++;
-	while ((f1 <= f2) && (!object_test(tester, floor_list[f2]))) f2--;
+	while ((f1 <= f2) && (!item_index_accepts(floor_list[f1]))) f1++;
+	while ((f1 <= f2) && (!item_index_accepts(floor_list[f2]))) f2--;
 
 	/* Accept floor */
 	if ((f1 <= f2) || allow_all)
@@ -1391,13 +1416,15 @@ bool textui_get_item(struct object **choice, const char *pmt, const char *str,
 			/* Build object list */
 			wipe_obj_list();
 			if (player->upkeep->command_wrk == USE_INVEN)
-				build_obj_list(i2, player->upkeep->inven, tester_m, olist_mode);
+				build_obj_list(i2, player->upkeep->inven, item_index_accepts,
+							   olist_mode);
 			else if (player->upkeep->command_wrk == USE_EQUIP)
-				build_obj_list(e2, NULL, tester_m, olist_mode);
+				build_obj_list(e2, NULL, item_index_accepts, olist_mode);
 			else if (player->upkeep->command_wrk == USE_QUIVER)
-				build_obj_list(q2, player->upkeep->quiver, tester_m,olist_mode);
+				build_obj_list(q2, player->upkeep->quiver, item_index_accepts,
+							   olist_mode);
 			else if (player->upkeep->command_wrk == USE_FLOOR)
-				build_obj_list(f2, floor_list, tester_m, olist_mode);
+				build_obj_list(f2, floor_list, item_index_accepts, olist_mode);
 
 			/* Show the prompt */
 			menu_header();
@@ -1437,6 +1464,9 @@ bool textui_get_item(struct object **choice, const char *pmt, const char *str,
 	/* Clean up */
 	player->upkeep->command_wrk = 0;
 	mem_free(floor_list);
+	mem_free(item_index);
+	item_index = NULL;
+	item_index_num = 0;
 
 	/* Result */
 	return (*choice != NULL) ? true : false;
@@ -1652,6 +1682,7 @@ void textui_cmd_ignore_menu(struct object *obj)
 		ignore_level[ignore_type] = ignore_value;
 	}
 
+	ignore_settings_changed();
 	player->upkeep->notice |= PN_IGNORE;
 
 	menu_dynamic_free(m);
@@ -1383,8 +1383,10 @@ static bool quality_action(struct menu *m, const ui_event *event, int oid)
 	evt = menu_select(&menu, 0, true);
 
 	/* Set the new value appropriately */
-	if (evt.type == EVT_SELECT)
+	if (evt.type == EVT_SELECT) {
 		ignore_level[oid] = menu.cursor;
+		ignore_settings_changed();
+	}
 
 	/* Load and finish */
 	screen_load();
@@ -1521,6 +1523,7 @@ static bool ignore_sval_menu_action(struct menu *m, const ui_event *event,
 		else
 			kind->ignore ^= IGNORE_IF_UNAWARE;
 
+		ignore_settings_changed();
 		player->upkeep->notice |= PN_IGNORE;
 		return true;
 	}
@@ -324,9 +324,10 @@ static void display_resistance_panel(const struct player_flag_record *rec,
 
 			/* Object or player info? */
 			if (j < player->body.count) {
-				int index = 0;
+				int index = -1;
 				struct object *obj = slot_object(player, j);
 				struct curse_data *curse = obj ? obj->curses : NULL;
+				int num_curses = obj ? obj->num_curses : 0;
 
 				while (obj) {
 					/* Wipe flagset */
@@ -372,9 +373,9 @@ static void display_resistance_panel(const struct player_flag_record *rec,
 					if (curse) {
 						index++;
 						obj = NULL;
-						while (index < z_info->curse_max) {
+						while (index < num_curses) {
 							if (curse[index].power) {
-								obj = curses[index].obj;
+								obj = curses[curse[index].index].obj;
 								break;
 							} else {
 								index++;
@@ -1025,6 +1026,10 @@ void write_character_dump(ang_file *fff)
 	char buf[1024];
 	char *p;
 
+	/* Nothing changes objects while dumping, so each item's knowledge and
+	 * name are worked out once for the screens and its description */
+	object_knowledge_cache_begin();
+
 	/* Begin dump */
 	file_putf(fff, "  [%s Character Dump]\n\n", buildid);
 
@@ -1213,11 +1218,13 @@ void write_character_dump(ang_file *fff)
 		file_putf(fff, "\n");
 	}
 
+	object_knowledge_cache_end();
 	mem_free(home_list);
 }
 
 /**
- * Save the lore to a file in the user directory.
+ * Save the character dump to a file in the user directory; an unchanged
+ * dump leaves the file as it was.
  *
  * \param path is the path to the filename
  *
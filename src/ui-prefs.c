@@ -24,6 +24,7 @@
 #include "init.h"
 #include "mon-util.h"
 #include "monster.h"
+#include "obj-desc.h"
 #include "obj-ignore.h"
 #include "obj-tval.h"
 #include "obj-util.h"
@@ -342,6 +343,14 @@ void option_dump(ang_file *fff)
 				file_putf(fff, "\n");
 			}
 		}
+
+		/* Dump the frame rate cap, if any */
+		if (angband_term[i]->frame_ms) {
+			file_putf(fff, "# Window '%s', Frames a second\n",
+					  angband_term_name[i]);
+			file_putf(fff, "window-fps:%d:%d\n\n", i,
+					  1000 / angband_term[i]->frame_ms);
+		}
 	}
 }
 
@@ -395,6 +404,18 @@ bool prefs_save(const char *path, void (*dump)(ang_file *), const char *title)
  * Pref file parser
  * ------------------------------------------------------------------------ */
 
+/**
+ * Find an object kind by tval and sval name or number, as lookup_sval() and
+ * lookup_kind() do
+ */
+static struct object_kind *pref_find_kind(int tval, const char *sval)
+{
+	int s = lookup_sval(tval, sval);
+
+	return s >= 0 ? lookup_kind(tval, s) : NULL;
+}
+
+
 /**
  * Load another file.
  */
@@ -573,7 +594,7 @@ static enum parser_error parse_prefs_expr(struct parser *p)
 
 static enum parser_error parse_prefs_object(struct parser *p)
 {
-	int tvi, svi;
+	int tvi;
 	struct object_kind *kind;
 	const char *tval, *sval;
 
@@ -635,11 +656,7 @@ static enum parser_error parse_prefs_object(struct parser *p)
 		} else {
 			/* No error at incorrect sval to stop failure due to outdated
 			 * pref files and enable switching between old and new classes */
-			svi = lookup_sval(tvi, sval);
-			if (svi < 0)
-				return PARSE_ERROR_NONE;
-
-			kind = lookup_kind(tvi, svi);
+			kind = pref_find_kind(tvi, sval);
 			if (!kind)
 				return PARSE_ERROR_NONE;
 
@@ -889,7 +906,7 @@ static enum parser_error parse_prefs_flavor(struct parser *p)
 
 static enum parser_error parse_prefs_inscribe(struct parser *p)
 {
-	int tvi, svi;
+	int tvi;
 	struct object_kind *kind;
 
 	struct prefs_data *d = parser_priv(p);
@@ -900,11 +917,7 @@ static enum parser_error parse_prefs_inscribe(struct parser *p)
 	if (tvi < 0)
 		return PARSE_ERROR_UNRECOGNISED_TVAL;
 
-	svi = lookup_sval(tvi, parser_getsym(p, "sval"));
-	if (svi < 0)
-		return PARSE_ERROR_UNRECOGNISED_SVAL;
-
-	kind = lookup_kind(tvi, svi);
+	kind = pref_find_kind(tvi, parser_getsym(p, "sval"));
 	if (!kind)
 		return PARSE_ERROR_UNRECOGNISED_SVAL;
 
@@ -1033,6 +1046,27 @@ static enum parser_error parse_prefs_window(struct parser *p)
 	return PARSE_ERROR_NONE;
 }
 
+static enum parser_error parse_prefs_window_fps(struct parser *p)
+{
+	int window;
+	unsigned int fps;
+
+	struct prefs_data *d = parser_priv(p);
+	assert(d != NULL);
+	if (d->bypass) return PARSE_ERROR_NONE;
+
+	window = parser_getint(p, "window");
+	if (window <= 0 || window >= ANGBAND_TERM_MAX)
+		return PARSE_ERROR_OUT_OF_BOUNDS;
+
+	/* Cap how often the window is drawn; 0 lifts the cap */
+	fps = parser_getuint(p, "fps");
+	if (angband_term[window])
+		angband_term[window]->frame_ms = fps ? 1000 / MIN(fps, 1000) : 0;
+
+	return PARSE_ERROR_NONE;
+}
+
 enum parser_error parse_prefs_dummy(struct parser *p)
 {
 	return PARSE_ERROR_NONE;
@@ -1065,6 +1099,7 @@ static struct parser *init_parse_prefs(bool user)
 	parser_reg(p, "message sym type sym attr", parse_prefs_message);
 	parser_reg(p, "color uint idx int k int r int g int b", parse_prefs_color);
 	parser_reg(p, "window int window uint flag uint value", parse_prefs_window);
+	parser_reg(p, "window-fps int window uint fps", parse_prefs_window_fps);
 	register_sound_pref_parser(p);
 
 	return p;
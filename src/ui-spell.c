@@ -65,7 +65,6 @@ static void spell_menu_display(struct menu *m, int oid, bool cursor,
 	int spell_index = d->spells[oid];
 	const struct class_spell *spell = spell_by_index(spell_index);
 
-	char help[30];
 	char out[80];
 
 	int attr;
@@ -81,8 +80,7 @@ static void spell_menu_display(struct menu *m, int oid, bool cursor,
 	} else if (player->spell_flags[spell_index] & PY_SPELL_LEARNED) {
 		if (player->spell_flags[spell_index] & PY_SPELL_WORKED) {
 			/* Get extra info */
-			get_spell_info(spell_index, help, sizeof(help));
-			comment = help;
+			spell_chance_info(spell_index, &comment);
 			attr = COLOUR_WHITE;
 		} else {
 			comment = " untried";
@@ -98,7 +96,7 @@ static void spell_menu_display(struct menu *m, int oid, bool cursor,
 
 	/* Dump the spell --(-- */
 	strnfmt(out, sizeof(out), "%-30s%2d %4d %3d%%%s", spell->name,
-			spell->slevel, spell->smana, spell_chance(spell_index), comment);
+			spell->slevel, spell->smana, spell_chance_info(spell_index, NULL), comment);
 	c_prt(attr, illegible ? illegible : out, row, col);
 }
 
@@ -1142,6 +1142,7 @@ void textui_store_knowledge(int n)
 	screen_save();
 	clear_from(0);
 
+	store_catch_up(&stores[n]);
 	store_menu_init(&ctx, &stores[n], true);
 	menu_select(&ctx.menu, 0, false);
 
@@ -1196,6 +1197,9 @@ void use_store(game_event_type type, game_event_data *data, void *user)
 	/* Check that we're on a store */
 	if (!store) return;
 
+	/* Restock for the days since the last visit */
+	store_catch_up(store);
+
 	/*** Display ***/
 
 	/* Save current screen (ie. dungeon) */
@@ -248,8 +248,8 @@ static ui_event target_recall_loop_object(struct object *obj, int y, int x,
 			if (player->wizard) {
 				strnfmt(out_val, TARGET_OUT_VAL_SIZE,
 						"%s%s%s%s, %s (%d:%d, noise=%d, scent=%d).", s1, s2, s3,
-						o_name, coords, y, x, (int)cave->noise.grids[y][x],
-						(int)cave->scent.grids[y][x]);
+						o_name, coords, y, x, square_noise(cave, loc(x, y)),
+						square_scent(cave, loc(x, y)));
 			} else {
 				strnfmt(out_val, TARGET_OUT_VAL_SIZE,
 						"%s%s%s%s, %s.", s1, s2, s3, o_name, coords);
@@ -353,8 +353,8 @@ static ui_event target_set_interactive_aux(int y, int x, int mode)
 			if (player->wizard)
 				strnfmt(out_val, sizeof(out_val),
 						"%s%s%s%s, %s (%d:%d, noise=%d, scent=%d).", s1, s2, s3,
-						name_strange, coords, y, x, (int)cave->noise.grids[y][x],
-						(int)cave->scent.grids[y][x]);
+						name_strange, coords, y, x, square_noise(cave, loc(x, y)),
+						square_scent(cave, loc(x, y)));
 			else
 				strnfmt(out_val, sizeof(out_val), "%s%s%s%s, %s.",
 						s1, s2, s3, name_strange, coords);
@@ -416,8 +416,8 @@ static ui_event target_set_interactive_aux(int y, int x, int mode)
 							strnfmt(out_val, sizeof(out_val),
 									"%s%s%s%s (%s), %s (%d:%d, noise=%d, scent=%d).",
 									s1, s2, s3, m_name, buf, coords, y, x,
-									(int)cave->noise.grids[y][x],
-									(int)cave->scent.grids[y][x]);
+									square_noise(cave, loc(x, y)),
+									square_scent(cave, loc(x, y)));
 						} else {
 							strnfmt(out_val, sizeof(out_val),
 									"%s%s%s%s (%s), %s.",
@@ -482,8 +482,8 @@ static ui_event target_set_interactive_aux(int y, int x, int mode)
 						strnfmt(out_val, sizeof(out_val),
 								"%s%s%s%s, %s (%d:%d, noise=%d, scent=%d).",
 								s1, s2, s3, o_name, coords, y, x,
-								(int)cave->noise.grids[y][x],
-								(int)cave->scent.grids[y][x]);
+								square_noise(cave, loc(x, y)),
+								square_scent(cave, loc(x, y)));
 
 						prt(out_val, 0, 0);
 						move_cursor_relative(y, x);
@@ -548,8 +548,8 @@ static ui_event target_set_interactive_aux(int y, int x, int mode)
 					strnfmt(out_val, sizeof(out_val),
 							"%s%s%s%s, %s (%d:%d, noise=%d, scent=%d).", s1, s2,
 							s3, trap->kind->name, coords, y, x,
-							(int)cave->noise.grids[y][x],
-							(int)cave->scent.grids[y][x]);
+							square_noise(cave, loc(x, y)),
+							square_scent(cave, loc(x, y)));
 				} else {
 					strnfmt(out_val, sizeof(out_val), "%s%s%s%s, %s.", 
 							s1, s2, s3, trap->kind->desc, coords);
@@ -595,8 +595,8 @@ static ui_event target_set_interactive_aux(int y, int x, int mode)
 						strnfmt(out_val, sizeof(out_val),
 								"%s%s%sa pile of %d objects, %s (%d:%d, noise=%d, scent=%d).",
 								s1, s2, s3, floor_num, coords, y, x,
-								(int)cave->noise.grids[y][x],
-								(int)cave->scent.grids[y][x]);
+								square_noise(cave, loc(x, y)),
+								square_scent(cave, loc(x, y)));
 					} else {
 						strnfmt(out_val, sizeof(out_val),
 								"%s%s%sa pile of %d objects, %s.",
@@ -698,8 +698,8 @@ static ui_event target_set_interactive_aux(int y, int x, int mode)
 			if (player->wizard) {
 				strnfmt(out_val, sizeof(out_val),
 						"%s%s%s%s, %s (%d:%d, noise=%d, scent=%d).", s1, s2, s3,
-						name, coords, y, x, (int)cave->noise.grids[y][x],
-						(int)cave->scent.grids[y][x]);
+						name, coords, y, x, square_noise(cave, loc(x, y)),
+						square_scent(cave, loc(x, y)));
 			} else {
 				strnfmt(out_val, sizeof(out_val),
 						"%s%s%s%s, %s.", s1, s2, s3, name, coords);
@@ -16,6 +16,7 @@
  *    are included in all such copies.  Other copyrights may also apply.
  */
 #include "buildid.h"
+#include "game-profile.h"
 #include "h-basic.h"
 #include "ui-term.h"
 #include "z-color.h"
@@ -166,7 +167,9 @@
  * is actually seen by the user, a "requested" screen image (scr)
  * which is being prepared for display, a "memorized" screen image
  * (mem) which is used to save and restore screen images, and a
- * "temporary" screen image (tmp) which is currently unused.
+ * "temporary" screen image (tmp) which is currently unused.  A memorized
+ * image only holds the rows which have been drawn over since it was saved,
+ * each copied from the requested image just before its first change.
  *
  *
  * Several "flags" are available in each "term" to allow the underlying
@@ -298,6 +301,44 @@ u32b window_flag[ANGBAND_TERM_MAX];
  */
 term *Term = NULL;
 
+/**
+ * Work done while waiting for input, such as animation.  It is called when
+ * the time it last asked for has passed, and returns how many milliseconds
+ * until it wants calling again, or a negative number if only input matters.
+ */
+int (*Term_idle_hook)(void) = NULL;
+
+/* When Term_idle_hook next wants calling (in profile_clock() time), or 0 */
+static u64b idle_due;
+
+/**
+ * Least time between frames, in milliseconds, or 0 to show every one, for
+ * terms without a frame_ms of their own.  A Term_fresh() sooner than that
+ * after the last frame leaves its changes in the term; they are shown by
+ * the next one after the interval has passed, or as soon as the game delays
+ * or waits for input.  While the game runs on (resting, running, repeating)
+ * it then never waits on a slow frontend more than once per interval.
+ */
+int Term_frame_ms = 0;
+
+/**
+ * Handed each frame as an encoded diff for anyone watching the game, or
+ * NULL when nobody is; see term_observe_frame() for the encoding
+ */
+void (*Term_observe_hook)(const byte *buf, size_t len) = NULL;
+
+/* Frames after which observers are sent the whole of a term again, so
+ * that they can join part way through a game */
+#define OBSERVE_KEYFRAME	250
+
+/* The frame being encoded for Term_observe_hook, and where its count of
+ * runs goes */
+static byte *observe_buf;
+static size_t observe_len;
+static size_t observe_size;
+static size_t observe_runs_at;
+static int observe_runs;
+
 /* grumbles */
 int log_i = 0;
 int log_size = 0;
@@ -331,6 +372,9 @@ static errr term_win_nuke(term_win *s)
 	mem_free(s->vta);
 	mem_free(s->vtc);
 
+	/* Free the held rows */
+	mem_free(s->held);
+
 	/* Success */
 	return (0);
 }
@@ -414,6 +458,35 @@ static errr term_win_copy(term_win *s, term_win *f, int w, int h)
 }
 
 
+/**
+ * Copy row y of the requested screen into the latest saved screen, which
+ * has to hold it before it is drawn over
+ */
+static void term_hold_row(term *t, int y)
+{
+	term_win *mem = t->mem;
+	int w = t->wid;
+
+	/* Make the arrays on the first row held */
+	if (!mem->va)
+		term_win_init(mem, w, t->hgt);
+
+	memcpy(mem->a[y], t->scr->a[y], w * sizeof(int));
+	memcpy(mem->c[y], t->scr->c[y], w * sizeof(wchar_t));
+	memcpy(mem->ta[y], t->scr->ta[y], w * sizeof(int));
+	memcpy(mem->tc[y], t->scr->tc[y], w * sizeof(wchar_t));
+	mem->held[y] = 1;
+}
+
+/**
+ * Note that row y of the requested screen is about to change
+ */
+#define term_note_row(t, y) \
+	do { \
+		if ((t)->mem && !(t)->mem->held[y]) term_hold_row((t), (y)); \
+	} while (0)
+
+
 
 /**
  * ------------------------------------------------------------------------
@@ -421,11 +494,79 @@ static errr term_win_copy(term_win *s, term_win *f, int w, int h)
  * ------------------------------------------------------------------------ */
 
 
+/**
+ * Least time between frames on a term, in milliseconds, or 0
+ */
+static int term_frame_interval(const term *t)
+{
+	return t->frame_ms ? t->frame_ms : Term_frame_ms;
+}
+
+/**
+ * Show any frames held back by the frame interval, on every term
+ */
+static void term_show_held(void)
+{
+	term *old = Term;
+	int i;
+
+	for (i = -1; i < ANGBAND_TERM_MAX; i++) {
+		term *t = (i < 0) ? old : angband_term[i];
+
+		if (!t || !t->frame_held) continue;
+
+		Term_activate(t);
+		t->frame_at = 0;
+		Term_fresh();
+	}
+
+	Term_activate(old);
+}
+
+/**
+ * Note a frame about to be shown, or return true if it should be held back
+ * for the frame interval
+ */
+static bool term_hold_frame(void)
+{
+	int ms = term_frame_interval(Term);
+	u64b now;
+
+	if (!ms) return false;
+
+	now = profile_clock();
+	if (Term->frame_at && now < Term->frame_at + (u64b) ms * 1000000) {
+		Term->frame_held = true;
+		return true;
+	}
+
+	Term->frame_at = now;
+	Term->frame_held = false;
+	return false;
+}
+
+/**
+ * True if a frame drawn on the term now would be shown, rather than held
+ * back for the frame interval; callers with costly contents to draw can
+ * wait until it is
+ */
+bool term_frame_due(const term *t)
+{
+	int ms = term_frame_interval(t);
+
+	return !ms || !t->frame_at ||
+		profile_clock() >= t->frame_at + (u64b) ms * 1000000;
+}
+
 /**
  * Execute the "Term->xtra_hook" hook, if available (see above).
  */
 errr Term_xtra(int n, int v)
 {
+	/* Show held-back frames before the game pauses */
+	if (n == TERM_XTRA_DELAY || (n == TERM_XTRA_EVENT && v))
+		term_show_held();
+
 	/* Verify the hook */
 	if (!Term->xtra_hook) return (-1);
 
@@ -523,6 +664,7 @@ void Term_queue_char(term *t, int x, int y, int a, wchar_t c, int ta,
 
 	/* Hack -- Ignore non-changes */
 	if ((oa == a) && (oc == c) && (ota == ta) && (otc == tc)) return;
+	term_note_row(t, y);
 
 	/* Save the "literal" information */
 	scr_aa[x] = a;
@@ -620,6 +762,7 @@ void Term_queue_chars(int x, int y, int n, int a, const wchar_t *s)
 
 		/* Hack -- Ignore non-changes */
 		if ((oa == a) && (oc == *s) && (ota == 0) && (otc == 0)) continue;
+		if (x1 < 0) term_note_row(Term, y);
 
 		/* Save the "literal" information */
 		scr_aa[x] = a;
@@ -653,6 +796,89 @@ void Term_queue_chars(int x, int y, int n, int a, const wchar_t *s)
  * ------------------------------------------------------------------------ */
 
 
+/**
+ * Number of grids compared at a time when looking for changes in a row
+ */
+#define TERM_DIFF_CHUNK 16
+
+/**
+ * Check whether n grids of row y starting at x are unchanged since they were
+ * last drawn, including terrain if `terrain` is set
+ */
+static bool Term_row_same(int y, int x, int n, bool terrain)
+{
+	term_win *old = Term->old, *scr = Term->scr;
+
+	if (memcmp(&old->a[y][x], &scr->a[y][x], n * sizeof(int))) return false;
+	if (memcmp(&old->c[y][x], &scr->c[y][x], n * sizeof(wchar_t)))
+		return false;
+	if (!terrain) return true;
+	if (memcmp(&old->ta[y][x], &scr->ta[y][x], n * sizeof(int)))
+		return false;
+	if (memcmp(&old->tc[y][x], &scr->tc[y][x], n * sizeof(wchar_t)))
+		return false;
+	return true;
+}
+
+/**
+ * Find the first changed grid in row y from x to x2, skipping unchanged
+ * grids a chunk at a time; returns x2 + 1 if there is none
+ */
+static int Term_row_next_change(int y, int x, int x2, bool terrain)
+{
+	while (x + TERM_DIFF_CHUNK <= x2 + 1 &&
+		   Term_row_same(y, x, TERM_DIFF_CHUNK, terrain))
+		x += TERM_DIFF_CHUNK;
+	while (x <= x2 && Term_row_same(y, x, 1, terrain))
+		x++;
+	return x;
+}
+
+/**
+ * Find the last changed grid in row y from x1 to x2; returns x1 - 1 if
+ * there is none
+ */
+static int Term_row_last_change(int y, int x1, int x2, bool terrain)
+{
+	while (x2 - TERM_DIFF_CHUNK >= x1 - 1 &&
+		   Term_row_same(y, x2 - TERM_DIFF_CHUNK + 1, TERM_DIFF_CHUNK, terrain))
+		x2 -= TERM_DIFF_CHUNK;
+	while (x2 >= x1 && Term_row_same(y, x2, 1, terrain))
+		x2--;
+	return x2;
+}
+
+/**
+ * Flush a row of the current window (see "Term_fresh")
+ *
+ * Add each changed grid to the batch for "Term->batch_hook"
+ */
+static void Term_fresh_row_batch(int y, int x1, int x2, bool terrain)
+{
+	term_win *old = Term->old, *scr = Term->scr;
+	int x;
+
+	for (x = Term_row_next_change(y, x1, x2, terrain); x <= x2;
+		 x = Term_row_next_change(y, x + 1, x2, terrain)) {
+		struct term_glyph *g = &Term->batch[Term->batch_num++];
+
+		/* Save new contents */
+		old->a[y][x] = scr->a[y][x];
+		old->c[y][x] = scr->c[y][x];
+		if (terrain) {
+			old->ta[y][x] = scr->ta[y][x];
+			old->tc[y][x] = scr->tc[y][x];
+		}
+
+		g->x = x;
+		g->y = y;
+		g->a = scr->a[y][x];
+		g->c = scr->c[y][x];
+		g->ta = scr->ta[y][x];
+		g->tc = scr->tc[y][x];
+	}
+}
+
 /**
  * Flush a row of the current window (see "Term_fresh")
  *
@@ -720,7 +946,8 @@ static void Term_fresh_row_pict(int y, int x1, int x2)
 				fn = 0;
 			}
 
-			/* Skip */
+			/* Skip to the next change */
+			x = Term_row_next_change(y, x + 1, x2, true) - 1;
 			continue;
 		}
 
@@ -818,7 +1045,8 @@ static void Term_fresh_row_both(int y, int x1, int x2)
 				fn = 0;
 			}
 
-			/* Skip */
+			/* Skip to the next change */
+			x = Term_row_next_change(y, x + 1, x2, true) - 1;
 			continue;
 		}
 
@@ -943,7 +1171,8 @@ static void Term_fresh_row_text(int y, int x1, int x2)
 				fn = 0;
 			}
 
-			/* Skip */
+			/* Skip to the next change */
+			x = Term_row_next_change(y, x + 1, x2, false) - 1;
 			continue;
 		}
 
@@ -1017,6 +1246,150 @@ bool bigcurs = false;
 bool smlcurs = true;
 
 
+/**
+ * ------------------------------------------------------------------------
+ * Observer frames
+ * ------------------------------------------------------------------------ */
+
+
+static void observe_put(const byte *p, size_t n)
+{
+	if (observe_len + n > observe_size) {
+		while (observe_len + n > observe_size)
+			observe_size = observe_size ? observe_size * 2 : 4096;
+		observe_buf = mem_realloc(observe_buf, observe_size);
+	}
+	memcpy(observe_buf + observe_len, p, n);
+	observe_len += n;
+}
+
+static void observe_put_u8(int v)
+{
+	byte b = (byte)v;
+	observe_put(&b, 1);
+}
+
+static void observe_put_u16(int v)
+{
+	byte b[2];
+	b[0] = (byte)(v & 0xFF);
+	b[1] = (byte)((v >> 8) & 0xFF);
+	observe_put(b, 2);
+}
+
+/* Characters go out as UTF-8, whatever the locale */
+static void observe_put_char(wchar_t c)
+{
+	u32b v = (u32b)c;
+	byte b[4];
+	size_t n;
+
+	if (v < 0x80) {
+		b[0] = (byte)v;
+		n = 1;
+	} else if (v < 0x800) {
+		b[0] = (byte)(0xC0 | (v >> 6));
+		b[1] = (byte)(0x80 | (v & 0x3F));
+		n = 2;
+	} else if (v < 0x10000) {
+		b[0] = (byte)(0xE0 | (v >> 12));
+		b[1] = (byte)(0x80 | ((v >> 6) & 0x3F));
+		b[2] = (byte)(0x80 | (v & 0x3F));
+		n = 3;
+	} else {
+		b[0] = (byte)(0xF0 | ((v >> 18) & 0x07));
+		b[1] = (byte)(0x80 | ((v >> 12) & 0x3F));
+		b[2] = (byte)(0x80 | ((v >> 6) & 0x3F));
+		b[3] = (byte)(0x80 | (v & 0x3F));
+		n = 4;
+	}
+	observe_put(b, n);
+}
+
+/**
+ * Whether the frame being refreshed sends the whole term to observers
+ */
+static bool term_observe_keyframe(void)
+{
+	return (Term->observe_frames % OBSERVE_KEYFRAME) == 0;
+}
+
+/**
+ * Start encoding a frame of the current term for observers
+ */
+static void term_observe_start(void)
+{
+	int i, idx = 255;
+
+	for (i = 0; i < ANGBAND_TERM_MAX; i++)
+		if (angband_term[i] == Term) idx = i;
+
+	observe_len = 0;
+	observe_runs = 0;
+	observe_put_u8('F');
+	observe_put_u8(idx);
+	observe_put_u8((term_observe_keyframe() ? 0x01 : 0) |
+				   ((Term->scr->cv && !Term->scr->cu) ? 0x02 : 0));
+	observe_put_u16(Term->wid);
+	observe_put_u16(Term->hgt);
+	observe_put_u16(Term->scr->cx);
+	observe_put_u16(Term->scr->cy);
+	observe_runs_at = observe_len;
+	observe_put_u16(0);
+}
+
+/**
+ * Add grids x1 to x2 of row y, as they now are, to the observers' frame
+ */
+static void term_observe_run(int y, int x1, int x2)
+{
+	term_win *scr = Term->scr;
+	int x;
+
+	if (x1 > x2) return;
+
+	observe_put_u16(y);
+	observe_put_u16(x1);
+	observe_put_u16(x2 - x1 + 1);
+	for (x = x1; x <= x2; x++) {
+		observe_put_u16(scr->a[y][x]);
+		observe_put_char(scr->c[y][x]);
+		observe_put_u16(scr->ta[y][x]);
+		observe_put_char(scr->tc[y][x]);
+	}
+	observe_runs++;
+}
+
+/**
+ * Hand the finished frame to Term_observe_hook.
+ *
+ * A frame is, with every number little-endian:
+ *	- 'F', then the term's index in angband_term[] (255 if it has none)
+ *	- flags: 0x01 if the frame holds the whole term, 0x02 if the cursor
+ *	  is visible
+ *	- the term's width and height, and the cursor's x and y (two bytes each)
+ *	- the number of runs (two bytes), then for each run its row, first
+ *	  column and length (two bytes each) followed by each grid's attr
+ *	  (two bytes), char (UTF-8), terrain attr (two bytes) and terrain
+ *	  char (UTF-8)
+ *
+ * Frames are encoded once, however many observers the hook passes them to.
+ */
+static void term_observe_frame(void)
+{
+	int y;
+
+	/* Send the whole term now and then */
+	if (term_observe_keyframe())
+		for (y = 0; y < Term->hgt; y++)
+			term_observe_run(y, 0, Term->wid - 1);
+
+	observe_buf[observe_runs_at] = (byte)(observe_runs & 0xFF);
+	observe_buf[observe_runs_at + 1] = (byte)((observe_runs >> 8) & 0xFF);
+	Term_observe_hook(observe_buf, observe_len);
+	Term->observe_frames++;
+}
+
 /**
  * Actually perform all requested changes to the window
  *
@@ -1129,7 +1502,7 @@ bool smlcurs = true;
  * Currently, the use of "Term->icky_corner" and "Term->soft_cursor"
  * together may result in undefined behavior.
  */
-errr Term_fresh(void)
+static errr Term_fresh_aux(void)
 {
 	int x, y;
 
@@ -1142,6 +1515,8 @@ errr Term_fresh(void)
 	term_win *old = Term->old;
 	term_win *scr = Term->scr;
 
+	bool observe = (Term_observe_hook != NULL);
+
 
 	/* Do nothing unless "mapped" */
 	if (!Term->mapped_flag) return (1);
@@ -1159,6 +1534,9 @@ errr Term_fresh(void)
 	}
 
 
+	/* Start the frame for anyone watching */
+	if (observe) term_observe_start();
+
 	/* Paranoia -- use "fake" hooks to prevent core dumps */
 	if (!Term->curs_hook) Term->curs_hook = Term_curs_hack;
 	if (!Term->bigcurs_hook) Term->bigcurs_hook = Term->curs_hook;
@@ -1250,6 +1628,13 @@ errr Term_fresh(void)
 
 	/* Something to update */
 	if (y1 <= y2) {
+		/* Make room to batch every grid */
+		if (Term->batch_hook && Term->batch_size < w * h) {
+			Term->batch_size = w * h;
+			Term->batch = mem_realloc(Term->batch,
+				Term->batch_size * sizeof(struct term_glyph));
+		}
+
 		/* Handle "icky corner" */
 		if ((Term->icky_corner) && (y2 >= h - 1) && (Term->x2[h - 1] > w - 2))
 			Term->x2[h - 1] = w - 2;
@@ -1262,8 +1647,20 @@ errr Term_fresh(void)
 
 			/* Flush each "modified" row */
 			if (x1 <= x2) {
+				/* Only look at the part which has actually changed */
+				bool terrain = Term->always_pict || Term->higher_pict;
+				x1 = Term_row_next_change(y, x1, x2, terrain);
+				x2 = Term_row_last_change(y, x1, x2, terrain);
+
+				/* Tell observers, unless they get the whole term anyway */
+				if (observe && !term_observe_keyframe())
+					term_observe_run(y, x1, x2);
+
 				/* Use "Term_pict()" - always, sometimes or never */
-				if (Term->always_pict)
+				if (Term->batch_hook)
+					/* Save the row's changes for later */
+					Term_fresh_row_batch(y, x1, x2, terrain);
+				else if (Term->always_pict)
 					/* Flush the row */
 					Term_fresh_row_pict(y, x1, x2);
 				else if (Term->higher_pict)
@@ -1278,10 +1675,17 @@ errr Term_fresh(void)
 				Term->x2[y] = 0;
 
 				/* Hack -- Flush that row (if allowed) */
-				if (!Term->never_frosh) Term_xtra(TERM_XTRA_FROSH, y);
+				if (!Term->never_frosh && !Term->batch_hook)
+					Term_xtra(TERM_XTRA_FROSH, y);
 			}
 		}
 
+		/* Hand over the whole frame at once */
+		if (Term->batch_num) {
+			(void)((*Term->batch_hook)(Term->batch, Term->batch_num));
+			Term->batch_num = 0;
+		}
+
 		/* No rows are invalid */
 		Term->y1 = h;
 		Term->y2 = 0;
@@ -1322,6 +1726,9 @@ errr Term_fresh(void)
 	old->cx = scr->cx;
 	old->cy = scr->cy;
 
+	/* Send observers the frame */
+	if (observe) term_observe_frame();
+
 
 	/* Actually flush the output */
 	Term_xtra(TERM_XTRA_FRESH, 0);
@@ -1330,6 +1737,26 @@ errr Term_fresh(void)
 	return (0);
 }
 
+/**
+ * Refresh the terminal, timing it if the game loop is being profiled
+ */
+errr Term_fresh(void)
+{
+	enum mem_tag tag;
+	u64b start;
+	errr result;
+
+	if (term_hold_frame()) return 0;
+
+	tag = mem_tag_set(MEM_TAG_UI);
+	start = profile_begin();
+	result = Term_fresh_aux();
+
+	profile_end(PROFILE_FRESH, start);
+	mem_tag_set(tag);
+	return result;
+}
+
 
 
 /**
@@ -1477,14 +1904,14 @@ errr Term_addstr(int n, int a, const char *buf)
 
 	wchar_t s[1024];
 
-	/* Copy to a rewriteable string */
- 	text_mbstowcs(s, buf, 1024);
-
 	/* Handle "unusable" cursor */
 	if (Term->scr->cu) return (-1);
 
 	/* Obtain maximal length */
-	k = (n < 0) ? (w + 1) : n;
+	k = (n < 0) ? (w + 1) : MIN(n, 1024);
+
+	/* Copy to a rewriteable string, as much as could be shown */
+	text_mbstowcs(s, buf, k);
 
 	/* Obtain the usable string length */
 	for (n = 0; (n < k) && s[n]; n++) /* loop */;
@@ -1632,6 +2059,7 @@ errr Term_erase(int x, int y, int n)
 
 		/* Hack -- Ignore "non-changes" */
 		if ((oa == na) && (oc == nc)) continue;
+		if (x1 < 0) term_note_row(Term, y);
 
 		/* Save the "literal" information */
 		scr_aa[x] = na;
@@ -1684,6 +2112,10 @@ errr Term_clear(void)
 	/* Cursor to the top left */
 	Term->scr->cx = Term->scr->cy = 0;
 
+	/* Any saved screen needs all of its rows */
+	for (y = 0; y < h; y++)
+		term_note_row(Term, y);
+
 	/* Wipe each row */
 	for (y = 0; y < h; y++) {
 		int *scr_aa = Term->scr->a[y];
@@ -2007,6 +2439,31 @@ errr Term_event_push(const ui_event *ke)
 
 
 
+/**
+ * Do the idle work if it is due, and return how many milliseconds a wait
+ * for input may last before the idle work is next due (negative for no
+ * limit)
+ */
+static int term_idle_wait(void)
+{
+	u64b now;
+	int ms;
+
+	if (!Term_idle_hook) return -1;
+
+	now = profile_clock();
+	if (!idle_due || now >= idle_due) {
+		ms = Term_idle_hook();
+		if (ms < 0) {
+			idle_due = 0;
+			return -1;
+		}
+		idle_due = now + (u64b) ms * 1000000;
+	}
+
+	return (int) ((idle_due - now + 999999) / 1000000);
+}
+
 /**
  * Check for a pending keypress on the key queue.
  *
@@ -2027,8 +2484,19 @@ errr Term_inkey(ui_event *ch, bool wait, bool take)
 		/* Process random events */
 		Term_xtra(TERM_XTRA_BORED, 0);
 
+	/* Nothing held back while we wait */
+	if (wait && Term->key_head == Term->key_tail)
+		term_show_held();
+
 	/* Wait or not */
-	if (wait)
+	if (wait && Term->wait_hook) {
+		/* Sleep until there are events, or the idle work is due */
+		while (Term->key_head == Term->key_tail) {
+			Term_xtra(TERM_XTRA_EVENT, false);
+			if (Term->key_head != Term->key_tail) break;
+			Term->wait_hook(term_idle_wait());
+		}
+	} else if (wait)
 		/* Process pending events while necessary */
 		while (Term->key_head == Term->key_tail)
 			/* Process events (wait for one) */
@@ -2069,19 +2537,17 @@ errr Term_inkey(ui_event *ch, bool wait, bool take)
  */
 errr Term_save(void)
 {
-	int w = Term->wid;
-	int h = Term->hgt;
-
 	term_win *mem;
 
-	/* Allocate window */
+	/* Allocate window, holding no rows until they are drawn over */
 	mem = mem_zalloc(sizeof(term_win));
+	mem->held = mem_zalloc(Term->hgt * sizeof(byte));
 
-	/* Initialize window */
-	term_win_init(mem, w, h);
-
-	/* Grab */
-	term_win_copy(mem, Term->scr, w, h);
+	/* Grab the cursor */
+	mem->cx = Term->scr->cx;
+	mem->cy = Term->scr->cy;
+	mem->cu = Term->scr->cu;
+	mem->cv = Term->scr->cv;
 
 	/* Front of the queue */
 	mem->next = Term->mem;
@@ -2096,7 +2562,9 @@ errr Term_save(void)
 
 
 /**
- * Restore the "requested" contents (see above).
+ * Restore the "requested" contents (see above).  Only the rows drawn over
+ * since the matching save are copied back, and only the parts of them
+ * which differ are marked for redrawing.
  *
  * Every "Term_save()" should match exactly one "Term_load()"
  */
@@ -2117,8 +2585,45 @@ errr Term_load(void)
 		/* Forget it */
 		Term->mem = Term->mem->next;
 
-		/* Load */
-		term_win_copy(Term->scr, tmp, w, h);
+		/* Load the rows it holds */
+		for (y = 0; y < h; y++) {
+			int x1, x2;
+
+			if (!tmp->held[y]) continue;
+
+			/* Find what differs */
+			for (x1 = 0; x1 < w; x1++)
+				if (tmp->a[y][x1] != Term->scr->a[y][x1] ||
+					tmp->c[y][x1] != Term->scr->c[y][x1] ||
+					tmp->ta[y][x1] != Term->scr->ta[y][x1] ||
+					tmp->tc[y][x1] != Term->scr->tc[y][x1])
+					break;
+			if (x1 == w) continue;
+			for (x2 = w - 1; x2 > x1; x2--)
+				if (tmp->a[y][x2] != Term->scr->a[y][x2] ||
+					tmp->c[y][x2] != Term->scr->c[y][x2] ||
+					tmp->ta[y][x2] != Term->scr->ta[y][x2] ||
+					tmp->tc[y][x2] != Term->scr->tc[y][x2])
+					break;
+
+			/* Load */
+			memcpy(Term->scr->a[y], tmp->a[y], w * sizeof(int));
+			memcpy(Term->scr->c[y], tmp->c[y], w * sizeof(wchar_t));
+			memcpy(Term->scr->ta[y], tmp->ta[y], w * sizeof(int));
+			memcpy(Term->scr->tc[y], tmp->tc[y], w * sizeof(wchar_t));
+
+			/* Note the change */
+			if (y < Term->y1) Term->y1 = y;
+			if (y > Term->y2) Term->y2 = y;
+			if (x1 < Term->x1[y]) Term->x1[y] = x1;
+			if (x2 > Term->x2[y]) Term->x2[y] = x2;
+		}
+
+		/* Load the cursor */
+		Term->scr->cx = tmp->cx;
+		Term->scr->cy = tmp->cy;
+		Term->scr->cu = tmp->cu;
+		Term->scr->cv = tmp->cv;
 
 		/* Free the old window */
 		(void)term_win_nuke(tmp);
@@ -2127,17 +2632,6 @@ errr Term_load(void)
 		mem_free(tmp);
 	}
 
-	/* Assume change */
-	for (y = 0; y < h; y++) {
-		/* Assume change */
-		Term->x1[y] = 0;
-		Term->x2[y] = w - 1;
-	}
-
-	/* Assume change */
-	Term->y1 = 0;
-	Term->y2 = h - 1;
-
 	/* One less saved */
 	Term->saved--;
 
@@ -2190,7 +2684,10 @@ errr Term_resize(int w, int h)
 	/* Save old window */
 	hold_scr = Term->scr;
 
-	/* Save old window */
+	/* Save old window, with every row held */
+	if (Term->mem)
+		for (i = 0; i < Term->hgt; i++)
+			term_note_row(Term, i);
 	hold_mem = Term->mem;
 
 	/* Save old window */
@@ -2225,6 +2722,8 @@ errr Term_resize(int w, int h)
 
 		/* Initialize new window */
 		term_win_init(Term->mem, w, h);
+		Term->mem->held = mem_alloc(h * sizeof(byte));
+		memset(Term->mem->held, 1, h * sizeof(byte));
 
 		/* Save the contents */
 		term_win_copy(Term->mem, hold_mem, wid, hgt);
@@ -2296,6 +2795,9 @@ errr Term_resize(int w, int h)
 	Term->wid = w;
 	Term->hgt = h;
 
+	/* Observers need the whole term again */
+	Term->observe_frames = 0;
+
 	/* Force "total erase" */
 	Term->total_erase = true;
 
@@ -2378,6 +2880,11 @@ errr term_nuke(term *t)
 	}
 
 
+	/* Forget any batch */
+	mem_free(t->batch);
+	t->batch = NULL;
+	t->batch_size = 0;
+
 	/* Nuke "displayed" */
 	term_win_nuke(t->old);
 
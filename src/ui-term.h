@@ -27,6 +27,7 @@
  *	- Array[h*w] -- Attribute array
  *	- Array[h*w] -- Character array
  *
+ *	- Array[h] -- Rows held, for a saved screen (see Term_save())
  *	- next screen saved
  *	- hook to be called on screen size change
  *
@@ -53,6 +54,8 @@ struct term_win
 	int *vta;
 	wchar_t *vtc;
 
+	byte *held;
+
 	term_win *next;
 };
 
@@ -155,7 +158,23 @@ struct term_win
  *	- Hook for drawing a string of chars using an attr
  *
  *	- Hook for drawing a sequence of special attr/char pairs
+ *
+ *	- Hook for sleeping until there is input (optional)
+ */
+
+/**
+ * A changed grid, as handed to a term's batch_hook
+ *
+ * An attr of 0 means the grid should be erased unless the term has
+ * always_text set, and an attr of 255 marks the second part of a big tile.
  */
+struct term_glyph {
+	int x, y;
+	int a;
+	wchar_t c;
+	int ta;
+	wchar_t tc;
+};
 
 typedef struct term term;
 
@@ -231,8 +250,31 @@ struct term
 
 	errr (*pict_hook)(int x, int y, int n, const int *ap, const wchar_t *cp, const int *tap, const wchar_t *tcp);
 
+	errr (*batch_hook)(const struct term_glyph *glyphs, int n);
+
 	void (*view_map_hook)(term *t);
 
+	/* Block until there is an event to process, or until ms milliseconds
+	 * have passed if ms is not negative; without it, Term_inkey() waits
+	 * through TERM_XTRA_EVENT */
+	errr (*wait_hook)(int ms);
+
+	/* Least time between frames for this term, in milliseconds, or 0 to
+	 * follow Term_frame_ms; when the last frame was shown (in
+	 * profile_clock() time), and whether one has been held back since */
+	int frame_ms;
+	u64b frame_at;
+	bool frame_held;
+
+	/* Frames sent to Term_observe_hook since the term was made or
+	 * resized */
+	int observe_frames;
+
+	/* Changed grids for batch_hook */
+	struct term_glyph *batch;
+	int batch_num;
+	int batch_size;
+
 };
 
 
@@ -335,6 +377,9 @@ extern struct keypress keylog[KEYLOG_SIZE];
  * ------------------------------------------------------------------------ */
 
 extern term *Term;
+extern int (*Term_idle_hook)(void);
+extern int Term_frame_ms;
+extern void (*Term_observe_hook)(const byte *buf, size_t len);
 extern byte tile_width;
 extern byte tile_height;
 extern bool bigcurs;
@@ -396,6 +441,7 @@ extern errr Term_resize(int w, int h);
 extern errr Term_activate(term *t);
 
 extern errr term_nuke(term *t);
+extern bool term_frame_due(const term *t);
 extern errr term_init(term *t, int w, int h, int k);
 
 extern int big_pad(int col, int row, byte a, wchar_t c);
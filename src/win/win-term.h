@@ -93,6 +93,11 @@ struct _term_data
 	uint map_tile_hgt;
 
 	bool map_active;
+
+	HBITMAP tile_cache;
+	HBITMAP tile_cache_mask;
+	int tile_cache_wid;
+	int tile_cache_hgt;
 };
 
 
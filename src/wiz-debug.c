@@ -17,9 +17,12 @@
  */
 
 #include "angband.h"
+#include "buildid.h"
 #include "cave.h"
 #include "cmds.h"
 #include "effects.h"
+#include "game-profile.h"
+#include "game-world.h"
 #include "game-input.h"
 #include "grafmode.h"
 #include "init.h"
@@ -50,6 +53,7 @@
 #include "ui-input.h"
 #include "ui-map.h"
 #include "ui-menu.h"
+#include "ui-output.h"
 #include "ui-prefs.h"
 #include "ui-target.h"
 #include "wizard.h"
@@ -149,7 +153,7 @@ static void do_cmd_wiz_hack_nick(void)
 				if (!square_in_bounds_fully(cave, grid)) continue;
 
 				/* Display proper noise */
-				if (cave->noise.grids[y][x] != i) continue;
+				if (square_noise(cave, loc(x, y)) != i) continue;
 
 				/* Display player/floors/walls */
 				if (loc_eq(grid, player->grid))
@@ -179,7 +183,7 @@ static void do_cmd_wiz_hack_nick(void)
 				if (!square_in_bounds_fully(cave, grid)) continue;
 
 				/* Display proper smell */
-				if (cave->scent.grids[y][x] != i) continue;
+				if (square_scent(cave, loc(x, y)) != i) continue;
 
 				/* Display player/floors/walls */
 				if (loc_eq(grid, player->grid))
@@ -931,7 +935,7 @@ static void wiz_tweak_item(struct object *obj)
 	if (val) {
 		obj->artifact = &a_info[val];
 	} else {
-		obj->artifact = lookup_artifact_name(tmp_val);
+		obj->artifact = lookup_closest_artifact(tmp_val);
 	}
 	if (obj->artifact) {
 		struct artifact *a = obj->artifact;
@@ -1032,6 +1036,7 @@ static void wiz_reroll_item(struct object *obj)
 		obj->brands = NULL;
 		mem_free(obj->curses);
 		obj->curses = NULL;
+		obj->num_curses = 0;
 
 		/* Copy over - slays and brands OK, pile info needs restoring */
 		object_copy(obj, new);
@@ -1416,6 +1421,7 @@ static void do_cmd_wiz_cure_all(void)
 		if (player->body.slots[i].obj && player->body.slots[i].obj->curses) {
 			mem_free(player->body.slots[i].obj->curses);
 			player->body.slots[i].obj->curses = NULL;
+			player->body.slots[i].obj->num_curses = 0;
 		}
 	}
 
@@ -1980,6 +1986,77 @@ void do_cmd_wiz_effect(void)
 		msg("Identified!");
 }
 
+/**
+ * View, control or dump the timings of the parts of the game loop, and the
+ * memory accounted to each part of the game
+ */
+static void do_cmd_wiz_profile(void)
+{
+	char cmd, buf[1024];
+	textblock *tb;
+	ang_file *fh;
+
+#ifdef GAME_TRACE
+	if (!get_com(format("Profiling is %s: [v]iew, [t]oggle, [r]eset, "
+						"[d]ump to file, [w]rite trace? ",
+						profile_enabled ? "on" : "off"), &cmd))
+		return;
+#else
+	if (!get_com(format("Profiling is %s: [v]iew, [t]oggle, [r]eset, "
+						"[d]ump to file? ", profile_enabled ? "on" : "off"),
+				 &cmd))
+		return;
+#endif
+
+	switch (cmd) {
+		case 'v':
+			tb = textblock_new();
+			profile_describe(tb);
+			textblock_append(tb, "\n");
+			profile_describe_memory(tb);
+			textui_textblock_show(tb, SCREEN_REGION, "Game loop profile");
+			textblock_free(tb);
+			break;
+		case 't':
+			profile_enabled = !profile_enabled;
+			msg("Profiling is now %s.", profile_enabled ? "on" : "off");
+			break;
+		case 'r':
+			profile_reset();
+			mem_tag_reset();
+			msg("Profile reset.");
+			break;
+		case 'd':
+			path_build(buf, sizeof(buf), ANGBAND_DIR_USER, "profile.txt");
+			fh = file_open(buf, MODE_WRITE, FTYPE_TEXT);
+			if (!fh) {
+				msg("Cannot create %s.", buf);
+				break;
+			}
+			tb = textblock_new();
+			textblock_append(tb, "Game loop profile for %s, turn %ld, "
+							 "dungeon level %d\n\n", buildid, (long) turn,
+							 player->depth);
+			profile_describe(tb);
+			textblock_append(tb, "\n");
+			profile_describe_memory(tb);
+			textblock_to_file(tb, fh, 0, 80);
+			textblock_free(tb);
+			file_close(fh);
+			msg("Profile written to %s.", buf);
+			break;
+#ifdef GAME_TRACE
+		case 'w':
+			path_build(buf, sizeof(buf), ANGBAND_DIR_USER, "trace.json");
+			if (trace_dump(buf))
+				msg("Trace written to %s.", buf);
+			else
+				msg("Cannot create %s.", buf);
+			break;
+#endif
+	}
+}
+
 /**
  * Main switch for processing debug commands.  This is a step back in time to
  * how all commands used to be processed
@@ -2149,6 +2226,13 @@ void get_debug_command(void)
 			break;
 		}
 
+		/* Game loop profiling */
+		case 'M':
+		{
+			do_cmd_wiz_profile();
+			break;
+		}
+
 		/* Magic Mapping */
 		case 'm':
 		{
@@ -2177,7 +2261,7 @@ void get_debug_command(void)
 					r = &r_info[r_idx];
 				else
 					/* If not, find the monster with that name */
-					r = lookup_monster(name); 
+					r = lookup_closest_monster(name);
 					
 				player->upkeep->redraw |= (PR_MAP | PR_MONLIST);
 			}
@@ -2259,7 +2343,7 @@ void get_debug_command(void)
 						race = &r_info[r_idx];
 					else
 						/* If not, find the monster with that name */
-						race = lookup_monster(name); 
+						race = lookup_closest_monster(name);
 				}
 
 				/* Reload the screen */
@@ -2399,7 +2483,7 @@ void get_debug_command(void)
 						race = &r_info[r_idx];
 					else
 						/* If not, find the monster with that name */
-						race = lookup_monster(name); 
+						race = lookup_closest_monster(name);
 				}
 					
 				/* Reload the screen */
@@ -175,31 +175,51 @@ static void kind_info(char *buf, size_t buf_len, char *dam, size_t dam_len,
 	if (wgt)
 		strnfmt(wgt, wgt_len, "%3d.%d", obj->weight / 10, obj->weight % 10);
 
-	/* Hack */
-	if (!dam)
-		return;
-
 	/* Misc info */
-	dam[0] = '\0';
-
-	/* Damage */
-	if (tval_is_ammo(obj) || tval_is_melee_weapon(obj))
-		strnfmt(dam, dam_len, "%dd%d", obj->dd, obj->ds);
-	else if (tval_is_armor(obj))
-		strnfmt(dam, dam_len, "%d", obj->ac);
+	if (dam) {
+		dam[0] = '\0';
+
+		/* Damage */
+		if (tval_is_ammo(obj) || tval_is_melee_weapon(obj))
+			strnfmt(dam, dam_len, "%dd%d", obj->dd, obj->ds);
+		else if (tval_is_armor(obj))
+			strnfmt(dam, dam_len, "%d", obj->ac);
+	}
 
 	object_delete(&known_obj);
 	object_delete(&obj);
 }
 
 
+/**
+ * A kind to list in the item spoilers, with what it is sorted by
+ */
+struct spoil_kind {
+	int k;
+	int order;
+	int lev;
+	s32b val;
+};
+
+/**
+ * Sort by cost and then level, keeping the order found otherwise
+ */
+static int cmp_spoil_kinds(const void *a, const void *b)
+{
+	const struct spoil_kind *ka = a, *kb = b;
+
+	if (ka->val != kb->val) return ka->val < kb->val ? -1 : 1;
+	if (ka->lev != kb->lev) return ka->lev < kb->lev ? -1 : 1;
+	return ka->order - kb->order;
+}
+
 /**
  * Create a spoiler file for items
  */
 static void spoil_obj_desc(const char *fname)
 {
-	int i, k, s, t, n = 0;
-	u16b who[200];
+	int i, k, s, n = 0;
+	struct spoil_kind who[200];
 	char buf[1024];
 	char wgt[80];
 	char dam[80];
@@ -227,28 +247,8 @@ static void spoil_obj_desc(const char *fname)
 	for (i = 0; true; i++) {
 		/* Write out the group title */
 		if (group_item[i].name) {
-			/* Hack -- bubble-sort by cost and then level */
-			for (s = 0; s < n - 1; s++) {
-				for (t = 0; t < n - 1; t++) {
-					int i1 = t;
-					int i2 = t + 1;
-
-					int e1;
-					int e2;
-
-					s32b t1;
-					s32b t2;
-
-					kind_info(NULL, 0, NULL, 0, NULL, 0, &e1, &t1, who[i1]);
-					kind_info(NULL, 0, NULL, 0, NULL, 0, &e2, &t2, who[i2]);
-
-					if ((t1 > t2) || ((t1 == t2) && (e1 > e2))) {
-						int tmp = who[i1];
-						who[i1] = who[i2];
-						who[i2] = tmp;
-					}
-				}
-			}
+			/* Sort by cost and then level, each worked out once */
+			sort(who, n, sizeof(*who), cmp_spoil_kinds);
 
 			/* Spoil each item */
 			for (s = 0; s < n; s++) {
@@ -257,7 +257,7 @@ static void spoil_obj_desc(const char *fname)
 
 				/* Describe the kind */
 				kind_info(buf, sizeof(buf), dam, sizeof(dam), wgt, sizeof(wgt),
-						  &e, &v, who[s]);
+						  &e, &v, who[s].k);
 
 				/* Dump it */
 				file_putf(fh, "  %-51s%7s%6s%4d%9ld\n", buf, dam, wgt, e,
@@ -284,8 +284,12 @@ static void spoil_obj_desc(const char *fname)
 			/* Hack -- Skip instant-artifacts */
 			if (kf_has(kind->kind_flags, KF_INSTA_ART)) continue;
 
-			/* Save the index */
-			who[n++] = k;
+			/* Save the index, and what it is sorted by */
+			assert(n < (int) N_ELEMENTS(who));
+			who[n].k = k;
+			who[n].order = n;
+			kind_info(NULL, 0, NULL, 0, NULL, 0, &who[n].lev, &who[n].val, k);
+			n++;
 		}
 	}
 
@@ -380,6 +384,7 @@ static void spoil_artifact(const char *fname)
 			struct artifact *art = &a_info[j];
 			char buf2[80];
 			char *temp;
+			struct file_mark temp_mark;
 			struct object *obj, *known_obj;
 
 			/* We only want objects in the current group */
@@ -408,13 +413,16 @@ static void spoil_artifact(const char *fname)
 			/* Temporarily blank the artifact flavour text - spoilers
 			   spoil the mechanics, not the atmosphere. */
 			temp = obj->artifact->text;
+			temp_mark = obj->artifact->text_mark;
 			obj->artifact->text = NULL;
+			obj->artifact->text_mark.path = NULL;
 
 			/* Write out the artifact description to the spoiler file */
 			object_info_spoil(fh, obj, 80);
 
 			/* Put back the flavour */
 			obj->artifact->text = temp;
+			obj->artifact->text_mark = temp_mark;
 
 			/*
 			 * Determine the minimum and maximum depths an
@@ -426,7 +434,8 @@ static void spoil_artifact(const char *fname)
 					 object_power(obj, false, NULL), (art->weight / 10),
 					 (art->weight % 10));
 
-			if (OPT(player, birth_randarts)) text_out("%s.\n", art->text);
+			if (OPT(player, birth_randarts))
+				text_out("%s.\n", artifact_text(art));
 
 			/* Terminate the entry */
 			spoiler_blanklines(2);
@@ -566,6 +575,117 @@ static void spoil_mon_desc(const char *fname)
 
 
 
+/**
+ * ------------------------------------------------------------------------
+ * Gear damage spoilers
+ * ------------------------------------------------------------------------ */
+#define GEAR_DAMAGE_MAX 8
+
+/**
+ * Create a spoiler file giving the average damage/turn of the character's
+ * melee weapons and ammunition for their launcher against every monster
+ */
+static void spoil_gear_damage(const char *fname)
+{
+	int i, j, n = 0, num = 0;
+
+	char buf[1024];
+	char o_name[80];
+
+	const struct object *gear[GEAR_DAMAGE_MAX];
+	struct object *obj;
+	int *damage;
+	u16b *who;
+
+	/* Find the weapons and ammunition */
+	for (obj = player->gear; obj && (num < GEAR_DAMAGE_MAX); obj = obj->next) {
+		if (tval_is_melee_weapon(obj) ||
+			(tval_is_ammo(obj) && (obj->tval == player->state.ammo_tval)))
+			gear[num++] = obj;
+	}
+	if (!num) {
+		msg("You have no weapons or ammunition.");
+		return;
+	}
+
+	/* Build the filename */
+	path_build(buf, sizeof(buf), ANGBAND_DIR_USER, fname);
+	fh = file_open(buf, MODE_WRITE, FTYPE_TEXT);
+
+	/* Oops */
+	if (!fh) {
+		msg("Cannot create spoiler file.");
+		return;
+	}
+
+	/* Dump the header */
+	file_putf(fh, "Gear Damage Spoilers for %s\n", buildid);
+	file_putf(fh, "------------------------------------------\n\n");
+	file_putf(fh, "Average damage/turn of %s against each monster:\n\n",
+			  player->full_name);
+	for (j = 0; j < num; j++) {
+		object_desc(o_name, sizeof(o_name), gear[j], ODESC_PREFIX | ODESC_FULL);
+		file_putf(fh, "%c) %s\n", I2A(j), o_name);
+	}
+	file_putf(fh, "\n%-40.40s%4s", "Name", "Lev");
+	for (j = 0; j < num; j++)
+		file_putf(fh, "%7c", I2A(j));
+	file_putf(fh, "\n%-40.40s%4s", "----", "---");
+	for (j = 0; j < num; j++)
+		file_putf(fh, "%7s", "-");
+	file_putf(fh, "\n");
+
+	/* Work out the whole table at once */
+	damage = mem_zalloc(num * z_info->r_max * sizeof(int));
+	obj_known_damage_races(gear, num, false, damage);
+
+	/* Allocate the "who" array */
+	who = mem_zalloc(z_info->r_max * sizeof(u16b));
+
+	/* Scan the monsters (except the ghost) */
+	for (i = 1; i < z_info->r_max - 1; i++) {
+		struct monster_race *race = &r_info[i];
+
+		/* Use that monster */
+		if (race->name) who[n++] = (u16b)i;
+	}
+
+	/* Sort the array by dungeon depth of monsters */
+	sort(who, n, sizeof(*who), cmp_monsters);
+
+	/* Scan again */
+	for (i = 0; i < n; i++) {
+		struct monster_race *race = &r_info[who[i]];
+
+		file_putf(fh, "%-40.40s%4d", race->name, race->level);
+		for (j = 0; j < num; j++) {
+			int dam = damage[j * z_info->r_max + who[i]];
+			file_putf(fh, "%5d.%d", dam / 10, dam % 10);
+		}
+		file_putf(fh, "\n");
+	}
+
+	/* End it */
+	file_putf(fh, "\n");
+
+	/* Free the arrays */
+	mem_free(who);
+	mem_free(damage);
+
+
+	/* Check for errors */
+	if (!file_close(fh)) {
+		msg("Cannot close spoiler file.");
+		return;
+	}
+
+	/* Worked */
+	msg("Successfully created a spoiler file.");
+}
+
+
+
+
 /**
  * ------------------------------------------------------------------------
  * Monster spoilers originally by: smchorse@ringer.cs.utsa.edu (Shawn McHorse)
@@ -681,6 +801,8 @@ static void spoiler_menu_act(const char *title, int row)
 		spoil_mon_desc("mon-desc.spo");
 	else if (row == 3)
 		spoil_mon_info("mon-info.spo");
+	else if (row == 4)
+		spoil_gear_damage("gear-dmg.spo");
 
 	event_signal(EVENT_MESSAGE_FLUSH);
 }
@@ -692,6 +814,7 @@ static menu_action spoil_actions[] =
 	{ 0, 0, "Brief Artifact Info (artifact.spo)",	spoiler_menu_act },
 	{ 0, 0, "Brief Monster Info (mon-desc.spo)",	spoiler_menu_act },
 	{ 0, 0, "Full Monster Info (mon-info.spo)",		spoiler_menu_act },
+	{ 0, 0, "Gear Damage vs. Monsters (gear-dmg.spo)",	spoiler_menu_act },
 };
 
 
@@ -19,6 +19,7 @@
 #include "cave.h"
 #include "cmds.h"
 #include "effects.h"
+#include "game-event.h"
 #include "game-input.h"
 #include "generate.h"
 #include "init.h"
@@ -31,6 +32,11 @@
 #include "object.h"
 #include "ui-command.h"
 #include "wizard.h"
+#include "z-queue.h"
+
+#ifdef USE_STATS
+#include <sys/wait.h>
+#endif
 
 /**
  * The stats programs here will provide information on the dungeon, the monsters
@@ -390,22 +396,182 @@ static double mon_total[MAX_LVL], mon_ood[MAX_LVL], mon_deadly[MAX_LVL];
 static double uniq_total[MAX_LVL], uniq_ood[MAX_LVL], uniq_deadly[MAX_LVL];
 
 
-/* set everything to 0.0 to begin */
-static void init_stat_vals()
+
+/*** Workers ***/
+
+/**
+ * A block of counters which each worker fills in for its own share of the
+ * simulations, and which the parent adds up when they have all finished
+ */
+struct stats_accum {
+	void *data;
+	size_t num;
+	bool is_double;
+};
+
+/* Every counter kept by the diving and clearing sims */
+static const struct stats_accum collect_accum[] = {
+	{ stat_all, ST_END * 3 * MAX_LVL, true },
+	{ stat_ff_all, ST_FF_END * TRIES_SIZE, false },
+	{ art_it, TRIES_SIZE, false },
+	{ gold_total, MAX_LVL, true },
+	{ gold_floor, MAX_LVL, true },
+	{ gold_mon, MAX_LVL, true },
+	{ art_total, MAX_LVL, true },
+	{ art_spec, MAX_LVL, true },
+	{ art_norm, MAX_LVL, true },
+	{ art_shal, MAX_LVL, true },
+	{ art_ave, MAX_LVL, true },
+	{ art_ood, MAX_LVL, true },
+	{ art_mon, MAX_LVL, true },
+	{ art_uniq, MAX_LVL, true },
+	{ art_floor, MAX_LVL, true },
+	{ art_vault, MAX_LVL, true },
+	{ art_mon_vault, MAX_LVL, true },
+	{ mon_total, MAX_LVL, true },
+	{ mon_ood, MAX_LVL, true },
+	{ mon_deadly, MAX_LVL, true },
+	{ uniq_total, MAX_LVL, true },
+	{ uniq_ood, MAX_LVL, true },
+	{ uniq_deadly, MAX_LVL, true },
+};
+
+/* Number of processes to split the simulations between; 0 until asked */
+static int stats_workers = 0;
+
+static size_t stats_accum_size(const struct stats_accum *acc)
 {
-	int i,j,k;
-
-	for (i = 0; i < ST_END;i++)
-		for (j = 0; j < 3; k = j++)
-			for (k = 0; k < MAX_LVL; k++)
-				stat_all[i][j][k] = 0.0;
-				
-	for (i = 1; i < TRIES_SIZE; i++)
-		art_it[i] = 0;
-	
-	for (i = 0; i < ST_FF_END; i++)
-		for (j = 0; j < TRIES_SIZE; j++)
-			stat_ff_all[i][j] = 0.0;
+	return acc->num * (acc->is_double ? sizeof(double) : sizeof(int));
+}
+
+static void stats_accum_clear(const struct stats_accum *acc, size_t n_acc)
+{
+	size_t i;
+
+	for (i = 0; i < n_acc; i++)
+		memset(acc[i].data, 0, stats_accum_size(&acc[i]));
+}
+
+static void stats_accum_add(const struct stats_accum *acc, const void *from)
+{
+	size_t i;
+
+	for (i = 0; i < acc->num; i++) {
+		if (acc->is_double)
+			((double *) acc->data)[i] += ((const double *) from)[i];
+		else
+			((int *) acc->data)[i] += ((const int *) from)[i];
+	}
+}
+
+/**
+ * Ask how many processes to use, defaulting to one per processor
+ */
+static bool stats_prompt_workers(void)
+{
+	char tmp_val[100];
+
+	if (!stats_workers) {
+		long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+		stats_workers = (cpus < 1) ? 1 : MIN(cpus, 64);
+	}
+
+	strnfmt(tmp_val, sizeof(tmp_val), "%d", stats_workers);
+	if (!get_string("Num of workers: ", tmp_val, 4)) return false;
+
+	stats_workers = MAX(atoi(tmp_val), 1);
+	return true;
+}
+
+/**
+ * Do simulations 0 to num - 1 by calling work() on a share of them in each
+ * of stats_workers child processes, each with its own random stream split
+ * off from the main one.  The counters in acc should be cleared beforehand;
+ * afterwards they hold the totals from all the workers.
+ *
+ * Level generation works on the global cave, player and RNG, so the workers
+ * are separate processes rather than threads.  They never come back to the
+ * UI, so they drop the event handlers and leave through _exit().
+ */
+static bool stats_run_workers(int num, void (*work)(int first, int count,
+		void *data), void *data, const struct stats_accum *acc, size_t n_acc)
+{
+	int workers = MIN(stats_workers, num);
+	pid_t *pids;
+	FILE **pipes;
+	size_t i, buf_size = 0;
+	char *buf;
+	bool ok = true;
+	int w, first = 0;
+
+	if (workers <= 1) {
+		work(0, num, data);
+		return true;
+	}
+
+	pids = mem_zalloc(workers * sizeof(pid_t));
+	pipes = mem_zalloc(workers * sizeof(FILE *));
+	for (i = 0; i < n_acc; i++)
+		buf_size = MAX(buf_size, stats_accum_size(&acc[i]));
+	buf = mem_alloc(buf_size);
+
+	fflush(stdout);
+	for (w = 0; w < workers; w++) {
+		int share = num / workers + (w < num % workers);
+		int fd[2];
+
+		if (pipe(fd)) quit("Couldn't create a pipe for a worker!");
+		pids[w] = fork();
+		if (pids[w] < 0) quit("Couldn't start a worker!");
+
+		if (pids[w] == 0) {
+			/* Worker: do the simulations and send back the counters */
+			struct rng_state parent = Rand_default;
+			FILE *fp;
+
+			close(fd[0]);
+			event_remove_all_handlers();
+			Rand_split(&parent, w, &Rand_default);
+			work(first, share, data);
+
+			fp = fdopen(fd[1], "wb");
+			if (!fp) _exit(1);
+			for (i = 0; i < n_acc; i++)
+				if (fwrite(acc[i].data, stats_accum_size(&acc[i]), 1, fp) != 1)
+					_exit(1);
+			_exit(fclose(fp) ? 1 : 0);
+		}
+
+		close(fd[1]);
+		pipes[w] = fdopen(fd[0], "rb");
+		if (!pipes[w]) quit("Couldn't read from a worker!");
+		first += share;
+	}
+
+	/* Collect the results */
+	for (w = 0; w < workers; w++) {
+		int status;
+
+		for (i = 0; i < n_acc; i++) {
+			if (fread(buf, stats_accum_size(&acc[i]), 1, pipes[w]) != 1) {
+				ok = false;
+				break;
+			}
+			stats_accum_add(&acc[i], buf);
+		}
+		fclose(pipes[w]);
+
+		if (waitpid(pids[w], &status, 0) != pids[w] || !WIFEXITED(status) ||
+			WEXITSTATUS(status))
+			ok = false;
+	}
+
+	mem_free(buf);
+	mem_free(pipes);
+	mem_free(pids);
+
+	if (!ok) msg("Error - a stats worker failed; results are incomplete.");
+	return ok;
 }
 
 /*
@@ -1488,10 +1654,10 @@ static void revive_uniques(void)
 }
 
 /**
- * This function loops through the level and does N iterations of
- * the stat calling function, assuming diving style.
- */ 
-static void diving_stats(void)
+ * Do iterations first to first + count - 1 of the stat calling function at
+ * every fifth level, assuming diving style.
+ */
+static void diving_stats_aux(int first, int count, void *data)
 {
 	int depth;
 
@@ -1501,27 +1667,41 @@ static void diving_stats(void)
 		if (player->depth == 0) player->depth = 1;
 
 		/* Do many iterations of each level */
-		for (iter = 0; iter < tries; iter++)
+		for (iter = first; iter < first + count; iter++)
 		     stats_collect_level();
-
-		/* Print the output to the file */
-		print_stats(depth);
-
-		/* Show the level to check on status */
-		do_cmd_redraw();
 	}
 }
 
 /**
  * This function loops through the level and does N iterations of
- * the stat calling function, assuming clearing style.
+ * the stat calling function, assuming diving style.
  */ 
-static void clearing_stats(void)
+static void diving_stats(void)
+{
+	int depth;
+
+	/* Split the iterations between the workers */
+	stats_run_workers(tries, diving_stats_aux, NULL, collect_accum,
+					  N_ELEMENTS(collect_accum));
+
+	/* Print the output to the file */
+	for (depth = 0; depth < MAX_LVL; depth += 5)
+		print_stats(depth);
+
+	/* Show the level to check on status */
+	do_cmd_redraw();
+}
+
+/**
+ * Do iterations first to first + count - 1 of the whole game, assuming
+ * clearing style.
+ */
+static void clearing_stats_aux(int first, int count, void *data)
 {
 	int depth;
 
 	/* Do many iterations of the game */
-	for (iter = 0; iter < tries; iter++) {
+	for (iter = first; iter < first + count; iter++) {
 		/* Move all artifacts to uncreated */
 		uncreate_artifacts();
 
@@ -1554,6 +1734,19 @@ static void clearing_stats(void)
 
 		msg("Iteration %d complete",iter);
 	}
+}
+
+/**
+ * This function loops through the level and does N iterations of
+ * the stat calling function, assuming clearing style.
+ */ 
+static void clearing_stats(void)
+{
+	int depth;
+
+	/* Split the iterations between the workers */
+	stats_run_workers(tries, clearing_stats_aux, NULL, collect_accum,
+					  N_ELEMENTS(collect_accum));
 
 	/* Print to file */
 	for (depth = 0 ;depth < MAX_LVL; depth++)
@@ -1640,6 +1833,9 @@ void stats_collect(void)
 	if (!((simtype == 1) || (simtype == 2)))
 		return; 
 
+	/* Ask how many processes to split the work between */
+	if (!stats_prompt_workers()) return;
+
 	/* Are we in diving or clearing mode */
 	if (simtype == 2)
 		clearing = true;
@@ -1676,7 +1872,7 @@ void stats_collect(void)
 	print_heading();
 
 	/* Make sure all stats are 0 */
-	init_stat_vals();
+	stats_accum_clear(collect_accum, N_ELEMENTS(collect_accum));
 
 	/* Select diving option */
 	if (!clearing) diving_stats();
@@ -1694,84 +1890,81 @@ void stats_collect(void)
 	}
 }
 
-#define DIST_MAX 10000
-
+/**
+ * Fill cave_dist with the walking distance of each grid from the player,
+ * leaving grids that can't be reached untouched.
+ */
 void calc_cave_distances(int **cave_dist)
 {
-	int dist, i;
-	int oy, ox, ty, tx, d;
-
-	/* Squares with distance from player of n - 1 */
-	int d_x_old[DIST_MAX];
-	int d_y_old[DIST_MAX];
-	int d_old_max;
-
-	/* Squares with distance from player of n */
-	int d_x_new[DIST_MAX];
-	int d_y_new[DIST_MAX];
-	int d_new_max;
-
-	/* Get player location */
-	oy = d_y_old[0] = player->grid.y;
-	ox = d_x_old[0] = player->grid.x;
-	d_old_max = 1;
+	struct queue *queue = q_new(cave->width * 4);
+	struct loc grid = player->grid;
+	int d;
 
 	/* Distance from player starts at 0 */
-	dist = 0;
+	cave_dist[grid.y][grid.x] = 0;
+	q_push_int(queue, grid_to_i(grid, cave->width));
 
-	/* Assign the distance value to the first square (player) */
-	cave_dist[oy][ox] = dist;
+	/* Breadth first, so each grid is reached first by a shortest walk */
+	while (q_len(queue) > 0) {
+		i_to_grid(q_pop_int(queue), cave->width, &grid);
 
-	do {
-		d_new_max = 0;
-		dist++;
+		/* Get all adjacent squares */
+		for (d = 0; d < 8; d++) {
+			struct loc adj = loc_sum(grid, ddgrid_ddd[d]);
 
-		/* Loop over all visited squares of the previous iteration */
-		for (i = 0; i < d_old_max; i++){
+			if (!(square_in_bounds_fully(cave, adj))) continue;
 
-			/* Get the square we want to look at */
-			oy = d_y_old[i];
-			ox = d_x_old[i];
+			/* Have we been here before? */
+			if (cave_dist[adj.y][adj.x] >= 0) continue;
 
-			/* debug
-			msg("x: %d y: %d dist: %d %d ",ox,oy,dist-1,i); */
+			/* Is it a wall? */
+			if (square_iswall(cave, adj)) continue;
 
-			/* Get all adjacent squares */
-			for (d = 0; d < 8; d++) {
-				/* Adjacent square location */
-				ty = oy + ddy_ddd[d];
-				tx = ox + ddx_ddd[d];
+			/* Assign the distance to that spot */
+			cave_dist[adj.y][adj.x] = cave_dist[grid.y][grid.x] + 1;
+			q_push_int(queue, grid_to_i(adj, cave->width));
+		}
+	}
 
-				if (!(square_in_bounds_fully(cave, loc(tx, ty)))) continue;
+	q_free(queue);
+}
 
-				/* Have we been here before? */
-				if (cave_dist[ty][tx] >= 0) continue;
+/**
+ * Settings and counts for a pit stats run
+ */
+struct pit_sim {
+	int type;
+	int depth;
+	int *hist;
+};
 
-				/* Is it a wall? */
-				if (square_iswall(cave, loc(tx, ty))) continue;
+static void pit_stats_aux(int first, int count, void *data)
+{
+	struct pit_sim *sim = data;
+	int j;
 
-				/* Add the new location */
-				d_y_new[d_new_max] = ty;
-				d_x_new[d_new_max] = tx;
+	for (j = 0; j < count; j++) {
+		int i;
+		int pit_idx = 0;
+		int pit_dist = 999;
 
-				/* Assign the distance to that spot */
-				cave_dist[ty][tx] = dist;
+		for (i = 0; i < z_info->pit_max; i++) {
+			int offset, dist;
+			struct pit_profile *pit = &pit_info[i];
 
-				d_new_max++;
+			if (!pit->name || pit->room_type != sim->type) continue;
 
-				/* debug
-				msg("x: %d y: %d dist: %d ",tx,ty,dist); */
-			}
-		}
+			offset = Rand_normal(pit->ave, 10);
+			dist = ABS(offset - sim->depth);
 
-		/* Copy the new distance list to the old one */
-		for (i = 0; i < d_new_max; i++) {
-			d_y_old[i] = d_y_new[i];
-			d_x_old[i] = d_x_new[i];
+			if (dist < pit_dist && one_in_(pit->rarity)) {
+				pit_idx = i;
+				pit_dist = dist;
+			}
 		}
-		d_old_max = d_new_max;
 
-	} while ((d_old_max > 0) || dist == DIST_MAX);
+		sim->hist[pit_idx]++;
+	}
 }
 
 void pit_stats(void)
@@ -1779,8 +1972,10 @@ void pit_stats(void)
 	int tries = 1000;
 	int depth = 0;
 	int hist[z_info->pit_max];
-	int j, p;
+	int p;
 	int type = 1;
+	struct pit_sim sim;
+	struct stats_accum acc = { hist, z_info->pit_max, false };
 
 	char tmp_val[100];
 
@@ -1818,28 +2013,13 @@ void pit_stats(void)
 	depth = atoi(tmp_val);
 	if (depth < 1) depth = 1;
 
-	for (j = 0; j < tries; j++) {
-		int i;
-		int pit_idx = 0;
-		int pit_dist = 999;
-
-		for (i = 0; i < z_info->pit_max; i++) {
-			int offset, dist;
-			struct pit_profile *pit = &pit_info[i];
-
-			if (!pit->name || pit->room_type != type) continue;
+	/* Ask how many processes to split the work between */
+	if (!stats_prompt_workers()) return;
 
-			offset = Rand_normal(pit->ave, 10);
-			dist = ABS(offset - depth);
-
-			if (dist < pit_dist && one_in_(pit->rarity)) {
-				pit_idx = i;
-				pit_dist = dist;
-			}
-		}
-
-		hist[pit_idx]++;
-	}
+	sim.type = type;
+	sim.depth = depth;
+	sim.hist = hist;
+	stats_run_workers(tries, pit_stats_aux, &sim, &acc, 1);
 
 	for (p = 0; p < z_info->pit_max; p++) {
 		struct pit_profile *pit = &pit_info[p];
@@ -1851,11 +2031,10 @@ void pit_stats(void)
 }
 
 
-/**
- * Gather whether the dungeon has disconnects in it and whether the player
- * is disconnected from the stairs
- */
-void disconnect_stats(void)
+/* Levels with disconnected areas, and levels isolated from the stairs */
+static int dsc_counts[2];
+
+static void disconnect_stats_aux(int first, int count, void *data)
 {
 	int i, y, x;
 
@@ -1863,32 +2042,7 @@ void disconnect_stats(void)
 
 	bool has_dsc, has_dsc_from_stairs;
 
-	static int temp;
-	static char tmp_val[100];
-	static char prompt[50];
-
-	long dsc_area = 0, dsc_from_stairs = 0;
-
-	/* This is the prompt for no. of tries */
-	strnfmt(prompt, sizeof(prompt), "Num of simulations: ");
-
-	/* This is the default value (50) */
-	strnfmt(tmp_val, sizeof(tmp_val), "%d", tries);
-
-	/* Ask for the input */
-	if (!get_string(prompt,tmp_val,7)) return;
-
-	/* Get the new value */
-	temp = atoi(tmp_val);
-
-	/* Try at least once */
-	if (temp < 1)
-		temp = 1;
-
-	/* Save */
-	tries = temp;
-
-	for (i = 1; i <= tries; i++) {
+	for (i = first + 1; i <= first + count; i++) {
 		/* Assume no disconnected areas */
 		has_dsc = false;
 
@@ -1941,20 +2095,58 @@ void disconnect_stats(void)
 			}
 		}
 
-		if (has_dsc_from_stairs) dsc_from_stairs++;
+		if (has_dsc_from_stairs) dsc_counts[1]++;
 
-		if (has_dsc) dsc_area++;
+		if (has_dsc) dsc_counts[0]++;
 
 		msg("Iteration: %d",i); 
 
 		/* Free arrays */
-		for (y = 0; x < cave->height; x++)
+		for (y = 0; y < cave->height; y++)
 			mem_free(cave_dist[y]);
 		mem_free(cave_dist);
 	}
+}
+
+/**
+ * Gather whether the dungeon has disconnects in it and whether the player
+ * is disconnected from the stairs
+ */
+void disconnect_stats(void)
+{
+	static int temp;
+	static char tmp_val[100];
+	static char prompt[50];
+
+	struct stats_accum acc = { dsc_counts, N_ELEMENTS(dsc_counts), false };
+
+	/* This is the prompt for no. of tries */
+	strnfmt(prompt, sizeof(prompt), "Num of simulations: ");
+
+	/* This is the default value (50) */
+	strnfmt(tmp_val, sizeof(tmp_val), "%d", tries);
+
+	/* Ask for the input */
+	if (!get_string(prompt,tmp_val,7)) return;
+
+	/* Get the new value */
+	temp = atoi(tmp_val);
+
+	/* Try at least once */
+	if (temp < 1)
+		temp = 1;
+
+	/* Save */
+	tries = temp;
+
+	/* Ask how many processes to split the work between */
+	if (!stats_prompt_workers()) return;
+
+	stats_accum_clear(&acc, 1);
+	stats_run_workers(tries, disconnect_stats_aux, NULL, &acc, 1);
 
-	msg("Total levels with disconnected areas: %ld",dsc_area);
-	msg("Total levels isolated from stairs: %ld",dsc_from_stairs);
+	msg("Total levels with disconnected areas: %d", dsc_counts[0]);
+	msg("Total levels isolated from stairs: %d", dsc_counts[1]);
 
 	/* Redraw the level */
 	do_cmd_redraw();
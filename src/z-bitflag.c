@@ -19,47 +19,6 @@
 #include "z-bitflag.h"
 
 
-/**
- * Tests if a flag is "on" in a bitflag set.
- *
- * true is returned when `flag` is on in `flags`, and false otherwise.
- * The flagset size is supplied in `size`.
- */
-bool flag_has(const bitflag *flags, const size_t size, const int flag)
-{
-	const size_t flag_offset = FLAG_OFFSET(flag);
-	const int flag_binary = FLAG_BINARY(flag);
-
-	if (flag == FLAG_END) return false;
-
-	assert(flag_offset < size);
-
-	if (flags[flag_offset] & flag_binary) return true;
-
-	return false;
-}
-
-bool flag_has_dbg(const bitflag *flags, const size_t size, const int flag,
-				  const char *fi, const char *fl)
-{
-	const size_t flag_offset = FLAG_OFFSET(flag);
-	const int flag_binary = FLAG_BINARY(flag);
-
-	if (flag == FLAG_END) return false;
-
-	if (flag_offset >= size) {
-		quit_fmt("Error in flag_has(%s, %s): FlagID[%d] Size[%u] FlagOff[%u] FlagBV[%d]\n",
-		         fi, fl, flag, (unsigned int) size, (unsigned int) flag_offset, flag_binary);
-	}
-
-	assert(flag_offset < size);
-
-	if (flags[flag_offset] & flag_binary) return true;
-
-	return false;
-}
-
-
 /**
  * Iterates over the flags which are "on" in a bitflag set.
  *
@@ -91,14 +50,16 @@ int flag_next(const bitflag *flags, const size_t size, const int flag)
  */
 int flag_count(const bitflag *flags, const size_t size)
 {
-	size_t i, j;
+	size_t i;
 	int count = 0;
 
 	for (i = 0; i < size; i++) {
-		for (j = 0; j < FLAG_WIDTH; j++) {
-			if (flags[i] & FLAG_BINARY(j)) {
-				count++;
-			}
+		bitflag f = flags[i];
+
+		/* Clear the lowest set bit until none are left */
+		while (f) {
+			f &= f - 1;
+			count++;
 		}
 	}
 
@@ -189,70 +150,6 @@ bool flag_is_equal(const bitflag *flags1, const bitflag *flags2,
 }
 
 
-/**
- * Sets one bitflag in a bitfield.
- *
- * The bitflag identified by `flag` is set in `flags`. The bitfield size is
- * supplied in `size`.  true is returned when changes were made, false
- * otherwise.
- */
-bool flag_on(bitflag *flags, const size_t size, const int flag)
-{
-	const size_t flag_offset = FLAG_OFFSET(flag);
-	const int flag_binary = FLAG_BINARY(flag);
-
-	assert(flag_offset < size);
-
-	if (flags[flag_offset] & flag_binary) return false;
-
-	flags[flag_offset] |= flag_binary;
-
-	return true;
-}
-
-bool flag_on_dbg(bitflag *flags, const size_t size, const int flag,
-				 const char *fi, const char *fl)
-{
-	const size_t flag_offset = FLAG_OFFSET(flag);
-	const int flag_binary = FLAG_BINARY(flag);
-
-	if (flag_offset >= size) {
-		quit_fmt("Error in flag_on(%s, %s): FlagID[%d] Size[%u] FlagOff[%u] FlagBV[%d]\n",
-		         fi, fl, flag, (unsigned int) size, (unsigned int) flag_offset, flag_binary);
-	}
-
-	assert(flag_offset < size);
-
-	if (flags[flag_offset] & flag_binary) return false;
-
-	flags[flag_offset] |= flag_binary;
-
-	return true;
-}
-
-
-/**
- * Clears one flag in a bitfield.
- *
- * The bitflag identified by `flag` is cleared in `flags`. The bitfield size
- * is supplied in `size`.  true is returned when changes were made, false
- * otherwise.
- */
-bool flag_off(bitflag *flags, const size_t size, const int flag)
-{
-	const size_t flag_offset = FLAG_OFFSET(flag);
-	const int flag_binary = FLAG_BINARY(flag);
-
-	assert(flag_offset < size);
-
-	if (!(flags[flag_offset] & flag_binary)) return false;
-
-	flags[flag_offset] &= ~flag_binary;
-
-	return true;
-}
-
-
 /**
  * Clears all flags in a bitfield.
  *
@@ -497,6 +497,18 @@ bool dice_parse_string(dice_t *dice, const char *string)
 	return true;
 }
 
+/**
+ * Evaluate the expression bound to a variable, or 0 if there isn't one.
+ */
+static int dice_expression_value(const dice_t *dice, int index)
+{
+	if (dice->expressions == NULL || index < 0 ||
+		dice->expressions[index].expression == NULL)
+		return 0;
+
+	return expression_evaluate(dice->expressions[index].expression);
+}
+
 /**
  * Extract a random_value by evaluating any bound expressions.
  *
@@ -508,41 +520,19 @@ void dice_random_value(dice_t *dice, random_value *v)
 	if (v == NULL)
 		return;
 
-	if (dice->ex_b) {
-		if (dice->expressions != NULL && dice->expressions[dice->b].expression != NULL)
-			v->base = expression_evaluate(dice->expressions[dice->b].expression);
-		else
-			v->base = 0;
-	}
-	else
+	/* Plain numbers need no lookups */
+	if (!dice->ex_b && !dice->ex_x && !dice->ex_y && !dice->ex_m) {
 		v->base = dice->b;
-
-	if (dice->ex_x) {
-		if (dice->expressions != NULL && dice->expressions[dice->x].expression != NULL)
-			v->dice = expression_evaluate(dice->expressions[dice->x].expression);
-		else
-			v->dice = 0;
-	}
-	else
 		v->dice = dice->x;
-
-	if (dice->ex_y) {
-		if (dice->expressions != NULL && dice->expressions[dice->y].expression != NULL)
-			v->sides = expression_evaluate(dice->expressions[dice->y].expression);
-		else
-			v->sides = 0;
-	}
-	else
 		v->sides = dice->y;
-
-	if (dice->ex_m) {
-		if (dice->expressions != NULL && dice->expressions[dice->m].expression != NULL)
-			v->m_bonus = expression_evaluate(dice->expressions[dice->m].expression);
-		else
-			v->m_bonus = 0;
-	}
-	else
 		v->m_bonus = dice->m;
+		return;
+	}
+
+	v->base = dice->ex_b ? dice_expression_value(dice, dice->b) : dice->b;
+	v->dice = dice->ex_x ? dice_expression_value(dice, dice->x) : dice->x;
+	v->sides = dice->ex_y ? dice_expression_value(dice, dice->y) : dice->y;
+	v->m_bonus = dice->ex_m ? dice_expression_value(dice, dice->m) : dice->m;
 }
 
 /**
@@ -263,8 +263,18 @@ struct ang_file
 	FILE *fh;
 	char *fname;
 	file_mode mode;
+
+	/* Read-ahead for files opened with MODE_READ */
+	char *buf;
+	size_t buf_pos;
+	size_t buf_len;
 };
 
+/**
+ * Size of the read-ahead buffer; most pref and help files fit in one fill
+ */
+#define FILE_BUF_SIZE 16384
+
 
 
 /** Utility functions **/
@@ -415,6 +425,8 @@ ang_file *file_open(const char *fname, file_mode mode, file_type ftype)
 
 	f->fname = string_make(buf);
 	f->mode = mode;
+	if (mode == MODE_READ)
+		f->buf = mem_alloc(FILE_BUF_SIZE);
 
 	if (mode != MODE_READ && file_open_hook)
 		file_open_hook(buf, ftype);
@@ -431,12 +443,22 @@ bool file_close(ang_file *f)
 	if (fclose(f->fh) != 0)
 		return false;
 
+	mem_free(f->buf);
 	mem_free(f->fname);
 	mem_free(f);
 
 	return true;
 }
 
+/**
+ * Flush file handle 'f'; unlike file_close(), this allocates and frees
+ * nothing, so it can be used away from the game thread.
+ */
+bool file_flush(ang_file *f)
+{
+	return fflush(f->fh) == 0;
+}
+
 
 
 /** Locking functions **/
@@ -476,12 +498,60 @@ void file_unlock(ang_file *f)
 
 /** Byte-based IO and functions **/
 
+/**
+ * Refill the read-ahead buffer of 'f' once it has all been used, returning
+ * false at the end of the file.
+ */
+static bool file_fill(ang_file *f)
+{
+	if (f->buf_pos < f->buf_len)
+		return true;
+
+	f->buf_pos = 0;
+	f->buf_len = fread(f->buf, 1, FILE_BUF_SIZE, f->fh);
+	return f->buf_len > 0;
+}
+
+/**
+ * Read the next byte from 'f', or EOF at the end of the file.
+ */
+static int file_getc(ang_file *f)
+{
+	if (!f->buf)
+		return fgetc(f->fh);
+	if (!file_fill(f))
+		return EOF;
+	return (byte)f->buf[f->buf_pos++];
+}
+
 /**
  * Seek to location 'pos' in file 'f'.
  */
 bool file_skip(ang_file *f, int bytes)
 {
-	return (fseek(f->fh, bytes, SEEK_CUR) == 0);
+	long ahead = 0;
+
+	/* Whatever was read ahead past the current place is given back */
+	if (f->buf) {
+		ahead = (long)(f->buf_len - f->buf_pos);
+		f->buf_pos = f->buf_len = 0;
+	}
+
+	return (fseek(f->fh, bytes - ahead, SEEK_CUR) == 0);
+}
+
+/**
+ * Get the current position in file 'f'.
+ */
+long file_tell(ang_file *f)
+{
+	long pos = ftell(f->fh);
+
+	/* Whatever was read ahead hasn't been reached yet */
+	if (f->buf && pos >= 0)
+		pos -= (long)(f->buf_len - f->buf_pos);
+
+	return pos;
 }
 
 /**
@@ -489,7 +559,7 @@ bool file_skip(ang_file *f, int bytes)
  */
 bool file_readc(ang_file *f, byte *b)
 {
-	int i = fgetc(f->fh);
+	int i = file_getc(f);
 
 	if (i == EOF)
 		return false;
@@ -511,7 +581,18 @@ bool file_writec(ang_file *f, byte b)
  */
 int file_read(ang_file *f, char *buf, size_t n)
 {
-	size_t read = fread(buf, 1, n, f->fh);
+	size_t read = 0;
+
+	/* Use up anything read ahead first */
+	if (f->buf && f->buf_pos < f->buf_len) {
+		read = MIN(n, f->buf_len - f->buf_pos);
+		memcpy(buf, f->buf + f->buf_pos, read);
+		f->buf_pos += read;
+		if (read == n)
+			return read;
+	}
+
+	read += fread(buf + read, 1, n - read, f->fh);
 
 	if (read == 0 && ferror(f->fh))
 		return -1;
@@ -532,37 +613,40 @@ bool file_write(ang_file *f, const char *buf, size_t n)
 /**
  * Read a line of text from file 'f' into buffer 'buf' of size 'n' bytes.
  *
- * Support both \r\n and \n as line endings, but not the outdated \r that used
- * to be used on Macs.  Replace non-printables with '?', and \ts with ' '.
+ * Support \r\n, \n and a lone \r as line endings.  Expand \ts to spaces.
+ *
+ * Files opened for reading are read ahead a buffer at a time, and lines are
+ * copied out of that, so this costs no more than a pass over the text.
  */
 #define TAB_COLUMNS 4
 
 bool file_getl(ang_file *f, char *buf, size_t len)
 {
 	bool seen_cr = false;
-	byte b;
 	size_t i = 0;
 
 	/* Leave a byte for the terminating 0 */
 	size_t max_len = len - 1;
 
 	while (i < max_len) {
-		char c;
+		int c = file_getc(f);
 
-		if (!file_readc(f, &b)) {
+		if (c == EOF) {
 			buf[i] = '\0';
 			return (i == 0) ? false : true;
 		}
 
-		c = (char) b;
-
 		if (c == '\r') {
 			seen_cr = true;
 			continue;
 		}
 
 		if (seen_cr && c != '\n') {
-			fseek(f->fh, -1, SEEK_CUR);
+			/* Leave this character for the next line */
+			if (f->buf)
+				f->buf_pos--;
+			else
+				fseek(f->fh, -1, SEEK_CUR);
 			buf[i] = '\0';
 			return true;
 		}
@@ -585,7 +669,7 @@ bool file_getl(ang_file *f, char *buf, size_t len)
 			continue;
 		}
 
-		buf[i++] = c;
+		buf[i++] = (char)c;
 	}
 
 	buf[i] = '\0';
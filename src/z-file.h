@@ -83,6 +83,15 @@ size_t path_filename_index( const char *path );
  */
 typedef struct ang_file ang_file;
 
+/**
+ * A place in a file that something can be read back from later; `path` is
+ * NULL when there is nothing to read.
+ */
+struct file_mark {
+	const char *path;
+	long offset;
+};
+
 /**
  * Specifies what kind of access is required to a file.  See file_open().
  */
@@ -165,6 +174,13 @@ extern void (*file_open_hook)(const char *path, file_type ftype);
  */
 bool file_close(ang_file *f);
 
+/**
+ * Attempt to push anything buffered for `f` out to the operating system.
+ *
+ * Returns true if successful, false otherwise.
+ */
+bool file_flush(ang_file *f);
+
 
 /** File locking **/
 
@@ -213,6 +229,11 @@ bool file_vputf(ang_file *f, const char *fmt, va_list vp);
  */
 bool file_skip(ang_file *f, int bytes);
 
+/**
+ * Get the current position in file 'f', as a byte offset from its start.
+ */
+long file_tell(ang_file *f);
+
 /**
  * Reads n bytes from file 'f' into buffer 'buf'.
  * \returns Number of bytes read; -1 on error
@@ -0,0 +1,139 @@
+/**
+ * \file z-names.c
+ * \brief Hash tables finding things by name
+ *
+ * Copyright (c) 2026 The Angband Developers
+ *
+ * This work is free software; you can redistribute it and/or modify it
+ * under the terms of either:
+ *
+ * a) the GNU General Public License as published by the Free Software
+ *    Foundation, version 2, or
+ *
+ * b) the "Angband licence":
+ *    This software may be copied and distributed for educational, research,
+ *    and not for profit purposes provided that this copyright and statement
+ *    are included in all such copies.  Other copyrights may also apply.
+ */
+#include "z-names.h"
+#include "z-util.h"
+#include "z-virt.h"
+
+struct name_entry {
+	char *name;
+	u32b hash;
+	int key;
+	int idx;
+};
+
+/**
+ * Open-addressed, with a NULL name for an empty slot; always a power of two
+ * in size and at most half full
+ */
+struct name_table {
+	struct name_entry *entries;
+	size_t mask;
+	size_t count;
+	bool fold_case;
+};
+
+/**
+ * djb2_hash() of the name, lower case if case is ignored, mixed with the key
+ */
+static u32b name_hash(const struct name_table *t, const char *name, int key)
+{
+	u32b hash = 5381;
+	int c;
+
+	while ((c = (unsigned char) *name++))
+		hash = ((hash << 5) + hash) + (t->fold_case ? tolower(c) : c);
+
+	return hash ^ ((u32b) key * 2654435761u);
+}
+
+/**
+ * Find the entry for `name` and `key`, which is either where it is or the
+ * empty slot it would go in
+ */
+static struct name_entry *name_slot(const struct name_table *t,
+									const char *name, u32b hash, int key)
+{
+	size_t i = hash & t->mask;
+
+	while (t->entries[i].name) {
+		struct name_entry *e = &t->entries[i];
+
+		if (e->hash == hash && e->key == key &&
+			(t->fold_case ? !my_stricmp(e->name, name) : streq(e->name, name)))
+			break;
+		i = (i + 1) & t->mask;
+	}
+	return &t->entries[i];
+}
+
+/**
+ * Make the table `size` slots, moving what is in it
+ */
+static void name_table_resize(struct name_table *t, size_t size)
+{
+	struct name_entry *old = t->entries;
+	size_t i, old_size = old ? t->mask + 1 : 0;
+
+	t->entries = mem_zalloc(size * sizeof(*t->entries));
+	t->mask = size - 1;
+	for (i = 0; i < old_size; i++) {
+		if (old[i].name)
+			*name_slot(t, old[i].name, old[i].hash, old[i].key) = old[i];
+	}
+	mem_free(old);
+}
+
+struct name_table *name_table_new(size_t n, bool fold_case)
+{
+	struct name_table *t = mem_zalloc(sizeof(*t));
+	size_t size = 16;
+
+	while (size < 2 * n)
+		size <<= 1;
+	t->fold_case = fold_case;
+	name_table_resize(t, size);
+	return t;
+}
+
+void name_table_add(struct name_table *t, const char *name, int key, int idx)
+{
+	u32b hash = name_hash(t, name, key);
+	struct name_entry *e = name_slot(t, name, hash, key);
+
+	if (e->name) return;
+
+	/* Growing moves everything, so look again */
+	if (2 * (t->count + 1) > t->mask + 1) {
+		name_table_resize(t, 2 * (t->mask + 1));
+		e = name_slot(t, name, hash, key);
+	}
+
+	t->count++;
+	e->name = string_make(name);
+	e->hash = hash;
+	e->key = key;
+	e->idx = idx;
+}
+
+int name_table_find(const struct name_table *t, const char *name, int key)
+{
+	struct name_entry *e = name_slot(t, name, name_hash(t, name, key), key);
+
+	return e->name ? e->idx : -1;
+}
+
+void name_table_free(struct name_table *t)
+{
+	size_t i;
+
+	if (!t) return;
+	for (i = 0; i <= t->mask; i++)
+		string_free(t->entries[i].name);
+	mem_free(t->entries);
+	mem_free(t);
+}
@@ -0,0 +1,54 @@
+/**
+ * \file z-names.h
+ * \brief Hash tables finding things by name
+ *
+ * Copyright (c) 2026 The Angband Developers
+ *
+ * This work is free software; you can redistribute it and/or modify it
+ * under the terms of either:
+ *
+ * a) the GNU General Public License as published by the Free Software
+ *    Foundation, version 2, or
+ *
+ * b) the "Angband licence":
+ *    This software may be copied and distributed for educational, research,
+ *    and not for profit purposes provided that this copyright and statement
+ *    are included in all such copies.  Other copyrights may also apply.
+ */
+
+#ifndef INCLUDED_Z_NAMES_H
+#define INCLUDED_Z_NAMES_H
+
+#include "h-basic.h"
+
+/**
+ * A table from names to indices, for finding entries of the game data
+ * arrays without a walk through them.  Each name goes with a key, such as
+ * a tval, so the same name can be found for different keys.  Indices rather
+ * than pointers are kept since the arrays may be reallocated as they grow.
+ */
+struct name_table;
+
+/**
+ * Make a table expecting about `n` names, compared ignoring case if
+ * `fold_case` is set
+ */
+struct name_table *name_table_new(size_t n, bool fold_case);
+
+/**
+ * Add `idx` under `name` and `key`; if there is already an index there,
+ * the first one added stays, as it would be found first by a walk
+ */
+void name_table_add(struct name_table *t, const char *name, int key, int idx);
+
+/**
+ * Find the index added under `name` and `key`, or -1
+ */
+int name_table_find(const struct name_table *t, const char *name, int key);
+
+/**
+ * Free a table
+ */
+void name_table_free(struct name_table *t);
+
+#endif /* !INCLUDED_Z_NAMES_H */
@@ -19,34 +19,92 @@
  */
 #include "z-virt.h"
 #include "z-quark.h"
+#include "z-util.h"
 #include "init.h"
 
 static char **quarks;
 static size_t nr_quarks = 1;
 static size_t alloc_quarks = 0;
 
+/**
+ * Open-addressed hash table of quark indices, with zero for an empty slot;
+ * always a power of two in size and at most half full
+ */
+static quark_t *quark_table;
+static size_t quark_table_size = 0;
+
 #define QUARKS_INIT	16
 
-quark_t quark_add(const char *str)
+/**
+ * Find the slot in the hash table holding `str`, or the empty slot where
+ * it belongs
+ */
+static size_t quark_slot(const char *str)
 {
-	quark_t q;
+	size_t mask = quark_table_size - 1;
+	size_t i = djb2_hash(str) & mask;
 
-	for (q = 1; q < nr_quarks; q++) {
-		if (!strcmp(quarks[q], str))
-			return q;
-	}
+	while (quark_table[i] && strcmp(quarks[quark_table[i]], str))
+		i = (i + 1) & mask;
+
+	return i;
+}
+
+/**
+ * Make room in the quark array and hash table for `n` more quarks
+ */
+static void quark_reserve(size_t n)
+{
+	size_t q;
 
-	if (nr_quarks == alloc_quarks) {
-		alloc_quarks *= 2;
+	if (nr_quarks + n > alloc_quarks) {
+		while (nr_quarks + n > alloc_quarks)
+			alloc_quarks *= 2;
 		quarks = mem_realloc(quarks, alloc_quarks * sizeof(char *));
 	}
 
+	if (2 * (nr_quarks + n) <= quark_table_size)
+		return;
+
+	/* Grow and rehash */
+	while (2 * (nr_quarks + n) > quark_table_size)
+		quark_table_size *= 2;
+	mem_free(quark_table);
+	quark_table = mem_zalloc(quark_table_size * sizeof(quark_t));
+	for (q = 1; q < nr_quarks; q++)
+		quark_table[quark_slot(quarks[q])] = q;
+}
+
+quark_t quark_add(const char *str)
+{
+	size_t slot = quark_slot(str), table_size;
+	quark_t q = quark_table[slot];
+
+	if (q)
+		return q;
+
+	/* Growing the table moves everything, so look again */
+	table_size = quark_table_size;
+	quark_reserve(1);
+	if (quark_table_size != table_size)
+		slot = quark_slot(str);
+
 	q = nr_quarks++;
 	quarks[q] = string_make(str);
+	quark_table[slot] = q;
 
 	return q;
 }
 
+void quark_add_many(const char **strs, size_t n, quark_t *qs)
+{
+	size_t i;
+
+	quark_reserve(n);
+	for (i = 0; i < n; i++)
+		qs[i] = quark_add(strs[i]);
+}
+
 const char *quark_str(quark_t q)
 {
 	return (q >= nr_quarks ? NULL : quarks[q]);
@@ -54,8 +112,11 @@ const char *quark_str(quark_t q)
 
 void quarks_init(void)
 {
+	nr_quarks = 1;
 	alloc_quarks = QUARKS_INIT;
 	quarks = mem_zalloc(alloc_quarks * sizeof(char*));
+	quark_table_size = 2 * QUARKS_INIT;
+	quark_table = mem_zalloc(quark_table_size * sizeof(quark_t));
 }
 
 void quarks_free(void)
@@ -67,6 +128,9 @@ void quarks_free(void)
 		string_free(quarks[i]);
 
 	mem_free(quarks);
+	mem_free(quark_table);
+	quark_table = NULL;
+	nr_quarks = 1;
 }
 
 struct init_module z_quark_module = {
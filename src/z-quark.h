@@ -34,6 +34,12 @@ typedef size_t quark_t;
  */
 quark_t quark_add(const char *str);
 
+/**
+ * Fill 'qs' with quarks for the 'n' strings in 'strs', making room for
+ * them all at once; for interning many strings, as when loading a savefile
+ */
+void quark_add_many(const char **strs, size_t n, quark_t *qs);
+
 /**
  * Return the string corresponding to the quark
  */
@@ -17,6 +17,7 @@
  */
 
 #include <stdlib.h>
+#include <string.h>
 #include "z-queue.h"
 
 struct queue *q_new(size_t size) {
@@ -28,27 +29,27 @@ struct queue *q_new(size_t size) {
     return q;
 }
 
-int q_len(struct queue *q) {
-    int len;
-    if (q->tail >= q->head) {
-        len = q->tail - q->head;
-    } else {
-        len = q->size - q->head + q->tail;
-    }
-    return len;
-}
+/**
+ * Double the room in a queue which a push has just filled, so that tail has
+ * caught up with head; the items are unwrapped to the front of the new buffer.
+ */
+void q_grow(struct queue *q) {
+    uintptr_t *data = (uintptr_t*)malloc(sizeof(uintptr_t) * q->size * 2);
+    size_t first = q->size - q->head;
 
-void q_push(struct queue *q, uintptr_t item) {
-    q->data[q->tail] = item;
-    q->tail = (q->tail + 1) % q->size;
-    if (q->tail == q->head) abort();
+    if (!data) abort();
+    memcpy(data, q->data + q->head, sizeof(uintptr_t) * first);
+    memcpy(data + first, q->data, sizeof(uintptr_t) * q->tail);
+    free(q->data);
+    q->data = data;
+    q->head = 0;
+    q->tail = q->size;
+    q->size *= 2;
 }
 
-uintptr_t q_pop(struct queue *q) {
-    uintptr_t item = q->data[q->head];
-    if (q->head == q->tail) abort();
-    q->head = (q->head + 1) % q->size;
-    return item;
+void q_reset(struct queue *q) {
+    q->head = 0;
+    q->tail = 0;
 }
 
 void q_free(struct queue *q) {
@@ -20,6 +20,7 @@
 #define INCLUDED_Z_QUEUE_H
 
 #include "h-basic.h"
+#include <stdlib.h>
 
 #if (!defined(HAVE_STDINT_H))
 /* MSVC doesn't have stdint.h (which is C99), so we'll just
@@ -34,25 +35,51 @@ typedef unsigned long uintptr_t;
 #endif
 #endif
 
+/**
+ * A ring buffer of integers or pointers.  It starts with room for the size
+ * given to q_new() and doubles whenever it fills, so callers only need a
+ * reasonable guess; q_reset() empties it but keeps the storage for reuse.
+ */
 struct queue {
     uintptr_t *data;
     size_t size;
-    int head;
-    int tail;
+    size_t head;
+    size_t tail;
 };
 
 struct queue *q_new(size_t size);
-int q_len(struct queue *q);
+void q_grow(struct queue *q);
+void q_reset(struct queue *q);
+void q_free(struct queue *q);
 
-void q_push(struct queue *q, uintptr_t item);
-uintptr_t q_pop(struct queue *q);
+/* Pushing and popping happen for each grid of a flood fill, so are inline */
+static inline int q_len(const struct queue *q) {
+    if (q->tail >= q->head) return (int)(q->tail - q->head);
+    return (int)(q->size - q->head + q->tail);
+}
 
-void q_free(struct queue *q);
+static inline void q_push(struct queue *q, uintptr_t item) {
+    q->data[q->tail] = item;
+    if (++q->tail == q->size) q->tail = 0;
+    if (q->tail == q->head) q_grow(q);
+}
+
+static inline uintptr_t q_pop(struct queue *q) {
+    uintptr_t item = q->data[q->head];
+    if (q->head == q->tail) abort();
+    if (++q->head == q->size) q->head = 0;
+    return item;
+}
+
+static inline void q_push_int(struct queue *q, int i) {
+    q_push(q, (uintptr_t)i);
+}
+
+static inline int q_pop_int(struct queue *q) {
+    return (int)q_pop(q);
+}
 
 #define q_push_ptr(q, ptr) q_push((q), (uintptr_t)(ptr))
 #define q_pop_ptr(q) ((void *)(q_pop((q))))
 
-#define q_push_int(q, i) q_push((q), (uintptr_t)(i))
-#define q_pop_int(q) ((int)(q_pop((q))))
-
 #endif /* INCLUDED_Z_QUEUE_H */
@@ -50,29 +50,24 @@
 #define MAT0NEG(t, v) (v ^ (v << (-(t))))
 #define Identity(v) (v)
 
-u32b state_i = 0;
-u32b STATE[RAND_DEG] = {0, 0, 0, 0, 0, 0, 0, 0,
-						0, 0, 0, 0, 0, 0, 0, 0,
-						0, 0, 0, 0, 0, 0, 0, 0,
-						0, 0, 0, 0, 0, 0, 0, 0};
-u32b z0, z1, z2;
-
-#define V0    STATE[state_i]
-#define VM1   STATE[(state_i + M1) & 0x0000001fU]
-#define VM2   STATE[(state_i + M2) & 0x0000001fU]
-#define VM3   STATE[(state_i + M3) & 0x0000001fU]
-#define VRm1  STATE[(state_i + 31) & 0x0000001fU]
-#define newV0 STATE[(state_i + 31) & 0x0000001fU]
-#define newV1 STATE[state_i]
-
-static u32b WELLRNG1024a (void){
+#define V0    r->state[r->state_i]
+#define VM1   r->state[(r->state_i + M1) & 0x0000001fU]
+#define VM2   r->state[(r->state_i + M2) & 0x0000001fU]
+#define VM3   r->state[(r->state_i + M3) & 0x0000001fU]
+#define VRm1  r->state[(r->state_i + 31) & 0x0000001fU]
+#define newV0 r->state[(r->state_i + 31) & 0x0000001fU]
+#define newV1 r->state[r->state_i]
+
+static u32b WELLRNG1024a (struct rng_state *r){
+	u32b z0, z1, z2;
+
 	z0      = VRm1;
 	z1      = Identity(V0) ^ MAT0POS (8, VM1);
 	z2      = MAT0NEG (-19, VM2) ^ MAT0NEG(-14,VM3);
 	newV1   = z1 ^ z2; 
 	newV0   = MAT0NEG (-11,z0) ^ MAT0NEG(-7,z1) ^ MAT0NEG(-13,z2);
-	state_i = (state_i + 31) & 0x0000001fU;
-	return STATE[state_i];
+	r->state_i = (r->state_i + 31) & 0x0000001fU;
+	return r->state[r->state_i];
 }
 /* end WELL RNG */
 
@@ -83,45 +78,96 @@ static u32b WELLRNG1024a (void){
 
 
 /**
- * Whether to use the simple RNG or not.
- */
-bool Rand_quick = true;
-
-/**
- * The current "seed" of the simple RNG.
+ * The state of the RNG used by the game, which starts out on the simple RNG
  */
-u32b Rand_value;
+struct rng_state Rand_default = { true, 0, 0, { 0 } };
 
 static bool rand_fixed = false;
 static u32b rand_fixval = 0;
 
 /**
  * Initialize the complex RNG using a new seed.
+ *
+ * Note that the state index carries on from wherever it was, so a fresh
+ * state should start zeroed.
  */
-void Rand_state_init(u32b seed)
+void Rand_state_init_r(struct rng_state *r, u32b seed)
 {
 	int i, j;
 
 	/* Seed the table */
-	STATE[0] = seed;
+	r->state[0] = seed;
 
 	/* Propagate the seed */
 	for (i = 1; i < RAND_DEG; i++)
-		STATE[i] = LCRNG(STATE[i - 1]);
+		r->state[i] = LCRNG(r->state[i - 1]);
 
 	/* Cycle the table ten times per degree */
 	for (i = 0; i < RAND_DEG * 10; i++) {
 		/* Acquire the next index */
-		j = (state_i + 1) % RAND_DEG;
+		j = (r->state_i + 1) % RAND_DEG;
 
 		/* Update the table, extract an entry */
-		STATE[j] += STATE[state_i];
+		r->state[j] += r->state[r->state_i];
 
 		/* Advance the index */
-		state_i = j;
+		r->state_i = j;
 	}
 }
 
+void Rand_state_init(u32b seed)
+{
+	Rand_state_init_r(&Rand_default, seed);
+}
+
+/**
+ * Scramble a 32-bit value so that nearby inputs give unrelated outputs
+ * (the finaliser from MurmurHash3)
+ */
+static u32b rand_mix(u32b x)
+{
+	x ^= x >> 16;
+	x *= 0x85ebca6bU;
+	x ^= x >> 13;
+	x *= 0xc2b2ae35U;
+	x ^= x >> 16;
+	return x;
+}
+
+/**
+ * Give `child` a stream of its own, which depends only on the state of
+ * `parent` and on `stream`.
+ *
+ * Jumping the WELL1024a generator ahead by a fixed distance would need its
+ * 1024-bit characteristic polynomial; instead every word of the child's
+ * table is a scrambled mix of the parent's table and the stream number, so
+ * that the same parent and stream always give the same child and different
+ * streams share nothing in their tables.  The child is then run through the
+ * same warm-up as a freshly seeded table.
+ */
+void Rand_split(const struct rng_state *parent, u32b stream,
+				struct rng_state *child)
+{
+	u32b key = rand_mix(stream * 0x9e3779b9U + 0x7f4a7c15U);
+	int i;
+
+	child->quick = false;
+	child->value = rand_mix(parent->value ^ key);
+	child->state_i = 0;
+	for (i = 0; i < RAND_DEG; i++) {
+		u32b word = parent->state[(parent->state_i + i) % RAND_DEG];
+
+		key = rand_mix(key + word + (u32b) i);
+		child->state[i] = key;
+	}
+
+	/* Keep the table away from all zeroes, which WELL never leaves */
+	child->state[0] |= 1;
+
+	for (i = 0; i < RAND_DEG * 10; i++)
+		WELLRNG1024a(child);
+}
+
 /**
  * Initialise the RNG
  */
@@ -161,9 +207,9 @@ void Rand_init(void)
  * This method has no bias, and is much less affected by patterns in the "low"
  * bits of the underlying RNG's. However, it is potentially non-terminating.
  */
-u32b Rand_div(u32b m)
+u32b Rand_div_r(struct rng_state *r, u32b m)
 {
-	u32b r, n;
+	u32b v, n;
 
 	/* Division by zero will result if m is larger than 0x10000000 */
 	assert(m <= 0x10000000);
@@ -177,35 +223,107 @@ u32b Rand_div(u32b m)
 	/* Partition size */
 	n = (0x10000000 / m);
 
-	if (Rand_quick) {
+	if (r->quick) {
 		/* Use a simple RNG */
 		/* Wait for it */
 		while (1) {
 			/* Cycle the generator */
-			r = (Rand_value = LCRNG(Rand_value));
+			v = (r->value = LCRNG(r->value));
 
 			/* Mutate a 28-bit "random" number */
-			r = ((r >> 4) & 0x0FFFFFFF) / n;
+			v = ((v >> 4) & 0x0FFFFFFF) / n;
 
 			/* Done */
-			if (r < m) break;
+			if (v < m) break;
 		}
 	} else {
 		/* Use a complex RNG */
 		while (1) {
 			/* Get the next pseudorandom number */
-			r = WELLRNG1024a();
+			v = WELLRNG1024a(r);
 
 			/* Mutate a 28-bit "random" number */
-			r = ((r >> 4) & 0x0FFFFFFF) / n;
+			v = ((v >> 4) & 0x0FFFFFFF) / n;
 
 			/* Done */
-			if (r < m) break;
+			if (v < m) break;
 		}
 	}
 
 	/* Use the value */
-	return (r);
+	return (v);
+}
+
+u32b Rand_div(u32b m)
+{
+	return Rand_div_r(&Rand_default, m);
+}
+
+/**
+ * Draw `num` numbers from 0 to m - 1, exactly as `num` calls to Rand_div_r()
+ * would, storing them in `out` if it is given and returning their sum.
+ *
+ * The generator is sequential, so this can't draw the numbers side by side;
+ * instead the partition size is worked out once and the generator's state is
+ * kept in locals for the whole block, rather than for every number.
+ */
+static u32b rand_div_block(struct rng_state *r, u32b m, u32b *out, int num)
+{
+	u32b n, v, sum = 0;
+	int i;
+
+	assert(m <= 0x10000000);
+
+	/* Hack -- simple cases */
+	if (m <= 1 || rand_fixed) {
+		v = Rand_div_r(r, m);
+		for (i = 0; i < num; i++) {
+			if (out) out[i] = v;
+			sum += v;
+		}
+		return sum;
+	}
+
+	/* Partition size */
+	n = (0x10000000 / m);
+
+	if (r->quick) {
+		u32b value = r->value;
+
+		for (i = 0; i < num; i++) {
+			do {
+				value = LCRNG(value);
+				v = ((value >> 4) & 0x0FFFFFFF) / n;
+			} while (v >= m);
+			if (out) out[i] = v;
+			sum += v;
+		}
+		r->value = value;
+	} else {
+		for (i = 0; i < num; i++) {
+			do {
+				v = ((WELLRNG1024a(r) >> 4) & 0x0FFFFFFF) / n;
+			} while (v >= m);
+			if (out) out[i] = v;
+			sum += v;
+		}
+	}
+
+	return sum;
+}
+
+/**
+ * Fill `out` with `num` numbers from 0 to m - 1; the same stream as calling
+ * Rand_div() `num` times
+ */
+void Rand_div_fill_r(struct rng_state *r, u32b m, u32b *out, int num)
+{
+	rand_div_block(r, m, out, num);
+}
+
+void Rand_div_fill(u32b m, u32b *out, int num)
+{
+	rand_div_block(&Rand_default, m, out, num);
 }
 
 
@@ -280,7 +398,7 @@ static s16b Rand_normal_table[RANDNOR_NUM] = {
  *
  * Note that the binary search takes up to 16 quick iterations.
  */
-s16b Rand_normal(int mean, int stand)
+s16b Rand_normal_r(struct rng_state *r, int mean, int stand)
 {
 	s16b tmp, offset;
 
@@ -291,7 +409,7 @@ s16b Rand_normal(int mean, int stand)
 	if (stand < 1) return (mean);
 
 	/* Roll for probability */
-	tmp = (s16b)randint0(32768);
+	tmp = (s16b)randint0_r(r, 32768);
 
 	/* Binary Search */
 	while (low < high) {
@@ -309,12 +427,34 @@ s16b Rand_normal(int mean, int stand)
 	offset = (s16b)((long)stand * (long)low / RANDNOR_STD);
 
 	/* One half should be negative */
-	if (one_in_(2)) return (mean - offset);
+	if (one_in_r(r, 2)) return (mean - offset);
 
 	/* One half should be positive */
 	return (mean + offset);
 }
 
+s16b Rand_normal(int mean, int stand)
+{
+	return Rand_normal_r(&Rand_default, mean, stand);
+}
+
+/**
+ * Fill `out` with `num` numbers from Rand_normal_r(r, mean, stand), in order
+ */
+void Rand_normal_fill_r(struct rng_state *r, int mean, int stand, s16b *out,
+						int num)
+{
+	int i;
+
+	for (i = 0; i < num; i++)
+		out[i] = Rand_normal_r(r, mean, stand);
+}
+
+void Rand_normal_fill(int mean, int stand, s16b *out, int num)
+{
+	Rand_normal_fill_r(&Rand_default, mean, stand, out, num);
+}
+
 
 /**
  * Choose an integer from a distribution where we know the mean and approximate
@@ -349,16 +489,33 @@ int Rand_sample(int mean, int upper, int lower, int stand_u, int stand_l)
 /**
  * Generates damage for "2d6" style dice rolls
  */
+int damroll_r(struct rng_state *r, int num, int sides)
+{
+	if (sides <= 0 || num <= 0) return 0;
+
+	return num + (int) rand_div_block(r, sides, NULL, num);
+}
+
 int damroll(int num, int sides)
+{
+	return damroll_r(&Rand_default, num, sides);
+}
+
+/**
+ * Fill `out` with `count` rolls of `num` dice with `sides` sides, in order
+ */
+void damroll_fill_r(struct rng_state *r, int num, int sides, int *out,
+					int count)
 {
 	int i;
-	int sum = 0;
 
-	if (sides <= 0) return 0;
+	for (i = 0; i < count; i++)
+		out[i] = damroll_r(r, num, sides);
+}
 
-	for (i = 0; i < num; i++)
-		sum += randint1(sides);
-	return sum;
+void damroll_fill(int num, int sides, int *out, int count)
+{
+	damroll_fill_r(&Rand_default, num, sides, out, count);
 }
 
 
@@ -366,12 +523,13 @@ int damroll(int num, int sides)
 /**
  * Calculation helper function for damroll
  */
-int damcalc(int num, int sides, aspect dam_aspect)
+static int damcalc_r(struct rng_state *r, int num, int sides,
+					 aspect dam_aspect)
 {
 	switch (dam_aspect) {
 		case MAXIMISE:
 		case EXTREMIFY: return num * sides;
-		case RANDOMISE: return damroll(num, sides);
+		case RANDOMISE: return damroll_r(r, num, sides);
 		case MINIMISE: return num;
 		case AVERAGE: return num * (sides + 1) / 2;
 	}
@@ -380,6 +538,11 @@ int damcalc(int num, int sides, aspect dam_aspect)
 	return 0;
 }
 
+int damcalc(int num, int sides, aspect dam_aspect)
+{
+	return damcalc_r(&Rand_default, num, sides, dam_aspect);
+}
+
 
 /**
  * Generates a random signed long integer X where `A` <= X <= `B`.
@@ -400,11 +563,11 @@ int rand_range(int A, int B)
  * Perform division, possibly rounding up or down depending on the size of the
  * remainder and chance.
  */
-static int simulate_division(int dividend, int divisor)
+static int simulate_division(struct rng_state *r, int dividend, int divisor)
 {
 	int quotient  = dividend / divisor;
 	int remainder = dividend % divisor;
-	if (randint0(divisor) < remainder) quotient++;
+	if (randint0_r(r, divisor) < remainder) quotient++;
 	return quotient;
 }
 
@@ -448,7 +611,7 @@ static int simulate_division(int dividend, int divisor)
  * 120    0.03  0.11  0.31  0.46  1.31  2.48  4.60  7.78 11.67 25.53 45.72
  * 128    0.02  0.01  0.13  0.33  0.83  1.41  3.24  6.17  9.57 14.22 64.07
  */
-s16b m_bonus(int max, int level)
+static s16b m_bonus_r(struct rng_state *r, int max, int level)
 {
 	int bonus, stand, value;
 
@@ -456,13 +619,13 @@ s16b m_bonus(int max, int level)
 	if (level >= MAX_RAND_DEPTH) level = MAX_RAND_DEPTH - 1;
 
 	/* The bonus approaches max as level approaches MAX_RAND_DEPTH */
-	bonus = simulate_division(max * level, MAX_RAND_DEPTH);
+	bonus = simulate_division(r, max * level, MAX_RAND_DEPTH);
 
 	/* The standard deviation is 1/4 of the max */
-	stand = simulate_division(max, 4);
+	stand = simulate_division(r, max, 4);
 
 	/* Choose a value */
-	value = Rand_normal(bonus, stand);
+	value = Rand_normal_r(r, bonus, stand);
 
 	/* Return, enforcing the min and max values */
 	if (value < 0)
@@ -473,16 +636,22 @@ s16b m_bonus(int max, int level)
 		return value;
 }
 
+s16b m_bonus(int max, int level)
+{
+	return m_bonus_r(&Rand_default, max, level);
+}
+
 
 /**
  * Calculation helper function for m_bonus
  */
-s16b m_bonus_calc(int max, int level, aspect bonus_aspect)
+static s16b m_bonus_calc_r(struct rng_state *r, int max, int level,
+						   aspect bonus_aspect)
 {
 	switch (bonus_aspect) {
 		case EXTREMIFY:
 		case MAXIMISE:  return max;
-		case RANDOMISE: return m_bonus(max, level);
+		case RANDOMISE: return m_bonus_r(r, max, level);
 		case MINIMISE:  return 0;
 		case AVERAGE:   return max * level / MAX_RAND_DEPTH;
 	}
@@ -491,24 +660,35 @@ s16b m_bonus_calc(int max, int level, aspect bonus_aspect)
 	return 0;
 }
 
+s16b m_bonus_calc(int max, int level, aspect bonus_aspect)
+{
+	return m_bonus_calc_r(&Rand_default, max, level, bonus_aspect);
+}
+
 
 /**
  * Calculation helper function for random_value structs
  */
-int randcalc(random_value v, int level, aspect rand_aspect)
+int randcalc_r(struct rng_state *r, random_value v, int level,
+			   aspect rand_aspect)
 {
 	if (rand_aspect == EXTREMIFY) {
-		int min = randcalc(v, level, MINIMISE);
-		int max = randcalc(v, level, MAXIMISE);
+		int min = randcalc_r(r, v, level, MINIMISE);
+		int max = randcalc_r(r, v, level, MAXIMISE);
 		return abs(min) > abs(max) ? min : max;
 
 	} else {
-		int dmg   = damcalc(v.dice, v.sides, rand_aspect);
-		int bonus = m_bonus_calc(v.m_bonus, level, rand_aspect);
+		int dmg   = damcalc_r(r, v.dice, v.sides, rand_aspect);
+		int bonus = m_bonus_calc_r(r, v.m_bonus, level, rand_aspect);
 		return v.base + dmg + bonus;
 	}
 }
 
+int randcalc(random_value v, int level, aspect rand_aspect)
+{
+	return randcalc_r(&Rand_default, v, level, rand_aspect);
+}
+
 
 /**
  * Test to see if a value is within a random_value's range
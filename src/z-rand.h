@@ -61,12 +61,31 @@ typedef enum {
 } aspect;
 
 
+/**
+ * The whole state of one random number generator.  The game uses
+ * Rand_default; anything that wants a stream of its own, such as a worker
+ * process or a level being built alongside another, keeps one of these and
+ * uses the _r functions below.
+ */
+struct rng_state {
+	bool quick;				/* Use the "quick" RNG rather than WELL1024a */
+	u32b value;				/* State of the "quick" RNG */
+	u32b state_i;			/* Index into the WELL1024a state */
+	u32b state[RAND_DEG];	/* State of the WELL1024a RNG */
+};
+
+/**
+ * The state behind the global functions
+ */
+extern struct rng_state Rand_default;
+
 /**
  * Generates a random signed long integer X where "0 <= X < M" holds.
  *
  * The integer X falls along a uniform distribution.
  */
 #define randint0(M) ((s32b) Rand_div(M))
+#define randint0_r(R, M) ((s32b) Rand_div_r(R, M))
 
 
 /**
@@ -75,6 +94,7 @@ typedef enum {
  * The integer X falls along a uniform distribution.
  */
 #define randint1(M) ((s32b) Rand_div(M) + 1)
+#define randint1_r(R, M) ((s32b) Rand_div_r(R, M) + 1)
 
 /**
  * Generate a random signed long integer X where "A - D <= X <= A + D" holds.
@@ -88,31 +108,31 @@ typedef enum {
  * Return true one time in `x`.
  */
 #define one_in_(x) (!randint0(x))
+#define one_in_r(R, x) (!randint0_r(R, x))
 
 /**
  * Whether we are currently using the "quick" method or not.
  */
-extern bool Rand_quick;
+#define Rand_quick (Rand_default.quick)
 
 /**
  * The state used by the "quick" RNG.
  */
-extern u32b Rand_value;
-
-/**
- * The state used by the "complex" RNG.
- */
-extern u32b state_i;
-extern u32b STATE[RAND_DEG];
-extern u32b z0;
-extern u32b z1;
-extern u32b z2;
+#define Rand_value (Rand_default.value)
 
 
 /**
  * Initialise the RNG state with the given seed.
  */
 void Rand_state_init(u32b seed);
+void Rand_state_init_r(struct rng_state *r, u32b seed);
+
+/**
+ * Set up `child` with a stream of its own, picked out by `stream`, from the
+ * state of `parent`, which is left as it was
+ */
+void Rand_split(const struct rng_state *parent, u32b stream,
+				struct rng_state *child);
 
 /**
  * Initialise the RNG
@@ -125,12 +145,24 @@ void Rand_init(void);
  * The integer X falls along a uniform distribution.
  */
 u32b Rand_div(u32b m);
+u32b Rand_div_r(struct rng_state *r, u32b m);
+
+/**
+ * Fill `out` with `num` numbers X where "0 <= X < M", drawing the same
+ * stream as `num` calls to Rand_div() but faster.
+ */
+void Rand_div_fill(u32b m, u32b *out, int num);
+void Rand_div_fill_r(struct rng_state *r, u32b m, u32b *out, int num);
 
 /**
  * Generate a signed random integer within `stand` standard deviations of
  * `mean`, following a normal distribution.
  */
 s16b Rand_normal(int mean, int stand);
+s16b Rand_normal_r(struct rng_state *r, int mean, int stand);
+void Rand_normal_fill(int mean, int stand, s16b *out, int num);
+void Rand_normal_fill_r(struct rng_state *r, int mean, int stand, s16b *out,
+						int num);
 
 /**
  * Generate a signed random integer following a normal distribution, where
@@ -151,6 +183,10 @@ u32b Rand_simple(u32b m);
  * Emulate a number `num` of dice rolls of dice with `sides` sides.
  */
 int damroll(int num, int sides);
+int damroll_r(struct rng_state *r, int num, int sides);
+void damroll_fill(int num, int sides, int *out, int count);
+void damroll_fill_r(struct rng_state *r, int num, int sides, int *out,
+					int count);
 
 /**
  * Calculation helper function for damroll
@@ -180,6 +216,8 @@ s16b m_bonus_calc(int max, int level, aspect bonus_aspect);
  * Calculation helper function for random_value structs.
  */
 int randcalc(random_value v, int level, aspect rand_aspect);
+int randcalc_r(struct rng_state *r, random_value v, int level,
+			   aspect rand_aspect);
 
 /**
  * Test to see if a value is within a random_value's range.
@@ -30,14 +30,35 @@
 #define TEXTBLOCK_LEN_INITIAL		128
 #define TEXTBLOCK_LEN_INCR(x)		((x) + 128)
 
+/**
+ * How many freed textblocks to keep for reuse
+ */
+#define TEXTBLOCK_SPARES			4
+
 struct textblock {
 	wchar_t *text;
 	byte *attrs;
 
 	size_t strlen;
 	size_t size;
+
+	/* Lines as last wrapped, valid while wrap_len == strlen */
+	size_t *line_starts;
+	size_t *line_lengths;
+	size_t n_lines;
+	size_t line_alloc;
+	size_t wrap_width;
+	size_t wrap_len;
+
+	struct textblock *next;
 };
 
+/**
+ * Freed textblocks, with their storage, ready to be handed out again; recall
+ * and info screens make and throw away a textblock on every keypress.
+ */
+static struct textblock *spare_blocks;
+static int n_spare_blocks;
 
 
 /**
@@ -45,8 +66,19 @@ struct textblock {
  */
 textblock *textblock_new(void)
 {
-	textblock *tb = mem_zalloc(sizeof *tb);
+	textblock *tb = spare_blocks;
+
+	if (tb) {
+		spare_blocks = tb->next;
+		n_spare_blocks--;
+		tb->next = NULL;
+		tb->strlen = 0;
+		tb->wrap_width = 0;
+		tb->text[0] = 0;
+		return tb;
+	}
 
+	tb = mem_zalloc(sizeof *tb);
 	tb->size = TEXTBLOCK_LEN_INITIAL;
 	tb->text = mem_zalloc(tb->size * sizeof *tb->text);
 	tb->attrs = mem_zalloc(tb->size);
@@ -59,6 +91,15 @@ textblock *textblock_new(void)
  */
 void textblock_free(textblock *tb)
 {
+	if (n_spare_blocks < TEXTBLOCK_SPARES) {
+		tb->next = spare_blocks;
+		spare_blocks = tb;
+		n_spare_blocks++;
+		return;
+	}
+
+	mem_free(tb->line_starts);
+	mem_free(tb->line_lengths);
 	mem_free(tb->text);
 	mem_free(tb->attrs);
 	mem_free(tb);
@@ -66,7 +107,7 @@ void textblock_free(textblock *tb)
 
 /**
  * Resize the internal textblock storage (if needed) to hold additional
- * characters.
+ * characters, and the terminating null after them.
  *
  * \param tb is the textblock we need to resize.
  * \param additional_size is how many characters we want to add.
@@ -76,7 +117,7 @@ void textblock_resize_if_needed(textblock *tb, size_t additional_size)
 	size_t remaining = tb->size - tb->strlen;
 
 	/* If we need more room, reallocate it */
-	if (remaining < additional_size) {
+	if (remaining <= additional_size) {
 		tb->size = TEXTBLOCK_LEN_INCR(tb->strlen + additional_size);
 		tb->text = mem_realloc(tb->text, tb->size * sizeof *tb->text);
 		tb->attrs = mem_realloc(tb->attrs, tb->size);
@@ -119,6 +160,7 @@ static void textblock_vappend_c(textblock *tb, byte attr, const char *fmt,
 	text_mbstowcs(tb->text + tb->strlen, temp_space, tb->size - tb->strlen);
 	memset(tb->attrs + tb->strlen, attr, new_length);
 	tb->strlen += new_length;
+	tb->text[tb->strlen] = 0;
 	mem_free(temp_space);
 }
 
@@ -131,6 +173,7 @@ void textblock_append_pict(textblock *tb, byte attr, int c)
 	tb->text[tb->strlen] = (wchar_t)c;
 	tb->attrs[tb->strlen] = attr;
 	tb->strlen += 1;
+	tb->text[tb->strlen] = 0;
 }
 
 /**
@@ -160,6 +203,7 @@ void textblock_append_utf8(textblock *tb, const char *utf8_string)
 
 	memset(tb->attrs + tb->strlen, COLOUR_WHITE, new_length);
 	tb->strlen += new_length;
+	tb->text[tb->strlen] = 0;
 }
 
 /**
@@ -226,42 +270,32 @@ static void new_line(size_t **line_starts, size_t **line_lengths,
 }
 
 /**
- * Given a certain width, split a textblock into wrapped lines of text. Trailing
- * empty lines are trimmed.
- *
- * \param tb The textblock to wrap.
- * \param line_starts On return, an array (indexed by line number) of character
- *		  indexes to the text of \c tb where each line begins.
- * \param line_lengths On return, an array (indexed by line number) of line
- *		  lengths.
- * \param width The maximum permitted width of each line.
- * \return Number of lines in output.
+ * Split a textblock into lines of at most the given width, into arrays of
+ * line starts and lengths which are grown as needed.  Trailing empty lines
+ * are trimmed.
  */
-size_t textblock_calculate_lines(textblock *tb, size_t **line_starts, size_t **line_lengths, size_t width)
+static size_t textblock_wrap_lines(textblock *tb, size_t **line_starts,
+		size_t **line_lengths, size_t *alloc_lines, size_t width)
 {
 	const wchar_t *text = NULL;
 	size_t text_offset = 0;
-	size_t alloc_lines = 0;
 	size_t total_lines = 0;
 	size_t current_line_index = 0;
 	size_t current_line_length = 0;
 	size_t breaking_char_offset = 0;
 
-	if (tb == NULL || line_starts == NULL || line_lengths == NULL || width == 0)
-		return 0;
-
 	text = textblock_text(tb);
 
-	if (text == NULL || tb->strlen == 0)
+	if (tb->strlen == 0)
 		return 0;
 
 	/* Start a line, since we have at least one. */
-	new_line(line_starts, line_lengths, &alloc_lines, &total_lines, 0, 0);
+	new_line(line_starts, line_lengths, alloc_lines, &total_lines, 0, 0);
 
 	while (text_offset < tb->strlen) {
 		if (text[text_offset] == L'\n') {
 			(*line_lengths)[current_line_index] = current_line_length;
-			new_line(line_starts, line_lengths, &alloc_lines, &total_lines, text_offset + 1, 0);
+			new_line(line_starts, line_lengths, alloc_lines, &total_lines, text_offset + 1, 0);
 			current_line_index++;
 			current_line_length = 0;
 		}
@@ -299,7 +333,7 @@ size_t textblock_calculate_lines(textblock *tb, size_t **line_starts, size_t **l
 			}
 
 			(*line_lengths)[current_line_index] = adjusted_line_length;
-			new_line(line_starts, line_lengths, &alloc_lines, &total_lines, next_line_start_offset, 0);
+			new_line(line_starts, line_lengths, alloc_lines, &total_lines, next_line_start_offset, 0);
 			current_line_index++;
 			current_line_length = 0;
 		}
@@ -317,20 +351,72 @@ size_t textblock_calculate_lines(textblock *tb, size_t **line_starts, size_t **l
 	return total_lines;
 }
 
+/**
+ * Given a certain width, split a textblock into wrapped lines of text. Trailing
+ * empty lines are trimmed.
+ *
+ * The lines are kept with the textblock, so wrapping it again at the same
+ * width before anything more is appended costs nothing.  They belong to the
+ * textblock and are only good until it is next changed, wrapped at another
+ * width or freed.
+ *
+ * \param tb The textblock to wrap.
+ * \param line_starts On return, an array (indexed by line number) of character
+ *		  indexes to the text of \c tb where each line begins.
+ * \param line_lengths On return, an array (indexed by line number) of line
+ *		  lengths.
+ * \param width The maximum permitted width of each line.
+ * \return Number of lines in output.
+ */
+size_t textblock_wrap(textblock *tb, const size_t **line_starts,
+		const size_t **line_lengths, size_t width)
+{
+	if (tb == NULL || line_starts == NULL || line_lengths == NULL || width == 0)
+		return 0;
+
+	if (tb->wrap_width != width || tb->wrap_len != tb->strlen) {
+		tb->n_lines = textblock_wrap_lines(tb, &tb->line_starts,
+				&tb->line_lengths, &tb->line_alloc, width);
+		tb->wrap_width = width;
+		tb->wrap_len = tb->strlen;
+	}
+
+	*line_starts = tb->line_starts;
+	*line_lengths = tb->line_lengths;
+	return tb->n_lines;
+}
+
+/**
+ * As textblock_wrap(), but into new arrays which the caller must free.
+ */
+size_t textblock_calculate_lines(textblock *tb, size_t **line_starts, size_t **line_lengths, size_t width)
+{
+	const size_t *starts, *lengths;
+	size_t n_lines = textblock_wrap(tb, &starts, &lengths, width);
+
+	if (!n_lines) return 0;
+
+	*line_starts = mem_alloc(n_lines * sizeof **line_starts);
+	*line_lengths = mem_alloc(n_lines * sizeof **line_lengths);
+	memcpy(*line_starts, starts, n_lines * sizeof **line_starts);
+	memcpy(*line_lengths, lengths, n_lines * sizeof **line_lengths);
+	return n_lines;
+}
+
 /**
  * Output a textblock to file.
  */
 void textblock_to_file(textblock *tb, ang_file *f, int indent, int wrap_at)
 {
-	size_t *line_starts = NULL;
-	size_t *line_lengths = NULL;
+	const size_t *line_starts = NULL;
+	const size_t *line_lengths = NULL;
 
 	size_t n_lines, i;
 
 	int width = wrap_at - indent;
 	assert(width > 0);
 
-	n_lines = textblock_calculate_lines(tb, &line_starts, &line_lengths, width);
+	n_lines = textblock_wrap(tb, &line_starts, &line_lengths, width);
 
 	for (i = 0; i < n_lines; i++) {
 		/* For some reason, the %*c part of the format string was still
@@ -341,9 +427,6 @@ void textblock_to_file(textblock *tb, ang_file *f, int indent, int wrap_at)
 			file_putf(f, "%*c%.*ls\n", indent, ' ', line_lengths[i],
 					  tb->text + line_starts[i]);
 	}
-
-	mem_free(line_starts);
-	mem_free(line_lengths);
 }
 
 
@@ -685,7 +768,32 @@ void text_out_e(const char *fmt, ...)
 
 
 /**
- * Write a text file from given input.
+ * Check whether two files hold the same bytes
+ */
+static bool files_match(const char *first, const char *second)
+{
+	ang_file *f1 = file_open(first, MODE_READ, FTYPE_TEXT);
+	ang_file *f2 = file_open(second, MODE_READ, FTYPE_TEXT);
+	char buf1[4096], buf2[4096];
+	int n1, n2;
+	bool same = f1 && f2;
+
+	while (same) {
+		n1 = file_read(f1, buf1, sizeof(buf1));
+		n2 = file_read(f2, buf2, sizeof(buf2));
+		if (n1 != n2 || n1 < 0 || memcmp(buf1, buf2, n1)) same = false;
+		else if (!n1) break;
+	}
+
+	if (f1) file_close(f1);
+	if (f2) file_close(f2);
+	return same;
+}
+
+/**
+ * Write a text file from given input.  If the file is already there and
+ * just the same, it is left alone, so files written again and again, like
+ * character dumps, only change when what is in them does.
  *
  * \param path the path to write to
  * \param writer the text-writing function
@@ -720,6 +828,8 @@ errr text_lines_to_file(const char *path, text_writer writer)
 	strnfmt(old_fname, sizeof(old_fname), "%s.old", path);
 	if (!file_exists(path)) {
 		file_move(new_fname, path);
+	} else if (files_match(new_fname, path)) {
+		file_delete(new_fname);
 	} else if (file_move(path, old_fname)) {
 		file_move(new_fname, path);
 		file_delete(old_fname);
@@ -81,21 +81,56 @@ struct point_set *point_set_new(int initial_size)
 	ps->n = 0;
 	ps->allocated = initial_size;
 	ps->pts = mem_zalloc(sizeof(*(ps->pts)) * ps->allocated);
+	ps->width = 0;
+	ps->height = 0;
+	ps->member = NULL;
+	return ps;
+}
+
+/**
+ * Make a point set for grids in a width by height area, which keeps a map
+ * of its members so that point_set_contains() doesn't have to search
+ */
+struct point_set *point_set_new_grid(int initial_size, int width, int height)
+{
+	struct point_set *ps = point_set_new(initial_size);
+	ps->width = width;
+	ps->height = height;
+	ps->member = mem_zalloc((width * height + 7) / 8);
 	return ps;
 }
 
 void point_set_dispose(struct point_set *ps)
 {
+	mem_free(ps->member);
 	mem_free(ps->pts);
 	mem_free(ps);
 }
 
+/**
+ * Find where a grid is in the member map of a point set, or -1 if it is
+ * outside the map
+ */
+static int point_set_member_index(struct point_set *ps, struct loc grid)
+{
+	if (grid.x < 0 || grid.x >= ps->width || grid.y < 0 ||
+		grid.y >= ps->height)
+		return -1;
+	return grid.y * ps->width + grid.x;
+}
+
 /**
  * Add the point to the given point set, making more space if there is
  * no more space left.
  */
 void add_to_point_set(struct point_set *ps, struct loc grid)
 {
+	if (ps->member) {
+		int i = point_set_member_index(ps, grid);
+		if (i >= 0)
+			ps->member[i / 8] |= 1 << (i % 8);
+	}
+
 	ps->pts[ps->n] = grid;
 	ps->n++;
 	if (ps->n >= ps->allocated) {
@@ -112,6 +147,14 @@ int point_set_size(struct point_set *ps)
 int point_set_contains(struct point_set *ps, struct loc grid)
 {
 	int i;
+
+	/* Grids in the member map can be looked up directly */
+	if (ps->member) {
+		i = point_set_member_index(ps, grid);
+		if (i >= 0)
+			return (ps->member[i / 8] & (1 << (i % 8))) ? 1 : 0;
+	}
+
 	for (i = 0; i < ps->n; i++)
 		if (loc_eq(ps->pts[i], grid))
 			return 1;
@@ -51,9 +51,13 @@ struct point_set {
 	int n;
 	int allocated;
 	struct loc *pts;
+	int width;			/* Grids inside width by height are also */
+	int height;			/* noted in member, one bit each, if there */
+	byte *member;		/* is a member map */
 };
 
 struct point_set *point_set_new(int initial_size);
+struct point_set *point_set_new_grid(int initial_size, int width, int height);
 void point_set_dispose(struct point_set *ps);
 void add_to_point_set(struct point_set *ps, struct loc grid);
 int point_set_size(struct point_set *ps);
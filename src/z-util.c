@@ -380,6 +380,18 @@ bool is_a_vowel(int ch)
  */
 size_t text_mbstowcs(wchar_t *dest, const char *src, int n)
 {
+	int i;
+
+	/* Plain ASCII, nearly all the game writes, reads the same in any
+	 * locale, so widen it directly and only decode anything else */
+	if (dest) {
+		for (i = 0; i < n && !(src[i] & 0x80); i++) {
+			dest[i] = (unsigned char) src[i];
+			if (!src[i]) return i;
+		}
+		if (i == n) return n;
+	}
+
 	if (text_mbcs_hook)
 		return (*text_mbcs_hook)(dest, src, n);
 	else
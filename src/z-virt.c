@@ -23,32 +23,193 @@ unsigned int mem_flags = 0;
 #define SZ(uptr)	*((size_t *)((char *)(uptr) - sizeof(size_t)))
 
 /**
- * Allocate `len` bytes of memory.
- *
- * Returns:
- *  - NULL if `len` == 0; or
- *  - a pointer to a block of memory of at least `len` bytes
+ * The size header keeps the block's accounting tag in its top bits
+ */
+#define SZ_TAG_SHIFT	(sizeof(size_t) * 8 - 4)
+#define SZ_LEN_MASK		(((size_t)1 << SZ_TAG_SHIFT) - 1)
+#define SZ_MAKE(len, tag)	((len) | ((size_t)(tag) << SZ_TAG_SHIFT))
+#define SZ_LEN(uptr)	(SZ(uptr) & SZ_LEN_MASK)
+#define SZ_TAG(uptr)	((enum mem_tag)(SZ(uptr) >> SZ_TAG_SHIFT))
+
+/**
+ * The size header of a string living in the string pool
+ */
+#define STRING_POOLED	((size_t)-1)
+
+/**
+ * Small blocks come from per-size-class free lists, carved out of larger
+ * slabs, rather than going to malloc() and free() every time; they keep the
+ * same size header as large blocks, so mem_free() can tell which is which.
  *
- * Doesn't return on out of memory.
+ * Each class holds blocks of up to POOL_GRAIN * (class + 1) bytes, and
+ * freed blocks are kept for reuse rather than given back to the system.
  */
-void *mem_alloc(size_t len)
+#define POOL_GRAIN		16
+#define POOL_CLASSES	32
+#define POOL_MAX		(POOL_GRAIN * POOL_CLASSES)
+#define POOL_SLAB		65536
+
+struct pool_block {
+	struct pool_block *next;
+};
+
+static struct pool_block *pool_free_list[POOL_CLASSES];
+static char *pool_slab_pos;
+static size_t pool_slab_left;
+
+/**
+ * The size class for a small block of `len` bytes
+ */
+#define POOL_CLASS(len)	(((len) - 1) / POOL_GRAIN)
+
+/**
+ * Get a block of size class `class`, including its header
+ */
+static char *pool_get(size_t class)
+{
+	size_t stride = POOL_GRAIN * (class + 1) + sizeof(size_t);
+	char *mem;
+
+	/* Reuse a freed block */
+	if (pool_free_list[class]) {
+		mem = (char *)pool_free_list[class];
+		pool_free_list[class] = pool_free_list[class]->next;
+		return mem - sizeof(size_t);
+	}
+
+	/* Start a new slab; what's left of the old one is abandoned */
+	stride = (stride + POOL_GRAIN - 1) / POOL_GRAIN * POOL_GRAIN;
+	if (pool_slab_left < stride) {
+		pool_slab_pos = malloc(POOL_SLAB);
+		if (!pool_slab_pos)
+			quit("Out of Memory!");
+		pool_slab_left = POOL_SLAB;
+	}
+
+	mem = pool_slab_pos;
+	pool_slab_pos += stride;
+	pool_slab_left -= stride;
+	return mem;
+}
+
+/**
+ * Allocation accounting, kept only while MEM_ACCOUNT is set
+ */
+static struct mem_tag_stats mem_stats[MEM_TAG_MAX];
+static enum mem_tag mem_tag_current = MEM_TAG_OTHER;
+
+static const char *mem_tag_names[MEM_TAG_MAX] = {
+	"other",
+	"cave",
+	"objects",
+	"monsters",
+	"strings",
+	"UI",
+	"parser"
+};
+
+static void mem_account_alloc(enum mem_tag tag, size_t len)
+{
+	struct mem_tag_stats *stats = &mem_stats[tag];
+
+	if (!(mem_flags & MEM_ACCOUNT)) return;
+
+	stats->bytes += len;
+	stats->allocs++;
+	if (stats->bytes > stats->peak)
+		stats->peak = stats->bytes;
+}
+
+static void mem_account_free(enum mem_tag tag, size_t len)
+{
+	struct mem_tag_stats *stats = &mem_stats[tag];
+
+	if (!(mem_flags & MEM_ACCOUNT)) return;
+
+	/* Blocks allocated before accounting started aren't in the count */
+	stats->bytes -= MIN(len, stats->bytes);
+	stats->frees++;
+}
+
+/**
+ * Make `tag` the one new allocations are accounted to, returning the one
+ * it replaces so that it can be put back afterwards.
+ */
+enum mem_tag mem_tag_set(enum mem_tag tag)
+{
+	enum mem_tag old = mem_tag_current;
+
+	mem_tag_current = tag;
+	return old;
+}
+
+const char *mem_tag_name(enum mem_tag tag)
+{
+	return mem_tag_names[tag];
+}
+
+void mem_tag_get_stats(enum mem_tag tag, struct mem_tag_stats *stats)
+{
+	*stats = mem_stats[tag];
+}
+
+/**
+ * Start the peaks and counts afresh; bytes in use are left alone.
+ */
+void mem_tag_reset(void)
+{
+	int i;
+
+	for (i = 0; i < MEM_TAG_MAX; i++) {
+		mem_stats[i].peak = mem_stats[i].bytes;
+		mem_stats[i].allocs = 0;
+		mem_stats[i].frees = 0;
+	}
+}
+
+/**
+ * Allocate `len` bytes of memory, accounted to `tag`
+ */
+static void *mem_alloc_tag(size_t len, enum mem_tag tag)
 {
 	char *mem;
 
 	/* Allow allocation of "zero bytes" */
 	if (len == 0) return (NULL);
 
-	mem = malloc(len + sizeof(size_t));
-	if (!mem)
+	if (len > SZ_LEN_MASK)
 		quit("Out of Memory!");
+
+	if (len <= POOL_MAX) {
+		mem = pool_get(POOL_CLASS(len));
+	} else {
+		mem = malloc(len + sizeof(size_t));
+		if (!mem)
+			quit("Out of Memory!");
+	}
 	mem += sizeof(size_t);
 	if (mem_flags & MEM_POISON_ALLOC)
 		memset(mem, 0xCC, len);
-	SZ(mem) = len;
+	SZ(mem) = SZ_MAKE(len, tag);
+	mem_account_alloc(tag, len);
 
 	return mem;
 }
 
+/**
+ * Allocate `len` bytes of memory.
+ *
+ * Returns:
+ *  - NULL if `len` == 0; or
+ *  - a pointer to a block of memory of at least `len` bytes
+ *
+ * Doesn't return on out of memory.
+ */
+void *mem_alloc(size_t len)
+{
+	return mem_alloc_tag(len, mem_tag_current);
+}
+
 void *mem_zalloc(size_t len)
 {
 	void *mem = mem_alloc(len);
@@ -60,26 +221,78 @@ void *mem_zalloc(size_t len)
 
 void mem_free(void *p)
 {
+	size_t len;
+
 	if (!p) return;
 
+	if (SZ(p) == STRING_POOLED) return;
+	len = SZ_LEN(p);
+	mem_account_free(SZ_TAG(p), len);
 	if (mem_flags & MEM_POISON_FREE)
-		memset(p, 0xCD, SZ(p));
-	free((char *)p - sizeof(size_t));
+		memset(p, 0xCD, len);
+
+	if (len <= POOL_MAX) {
+		struct pool_block *block = p;
+		block->next = pool_free_list[POOL_CLASS(len)];
+		pool_free_list[POOL_CLASS(len)] = block;
+	} else {
+		free((char *)p - sizeof(size_t));
+	}
 }
 
 void *mem_realloc(void *p, size_t len)
 {
 	char *m = p;
+	size_t old_len = 0;
+	enum mem_tag tag = mem_tag_current;
 
 	/* Fail gracefully */
 	if (len == 0) return (NULL);
 
+	/* Pooled strings are copied out to the heap */
+	if (m && SZ(m) == STRING_POOLED) {
+		m = mem_alloc_tag(len, MEM_TAG_STRING);
+		memcpy(m, p, MIN(strlen(p) + 1, len));
+		return m;
+	}
+
+	/* The block stays with the tag it was allocated under */
+	if (m) {
+		old_len = SZ_LEN(m);
+		tag = SZ_TAG(m);
+	}
+
+	/* Blocks staying in the same size class don't need to move */
+	if (m && old_len <= POOL_MAX && len <= POOL_MAX &&
+		POOL_CLASS(old_len) == POOL_CLASS(len)) {
+		mem_account_free(tag, old_len);
+		mem_account_alloc(tag, len);
+		SZ(m) = SZ_MAKE(len, tag);
+		return m;
+	}
+
+	/* Moving to or from a pool needs a copy */
+	if ((m && old_len <= POOL_MAX) || len <= POOL_MAX) {
+		m = mem_alloc_tag(len, tag);
+		if (p) {
+			memcpy(m, p, MIN(old_len, len));
+			mem_free(p);
+		}
+		return m;
+	}
+
+	if (len > SZ_LEN_MASK)
+		quit("Out of Memory!");
+
 	m = realloc(m ? m - sizeof(size_t) : NULL, len + sizeof(size_t));
-	m += sizeof(size_t);
 
 	/* Handle OOM */
 	if (!m) quit("Out of Memory!");
-	SZ(m) = len;
+	m += sizeof(size_t);
+	if (p)
+		mem_account_free(tag, old_len);
+	mem_account_alloc(tag, len);
+	SZ(m) = SZ_MAKE(len, tag);
 
 	return m;
 }
@@ -97,7 +310,7 @@ char *string_make(const char *str)
 
 	/* Allocate space for the string (including terminator) */
 	siz = strlen(str) + 1;
-	res = mem_alloc(siz);
+	res = mem_alloc_tag(siz, MEM_TAG_STRING);
 
 	/* Copy the string (with terminator) */
 	my_strcpy(res, str, siz);
@@ -125,3 +338,120 @@ char *string_append(char *s1, const char *s2)
 	my_strcpy(s1 + len, s2, strlen(s2) + 1);
 	return s1;
 }
+
+/**
+ * Gamedata names and descriptions are kept in an append-only pool of large
+ * chunks rather than allocated one by one, and are all released together by
+ * string_pool_free().  Pooled strings carry a size header like any other
+ * block, set to STRING_POOLED, so mem_free() leaves them alone and
+ * mem_realloc() copies them out; code that frees or replaces them needn't
+ * know where they came from.
+ */
+#define STRING_POOL_CHUNK	65536
+#define STRING_POOL_ROUND(len) \
+	(((len) + sizeof(size_t) - 1) / sizeof(size_t) * sizeof(size_t))
+
+struct string_chunk {
+	struct string_chunk *next;
+	size_t size;
+	size_t used;
+};
+
+static struct string_chunk *string_pool;
+static char *string_pool_last;
+
+/**
+ * Carve room for a string of `len` bytes (including terminator) from the pool
+ */
+static char *string_pool_get(size_t len)
+{
+	size_t need = sizeof(size_t) + STRING_POOL_ROUND(len);
+	char *mem;
+
+	if (!string_pool || string_pool->size - string_pool->used < need) {
+		size_t size = MAX(need, STRING_POOL_CHUNK);
+		struct string_chunk *chunk = malloc(sizeof(*chunk) + size);
+
+		if (!chunk)
+			quit("Out of Memory!");
+		mem_account_alloc(MEM_TAG_STRING, size);
+		chunk->next = string_pool;
+		chunk->size = size;
+		chunk->used = 0;
+		string_pool = chunk;
+	}
+
+	mem = (char *)(string_pool + 1) + string_pool->used + sizeof(size_t);
+	string_pool->used += need;
+	SZ(mem) = STRING_POOLED;
+	string_pool_last = mem;
+	return mem;
+}
+
+/**
+ * Duplicates `str` into the string pool.
+ */
+char *string_pool_make(const char *str)
+{
+	char *res;
+	size_t siz;
+
+	if (!str) return NULL;
+
+	siz = strlen(str) + 1;
+	res = string_pool_get(siz);
+	memcpy(res, str, siz);
+	return res;
+}
+
+/**
+ * Appends `s2` to `s1`, keeping the result in the string pool.  The most
+ * recently pooled string grows in place when its chunk has room, which is
+ * the usual case for multi-line descriptions built during parsing.
+ */
+char *string_pool_append(char *s1, const char *s2)
+{
+	size_t len1, len2;
+	char *res;
+
+	if (!s1 && !s2) {
+		return NULL;
+	} else if (s1 && !s2) {
+		return s1;
+	} else if (!s1 && s2) {
+		return string_pool_make(s2);
+	}
+
+	len1 = strlen(s1);
+	len2 = strlen(s2);
+	if (s1 == string_pool_last) {
+		size_t start = s1 - sizeof(size_t) - (char *)(string_pool + 1);
+		size_t need = sizeof(size_t) + STRING_POOL_ROUND(len1 + len2 + 1);
+
+		if (start + need <= string_pool->size) {
+			memcpy(s1 + len1, s2, len2 + 1);
+			string_pool->used = start + need;
+			return s1;
+		}
+	}
+
+	res = string_pool_get(len1 + len2 + 1);
+	memcpy(res, s1, len1);
+	memcpy(res + len1, s2, len2 + 1);
+	mem_free(s1);
+	return res;
+}
+
+/**
+ * Releases every pooled string at once.
+ */
+void string_pool_free(void)
+{
+	while (string_pool) {
+		struct string_chunk *next = string_pool->next;
+		mem_account_free(MEM_TAG_STRING, string_pool->size);
+		free(string_pool);
+		string_pool = next;
+	}
+	string_pool_last = NULL;
+}
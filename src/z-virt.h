@@ -27,11 +27,49 @@ char *string_make(const char *str);
 void string_free(char *str);
 char *string_append(char *s1, const char *s2);
 
+char *string_pool_make(const char *str);
+char *string_pool_append(char *s1, const char *s2);
+void string_pool_free(void);
+
 enum {
 	MEM_POISON_ALLOC = 0x00000001,
-	MEM_POISON_FREE  = 0x00000002
+	MEM_POISON_FREE  = 0x00000002,
+	MEM_ACCOUNT      = 0x00000004
 };
 
 extern unsigned int mem_flags;
 
+/**
+ * The parts of the game that memory is accounted to; each block remembers
+ * the tag that was current when it was allocated, and strings are always
+ * accounted to MEM_TAG_STRING.
+ */
+enum mem_tag {
+	MEM_TAG_OTHER,
+	MEM_TAG_CAVE,
+	MEM_TAG_OBJECT,
+	MEM_TAG_MONSTER,
+	MEM_TAG_STRING,
+	MEM_TAG_UI,
+	MEM_TAG_PARSER,
+
+	MEM_TAG_MAX
+};
+
+/**
+ * What has been allocated under one tag while MEM_ACCOUNT is set; peak and
+ * the counts run from the last mem_tag_reset()
+ */
+struct mem_tag_stats {
+	size_t bytes;		/* Bytes currently allocated */
+	size_t peak;		/* Most bytes allocated at once */
+	u32b allocs;		/* Number of allocations */
+	u32b frees;			/* Number of frees */
+};
+
+enum mem_tag mem_tag_set(enum mem_tag tag);
+const char *mem_tag_name(enum mem_tag tag);
+void mem_tag_get_stats(enum mem_tag tag, struct mem_tag_stats *stats);
+void mem_tag_reset(void);
+
 #endif /* INCLUDED_Z_VIRT_H */